@@ -0,0 +1,161 @@
+// 以 HPS_BENCH_TRACK_ALLOC 构建时链接进每个基准程序，替换全局 operator new/delete 以统计堆分配。
+// 每块内存前放一个记录申请大小与偏移的头部，释放时据此扣减存活字节，不依赖平台的 malloc_usable_size。
+
+#include "alloc_tracker.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+struct BlockHeader {
+    std::size_t size;    ///< 调用方申请的字节数
+    std::size_t offset;  ///< 返回指针相对 malloc 起点的偏移
+};
+
+std::atomic<std::size_t> g_allocations{0};
+std::atomic<std::size_t> g_allocated_bytes{0};
+std::atomic<std::size_t> g_live_bytes{0};
+std::atomic<std::size_t> g_peak_live_bytes{0};
+
+void record_allocation(const std::size_t size) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    const std::size_t live = g_live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t       peak = g_peak_live_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !g_peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void* tracked_allocate(const std::size_t size, const std::size_t alignment) noexcept {
+    const std::size_t align = alignment < alignof(BlockHeader) ? alignof(BlockHeader) : alignment;
+    void*             raw   = std::malloc(size + sizeof(BlockHeader) + align);
+    if (raw == nullptr) {
+        return nullptr;
+    }
+
+    const auto base = reinterpret_cast<std::uintptr_t>(raw);
+    const auto user = (base + sizeof(BlockHeader) + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1);
+    auto*      header = reinterpret_cast<BlockHeader*>(user) - 1;
+    header->size      = size;
+    header->offset    = static_cast<std::size_t>(user - base);
+    record_allocation(size);
+    return reinterpret_cast<void*>(user);
+}
+
+void tracked_free(void* pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    const auto* header = static_cast<BlockHeader*>(pointer) - 1;
+    g_live_bytes.fetch_sub(header->size, std::memory_order_relaxed);
+    std::free(static_cast<char*>(pointer) - header->offset);
+}
+
+void* allocate_or_throw(const std::size_t size, const std::size_t alignment) {
+    if (void* pointer = tracked_allocate(size == 0 ? 1 : size, alignment)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+}  // namespace
+
+namespace bench {
+
+AllocationCounters allocation_counters() noexcept {
+    return {
+        g_allocations.load(std::memory_order_relaxed),
+        g_allocated_bytes.load(std::memory_order_relaxed),
+        g_live_bytes.load(std::memory_order_relaxed),
+        g_peak_live_bytes.load(std::memory_order_relaxed),
+    };
+}
+
+void reset_peak_live_bytes() noexcept {
+    g_peak_live_bytes.store(g_live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+}  // namespace bench
+
+void* operator new(const std::size_t size) {
+    return allocate_or_throw(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](const std::size_t size) {
+    return allocate_or_throw(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment) {
+    return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+    return tracked_allocate(size == 0 ? 1 : size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept {
+    return tracked_allocate(size == 0 ? 1 : size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return tracked_allocate(size == 0 ? 1 : size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return tracked_allocate(size == 0 ? 1 : size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+    tracked_free(pointer);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+
+namespace bench {
+
+/**
+ * @brief 一段代码执行期间的堆分配统计
+ *
+ * 只有以 HPS_BENCH_TRACK_ALLOC 构建的基准程序会替换全局 operator new/delete 并填充这些字段，
+ * 其他构建中 sample_allocations() 只执行代码，返回全零。
+ */
+struct AllocationSample {
+    std::size_t allocations{};      ///< 分配次数
+    std::size_t allocated_bytes{};  ///< 累计申请的字节数
+    std::size_t peak_live_bytes{};  ///< 执行期间相对起点的存活字节峰值
+    std::size_t retained_bytes{};   ///< 执行结束时相对起点仍存活的字节数，例如仍被持有的 DOM
+};
+
+#ifdef HPS_BENCH_TRACK_ALLOC
+
+/**
+ * @brief 全局分配计数的快照，由 alloc_tracker.cpp 中的 operator new/delete 维护
+ */
+struct AllocationCounters {
+    std::size_t allocations{};
+    std::size_t allocated_bytes{};
+    std::size_t live_bytes{};
+    std::size_t peak_live_bytes{};
+};
+
+[[nodiscard]] AllocationCounters allocation_counters() noexcept;
+
+/**
+ * @brief 把存活字节峰值重置为当前存活字节数
+ */
+void reset_peak_live_bytes() noexcept;
+
+#endif
+
+constexpr bool kAllocationTrackingEnabled =
+#ifdef HPS_BENCH_TRACK_ALLOC
+    true;
+#else
+    false;
+#endif
+
+/**
+ * @brief 执行 body 一次并统计期间的堆分配
+ *
+ * body 把结果保存到外部变量时，结果占用的内存计入 retained_bytes。
+ */
+template <typename Body>
+auto sample_allocations(Body&& body) -> AllocationSample {
+#ifdef HPS_BENCH_TRACK_ALLOC
+    reset_peak_live_bytes();
+    const AllocationCounters before = allocation_counters();
+    body();
+    const AllocationCounters after = allocation_counters();
+
+    AllocationSample sample;
+    sample.allocations     = after.allocations - before.allocations;
+    sample.allocated_bytes = after.allocated_bytes - before.allocated_bytes;
+    sample.peak_live_bytes = after.peak_live_bytes - before.live_bytes;
+    sample.retained_bytes  = after.live_bytes > before.live_bytes ? after.live_bytes - before.live_bytes : 0;
+    return sample;
+#else
+    body();
+    return {};
+#endif
+}
+
+}  // namespace bench
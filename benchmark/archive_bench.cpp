@@ -0,0 +1,170 @@
+#include "benchmark_common.hpp"
+#include "hps/core/document.hpp"
+#include "hps/parsing/archive_reader.hpp"
+#include "hps/parsing/html_parser.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef HPS_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace hps;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::size_t kTargetArchiveBytes = 16 * bench::MIB;
+
+auto time_iterations(const int iterations, const std::function<void()>& body) -> bench::Stats {
+    std::vector<double> durations_ms;
+    durations_ms.reserve(static_cast<std::size_t>(iterations));
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const auto end = std::chrono::steady_clock::now();
+
+        const std::chrono::duration<double, std::milli> elapsed_ms = end - start;
+        durations_ms.push_back(elapsed_ms.count());
+    }
+    return bench::compute_stats(durations_ms);
+}
+
+auto warc_response_record(const std::string& uri, const std::string& html) -> std::string {
+    const std::string block = "HTTP/1.1 200 OK\r\nContent-Type: text/html; charset=utf-8\r\n\r\n" + html;
+
+    std::string record = "WARC/1.1\r\nWARC-Type: response\r\nWARC-Target-URI: " + uri +
+                         "\r\nContent-Type: application/http; msgtype=response\r\nContent-Length: " +
+                         std::to_string(block.size()) + "\r\n\r\n";
+    record += block;
+    record += "\r\n\r\n";
+    return record;
+}
+
+#ifdef HPS_HAS_ZLIB
+auto gzip_member(const std::string& data) -> std::string {
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("deflateInit2 failed");
+    }
+    std::string out(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+    stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in  = static_cast<uInt>(data.size());
+    stream.next_out  = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    const int result = deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        throw std::runtime_error("deflate failed");
+    }
+    return out;
+}
+#endif
+
+void write_binary_file(const fs::path& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!out.good()) {
+        throw std::runtime_error("Cannot write file: " + path.string());
+    }
+}
+
+}  // namespace
+
+int main() {
+    try {
+        const auto files = bench::example_html_files();
+        if (files.empty()) {
+            std::cerr << "Error: no example HTML files found under " << bench::example_html_root() << std::endl;
+            return 1;
+        }
+
+        std::vector<std::string> sources;
+        for (const fs::path& file_path : files) {
+            sources.push_back(bench::read_binary_file(file_path));
+        }
+
+        // 轮流拼接示例页面，生成约 16 MiB 的合成 WARC 与对应的逐记录 gzip 版本
+        std::string warc;
+        std::string warc_gz;
+        std::size_t record_count = 0;
+        while (warc.size() < kTargetArchiveBytes) {
+            const std::string& html   = sources[record_count % sources.size()];
+            const std::string  record = warc_response_record("http://example.com/" + std::to_string(record_count), html);
+            warc += record;
+#ifdef HPS_HAS_ZLIB
+            warc_gz += gzip_member(record);
+#endif
+            ++record_count;
+        }
+
+        struct Scenario {
+            std::string name;
+            fs::path    path;
+            std::size_t bytes;
+        };
+        std::vector<Scenario> scenarios;
+        const fs::path        temp_root = fs::temp_directory_path();
+        scenarios.push_back({"synthetic.warc", temp_root / "hps_archive_bench.warc", warc.size()});
+        write_binary_file(scenarios.back().path, warc);
+        if (!warc_gz.empty() && ArchiveReader::gzip_supported()) {
+            scenarios.push_back({"synthetic.warc.gz", temp_root / "hps_archive_bench.warc.gz", warc.size()});
+            write_binary_file(scenarios.back().path, warc_gz);
+        }
+
+        bench::print_csv_header();
+
+        const Options options    = Options::performance();
+        const int     iterations = 5;
+        for (const Scenario& scenario : scenarios) {
+            std::size_t sink   = 0;
+            const auto  report = [&](const std::string_view category, const bench::Stats& stats) {
+                bench::print_csv_row(
+                    "archive_bench",
+                    category,
+                    scenario.name,
+                    scenario.bytes,
+                    iterations,
+                    record_count,
+                    stats,
+                    bench::throughput_mib_s(scenario.bytes, stats.avg_ms));
+                std::cerr << scenario.name << ' ' << category << ": "
+                          << static_cast<double>(record_count) / (stats.avg_ms / 1000.0) << " records/s\n";
+            };
+
+            report("scan", time_iterations(iterations, [&] {
+                       auto reader = ArchiveReader::open(scenario.path);
+                       while (const auto record = reader.next()) {
+                           sink += record->body.size();
+                       }
+                   }));
+
+            HTMLParser parser;
+            report("scan_parse", time_iterations(iterations, [&] {
+                       auto reader = ArchiveReader::open(scenario.path);
+                       while (const auto record = reader.next()) {
+                           sink += parse_archive_record(parser, *record, options)->children().size();
+                       }
+                   }));
+
+            fs::remove(scenario.path);
+            if (sink == 0) {
+                std::cerr << "Error: empty benchmark results for " << scenario.name << std::endl;
+                return 1;
+            }
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
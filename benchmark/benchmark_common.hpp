@@ -1,5 +1,7 @@
 #pragma once
 
+#include "alloc_tracker.hpp"
+
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
@@ -29,6 +31,12 @@ struct Stats {
     double      stddev_ms{};
     double      p50_ms{};
     double      p95_ms{};
+
+    // 以下字段只在 HPS_BENCH_TRACK_ALLOC 构建中由 attach_allocation_stats() 填充
+    double      allocations_per_doc{};   ///< 每次处理一份文档的堆分配次数
+    double      bytes_per_input_byte{};  ///< 每个输入字节对应的累计分配字节数
+    std::size_t peak_live_bytes{};       ///< 处理一份文档期间的存活字节峰值
+    double      dom_bytes_per_node{};    ///< 处理结束后仍被结果持有的字节数除以节点数
 };
 
 inline auto compute_stats(const std::vector<double>& durations_ms) -> Stats {
@@ -71,6 +79,21 @@ inline auto compute_stats(const std::vector<double>& durations_ms) -> Stats {
     return stats;
 }
 
+/**
+ * @brief 把一次 sample_allocations() 的结果折算进 stats
+ * @param result_count 结果中的节点数，用于计算每节点 DOM 字节；为 0 时不计算
+ */
+inline void attach_allocation_stats(
+    Stats& stats,
+    const AllocationSample& sample,
+    const std::size_t input_bytes,
+    const std::size_t result_count) {
+    stats.allocations_per_doc  = static_cast<double>(sample.allocations);
+    stats.bytes_per_input_byte = input_bytes > 0 ? static_cast<double>(sample.allocated_bytes) / static_cast<double>(input_bytes) : 0.0;
+    stats.peak_live_bytes      = sample.peak_live_bytes;
+    stats.dom_bytes_per_node   = result_count > 0 ? static_cast<double>(sample.retained_bytes) / static_cast<double>(result_count) : 0.0;
+}
+
 inline auto throughput_mib_s(const std::size_t input_bytes, const double avg_ms) -> double {
     if (input_bytes == 0 || avg_ms <= 0.0) {
         return 0.0;
@@ -107,7 +130,11 @@ inline auto csv_escape(std::string_view text) -> std::string {
 
 inline void print_csv_header() {
     std::cout
-        << "target,category,scenario,input_bytes,iterations,result_count,avg_ms,min_ms,max_ms,stddev_ms,p50_ms,p95_ms,throughput_mib_s\n";
+        << "target,category,scenario,input_bytes,iterations,result_count,avg_ms,min_ms,max_ms,stddev_ms,p50_ms,p95_ms,throughput_mib_s";
+    if constexpr (kAllocationTrackingEnabled) {
+        std::cout << ",allocations_per_doc,bytes_per_input_byte,peak_live_bytes,dom_bytes_per_node";
+    }
+    std::cout << '\n';
 }
 
 inline void print_csv_row(
@@ -135,7 +162,14 @@ inline void print_csv_row(
               << stats.stddev_ms << ','
               << stats.p50_ms << ','
               << stats.p95_ms << ','
-              << throughput << '\n';
+              << throughput;
+    if constexpr (kAllocationTrackingEnabled) {
+        std::cout << ',' << stats.allocations_per_doc << ','
+                  << stats.bytes_per_input_byte << ','
+                  << stats.peak_live_bytes << ','
+                  << stats.dom_bytes_per_node;
+    }
+    std::cout << '\n';
 
     std::cout.flags(old_flags);
     std::cout.precision(old_precision);
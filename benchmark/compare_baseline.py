@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Compare Google Benchmark JSON results against a stored baseline.
+
+Usage:
+    hps_gbench --benchmark_out=current.json --benchmark_out_format=json
+    python3 benchmark/compare_baseline.py baseline.json current.json --threshold 10
+
+Benchmarks are matched by name. When repetitions are used, the median
+aggregate is compared; otherwise the single run is. The script exits with
+status 1 when any benchmark is slower than the baseline by more than the
+threshold (in percent), so it can gate CI jobs.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_results(path, metric):
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+
+    results = {}
+    medians = {}
+    for entry in data.get("benchmarks", []):
+        if entry.get("error_occurred"):
+            continue
+        name = entry.get("run_name", entry["name"])
+        value = float(entry[metric])
+        if entry.get("run_type") == "aggregate":
+            if entry.get("aggregate_name") == "median":
+                medians[name] = value
+            continue
+        results.setdefault(name, value)
+    results.update(medians)
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="baseline JSON produced by --benchmark_out_format=json")
+    parser.add_argument("current", help="current JSON produced by --benchmark_out_format=json")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent (default: 10)")
+    parser.add_argument("--metric", choices=["real_time", "cpu_time"], default="cpu_time",
+                        help="time column to compare (default: cpu_time)")
+    args = parser.parse_args()
+
+    baseline = load_results(args.baseline, args.metric)
+    current = load_results(args.current, args.metric)
+
+    regressions = []
+    print(f"{'benchmark':<60} {'baseline':>12} {'current':>12} {'change':>9}")
+    for name in sorted(current):
+        if name not in baseline:
+            print(f"{name:<60} {'-':>12} {current[name]:>12.3f} {'new':>9}")
+            continue
+        before = baseline[name]
+        after = current[name]
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            regressions.append(name)
+            flag = "  REGRESSION"
+        print(f"{name:<60} {before:>12.3f} {after:>12.3f} {change:>+8.1f}%{flag}")
+
+    for name in sorted(set(baseline) - set(current)):
+        print(f"{name:<60} {baseline[name]:>12.3f} {'-':>12} {'missing':>9}")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) regressed by more than {args.threshold:g}%:", file=sys.stderr)
+        for name in regressions:
+            print(f"  {name}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,4 +1,6 @@
 #include "benchmark_common.hpp"
+#include "hps/core/document.hpp"
+#include "hps/core/frozen_document.hpp"
 #include "hps/parsing/html_parser.hpp"
 #include "hps/query/css/css_parser.hpp"
 #include "hps/query/css/css_matcher.hpp"
@@ -85,6 +87,8 @@ int main() {
         return 1;
     }
 
+    const auto frozen = document->freeze();
+
     const std::array<std::string_view, 14> selectors = {
         "div",
         ".container",
@@ -176,6 +180,34 @@ int main() {
             match_count,
             match_stats,
             bench::throughput_mib_s(html.size(), match_stats.avg_ms));
+
+        // 同一选择器在 FrozenDocument 结构数组上的匹配
+        std::vector<double> frozen_durations_ms;
+        frozen_durations_ms.reserve(static_cast<std::size_t>(match_iterations));
+        for (int iteration = 0; iteration < match_iterations; ++iteration) {
+            const auto start   = std::chrono::steady_clock::now();
+            const auto results = frozen.find_all(*selector);
+            const auto end     = std::chrono::steady_clock::now();
+
+            if (results.size() != match_count) {
+                std::cerr << "Frozen selector result drift detected for: " << selector_text << std::endl;
+                return 1;
+            }
+
+            const std::chrono::duration<double, std::milli> elapsed_ms = end - start;
+            frozen_durations_ms.push_back(elapsed_ms.count());
+        }
+
+        const auto frozen_stats = bench::compute_stats(frozen_durations_ms);
+        bench::print_csv_row(
+            "css_selector_bench",
+            "match_frozen",
+            selector_text,
+            html.size(),
+            match_iterations,
+            match_count,
+            frozen_stats,
+            bench::throughput_mib_s(html.size(), frozen_stats.avg_ms));
     }
 
     return 0;
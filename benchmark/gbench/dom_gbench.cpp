@@ -0,0 +1,111 @@
+#include "gbench_corpus.hpp"
+
+#include "hps/core/document.hpp"
+#include "hps/core/element.hpp"
+#include "hps/core/text_extractor.hpp"
+#include "hps/parsing/html_parser.hpp"
+#include "hps/query/css/css_parser.hpp"
+
+#include <array>
+#include <memory>
+
+using namespace hps;
+using namespace bench::gbench;
+
+namespace {
+
+constexpr std::array<std::string_view, 8> kSelectors = {
+    "article",
+    ".entry",
+    "#entry",
+    "a[href]",
+    "ul li.last",
+    "article > header h2 a",
+    "li:nth-child(2)",
+    "p b, img[alt]",
+};
+
+auto parse_document(const std::string& html) -> std::shared_ptr<Document> {
+    HTMLParser parser;
+    return parser.parse(std::string_view(html));
+}
+
+/**
+ * @brief 用显式栈先序遍历整棵树，返回节点数
+ */
+auto count_nodes(const Node& root) -> std::size_t {
+    std::size_t              count = 0;
+    std::vector<const Node*> pending{&root};
+    while (!pending.empty()) {
+        const Node* node = pending.back();
+        pending.pop_back();
+        ++count;
+        for (const Node* child = node->first_child(); child != nullptr; child = child->next_sibling()) {
+            pending.push_back(child);
+        }
+    }
+    return count;
+}
+
+void traverse(benchmark::State& state, const std::string& html) {
+    const auto  document = parse_document(html);
+    std::size_t nodes    = 0;
+    for (auto _ : state) {
+        nodes = count_nodes(*document);
+        benchmark::DoNotOptimize(nodes);
+    }
+    state.counters["nodes"] = static_cast<double>(nodes);
+}
+
+void extract_text(benchmark::State& state, const std::string& html) {
+    const auto          document = parse_document(html);
+    const TextExtractor extractor;
+    std::string         out;
+    for (auto _ : state) {
+        out.clear();
+        extractor.extract(*document, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_bytes_processed(state, out.size());
+}
+
+void BM_TraverseSynthetic(benchmark::State& state) {
+    traverse(state, synthetic_html(static_cast<std::size_t>(state.range(0))));
+}
+BENCHMARK(BM_TraverseSynthetic)->Arg(512 << 10)->Unit(benchmark::kMicrosecond);
+
+void BM_ExtractTextSynthetic(benchmark::State& state) {
+    extract_text(state, synthetic_html(static_cast<std::size_t>(state.range(0))));
+}
+BENCHMARK(BM_ExtractTextSynthetic)->Arg(512 << 10)->Unit(benchmark::kMicrosecond);
+
+void BM_ParseSelector(benchmark::State& state) {
+    const std::string_view text = kSelectors[static_cast<std::size_t>(state.range(0))];
+    for (auto _ : state) {
+        CSSParser parser(text);
+        benchmark::DoNotOptimize(parser.parse_selector_list());
+    }
+    state.SetLabel(std::string(text));
+}
+BENCHMARK(BM_ParseSelector)->DenseRange(0, static_cast<int>(kSelectors.size()) - 1);
+
+void BM_QuerySelectorAll(benchmark::State& state) {
+    static const auto      document = parse_document(synthetic_html(512 << 10));
+    const std::string_view selector = kSelectors[static_cast<std::size_t>(state.range(0))];
+    std::size_t            matches  = 0;
+    for (auto _ : state) {
+        matches = document->querySelectorAll(selector).size();
+        benchmark::DoNotOptimize(matches);
+    }
+    state.counters["matches"] = static_cast<double>(matches);
+    state.SetLabel(std::string(selector));
+}
+BENCHMARK(BM_QuerySelectorAll)->DenseRange(0, static_cast<int>(kSelectors.size()) - 1)->Unit(benchmark::kMicrosecond);
+
+const bool kCorpusRegistered = [] {
+    register_corpus_benchmarks("BM_TraverseCorpus", traverse);
+    register_corpus_benchmarks("BM_ExtractTextCorpus", extract_text);
+    return true;
+}();
+
+}  // namespace
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "../benchmark_common.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench::gbench {
+
+/**
+ * @brief 语料中的一份 HTML 文档
+ */
+struct CorpusDocument {
+    std::string name;
+    std::string html;
+};
+
+/**
+ * @brief 本地语料：examples/html 下的真实页面，首次调用时读入并在进程内复用
+ */
+inline auto corpus() -> const std::vector<CorpusDocument>& {
+    static const std::vector<CorpusDocument> documents = [] {
+        std::vector<CorpusDocument> loaded;
+        for (const auto& path : example_html_files()) {
+            loaded.push_back({path.stem().string(), read_binary_file(path)});
+        }
+        return loaded;
+    }();
+    return documents;
+}
+
+/**
+ * @brief 合成规模可控的文章列表页面，覆盖属性、注释、实体、空元素与嵌套列表
+ */
+inline auto synthetic_html(const std::size_t target_bytes) -> std::string {
+    constexpr std::string_view header = "<!DOCTYPE html><html><head><title>Synthetic</title></head><body>";
+    constexpr std::string_view footer = "</body></html>";
+    constexpr std::string_view block  = R"(
+        <article class="entry card" id="entry" data-id="42">
+            <header><h2><a href="/post?id=42&amp;ref=list">Synthetic &ldquo;entry&rdquo;</a></h2>
+                <time datetime="2026-04-08">2026-04-08</time></header>
+            <p>Lorem ipsum dolor sit amet, <b>consectetur</b> adipiscing elit &amp; sed do eiusmod.</p>
+            <ul class="tags"><li>One</li><li>Two</li><li class="last">Three</li></ul>
+            <img src="image.jpg" alt="preview" width="320" height="180"><br>
+            <!-- synthetic benchmark payload -->
+        </article>
+    )";
+
+    std::string html;
+    html.reserve(target_bytes + block.size() + header.size() + footer.size());
+    html += header;
+    while (html.size() + footer.size() < target_bytes) {
+        html += block;
+    }
+    html += footer;
+    return html;
+}
+
+/**
+ * @brief 合成含大量命名与数字字符引用的文本
+ */
+inline auto synthetic_entity_text(const std::size_t target_bytes) -> std::string {
+    constexpr std::string_view chunk = "Fish &amp; chips &lt;b&gt; caf&eacute; &#8212; &#x1F600; &nbsp;plain text run ";
+    std::string                text;
+    text.reserve(target_bytes + chunk.size());
+    while (text.size() < target_bytes) {
+        text += chunk;
+    }
+    return text;
+}
+
+/**
+ * @brief 合成混合 ASCII 与多字节字符的 UTF-8 文本
+ */
+inline auto synthetic_utf8_text(const std::size_t target_bytes) -> std::string {
+    constexpr std::string_view chunk = "ASCII run with some words, 中文内容混排，Ελληνικά, emoji \xF0\x9F\x98\x80 and more. ";
+    std::string                text;
+    text.reserve(target_bytes + chunk.size());
+    while (text.size() < target_bytes) {
+        text += chunk;
+    }
+    return text;
+}
+
+/**
+ * @brief 合成 windows-1252 字节，约四分之一为高位字节
+ */
+inline auto synthetic_windows_1252_bytes(const std::size_t target_bytes) -> std::string {
+    constexpr std::string_view chunk = "Caf\xE9 cr\xE8me br\xFBl\xE9\x65 \x93quoted\x94 \x80 price ";
+    std::string                bytes;
+    bytes.reserve(target_bytes + chunk.size());
+    while (bytes.size() < target_bytes) {
+        bytes += chunk;
+    }
+    return bytes;
+}
+
+/**
+ * @brief 为语料中的每份文档注册一个基准，名称形如 "<prefix>/<文档名>"
+ * @param prefix 基准名前缀
+ * @param body 基准主体，参数为 benchmark 状态与文档内容
+ */
+template <typename Body>
+void register_corpus_benchmarks(const std::string& prefix, Body body) {
+    for (const auto& document : corpus()) {
+        const std::string* html = &document.html;
+        benchmark::RegisterBenchmark((prefix + "/" + document.name).c_str(), [html, body](benchmark::State& state) {
+            body(state, *html);
+        })->Unit(benchmark::kMicrosecond);
+    }
+}
+
+/**
+ * @brief 记录每次迭代处理的输入字节数，报告吞吐量
+ */
+inline void set_bytes_processed(benchmark::State& state, const std::size_t bytes_per_iteration) {
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(bytes_per_iteration));
+}
+
+}  // namespace bench::gbench
@@ -0,0 +1,97 @@
+#include "gbench_corpus.hpp"
+
+#include "hps/core/document.hpp"
+#include "hps/parsing/html_parser.hpp"
+#include "hps/parsing/tokenizer.hpp"
+#include "hps/parsing/tree_builder.hpp"
+
+#include <memory>
+
+using namespace hps;
+using namespace bench::gbench;
+
+namespace {
+
+void tokenize(benchmark::State& state, const std::string& html, const Options& options) {
+    std::size_t tokens = 0;
+    for (auto _ : state) {
+        Tokenizer tokenizer(html, options);
+        tokens = 0;
+        while (auto token = tokenizer.next_token()) {
+            if (token->is_done()) {
+                break;
+            }
+            ++tokens;
+        }
+        benchmark::DoNotOptimize(tokens);
+    }
+    state.counters["tokens"] = static_cast<double>(tokens);
+    set_bytes_processed(state, html.size());
+}
+
+void build_tree(benchmark::State& state, const std::string& html) {
+    const Options      options;
+    Tokenizer          tokenizer(html, options);
+    const auto         tokens = tokenizer.tokenize_all();
+    for (auto _ : state) {
+        auto        document = std::make_shared<Document>(std::string_view(html), nullptr);
+        TreeBuilder builder(document, options);
+        for (const auto& token : tokens) {
+            benchmark::DoNotOptimize(builder.process_token(token));
+        }
+        benchmark::DoNotOptimize(builder.finish());
+    }
+    state.counters["tokens"] = static_cast<double>(tokens.size());
+    set_bytes_processed(state, html.size());
+}
+
+void parse(benchmark::State& state, const std::string& html, const Options& options) {
+    HTMLParser parser;
+    for (auto _ : state) {
+        auto document = parser.parse(std::string_view(html), options);
+        benchmark::DoNotOptimize(document.get());
+    }
+    set_bytes_processed(state, html.size());
+}
+
+void BM_TokenizeSynthetic(benchmark::State& state) {
+    const auto html = synthetic_html(static_cast<std::size_t>(state.range(0)));
+    tokenize(state, html, Options());
+}
+BENCHMARK(BM_TokenizeSynthetic)->Arg(8 << 10)->Arg(512 << 10)->Arg(4 << 20)->Unit(benchmark::kMicrosecond);
+
+void BM_TreeBuildSynthetic(benchmark::State& state) {
+    const auto html = synthetic_html(static_cast<std::size_t>(state.range(0)));
+    build_tree(state, html);
+}
+BENCHMARK(BM_TreeBuildSynthetic)->Arg(8 << 10)->Arg(512 << 10)->Unit(benchmark::kMicrosecond);
+
+void BM_ParseSynthetic(benchmark::State& state) {
+    const auto html = synthetic_html(static_cast<std::size_t>(state.range(0)));
+    parse(state, html, Options());
+}
+BENCHMARK(BM_ParseSynthetic)->Arg(8 << 10)->Arg(512 << 10)->Arg(4 << 20)->Unit(benchmark::kMicrosecond);
+
+void BM_ParseSyntheticPerformance(benchmark::State& state) {
+    const auto html = synthetic_html(static_cast<std::size_t>(state.range(0)));
+    parse(state, html, Options::performance());
+}
+BENCHMARK(BM_ParseSyntheticPerformance)->Arg(512 << 10)->Unit(benchmark::kMicrosecond);
+
+const bool kCorpusRegistered = [] {
+    register_corpus_benchmarks("BM_TokenizeCorpus", [](benchmark::State& state, const std::string& html) {
+        tokenize(state, html, Options());
+    });
+    register_corpus_benchmarks("BM_TreeBuildCorpus", [](benchmark::State& state, const std::string& html) {
+        build_tree(state, html);
+    });
+    register_corpus_benchmarks("BM_ParseCorpus", [](benchmark::State& state, const std::string& html) {
+        parse(state, html, Options());
+    });
+    register_corpus_benchmarks("BM_ParseCorpusPerformance", [](benchmark::State& state, const std::string& html) {
+        parse(state, html, Options::performance());
+    });
+    return true;
+}();
+
+}  // namespace
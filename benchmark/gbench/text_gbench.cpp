@@ -0,0 +1,66 @@
+#include "gbench_corpus.hpp"
+
+#include "hps/utils/encoding.hpp"
+#include "hps/utils/html_entities.hpp"
+#include "hps/utils/legacy_encodings.hpp"
+
+using namespace hps;
+using namespace bench::gbench;
+
+namespace {
+
+void BM_DecodeEntities(benchmark::State& state) {
+    const auto  text = synthetic_entity_text(static_cast<std::size_t>(state.range(0)));
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        decode_html_entities(text, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_bytes_processed(state, text.size());
+}
+BENCHMARK(BM_DecodeEntities)->Arg(64 << 10)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+void BM_ValidateUtf8(benchmark::State& state) {
+    const auto text = synthetic_utf8_text(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(is_valid_utf8(text));
+    }
+    set_bytes_processed(state, text.size());
+}
+BENCHMARK(BM_ValidateUtf8)->Arg(64 << 10)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+void BM_DecodeUtf8WithReplacement(benchmark::State& state) {
+    const auto  text = synthetic_utf8_text(static_cast<std::size_t>(state.range(0)));
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        decode_utf8_with_replacement(text, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_bytes_processed(state, text.size());
+}
+BENCHMARK(BM_DecodeUtf8WithReplacement)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+void BM_DecodeWindows1252(benchmark::State& state) {
+    const auto  bytes = synthetic_windows_1252_bytes(static_cast<std::size_t>(state.range(0)));
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        decode_windows_1252_to_utf8(bytes, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_bytes_processed(state, bytes.size());
+}
+BENCHMARK(BM_DecodeWindows1252)->Arg(1 << 20)->Unit(benchmark::kMicrosecond);
+
+const bool kCorpusRegistered = [] {
+    register_corpus_benchmarks("BM_SniffEncodingCorpus", [](benchmark::State& state, const std::string& html) {
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(sniff_html_encoding(html));
+        }
+    });
+    return true;
+}();
+
+}  // namespace
@@ -0,0 +1,101 @@
+#include "benchmark_common.hpp"
+#include "hps/core/document.hpp"
+#include "hps/parsing/html_parser.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace hps;
+
+namespace {
+
+constexpr std::size_t kBombDepth  = 1000000;
+constexpr int         kIterations = 5;
+
+auto make_unclosed_bomb(const std::size_t depth) -> std::string {
+    std::string html;
+    html.reserve(depth * 5);
+    for (std::size_t i = 0; i < depth; ++i) {
+        html += "<div>";
+    }
+    return html;
+}
+
+auto make_balanced_bomb(const std::size_t depth) -> std::string {
+    std::string html;
+    html.reserve(depth * 11 + 32);
+    for (std::size_t i = 0; i < depth; ++i) {
+        html += "<div>";
+    }
+    for (std::size_t i = 0; i < depth; ++i) {
+        html += "</div>";
+    }
+    html += "<p>after</p>";
+    return html;
+}
+
+auto make_mixed_bomb(const std::size_t depth) -> std::string {
+    std::string html;
+    html.reserve(depth * 48);
+    for (std::size_t i = 0; i < depth; ++i) {
+        html += "<span class=\"x\"><!-- c --><br>";
+    }
+    return html;
+}
+
+}  // namespace
+
+int main() {
+    try {
+        bench::print_csv_header();
+
+        struct Scenario {
+            const char* name;
+            std::string html;
+        };
+        const std::vector<Scenario> scenarios = {
+            {"unclosed_div", make_unclosed_bomb(kBombDepth)},
+            {"balanced_div", make_balanced_bomb(kBombDepth)},
+            {"mixed_span", make_mixed_bomb(kBombDepth)},
+        };
+
+        const Options options;
+        for (const auto& scenario : scenarios) {
+            HTMLParser          parser;
+            std::size_t         result_count = 0;
+            std::vector<double> durations_ms;
+            durations_ms.reserve(kIterations);
+            for (int iteration = 0; iteration < kIterations; ++iteration) {
+                const auto start    = std::chrono::steady_clock::now();
+                const auto document = parser.parse(scenario.html, options);
+                const auto end      = std::chrono::steady_clock::now();
+                if (!document) {
+                    std::cerr << "Error: parse failed for " << scenario.name << std::endl;
+                    return 1;
+                }
+                result_count = parser.get_errors().size();
+
+                const std::chrono::duration<double, std::milli> elapsed_ms = end - start;
+                durations_ms.push_back(elapsed_ms.count());
+            }
+
+            const auto stats = bench::compute_stats(durations_ms);
+            bench::print_csv_row(
+                "nesting_bomb_bench",
+                "parse",
+                scenario.name,
+                scenario.html.size(),
+                kIterations,
+                result_count,
+                stats,
+                bench::throughput_mib_s(scenario.html.size(), stats.avg_ms));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
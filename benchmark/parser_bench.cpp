@@ -5,6 +5,7 @@
 #include <chrono>
 #include <filesystem>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 using namespace hps;
@@ -64,7 +65,14 @@ int main() {
                 durations_ms.push_back(elapsed_ms.count());
             }
 
-            const auto stats      = bench::compute_stats(durations_ms);
+            auto                      stats = bench::compute_stats(durations_ms);
+            std::shared_ptr<Document> sampled_doc;
+            const auto                allocations = bench::sample_allocations([&] {
+                sampled_doc = parser.parse(source, options);
+            });
+            bench::attach_allocation_stats(stats, allocations, source.size(), node_count);
+            sampled_doc.reset();
+
             const auto throughput = bench::throughput_mib_s(source.size(), stats.avg_ms);
             bench::print_csv_row(
                 "parser_bench",
@@ -0,0 +1,107 @@
+#include "benchmark_common.hpp"
+#include "hps/core/document.hpp"
+#include "hps/core/frozen_document.hpp"
+#include "hps/parsing/html_parser.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+using namespace hps;
+namespace fs = std::filesystem;
+
+namespace {
+
+auto time_iterations(const int iterations, const std::function<void()>& body) -> bench::Stats {
+    std::vector<double> durations_ms;
+    durations_ms.reserve(static_cast<std::size_t>(iterations));
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const auto end = std::chrono::steady_clock::now();
+
+        const std::chrono::duration<double, std::milli> elapsed_ms = end - start;
+        durations_ms.push_back(elapsed_ms.count());
+    }
+    return bench::compute_stats(durations_ms);
+}
+
+}  // namespace
+
+int main() {
+    try {
+        const auto files = bench::example_html_files();
+        if (files.empty()) {
+            std::cerr << "Error: no example HTML files found under " << bench::example_html_root() << std::endl;
+            return 1;
+        }
+
+        bench::print_csv_header();
+
+        const Options  options       = Options::performance();
+        const fs::path snapshot_root = fs::temp_directory_path();
+
+        for (const fs::path& file_path : files) {
+            const std::string source     = bench::read_binary_file(file_path);
+            const int         iterations = bench::recommended_iterations(source.size());
+            const std::string scenario   = file_path.filename().string();
+
+            HTMLParser parser;
+            const auto document = parser.parse(source, options);
+            if (!document) {
+                std::cerr << "Error: warmup parse failed for " << file_path << std::endl;
+                return 1;
+            }
+            const auto        frozen        = document->freeze();
+            const std::string bytes         = frozen.serialize();
+            const fs::path    snapshot_path = snapshot_root / (scenario + ".hpssnap");
+            frozen.save(snapshot_path);
+
+            std::size_t sink = 0;
+            const auto  report = [&](const std::string_view category, const std::size_t input_bytes, const bench::Stats& stats) {
+                bench::print_csv_row(
+                    "snapshot_bench",
+                    category,
+                    scenario,
+                    input_bytes,
+                    iterations,
+                    frozen.size(),
+                    stats,
+                    bench::throughput_mib_s(input_bytes, stats.avg_ms));
+            };
+
+            report("parse", source.size(), time_iterations(iterations, [&] {
+                       sink += parser.parse(source, options)->children().size();
+                   }));
+            report("freeze", source.size(), time_iterations(iterations, [&] {
+                       sink += document->freeze().size();
+                   }));
+            report("serialize", bytes.size(), time_iterations(iterations, [&] {
+                       sink += frozen.serialize().size();
+                   }));
+            report("deserialize", bytes.size(), time_iterations(iterations, [&] {
+                       sink += FrozenDocument::deserialize(bytes).size();
+                   }));
+            report("load_mmap", bytes.size(), time_iterations(iterations, [&] {
+                       sink += FrozenDocument::load(snapshot_path).size();
+                   }));
+            report("to_document", bytes.size(), time_iterations(iterations, [&] {
+                       sink += frozen.to_document()->children().size();
+                   }));
+
+            fs::remove(snapshot_path);
+            if (sink == 0) {
+                std::cerr << "Error: empty benchmark results for " << file_path << std::endl;
+                return 1;
+            }
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -83,7 +83,16 @@ int main() {
             durations_ms.push_back(elapsed_ms.count());
         }
 
-        const auto stats      = bench::compute_stats(durations_ms);
+        auto       stats       = bench::compute_stats(durations_ms);
+        const auto allocations = bench::sample_allocations([&] {
+            Tokenizer tokenizer(source, Options::performance());
+            const auto tokens = tokenizer.tokenize_all();
+            if (tokens.size() != token_count) {
+                std::cerr << "Tokenizer result drift detected in scenario " << scenario_name << '\n';
+            }
+        });
+        bench::attach_allocation_stats(stats, allocations, source.size(), 0);
+
         const auto throughput = bench::throughput_mib_s(source.size(), stats.avg_ms);
         bench::print_csv_row(
             "tokenizer_bench",
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "hps/parsing/token_attribute.hpp"
+#include "hps/utils/lazy_entity_text.hpp"
 
+#include <compare>
 #include <string>
 
 namespace hps {
@@ -12,6 +14,9 @@ namespace hps {
  * Attribute 类表示 HTML 元素的一个属性，包含属性名、属性值以及是否有值的标志。
  * 支持无值属性（如 disabled、checked）和有值属性（如 id="value"、class="value"）。
  * 该类提供了属性的创建、访问、修改和字符串化功能。
+ *
+ * 惰性解码模式下属性值先以原始文本保存，首次读取 value() 时才解码字符引用并缓存结果；
+ * 解码对每个属性只执行一次，多个线程可以同时读取同一个 const 属性。
  */
 class Attribute {
   public:
@@ -28,12 +33,14 @@ class Attribute {
      * @param value 属性值，默认为空字符串
      * @param hv 是否有值标志，默认为 true
      *
+     * @param needs_decode 属性值是否含有待解码的字符引用，为 true 时首次读取才解码
+     *
      * 创建一个具有指定名称和值的属性。
      * 对于无值属性（如 disabled），应将 hv 设置为 false。
      */
-    explicit Attribute(const std::string_view name, const std::string_view value = {}, const bool hv = true) noexcept
+    explicit Attribute(const std::string_view name, const std::string_view value = {}, const bool hv = true, const bool needs_decode = false) noexcept
         : m_name(name),
-          m_value(value),
+          m_value(value, needs_decode, LazyEntityText::Context::Attribute),
           m_has_value(hv) {}
 
     /**
@@ -45,7 +52,7 @@ class Attribute {
      */
     explicit Attribute(const TokenAttribute& attr)
         : m_name(attr.name),
-          m_value(attr.value),
+          m_value(attr.value, false, LazyEntityText::Context::Attribute),
           m_has_value(attr.has_value) {}
 
     // Attribute Access Methods
@@ -60,9 +67,10 @@ class Attribute {
     /**
      * @brief 获取属性值
      * @return 属性值的常量引用
+     * @throws std::bad_alloc 首次读取惰性解码的值时内存不足
      */
-    [[nodiscard]] const std::string& value() const noexcept {
-        return m_value;
+    [[nodiscard]] const std::string& value() const {
+        return m_value.get();
     }
 
     /**
@@ -88,7 +96,7 @@ class Attribute {
         if (!m_has_value) {
             return m_name;
         }
-        return m_name + "=\"" + m_value + "\"";
+        return m_name + "=\"" + value() + "\"";
     }
 
     // Attribute Modification Methods
@@ -125,7 +133,7 @@ class Attribute {
      * 或者将无值属性转换为有值属性。
      */
     void set_value(const std::string& value, const bool has_value = true) noexcept {
-        m_value     = value;
+        m_value.assign(value);
         m_has_value = has_value;
     }
 
@@ -135,7 +143,7 @@ class Attribute {
      * @param has_value 是否有值标志，默认为 true
      */
     void set_value(std::string&& value, const bool has_value = true) noexcept {
-        m_value     = std::move(value);
+        m_value.assign(std::move(value));
         m_has_value = has_value;
     }
 
@@ -145,7 +153,7 @@ class Attribute {
      * @param has_value 是否有值标志，默认为 true
      */
     void set_value(const std::string_view value, const bool has_value = true) noexcept {
-        m_value     = value;
+        m_value.assign(value);
         m_has_value = has_value;
     }
 
@@ -157,13 +165,26 @@ class Attribute {
      *
      * 提供完整的比较功能，支持 ==, !=, <, <=, >, >= 操作符。
      * 比较顺序：首先比较属性名，然后比较属性值，最后比较 has_value 标志。
+     * 属性值按解码后的内容比较。
      */
-    auto operator<=>(const Attribute& other) const = default;
+    std::strong_ordering operator<=>(const Attribute& other) const {
+        if (const auto order = m_name <=> other.m_name; order != 0) {
+            return order;
+        }
+        if (const auto order = value() <=> other.value(); order != 0) {
+            return order;
+        }
+        return m_has_value <=> other.m_has_value;
+    }
+
+    bool operator==(const Attribute& other) const {
+        return m_has_value == other.m_has_value && m_name == other.m_name && value() == other.value();
+    }
 
   private:
-    std::string m_name;              /**< 属性名 */
-    std::string m_value;             /**< 属性值 */
-    bool        m_has_value = false; /**< 是否有值标志，false 表示无值属性（如 disabled） */
+    std::string    m_name;               /**< 属性名 */
+    LazyEntityText m_value;              /**< 属性值，待解码时保存原始文本 */
+    bool           m_has_value = false;  /**< 是否有值标志，false 表示无值属性（如 disabled） */
 };
 
 }  // namespace hps
\ No newline at end of file
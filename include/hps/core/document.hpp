@@ -1,6 +1,9 @@
 #pragma once
 #include "hps/core/node.hpp"
+#include "hps/utils/transparent_hash.hpp"
 
+#include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -26,6 +29,13 @@ class Document : public Node {
      */
     explicit Document(std::string html_content);
 
+    /**
+     * @brief 构造引用外部源码的文档，不复制源码
+     * @param html_content HTML 源代码视图
+     * @param source_owner 源码缓冲区的所有者（如内存映射文件），与文档同生命周期；为空时由调用方保证缓冲区有效
+     */
+    Document(std::string_view html_content, std::shared_ptr<const void> source_owner);
+
     /**
      * @brief 虚析构函数
      */
@@ -63,6 +73,14 @@ class Document : public Node {
      */
     [[nodiscard]] std::string_view source_html() const noexcept;
 
+    /**
+     * @brief 源码是否由文档自身持有
+     * @return 借用外部缓冲区（内存映射文件或 parse_borrowed 的输入）时返回 false
+     */
+    [[nodiscard]] bool owns_source() const noexcept {
+        return m_source_view.data() == m_html_source.data();
+    }
+
     // Meta Information Extraction
     /**
      * @brief 获取指定 name 属性的 meta 标签内容
@@ -165,25 +183,90 @@ class Document : public Node {
      */
     std::vector<std::unique_ptr<Node>> take_children();
 
+    /**
+     * @brief 生成只读的扁平化快照
+     * @return 以结构数组保存当前树的 FrozenDocument，与本文档此后的修改无关
+     */
+    [[nodiscard]] FrozenDocument freeze() const;
+
   private:
+    /**
+     * @brief 查询索引缓存
+     *
+     * 各索引桶内元素均按文档顺序排列；首次查询时整体构建，之后随 DOM 变更增量维护。
+     */
     struct QueryIndexCache {
-        std::unordered_map<std::string, const Element*>              id_lookup;
-        std::unordered_map<std::string, std::vector<const Element*>> class_lookup;
-        std::unordered_map<std::string, std::vector<const Element*>> tag_lookup;
-        bool                                                         valid{false};
+        using Buckets = std::unordered_map<std::string, std::vector<const Element*>, TransparentStringHash, std::equal_to<>>;
+
+        Buckets id_lookup;
+        Buckets class_lookup;
+        Buckets tag_lookup;
+        bool    valid{false};
     };
 
     void invalidate_query_indexes() noexcept;
     void ensure_query_indexes() const;
-    void index_element_subtree(const Element& element) const;
+    void index_element(const Element& element, bool append) const;
+
+    /**
+     * @brief 立即建立查询索引，此后解析插入的元素随插入同步入索引
+     *
+     * 由 TreeBuilder 在 Options::build_query_indexes 开启时调用。
+     */
+    void enable_incremental_query_indexes();
+
+    /**
+     * @brief 编号失效时按先序遍历为所有元素重新编号
+     */
+    void ensure_document_order() const noexcept;
+
+    /**
+     * @brief 为新挂载子树分配文档顺序序号
+     * @param node 新挂载子树的根节点
+     * @param append 子树是否位于文档末尾；否则仅标记编号失效
+     */
+    void assign_document_order(const Node& node, bool append) noexcept;
+
+    /**
+     * @brief 判断新挂载的子树是否位于文档末尾，并随之更新缓存的文档最后节点
+     * @param node 新挂载子树的根节点
+     */
+    [[nodiscard]] bool is_appended_at_end(const Node& node) noexcept;
+
+    /**
+     * @brief 子树挂载到本文档后增量更新索引
+     * @param node 新挂载子树的根节点
+     */
+    void on_subtree_attached(const Node& node) noexcept;
+
+    /**
+     * @brief 子树即将从本文档摘除时增量移除索引项
+     * @param node 被摘除子树的根节点
+     */
+    void on_subtree_detached(const Node& node) noexcept;
+
+    /**
+     * @brief 元素属性变化后增量更新 id/class 索引
+     * @param element 属性发生变化的元素
+     * @param name 属性名
+     * @param old_value 变化前的属性值（新增属性时为空）
+     */
+    void on_attribute_changed(const Element& element, std::string_view name, std::string_view old_value) noexcept;
 
-    std::string m_html_source; /**< 原始 HTML 源代码 */
+    std::string                 m_html_source;  /**< 文档自有的 HTML 源代码 */
+    std::shared_ptr<const void> m_source_owner; /**< 外部源码的所有者，源码不由文档持有时非空 */
+    std::string_view            m_source_view;  /**< 原始 HTML 源代码，指向 m_html_source 或外部缓冲区 */
 
     mutable QueryIndexCache           m_query_index_cache;
+    mutable size_t                     m_next_document_order{0};     /**< 已分配的最大文档顺序序号 */
+    mutable bool                       m_document_order_valid{true}; /**< 元素文档顺序序号是否有效 */
+    const Node*                        m_last_node{this};            /**< 文档顺序中的最后一个节点，为空表示需要重新定位 */
     mutable std::optional<std::string> m_cached_title;   /**< 缓存的文档标题 */
     mutable std::optional<std::string> m_cached_charset; /**< 缓存的字符编码 */
 
     friend class Node;
+    friend class Element;
+    friend class TreeBuilder;
 };
 
 }  // namespace hps
@@ -63,7 +63,7 @@ class Element : public Node {
      * @param name 属性名（忽略大小写）
      * @return 属性值，如果属性不存在则返回空字符串
      */
-    [[nodiscard]] const std::string& get_attribute(std::string_view name) const noexcept;
+    [[nodiscard]] const std::string& get_attribute(std::string_view name) const;
 
     /**
      * @brief 获取所有属性
@@ -81,26 +81,26 @@ class Element : public Node {
      * @brief 获取 ID 属性值
      * @return ID 值，如果元素没有 ID 属性则返回空字符串
      */
-    [[nodiscard]] const std::string& id() const noexcept;
+    [[nodiscard]] const std::string& id() const;
 
     /**
      * @brief 获取 class 属性的原始值
      * @return class 属性值，如果元素没有 class 属性则返回空字符串
      */
-    [[nodiscard]] const std::string& class_name() const noexcept;
+    [[nodiscard]] const std::string& class_name() const;
 
     /**
      * @brief 获取所有 CSS 类名
      * @return 包含所有 CSS 类名的集合的常量引用
      */
-    [[nodiscard]] std::unordered_set<std::string> class_names() const noexcept;
+    [[nodiscard]] std::unordered_set<std::string> class_names() const;
 
     /**
      * @brief 检查元素是否包含指定 class 类
      * @param class_name 要检查的类名
      * @return 如果包含指定类则返回 true，否则返回 false
      */
-    [[nodiscard]] bool has_class(std::string_view class_name) const noexcept;
+    [[nodiscard]] bool has_class(std::string_view class_name) const;
 
     // Query Methods
     /**
@@ -164,13 +164,25 @@ class Element : public Node {
      * @param name 属性名
      * @param value 属性值
      * @param has_value 是否显式带值，用于区分 `checked` 和 `checked=""`
+     * @param needs_decode 值中是否含有待解码的字符引用，为 true 时首次读取才解码
      */
-    void add_attribute(std::string_view name, std::string_view value, bool has_value = true);
+    void add_attribute(std::string_view name, std::string_view value, bool has_value = true, bool needs_decode = false);
+
+    /**
+     * @brief 获取元素在所属文档中的先序序号
+     * @return 从 1 开始的文档顺序序号；元素不属于任何文档时返回 0
+     *
+     * 解析期顺序追加的元素在挂载时直接编号；非末尾插入会使编号失效，下次访问时整体重编号。
+     */
+    [[nodiscard]] size_t document_order() const noexcept;
 
   private:
-    std::string            m_name;            /**< 标签名 */
-    NamespaceKind          m_namespace_kind;  /**< 命名空间 */
-    std::vector<Attribute> m_attributes;      /**< 属性列表 */
+    std::string            m_name;                 /**< 标签名 */
+    NamespaceKind          m_namespace_kind;       /**< 命名空间 */
+    std::vector<Attribute> m_attributes;           /**< 属性列表 */
+    mutable size_t         m_document_order{0};  /**< 文档顺序序号，由所属 Document 维护 */
+
+    friend class Document;
 };
 
 }  // namespace hps
@@ -0,0 +1,197 @@
+#pragma once
+#include "hps/hps_fwd.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hps {
+
+class SelectorList;
+
+/**
+ * @brief 只读的扁平化文档快照
+ *
+ * FrozenDocument 由 Document::freeze() 生成，以结构数组（struct-of-arrays）形式保存整棵树：
+ * 节点类型、标签原子、父/首子/兄弟索引、属性区间与文本区间各占一列连续内存。
+ * 节点编号即先序文档顺序，0 号节点为文档根。快照不可修改，适合解析后只做查询与分析的场景。
+ * 列数据由共享所有者持有，拷贝快照只增加引用计数；可序列化后经内存映射直接加载。
+ */
+class FrozenDocument {
+  public:
+    using NodeId = std::uint32_t;
+    using AtomId = std::uint32_t;
+
+    static constexpr NodeId kInvalidNode = std::numeric_limits<NodeId>::max(); /**< 无效节点编号 */
+    static constexpr AtomId kNoAtom      = std::numeric_limits<AtomId>::max(); /**< 非元素节点的标签原子 */
+
+    /**
+     * @brief 字符串区间，指向快照内部字符缓冲区
+     */
+    struct StringRange {
+        std::uint32_t offset{0};
+        std::uint32_t length{0};
+    };
+
+    FrozenDocument() = default;
+
+    // ==================== 结构访问 ====================
+
+    /**
+     * @brief 获取节点总数（含文档根节点）
+     */
+    [[nodiscard]] size_t size() const noexcept {
+        return m_types.size();
+    }
+
+    /**
+     * @brief 获取文档根节点编号
+     */
+    [[nodiscard]] static constexpr NodeId root() noexcept {
+        return 0;
+    }
+
+    [[nodiscard]] NodeType type(NodeId node) const noexcept;
+    [[nodiscard]] bool     is_element(NodeId node) const noexcept;
+    [[nodiscard]] NodeId   parent(NodeId node) const noexcept;
+    [[nodiscard]] NodeId   first_child(NodeId node) const noexcept;
+    [[nodiscard]] NodeId   next_sibling(NodeId node) const noexcept;
+    [[nodiscard]] NodeId   previous_sibling(NodeId node) const noexcept;
+
+    /**
+     * @brief 获取元素标签名，非元素节点返回空
+     */
+    [[nodiscard]] std::string_view tag_name(NodeId node) const noexcept;
+
+    /**
+     * @brief 获取文本或注释节点的内容，元素节点返回空
+     */
+    [[nodiscard]] std::string_view text(NodeId node) const noexcept;
+
+    /**
+     * @brief 拼接节点子树中所有文本节点的内容
+     */
+    [[nodiscard]] std::string text_content(NodeId node) const;
+
+    // ==================== 属性访问 ====================
+
+    [[nodiscard]] size_t           attribute_count(NodeId node) const noexcept;
+    [[nodiscard]] std::string_view attribute_name(NodeId node, size_t index) const noexcept;
+    [[nodiscard]] std::string_view attribute_value(NodeId node, size_t index) const noexcept;
+    [[nodiscard]] bool             has_attribute(NodeId node, std::string_view name) const noexcept;
+
+    /**
+     * @brief 获取属性值（属性名大小写不敏感）
+     * @return 属性值，不存在时返回空
+     */
+    [[nodiscard]] std::string_view get_attribute(NodeId node, std::string_view name) const noexcept;
+
+    [[nodiscard]] std::string_view id(NodeId node) const noexcept;
+    [[nodiscard]] bool             has_class(NodeId node, std::string_view class_name) const noexcept;
+
+    // ==================== 选择器查询 ====================
+
+    /**
+     * @brief 查找所有匹配选择器的元素
+     * @param selector CSS 选择器字符串
+     * @return 按文档顺序排列的节点编号
+     * @throws HPSException 选择器包含快照不支持的 :has() 或伪元素时抛出 InvalidSelector
+     */
+    [[nodiscard]] std::vector<NodeId> css(std::string_view selector) const;
+
+    /**
+     * @brief 查找第一个匹配选择器的元素
+     * @return 节点编号，未找到时返回 kInvalidNode
+     */
+    [[nodiscard]] NodeId css_first(std::string_view selector) const;
+
+    [[nodiscard]] std::vector<NodeId> find_all(const SelectorList& selector_list) const;
+    [[nodiscard]] NodeId              find_first(const SelectorList& selector_list) const;
+
+    // ==================== 序列化 ====================
+
+    static constexpr std::uint32_t kFormatVersion = 1; /**< 二进制格式版本，布局变化时递增 */
+
+    /**
+     * @brief 序列化为带版本号的二进制格式
+     *
+     * 各列按 8 字节对齐顺序排布，加载时直接在缓冲区上建立视图，无需逐节点修正指针。
+     * 格式使用本机字节序，加载端字节序不同会被拒绝。
+     */
+    [[nodiscard]] std::string serialize() const;
+
+    /**
+     * @brief 序列化并写入文件
+     * @throws HPSException 写入失败时抛出 FileWriteError
+     */
+    void save(const std::filesystem::path& path) const;
+
+    /**
+     * @brief 从内存中的二进制数据加载（数据被复制到对齐的内部缓冲区）
+     * @throws HPSException 数据损坏或版本不符时抛出 InvalidSnapshot
+     */
+    [[nodiscard]] static FrozenDocument deserialize(std::string_view bytes);
+
+    /**
+     * @brief 通过内存映射加载快照文件，各列直接引用映射内容
+     * @throws HPSException 文件无法读取时抛出 FileReadError，数据损坏时抛出 InvalidSnapshot
+     */
+    [[nodiscard]] static FrozenDocument load(const std::filesystem::path& path);
+
+    /**
+     * @brief 重建可修改的指针树文档
+     * @return 新的 Document，原始 HTML 源码不包含在快照中，source_html() 为空
+     */
+    [[nodiscard]] std::shared_ptr<Document> to_document() const;
+
+  private:
+    friend class Document;
+    friend class FrozenSelectorMatcher;
+
+    struct Columns;
+
+    [[nodiscard]] std::string_view view(StringRange range) const noexcept {
+        return m_strings.substr(range.offset, range.length);
+    }
+
+    /**
+     * @brief 从指针树构建快照，供 Document::freeze() 调用
+     */
+    [[nodiscard]] static FrozenDocument build(const Document& document);
+
+    /**
+     * @brief 在已校验所有权的字节缓冲区上建立列视图
+     * @param storage 保持缓冲区存活的所有者
+     * @param bytes 序列化数据，起始地址需 8 字节对齐
+     */
+    [[nodiscard]] static FrozenDocument attach(std::shared_ptr<const void> storage, std::string_view bytes);
+
+    // 每个节点一列
+    std::span<const NodeType>      m_types;
+    std::span<const NamespaceKind> m_namespaces;
+    std::span<const AtomId>        m_tags;
+    std::span<const NodeId>        m_parents;
+    std::span<const NodeId>        m_first_children;
+    std::span<const NodeId>        m_next_siblings;
+    std::span<const NodeId>        m_prev_siblings;
+    std::span<const std::uint32_t> m_attribute_begin; /**< 长度为 size()+1 的前缀区间 */
+    std::span<const StringRange>   m_texts;
+    std::span<const StringRange>   m_ids;
+    std::span<const StringRange>   m_classes;
+
+    // 每个属性一列
+    std::span<const AtomId>      m_attribute_names;
+    std::span<const StringRange> m_attribute_values;
+
+    std::span<const StringRange> m_atoms;   /**< 标签名与属性名原子表 */
+    std::string_view             m_strings; /**< 所有字符串内容的连续缓冲区 */
+
+    std::shared_ptr<const void> m_storage; /**< 列数据的所有者：构建时的内部数组、复制缓冲区或内存映射 */
+};
+
+}  // namespace hps
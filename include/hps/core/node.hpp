@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace hps {
@@ -170,6 +171,8 @@ class Node {
     /**
      * @brief 获取所属文档
      * @return 当前节点所在的文档，未挂载则返回 nullptr
+     *
+     * 所属文档指针在挂载/摘除子树时维护，查询为 O(1)。
      */
     [[nodiscard]] const Document* owner_document() const noexcept;
 
@@ -180,9 +183,12 @@ class Node {
     [[nodiscard]] Document* owner_document_mut() noexcept;
 
     /**
-     * @brief 通知所属文档清理查询缓存
+     * @brief 通知所属文档某个元素的属性已变更，用于增量维护查询索引
+     * @param element 属性发生变化的元素
+     * @param name 属性名
+     * @param old_value 变更前的属性值
      */
-    void invalidate_document_query_cache() noexcept;
+    void notify_attribute_changed(const Element& element, std::string_view name, std::string_view old_value) noexcept;
 
     /**
      * @brief 添加子节点
@@ -211,11 +217,20 @@ class Node {
     std::vector<std::unique_ptr<Node>> take_children();
 
   private:
+    /**
+     * @brief 将子树的所属文档更新为指定文档
+     * @param owner 新的所属文档，摘除时为 nullptr
+     */
+    void set_subtree_owner(Document* owner) noexcept;
+
     NodeType                           m_type;
     Node*                              m_parent{nullptr};
+    Document*                          m_owner_document{nullptr};
     std::vector<std::unique_ptr<Node>> m_children;
     Node*                              m_prev_sibling{nullptr};
     Node*                              m_next_sibling{nullptr};
+
+    friend class FrozenDocument;
 };
 
 }  // namespace hps
@@ -0,0 +1,73 @@
+#pragma once
+#include "hps/hps_fwd.hpp"
+#include "hps/parsing/options.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hps {
+
+/**
+ * @brief 文本提取选项
+ */
+struct TextExtractionOptions {
+    bool        block_newlines      = true;                       ///< 在块级元素边界输出换行，关闭时以空格分隔
+    bool        collapse_whitespace = true;                       ///< 合并连续空白并去掉首尾空白（pre/textarea/listing 内部除外）
+    bool        skip_non_content    = true;                       ///< 跳过 script、style、template 的内容
+    BRHandling  br_handling         = BRHandling::InsertNewline;  ///< <br> 处理策略，Keep 时按空白处理
+    std::string br_text             = "\n";                       ///< InsertCustom 时插入的文本
+    bool        nfc                 = false;                      ///< 输出转换为 Unicode NFC
+    bool        case_fold           = false;                      ///< 输出做完全大小写折叠
+};
+
+/**
+ * @brief 单遍 DOM 文本提取器
+ *
+ * 一次先序遍历完成块级换行、<br> 处理、空白合并以及可选的 NFC 与大小写折叠，
+ * 结果直接追加到调用方缓冲区，不为每个元素构造中间字符串。
+ * 遍历使用显式的父/兄弟指针而非递归，深层嵌套的文档不会耗尽调用栈。
+ */
+class TextExtractor {
+  public:
+    explicit TextExtractor(TextExtractionOptions options = {});
+
+    /**
+     * @brief 提取 root 子树的文本并追加到 out
+     */
+    void extract(const Node& root, std::string& out) const;
+
+    /**
+     * @brief 提取 root 子树的文本
+     */
+    [[nodiscard]] std::string extract(const Node& root) const;
+
+    /**
+     * @brief 提取文本并切分为词
+     *
+     * 文本追加到 buffer，词以指向 buffer 的视图追加到 words；buffer 再次修改前视图保持有效。
+     */
+    void extract_words(const Node& root, std::string& buffer, std::vector<std::string_view>& words) const;
+
+    /**
+     * @brief 按词边界切分 UTF-8 文本
+     *
+     * 词是字母、数字与组合字符的连续序列，允许词内的撇号（don't）和数字间的 '.'、','（3.14）；
+     * 汉字、假名等表意文字每个字符单独成词，标点与空白不产生词。
+     */
+    static void segment_words(std::string_view text, std::vector<std::string_view>& words);
+
+    [[nodiscard]] const TextExtractionOptions& options() const noexcept {
+        return m_options;
+    }
+
+  private:
+    TextExtractionOptions m_options;
+};
+
+/**
+ * @brief 把 root 子树中所有文本节点的内容按文档顺序追加到 out（text_content() 的语义）
+ */
+void append_text_content(const Node& root, std::string& out);
+
+}  // namespace hps
@@ -1,12 +1,24 @@
 #pragma once
 
 #include "hps/core/node.hpp"
+#include "hps/utils/lazy_entity_text.hpp"
 
 namespace hps {
 
+/**
+ * @brief 文本节点
+ *
+ * 惰性解码模式下文本先以原始内容保存，首次读取时才解码字符引用并缓存结果；
+ * 解码对每个节点只执行一次，多个线程可以同时读取同一个 const 文本节点。
+ */
 class TextNode : public Node {
   public:
-    explicit TextNode(std::string_view text) noexcept;
+    /**
+     * @brief 构造文本节点
+     * @param text 文本内容
+     * @param needs_decode 文本中是否含有待解码的字符引用，为 true 时首次读取才解码
+     */
+    explicit TextNode(std::string_view text, bool needs_decode = false) noexcept;
     ~TextNode() override = default;
 
     /**
@@ -49,22 +61,30 @@ class TextNode : public Node {
      * @brief 判断是否为空
      * @return 是否为空
      */
-    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] bool empty() const;
 
     /**
      * @brief 获取长度
      * @return 长度
      */
-    [[nodiscard]] size_t length() const noexcept;
+    [[nodiscard]] size_t length() const;
 
     /**
      * @brief 追加文本内容
      * @param text 要追加的文本
+     * @param needs_decode 追加的文本是否含有待解码的字符引用
+     */
+    void append_text(std::string_view text, bool needs_decode = false);
+
+    /**
+     * @brief 文本是否仍含未解码的字符引用
      */
-    void append_text(std::string_view text);
+    [[nodiscard]] bool needs_decode() const noexcept {
+        return m_text.needs_decode();
+    }
 
   private:
-    std::string m_text;
+    LazyEntityText m_text;
 };
 
 }  // namespace hps
@@ -2,7 +2,9 @@
 
 #include "hps/core/comment_node.hpp"
 #include "hps/core/document.hpp"
+#include "hps/core/frozen_document.hpp"
 #include "hps/hps_fwd.hpp"
+#include "hps/parsing/html_parser.hpp"
 #include "hps/parsing/options.hpp"
 #include "hps/query/query.hpp"
 #include "hps/utils/encoding.hpp"
@@ -14,6 +16,14 @@ namespace hps {
 struct ParseResult {
     std::shared_ptr<Document> document;
     std::vector<HPSError>     errors;
+    ParseStatus               status = ParseStatus::Complete;  ///< 解析因资源预算提前停止时说明原因
+
+    /**
+     * @brief 解析是否因资源预算提前停止，此时 document 只包含部分结果
+     */
+    [[nodiscard]] bool is_partial() const noexcept {
+        return status != ParseStatus::Complete;
+    }
 
     [[nodiscard]] bool has_errors() const noexcept {
         return !errors.empty();
@@ -28,6 +38,13 @@ std::shared_ptr<Document> parse(std::string_view html);
 
 std::shared_ptr<Document> parse(std::string_view html, const Options& options);
 
+std::shared_ptr<Document> parse_borrowed(std::string_view html, std::shared_ptr<const void> keep_alive);
+
+std::shared_ptr<Document> parse_borrowed(
+    std::string_view html,
+    std::shared_ptr<const void> keep_alive,
+    const Options& options);
+
 std::shared_ptr<Document> parse_fragment(std::string_view html, std::string_view context_tag);
 
 std::shared_ptr<Document> parse_fragment(
@@ -54,5 +71,23 @@ ParseResult parse_file_with_error(std::string_view path);
 
 ParseResult parse_file_with_error(std::string_view path, const Options& options);
 
+std::shared_ptr<Document> parse_bytes(std::string_view raw_bytes);
+
+std::shared_ptr<Document> parse_bytes(std::string_view raw_bytes, const Options& options);
+
+std::shared_ptr<Document> parse_bytes(
+    std::string_view raw_bytes,
+    const Options& options,
+    std::string_view transport_charset);
+
+ParseResult parse_bytes_with_error(std::string_view raw_bytes);
+
+ParseResult parse_bytes_with_error(std::string_view raw_bytes, const Options& options);
+
+ParseResult parse_bytes_with_error(
+    std::string_view raw_bytes,
+    const Options& options,
+    std::string_view transport_charset);
+
 std::string version();
 }  // namespace hps
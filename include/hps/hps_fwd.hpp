@@ -62,12 +62,14 @@ enum class TokenizerState : std::uint8_t {
 class Attribute;
 class Document;
 class Element;
+class FrozenDocument;
 class Node;
 class TextNode;
 class CommentNode;
 
 // 解析模块
 class HTMLParser;
+class IgnoredSubtree;
 class Options;
 class Token;
 class Tokenizer;
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "hps/parsing/options.hpp"
+#include "hps/utils/noncopyable.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace hps {
+
+class Document;
+class HTMLParser;
+
+/**
+ * @brief 归档容器格式
+ */
+enum class ArchiveFormat {
+    Auto,             ///< 按内容开头自动识别："WARC/" 为 WARC，否则按拼接 HTML 处理
+    Warc,             ///< WARC 1.0/1.1，只产出 HTML 响应记录与 HTML 资源记录
+    ConcatenatedHtml  ///< 多个 HTML 文档首尾拼接，以 </html> 作为文档边界
+};
+
+/**
+ * @brief 归档中的一条 HTML 记录
+ *
+ * 所有视图都指向归档数据本身：未压缩输入为内存映射或调用方缓冲区，gzip 输入为该成员解压后的缓冲区。
+ * keep_alive 持有这块缓冲区，记录可以在读取器销毁或前进后继续使用。
+ */
+struct ArchiveRecord {
+    std::string_view            body;        /**< HTML 字节，WARC 响应记录为去掉 HTTP 头后的负载 */
+    std::string_view            target_uri;  /**< WARC-Target-URI，拼接 HTML 时为空 */
+    std::string_view            charset;     /**< HTTP 或记录 Content-Type 声明的字符集，未声明时为空 */
+    size_t                      offset{0};   /**< 记录在（解压后）容器数据中的起始偏移 */
+    std::shared_ptr<const void> keep_alive;  /**< body 所在缓冲区的所有者，调用方自有缓冲区时为空 */
+};
+
+/**
+ * @brief 流式归档读取器
+ *
+ * 逐条产出 WARC 或拼接 HTML 归档中的 HTML 记录，记录正文不做复制。
+ * gzip 输入（包括每条记录单独压缩的 .warc.gz）按成员逐个解压，需要编译时找到 zlib。
+ */
+class ArchiveReader : public NonCopyable {
+  public:
+    /**
+     * @brief 在内存中的归档数据上创建读取器
+     * @param data 归档数据，可以是 gzip 压缩数据
+     * @param keep_alive data 的所有者，为空时由调用方保证 data 在记录使用期间有效
+     * @param format 容器格式
+     */
+    explicit ArchiveReader(
+        std::string_view data,
+        std::shared_ptr<const void> keep_alive = {},
+        ArchiveFormat format = ArchiveFormat::Auto);
+
+    ~ArchiveReader();
+
+    ArchiveReader(ArchiveReader&& other) noexcept;
+    ArchiveReader& operator=(ArchiveReader&& other) noexcept;
+
+    /**
+     * @brief 以内存映射方式打开归档文件
+     * @throws HPSException 文件无法读取时抛出 FileReadError
+     */
+    [[nodiscard]] static ArchiveReader open(const std::filesystem::path& path, ArchiveFormat format = ArchiveFormat::Auto);
+
+    /**
+     * @brief 读取下一条 HTML 记录，跳过非 HTML 记录
+     * @return 下一条记录，没有更多记录时返回 std::nullopt
+     * @throws HPSException 归档结构损坏时抛出 InvalidArchive，gzip 输入不可用时同样抛出 InvalidArchive
+     */
+    [[nodiscard]] std::optional<ArchiveRecord> next();
+
+    /**
+     * @brief 当前构建是否支持 gzip 输入
+     */
+    [[nodiscard]] static bool gzip_supported() noexcept;
+
+  private:
+    struct GzipState;
+
+    [[nodiscard]] bool load_next_segment();
+    [[nodiscard]] std::optional<ArchiveRecord> next_warc_record();
+    [[nodiscard]] std::optional<ArchiveRecord> next_html_document();
+
+    std::string_view            m_input;        /**< 原始输入 */
+    std::shared_ptr<const void> m_input_owner;  /**< 原始输入的所有者 */
+    size_t                      m_input_cursor{0};
+    ArchiveFormat               m_format{ArchiveFormat::Auto};
+    bool                        m_started{false};
+
+    std::string_view            m_segment;        /**< 当前数据段：未压缩输入为整个输入，gzip 输入为一个已解压成员 */
+    std::shared_ptr<const void> m_segment_owner;  /**< 当前数据段的所有者 */
+    size_t                      m_segment_base{0}; /**< 当前数据段在解压后数据中的起始偏移 */
+    size_t                      m_cursor{0};       /**< 当前数据段内的读取位置 */
+
+    std::unique_ptr<GzipState> m_gzip;  /**< gzip 解压状态，未压缩输入为空 */
+};
+
+/**
+ * @brief 解析一条归档记录
+ *
+ * 内容为 UTF-8 时以借用模式解析，文档直接引用记录正文并持有 record.keep_alive；
+ * 其他编码按记录声明的字符集经 parse_bytes 转码。
+ *
+ * @param parser 复用的解析器，错误信息可通过 parser.get_errors() 获取
+ * @param record 归档记录
+ * @param options 解析选项
+ */
+[[nodiscard]] std::shared_ptr<Document> parse_archive_record(
+    HTMLParser& parser,
+    const ArchiveRecord& record,
+    const Options& options = {});
+
+}  // namespace hps
@@ -3,9 +3,24 @@
 #include "hps/parsing/options.hpp"
 #include "hps/parsing/tokenizer.hpp"
 #include "hps/parsing/tree_builder.hpp"
+#include "hps/utils/error_summary.hpp"
 
 namespace hps {
 
+/**
+ * @brief 最近一次解析的完成状态
+ *
+ * 除 Complete 外都表示解析因资源预算提前停止：InputTooLarge 时文档为空，其余情况下文档包含停止前已构建的部分。
+ */
+enum class ParseStatus {
+    Complete,       ///< 输入已完整解析
+    TokenLimit,     ///< Token 数超过 Options::max_tokens
+    InputTooLarge,  ///< 输入超过 Options::max_input_bytes，未解析
+    MemoryLimit,    ///< DOM 估算内存超过 Options::max_dom_bytes
+    Timeout,        ///< 解析时间超过 Options::parse_timeout
+    Cancelled       ///< Options::cancellation 已被取消
+};
+
 /**
  * @brief HTML解析器类
  *
@@ -41,6 +56,23 @@ class HTMLParser : public NonCopyable {
      */
     [[nodiscard]] std::shared_ptr<Document> parse(std::string&& html, const Options& options = {});
 
+    /**
+     * @brief 解析调用方持有的 HTML 缓冲区，不复制源码
+     *
+     * 文档的 source_html() 直接引用 html。缓冲区需在文档存活期间保持有效：
+     * 传入 keep_alive 时由文档共同持有（可借助 shared_ptr 的别名构造或自定义删除器绑定任意所有者），
+     * 为空时由调用方自行保证生命周期。
+     *
+     * @param html UTF-8 编码的 HTML 内容
+     * @param keep_alive 缓冲区所有者，随文档一起释放
+     * @param options 解析选项（可选，默认为宽松模式）
+     * @return 解析后的文档对象智能指针
+     */
+    [[nodiscard]] std::shared_ptr<Document> parse_borrowed(
+        std::string_view html,
+        std::shared_ptr<const void> keep_alive = {},
+        const Options& options = {});
+
     /**
      * @brief 解析 HTML 片段
      * @param html HTML 片段内容
@@ -68,23 +100,79 @@ class HTMLParser : public NonCopyable {
     // 文件解析功能（扩展功能）
     /**
      * @brief 解析HTML文件
+     *
+     * 文件通过内存映射读取。UTF-8 文件不复制源码，文档的 source_html() 直接引用映射内容，
+     * 映射随文档一起释放。
+     *
      * @param filePath HTML文件路径
      * @param options 解析选项（可选，默认为宽松模式）
      * @return 解析后的文档对象智能指针
      */
     [[nodiscard]] std::shared_ptr<Document> parse_file(std::string_view filePath, const Options& options = {});
 
+    /**
+     * @brief 解析任意编码的原始 HTML 字节
+     *
+     * 按 BOM、传输层字符集、开头 1024 字节内的 meta charset 预扫描、UTF-8 前缀校验的顺序探测编码，
+     * 未能探测到编码时按 WHATWG 默认使用 windows-1252。输入随后一次性解码为文档源码：
+     * UTF-8 按块校验并复制，非法序列替换为 U+FFFD；其他编码由内置解码器转换。
+     *
+     * @param raw_bytes 原始字节
+     * @param options 解析选项（可选，默认为宽松模式）
+     * @param transport_charset 传输层声明的字符集（如 HTTP Content-Type 的 charset），为空时忽略
+     * @return 解析后的文档对象智能指针，编码不受支持时记录 UnsupportedEncoding 错误
+     */
+    [[nodiscard]] std::shared_ptr<Document> parse_bytes(
+        std::string_view raw_bytes,
+        const Options& options = {},
+        std::string_view transport_charset = {});
+
     // 错误信息访问（诊断功能）
     /**
      * @brief 获取解析过程中的错误列表
+     *
+     * 开启 Options::defer_error_locations 时，行列号在首次调用本函数时才计算。
+     *
      * @return 错误列表的常量引用
      */
-    [[nodiscard]] const std::vector<HPSError>& get_errors() const noexcept;
+    [[nodiscard]] const std::vector<HPSError>& get_errors() const;
+
+    /**
+     * @brief 获取最近一次解析的错误统计
+     *
+     * 各错误收集模式下都可用。Compact 模式下最近的错误由 get_errors() 按错误码描述格式化，
+     * CountOnly 模式下 get_errors() 只包含解析器自身产生的错误（如选项无效、Token 数超限）。
+     */
+    [[nodiscard]] const ErrorSummary& error_summary() const noexcept;
+
+    /**
+     * @brief 获取最近一次解析的完成状态
+     *
+     * 宽松模式下预算超限只记录错误并返回部分文档，调用方据此区分完整结果与部分结果；
+     * 严格模式下预算超限直接抛出异常。
+     */
+    [[nodiscard]] ParseStatus status() const noexcept;
 
   private:
-    std::vector<HPSError> m_errors;  ///< 解析错误列表
+    mutable std::vector<HPSError>            m_errors;             ///< 解析错误列表
+    mutable std::shared_ptr<const LineIndex> m_pending_locations;  ///< 延迟定位模式下用于补全行列号的行首表（不引用源码），补全后释放
+    ErrorSummary                             m_error_summary;      ///< 错误统计
+    mutable bool                             m_pending_compact_errors = false;  ///< 环形缓冲区中的错误尚未格式化
+    ParseStatus                              m_status = ParseStatus::Complete;  ///< 最近一次解析的完成状态
+
+    void reset_errors(const Options& options);
+    void stop_parsing(ParseStatus status, size_t position, const Options& options);
+    [[nodiscard]] std::shared_ptr<Document> reject_input(const Options& options);
+    void add_error(HPSError error);
+    void collect_errors(
+        Tokenizer& tokenizer,
+        TreeBuilder& builder,
+        const Options& options,
+        const std::shared_ptr<LineIndex>& line_index);
+    void defer_locations(const std::shared_ptr<LineIndex>& line_index);
 
     [[nodiscard]] std::shared_ptr<Document> parse_owned(std::string html, const Options& options);
+    [[nodiscard]] std::shared_ptr<Document> parse_document(std::shared_ptr<Document> document, const Options& options);
     [[nodiscard]] std::shared_ptr<Document> parse_fragment_owned(
         std::string html,
         std::string_view context_tag,
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "hps/parsing/tag_table.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace hps {
+
+/**
+ * @brief 被丢弃子树（超过 max_depth 或被剪除）的结束判定
+ *
+ * 维护子树内部的已打开元素栈（只记录标签槽，不建节点），按与 TreeBuilder 相同的规则判断子树在哪里结束：
+ * - 结束标签优先匹配子树内已打开的元素，匹配到根元素时子树结束并消耗该标签；
+ * - 开始标签先按 implicitly_closed_by 隐式关闭栈顶元素，根元素被隐式关闭（如 <p> 遇到 <div>）时子树结束，
+ *   该开始标签属于子树之外；
+ * - 不匹配子树内任何元素的结束标签由调用方判断：属于子树外已打开的元素（如被剪除的 <li> 遇到 </ul>）时子树结束，
+ *   否则作为错位标签丢弃。
+ *
+ * TreeBuilder 逐个 Token 处理与 Tokenizer 在原始输入上快速跳过共用同一个对象，两条路径的结束位置一致。
+ * 未知标签按哈希槽近似匹配。
+ */
+class IgnoredSubtree {
+  public:
+    /**
+     * @brief 处理一个标签后的结果
+     */
+    enum class Step : std::uint8_t {
+        Continue,   ///< 标签属于子树，已被消耗
+        Finished,   ///< 子树已结束：结束标签已被消耗，开始标签仍需按子树之外处理
+        Unmatched,  ///< 结束标签不匹配子树内的元素，由调用方决定结束子树或丢弃该标签
+    };
+
+    /**
+     * @brief 以 name 为根开始一棵被丢弃的子树
+     */
+    void begin(std::string_view name, TagInfo tag);
+
+    /**
+     * @brief 处理子树内的开始标签
+     * @param opens_element 标签是否打开元素（空元素与自闭合标签为 false）
+     * @return Continue 或 Finished
+     */
+    [[nodiscard]] Step start_tag(std::string_view name, TagInfo tag, bool opens_element);
+
+    /**
+     * @brief 处理子树内的结束标签
+     * @return Continue、Finished 或 Unmatched
+     */
+    [[nodiscard]] Step end_tag(std::string_view name, TagInfo tag) noexcept;
+
+    /**
+     * @brief 立即结束子树
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief 子树内尚未闭合的元素层数（包括根元素），为 0 表示没有被丢弃的子树
+     */
+    [[nodiscard]] size_t depth() const noexcept {
+        return m_open_slots.size();
+    }
+
+  private:
+    void pop() noexcept;
+
+    std::vector<std::uint16_t>                    m_open_slots;    ///< 子树内已打开元素的标签槽，栈底为根元素
+    std::array<std::uint32_t, kOpenTagSlotCount> m_open_counts{};  ///< 每个槽在栈中的元素个数
+};
+
+}  // namespace hps
@@ -1,7 +1,13 @@
 #pragma once
 
+#include "hps/parsing/tag_table.hpp"
+#include "hps/utils/cancellation.hpp"
+#include "hps/utils/transparent_hash.hpp"
+
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <limits>
 #include <string>
 #include <unordered_set>
 
@@ -18,6 +24,17 @@ enum class ErrorHandlingMode {
     Ignore    ///< 忽略模式，记录错误但继续解析
 };
 
+/**
+ * @brief 错误收集模式枚举
+ *
+ * 定义可恢复错误的记录方式。非 Full 模式下记录错误不构造消息字符串，也不分配内存。
+ */
+enum class ErrorCollectionMode {
+    Full,      ///< 记录完整错误（消息与位置）
+    Compact,   ///< 按错误码计数，并把最近的 (错误码, 偏移) 写入预分配的环形缓冲区，读取时再格式化
+    CountOnly  ///< 只按错误码计数
+};
+
 /**
  * @brief 空白文本处理模式枚举
  *
@@ -45,10 +62,15 @@ enum class CommentMode {
  * @brief 文本处理模式枚举
  *
  * 定义如何处理HTML文本内容中的实体和特殊标签。
+ *
+ * LazyDecode 模式下，文本节点与属性值在首次读取时解码并缓存，每个节点只解码一次。
+ * 多个线程可以同时读取同一个 const 文档；首次读取可能分配内存，内存不足时向读取方抛出 std::bad_alloc。
+ * 修改 DOM 仍需调用方自行同步。
  */
 enum class TextProcessingMode {
-    Raw,     ///< 保持原始文本，不进行任何转换
-    Decode,  ///< 解码HTML实体但保留标签
+    Raw,         ///< 保持原始文本，不进行任何转换
+    Decode,      ///< 解码HTML实体但保留标签
+    LazyDecode,  ///< 解码HTML实体，但推迟到首次读取文本或属性值时进行
 };
 
 /**
@@ -126,17 +148,21 @@ class Options {
     /**
      * @brief 创建性能优化配置
      *
-     * 性能模式下，解析器会移除注释和多余空白，
-     * 提高解析速度和内存效率，适用于大量HTML处理场景。
+     * 面向爬虫等吞吐优先场景：注释在词法分析阶段直接跳过，移除空白文本，
+     * script/style 内容、DOCTYPE 与 CDATA 段不产生 Token，错误只计数不记录。
+     * 需要进一步减少属性复制时可设置 attribute_allow_list。
      *
      * @return 配置为性能优化的Options实例
      */
     static Options performance() {
         Options opts;
-        opts.comment_mode    = CommentMode::Remove;
-        opts.whitespace_mode = WhitespaceMode::Remove;
-        opts.max_tokens      = 10000000;
-        opts.max_depth       = 2000;
+        opts.comment_mode              = CommentMode::Remove;
+        opts.whitespace_mode           = WhitespaceMode::Remove;
+        opts.error_collection          = ErrorCollectionMode::CountOnly;
+        opts.skip_script_style_content = true;
+        opts.skip_markup_declarations  = true;
+        opts.max_tokens                = 10000000;
+        opts.max_depth                 = 2000;
         return opts;
     }
 
@@ -178,10 +204,41 @@ class Options {
             return void_elements.contains(std::string(tag_name));
         }
 
-        // 优化的二分查找，避免构建 set
-        static constexpr std::array<std::string_view, 20> default_void_tags = {"area", "base", "basefont", "br", "col", "command", "embed", "frame", "hr", "img", "input", "isindex", "keygen", "link", "menuitem", "meta", "param", "source", "track", "wbr"};
+        // 默认集合直接读标签表的类别位，避免构建 set
+        return lookup_tag(tag_name).is(TagCategory::Void);
+    }
 
-        return std::binary_search(default_void_tags.begin(), default_void_tags.end(), tag_name);
+    /**
+     * @brief 是否设置了标签过滤（tag_allow_list 或 pruned_tags）
+     */
+    [[nodiscard]] bool has_tag_filters() const noexcept {
+        return !tag_allow_list.empty() || !pruned_tags.empty();
+    }
+
+    /**
+     * @brief 按 tag_allow_list 判断是否为该标签创建元素
+     *
+     * html/head/body 决定文档骨架，不受过滤影响。
+     */
+    [[nodiscard]] bool keeps_tag(std::string_view tag_name) const {
+        if (tag_allow_list.empty()) {
+            return true;
+        }
+        switch (lookup_tag(tag_name).id) {
+            case TagId::Html:
+            case TagId::Head:
+            case TagId::Body:
+                return true;
+            default:
+                return tag_allow_list.contains(tag_name);
+        }
+    }
+
+    /**
+     * @brief 该标签的整个子树是否被剪除
+     */
+    [[nodiscard]] bool is_pruned_tag(std::string_view tag_name) const {
+        return !pruned_tags.empty() && pruned_tags.contains(tag_name);
     }
 
     /**
@@ -226,6 +283,8 @@ class Options {
 
     // 核心解析选项
     ErrorHandlingMode error_handling = ErrorHandlingMode::Lenient;  ///< ✅ 错误处理模式，默认宽松模式
+    ErrorCollectionMode error_collection = ErrorCollectionMode::Full;  ///< 错误收集模式，默认记录完整错误
+    size_t              error_ring_capacity = 256;  ///< Compact 模式下保留的最近错误条数
 
     // 内容处理选项
     CommentMode        comment_mode         = CommentMode::Preserve;     ///< ✅ 注释处理模式，默认保留注释
@@ -237,6 +296,13 @@ class Options {
     // 高级选项
     bool preserve_case = false;  ///< ✅ 是否保持标签和属性名大小写，默认转为小写
     bool decode_entities = false; ///< ✅ 是否解码HTML实体，默认不解码（Zero-Copy优化）
+    bool build_query_indexes = false;  ///< 是否在解析期间同步构建 id/class/tag 查询索引，默认首次查询时再构建
+    bool transcode_file_input = false;  ///< parse_file 是否按探测到的字符集把非 UTF-8 文件转码，默认只接受 UTF-8 文件
+    bool defer_error_locations = false;  ///< 记录错误时只保存字节偏移，行列号在读取错误列表时再计算
+
+    // 内容模型捷径，跳过的内容不产生 Token，也不会出现在 DOM 中
+    bool skip_script_style_content = false;  ///< 跳过 <script>/<style> 的内容，元素本身保留但没有文本子节点
+    bool skip_markup_declarations  = false;  ///< 跳过 DOCTYPE 与 CDATA 段
 
     // 性能和安全限制
     size_t max_tokens                 = 1000000;  ///< 最大Token数量限制
@@ -246,11 +312,20 @@ class Options {
     size_t max_attribute_value_length = 8192;     ///< 属性值最大长度限制
     size_t max_text_length            = 1048576;  ///< 文本节点最大长度限制（1MB）
 
+    // 资源预算，超出时停止解析并通过 HTMLParser::status() 报告
+    size_t max_input_bytes = std::numeric_limits<size_t>::max();  ///< 输入源码最大字节数，超出时不解析，默认不限制
+    size_t max_dom_bytes   = std::numeric_limits<size_t>::max();  ///< DOM 估算内存上限，超出时返回已构建的部分文档，默认不限制
+    std::chrono::nanoseconds parse_timeout{0};                    ///< 单次解析的时间预算，超出时返回部分文档，0 表示不限制
+    CancellationToken        cancellation;                        ///< 协作式取消令牌，取消后返回部分文档
+
     // CSS 解析器配置
     size_t max_css3_cache_size = 1000;  ///< 最大缓存条目数量
 
     // 自定义配置
     std::unordered_set<std::string> void_elements;  ///< ✅ 自定义void元素列表，为空时使用默认列表
+    std::unordered_set<std::string> attribute_allow_list;  ///< 只保留列表中的属性（按解析后的属性名匹配），为空时保留全部属性
+    TransparentStringSet            tag_allow_list;  ///< 只创建列表中的元素，其余标签被丢弃、内容并入最近的保留祖先；html/head/body 始终保留，为空时不过滤
+    TransparentStringSet            pruned_tags;     ///< 整个子树都不创建的元素（如 svg、script），优先于 tag_allow_list；子树按正常构建规则结束，可省略结束标签的元素（如 p、li）随父元素结束
 
     // ==================== 便利方法 ====================
 
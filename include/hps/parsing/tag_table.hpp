@@ -0,0 +1,366 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace hps {
+
+/**
+ * @brief 树构建器按名称分派的已知标签
+ *
+ * 只收录插入规则、隐式关闭、表格与 select 作用域、空元素判断等处会用到的标签，其他标签为 Unknown。
+ */
+enum class TagId : std::uint8_t {
+    Unknown,
+    A,
+    Address,
+    Area,
+    Article,
+    Aside,
+    B,
+    Base,
+    BaseFont,
+    BgSound,
+    Big,
+    BlockQuote,
+    Body,
+    Br,
+    Button,
+    Caption,
+    Code,
+    Col,
+    ColGroup,
+    Command,
+    Dd,
+    Div,
+    Dl,
+    Dt,
+    Em,
+    Embed,
+    FieldSet,
+    Font,
+    Footer,
+    ForeignObject,
+    Form,
+    Frame,
+    H1,
+    H2,
+    H3,
+    H4,
+    H5,
+    H6,
+    Head,
+    Header,
+    HGroup,
+    Hr,
+    Html,
+    I,
+    Img,
+    Input,
+    IsIndex,
+    Keygen,
+    Li,
+    Link,
+    Main,
+    Math,
+    MenuItem,
+    Meta,
+    Nav,
+    Nobr,
+    NoFrames,
+    NoScript,
+    Ol,
+    OptGroup,
+    Option,
+    P,
+    Param,
+    PlainText,
+    Pre,
+    Rb,
+    Rp,
+    Rt,
+    Rtc,
+    S,
+    Script,
+    Section,
+    Select,
+    Small,
+    Source,
+    Span,
+    Strike,
+    Strong,
+    Style,
+    Svg,
+    Table,
+    Tbody,
+    Td,
+    Template,
+    TextArea,
+    Tfoot,
+    Th,
+    Thead,
+    Title,
+    Tr,
+    Track,
+    Tt,
+    U,
+    Ul,
+    Wbr,
+};
+
+/**
+ * @brief TagId 的取值个数
+ */
+inline constexpr size_t kTagIdCount = static_cast<size_t>(TagId::Wbr) + 1;
+
+/**
+ * @brief 标签类别位
+ */
+struct TagCategory {
+    enum : std::uint16_t {
+        HeadContent     = 1U << 0,  ///< body 出现前归入 head 的元素
+        TableSection    = 1U << 1,  ///< tbody / thead / tfoot
+        TableCell       = 1U << 2,  ///< td / th
+        TableRow        = 1U << 3,  ///< tr
+        TableStructure  = 1U << 4,  ///< 表格结构元素，不会被寄养到表格之前
+        FosterParent    = 1U << 5,  ///< 作为当前元素时，非表格内容需要寄养到表格之前
+        Formatting      = 1U << 6,  ///< 结束标签错位时重新打开的格式化元素
+        ParagraphCloser = 1U << 7,  ///< 开始标签隐式关闭打开的 <p>
+        OptionalEndTag  = 1U << 8,  ///< 文件结束时可以省略结束标签
+        Void            = 1U << 9,  ///< 默认空元素
+    };
+};
+
+/**
+ * @brief 标签编号与类别位
+ */
+struct TagInfo {
+    TagId         id{TagId::Unknown};
+    std::uint16_t categories{0};
+
+    [[nodiscard]] constexpr bool is(const std::uint16_t category) const noexcept {
+        return (categories & category) != 0;
+    }
+};
+
+namespace detail {
+
+struct TagEntry {
+    std::string_view name;
+    TagId            id;
+    std::uint16_t    categories;
+};
+
+inline constexpr std::array kTagEntries = std::to_array<TagEntry>({
+    {"a", TagId::A, TagCategory::Formatting},
+    {"address", TagId::Address, TagCategory::ParagraphCloser},
+    {"area", TagId::Area, TagCategory::Void},
+    {"article", TagId::Article, TagCategory::ParagraphCloser},
+    {"aside", TagId::Aside, TagCategory::ParagraphCloser},
+    {"b", TagId::B, TagCategory::Formatting},
+    {"base", TagId::Base, TagCategory::HeadContent | TagCategory::Void},
+    {"basefont", TagId::BaseFont, TagCategory::HeadContent | TagCategory::Void},
+    {"bgsound", TagId::BgSound, TagCategory::HeadContent},
+    {"big", TagId::Big, TagCategory::Formatting},
+    {"blockquote", TagId::BlockQuote, TagCategory::ParagraphCloser},
+    {"body", TagId::Body, TagCategory::OptionalEndTag},
+    {"br", TagId::Br, TagCategory::Void},
+    {"button", TagId::Button, 0},
+    {"caption", TagId::Caption, TagCategory::TableStructure | TagCategory::OptionalEndTag},
+    {"code", TagId::Code, TagCategory::Formatting},
+    {"col", TagId::Col, TagCategory::TableStructure | TagCategory::Void},
+    {"colgroup", TagId::ColGroup, TagCategory::TableStructure | TagCategory::OptionalEndTag},
+    {"command", TagId::Command, TagCategory::Void},
+    {"dd", TagId::Dd, TagCategory::OptionalEndTag},
+    {"div", TagId::Div, TagCategory::ParagraphCloser},
+    {"dl", TagId::Dl, TagCategory::ParagraphCloser},
+    {"dt", TagId::Dt, TagCategory::OptionalEndTag},
+    {"em", TagId::Em, TagCategory::Formatting},
+    {"embed", TagId::Embed, TagCategory::Void},
+    {"fieldset", TagId::FieldSet, TagCategory::ParagraphCloser},
+    {"font", TagId::Font, TagCategory::Formatting},
+    {"footer", TagId::Footer, TagCategory::ParagraphCloser},
+    {"foreignobject", TagId::ForeignObject, 0},
+    {"form", TagId::Form, TagCategory::ParagraphCloser},
+    {"frame", TagId::Frame, TagCategory::Void},
+    {"h1", TagId::H1, TagCategory::ParagraphCloser},
+    {"h2", TagId::H2, TagCategory::ParagraphCloser},
+    {"h3", TagId::H3, TagCategory::ParagraphCloser},
+    {"h4", TagId::H4, TagCategory::ParagraphCloser},
+    {"h5", TagId::H5, TagCategory::ParagraphCloser},
+    {"h6", TagId::H6, TagCategory::ParagraphCloser},
+    {"head", TagId::Head, TagCategory::OptionalEndTag},
+    {"header", TagId::Header, TagCategory::ParagraphCloser},
+    {"hgroup", TagId::HGroup, TagCategory::ParagraphCloser},
+    {"hr", TagId::Hr, TagCategory::ParagraphCloser | TagCategory::Void},
+    {"html", TagId::Html, TagCategory::OptionalEndTag},
+    {"i", TagId::I, TagCategory::Formatting},
+    {"img", TagId::Img, TagCategory::Void},
+    {"input", TagId::Input, TagCategory::Void},
+    {"isindex", TagId::IsIndex, TagCategory::Void},
+    {"keygen", TagId::Keygen, TagCategory::Void},
+    {"li", TagId::Li, TagCategory::OptionalEndTag},
+    {"link", TagId::Link, TagCategory::HeadContent | TagCategory::Void},
+    {"main", TagId::Main, TagCategory::ParagraphCloser},
+    {"math", TagId::Math, 0},
+    {"menuitem", TagId::MenuItem, TagCategory::Void},
+    {"meta", TagId::Meta, TagCategory::HeadContent | TagCategory::Void},
+    {"nav", TagId::Nav, TagCategory::ParagraphCloser},
+    {"nobr", TagId::Nobr, TagCategory::Formatting},
+    {"noframes", TagId::NoFrames, TagCategory::HeadContent},
+    {"noscript", TagId::NoScript, TagCategory::HeadContent},
+    {"ol", TagId::Ol, TagCategory::ParagraphCloser},
+    {"optgroup", TagId::OptGroup, TagCategory::OptionalEndTag},
+    {"option", TagId::Option, TagCategory::OptionalEndTag},
+    {"p", TagId::P, TagCategory::ParagraphCloser | TagCategory::OptionalEndTag},
+    {"param", TagId::Param, TagCategory::Void},
+    {"plaintext", TagId::PlainText, 0},
+    {"pre", TagId::Pre, TagCategory::ParagraphCloser},
+    {"rb", TagId::Rb, TagCategory::OptionalEndTag},
+    {"rp", TagId::Rp, TagCategory::OptionalEndTag},
+    {"rt", TagId::Rt, TagCategory::OptionalEndTag},
+    {"rtc", TagId::Rtc, TagCategory::OptionalEndTag},
+    {"s", TagId::S, TagCategory::Formatting},
+    {"script", TagId::Script, TagCategory::HeadContent},
+    {"section", TagId::Section, TagCategory::ParagraphCloser},
+    {"select", TagId::Select, 0},
+    {"small", TagId::Small, TagCategory::Formatting},
+    {"source", TagId::Source, TagCategory::Void},
+    {"span", TagId::Span, TagCategory::Formatting},
+    {"strike", TagId::Strike, TagCategory::Formatting},
+    {"strong", TagId::Strong, TagCategory::Formatting},
+    {"style", TagId::Style, TagCategory::HeadContent},
+    {"svg", TagId::Svg, 0},
+    {"table", TagId::Table, TagCategory::TableStructure | TagCategory::FosterParent | TagCategory::ParagraphCloser},
+    {"tbody", TagId::Tbody, TagCategory::TableSection | TagCategory::TableStructure | TagCategory::FosterParent | TagCategory::OptionalEndTag},
+    {"td", TagId::Td, TagCategory::TableCell | TagCategory::TableStructure | TagCategory::OptionalEndTag},
+    {"template", TagId::Template, TagCategory::HeadContent},
+    {"textarea", TagId::TextArea, 0},
+    {"tfoot", TagId::Tfoot, TagCategory::TableSection | TagCategory::TableStructure | TagCategory::FosterParent | TagCategory::OptionalEndTag},
+    {"th", TagId::Th, TagCategory::TableCell | TagCategory::TableStructure | TagCategory::OptionalEndTag},
+    {"thead", TagId::Thead, TagCategory::TableSection | TagCategory::TableStructure | TagCategory::FosterParent | TagCategory::OptionalEndTag},
+    {"title", TagId::Title, TagCategory::HeadContent},
+    {"tr", TagId::Tr, TagCategory::TableRow | TagCategory::TableStructure | TagCategory::FosterParent | TagCategory::OptionalEndTag},
+    {"track", TagId::Track, TagCategory::Void},
+    {"tt", TagId::Tt, TagCategory::Formatting},
+    {"u", TagId::U, TagCategory::Formatting},
+    {"ul", TagId::Ul, TagCategory::ParagraphCloser},
+    {"wbr", TagId::Wbr, TagCategory::Void},
+});
+
+inline constexpr size_t kMaxTagNameLength = 13;
+inline constexpr size_t kTagSlotCount     = 512;
+
+[[nodiscard]] constexpr char ascii_lower(const char c) noexcept {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+[[nodiscard]] constexpr size_t tag_hash(const std::string_view name) noexcept {
+    std::uint32_t hash = 2166136261U;
+    for (const char c : name) {
+        hash = (hash ^ static_cast<unsigned char>(ascii_lower(c))) * 16777619U;
+    }
+    return (hash ^ (hash >> 24)) & (kTagSlotCount - 1);
+}
+
+/**
+ * @brief 编译期构建的开放寻址表，槽位保存 kTagEntries 下标加一，0 表示空槽
+ */
+inline constexpr auto kTagSlots = [] {
+    std::array<std::uint8_t, kTagSlotCount> slots{};
+    for (size_t index = 0; index < kTagEntries.size(); ++index) {
+        size_t slot = tag_hash(kTagEntries[index].name);
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & (kTagSlotCount - 1);
+        }
+        slots[slot] = static_cast<std::uint8_t>(index + 1);
+    }
+    return slots;
+}();
+
+}  // namespace detail
+
+/**
+ * @brief 按名称（ASCII 大小写不敏感）查找标签编号与类别
+ *
+ * 一次哈希加一次比较即可完成，未收录的标签返回 TagId::Unknown 与空类别。
+ */
+[[nodiscard]] constexpr TagInfo lookup_tag(const std::string_view name) noexcept {
+    if (name.empty() || name.size() > detail::kMaxTagNameLength) {
+        return {};
+    }
+    for (size_t slot = detail::tag_hash(name);; slot = (slot + 1) & (detail::kTagSlotCount - 1)) {
+        const std::uint8_t entry_index = detail::kTagSlots[slot];
+        if (entry_index == 0) {
+            return {};
+        }
+        const auto& entry = detail::kTagEntries[entry_index - 1];
+        if (entry.name.size() == name.size()) {
+            bool equal = true;
+            for (size_t i = 0; i < name.size() && equal; ++i) {
+                equal = detail::ascii_lower(name[i]) == entry.name[i];
+            }
+            if (equal) {
+                return {entry.id, entry.categories};
+            }
+        }
+    }
+}
+
+/**
+ * @brief 开始标签 start_tag 是否隐式关闭位于栈顶的 open 元素（如 <p> 遇到 <div>、<li> 遇到 <li>）
+ *
+ * TreeBuilder 构建时与跳过被忽略子树时共用这一规则。
+ */
+[[nodiscard]] constexpr bool implicitly_closed_by(const TagId open, const TagInfo start_tag) noexcept {
+    switch (open) {
+        case TagId::P:
+            return start_tag.is(TagCategory::ParagraphCloser);
+        case TagId::Li:
+            return start_tag.id == TagId::Li;
+        case TagId::Dd:
+        case TagId::Dt:
+            return start_tag.id == TagId::Dd || start_tag.id == TagId::Dt;
+        case TagId::Button:
+            return start_tag.id == TagId::Button;
+        case TagId::Td:
+        case TagId::Th:
+            return start_tag.is(TagCategory::TableCell | TagCategory::TableRow | TagCategory::TableSection);
+        case TagId::Tr:
+            return start_tag.is(TagCategory::TableRow | TagCategory::TableSection) || start_tag.id == TagId::Table;
+        case TagId::Tbody:
+        case TagId::Tfoot:
+        case TagId::Thead:
+            return start_tag.is(TagCategory::TableSection) || start_tag.id == TagId::Table;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief 未知标签按名称哈希共享的槽数
+ */
+inline constexpr size_t kUnknownTagSlotCount = 64;
+
+/**
+ * @brief 已打开元素按标签分槽时的槽数：已知标签按 TagId 各占一槽，未知标签共享 kUnknownTagSlotCount 个槽
+ */
+inline constexpr size_t kOpenTagSlotCount = kTagIdCount + kUnknownTagSlotCount;
+
+/**
+ * @brief 标签所在的槽
+ */
+[[nodiscard]] constexpr size_t open_tag_slot(const std::string_view name, const TagInfo tag) noexcept {
+    if (tag.id != TagId::Unknown) {
+        return static_cast<size_t>(tag.id);
+    }
+    return kTagIdCount + (detail::tag_hash(name) & (kUnknownTagSlotCount - 1));
+}
+
+static_assert(lookup_tag("TABLE").id == TagId::Table);
+static_assert(lookup_tag("td").is(TagCategory::TableCell | TagCategory::TableStructure));
+static_assert(lookup_tag("custom-element").id == TagId::Unknown);
+
+}  // namespace hps
@@ -91,6 +91,12 @@ class Token : public NonCopyable {
      */
     [[nodiscard]] bool doctype_force_quirks() const noexcept;
 
+    /**
+     * @brief 文本内容中是否出现 '&'
+     * @return true 表示文本可能含有待解码的字符引用，由词法分析器在扫描文本时设置
+     */
+    [[nodiscard]] bool has_char_ref() const noexcept;
+
     // === 类型修改器 ===
 
     /**
@@ -120,6 +126,11 @@ class Token : public NonCopyable {
      */
     void set_doctype_force_quirks(bool force_quirks) noexcept;
 
+    /**
+     * @brief 设置文本是否可能含有待解码的字符引用
+     */
+    void set_has_char_ref(bool has_char_ref) noexcept;
+
     // === 属性管理（重要的扩展功能）===
 
     /**
@@ -243,6 +254,7 @@ class Token : public NonCopyable {
     std::string                 m_doctype_public_id;  ///< DOCTYPE public identifier
     std::string                 m_doctype_system_id;  ///< DOCTYPE system identifier
     bool                        m_doctype_force_quirks{false}; ///< DOCTYPE quirks flag
+    bool                        m_has_char_ref{false};  ///< 文本中是否出现 '&'
     std::vector<TokenAttribute> m_attrs;       ///< 属性列表，存储标签的所有属性信息
 };
 
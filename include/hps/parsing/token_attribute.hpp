@@ -18,6 +18,7 @@ struct TokenAttribute {
     std::string name;              ///< 属性名称
     std::string_view value;             ///< 属性值
     bool        has_value = true;  ///< 是否有值标志，区分 <input disabled> 和 <input disabled="true">
+    bool        has_char_ref = false;  ///< 属性值中是否出现 '&'，即可能含有待解码的字符引用
 
     /**
      * @brief 默认构造函数
@@ -31,15 +32,17 @@ struct TokenAttribute {
      * @param n 属性名（支持左值拷贝或右值移动）
      * @param v 属性值，默认为空字符串
      * @param hv 是否有值标志，默认为true
+     * @param char_ref 属性值中是否出现 '&'
      *
      * 使用按值传递（Pass-by-Value）惯用语，结合 std::move，
      * 既能处理左值也能处理右值，同时避免了重载带来的歧义。
      * 字符串字面量（const char*）会隐式转换为 std::string。
      */
-    explicit TokenAttribute(std::string n, const std::string_view v = {}, const bool hv = true)
+    explicit TokenAttribute(std::string n, const std::string_view v = {}, const bool hv = true, const bool char_ref = false)
         : name(std::move(n)),
           value(v),
-          has_value(hv) {}
+          has_value(hv),
+          has_char_ref(char_ref) {}
 };
 
 }  // namespace hps
\ No newline at end of file
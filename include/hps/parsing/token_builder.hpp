@@ -25,6 +25,7 @@ struct TokenBuilder {
     bool is_void_element = false;  ///< 是否为空元素（如<br>, <img>等）
     bool is_self_closing = false;  ///< 是否为自闭合标签（如<tag />）
     bool force_quirks    = false;  ///< DOCTYPE quirks flag
+    bool discard_attrs   = false;  ///< 所属标签被过滤或剪除，属性名不再收集
 
     // === 属性集合 ===
     std::vector<TokenAttribute> attrs;  ///< 已完成的属性列表
@@ -46,12 +47,13 @@ struct TokenBuilder {
      * @param name 属性名（按值传递）
      * @param value 属性值
      * @param has_value 是否有值，默认为true
+     * @param has_char_ref 属性值中是否出现 '&'
      *
      * 统一处理所有类型的属性名（左值string、右值string、C风格字符串）。
      * 内部使用移动语义优化性能。
      */
-    void add_attr(std::string name, std::string_view value, bool has_value = true) {
-        attrs.emplace_back(std::move(name), value, has_value);
+    void add_attr(std::string name, std::string_view value, bool has_value = true, bool has_char_ref = false) {
+        attrs.emplace_back(std::move(name), value, has_value, has_char_ref);
     }
 
     // === 状态管理方法 ===
@@ -70,6 +72,7 @@ struct TokenBuilder {
         is_void_element = false;
         is_self_closing = false;
         force_quirks    = false;
+        discard_attrs   = false;
         attrs.clear();
     }
 
@@ -3,8 +3,11 @@
 #include "hps/parsing/options.hpp"
 #include "hps/parsing/token.hpp"
 #include "hps/parsing/token_builder.hpp"
+#include "hps/utils/error_summary.hpp"
 #include "hps/utils/exception.hpp"
+#include "hps/utils/line_index.hpp"
 
+#include <memory>
 #include <optional>
 
 namespace hps {
@@ -70,6 +73,19 @@ class Tokenizer : public NonCopyable {
      */
     [[nodiscard]] std::vector<Token> tokenize_all();
 
+    /**
+     * @brief 跳过被忽略的子树
+     *
+     * 树构建器丢弃元素（超过 max_depth 或被剪除）时，直接在原始输入上向前扫描，按 IgnoredSubtree 的规则
+     * 跟踪子树内的元素，跳过注释与原始文本元素的内容，直到子树结束或输入结束。
+     * 隐式关闭子树根元素的开始标签与不匹配子树内元素的结束标签不被跳过，词法分析器停在它们之前，
+     * 由树构建器按同一规则处理。扫描不产生 Token、不记录错误，只复用 subtree 已有的栈空间。
+     *
+     * @param subtree 树构建器中被丢弃子树的状态，扫描时同步更新
+     * @return 词法分析器处于 Data 状态并完成了扫描时返回 true；处于原始文本等其他状态时不做任何事并返回 false
+     */
+    bool skip_ignored_subtree(IgnoredSubtree& subtree);
+
     // ==================== 状态查询方法 ====================
 
     /**
@@ -105,6 +121,19 @@ class Tokenizer : public NonCopyable {
      */
     [[nodiscard]] std::vector<HPSError> consume_errors();
 
+    /**
+     * @brief 非 Full 错误收集模式下的错误统计
+     */
+    [[nodiscard]] const ErrorSummary& error_summary() const noexcept;
+
+    /**
+     * @brief 使用外部共享的换行索引计算错误位置
+     *
+     * HTMLParser 让词法分析器与树构建器共用一个索引；未设置时首次记录错误才创建自己的索引。
+     * 索引必须建立在同一份源码上。
+     */
+    void set_line_index(std::shared_ptr<const LineIndex> line_index);
+
   private:
     // ==================== 状态处理方法 ====================
 
@@ -281,6 +310,11 @@ class Tokenizer : public NonCopyable {
     std::optional<Token> emit_text_token(std::string_view data);
     std::optional<Token> emit_owned_text_token(std::string data);
 
+    /**
+     * @brief 发射原始文本元素的内容，开启 Options::skip_script_style_content 时 script/style 内容不产生 Token
+     */
+    std::optional<Token> emit_raw_text_token(std::string_view data);
+
     /**
      * @brief 创建注释 Token
      * @param comment 注释内容
@@ -315,15 +349,20 @@ class Tokenizer : public NonCopyable {
      * @param code 错误代码
      * @param message 错误消息
      */
-    void handle_parse_error(ErrorCode code, const std::string& message);
-    void record_recoverable_error(ErrorCode code, const std::string& message);
+    void handle_parse_error(ErrorCode code, std::string_view message);
+    void record_recoverable_error(ErrorCode code, std::string_view message);
 
     /**
-     * @brief 记录解析错误到错误列表
+     * @brief 记录解析错误到错误列表，非 Full 收集模式下只写入错误统计
      * @param code 错误代码
      * @param message 错误消息
      */
-    void record_error(ErrorCode code, const std::string& message);
+    void record_error(ErrorCode code, std::string_view message);
+
+    /**
+     * @brief 当前位置的行列号，经共享的换行索引计算
+     */
+    [[nodiscard]] Location current_location();
 
     /**
      * @brief 转换到Data状态
@@ -339,7 +378,7 @@ class Tokenizer : public NonCopyable {
     std::string_view m_source;   ///< 输入HTML字符串视图，保存待解析的源代码
     size_t           m_pos;      ///< 当前解析位置索引，指向下一个要处理的字符
     TokenizerState   m_state;    ///< 当前词法分析器状态，控制解析行为
-    const Options&   m_options;  ///< 解析配置
+    Options          m_options;  ///< 解析配置（按值持有，避免悬垂引用临时对象）
 
     // ==================== 解析辅助成员变量 ====================
 
@@ -347,6 +386,8 @@ class Tokenizer : public NonCopyable {
     std::string           m_end_tag;           ///< 当前正在解析的结束标签名称缓存
     std::string           m_last_start_tag;    ///< 最近一次发射的开始标签名称
     std::vector<HPSError> m_errors;            ///< 解析过程中收集的所有错误信息列表
+    ErrorSummary          m_error_summary;     ///< 非 Full 收集模式下的错误统计
+    std::shared_ptr<const LineIndex> m_line_index;  ///< 换行索引，首次记录错误时创建或由解析器注入
     std::string           m_char_ref_buffer;   ///< 字符引用解析缓冲区，用于处理HTML实体
     size_t                m_attr_value_start;  ///< 属性值起始位置（Zero-Copy优化）
 };
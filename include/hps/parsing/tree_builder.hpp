@@ -1,10 +1,17 @@
 #pragma once
 
 #include "hps/core/element.hpp"
+#include "hps/parsing/ignored_subtree.hpp"
 #include "hps/parsing/options.hpp"
+#include "hps/parsing/tag_table.hpp"
+#include "hps/utils/error_summary.hpp"
 #include "hps/utils/exception.hpp"
+#include "hps/utils/line_index.hpp"
 #include "hps/utils/noncopyable.hpp"
 
+#include <array>
+#include <cstdint>
+#include <initializer_list>
 #include <utility>
 
 namespace hps {
@@ -57,6 +64,23 @@ class TreeBuilder : public NonCopyable {
      */
     [[nodiscard]] bool finish();
 
+    /**
+     * @brief 被丢弃子树（超过深度限制或被剪除）中尚未闭合的元素层数，为 0 表示正常构建
+     */
+    [[nodiscard]] size_t ignored_depth() const noexcept;
+
+    /**
+     * @brief 被丢弃子树的状态，供词法分析器在原始输入上跳过子树时同步更新
+     */
+    [[nodiscard]] IgnoredSubtree& ignored_subtree() noexcept;
+
+    /**
+     * @brief 已构建 DOM 的估算字节数
+     *
+     * 按节点对象大小加上标签名、属性与文本内容的字节数累计，用于 Options::max_dom_bytes 预算检查。
+     */
+    [[nodiscard]] size_t dom_bytes() const noexcept;
+
     /**
      * @brief 获取解析过程中的错误列表
      * @return 解析错误列表的常量引用
@@ -74,6 +98,16 @@ class TreeBuilder : public NonCopyable {
      */
     [[nodiscard]] std::vector<HPSError> consume_errors();
 
+    /**
+     * @brief 非 Full 错误收集模式下的错误统计
+     */
+    [[nodiscard]] const ErrorSummary& error_summary() const noexcept;
+
+    /**
+     * @brief 使用外部共享的换行索引计算错误位置，未设置时首次记录错误才创建自己的索引
+     */
+    void set_line_index(std::shared_ptr<const LineIndex> line_index);
+
   private:
     // === Token处理方法 ===
 
@@ -121,11 +155,11 @@ class TreeBuilder : public NonCopyable {
      *
      * 静态方法，根据Token中的标签名和属性创建相应的Element对象。
      */
-    [[nodiscard]] static std::unique_ptr<Element> create_element(const Token& token);
-    [[nodiscard]] static std::unique_ptr<Element> create_element(
+    [[nodiscard]] std::unique_ptr<Element> create_element(const Token& token) const;
+    [[nodiscard]] std::unique_ptr<Element> create_element(
         const Token& token,
-        NamespaceKind namespace_kind);
-    static void merge_token_attributes(Element& element, const Token& token);
+        NamespaceKind namespace_kind) const;
+    void merge_token_attributes(Element& element, const Token& token) const;
 
     /**
      * @brief 将元素插入到DOM树中
@@ -139,9 +173,11 @@ class TreeBuilder : public NonCopyable {
      * @brief 插入文本节点
      * @param text 要插入的文本内容
      *
+     * @param needs_decode 文本是否含有待解码的字符引用，惰性解码时为 true
+     *
      * 在当前元素下创建并插入文本节点。
      */
-    void insert_text(std::string_view text) const;
+    void insert_text(std::string_view text, bool needs_decode = false) const;
 
     /**
      * @brief 插入注释节点
@@ -160,8 +196,14 @@ class TreeBuilder : public NonCopyable {
      * 将元素添加到栈顶，成为新的当前元素。
      */
     void push_element(Element* element);
+    void push_element(Element* element, TagInfo tag);
     void push_if_absent(Element* element);
 
+    /**
+     * @brief 弹出栈顶元素，同时维护同名元素链
+     */
+    void pop_element() noexcept;
+
     /**
      * @brief 获取当前元素（栈顶元素）
      * @return 当前元素的原始指针，如果栈为空则返回nullptr
@@ -169,6 +211,7 @@ class TreeBuilder : public NonCopyable {
      * 返回栈顶元素但不移除它，用于确定新节点的插入位置。
      */
     [[nodiscard]] Element* current_element() const;
+    [[nodiscard]] TagInfo current_tag() const noexcept;
     [[nodiscard]] bool is_on_stack(const Element* element) const noexcept;
 
     /**
@@ -182,19 +225,19 @@ class TreeBuilder : public NonCopyable {
 
     /**
      * @brief 检查并处理隐含关闭的标签
-     * @param tag_name 当前遇到的开始标签名称
+     * @param tag 当前遇到的开始标签
      *
      * 如果当前栈顶元素是可以被新标签隐含关闭的（如 <p> 遇到 <p>），则自动关闭栈顶元素。
      */
-    void check_implicit_close(std::string_view tag_name);
+    void check_implicit_close(TagInfo tag);
     void ensure_html_element();
     void ensure_head_element();
     void ensure_body_element();
     void close_head_element_if_open();
-    void prepare_table_context_for_start_tag(std::string_view tag_name);
-    void prepare_select_context_for_start_tag(std::string_view tag_name);
-    [[nodiscard]] bool handle_table_end_tag(std::string_view tag_name);
-    [[nodiscard]] bool handle_select_end_tag(std::string_view tag_name);
+    void prepare_table_context_for_start_tag(TagInfo tag);
+    void prepare_select_context_for_start_tag(TagInfo tag);
+    [[nodiscard]] bool handle_table_end_tag(std::string_view tag_name, TagInfo tag);
+    [[nodiscard]] bool handle_select_end_tag(TagInfo tag);
     void close_open_table_content_before_container(std::string_view tag_name, bool close_matching_tag = true);
     void ensure_table_section(std::string_view tag_name = "tbody");
     void ensure_table_row();
@@ -202,20 +245,20 @@ class TreeBuilder : public NonCopyable {
     void close_colgroup_for_non_col_token();
     Node* insert_node(std::unique_ptr<Node> child, Node* parent) const;
     Node* insert_node_before(std::unique_ptr<Node> child, Node* parent, const Node* before) const;
-    void insert_text_before(std::string_view text, Node* parent, const Node* before) const;
-
-    [[nodiscard]] static bool is_head_content_tag(std::string_view tag_name) noexcept;
-    [[nodiscard]] static bool is_table_section_tag(std::string_view tag_name) noexcept;
-    [[nodiscard]] static bool is_table_cell_tag(std::string_view tag_name) noexcept;
-    [[nodiscard]] static bool is_table_structure_tag(std::string_view tag_name) noexcept;
-    [[nodiscard]] static bool is_table_container_tag(std::string_view tag_name) noexcept;
-    [[nodiscard]] static bool is_adoption_formatting_tag(std::string_view tag_name) noexcept;
+    void insert_text_before(std::string_view text, Node* parent, const Node* before, bool needs_decode = false) const;
+
+    [[nodiscard]] bool decodes_entities() const noexcept;
+
+    [[nodiscard]] size_t topmost_open(std::initializer_list<TagId> tags) const noexcept;
+    [[nodiscard]] Element* open_element_above_table(std::initializer_list<TagId> tags) const noexcept;
+    [[nodiscard]] size_t find_open_position(std::string_view tag_name, bool include_fragment_base) const noexcept;
+    [[nodiscard]] bool is_void_element(std::string_view tag_name, TagInfo tag) const;
     [[nodiscard]] NamespaceKind current_insertion_namespace() const noexcept;
-    [[nodiscard]] NamespaceKind namespace_for_start_tag(std::string_view tag_name) const noexcept;
+    [[nodiscard]] NamespaceKind namespace_for_start_tag(TagInfo tag) const noexcept;
     [[nodiscard]] static bool can_omit_end_tag_at_eof(std::string_view tag_name) noexcept;
     [[nodiscard]] static bool is_all_whitespace(std::string_view text) noexcept;
     [[nodiscard]] bool should_foster_parent_text() const noexcept;
-    [[nodiscard]] bool should_foster_parent_element(std::string_view tag_name) const noexcept;
+    [[nodiscard]] bool should_foster_parent_element(TagInfo tag) const noexcept;
     [[nodiscard]] std::pair<Node*, const Node*> foster_parent_insertion_point() const noexcept;
     void close_foster_parented_elements_before_table_token() noexcept;
     [[nodiscard]] bool try_recover_formatting_end_tag(std::string_view tag_name);
@@ -235,13 +278,51 @@ class TreeBuilder : public NonCopyable {
      * @param message 错误描述信息
      *
      * 将解析错误添加到错误列表中，用于后续的错误报告和调试。
+     * 非 Full 收集模式下只写入错误统计，不构造消息。
+     */
+    void parse_error(ErrorCode code, std::string_view message, size_t position = 0);
+
+    /**
+     * @brief 记录消息由两段拼接而成的解析错误，只有需要完整消息时才拼接
      */
-    void parse_error(ErrorCode code, const std::string& message, size_t position = 0);
+    void parse_error(ErrorCode code, std::string_view prefix, std::string_view detail, size_t position = 0);
 
   private:
+    /**
+     * @brief 按 Options::tag_allow_list 与 pruned_tags 过滤标签 Token
+     * @return Token 已被过滤时返回 true；剪除的元素进入忽略子树状态
+     */
+    [[nodiscard]] bool filter_tag_token(const Token& token);
+
+    /**
+     * @brief 丢弃以 tag_name 为根的子树，结束位置由 IgnoredSubtree 判定
+     */
+    void begin_ignored_subtree(std::string_view tag_name, TagInfo tag);
+
+    /**
+     * @brief 在被丢弃的子树中处理一个 Token
+     * @return Token 属于子树、已被丢弃时返回 true；子树已结束、Token 需要正常处理时返回 false
+     */
+    [[nodiscard]] bool process_ignored_token(const Token& token);
+
+    /**
+     * @brief 栈中元素的标签信息与同名元素链
+     *
+     * 已知标签按 TagId 分槽，未知标签按名称哈希分到若干共享槽。每个槽记录最上层的同槽元素，
+     * 每个栈项记录下一个更靠下的同槽元素，"某标签是否打开"与各作用域查询因此不必扫描整个栈。
+     * 位置均以栈下标加一存储，0 表示没有。
+     */
+    struct OpenElementLink {
+        TagInfo       tag;
+        std::uint16_t slot{0};
+        std::uint32_t previous{0};  ///< 更靠下的同槽元素位置
+    };
+
     std::shared_ptr<Document> m_document;       ///< 目标文档对象，存储构建的DOM树
     std::vector<Element*>     m_element_stack;  ///< 元素栈，跟踪当前的嵌套结构
-    std::vector<std::string>  m_ignored_element_stack;  ///< 超过深度限制后跳过的元素栈
+    std::vector<OpenElementLink> m_element_links;  ///< 与元素栈一一对应的标签信息
+    std::array<std::uint32_t, kOpenTagSlotCount> m_topmost_open{};  ///< 每个槽最上层元素的位置
+    IgnoredSubtree            m_ignored_subtree;  ///< 被丢弃的子树
     std::vector<HPSError>     m_errors;         ///< 解析错误列表，收集处理过程中的错误
     const Options&            m_options;        ///< 解析选项
     size_t                    m_last_position = 0;  ///< 最近处理到的源码位置
@@ -251,6 +332,10 @@ class TreeBuilder : public NonCopyable {
     Element*                  m_fragment_context = nullptr;  ///< fragment 解析上下文元素
     size_t                    m_stack_floor      = 0;        ///< fragment 栈底，不允许弹出
     bool                      m_head_closed  = false;    ///< head 是否已经结束
+    std::string               m_text_buffer;             ///< 文本解码与空白处理的复用缓冲区
+    std::shared_ptr<const LineIndex> m_line_index;       ///< 换行索引，首次记录错误时创建或由解析器注入
+    ErrorSummary              m_error_summary;           ///< 非 Full 收集模式下的错误统计
+    mutable size_t            m_dom_bytes = 0;           ///< 已构建 DOM 的估算字节数
 };
 
 }  // namespace hps
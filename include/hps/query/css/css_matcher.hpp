@@ -28,7 +28,7 @@ class CSSMatcher {
      * 在指定元素的后代中查找所有匹配选择器列表的元素
      * @param element 元素
      * @param selector_list 选择器列表
-     * @return 匹配的元素列表（去重）
+     * @return 匹配的元素列表（按文档顺序，单次遍历每个元素至多出现一次）
      */
     static std::vector<const Element*> find_all(const Element& element, const SelectorList& selector_list);
 
@@ -44,7 +44,7 @@ class CSSMatcher {
      * 在文档中查找所有匹配选择器列表的元素
      * @param document 文档对象
      * @param selector_list 选择器列表
-     * @return 匹配的元素列表（去重）
+     * @return 匹配的元素列表（按文档顺序，单次遍历每个元素至多出现一次）
      */
     static std::vector<const Element*> find_all(const Document& document, const SelectorList& selector_list);
 
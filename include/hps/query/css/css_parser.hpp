@@ -311,11 +311,6 @@ class PseudoClassSelector : public CSSSelector {
         return m_sub_selectors.get();
     }
 
-  private:
-    PseudoType                    m_pseudo_type;    ///< 伪类类型
-    std::string_view              m_argument;       ///< 伪类参数（用于nth-child(n)等带参数的伪类）
-    std::unique_ptr<SelectorList> m_sub_selectors;  ///< 子选择器列表（用于:is, :where, :has, :not等）
-
     /**
      * @brief 解析nth-child表达式
      * @param expression nth表达式（如"2n+1"、"odd"、"even"）
@@ -324,6 +319,12 @@ class PseudoClassSelector : public CSSSelector {
      */
     [[nodiscard]] static bool matches_nth_expression(std::string_view expression, int index);
 
+  private:
+    PseudoType                    m_pseudo_type;    ///< 伪类类型
+    std::string_view              m_argument;       ///< 伪类参数（用于nth-child(n)等带参数的伪类）
+    std::unique_ptr<SelectorList> m_sub_selectors;  ///< 子选择器列表（用于:is, :where, :has, :not等）
+
+
     /**
      * @brief 获取同类型兄弟元素的数量
      * @param element 目标元素
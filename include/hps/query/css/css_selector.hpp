@@ -220,12 +220,13 @@ class AttributeSelector : public CSSSelector {
         return {.inline_style = 0, .ids = 0, .classes = 1, .elements = 0};  // 属性选择器优先级为10
     }
 
+    // 按操作符比较给定属性值，供不经过 Element 的匹配器复用
+    [[nodiscard]] bool matches_attribute_value(std::string_view attr_value) const;
+
   private:
     std::string_view  m_attr_name;
     AttributeOperator m_operator;
     std::string_view  m_value;
-
-    [[nodiscard]] bool matches_attribute_value(std::string_view attr_value) const;
 };
 
 // 组合选择器基类
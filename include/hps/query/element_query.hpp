@@ -352,6 +352,14 @@ class ElementQuery {
      */
     [[nodiscard]] ElementQuery lt(size_t index) const;
 
+    /**
+     * @brief 按文档顺序排序并去重 Sort elements into document order and remove duplicates
+     * @return 新的 ElementQuery New ElementQuery
+     *
+     * 基于 Element::document_order() 比较，不属于任何文档的元素排在最前。
+     */
+    [[nodiscard]] ElementQuery sort_by_document_order() const;
+
     // 聚合方法 Aggregation methods
 
     /**
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace hps {
+
+/**
+ * @brief 协作式取消令牌
+ *
+ * 令牌的副本共享同一个取消标志，可以放进 Options 交给解析线程，再由其他线程调用 cancel()。
+ * 解析器每处理一批 Token 检查一次标志，被取消时停止构建并返回已构建的部分文档。
+ * 默认构造的令牌没有共享状态，永远不会被取消。
+ */
+class CancellationToken {
+  public:
+    CancellationToken() = default;
+
+    /**
+     * @brief 创建一个可以取消的令牌
+     */
+    [[nodiscard]] static CancellationToken create() {
+        CancellationToken token;
+        token.m_cancelled = std::make_shared<std::atomic<bool>>(false);
+        return token;
+    }
+
+    /**
+     * @brief 请求取消，对共享同一标志的所有副本生效
+     */
+    void cancel() const noexcept {
+        if (m_cancelled) {
+            m_cancelled->store(true, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief 是否已请求取消
+     */
+    [[nodiscard]] bool is_cancelled() const noexcept {
+        return m_cancelled && m_cancelled->load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 令牌是否可以被取消（由 create() 创建）
+     */
+    [[nodiscard]] bool can_be_cancelled() const noexcept {
+        return m_cancelled != nullptr;
+    }
+
+  private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;  ///< 共享的取消标志，默认令牌为空
+};
+
+}  // namespace hps
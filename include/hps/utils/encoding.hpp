@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -14,6 +15,7 @@ enum class EncodingHintSource : std::uint8_t {
     Utf16BeBom,
     MetaCharset,
     Utf8Heuristic,
+    TransportCharset,
 };
 
 struct EncodingHint {
@@ -27,7 +29,38 @@ struct EncodingHint {
     }
 };
 
-[[nodiscard]] EncodingHint sniff_html_encoding(std::string_view raw_bytes);
+/**
+ * @brief 按 WHATWG 编码嗅探顺序探测 HTML 字节的编码
+ *
+ * 优先级依次为 BOM、传输层字符集（如 HTTP Content-Type 中的 charset）、开头 1024 字节内的
+ * meta charset 预扫描，最后检查开头 1024 字节是否为合法 UTF-8。探测只读取有界前缀，
+ * 因此 Utf8Heuristic 结果不保证整个输入都是合法 UTF-8。
+ *
+ * @param raw_bytes 原始字节
+ * @param transport_charset 传输层声明的字符集标签，为空时忽略
+ */
+[[nodiscard]] EncodingHint sniff_html_encoding(std::string_view raw_bytes, std::string_view transport_charset = {});
+
+/**
+ * @brief 返回开头连续 ASCII 字节（0x00-0x7F）的长度
+ *
+ * x86-64 上每次检查 16 字节，其他平台每次检查 8 字节，供各解码器整段复制 ASCII 使用。
+ */
+[[nodiscard]] size_t ascii_prefix_length(std::string_view input) noexcept;
+
+/**
+ * @brief 校验输入是否为合法 UTF-8（拒绝过长编码、代理项与超出 U+10FFFF 的码位）
+ *
+ * 支持 SSSE3 的 x86-64 CPU 上每次校验 16 字节，其他情况使用逐字节校验并整段跳过 ASCII。
+ */
+[[nodiscard]] bool is_valid_utf8(std::string_view input) noexcept;
+
+/**
+ * @brief 按 WHATWG UTF-8 解码算法把字节追加到 out，非法序列替换为 U+FFFD
+ *
+ * 以 64 KiB 为块校验，合法块整块复制，只有包含非法序列的块才逐字节解码。
+ */
+void decode_utf8_with_replacement(std::string_view bytes, std::string& out);
 
 [[nodiscard]] std::optional<std::string> decode_html_bytes_to_utf8(
     std::string_view raw_bytes,
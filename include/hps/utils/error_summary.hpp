@@ -0,0 +1,101 @@
+#pragma once
+#include "hps/utils/exception.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace hps {
+
+/**
+ * @brief 只含错误码与字节偏移的紧凑错误记录
+ */
+struct CompactError {
+    ErrorCode code{ErrorCode::Success};
+    size_t    position{0};
+};
+
+/**
+ * @brief 错误统计：按错误码计数，并在预分配的环形缓冲区中保留最近的紧凑错误记录
+ *
+ * record() 不分配内存也不构造消息，适合在大规模抓取时只统计错误；
+ * 消息与行列号在读取时由 HTMLParser 按需生成。
+ */
+class ErrorSummary {
+  public:
+    /**
+     * @param ring_capacity 保留的最近错误条数，为 0 时只计数
+     */
+    explicit ErrorSummary(size_t ring_capacity = 0);
+
+    /**
+     * @brief 记录一个错误
+     */
+    void record(ErrorCode code, size_t position) noexcept {
+        ++m_counts[static_cast<size_t>(code)];
+        ++m_total;
+        if (!m_ring.empty()) {
+            m_ring[m_next] = CompactError{code, position};
+            m_next         = m_next + 1 == m_ring.size() ? 0 : m_next + 1;
+            ++m_recorded;
+        }
+    }
+
+    /**
+     * @brief 只计数，不进入环形缓冲区
+     */
+    void count(const ErrorCode code) noexcept {
+        ++m_counts[static_cast<size_t>(code)];
+        ++m_total;
+    }
+
+    /**
+     * @brief 合并另一份统计：计数相加，最近记录按偏移合并后保留容量允许的最后若干条
+     */
+    void merge(const ErrorSummary& other);
+
+    void clear() noexcept;
+
+    /**
+     * @brief 错误总数
+     */
+    [[nodiscard]] size_t total() const noexcept {
+        return m_total;
+    }
+
+    /**
+     * @brief 指定错误码的数量
+     */
+    [[nodiscard]] size_t count_of(const ErrorCode code) const noexcept {
+        return m_counts[static_cast<size_t>(code)];
+    }
+
+    /**
+     * @brief 环形缓冲区中保留的最近错误，按记录顺序从旧到新
+     */
+    [[nodiscard]] std::vector<CompactError> recent() const;
+
+    /**
+     * @brief 未保留在环形缓冲区中的错误数量
+     */
+    [[nodiscard]] size_t dropped() const noexcept;
+
+    [[nodiscard]] size_t ring_capacity() const noexcept {
+        return m_ring.size();
+    }
+
+  private:
+    std::array<size_t, kErrorCodeCount> m_counts{};
+    std::vector<CompactError>           m_ring;         ///< 预分配的环形缓冲区
+    size_t                              m_next{0};      ///< 下一条记录的写入位置
+    size_t                              m_total{0};     ///< 错误总数
+    size_t                              m_recorded{0};  ///< 写入过环形缓冲区的记录数
+};
+
+/**
+ * @brief 错误码的默认英文描述，用于延迟格式化紧凑错误记录
+ */
+[[nodiscard]] std::string_view error_code_description(ErrorCode code) noexcept;
+
+}  // namespace hps
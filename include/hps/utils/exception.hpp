@@ -18,6 +18,20 @@ struct Location {
           line(line),
           column(column) {}
 
+    /**
+     * @brief 只记录字节偏移、行列号待稍后计算的位置
+     */
+    [[nodiscard]] static Location unresolved(const size_t position) noexcept {
+        return Location(position, 0, 0);
+    }
+
+    /**
+     * @brief 行列号是否已经计算
+     */
+    [[nodiscard]] bool resolved() const noexcept {
+        return line != 0;
+    }
+
     static Location from_position(const std::string_view source, const size_t position) {
         const size_t clamped_position = position > source.size() ? source.size() : position;
 
@@ -62,8 +76,10 @@ enum class ErrorCode {
     // Parser 错误
     InvalidHTML,
     ParseTimeout,
+    ParseCancelled,
     QuirksMode,
     FileReadError,
+    FileWriteError,
     UnsupportedEncoding,
 
     // Query 错误
@@ -72,8 +88,19 @@ enum class ErrorCode {
     InvalidXPath,
     XPathParseError,
     XPathEvaluationError,
+
+    // 快照错误
+    InvalidSnapshot,
+
+    // 归档错误
+    InvalidArchive,
 };
 
+/**
+ * @brief 错误码数量，新增错误码时需同步更新
+ */
+inline constexpr size_t kErrorCodeCount = static_cast<size_t>(ErrorCode::InvalidArchive) + 1;
+
 // 错误信息结构体
 struct HPSError {
     ErrorCode   code;
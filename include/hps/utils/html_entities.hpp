@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace hps {
+
+/**
+ * @brief 命名字符引用的匹配结果
+ */
+struct NamedEntityMatch {
+    size_t           length{0};   /**< 匹配到的名称长度（含结尾分号，如有） */
+    std::string_view replacement; /**< UTF-8 替换文本 */
+};
+
+/**
+ * @brief 在输入开头查找最长的 HTML5 命名字符引用
+ *
+ * 覆盖 WHATWG 规范的完整命名字符引用表，包括 "amp"、"not" 等无分号的历史写法。
+ * 查找基于编译期生成的字典树，耗时只与名称长度相关。
+ *
+ * @param input '&' 之后的文本
+ * @return 最长匹配，没有任何匹配时返回 std::nullopt
+ */
+[[nodiscard]] std::optional<NamedEntityMatch> match_named_entity(std::string_view input) noexcept;
+
+/**
+ * @brief 解码文本内容中的字符引用，并把结果追加到输出缓冲区
+ *
+ * 按 HTML5 文本内容的规则处理命名引用（最长匹配，允许历史无分号写法）和数字引用
+ * （分号可省略，0、代理项与越界值替换为 U+FFFD，0x80–0x9F 按 windows-1252 重映射）。
+ * 无法识别的 '&' 原样保留；&nbsp; 沿用既有约定解码为普通空格。
+ *
+ * @param text 待解码文本
+ * @param out 输出缓冲区，解码结果追加在已有内容之后
+ * @param in_attribute 是否为属性值：属性值中无分号的命名引用后接 '=' 或字母数字时不解码（如 href="?a=1&copy=2"）
+ */
+void decode_html_entities(std::string_view text, std::string& out, bool in_attribute = false);
+
+/**
+ * @brief 解码文本内容中的字符引用并合并空白，结果追加到输出缓冲区
+ *
+ * 等价于先 decode_html_entities 再把连续空白合并为单个空格，但只遍历一次输入：
+ * 普通片段整段复制，引用解码出的空白（如 &#10;、&nbsp;）同样参与合并。
+ */
+void decode_html_entities_normalized(std::string_view text, std::string& out);
+
+/**
+ * @brief 解码HTML实体
+ *
+ * @param text 包含HTML实体的文本
+ * @return 解码后的文本
+ */
+[[nodiscard]] inline std::string decode_html_entities(const std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    decode_html_entities(text, out);
+    return out;
+}
+
+}  // namespace hps
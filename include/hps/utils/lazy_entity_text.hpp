@@ -0,0 +1,148 @@
+#pragma once
+
+#include "hps/utils/html_entities.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace hps {
+
+/**
+ * @brief 推迟解码字符引用的文本
+ *
+ * 保存原始文本，首次读取时才解码字符引用并缓存结果。解码由原子状态保证每个对象只执行一次：
+ * 多个线程可以同时读取同一个 const 对象，抢到解码权的线程负责解码，其余线程等待其完成后读取同一结果。
+ * 解码失败（内存不足）时恢复为待解码状态并向读取方抛出异常。
+ * 修改操作与其他非 const 成员一样，需要调用方自行同步。
+ */
+class LazyEntityText {
+  public:
+    /**
+     * @brief 字符引用所在的上下文，属性值中的字符引用按属性规则解码
+     */
+    enum class Context : std::uint8_t {
+        Text,
+        Attribute
+    };
+
+    constexpr LazyEntityText() noexcept = default;
+
+    /**
+     * @brief 构造
+     * @param text 文本内容
+     * @param needs_decode 文本是否含有待解码的字符引用
+     * @param context 字符引用的解码上下文
+     */
+    LazyEntityText(const std::string_view text, const bool needs_decode, const Context context)
+        : m_text(text),
+          m_state(needs_decode ? pending_state(context) : kReady) {}
+
+    /**
+     * @brief 复制解码后的内容，复制源可能被其他线程同时读取
+     */
+    LazyEntityText(const LazyEntityText& other)
+        : m_text(other.get()) {}
+
+    LazyEntityText(LazyEntityText&& other) noexcept
+        : m_text(std::move(other.m_text)),
+          m_state(other.m_state.load(std::memory_order_relaxed)) {}
+
+    LazyEntityText& operator=(const LazyEntityText& other) {
+        if (this != &other) {
+            m_text = other.get();
+            m_state.store(kReady, std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    LazyEntityText& operator=(LazyEntityText&& other) noexcept {
+        m_text = std::move(other.m_text);
+        m_state.store(other.m_state.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    ~LazyEntityText() = default;
+
+    /**
+     * @brief 读取解码后的文本，首次读取时解码
+     * @throws std::bad_alloc 解码时内存不足
+     */
+    [[nodiscard]] const std::string& get() const {
+        if (const std::uint8_t state = m_state.load(std::memory_order_acquire); state != kReady) [[unlikely]] {
+            resolve(state);
+        }
+        return m_text;
+    }
+
+    /**
+     * @brief 解码后返回可修改的文本，用于追加内容
+     */
+    [[nodiscard]] std::string& materialize() {
+        (void)get();
+        return m_text;
+    }
+
+    /**
+     * @brief 替换为已解码的文本
+     */
+    template <typename Text>
+    void assign(Text&& text) {
+        m_text = std::forward<Text>(text);
+        m_state.store(kReady, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 是否仍含未解码的字符引用
+     */
+    [[nodiscard]] bool needs_decode() const noexcept {
+        return m_state.load(std::memory_order_acquire) != kReady;
+    }
+
+  private:
+    static constexpr std::uint8_t kReady            = 0;  ///< 已解码或无需解码
+    static constexpr std::uint8_t kPendingText      = 1;  ///< 待按文本规则解码
+    static constexpr std::uint8_t kPendingAttribute = 2;  ///< 待按属性值规则解码
+    static constexpr std::uint8_t kDecoding         = 3;  ///< 某个线程正在解码
+
+    [[nodiscard]] static constexpr std::uint8_t pending_state(const Context context) noexcept {
+        return context == Context::Attribute ? kPendingAttribute : kPendingText;
+    }
+
+    void resolve(std::uint8_t state) const {
+        while (true) {
+            if (state == kReady) {
+                return;
+            }
+            if (state == kDecoding) {
+                m_state.wait(kDecoding, std::memory_order_acquire);
+                state = m_state.load(std::memory_order_acquire);
+                continue;
+            }
+            // 成功时 state 仍为待解码状态，决定解码规则
+            if (m_state.compare_exchange_weak(state, kDecoding, std::memory_order_acquire, std::memory_order_acquire)) {
+                break;
+            }
+        }
+
+        try {
+            std::string decoded;
+            decoded.reserve(m_text.size());
+            decode_html_entities(m_text, decoded, state == kPendingAttribute);
+            m_text = std::move(decoded);
+        } catch (...) {
+            m_state.store(state, std::memory_order_release);
+            m_state.notify_all();
+            throw;
+        }
+        m_state.store(kReady, std::memory_order_release);
+        m_state.notify_all();
+    }
+
+    mutable std::string               m_text;            ///< 待解码时为原始文本，否则为解码结果
+    mutable std::atomic<std::uint8_t> m_state{kReady};  ///< 解码状态
+};
+
+}  // namespace hps
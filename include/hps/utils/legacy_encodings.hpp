@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace hps {
+
+/**
+ * 内置的旧式编码解码器
+ *
+ * 码表由 WHATWG Encoding 标准的索引生成并编译进库中，不依赖 iconv 或系统代码页，
+ * 因此在各平台上结果一致。解码行为遵循 WHATWG 解码算法：无法映射或残缺的字节序列替换为 U+FFFD，
+ * 不会失败。所有函数都把结果追加到 out 已有内容之后，ASCII 段整段复制。
+ */
+
+/**
+ * @brief 将 GBK/GB18030 字节解码为 UTF-8
+ *
+ * 同时支持双字节与 GB18030 四字节序列，单字节 0x80 按 WHATWG 解码为欧元符号。
+ */
+void decode_gb18030_to_utf8(std::string_view bytes, std::string& out);
+
+/**
+ * @brief 将 Shift_JIS（含 Windows-31J 扩展）字节解码为 UTF-8
+ *
+ * 0x5C 与 0x7E 按 ASCII 解码，半角片假名映射到 U+FF61–U+FF9F。
+ */
+void decode_shift_jis_to_utf8(std::string_view bytes, std::string& out);
+
+/**
+ * @brief 将 windows-1252 字节解码为 UTF-8
+ *
+ * 按 WHATWG 约定同样用于 iso-8859-1、us-ascii 等标签。
+ */
+void decode_windows_1252_to_utf8(std::string_view bytes, std::string& out);
+
+}  // namespace hps
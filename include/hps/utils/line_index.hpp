@@ -0,0 +1,55 @@
+#pragma once
+#include "hps/utils/exception.hpp"
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace hps {
+
+/**
+ * @brief 源码换行位置索引，用于把字节偏移换算为行列号
+ *
+ * 首次查询时用 memchr 扫描一遍源码记录每行起始偏移，之后每次查询只做二分查找。
+ * 同一次解析中的词法分析器与树构建器共享同一个索引，避免每条错误都从头扫描源码。
+ * 列号按字节计数，与 Location::from_position 一致。
+ */
+class LineIndex {
+  public:
+    /**
+     * @brief 在源码上创建索引（此时不扫描）
+     * @param source 源码
+     */
+    explicit LineIndex(std::string_view source) noexcept;
+
+    /**
+     * @brief 计算字节偏移对应的位置，超出源码长度的偏移截断到末尾
+     */
+    [[nodiscard]] Location locate(size_t position) const;
+
+    /**
+     * @brief 补全只记录了偏移的位置
+     */
+    void resolve(Location& location) const;
+
+    /**
+     * @brief 建好行首表后不再引用源码，索引可以在源码释放后继续使用
+     */
+    void release_source();
+
+    /**
+     * @brief 源码，release_source() 之后为空
+     */
+    [[nodiscard]] std::string_view source() const noexcept {
+        return m_source;
+    }
+
+  private:
+    void build() const;
+
+    std::string_view            m_source;
+    size_t                      m_size{0};      ///< 源码长度，release_source() 之后仍用于截断偏移
+    mutable std::vector<size_t> m_line_starts;  ///< 每行起始偏移，首次查询时构建
+};
+
+}  // namespace hps
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "hps/utils/noncopyable.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace hps {
+
+/**
+ * @brief 只读内存映射文件
+ *
+ * 在 POSIX 上使用 mmap，在 Windows 上使用 CreateFileMapping。映射在对象析构时解除，
+ * 需要跨对象共享映射时通过 open_shared() 获取 shared_ptr。空文件不建立映射，data() 为空视图。
+ */
+class MappedFile : public NonCopyable {
+  public:
+    /**
+     * @brief 以只读方式映射整个文件
+     * @param path 文件路径
+     * @throws HPSException 文件无法打开或映射时抛出 FileReadError
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief 映射并返回共享所有权，便于把映射的生命周期绑定到其他对象
+     */
+    [[nodiscard]] static std::shared_ptr<const MappedFile> open_shared(const std::filesystem::path& path);
+
+    /**
+     * @brief 获取映射内容
+     */
+    [[nodiscard]] std::string_view data() const noexcept {
+        return {static_cast<const char*>(m_data), m_size};
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return m_size;
+    }
+
+  private:
+    void release() noexcept;
+
+    const void* m_data{nullptr};
+    size_t      m_size{0};
+#ifdef _WIN32
+    void* m_file_handle{nullptr};
+    void* m_mapping_handle{nullptr};
+#endif
+};
+
+}  // namespace hps
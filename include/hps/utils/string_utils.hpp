@@ -1,4 +1,8 @@
 #pragma once
+#include "hps/utils/html_entities.hpp"
+#include "hps/utils/legacy_encodings.hpp"
+#include "hps/utils/whitespace.hpp"
+
 #include <string_view>
 
 #include <array>
@@ -7,14 +11,6 @@
 #include <regex>
 #include <vector>
 
-#ifdef _WIN32
-#define NOMINMAX
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#else
-#include <iconv.h>
-#endif
-
 #include <stdexcept>
 #include <unordered_map>
 #include <unordered_set>
@@ -59,9 +55,7 @@ inline char to_upper(const char c) noexcept {
 }
 
 inline std::string_view trim_whitespace(std::string_view str) noexcept {
-    while (!str.empty() && is_whitespace(str.front())) {
-        str.remove_prefix(1);
-    }
+    str.remove_prefix(find_non_whitespace(str));
     while (!str.empty() && is_whitespace(str.back())) {
         str.remove_suffix(1);
     }
@@ -204,183 +198,13 @@ inline bool is_valid_identifier_char(std::string_view input, const size_t pos) {
     return false;
 }
 
-inline std::string gbk_to_utf8(std::string_view gbk_str) {
-    if (gbk_str.empty()) {
-        return {};
-    }
-#ifdef _WIN32
-    const int wide_size = MultiByteToWideChar(936, 0, gbk_str.data(), static_cast<int>(gbk_str.size()), nullptr, 0);
-    if (wide_size <= 0) {
-        throw std::runtime_error("Failed to calculate UTF-16 size");
-    }
-    std::vector<wchar_t> wide_str(wide_size);
-    if (MultiByteToWideChar(936, 0, gbk_str.data(), static_cast<int>(gbk_str.size()), wide_str.data(), wide_size) != wide_size) {
-        throw std::runtime_error("Failed to convert GBK to UTF-16");
-    }
-    const int utf8_size = WideCharToMultiByte(CP_UTF8, 0, wide_str.data(), wide_size, nullptr, 0, nullptr, nullptr);
-    if (utf8_size <= 0) {
-        throw std::runtime_error("Failed to calculate UTF-8 size");
-    }
-    std::string utf8_str(utf8_size, '\0');
-    if (WideCharToMultiByte(CP_UTF8, 0, wide_str.data(), wide_size, utf8_str.data(), utf8_size, nullptr, nullptr) != utf8_size) {
-        throw std::runtime_error("Failed to convert UTF-16 to UTF-8");
-    }
-    return utf8_str;
-
-#else
-    // Linux/macOS 实现 (使用 iconv)
-    iconv_t cd = iconv_open("UTF-8", "GBK");
-    if (cd == reinterpret_cast<iconv_t>(-1)) {
-        throw std::runtime_error("Failed to open iconv for GBK to UTF-8 conversion");
-    }
-    size_t            in_bytes_left  = gbk_str.size();
-    size_t            out_bytes_left = gbk_str.size() * 4;  // UTF-8 最多4字节
-    std::vector<char> out_buffer(out_bytes_left);
-    char*             in_ptr  = const_cast<char*>(gbk_str.data());
-    char*             out_ptr = out_buffer.data();
-    size_t            result  = iconv(cd, &in_ptr, &in_bytes_left, &out_ptr, &out_bytes_left);
-    iconv_close(cd);
-    if (result == static_cast<size_t>(-1)) {
-        throw std::runtime_error("Failed to convert GBK to UTF-8");
-    }
-    return std::string(out_buffer.data(), out_buffer.size() - out_bytes_left);
-#endif
-}
-
 /**
- * @brief 解码HTML实体
- *
- * @param text 包含HTML实体的文本
- * @return 解码后的文本
+ * @brief 将 GBK/GB18030 字节转换为 UTF-8，无法映射的序列替换为 U+FFFD
  */
-inline std::string decode_html_entities(const std::string& text) {
-    static constexpr std::array<std::pair<std::string_view, std::string_view>, 26> named_entities = {{
-        {"amp", "&"},
-        {"lt", "<"},
-        {"gt", ">"},
-        {"quot", "\""},
-        {"apos", "'"},
-        {"nbsp", " "},
-        {"copy", "\xC2\xA9"},
-        {"reg", "\xC2\xAE"},
-        {"trade", "\xE2\x84\xA2"},
-        {"mdash", "\xE2\x80\x94"},
-        {"ndash", "\xE2\x80\x93"},
-        {"hellip", "\xE2\x80\xA6"},
-        {"middot", "\xC2\xB7"},
-        {"bull", "\xE2\x80\xA2"},
-        {"euro", "\xE2\x82\xAC"},
-        {"laquo", "\xC2\xAB"},
-        {"raquo", "\xC2\xBB"},
-        {"iexcl", "\xC2\xA1"},
-        {"cent", "\xC2\xA2"},
-        {"pound", "\xC2\xA3"},
-        {"yen", "\xC2\xA5"},
-        {"sect", "\xC2\xA7"},
-        {"para", "\xC2\xB6"},
-        {"deg", "\xC2\xB0"},
-        {"times", "\xC3\x97"},
-        {"divide", "\xC3\xB7"},
-    }};
-
-    const auto append_code_point_utf8 = [](std::string& output, const uint32_t code_point) {
-        if (code_point <= 0x7F) {
-            output.push_back(static_cast<char>(code_point));
-            return;
-        }
-        if (code_point <= 0x7FF) {
-            output.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
-            output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
-            return;
-        }
-        if (code_point <= 0xFFFF) {
-            output.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
-            output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
-            output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
-            return;
-        }
-        output.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
-        output.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
-        output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
-        output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
-    };
-
-    const auto parse_numeric_entity = [](const std::string_view entity_body) -> std::optional<uint32_t> {
-        if (entity_body.size() < 2 || entity_body.front() != '#') {
-            return std::nullopt;
-        }
-
-        uint32_t       value    = 0;
-        size_t         index    = 1;
-        const unsigned base     = (index < entity_body.size() && (entity_body[index] == 'x' || entity_body[index] == 'X')) ? 16U : 10U;
-        if (base == 16U) {
-            ++index;
-        }
-        if (index >= entity_body.size()) {
-            return std::nullopt;
-        }
-
-        for (; index < entity_body.size(); ++index) {
-            const char ch = entity_body[index];
-            if (base == 16U) {
-                if (!is_hex_digit(ch)) {
-                    return std::nullopt;
-                }
-                value = static_cast<uint32_t>(value * 16 + (is_digit(ch) ? (ch - '0') : (to_lower(ch) - 'a' + 10)));
-            } else {
-                if (!is_digit(ch)) {
-                    return std::nullopt;
-                }
-                value = static_cast<uint32_t>(value * 10 + (ch - '0'));
-            }
-            if (value > 0x10FFFF) {
-                return std::nullopt;
-            }
-        }
-
-        if (value == 0 || (value >= 0xD800 && value <= 0xDFFF)) {
-            return std::nullopt;
-        }
-        return value;
-    };
-
-    const std::string_view input(text);
-    std::string            out;
-    out.reserve(text.size());
-
-    size_t i = 0;
-    while (i < input.size()) {
-        if (input[i] == '&') {
-            const size_t semicolon = input.find(';', i + 1);
-            if (semicolon != std::string_view::npos) {
-                const std::string_view entity_body = input.substr(i + 1, semicolon - i - 1);
-
-                if (const auto code_point = parse_numeric_entity(entity_body); code_point.has_value()) {
-                    append_code_point_utf8(out, *code_point);
-                    i = semicolon + 1;
-                    continue;
-                }
-
-                bool matched_named_entity = false;
-                for (const auto& [name, replacement] : named_entities) {
-                    if (entity_body == name) {
-                        out.append(replacement);
-                        i = semicolon + 1;
-                        matched_named_entity = true;
-                        break;
-                    }
-                }
-
-                if (matched_named_entity) {
-                    continue;
-                }
-            }
-        }
-        out.push_back(input[i]);
-        ++i;
-    }
-
-    return out;
+inline std::string gbk_to_utf8(std::string_view gbk_str) {
+    std::string utf8;
+    decode_gb18030_to_utf8(gbk_str, utf8);
+    return utf8;
 }
 
 /**
@@ -388,24 +212,9 @@ inline std::string decode_html_entities(const std::string& text) {
  * @param text 要处理的文本
  * @return 标准化后的文本
  */
-inline std::string normalize_whitespace(const std::string& text) {
+inline std::string normalize_whitespace(const std::string_view text) {
     std::string result;
-    result.reserve(text.length());
-
-    bool in_whitespace = false;
-    for (char c : text) {
-        if (is_whitespace(c)) {
-            if (!in_whitespace) {
-                result += ' ';  // 用单个空格替换所有空白字符
-                in_whitespace = true;
-            }
-            // 跳过连续的空白字符
-        } else {
-            result += c;
-            in_whitespace = false;
-        }
-    }
-
+    append_normalized_whitespace(text, result);
     return result;
 }
 }  // namespace hps
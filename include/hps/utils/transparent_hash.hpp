@@ -0,0 +1,26 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace hps {
+
+/**
+ * @brief 支持 string_view 异构查找的字符串哈希
+ */
+struct TransparentStringHash {
+    using is_transparent = void;
+
+    [[nodiscard]] size_t operator()(const std::string_view value) const noexcept {
+        return std::hash<std::string_view>{}(value);
+    }
+};
+
+/**
+ * @brief 可直接用 string_view 查找、查找时不构造临时字符串的字符串集合
+ */
+using TransparentStringSet = std::unordered_set<std::string, TransparentStringHash, std::equal_to<>>;
+
+}  // namespace hps
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace hps {
+
+/**
+ * Unicode 文本规范化与大小写折叠
+ *
+ * 数据表由 Unicode 14.0 字符数据库生成并编译进库中。输入按 UTF-8 解释，
+ * 残缺的字节序列替换为 U+FFFD。所有函数都把结果追加到 out 已有内容之后，ASCII 段整段处理。
+ */
+
+/**
+ * @brief 从 text[pos] 解码一个 UTF-8 字符并推进 pos
+ * @return 码位，非法序列返回 U+FFFD 并只前进一个字节
+ */
+[[nodiscard]] char32_t next_code_point(std::string_view text, size_t& pos) noexcept;
+
+/**
+ * @brief 将码位编码为 UTF-8 追加到 out
+ */
+void append_code_point(char32_t code_point, std::string& out);
+
+/**
+ * @brief 将 UTF-8 文本转换为 NFC（规范组合形式）
+ *
+ * 通过 NFC 快速检查的片段直接复制，只有含组合字符或可组合字符的片段才做分解、重排与组合。
+ */
+void append_nfc(std::string_view text, std::string& out);
+
+/**
+ * @brief 对 UTF-8 文本做完全大小写折叠（如 "ß" 折叠为 "ss"）
+ *
+ * 折叠结果可能不再是 NFC，需要时再调用 append_nfc。
+ */
+void append_case_folded(std::string_view text, std::string& out);
+
+/**
+ * @brief 码位的规范组合类别（Canonical_Combining_Class）
+ */
+[[nodiscard]] unsigned combining_class(char32_t code_point) noexcept;
+
+}  // namespace hps
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace hps {
+
+/**
+ * HTML 空白字符（空格、\t、\n、\f、\r）的批量扫描与合并
+ *
+ * x86-64 上每次比较 16 字节，其他平台退化为逐字节循环，结果一致。
+ */
+
+/**
+ * @brief 从 pos 开始查找第一个空白字符或 stop 字符
+ * @return 找到的位置，没有时返回 text.size()
+ */
+[[nodiscard]] size_t find_whitespace_or(std::string_view text, size_t pos, char stop) noexcept;
+
+/**
+ * @brief 从 pos 开始查找第一个空白字符
+ * @return 找到的位置，没有时返回 text.size()
+ */
+[[nodiscard]] inline size_t find_whitespace(const std::string_view text, const size_t pos = 0) noexcept {
+    return find_whitespace_or(text, pos, ' ');
+}
+
+/**
+ * @brief 从 pos 开始查找第一个非空白字符
+ * @return 找到的位置，没有时返回 text.size()
+ */
+[[nodiscard]] size_t find_non_whitespace(std::string_view text, size_t pos = 0) noexcept;
+
+/**
+ * @brief 文本是否已经是空白标准化的形式：只含单个空格作为空白，不存在连续空白
+ */
+[[nodiscard]] bool is_normalized_whitespace(std::string_view text) noexcept;
+
+/**
+ * @brief 把连续空白合并为单个空格后追加到 out
+ *
+ * 非空白片段整段复制；开头和结尾的空白同样合并为一个空格，不做裁剪。
+ */
+void append_normalized_whitespace(std::string_view text, std::string& out);
+
+}  // namespace hps
@@ -1,26 +1,173 @@
 #include "hps/core/document.hpp"
 
 #include "hps/core/element.hpp"
+#include "hps/core/frozen_document.hpp"
+#include "hps/core/text_extractor.hpp"
 #include "hps/query/element_query.hpp"
 #include "hps/query/query.hpp"
 #include "hps/utils/string_utils.hpp"
 
 #include <algorithm>
-#include <sstream>
+#include <unordered_set>
 
 namespace hps {
 namespace {
-std::string normalize_tag_key(const std::string_view tag_name) {
-    std::string normalized(tag_name);
-    std::ranges::transform(normalized, normalized.begin(), [](const unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
-    return normalized;
+using ElementBuckets = std::unordered_map<std::string, std::vector<const Element*>, TransparentStringHash, std::equal_to<>>;
+
+// 标签名已是小写（解析器默认输出）时直接复用，否则写入 scratch
+std::string_view tag_key(const std::string_view tag_name, std::string& scratch) {
+    if (std::ranges::none_of(tag_name, [](const char ch) { return ch >= 'A' && ch <= 'Z'; })) {
+        return tag_name;
+    }
+    scratch.assign(tag_name);
+    std::ranges::transform(scratch, scratch.begin(), [](const char ch) { return to_lower(ch); });
+    return scratch;
+}
+
+// 逐个回调 class 属性中的类名，不分配临时集合
+template <typename Visitor>
+void for_each_class_token(const std::string_view class_attr, Visitor&& visit) {
+    size_t pos = 0;
+    while (pos < class_attr.size()) {
+        while (pos < class_attr.size() && is_whitespace(class_attr[pos])) {
+            ++pos;
+        }
+        const size_t start = pos;
+        while (pos < class_attr.size() && !is_whitespace(class_attr[pos])) {
+            ++pos;
+        }
+        if (pos > start) {
+            visit(class_attr.substr(start, pos - start));
+        }
+    }
+}
+
+std::vector<const Element*>& bucket_for(ElementBuckets& lookup, const std::string_view key) {
+    if (const auto it = lookup.find(key); it != lookup.end()) {
+        return it->second;
+    }
+    return lookup.emplace(std::string(key), std::vector<const Element*>{}).first->second;
+}
+
+size_t node_depth(const Node* node) noexcept {
+    size_t depth = 0;
+    for (; node->parent() != nullptr; node = node->parent()) {
+        ++depth;
+    }
+    return depth;
+}
+
+// 判断 lhs 在文档顺序中是否位于 rhs 之前（祖先先于后代）；沿父链对齐到公共祖先下比较兄弟顺序，不分配内存
+bool precedes_in_tree(const Node* lhs, const Node* rhs) noexcept {
+    if (lhs == rhs) {
+        return false;
+    }
+    size_t      lhs_depth = node_depth(lhs);
+    size_t      rhs_depth = node_depth(rhs);
+    const Node* left      = lhs;
+    const Node* right     = rhs;
+    for (; lhs_depth > rhs_depth; --lhs_depth) {
+        left = left->parent();
+    }
+    for (; rhs_depth > lhs_depth; --rhs_depth) {
+        right = right->parent();
+    }
+    if (left == right) {
+        return left == lhs;
+    }
+    while (left->parent() != right->parent()) {
+        left  = left->parent();
+        right = right->parent();
+    }
+    for (const Node* sibling = left->next_sibling(); sibling != nullptr; sibling = sibling->next_sibling()) {
+        if (sibling == right) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 文档顺序序号有效时直接比较序号，否则回退到树上比较
+bool precedes_in_document(const Element* lhs, const Element* rhs, const bool ordered) noexcept {
+    return ordered ? lhs->document_order() < rhs->document_order() : precedes_in_tree(lhs, rhs);
+}
+
+// 沿最后一个子节点下行，得到子树中文档顺序最后的节点
+const Node* last_descendant(const Node* node) noexcept {
+    while (const Node* child = node->last_child()) {
+        node = child;
+    }
+    return node;
+}
+
+// 节点及其所有祖先均无后继兄弟时，节点子树位于文档末尾
+bool is_at_document_end(const Node& node) noexcept {
+    for (const Node* current = &node; current != nullptr; current = current->parent()) {
+        if (current->next_sibling() != nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 按文档顺序插入；append 为 true 时调用方保证元素位于所有已索引元素之后，ordered 表示文档顺序序号有效
+void insert_in_document_order(std::vector<const Element*>& bucket, const Element* element, const bool append, const bool ordered) {
+    if (!bucket.empty() && bucket.back() == element) {
+        return;
+    }
+    if (append || bucket.empty() || precedes_in_document(bucket.back(), element, ordered)) {
+        bucket.push_back(element);
+        return;
+    }
+    const auto pos = std::ranges::lower_bound(bucket, element, [ordered](const Element* lhs, const Element* rhs) {
+        return precedes_in_document(lhs, rhs, ordered);
+    });
+    if (pos == bucket.end() || *pos != element) {
+        bucket.insert(pos, element);
+    }
+}
+
+void erase_from_bucket(ElementBuckets& lookup, const std::string_view key, const Element* element) {
+    const auto it = lookup.find(key);
+    if (it == lookup.end()) {
+        return;
+    }
+    std::erase(it->second, element);
+    if (it->second.empty()) {
+        lookup.erase(it);
+    }
+}
+
+// 借助父/兄弟指针做先序遍历，不分配辅助栈
+template <typename Visitor>
+void for_each_element_in_subtree(const Node& root, Visitor&& visit) {
+    const Node* current = &root;
+    while (current != nullptr) {
+        if (const auto* element = current->as_element()) {
+            visit(*element);
+        }
+        if (const auto* child = current->first_child()) {
+            current = child;
+            continue;
+        }
+        while (current != &root && current->next_sibling() == nullptr) {
+            current = current->parent();
+        }
+        current = current == &root ? nullptr : current->next_sibling();
+    }
 }
 
 }  // namespace
 
 Document::Document(std::string html_content)
     : Node(NodeType::Document),
-      m_html_source(std::move(html_content)) {}
+      m_html_source(std::move(html_content)),
+      m_source_view(m_html_source) {}
+
+Document::Document(const std::string_view html_content, std::shared_ptr<const void> source_owner)
+    : Node(NodeType::Document),
+      m_source_owner(std::move(source_owner)),
+      m_source_view(html_content) {}
 
 NodeType Document::type() const noexcept {
     return NodeType::Document;
@@ -35,21 +182,16 @@ void Document::invalidate_query_indexes() noexcept {
     m_cached_charset.reset();
 }
 
-void Document::index_element_subtree(const Element& element) const {
-    if (!element.id().empty()) {
-        m_query_index_cache.id_lookup.emplace(element.id(), &element);
-    }
-    m_query_index_cache.tag_lookup[normalize_tag_key(element.tag_name())].push_back(&element);
-
-    for (const auto& class_name : element.class_names()) {
-        m_query_index_cache.class_lookup[class_name].push_back(&element);
-    }
-
-    for (auto child = element.first_child(); child; child = child->next_sibling()) {
-        if (const auto* child_element = child->as_element()) {
-            index_element_subtree(*child_element);
-        }
+void Document::index_element(const Element& element, const bool append) const {
+    const bool ordered = m_document_order_valid;
+    if (const auto& id = element.id(); !id.empty()) {
+        insert_in_document_order(bucket_for(m_query_index_cache.id_lookup, id), &element, append, ordered);
     }
+    std::string scratch;
+    insert_in_document_order(bucket_for(m_query_index_cache.tag_lookup, tag_key(element.tag_name(), scratch)), &element, append, ordered);
+    for_each_class_token(element.get_attribute("class"), [&](const std::string_view class_name) {
+        insert_in_document_order(bucket_for(m_query_index_cache.class_lookup, class_name), &element, append, ordered);
+    });
 }
 
 void Document::ensure_query_indexes() const {
@@ -61,21 +203,154 @@ void Document::ensure_query_indexes() const {
     m_query_index_cache.class_lookup.clear();
     m_query_index_cache.tag_lookup.clear();
 
-    for (auto child = first_child(); child; child = child->next_sibling()) {
-        if (const auto* child_element = child->as_element()) {
-            index_element_subtree(*child_element);
+    for_each_element_in_subtree(*this, [this](const Element& element) { index_element(element, true); });
+
+    m_query_index_cache.valid = true;
+}
+
+void Document::enable_incremental_query_indexes() {
+    ensure_query_indexes();
+}
+
+void Document::ensure_document_order() const noexcept {
+    if (m_document_order_valid) {
+        return;
+    }
+    size_t next = 0;
+    for_each_element_in_subtree(*this, [&next](const Element& element) { element.m_document_order = ++next; });
+    m_next_document_order  = next;
+    m_document_order_valid = true;
+}
+
+void Document::assign_document_order(const Node& node, const bool append) noexcept {
+    if (!m_document_order_valid) {
+        return;
+    }
+    if (!append) {
+        m_document_order_valid = false;
+        return;
+    }
+    for_each_element_in_subtree(node, [this](const Element& element) { element.m_document_order = ++m_next_document_order; });
+}
+
+bool Document::is_appended_at_end(const Node& node) noexcept {
+    if (node.next_sibling() != nullptr) {
+        return false;
+    }
+    if (m_last_node == nullptr) {
+        const bool at_end = is_at_document_end(node);
+        m_last_node       = last_descendant(this);
+        return at_end;
+    }
+    // 追加到父节点末尾的子树位于文档末尾，当且仅当插入前父节点子树的最后节点就是文档的最后节点；
+    // 下行经过的节点随后都不再是文档末尾，解析期的总开销与节点数成正比
+    const Node* previous = node.previous_sibling() != nullptr ? last_descendant(node.previous_sibling()) : node.parent();
+    if (previous != m_last_node) {
+        return false;
+    }
+    m_last_node = last_descendant(&node);
+    return true;
+}
+
+void Document::on_subtree_attached(const Node& node) noexcept {
+    m_cached_title.reset();
+    m_cached_charset.reset();
+    // 解析期插入总在文档末尾，先序遍历即文档顺序，可直接追加
+    const bool append = is_appended_at_end(node);
+    if (!node.is_element() && !node.has_children()) {
+        return;
+    }
+    try {
+        assign_document_order(node, append);
+        if (!m_query_index_cache.valid) {
+            return;
         }
+        for_each_element_in_subtree(node, [this, append](const Element& element) { index_element(element, append); });
+    } catch (...) {
+        invalidate_query_indexes();
     }
+}
 
-    m_query_index_cache.valid = true;
+void Document::on_subtree_detached(const Node& node) noexcept {
+    m_cached_title.reset();
+    m_cached_charset.reset();
+    m_last_node = nullptr;
+    if (!m_query_index_cache.valid) {
+        return;
+    }
+    try {
+        // 先收集被摘除元素与受影响的键，每个桶只扫描一次
+        std::unordered_set<const Element*> removed;
+        std::unordered_set<std::string>    id_keys;
+        std::unordered_set<std::string>    tag_keys;
+        std::unordered_set<std::string>    class_keys;
+        for_each_element_in_subtree(node, [&](const Element& element) {
+            removed.insert(&element);
+            if (!element.id().empty()) {
+                id_keys.insert(element.id());
+            }
+            std::string scratch;
+            tag_keys.emplace(tag_key(element.tag_name(), scratch));
+            for_each_class_token(element.get_attribute("class"), [&](const std::string_view class_name) { class_keys.emplace(class_name); });
+        });
+
+        const auto purge = [&removed](ElementBuckets& lookup, const std::unordered_set<std::string>& keys) {
+            for (const auto& key : keys) {
+                const auto it = lookup.find(key);
+                if (it == lookup.end()) {
+                    continue;
+                }
+                std::erase_if(it->second, [&removed](const Element* element) { return removed.contains(element); });
+                if (it->second.empty()) {
+                    lookup.erase(it);
+                }
+            }
+        };
+        purge(m_query_index_cache.id_lookup, id_keys);
+        purge(m_query_index_cache.tag_lookup, tag_keys);
+        purge(m_query_index_cache.class_lookup, class_keys);
+    } catch (...) {
+        invalidate_query_indexes();
+    }
 }
 
-std::string Document::text_content() const {
-    std::stringstream ss;
-    for (auto child = first_child(); child; child = child->next_sibling()) {
-        ss << child->text_content();
+void Document::on_attribute_changed(const Element& element, const std::string_view name, const std::string_view old_value) noexcept {
+    m_cached_title.reset();
+    m_cached_charset.reset();
+    if (!m_query_index_cache.valid) {
+        return;
     }
-    return ss.str();
+    try {
+        if (equals_ignore_case(name, "id")) {
+            if (!old_value.empty()) {
+                erase_from_bucket(m_query_index_cache.id_lookup, old_value, &element);
+            }
+            if (!element.id().empty()) {
+                insert_in_document_order(bucket_for(m_query_index_cache.id_lookup, element.id()), &element, false, m_document_order_valid);
+            }
+        } else if (equals_ignore_case(name, "class")) {
+            const auto old_classes = split_class_names(old_value);
+            const auto new_classes = element.class_names();
+            for (const auto& class_name : old_classes) {
+                if (!new_classes.contains(class_name)) {
+                    erase_from_bucket(m_query_index_cache.class_lookup, class_name, &element);
+                }
+            }
+            for (const auto& class_name : new_classes) {
+                if (!old_classes.contains(class_name)) {
+                    insert_in_document_order(bucket_for(m_query_index_cache.class_lookup, class_name), &element, false, m_document_order_valid);
+                }
+            }
+        }
+    } catch (...) {
+        invalidate_query_indexes();
+    }
+}
+
+std::string Document::text_content() const {
+    std::string text;
+    append_text_content(*this, text);
+    return text;
 }
 
 std::string Document::title() const {
@@ -126,7 +401,7 @@ std::string Document::charset() const {
 }
 
 std::string_view Document::source_html() const noexcept {
-    return m_html_source;
+    return m_source_view;
 }
 
 std::string Document::get_meta_content(const std::string_view name) const {
@@ -198,8 +473,8 @@ const Element* Document::get_element_by_id(const std::string_view id) const {
 
     ensure_query_indexes();
 
-    if (const auto it = m_query_index_cache.id_lookup.find(std::string(id)); it != m_query_index_cache.id_lookup.end()) {
-        return it->second;
+    if (const auto it = m_query_index_cache.id_lookup.find(id); it != m_query_index_cache.id_lookup.end()) {
+        return it->second.front();
     }
     return nullptr;
 }
@@ -207,7 +482,8 @@ const Element* Document::get_element_by_id(const std::string_view id) const {
 std::vector<const Element*> Document::get_elements_by_tag_name(const std::string_view tag_name) const {
     ensure_query_indexes();
 
-    if (const auto it = m_query_index_cache.tag_lookup.find(normalize_tag_key(tag_name)); it != m_query_index_cache.tag_lookup.end()) {
+    std::string scratch;
+    if (const auto it = m_query_index_cache.tag_lookup.find(tag_key(tag_name, scratch)); it != m_query_index_cache.tag_lookup.end()) {
         return it->second;
     }
     return {};
@@ -216,7 +492,7 @@ std::vector<const Element*> Document::get_elements_by_tag_name(const std::string
 std::vector<const Element*> Document::get_elements_by_class_name(const std::string_view class_name) const {
     ensure_query_indexes();
 
-    if (const auto it = m_query_index_cache.class_lookup.find(std::string(class_name)); it != m_query_index_cache.class_lookup.end()) {
+    if (const auto it = m_query_index_cache.class_lookup.find(class_name); it != m_query_index_cache.class_lookup.end()) {
         return it->second;
     }
     return {};
@@ -226,27 +502,25 @@ ElementQuery Document::css(const std::string_view selector) const {
     return Query::css(*this, selector);
 }
 
+FrozenDocument Document::freeze() const {
+    return FrozenDocument::build(*this);
+}
+
 Node* Document::add_child(std::unique_ptr<Node> child) {
     if (!child) {
         return nullptr;
     }
-    Node* inserted = append_child(std::move(child));
-    invalidate_query_indexes();
-    return inserted;
+    return append_child(std::move(child));
 }
 
 Node* Document::insert_child_before(std::unique_ptr<Node> child, const Node* before) {
     if (!child) {
         return nullptr;
     }
-    Node* inserted = Node::insert_child_before(std::move(child), before);
-    invalidate_query_indexes();
-    return inserted;
+    return Node::insert_child_before(std::move(child), before);
 }
 
 std::vector<std::unique_ptr<Node>> Document::take_children() {
-    auto children = Node::take_children();
-    invalidate_query_indexes();
-    return children;
+    return Node::take_children();
 }
 }  // namespace hps
@@ -1,5 +1,7 @@
 #include "hps/core/element.hpp"
 
+#include "hps/core/document.hpp"
+#include "hps/core/text_extractor.hpp"
 #include "hps/core/text_node.hpp"
 #include "hps/parsing/html_parser.hpp"
 #include "hps/query/element_query.hpp"
@@ -19,11 +21,9 @@ NodeType Element::type() const noexcept {
 }
 
 std::string Element::text_content() const {
-    std::stringstream ss;
-    for (auto child = first_child(); child; child = child->next_sibling()) {
-        ss << child->text_content();
-    }
-    return ss.str();
+    std::string text;
+    append_text_content(*this, text);
+    return text;
 }
 
 std::string Element::own_text() const {
@@ -60,7 +60,7 @@ bool Element::has_attribute(const std::string_view name) const noexcept {
     return std::ranges::any_of(m_attributes, [name](const Attribute& attr) { return equals_ignore_case(attr.name(), name); });
 }
 
-const std::string& Element::get_attribute(const std::string_view name) const noexcept {
+const std::string& Element::get_attribute(const std::string_view name) const {
     static const std::string empty_string;
     const auto               it = std::ranges::find_if(m_attributes, [name](const Attribute& attr) { return equals_ignore_case(attr.name(), name); });
     return it != m_attributes.end() ? it->value() : empty_string;
@@ -74,15 +74,15 @@ size_t Element::attribute_count() const noexcept {
     return m_attributes.size();
 }
 
-const std::string& Element::id() const noexcept {
+const std::string& Element::id() const {
     return get_attribute("id");
 }
 
-const std::string& Element::class_name() const noexcept {
+const std::string& Element::class_name() const {
     return get_attribute("class");
 }
 
-std::unordered_set<std::string> Element::class_names() const noexcept {
+std::unordered_set<std::string> Element::class_names() const {
     const std::string& cls = get_attribute("class");
     if (!cls.empty()) {
         return split_class_names(cls);
@@ -90,7 +90,7 @@ std::unordered_set<std::string> Element::class_names() const noexcept {
     return {};
 }
 
-bool Element::has_class(const std::string_view class_name) const noexcept {
+bool Element::has_class(const std::string_view class_name) const {
     if (class_name.empty()) {
         return false;
     }
@@ -196,34 +196,44 @@ Node* Element::add_child(std::unique_ptr<Node> child) {
     if (!child) {
         return nullptr;
     }
-    Node* inserted = append_child(std::move(child));
-    invalidate_document_query_cache();
-    return inserted;
+    return append_child(std::move(child));
 }
 
 Node* Element::insert_child_before(std::unique_ptr<Node> child, const Node* before) {
     if (!child) {
         return nullptr;
     }
-    Node* inserted = Node::insert_child_before(std::move(child), before);
-    invalidate_document_query_cache();
-    return inserted;
+    return Node::insert_child_before(std::move(child), before);
 }
 
 std::vector<std::unique_ptr<Node>> Element::take_children() {
-    auto children = Node::take_children();
-    invalidate_document_query_cache();
-    return children;
+    return Node::take_children();
 }
 
-void Element::add_attribute(std::string_view name, std::string_view value, const bool has_value) {
+size_t Element::document_order() const noexcept {
+    const auto* document = owner_document();
+    if (document == nullptr) {
+        return 0;
+    }
+    document->ensure_document_order();
+    return m_document_order;
+}
+
+void Element::add_attribute(std::string_view name, std::string_view value, const bool has_value, const bool needs_decode) {
     const auto it = std::ranges::find_if(m_attributes, [name](const Attribute& attr) { return equals_ignore_case(attr.name(), name); });
-    if (it != m_attributes.end()) {
-        it->set_value(value, has_value);
-    } else {
-        m_attributes.emplace_back(name, value, has_value);
+    if (it == m_attributes.end()) {
+        m_attributes.emplace_back(name, value, has_value, needs_decode);
+        notify_attribute_changed(*this, name, {});
+        return;
+    }
+    if (owner_document() == nullptr) {
+        *it = Attribute(it->name(), value, has_value, needs_decode);
+        return;
     }
-    invalidate_document_query_cache();
+    // 覆盖前保留旧值，供文档增量移除旧的 id/class 索引项
+    const std::string old_value = it->value();
+    *it                         = Attribute(it->name(), value, has_value, needs_decode);
+    notify_attribute_changed(*this, name, old_value);
 }
 
 }  // namespace hps
@@ -0,0 +1,885 @@
+#include "hps/core/frozen_document.hpp"
+
+#include "hps/core/comment_node.hpp"
+#include "hps/core/document.hpp"
+#include "hps/core/element.hpp"
+#include "hps/core/text_node.hpp"
+#include "hps/query/css/css_parser.hpp"
+#include "hps/query/css/css_utils.hpp"
+#include "hps/utils/exception.hpp"
+#include "hps/utils/mapped_file.hpp"
+#include "hps/utils/string_utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace hps {
+
+// ==================== 构建 ====================
+
+/**
+ * @brief 构建期持有的各列数组
+ */
+struct FrozenDocument::Columns {
+    std::vector<NodeType>      types;
+    std::vector<NamespaceKind> namespaces;
+    std::vector<AtomId>        tags;
+    std::vector<NodeId>        parents;
+    std::vector<NodeId>        first_children;
+    std::vector<NodeId>        next_siblings;
+    std::vector<NodeId>        prev_siblings;
+    std::vector<std::uint32_t> attribute_begin;
+    std::vector<StringRange>   texts;
+    std::vector<StringRange>   ids;
+    std::vector<StringRange>   classes;
+    std::vector<AtomId>        attribute_names;
+    std::vector<StringRange>   attribute_values;
+    std::vector<StringRange>   atoms;
+    std::string                strings;
+};
+
+FrozenDocument FrozenDocument::build(const Document& document) {
+    auto                                    columns = std::make_shared<Columns>();
+    std::unordered_map<std::string, AtomId> atom_lookup;
+
+    const auto store = [&columns](const std::string_view value) -> StringRange {
+        if (columns->strings.size() + value.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw HPSException(ErrorCode::OutOfMemory, "FrozenDocument string buffer exceeds 4 GiB");
+        }
+        const StringRange range{static_cast<std::uint32_t>(columns->strings.size()), static_cast<std::uint32_t>(value.size())};
+        columns->strings.append(value);
+        return range;
+    };
+    const auto intern = [&](const std::string_view value) -> AtomId {
+        if (const auto it = atom_lookup.find(std::string(value)); it != atom_lookup.end()) {
+            return it->second;
+        }
+        const auto atom = static_cast<AtomId>(columns->atoms.size());
+        columns->atoms.push_back(store(value));
+        atom_lookup.emplace(std::string(value), atom);
+        return atom;
+    };
+
+    // 先序遍历，节点编号即文档顺序
+    std::vector<NodeId>                         last_child;
+    std::vector<std::pair<const Node*, NodeId>> pending{{&document, kInvalidNode}};
+    while (!pending.empty()) {
+        const auto [node, parent_id] = pending.back();
+        pending.pop_back();
+
+        const auto id = static_cast<NodeId>(columns->types.size());
+        columns->types.push_back(node->type());
+        columns->namespaces.push_back(NamespaceKind::Html);
+        columns->tags.push_back(kNoAtom);
+        columns->parents.push_back(parent_id);
+        columns->first_children.push_back(kInvalidNode);
+        columns->next_siblings.push_back(kInvalidNode);
+        columns->prev_siblings.push_back(kInvalidNode);
+        columns->attribute_begin.push_back(static_cast<std::uint32_t>(columns->attribute_names.size()));
+        columns->texts.emplace_back();
+        columns->ids.emplace_back();
+        columns->classes.emplace_back();
+        last_child.push_back(kInvalidNode);
+
+        if (parent_id != kInvalidNode) {
+            if (const NodeId previous = last_child[parent_id]; previous == kInvalidNode) {
+                columns->first_children[parent_id] = id;
+            } else {
+                columns->next_siblings[previous] = id;
+                columns->prev_siblings[id]       = previous;
+            }
+            last_child[parent_id] = id;
+        }
+
+        if (const auto* element = node->as_element()) {
+            columns->namespaces[id] = element->namespace_kind();
+            columns->tags[id]       = intern(element->tag_name());
+            for (const auto& attribute : element->attributes()) {
+                const auto value = store(attribute.value());
+                columns->attribute_names.push_back(intern(attribute.name()));
+                columns->attribute_values.push_back(value);
+                if (equals_ignore_case(attribute.name(), "id")) {
+                    columns->ids[id] = value;
+                } else if (equals_ignore_case(attribute.name(), "class")) {
+                    columns->classes[id] = value;
+                }
+            }
+        } else if (const auto* text_node = node->as_text()) {
+            columns->texts[id] = store(text_node->value());
+        } else if (const auto* comment_node = node->as_comment()) {
+            columns->texts[id] = store(comment_node->value());
+        }
+
+        for (auto child = node->last_child(); child; child = child->previous_sibling()) {
+            pending.emplace_back(child, id);
+        }
+    }
+    columns->attribute_begin.push_back(static_cast<std::uint32_t>(columns->attribute_names.size()));
+
+    FrozenDocument frozen;
+    frozen.m_types            = columns->types;
+    frozen.m_namespaces       = columns->namespaces;
+    frozen.m_tags             = columns->tags;
+    frozen.m_parents          = columns->parents;
+    frozen.m_first_children   = columns->first_children;
+    frozen.m_next_siblings    = columns->next_siblings;
+    frozen.m_prev_siblings    = columns->prev_siblings;
+    frozen.m_attribute_begin  = columns->attribute_begin;
+    frozen.m_texts            = columns->texts;
+    frozen.m_ids              = columns->ids;
+    frozen.m_classes          = columns->classes;
+    frozen.m_attribute_names  = columns->attribute_names;
+    frozen.m_attribute_values = columns->attribute_values;
+    frozen.m_atoms            = columns->atoms;
+    frozen.m_strings          = columns->strings;
+    frozen.m_storage          = std::move(columns);
+    return frozen;
+}
+
+std::shared_ptr<Document> FrozenDocument::to_document() const {
+    auto document = std::make_shared<Document>("");
+    if (m_types.empty()) {
+        return document;
+    }
+
+    // 先序编号保证父节点总在子节点之前创建，按编号顺序追加即可还原兄弟顺序
+    std::vector<Node*> nodes(m_types.size(), nullptr);
+    nodes[root()] = document.get();
+    for (NodeId id = 1; id < m_types.size(); ++id) {
+        std::unique_ptr<Node> node;
+        switch (m_types[id]) {
+            case NodeType::Element: {
+                auto element = std::make_unique<Element>(tag_name(id), m_namespaces[id]);
+                for (size_t i = 0; i < attribute_count(id); ++i) {
+                    element->add_attribute(attribute_name(id, i), attribute_value(id, i));
+                }
+                node = std::move(element);
+                break;
+            }
+            case NodeType::Text:
+                node = std::make_unique<TextNode>(text(id));
+                break;
+            case NodeType::Comment:
+                node = std::make_unique<CommentNode>(text(id));
+                break;
+            default:
+                continue;
+        }
+        Node* parent = nodes[m_parents[id]];
+        if (parent == nullptr) {
+            continue;
+        }
+        nodes[id] = parent->append_child(std::move(node));
+    }
+    return document;
+}
+
+// ==================== 序列化 ====================
+
+namespace {
+
+constexpr std::array<char, 8> kSnapshotMagic    = {'H', 'P', 'S', 'S', 'N', 'A', 'P', '\0'};
+constexpr std::uint32_t       kByteOrderMark    = 0x01020304;
+constexpr size_t              kSectionAlignment = 8;
+
+/**
+ * @brief 快照中各列的排布顺序
+ */
+enum Section : size_t {
+    kTypes,
+    kNamespaces,
+    kTags,
+    kParents,
+    kFirstChildren,
+    kNextSiblings,
+    kPrevSiblings,
+    kAttributeBegin,
+    kTexts,
+    kIds,
+    kClasses,
+    kAttributeNames,
+    kAttributeValues,
+    kAtoms,
+    kStrings,
+    kSectionCount
+};
+
+struct SnapshotHeader {
+    std::array<char, 8>                     magic;
+    std::uint32_t                           version;
+    std::uint32_t                           byte_order_mark;
+    std::uint32_t                           node_count;
+    std::uint32_t                           attribute_count;
+    std::uint32_t                           atom_count;
+    std::uint32_t                           reserved;
+    std::uint64_t                           strings_size;
+    std::array<std::uint64_t, kSectionCount> section_offsets;
+};
+
+static_assert(sizeof(SnapshotHeader) % kSectionAlignment == 0);
+static_assert(sizeof(FrozenDocument::StringRange) == 8);
+
+constexpr size_t align_up(const size_t value) noexcept {
+    return (value + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+}
+
+void append_section(std::string& out, std::uint64_t& offset, const void* data, const size_t bytes) {
+    out.resize(align_up(out.size()), '\0');
+    offset = out.size();
+    if (bytes != 0) {
+        out.append(static_cast<const char*>(data), bytes);
+    }
+}
+
+template <typename T>
+void append_section(std::string& out, std::uint64_t& offset, const std::span<const T> column) {
+    append_section(out, offset, column.data(), column.size_bytes());
+}
+
+[[noreturn]] void throw_invalid_snapshot(const std::string& message) {
+    throw HPSException(ErrorCode::InvalidSnapshot, "Invalid snapshot: " + message);
+}
+
+}  // namespace
+
+std::string FrozenDocument::serialize() const {
+    SnapshotHeader header{};
+    header.magic           = kSnapshotMagic;
+    header.version         = kFormatVersion;
+    header.byte_order_mark = kByteOrderMark;
+    header.node_count      = static_cast<std::uint32_t>(m_types.size());
+    header.attribute_count = static_cast<std::uint32_t>(m_attribute_names.size());
+    header.atom_count      = static_cast<std::uint32_t>(m_atoms.size());
+    header.strings_size    = m_strings.size();
+
+    std::string out(sizeof(SnapshotHeader), '\0');
+    auto&       offsets = header.section_offsets;
+    append_section(out, offsets[kTypes], m_types);
+    append_section(out, offsets[kNamespaces], m_namespaces);
+    append_section(out, offsets[kTags], m_tags);
+    append_section(out, offsets[kParents], m_parents);
+    append_section(out, offsets[kFirstChildren], m_first_children);
+    append_section(out, offsets[kNextSiblings], m_next_siblings);
+    append_section(out, offsets[kPrevSiblings], m_prev_siblings);
+    append_section(out, offsets[kAttributeBegin], m_attribute_begin);
+    append_section(out, offsets[kTexts], m_texts);
+    append_section(out, offsets[kIds], m_ids);
+    append_section(out, offsets[kClasses], m_classes);
+    append_section(out, offsets[kAttributeNames], m_attribute_names);
+    append_section(out, offsets[kAttributeValues], m_attribute_values);
+    append_section(out, offsets[kAtoms], m_atoms);
+    append_section(out, offsets[kStrings], m_strings.data(), m_strings.size());
+    out.resize(align_up(out.size()), '\0');
+
+    std::memcpy(out.data(), &header, sizeof(header));
+    return out;
+}
+
+void FrozenDocument::save(const std::filesystem::path& path) const {
+    const std::string bytes = serialize();
+    std::ofstream     file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw HPSException(ErrorCode::FileWriteError, "Cannot open file for writing: " + path.string());
+    }
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        throw HPSException(ErrorCode::FileWriteError, "Failed to write file: " + path.string());
+    }
+}
+
+FrozenDocument FrozenDocument::deserialize(const std::string_view bytes) {
+    // 复制到 8 字节对齐的缓冲区，使各列可以直接按原类型访问
+    auto buffer = std::make_shared<std::vector<std::uint64_t>>(align_up(bytes.size()) / sizeof(std::uint64_t));
+    if (!bytes.empty()) {
+        std::memcpy(buffer->data(), bytes.data(), bytes.size());
+    }
+    const std::string_view aligned(reinterpret_cast<const char*>(buffer->data()), bytes.size());
+    return attach(std::move(buffer), aligned);
+}
+
+FrozenDocument FrozenDocument::load(const std::filesystem::path& path) {
+    auto       mapping = MappedFile::open_shared(path);
+    const auto bytes   = mapping->data();
+    return attach(std::move(mapping), bytes);
+}
+
+FrozenDocument FrozenDocument::attach(std::shared_ptr<const void> storage, const std::string_view bytes) {
+    if (bytes.size() < sizeof(SnapshotHeader)) {
+        throw_invalid_snapshot("truncated header");
+    }
+    if (reinterpret_cast<std::uintptr_t>(bytes.data()) % kSectionAlignment != 0) {
+        throw_invalid_snapshot("buffer is not 8-byte aligned");
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != kSnapshotMagic) {
+        throw_invalid_snapshot("bad magic");
+    }
+    if (header.byte_order_mark != kByteOrderMark) {
+        throw_invalid_snapshot("byte order mismatch");
+    }
+    if (header.version != kFormatVersion) {
+        throw_invalid_snapshot("unsupported version " + std::to_string(header.version));
+    }
+
+    const std::uint64_t node_count      = header.node_count;
+    const std::uint64_t attribute_count = header.attribute_count;
+    const std::uint64_t atom_count      = header.atom_count;
+
+    std::array<std::uint64_t, kSectionCount> section_bytes{};
+    section_bytes[kTypes]           = node_count * sizeof(NodeType);
+    section_bytes[kNamespaces]      = node_count * sizeof(NamespaceKind);
+    section_bytes[kTags]            = node_count * sizeof(AtomId);
+    section_bytes[kParents]         = node_count * sizeof(NodeId);
+    section_bytes[kFirstChildren]   = node_count * sizeof(NodeId);
+    section_bytes[kNextSiblings]    = node_count * sizeof(NodeId);
+    section_bytes[kPrevSiblings]    = node_count * sizeof(NodeId);
+    section_bytes[kAttributeBegin]  = (node_count + 1) * sizeof(std::uint32_t);
+    section_bytes[kTexts]           = node_count * sizeof(StringRange);
+    section_bytes[kIds]             = node_count * sizeof(StringRange);
+    section_bytes[kClasses]         = node_count * sizeof(StringRange);
+    section_bytes[kAttributeNames]  = attribute_count * sizeof(AtomId);
+    section_bytes[kAttributeValues] = attribute_count * sizeof(StringRange);
+    section_bytes[kAtoms]           = atom_count * sizeof(StringRange);
+    section_bytes[kStrings]         = header.strings_size;
+
+    for (size_t section = 0; section < kSectionCount; ++section) {
+        const std::uint64_t offset = header.section_offsets[section];
+        if (offset % kSectionAlignment != 0 || offset < sizeof(SnapshotHeader) || offset > bytes.size() ||
+            section_bytes[section] > bytes.size() - offset) {
+            throw_invalid_snapshot("section " + std::to_string(section) + " out of bounds");
+        }
+    }
+
+    const auto column = [&]<typename T>(const Section section, const std::uint64_t count) {
+        return std::span<const T>(reinterpret_cast<const T*>(bytes.data() + header.section_offsets[section]), count);
+    };
+
+    FrozenDocument frozen;
+    frozen.m_types            = column.operator()<NodeType>(kTypes, node_count);
+    frozen.m_namespaces       = column.operator()<NamespaceKind>(kNamespaces, node_count);
+    frozen.m_tags             = column.operator()<AtomId>(kTags, node_count);
+    frozen.m_parents          = column.operator()<NodeId>(kParents, node_count);
+    frozen.m_first_children   = column.operator()<NodeId>(kFirstChildren, node_count);
+    frozen.m_next_siblings    = column.operator()<NodeId>(kNextSiblings, node_count);
+    frozen.m_prev_siblings    = column.operator()<NodeId>(kPrevSiblings, node_count);
+    frozen.m_attribute_begin  = column.operator()<std::uint32_t>(kAttributeBegin, node_count + 1);
+    frozen.m_texts            = column.operator()<StringRange>(kTexts, node_count);
+    frozen.m_ids              = column.operator()<StringRange>(kIds, node_count);
+    frozen.m_classes          = column.operator()<StringRange>(kClasses, node_count);
+    frozen.m_attribute_names  = column.operator()<AtomId>(kAttributeNames, attribute_count);
+    frozen.m_attribute_values = column.operator()<StringRange>(kAttributeValues, attribute_count);
+    frozen.m_atoms            = column.operator()<StringRange>(kAtoms, atom_count);
+    frozen.m_strings          = bytes.substr(header.section_offsets[kStrings], header.strings_size);
+
+    // 内容校验：保证之后的所有访问都不会越界
+    const auto valid_range = [&](const StringRange range) {
+        return static_cast<std::uint64_t>(range.offset) + range.length <= header.strings_size;
+    };
+    if (node_count == 0 || frozen.m_types[0] != NodeType::Document || frozen.m_parents[0] != kInvalidNode) {
+        throw_invalid_snapshot("missing document root");
+    }
+    if (frozen.m_attribute_begin[0] != 0 || frozen.m_attribute_begin[node_count] != attribute_count) {
+        throw_invalid_snapshot("attribute table mismatch");
+    }
+    for (NodeId id = 0; id < node_count; ++id) {
+        const NodeType type = frozen.m_types[id];
+        if (id != 0 && type != NodeType::Element && type != NodeType::Text && type != NodeType::Comment) {
+            throw_invalid_snapshot("unexpected node type");
+        }
+        if (id != 0 && frozen.m_parents[id] >= id) {
+            throw_invalid_snapshot("parent does not precede node");
+        }
+        if (id != 0 && frozen.m_types[frozen.m_parents[id]] != NodeType::Element &&
+            frozen.m_types[frozen.m_parents[id]] != NodeType::Document) {
+            throw_invalid_snapshot("parent is not a container node");
+        }
+        if (frozen.m_namespaces[id] > NamespaceKind::MathML) {
+            throw_invalid_snapshot("unknown namespace");
+        }
+        const NodeId first_child = frozen.m_first_children[id];
+        const NodeId next        = frozen.m_next_siblings[id];
+        const NodeId previous    = frozen.m_prev_siblings[id];
+        if ((first_child != kInvalidNode && (first_child <= id || first_child >= node_count)) ||
+            (next != kInvalidNode && (next <= id || next >= node_count)) ||
+            (previous != kInvalidNode && previous >= id)) {
+            throw_invalid_snapshot("sibling links out of order");
+        }
+        if (frozen.m_attribute_begin[id] > frozen.m_attribute_begin[id + 1]) {
+            throw_invalid_snapshot("attribute table not monotonic");
+        }
+        const AtomId tag = frozen.m_tags[id];
+        if ((type == NodeType::Element) != (tag != kNoAtom) || (tag != kNoAtom && tag >= atom_count)) {
+            throw_invalid_snapshot("bad tag atom");
+        }
+        if (!valid_range(frozen.m_texts[id]) || !valid_range(frozen.m_ids[id]) || !valid_range(frozen.m_classes[id])) {
+            throw_invalid_snapshot("string range out of bounds");
+        }
+    }
+    for (std::uint64_t i = 0; i < attribute_count; ++i) {
+        if (frozen.m_attribute_names[i] >= atom_count || !valid_range(frozen.m_attribute_values[i])) {
+            throw_invalid_snapshot("bad attribute entry");
+        }
+    }
+    for (const auto atom : frozen.m_atoms) {
+        if (!valid_range(atom)) {
+            throw_invalid_snapshot("atom out of bounds");
+        }
+    }
+
+    frozen.m_storage = std::move(storage);
+    return frozen;
+}
+
+// ==================== 结构访问 ====================
+
+NodeType FrozenDocument::type(const NodeId node) const noexcept {
+    return node < m_types.size() ? m_types[node] : NodeType::Undefined;
+}
+
+bool FrozenDocument::is_element(const NodeId node) const noexcept {
+    return type(node) == NodeType::Element;
+}
+
+FrozenDocument::NodeId FrozenDocument::parent(const NodeId node) const noexcept {
+    return node < m_parents.size() ? m_parents[node] : kInvalidNode;
+}
+
+FrozenDocument::NodeId FrozenDocument::first_child(const NodeId node) const noexcept {
+    return node < m_first_children.size() ? m_first_children[node] : kInvalidNode;
+}
+
+FrozenDocument::NodeId FrozenDocument::next_sibling(const NodeId node) const noexcept {
+    return node < m_next_siblings.size() ? m_next_siblings[node] : kInvalidNode;
+}
+
+FrozenDocument::NodeId FrozenDocument::previous_sibling(const NodeId node) const noexcept {
+    return node < m_prev_siblings.size() ? m_prev_siblings[node] : kInvalidNode;
+}
+
+std::string_view FrozenDocument::tag_name(const NodeId node) const noexcept {
+    if (node >= m_tags.size() || m_tags[node] == kNoAtom) {
+        return {};
+    }
+    return view(m_atoms[m_tags[node]]);
+}
+
+std::string_view FrozenDocument::text(const NodeId node) const noexcept {
+    return node < m_texts.size() ? view(m_texts[node]) : std::string_view{};
+}
+
+std::string FrozenDocument::text_content(const NodeId node) const {
+    if (node >= m_types.size()) {
+        return {};
+    }
+    if (m_types[node] == NodeType::Text) {
+        return std::string(text(node));
+    }
+    // 子树在编号上是连续区间 [node, end)，线性扫描文本列即可
+    NodeId boundary = node;
+    while (boundary != kInvalidNode && m_next_siblings[boundary] == kInvalidNode) {
+        boundary = m_parents[boundary];
+    }
+    const size_t end = boundary == kInvalidNode ? m_types.size() : m_next_siblings[boundary];
+
+    std::string result;
+    for (size_t current = node + 1; current < end; ++current) {
+        if (m_types[current] == NodeType::Text) {
+            result.append(view(m_texts[current]));
+        }
+    }
+    return result;
+}
+
+// ==================== 属性访问 ====================
+
+size_t FrozenDocument::attribute_count(const NodeId node) const noexcept {
+    return node < m_types.size() ? m_attribute_begin[node + 1] - m_attribute_begin[node] : 0;
+}
+
+std::string_view FrozenDocument::attribute_name(const NodeId node, const size_t index) const noexcept {
+    if (index >= attribute_count(node)) {
+        return {};
+    }
+    return view(m_atoms[m_attribute_names[m_attribute_begin[node] + index]]);
+}
+
+std::string_view FrozenDocument::attribute_value(const NodeId node, const size_t index) const noexcept {
+    if (index >= attribute_count(node)) {
+        return {};
+    }
+    return view(m_attribute_values[m_attribute_begin[node] + index]);
+}
+
+bool FrozenDocument::has_attribute(const NodeId node, const std::string_view name) const noexcept {
+    const size_t count = attribute_count(node);
+    for (size_t i = 0; i < count; ++i) {
+        if (equals_ignore_case(attribute_name(node, i), name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view FrozenDocument::get_attribute(const NodeId node, const std::string_view name) const noexcept {
+    const size_t count = attribute_count(node);
+    for (size_t i = 0; i < count; ++i) {
+        if (equals_ignore_case(attribute_name(node, i), name)) {
+            return attribute_value(node, i);
+        }
+    }
+    return {};
+}
+
+std::string_view FrozenDocument::id(const NodeId node) const noexcept {
+    return node < m_ids.size() ? view(m_ids[node]) : std::string_view{};
+}
+
+bool FrozenDocument::has_class(const NodeId node, const std::string_view class_name) const noexcept {
+    if (class_name.empty() || node >= m_classes.size()) {
+        return false;
+    }
+    const std::string_view value = view(m_classes[node]);
+    size_t                 pos   = 0;
+    while (pos < value.size()) {
+        while (pos < value.size() && is_whitespace(value[pos])) {
+            ++pos;
+        }
+        const size_t start = pos;
+        while (pos < value.size() && !is_whitespace(value[pos])) {
+            ++pos;
+        }
+        if (pos > start && value.substr(start, pos - start) == class_name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ==================== 选择器匹配 ====================
+
+/**
+ * @brief 在快照上执行选择器匹配
+ *
+ * 先把选择器 AST 编译一遍：类型/属性名预先解析成原子位图，匹配时只比较整数。
+ */
+class FrozenSelectorMatcher {
+  public:
+    FrozenSelectorMatcher(const FrozenDocument& document, const SelectorList& selector_list)
+        : m_document(document) {
+        for (const auto& selector : selector_list.selectors()) {
+            m_roots.push_back(compile(*selector));
+        }
+    }
+
+    [[nodiscard]] bool matches(const FrozenDocument::NodeId node) const {
+        return std::ranges::any_of(m_roots, [this, node](const Compiled& compiled) { return match(compiled, node); });
+    }
+
+  private:
+    using NodeId = FrozenDocument::NodeId;
+    using Pseudo = PseudoClassSelector::PseudoType;
+
+    struct Compiled {
+        SelectorType             type{SelectorType::Universal};
+        const CSSSelector*       source{nullptr};
+        std::vector<char>        atoms;  ///< Type: 标签原子；Attribute: 属性名原子
+        std::string_view         value;  ///< Class / Id 名称
+        Pseudo                   pseudo{Pseudo::FirstChild};
+        bool                     has_left{false};
+        bool                     has_right{false};
+        std::vector<Compiled>    children;
+    };
+
+    const FrozenDocument& m_document;
+    std::vector<Compiled> m_roots;
+
+    [[nodiscard]] std::vector<char> resolve_atoms(const std::string_view name) const {
+        std::vector<char> atoms(m_document.m_atoms.size(), 0);
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            atoms[i] = equals_ignore_case(m_document.view(m_document.m_atoms[i]), name) ? 1 : 0;
+        }
+        return atoms;
+    }
+
+    [[nodiscard]] Compiled compile(const CSSSelector& selector) const {
+        Compiled compiled;
+        compiled.type   = selector.type();
+        compiled.source = &selector;
+        switch (selector.type()) {
+            case SelectorType::Universal:
+                break;
+            case SelectorType::PseudoElement:
+                throw HPSException(ErrorCode::InvalidSelector, "Selector is not supported by FrozenDocument: " + selector.to_string());
+            case SelectorType::Type:
+                compiled.atoms = resolve_atoms(static_cast<const TypeSelector&>(selector).tag_name());
+                break;
+            case SelectorType::Class:
+                compiled.value = static_cast<const ClassSelector&>(selector).class_name();
+                break;
+            case SelectorType::Id:
+                compiled.value = static_cast<const IdSelector&>(selector).id_name();
+                break;
+            case SelectorType::Attribute:
+                compiled.atoms = resolve_atoms(static_cast<const AttributeSelector&>(selector).attr_name());
+                break;
+            case SelectorType::Descendant:
+            case SelectorType::Child:
+            case SelectorType::Adjacent:
+            case SelectorType::Sibling: {
+                const auto& combinator = static_cast<const CombinatorSelector&>(selector);
+                compiled.has_left      = combinator.left() != nullptr;
+                compiled.has_right     = combinator.right() != nullptr;
+                compiled.children.push_back(compiled.has_left ? compile(*combinator.left()) : Compiled{});
+                compiled.children.push_back(compiled.has_right ? compile(*combinator.right()) : Compiled{});
+                break;
+            }
+            case SelectorType::Compound:
+                for (const auto& part : static_cast<const CompoundSelector&>(selector).selectors()) {
+                    compiled.children.push_back(compile(*part));
+                }
+                break;
+            case SelectorType::PseudoClass: {
+                const auto& pseudo = static_cast<const PseudoClassSelector&>(selector);
+                compiled.pseudo    = pseudo.pseudo_type();
+                if (compiled.pseudo == Pseudo::Has) {
+                    throw HPSException(ErrorCode::InvalidSelector, "Selector is not supported by FrozenDocument: " + selector.to_string());
+                }
+                if (const auto* sub_selectors = pseudo.sub_selectors()) {
+                    for (const auto& sub_selector : sub_selectors->selectors()) {
+                        compiled.children.push_back(compile(*sub_selector));
+                    }
+                }
+                compiled.has_right = pseudo.sub_selectors() != nullptr;
+                break;
+            }
+        }
+        return compiled;
+    }
+
+    [[nodiscard]] bool any_child_matches(const Compiled& compiled, const NodeId node) const {
+        return std::ranges::any_of(compiled.children, [this, node](const Compiled& child) { return match(child, node); });
+    }
+
+    [[nodiscard]] NodeId previous_element(NodeId node) const noexcept {
+        for (node = m_document.previous_sibling(node); node != FrozenDocument::kInvalidNode; node = m_document.previous_sibling(node)) {
+            if (m_document.is_element(node)) {
+                return node;
+            }
+        }
+        return FrozenDocument::kInvalidNode;
+    }
+
+    [[nodiscard]] NodeId next_element(NodeId node) const noexcept {
+        for (node = m_document.next_sibling(node); node != FrozenDocument::kInvalidNode; node = m_document.next_sibling(node)) {
+            if (m_document.is_element(node)) {
+                return node;
+            }
+        }
+        return FrozenDocument::kInvalidNode;
+    }
+
+    [[nodiscard]] bool same_tag(const NodeId lhs, const NodeId rhs) const noexcept {
+        const auto lhs_atom = m_document.m_tags[lhs];
+        const auto rhs_atom = m_document.m_tags[rhs];
+        return lhs_atom == rhs_atom || equals_ignore_case(m_document.tag_name(lhs), m_document.tag_name(rhs));
+    }
+
+    // 在同级元素中的位置（从 1 开始），of_type 时只计同标签元素
+    [[nodiscard]] int sibling_index(const NodeId node, const bool from_end, const bool of_type) const noexcept {
+        int index = 1;
+        for (NodeId current = from_end ? next_element(node) : previous_element(node); current != FrozenDocument::kInvalidNode;
+             current        = from_end ? next_element(current) : previous_element(current)) {
+            if (!of_type || same_tag(current, node)) {
+                ++index;
+            }
+        }
+        return index;
+    }
+
+    [[nodiscard]] bool match_attribute(const Compiled& compiled, const NodeId node) const {
+        const auto&  selector = static_cast<const AttributeSelector&>(*compiled.source);
+        const size_t begin    = m_document.m_attribute_begin[node];
+        const size_t end      = m_document.m_attribute_begin[node + 1];
+        for (size_t i = begin; i < end; ++i) {
+            if (compiled.atoms[m_document.m_attribute_names[i]] != 0) {
+                return selector.operator_type() == AttributeOperator::Exists || selector.matches_attribute_value(m_document.view(m_document.m_attribute_values[i]));
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool match_pseudo(const Compiled& compiled, const NodeId node) const {
+        const auto& selector = static_cast<const PseudoClassSelector&>(*compiled.source);
+        switch (compiled.pseudo) {
+            case Pseudo::FirstChild:
+                return previous_element(node) == FrozenDocument::kInvalidNode;
+            case Pseudo::LastChild:
+                return next_element(node) == FrozenDocument::kInvalidNode;
+            case Pseudo::OnlyChild:
+                return previous_element(node) == FrozenDocument::kInvalidNode && next_element(node) == FrozenDocument::kInvalidNode;
+            case Pseudo::NthChild:
+                return PseudoClassSelector::matches_nth_expression(selector.argument(), sibling_index(node, false, false));
+            case Pseudo::NthLastChild:
+                return PseudoClassSelector::matches_nth_expression(selector.argument(), sibling_index(node, true, false));
+            case Pseudo::FirstOfType:
+                return sibling_index(node, false, true) == 1;
+            case Pseudo::LastOfType:
+                return sibling_index(node, true, true) == 1;
+            case Pseudo::NthOfType:
+                return PseudoClassSelector::matches_nth_expression(selector.argument(), sibling_index(node, false, true));
+            case Pseudo::NthLastOfType:
+                return PseudoClassSelector::matches_nth_expression(selector.argument(), sibling_index(node, true, true));
+            case Pseudo::OnlyOfType:
+                return sibling_index(node, false, true) == 1 && sibling_index(node, true, true) == 1;
+            case Pseudo::Empty:
+                for (NodeId child = m_document.first_child(node); child != FrozenDocument::kInvalidNode; child = m_document.next_sibling(child)) {
+                    if (m_document.is_element(child)) {
+                        return false;
+                    }
+                    if (m_document.type(child) == NodeType::Text && !std::ranges::all_of(m_document.text(child), is_whitespace)) {
+                        return false;
+                    }
+                }
+                return true;
+            case Pseudo::Root:
+                return m_document.parent(node) == FrozenDocument::root();
+            case Pseudo::Not:
+                return compiled.has_right && !any_child_matches(compiled, node);
+            case Pseudo::Is:
+            case Pseudo::Where:
+                return compiled.has_right && any_child_matches(compiled, node);
+            case Pseudo::Has:
+            case Pseudo::Hover:
+            case Pseudo::Active:
+            case Pseudo::Focus:
+            case Pseudo::Visited:
+                return false;
+            case Pseudo::Link:
+                return equals_ignore_case(m_document.tag_name(node), "a") && m_document.has_attribute(node, "href");
+            case Pseudo::Disabled:
+                return m_document.has_attribute(node, "disabled");
+            case Pseudo::Enabled: {
+                static constexpr std::array<std::string_view, 7> form_elements = {"input", "button", "select", "textarea", "option", "optgroup", "fieldset"};
+                const auto                                        tag           = m_document.tag_name(node);
+                return std::ranges::any_of(form_elements, [tag](const auto form_element) { return equals_ignore_case(tag, form_element); }) && !m_document.has_attribute(node, "disabled");
+            }
+            case Pseudo::Checked: {
+                const auto tag = m_document.tag_name(node);
+                if (equals_ignore_case(tag, "input")) {
+                    const auto type = m_document.get_attribute(node, "type");
+                    return (equals_ignore_case(type, "checkbox") || equals_ignore_case(type, "radio")) && m_document.has_attribute(node, "checked");
+                }
+                return equals_ignore_case(tag, "option") && m_document.has_attribute(node, "selected");
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool match(const Compiled& compiled, const NodeId node) const {
+        switch (compiled.type) {
+            case SelectorType::Universal:
+                return true;
+            case SelectorType::Type:
+                return compiled.atoms[m_document.m_tags[node]] != 0;
+            case SelectorType::Class:
+                return m_document.has_class(node, compiled.value);
+            case SelectorType::Id:
+                return !compiled.value.empty() && m_document.id(node) == compiled.value && m_document.has_attribute(node, "id");
+            case SelectorType::Attribute:
+                return match_attribute(compiled, node);
+            case SelectorType::Compound:
+                return !compiled.children.empty() && std::ranges::all_of(compiled.children, [this, node](const Compiled& part) { return match(part, node); });
+            case SelectorType::PseudoClass:
+                return match_pseudo(compiled, node);
+            case SelectorType::PseudoElement:
+                return false;
+            case SelectorType::Descendant:
+            case SelectorType::Child:
+            case SelectorType::Adjacent:
+            case SelectorType::Sibling:
+                return match_combinator(compiled, node);
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool match_combinator(const Compiled& compiled, const NodeId node) const {
+        if (!compiled.has_right || !match(compiled.children[1], node)) {
+            return false;
+        }
+        if (!compiled.has_left) {
+            return true;
+        }
+        const Compiled& left = compiled.children[0];
+        switch (compiled.type) {
+            case SelectorType::Descendant:
+                for (NodeId ancestor = m_document.parent(node); ancestor != FrozenDocument::kInvalidNode; ancestor = m_document.parent(ancestor)) {
+                    if (m_document.is_element(ancestor) && match(left, ancestor)) {
+                        return true;
+                    }
+                }
+                return false;
+            case SelectorType::Child: {
+                const NodeId parent = m_document.parent(node);
+                return parent != FrozenDocument::kInvalidNode && m_document.is_element(parent) && match(left, parent);
+            }
+            case SelectorType::Adjacent: {
+                const NodeId previous = previous_element(node);
+                return previous != FrozenDocument::kInvalidNode && match(left, previous);
+            }
+            case SelectorType::Sibling:
+                for (NodeId previous = previous_element(node); previous != FrozenDocument::kInvalidNode; previous = previous_element(previous)) {
+                    if (match(left, previous)) {
+                        return true;
+                    }
+                }
+                return false;
+            default:
+                return false;
+        }
+    }
+};
+
+std::vector<FrozenDocument::NodeId> FrozenDocument::find_all(const SelectorList& selector_list) const {
+    const FrozenSelectorMatcher matcher(*this, selector_list);
+    std::vector<NodeId>         results;
+    // 编号即文档顺序，顺序扫描类型列即可遍历所有元素
+    for (NodeId node = 1; node < m_types.size(); ++node) {
+        if (m_types[node] == NodeType::Element && matcher.matches(node)) {
+            results.push_back(node);
+        }
+    }
+    return results;
+}
+
+FrozenDocument::NodeId FrozenDocument::find_first(const SelectorList& selector_list) const {
+    const FrozenSelectorMatcher matcher(*this, selector_list);
+    for (NodeId node = 1; node < m_types.size(); ++node) {
+        if (m_types[node] == NodeType::Element && matcher.matches(node)) {
+            return node;
+        }
+    }
+    return kInvalidNode;
+}
+
+std::vector<FrozenDocument::NodeId> FrozenDocument::css(const std::string_view selector) const {
+    const auto selector_list = parse_css_selector_cached(selector);
+    if (!selector_list || selector_list->empty()) {
+        return {};
+    }
+    return find_all(*selector_list);
+}
+
+FrozenDocument::NodeId FrozenDocument::css_first(const std::string_view selector) const {
+    const auto selector_list = parse_css_selector_cached(selector);
+    if (!selector_list || selector_list->empty()) {
+        return kInvalidNode;
+    }
+    return find_first(*selector_list);
+}
+
+}  // namespace hps
@@ -88,20 +88,39 @@ const CommentNode* Node::as_comment() const noexcept {
 }
 
 const Document* Node::owner_document() const noexcept {
-    const Node* current = this;
-    while (current && current->m_parent) {
-        current = current->m_parent;
+    if (m_type == NodeType::Document) {
+        return static_cast<const Document*>(this);
     }
-    return current ? current->as_document() : nullptr;
+    return m_owner_document;
 }
 
 Document* Node::owner_document_mut() noexcept {
     return const_cast<Document*>(std::as_const(*this).owner_document());
 }
 
-void Node::invalidate_document_query_cache() noexcept {
+void Node::notify_attribute_changed(const Element& element, const std::string_view name, const std::string_view old_value) noexcept {
     if (auto* document = owner_document_mut()) {
-        document->invalidate_query_indexes();
+        document->on_attribute_changed(element, name, old_value);
+    }
+}
+
+void Node::set_subtree_owner(Document* owner) noexcept {
+    // 已挂载子树内所有节点共享同一所属文档，相同则无需遍历
+    if (m_owner_document == owner) {
+        return;
+    }
+    // 沿父/兄弟指针先序遍历，不分配内存
+    Node* current = this;
+    while (current != nullptr) {
+        current->m_owner_document = owner;
+        if (!current->m_children.empty()) {
+            current = current->m_children.front().get();
+            continue;
+        }
+        while (current != this && current->m_next_sibling == nullptr) {
+            current = current->m_parent;
+        }
+        current = current == this ? nullptr : current->m_next_sibling;
     }
 }
 
@@ -119,6 +138,12 @@ Node* Node::append_child(std::unique_ptr<Node> child) {
     }
 
     m_children.push_back(std::move(child));
+
+    Document* owner = owner_document_mut();
+    inserted->set_subtree_owner(owner);
+    if (owner != nullptr) {
+        owner->on_subtree_attached(*inserted);
+    }
     return inserted;
 }
 
@@ -149,6 +174,12 @@ Node* Node::insert_child_before(std::unique_ptr<Node> child, const Node* before)
     }
 
     m_children.insert(it, std::move(child));
+
+    Document* owner = owner_document_mut();
+    inserted->set_subtree_owner(owner);
+    if (owner != nullptr) {
+        owner->on_subtree_attached(*inserted);
+    }
     return inserted;
 }
 
@@ -157,7 +188,13 @@ void Node::set_parent(Node* parent_node) noexcept {
 }
 
 std::vector<std::unique_ptr<Node>> Node::take_children() {
+    if (Document* owner = owner_document_mut()) {
+        for (const auto& child : m_children) {
+            owner->on_subtree_detached(*child);
+        }
+    }
     for (auto& child : m_children) {
+        child->set_subtree_owner(nullptr);
         child->m_parent       = nullptr;
         child->m_prev_sibling = nullptr;
         child->m_next_sibling = nullptr;
@@ -0,0 +1,367 @@
+#include "hps/core/text_extractor.hpp"
+
+#include "hps/core/element.hpp"
+#include "hps/core/node.hpp"
+#include "hps/core/text_node.hpp"
+#include "hps/utils/unicode.hpp"
+#include "hps/utils/whitespace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace hps {
+
+namespace {
+
+enum class ElementRole : std::uint8_t {
+    Inline,
+    Block,
+    LineBreak,
+    Preformatted,
+    NonContent,
+};
+
+/**
+ * @brief 标签名的小写副本，超长标签名不属于任何已知类别
+ */
+[[nodiscard]] auto lowercase_tag(const std::string_view name, std::array<char, 16>& buffer) noexcept -> std::string_view {
+    if (name.size() > buffer.size()) {
+        return {};
+    }
+    for (size_t i = 0; i < name.size(); ++i) {
+        const char c = name[i];
+        buffer[i]    = c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+    return {buffer.data(), name.size()};
+}
+
+[[nodiscard]] auto element_role(const Element& element, const bool skip_non_content) noexcept -> ElementRole {
+    static constexpr auto block_tags = std::to_array<std::string_view>({
+        "address", "article", "aside", "blockquote", "body", "caption", "dd", "details", "dialog", "div",
+        "dl", "dt", "fieldset", "figcaption", "figure", "footer", "form", "h1", "h2", "h3", "h4", "h5",
+        "h6", "head", "header", "hgroup", "hr", "html", "legend", "li", "main", "menu", "nav", "ol",
+        "option", "p", "section", "summary", "table", "tbody", "td", "tfoot", "th", "thead", "title", "tr",
+        "ul",
+    });
+    static_assert(std::ranges::is_sorted(block_tags));
+
+    std::array<char, 16>   buffer{};
+    const std::string_view name = lowercase_tag(element.tag_name(), buffer);
+    if (name == "br") {
+        return ElementRole::LineBreak;
+    }
+    if (name == "pre" || name == "textarea" || name == "listing") {
+        return ElementRole::Preformatted;
+    }
+    if (skip_non_content && (name == "script" || name == "style" || name == "template")) {
+        return ElementRole::NonContent;
+    }
+    return std::ranges::binary_search(block_tags, name) ? ElementRole::Block : ElementRole::Inline;
+}
+
+/**
+ * @brief 一次提取过程的输出状态
+ *
+ * 空白与块边界先记为待输出，直到遇到下一段可见文本才落地，因此首尾空白与重复换行自然被丢弃。
+ */
+class ExtractionSink {
+  public:
+    ExtractionSink(const TextExtractionOptions& options, std::string& out)
+        : m_options(options),
+          m_out(out),
+          m_start(out.size()) {}
+
+    void text(const std::string_view text) {
+        if (!m_options.collapse_whitespace || m_preformatted_depth > 0) {
+            if (!text.empty()) {
+                flush();
+                append_run(text);
+            }
+            return;
+        }
+
+        size_t pos = 0;
+        while (pos < text.size()) {
+            const size_t whitespace = find_whitespace(text, pos);
+            if (whitespace != pos) {
+                flush();
+                append_run(text.substr(pos, whitespace - pos));
+            }
+            if (whitespace == text.size()) {
+                break;
+            }
+            m_pending_space = true;
+            pos             = find_non_whitespace(text, whitespace + 1);
+        }
+    }
+
+    void block_boundary() noexcept {
+        if (m_options.block_newlines) {
+            m_pending_break = true;
+        } else {
+            m_pending_space = true;
+        }
+    }
+
+    void line_break() {
+        switch (m_options.br_handling) {
+            case BRHandling::Keep:
+                m_pending_space = true;
+                break;
+            case BRHandling::InsertNewline:
+                m_out.push_back('\n');
+                m_pending_space = false;
+                m_pending_break = false;
+                break;
+            case BRHandling::InsertCustom:
+                flush();
+                m_out.append(m_options.br_text);
+                break;
+        }
+    }
+
+    void enter_preformatted() noexcept {
+        ++m_preformatted_depth;
+    }
+
+    void leave_preformatted() noexcept {
+        --m_preformatted_depth;
+    }
+
+  private:
+    void flush() {
+        if (m_out.size() > m_start) {
+            const char last = m_out.back();
+            if (m_pending_break && last != '\n') {
+                m_out.push_back('\n');
+            } else if (m_pending_space && !m_pending_break && last != '\n' && last != ' ') {
+                m_out.push_back(' ');
+            }
+        }
+        m_pending_space = false;
+        m_pending_break = false;
+    }
+
+    void append_run(const std::string_view run) {
+        if (!m_options.nfc && !m_options.case_fold) {
+            m_out.append(run);
+            return;
+        }
+        if (!m_options.case_fold) {
+            append_nfc(run, m_out);
+            return;
+        }
+        if (!m_options.nfc) {
+            append_case_folded(run, m_out);
+            return;
+        }
+        // 折叠结果可能不再是 NFC（如 U+0130 折叠为 "i" 加组合点），折叠后再规范化
+        m_scratch.clear();
+        append_case_folded(run, m_scratch);
+        append_nfc(m_scratch, m_out);
+    }
+
+    const TextExtractionOptions& m_options;
+    std::string&                 m_out;
+    size_t                       m_start;
+    size_t                       m_preformatted_depth{0};
+    bool                         m_pending_space{false};
+    bool                         m_pending_break{false};
+    std::string                  m_scratch;
+};
+
+[[nodiscard]] auto is_ascii_word_byte(const char c) noexcept -> bool {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+[[nodiscard]] auto is_ideograph(const char32_t cp) noexcept -> bool {
+    return (cp >= 0x3040 && cp <= 0x30FF) ||   // 平假名、片假名
+           (cp >= 0x3400 && cp <= 0x4DBF) ||   // CJK 扩展 A
+           (cp >= 0x4E00 && cp <= 0x9FFF) ||   // CJK 统一表意文字
+           (cp >= 0xF900 && cp <= 0xFAFF) ||   // CJK 兼容表意文字
+           (cp >= 0x20000 && cp <= 0x3FFFF);   // CJK 扩展 B 及以后
+}
+
+/**
+ * @brief 非 ASCII 码位是否为词字符：排除常见的空白、标点与符号区段，其余按字母处理
+ */
+[[nodiscard]] auto is_word_code_point(const char32_t cp) noexcept -> bool {
+    if (cp < 0x80) {
+        return is_ascii_word_byte(static_cast<char>(cp));
+    }
+    if (cp <= 0xBF) {
+        return cp == 0xAA || cp == 0xB2 || cp == 0xB3 || cp == 0xB5 || cp == 0xB9 || cp == 0xBA;
+    }
+    if (cp == 0xD7 || cp == 0xF7) {
+        return false;
+    }
+    return !((cp >= 0x2000 && cp <= 0x2BFF) ||   // 通用标点、货币、箭头、数学与杂项符号
+             (cp >= 0x3000 && cp <= 0x303F) ||   // CJK 符号和标点
+             (cp >= 0xFE10 && cp <= 0xFE6F) ||   // 竖排与小型标点
+             (cp >= 0xFF00 && cp <= 0xFF0F) || (cp >= 0xFF1A && cp <= 0xFF20) ||
+             (cp >= 0xFF3B && cp <= 0xFF40) || (cp >= 0xFF5B && cp <= 0xFF65) ||   // 全角标点
+             cp == 0xFFFD);
+}
+
+[[nodiscard]] auto is_mid_letter(const char32_t cp) noexcept -> bool {
+    return cp == '\'' || cp == 0x2019;
+}
+
+[[nodiscard]] auto is_mid_number(const char32_t cp) noexcept -> bool {
+    return cp == '.' || cp == ',';
+}
+
+[[nodiscard]] auto is_digit_code_point(const char32_t cp) noexcept -> bool {
+    return cp >= '0' && cp <= '9';
+}
+
+}  // namespace
+
+TextExtractor::TextExtractor(TextExtractionOptions options)
+    : m_options(std::move(options)) {}
+
+void TextExtractor::extract(const Node& root, std::string& out) const {
+    ExtractionSink sink(m_options, out);
+
+    // 进入节点时输出文本或块起始边界，返回是否需要遍历子节点
+    const auto enter = [&](const Node& node) {
+        if (node.is_text()) {
+            sink.text(node.as_text()->value());
+            return false;
+        }
+        if (node.is_document()) {
+            return true;
+        }
+        if (!node.is_element()) {
+            return false;
+        }
+        switch (element_role(*node.as_element(), m_options.skip_non_content)) {
+            case ElementRole::LineBreak:
+                sink.line_break();
+                return false;
+            case ElementRole::NonContent:
+                return false;
+            case ElementRole::Preformatted:
+                sink.block_boundary();
+                sink.enter_preformatted();
+                return true;
+            case ElementRole::Block:
+                sink.block_boundary();
+                return true;
+            case ElementRole::Inline:
+                return true;
+        }
+        return true;
+    };
+    const auto leave = [&](const Node& node) {
+        if (!node.is_element()) {
+            return;
+        }
+        const ElementRole role = element_role(*node.as_element(), m_options.skip_non_content);
+        if (role == ElementRole::Preformatted) {
+            sink.leave_preformatted();
+        }
+        if (role == ElementRole::Block || role == ElementRole::Preformatted) {
+            sink.block_boundary();
+        }
+    };
+
+    // 借助父/兄弟指针做先序遍历，不使用递归
+    const Node* node = &root;
+    while (node != nullptr) {
+        const bool entered = enter(*node);
+        if (entered && node->first_child() != nullptr) {
+            node = node->first_child();
+            continue;
+        }
+        if (entered) {
+            leave(*node);
+        }
+        while (node != &root && node->next_sibling() == nullptr) {
+            node = node->parent();
+            leave(*node);
+        }
+        node = node == &root ? nullptr : node->next_sibling();
+    }
+}
+
+std::string TextExtractor::extract(const Node& root) const {
+    std::string out;
+    extract(root, out);
+    return out;
+}
+
+void TextExtractor::extract_words(const Node& root, std::string& buffer, std::vector<std::string_view>& words) const {
+    const size_t start = buffer.size();
+    extract(root, buffer);
+    segment_words(std::string_view(buffer).substr(start), words);
+}
+
+void TextExtractor::segment_words(const std::string_view text, std::vector<std::string_view>& words) {
+    size_t   word_begin = std::string_view::npos;
+    char32_t previous   = 0;
+    size_t   pos        = 0;
+    while (pos < text.size()) {
+        const size_t   start = pos;
+        const char32_t cp    = next_code_point(text, pos);
+
+        if (is_ideograph(cp)) {
+            if (word_begin != std::string_view::npos) {
+                words.push_back(text.substr(word_begin, start - word_begin));
+                word_begin = std::string_view::npos;
+            }
+            words.push_back(text.substr(start, pos - start));
+            previous = cp;
+            continue;
+        }
+
+        if (is_word_code_point(cp)) {
+            if (word_begin == std::string_view::npos) {
+                word_begin = start;
+            }
+            previous = cp;
+            continue;
+        }
+
+        // 词内连接符：撇号两侧都是字母、'.'/',' 两侧都是数字时不切分
+        if (word_begin != std::string_view::npos && pos < text.size()) {
+            size_t         next_pos  = pos;
+            const char32_t following = next_code_point(text, next_pos);
+            const bool     joins_letters = is_mid_letter(cp) && is_word_code_point(previous) && !is_digit_code_point(previous) &&
+                                       is_word_code_point(following) && !is_ideograph(following);
+            const bool joins_digits = is_mid_number(cp) && is_digit_code_point(previous) && is_digit_code_point(following);
+            if (joins_letters || joins_digits) {
+                previous = cp;
+                continue;
+            }
+        }
+
+        if (word_begin != std::string_view::npos) {
+            words.push_back(text.substr(word_begin, start - word_begin));
+            word_begin = std::string_view::npos;
+        }
+        previous = cp;
+    }
+    if (word_begin != std::string_view::npos) {
+        words.push_back(text.substr(word_begin));
+    }
+}
+
+void append_text_content(const Node& root, std::string& out) {
+    const Node* node = &root;
+    while (node != nullptr) {
+        if (node->is_text()) {
+            out.append(node->as_text()->value());
+        } else if (!node->is_comment() && node->first_child() != nullptr) {
+            node = node->first_child();
+            continue;
+        }
+        while (node != &root && node->next_sibling() == nullptr) {
+            node = node->parent();
+        }
+        node = node == &root ? nullptr : node->next_sibling();
+    }
+}
+
+}  // namespace hps
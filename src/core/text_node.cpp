@@ -5,9 +5,9 @@
 
 namespace hps {
 
-TextNode::TextNode(const std::string_view text) noexcept
+TextNode::TextNode(const std::string_view text, const bool needs_decode) noexcept
     : Node(NodeType::Text),
-      m_text(text) {}
+      m_text(text, needs_decode, LazyEntityText::Context::Text) {}
 
 NodeType TextNode::type() const noexcept {
     return NodeType::Text;
@@ -23,31 +23,38 @@ std::string TextNode::name() const {
 }
 
 const std::string& TextNode::value() const {
-    return m_text;
+    return m_text.get();
 }
 
 std::string TextNode::text_content() const {
-    return m_text;
+    return m_text.get();
 }
 
 const std::string& TextNode::text() const {
-    return m_text;
+    return m_text.get();
 }
 
 std::string TextNode::trim() const {
-    const auto trimmed = trim_whitespace(m_text);
+    const auto trimmed = trim_whitespace(m_text.get());
     return std::string(trimmed);
 }
 
-bool TextNode::empty() const noexcept {
-    return m_text.empty();
+bool TextNode::empty() const {
+    return m_text.get().empty();
 }
 
-size_t TextNode::length() const noexcept {
-    return m_text.length();
+size_t TextNode::length() const {
+    return m_text.get().length();
 }
 
-void TextNode::append_text(const std::string_view text) {
-    m_text.append(text);
+void TextNode::append_text(const std::string_view text, const bool needs_decode) {
+    // 先解码已有内容再追加，避免两段原始文本在拼接处组成新的字符引用
+    std::string& content = m_text.materialize();
+    if (needs_decode) {
+        decode_html_entities(text, content);
+        return;
+    }
+    content.append(text);
 }
+
 }  // namespace hps
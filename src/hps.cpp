@@ -14,6 +14,18 @@ std::shared_ptr<Document> parse(const std::string_view html, const Options& opti
     return parser.parse(html, options);
 }
 
+std::shared_ptr<Document> parse_borrowed(const std::string_view html, std::shared_ptr<const void> keep_alive) {
+    return parse_borrowed(html, std::move(keep_alive), Options());
+}
+
+std::shared_ptr<Document> parse_borrowed(
+    const std::string_view html,
+    std::shared_ptr<const void> keep_alive,
+    const Options& options) {
+    HTMLParser parser;
+    return parser.parse_borrowed(html, std::move(keep_alive), options);
+}
+
 std::shared_ptr<Document> parse_fragment(const std::string_view html, const std::string_view context_tag) {
     return parse_fragment(html, context_tag, Options());
 }
@@ -32,7 +44,7 @@ ParseResult parse_with_error(const std::string_view html, const Options& options
     const std::shared_ptr<Document> document = parser.parse(html, options);
     const std::vector<HPSError>     errors   = parser.get_errors();
 
-    return ParseResult{.document = document, .errors = errors};
+    return ParseResult{.document = document, .errors = errors, .status = parser.status()};
 }
 
 ParseResult parse_fragment_with_error(const std::string_view html, const std::string_view context_tag) {
@@ -44,7 +56,7 @@ ParseResult parse_fragment_with_error(const std::string_view html, const std::st
     const std::shared_ptr<Document> document = parser.parse_fragment(html, context_tag, options);
     const std::vector<HPSError>     errors   = parser.get_errors();
 
-    return ParseResult{.document = document, .errors = errors};
+    return ParseResult{.document = document, .errors = errors, .status = parser.status()};
 }
 
 std::shared_ptr<Document> parse_file(const std::string_view path) {
@@ -65,7 +77,42 @@ ParseResult parse_file_with_error(const std::string_view path, const Options& op
     const std::shared_ptr<Document> document = parser.parse_file(path, options);
     const std::vector<HPSError>     errors   = parser.get_errors();
 
-    return ParseResult{.document = document, .errors = errors};
+    return ParseResult{.document = document, .errors = errors, .status = parser.status()};
+}
+
+std::shared_ptr<Document> parse_bytes(const std::string_view raw_bytes) {
+    return parse_bytes(raw_bytes, Options());
+}
+
+std::shared_ptr<Document> parse_bytes(const std::string_view raw_bytes, const Options& options) {
+    return parse_bytes(raw_bytes, options, {});
+}
+
+std::shared_ptr<Document> parse_bytes(
+    const std::string_view raw_bytes,
+    const Options& options,
+    const std::string_view transport_charset) {
+    HTMLParser parser;
+    return parser.parse_bytes(raw_bytes, options, transport_charset);
+}
+
+ParseResult parse_bytes_with_error(const std::string_view raw_bytes) {
+    return parse_bytes_with_error(raw_bytes, Options());
+}
+
+ParseResult parse_bytes_with_error(const std::string_view raw_bytes, const Options& options) {
+    return parse_bytes_with_error(raw_bytes, options, {});
+}
+
+ParseResult parse_bytes_with_error(
+    const std::string_view raw_bytes,
+    const Options& options,
+    const std::string_view transport_charset) {
+    HTMLParser                      parser;
+    const std::shared_ptr<Document> document = parser.parse_bytes(raw_bytes, options, transport_charset);
+    const std::vector<HPSError>     errors   = parser.get_errors();
+
+    return ParseResult{.document = document, .errors = errors, .status = parser.status()};
 }
 
 std::string version() {
@@ -0,0 +1,409 @@
+#include "hps/parsing/archive_reader.hpp"
+
+#include "hps/core/document.hpp"
+#include "hps/parsing/html_parser.hpp"
+#include "hps/utils/encoding.hpp"
+#include "hps/utils/exception.hpp"
+#include "hps/utils/mapped_file.hpp"
+#include "hps/utils/string_utils.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <string>
+#include <utility>
+
+#ifdef HPS_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace hps {
+
+namespace {
+
+[[noreturn]] void throw_invalid_archive(const std::string& message) {
+    throw HPSException(ErrorCode::InvalidArchive, "Invalid archive: " + message);
+}
+
+[[nodiscard]] auto has_gzip_magic(const std::string_view data) noexcept -> bool {
+    return data.size() >= 2 && static_cast<unsigned char>(data[0]) == 0x1F && static_cast<unsigned char>(data[1]) == 0x8B;
+}
+
+[[nodiscard]] auto skip_whitespace(const std::string_view data, size_t cursor) noexcept -> size_t {
+    while (cursor < data.size() && is_whitespace(data[cursor])) {
+        ++cursor;
+    }
+    return cursor;
+}
+
+/**
+ * @brief 还原后的分块负载，同时持有其头部字段所在的数据段
+ */
+struct ChunkedBodyHolder {
+    std::shared_ptr<const void> segment_owner; /**< 数据段的所有者 */
+    std::string                 body;          /**< 还原后的负载 */
+};
+
+/**
+ * @brief 头部块的边界
+ */
+struct HeaderBlock {
+    std::string_view headers;    /**< 不含结尾空行的头部文本 */
+    size_t           body_begin; /**< 空行之后第一个字节的位置 */
+};
+
+/**
+ * @brief 查找从 begin 开始的头部块，兼容 CRLF 与 LF 换行
+ */
+[[nodiscard]] auto find_header_block(const std::string_view data, const size_t begin) noexcept
+    -> std::optional<HeaderBlock> {
+    const size_t crlf = data.find("\r\n\r\n", begin);
+    const size_t lf   = data.find("\n\n", begin);
+    if (crlf == std::string_view::npos && lf == std::string_view::npos) {
+        return std::nullopt;
+    }
+    if (crlf != std::string_view::npos && (lf == std::string_view::npos || crlf < lf)) {
+        return HeaderBlock{data.substr(begin, crlf - begin), crlf + 4};
+    }
+    return HeaderBlock{data.substr(begin, lf - begin), lf + 2};
+}
+
+/**
+ * @brief 在头部文本中查找字段值（字段名大小写不敏感），首行（版本行或状态行）被跳过
+ */
+[[nodiscard]] auto header_value(std::string_view headers, const std::string_view name) noexcept
+    -> std::string_view {
+    size_t line_begin = headers.find('\n');
+    while (line_begin != std::string_view::npos && line_begin < headers.size()) {
+        ++line_begin;
+        const size_t     line_end = headers.find('\n', line_begin);
+        std::string_view line     = headers.substr(line_begin, line_end == std::string_view::npos ? headers.size() - line_begin : line_end - line_begin);
+        if (const size_t colon = line.find(':'); colon != std::string_view::npos &&
+                                                 equals_ignore_case(trim_whitespace(line.substr(0, colon)), name)) {
+            return trim_whitespace(line.substr(colon + 1));
+        }
+        line_begin = line_end;
+    }
+    return {};
+}
+
+[[nodiscard]] auto media_type(const std::string_view content_type) noexcept -> std::string_view {
+    return trim_whitespace(content_type.substr(0, content_type.find(';')));
+}
+
+[[nodiscard]] auto is_html_media_type(const std::string_view content_type) noexcept -> bool {
+    const std::string_view type = media_type(content_type);
+    return equals_ignore_case(type, "text/html") || equals_ignore_case(type, "application/xhtml+xml");
+}
+
+[[nodiscard]] auto charset_parameter(const std::string_view content_type) noexcept -> std::string_view {
+    size_t cursor = content_type.find(';');
+    while (cursor != std::string_view::npos) {
+        const size_t     next      = content_type.find(';', cursor + 1);
+        std::string_view parameter = trim_whitespace(content_type.substr(cursor + 1, next == std::string_view::npos ? std::string_view::npos : next - cursor - 1));
+        if (starts_with_ignore_case(parameter, "charset=")) {
+            std::string_view value = trim_whitespace(parameter.substr(8));
+            if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front()) {
+                value = value.substr(1, value.size() - 2);
+            }
+            return value;
+        }
+        cursor = next;
+    }
+    return {};
+}
+
+/**
+ * @brief 还原分块传输编码的 HTTP 负载
+ * @return 还原后的负载，格式错误时返回 std::nullopt
+ */
+[[nodiscard]] auto decode_chunked_body(std::string_view body) -> std::optional<std::string> {
+    std::string decoded;
+    decoded.reserve(body.size());
+    while (true) {
+        const size_t line_end = body.find('\n');
+        if (line_end == std::string_view::npos) {
+            return std::nullopt;
+        }
+        const std::string_view size_field = trim_whitespace(body.substr(0, std::min(line_end, body.find(';'))));
+        size_t                 chunk_size = 0;
+        const auto [end, error]           = std::from_chars(size_field.data(), size_field.data() + size_field.size(), chunk_size, 16);
+        if (error != std::errc{} || end != size_field.data() + size_field.size()) {
+            return std::nullopt;
+        }
+        body.remove_prefix(line_end + 1);
+        if (chunk_size == 0) {
+            return decoded;
+        }
+        if (chunk_size > body.size()) {
+            return std::nullopt;
+        }
+        decoded.append(body.substr(0, chunk_size));
+        body.remove_prefix(chunk_size);
+        body.remove_prefix(std::min(body.find('\n') + 1, body.size()));
+    }
+}
+
+}  // namespace
+
+#ifdef HPS_HAS_ZLIB
+
+struct ArchiveReader::GzipState {
+    GzipState() {
+        if (inflateInit2(&stream, 15 + 16) != Z_OK) {
+            throw HPSException(ErrorCode::OutOfMemory, "Failed to initialize gzip decoder");
+        }
+    }
+
+    ~GzipState() {
+        inflateEnd(&stream);
+    }
+
+    GzipState(const GzipState&)            = delete;
+    GzipState& operator=(const GzipState&) = delete;
+
+    /**
+     * @brief 解压从 input 开头的一个 gzip 成员
+     * @return 该成员占用的压缩字节数
+     *
+     * 成员的解压长度事先未知（ISIZE 位于成员末尾），输出缓冲区从较小的固定容量开始按倍数增长，
+     * 结束时收缩到实际长度：记录会长期持有该缓冲区，多余容量不能随记录一起保留。
+     */
+    size_t inflate_member(const std::string_view input, std::string& out) {
+        // zlib 的长度字段为 32 位，超大输入分段送入
+        constexpr size_t kMaxStep      = size_t{1} << 30;
+        constexpr size_t kInitialSpace = 16 * 1024;
+
+        inflateReset(&stream);
+        out.resize(kInitialSpace);
+        size_t consumed = 0;
+        size_t produced = 0;
+        while (true) {
+            if (produced == out.size()) {
+                out.resize(out.size() * 2);
+            }
+            const size_t in_step  = std::min(input.size() - consumed, kMaxStep);
+            const size_t out_step = std::min(out.size() - produced, kMaxStep);
+            stream.next_in        = reinterpret_cast<Bytef*>(const_cast<char*>(input.data() + consumed));
+            stream.avail_in       = static_cast<uInt>(in_step);
+            stream.next_out       = reinterpret_cast<Bytef*>(out.data() + produced);
+            stream.avail_out      = static_cast<uInt>(out_step);
+
+            const int result = inflate(&stream, Z_NO_FLUSH);
+            consumed += in_step - stream.avail_in;
+            produced += out_step - stream.avail_out;
+            if (result == Z_STREAM_END) {
+                break;
+            }
+            if (result == Z_BUF_ERROR && consumed == input.size()) {
+                throw_invalid_archive("truncated gzip member");
+            }
+            if (result != Z_OK && result != Z_BUF_ERROR) {
+                throw_invalid_archive(std::string("corrupted gzip member: ") + (stream.msg != nullptr ? stream.msg : "unknown error"));
+            }
+        }
+        out.resize(produced);
+        out.shrink_to_fit();
+        return consumed;
+    }
+
+    z_stream stream{};
+};
+
+bool ArchiveReader::gzip_supported() noexcept {
+    return true;
+}
+
+#else
+
+struct ArchiveReader::GzipState {
+    size_t inflate_member(std::string_view /*input*/, std::string& /*out*/) {
+        throw_invalid_archive("gzip input requires zlib support");
+    }
+};
+
+bool ArchiveReader::gzip_supported() noexcept {
+    return false;
+}
+
+#endif
+
+ArchiveReader::ArchiveReader(
+    const std::string_view data,
+    std::shared_ptr<const void> keep_alive,
+    const ArchiveFormat format)
+    : m_input(data),
+      m_input_owner(std::move(keep_alive)),
+      m_format(format) {}
+
+ArchiveReader::~ArchiveReader() = default;
+
+ArchiveReader::ArchiveReader(ArchiveReader&& other) noexcept            = default;
+ArchiveReader& ArchiveReader::operator=(ArchiveReader&& other) noexcept = default;
+
+ArchiveReader ArchiveReader::open(const std::filesystem::path& path, const ArchiveFormat format) {
+    auto             mapping = MappedFile::open_shared(path);
+    std::string_view data    = mapping->data();
+    return ArchiveReader(data, std::move(mapping), format);
+}
+
+std::optional<ArchiveRecord> ArchiveReader::next() {
+    while (true) {
+        m_cursor = skip_whitespace(m_segment, m_cursor);
+        if (m_cursor < m_segment.size()) {
+            if (m_format == ArchiveFormat::Auto) {
+                m_format = m_segment.substr(m_cursor).starts_with("WARC/") ? ArchiveFormat::Warc : ArchiveFormat::ConcatenatedHtml;
+            }
+            auto record = m_format == ArchiveFormat::Warc ? next_warc_record() : next_html_document();
+            if (record.has_value()) {
+                return record;
+            }
+        }
+        if (!load_next_segment()) {
+            return std::nullopt;
+        }
+    }
+}
+
+bool ArchiveReader::load_next_segment() {
+    if (!m_started) {
+        m_started = true;
+        if (!has_gzip_magic(m_input)) {
+            m_segment       = m_input;
+            m_segment_owner = m_input_owner;
+            m_cursor        = 0;
+            return true;
+        }
+        m_gzip = std::make_unique<GzipState>();
+    }
+    if (!m_gzip || m_input_cursor >= m_input.size()) {
+        return false;
+    }
+
+    // 每个 gzip 成员解压到独立的共享缓冲区，已产出的记录不受后续解压影响
+    auto buffer = std::make_shared<std::string>();
+    m_input_cursor += m_gzip->inflate_member(m_input.substr(m_input_cursor), *buffer);
+    m_segment_base += m_segment.size();
+    m_segment       = *buffer;
+    m_segment_owner = std::move(buffer);
+    m_cursor        = 0;
+    return true;
+}
+
+std::optional<ArchiveRecord> ArchiveReader::next_warc_record() {
+    while (true) {
+        m_cursor = skip_whitespace(m_segment, m_cursor);
+        if (m_cursor >= m_segment.size()) {
+            return std::nullopt;
+        }
+        const size_t record_begin = m_cursor;
+        if (!m_segment.substr(record_begin).starts_with("WARC/")) {
+            throw_invalid_archive("expected WARC version line at offset " + std::to_string(m_segment_base + record_begin));
+        }
+        const auto header_block = find_header_block(m_segment, record_begin);
+        if (!header_block.has_value()) {
+            throw_invalid_archive("unterminated WARC header at offset " + std::to_string(m_segment_base + record_begin));
+        }
+
+        const std::string_view length_field = header_value(header_block->headers, "Content-Length");
+        size_t                 length       = 0;
+        const auto [end, error] = std::from_chars(length_field.data(), length_field.data() + length_field.size(), length);
+        if (length_field.empty() || error != std::errc{} || end != length_field.data() + length_field.size()) {
+            throw_invalid_archive("missing or invalid Content-Length at offset " + std::to_string(m_segment_base + record_begin));
+        }
+        if (length > m_segment.size() - header_block->body_begin) {
+            throw_invalid_archive("truncated WARC record at offset " + std::to_string(m_segment_base + record_begin));
+        }
+        const std::string_view block = m_segment.substr(header_block->body_begin, length);
+        m_cursor                     = header_block->body_begin + length;
+
+        const std::string_view type         = header_value(header_block->headers, "WARC-Type");
+        const std::string_view content_type = header_value(header_block->headers, "Content-Type");
+        ArchiveRecord          record{
+                     .body       = {},
+                     .target_uri = header_value(header_block->headers, "WARC-Target-URI"),
+                     .charset    = {},
+                     .offset     = m_segment_base + record_begin,
+                     .keep_alive = m_segment_owner,
+        };
+
+        if (equals_ignore_case(type, "resource") && is_html_media_type(content_type)) {
+            record.body    = block;
+            record.charset = charset_parameter(content_type);
+            return record;
+        }
+        if (!equals_ignore_case(type, "response") || !block.starts_with("HTTP/")) {
+            continue;
+        }
+
+        const auto http_block = find_header_block(block, 0);
+        if (!http_block.has_value()) {
+            continue;
+        }
+        const std::string_view http_content_type = header_value(http_block->headers, "Content-Type");
+        if (!is_html_media_type(http_content_type)) {
+            continue;
+        }
+        // 压缩过的负载无法直接作为 HTML 使用
+        if (const auto encoding = header_value(http_block->headers, "Content-Encoding");
+            !encoding.empty() && !equals_ignore_case(encoding, "identity")) {
+            continue;
+        }
+
+        record.body    = block.substr(http_block->body_begin);
+        record.charset = charset_parameter(http_content_type);
+        if (equals_ignore_case(header_value(http_block->headers, "Transfer-Encoding"), "chunked")) {
+            // 分块负载需要还原，还原结果由记录自行持有；target_uri 与 charset 仍指向数据段，一并持有数据段
+            auto decoded = decode_chunked_body(record.body);
+            if (!decoded.has_value()) {
+                continue;
+            }
+            auto holder       = std::make_shared<ChunkedBodyHolder>(m_segment_owner, std::move(*decoded));
+            record.body       = holder->body;
+            record.keep_alive = std::shared_ptr<const void>(holder, holder.get());
+        }
+        return record;
+    }
+}
+
+std::optional<ArchiveRecord> ArchiveReader::next_html_document() {
+    m_cursor = skip_whitespace(m_segment, m_cursor);
+    if (m_cursor >= m_segment.size()) {
+        return std::nullopt;
+    }
+
+    const size_t begin = m_cursor;
+    size_t       end   = m_segment.size();
+    for (size_t pos = m_segment.find("</", begin); pos != std::string_view::npos; pos = m_segment.find("</", pos + 2)) {
+        if (equals_ignore_case(m_segment.substr(pos + 2, 4), "html")) {
+            const size_t close = m_segment.find('>', pos);
+            end                = close == std::string_view::npos ? m_segment.size() : close + 1;
+            break;
+        }
+    }
+    m_cursor = end;
+    return ArchiveRecord{
+        .body       = m_segment.substr(begin, end - begin),
+        .target_uri = {},
+        .charset    = {},
+        .offset     = m_segment_base + begin,
+        .keep_alive = m_segment_owner,
+    };
+}
+
+std::shared_ptr<Document> parse_archive_record(
+    HTMLParser& parser,
+    const ArchiveRecord& record,
+    const Options& options) {
+    if (const auto hint = sniff_html_encoding(record.body, record.charset); hint.canonical_label == "utf-8") {
+        std::string_view body = record.body;
+        if (hint.source == EncodingHintSource::Utf8Bom) {
+            body.remove_prefix(3);
+        }
+        if (is_valid_utf8(body)) {
+            return parser.parse_borrowed(body, record.keep_alive, options);
+        }
+    }
+    return parser.parse_bytes(record.body, options, record.charset);
+}
+
+}  // namespace hps
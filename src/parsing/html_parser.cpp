@@ -3,12 +3,13 @@
 #include "hps/core/document.hpp"
 #include "hps/core/element.hpp"
 #include "hps/utils/encoding.hpp"
+#include "hps/utils/mapped_file.hpp"
 #include "hps/utils/string_utils.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
-#include <fstream>
-#include <iterator>
+#include <optional>
 
 namespace hps {
 namespace {
@@ -62,39 +63,110 @@ namespace {
     return NamespaceKind::Html;
 }
 
-[[nodiscard]] auto normalize_utf8_file_input(const std::string_view raw_bytes) -> std::string {
+[[nodiscard]] auto strip_utf8_bom(std::string_view bytes) noexcept -> std::string_view {
+    if (bytes.starts_with("\xEF\xBB\xBF")) {
+        bytes.remove_prefix(3);
+    }
+    return bytes;
+}
+
+/**
+ * @brief 把文件字节规范化为 UTF-8
+ * @param raw_bytes 原始字节
+ * @param transcode 是否把非 UTF-8 输入按探测到的字符集转码；未探测到字符集时按 WHATWG 默认使用 windows-1252
+ * @return 转换后的内容；输入本身已是合法 UTF-8 时返回 std::nullopt，调用方直接使用 strip_utf8_bom(raw_bytes)
+ * @throws HPSException 输入编码不受支持或 UTF-8 内容非法时抛出 UnsupportedEncoding
+ */
+[[nodiscard]] auto normalize_file_input(const std::string_view raw_bytes, const bool transcode)
+    -> std::optional<std::string> {
     if (raw_bytes.empty()) {
-        return {};
+        return std::nullopt;
     }
 
-    const auto hint = sniff_html_encoding(raw_bytes);
-    if (!hint.has_encoding()) {
-        throw HPSException(
-            ErrorCode::UnsupportedEncoding,
-            "HTML file input must already be UTF-8");
+    auto hint = sniff_html_encoding(raw_bytes);
+    if (hint.canonical_label == "utf-8") {
+        // 探测只检查了有界前缀，文件输入需要完整校验后才能直接引用
+        if (is_valid_utf8(strip_utf8_bom(raw_bytes))) {
+            return std::nullopt;
+        }
+        if (hint.source != EncodingHintSource::Utf8Heuristic) {
+            throw HPSException(
+                ErrorCode::UnsupportedEncoding,
+                "HTML input is not valid UTF-8");
+        }
+        hint = {};
     }
 
-    if (hint.canonical_label != "utf-8") {
-        const std::string detected =
-            hint.detected_label.empty() ? hint.canonical_label : hint.detected_label;
+    const std::string detected =
+        hint.detected_label.empty() ? hint.canonical_label : hint.detected_label;
+    if (!transcode) {
+        if (!hint.has_encoding()) {
+            throw HPSException(
+                ErrorCode::UnsupportedEncoding,
+                "HTML file input must already be UTF-8");
+        }
         throw HPSException(
             ErrorCode::UnsupportedEncoding,
             "HTML file input must already be UTF-8; detected encoding: " + detected);
     }
 
-    auto utf8 = decode_html_bytes_to_utf8(raw_bytes, hint.canonical_label);
+    auto utf8 = decode_html_bytes_to_utf8(raw_bytes, hint.has_encoding() ? hint.canonical_label : "windows-1252");
     if (!utf8.has_value()) {
         throw HPSException(
             ErrorCode::UnsupportedEncoding,
-            "HTML file input is not valid UTF-8");
+            "Unsupported HTML input encoding: " + detected);
     }
-
-    return std::move(*utf8);
+    return utf8;
 }
 
+/**
+ * @brief 解析循环的资源预算检查
+ *
+ * Token 数与 DOM 大小每个 Token 检查一次；取消标志与截止时间每 kCheckInterval 个 Token 检查一次，
+ * 避免在热循环中频繁读取时钟。
+ */
+class ParseBudget {
+  public:
+    explicit ParseBudget(const Options& options)
+        : m_options(options),
+          m_has_deadline(options.parse_timeout.count() > 0),
+          m_deadline(std::chrono::steady_clock::now() + options.parse_timeout) {}
+
+    /**
+     * @return 第一个超出的预算，均未超出时返回 ParseStatus::Complete
+     */
+    [[nodiscard]] auto check(const size_t tokens_seen, const size_t dom_bytes) const noexcept -> ParseStatus {
+        if (tokens_seen > m_options.max_tokens) {
+            return ParseStatus::TokenLimit;
+        }
+        if (dom_bytes > m_options.max_dom_bytes) {
+            return ParseStatus::MemoryLimit;
+        }
+        if (tokens_seen % kCheckInterval == 1) {
+            if (m_options.cancellation.is_cancelled()) {
+                return ParseStatus::Cancelled;
+            }
+            if (m_has_deadline && std::chrono::steady_clock::now() >= m_deadline) {
+                return ParseStatus::Timeout;
+            }
+        }
+        return ParseStatus::Complete;
+    }
+
+  private:
+    static constexpr size_t kCheckInterval = 256;
+
+    const Options&                        m_options;
+    bool                                  m_has_deadline;
+    std::chrono::steady_clock::time_point m_deadline;
+};
+
 }  // namespace
 
 std::shared_ptr<Document> HTMLParser::parse(const std::string_view html, const Options& options) {
+    if (html.size() > options.max_input_bytes) {
+        return reject_input(options);
+    }
     std::string owned_html(html);
     return parse_owned(std::move(owned_html), options);
 }
@@ -107,6 +179,9 @@ std::shared_ptr<Document> HTMLParser::parse_fragment(
     const std::string_view html,
     const std::string_view context_tag,
     const Options& options) {
+    if (html.size() > options.max_input_bytes) {
+        return reject_input(options);
+    }
     std::string owned_html(html);
     return parse_fragment_owned(std::move(owned_html), context_tag, options);
 }
@@ -118,22 +193,39 @@ std::shared_ptr<Document> HTMLParser::parse_fragment(
     return parse_fragment_owned(std::move(html), context_tag, options);
 }
 
+std::shared_ptr<Document> HTMLParser::parse_borrowed(
+    const std::string_view html,
+    std::shared_ptr<const void> keep_alive,
+    const Options& options) {
+    return parse_document(std::make_shared<Document>(html, std::move(keep_alive)), options);
+}
+
 std::shared_ptr<Document> HTMLParser::parse_owned(std::string html, const Options& options) {
-    m_errors.clear();
+    return parse_document(std::make_shared<Document>(std::move(html)), options);
+}
+
+std::shared_ptr<Document> HTMLParser::parse_document(std::shared_ptr<Document> document, const Options& options) {
+    reset_errors(options);
     const auto error_handling = options.error_handling;
 
     if (!options.is_valid()) {
-        m_errors.emplace_back(ErrorCode::InvalidHTML, "Invalid parser options", Location{});
+        add_error(HPSError(ErrorCode::InvalidHTML, "Invalid parser options", Location{}));
         if (error_handling == ErrorHandlingMode::Strict) {
             throw HPSException(ErrorCode::InvalidHTML, "Invalid parser options");
         }
-        return std::make_shared<Document>(std::move(html));
+        return document;
+    }
+    if (document->source_html().size() > options.max_input_bytes) {
+        return reject_input(options);
     }
 
-    auto document = std::make_shared<Document>(std::move(html));
     try {
-        TreeBuilder builder(document, options);
+        const ParseBudget budget(options);
+        TreeBuilder       builder(document, options);
         Tokenizer   tokenizer(document->source_html(), options);
+        const auto  line_index = std::make_shared<LineIndex>(document->source_html());
+        builder.set_line_index(line_index);
+        tokenizer.set_line_index(line_index);
 
         size_t tokens_seen = 0;
         while (true) {
@@ -143,17 +235,8 @@ std::shared_ptr<Document> HTMLParser::parse_owned(std::string html, const Option
             }
 
             ++tokens_seen;
-            if (tokens_seen > options.max_tokens) {
-                m_errors.emplace_back(
-                    ErrorCode::TooManyElements,
-                    "Token limit exceeded",
-                    tokenizer.position());
-                if (error_handling == ErrorHandlingMode::Strict) {
-                    throw HPSException(
-                        ErrorCode::TooManyElements,
-                        "Token limit exceeded",
-                        tokenizer.position());
-                }
+            if (const auto status = budget.check(tokens_seen, builder.dom_bytes()); status != ParseStatus::Complete) {
+                stop_parsing(status, tokenizer.position(), options);
                 break;
             }
 
@@ -167,6 +250,11 @@ std::shared_ptr<Document> HTMLParser::parse_owned(std::string html, const Option
                 }
             }
 
+            // 被丢弃的子树直接在原始输入上跳过，不再逐个产生 Token
+            if (builder.ignored_depth() > 0) {
+                tokenizer.skip_ignored_subtree(builder.ignored_subtree());
+            }
+
             if (token->is_done()) {
                 break;
             }
@@ -178,26 +266,18 @@ std::shared_ptr<Document> HTMLParser::parse_owned(std::string html, const Option
             }
         }
 
-        auto tokenizer_errors = tokenizer.consume_errors();
-        auto builder_errors   = builder.consume_errors();
-        m_errors.reserve(
-            m_errors.size() + tokenizer_errors.size() + builder_errors.size());
-        m_errors.insert(
-            m_errors.end(),
-            std::make_move_iterator(tokenizer_errors.begin()),
-            std::make_move_iterator(tokenizer_errors.end()));
-        m_errors.insert(
-            m_errors.end(),
-            std::make_move_iterator(builder_errors.begin()),
-            std::make_move_iterator(builder_errors.end()));
+        collect_errors(tokenizer, builder, options, line_index);
 
     } catch (const HPSException& e) {
-        m_errors.push_back(e.error());
+        // 预算检查停止解析时已经记录过错误
+        if (m_status == ParseStatus::Complete) {
+            add_error(e.error());
+        }
         if (error_handling == ErrorHandlingMode::Strict) {
             throw;
         }
     } catch (const std::exception& e) {
-        m_errors.emplace_back(ErrorCode::UnknownError, e.what(), Location{});
+        add_error(HPSError(ErrorCode::UnknownError, e.what(), Location{}));
         if (error_handling == ErrorHandlingMode::Strict) {
             throw HPSException(ErrorCode::UnknownError, e.what());
         }
@@ -209,16 +289,19 @@ std::shared_ptr<Document> HTMLParser::parse_fragment_owned(
     std::string html,
     const std::string_view context_tag,
     const Options& options) {
-    m_errors.clear();
+    reset_errors(options);
     const auto error_handling = options.error_handling;
 
     if (!options.is_valid()) {
-        m_errors.emplace_back(ErrorCode::InvalidHTML, "Invalid parser options", Location{});
+        add_error(HPSError(ErrorCode::InvalidHTML, "Invalid parser options", Location{}));
         if (error_handling == ErrorHandlingMode::Strict) {
             throw HPSException(ErrorCode::InvalidHTML, "Invalid parser options");
         }
         return std::make_shared<Document>(std::move(html));
     }
+    if (html.size() > options.max_input_bytes) {
+        return reject_input(options);
+    }
 
     auto working_document = std::make_shared<Document>(std::move(html));
     const std::string normalized_context =
@@ -231,12 +314,16 @@ std::shared_ptr<Document> HTMLParser::parse_fragment_owned(
         auto* fragment_element = const_cast<Element*>(
             working_document->add_child(std::move(fragment_root))->as_element());
 
-        TreeBuilder builder(working_document, options, fragment_element);
+        const ParseBudget budget(options);
+        TreeBuilder       builder(working_document, options, fragment_element);
         Tokenizer   tokenizer(
             working_document->source_html(),
             options,
             fragment_tokenizer_state_for_context(normalized_context),
             normalized_context);
+        const auto line_index = std::make_shared<LineIndex>(working_document->source_html());
+        builder.set_line_index(line_index);
+        tokenizer.set_line_index(line_index);
 
         size_t tokens_seen = 0;
         while (true) {
@@ -246,17 +333,8 @@ std::shared_ptr<Document> HTMLParser::parse_fragment_owned(
             }
 
             ++tokens_seen;
-            if (tokens_seen > options.max_tokens) {
-                m_errors.emplace_back(
-                    ErrorCode::TooManyElements,
-                    "Token limit exceeded",
-                    tokenizer.position());
-                if (error_handling == ErrorHandlingMode::Strict) {
-                    throw HPSException(
-                        ErrorCode::TooManyElements,
-                        "Token limit exceeded",
-                        tokenizer.position());
-                }
+            if (const auto status = budget.check(tokens_seen, builder.dom_bytes()); status != ParseStatus::Complete) {
+                stop_parsing(status, tokenizer.position(), options);
                 break;
             }
 
@@ -270,6 +348,11 @@ std::shared_ptr<Document> HTMLParser::parse_fragment_owned(
                 }
             }
 
+            // 被丢弃的子树直接在原始输入上跳过，不再逐个产生 Token
+            if (builder.ignored_depth() > 0) {
+                tokenizer.skip_ignored_subtree(builder.ignored_subtree());
+            }
+
             if (token->is_done()) {
                 break;
             }
@@ -281,18 +364,7 @@ std::shared_ptr<Document> HTMLParser::parse_fragment_owned(
             }
         }
 
-        auto tokenizer_errors = tokenizer.consume_errors();
-        auto builder_errors   = builder.consume_errors();
-        m_errors.reserve(
-            m_errors.size() + tokenizer_errors.size() + builder_errors.size());
-        m_errors.insert(
-            m_errors.end(),
-            std::make_move_iterator(tokenizer_errors.begin()),
-            std::make_move_iterator(tokenizer_errors.end()));
-        m_errors.insert(
-            m_errors.end(),
-            std::make_move_iterator(builder_errors.begin()),
-            std::make_move_iterator(builder_errors.end()));
+        collect_errors(tokenizer, builder, options, line_index);
 
         auto result_document =
             std::make_shared<Document>(std::string(working_document->source_html()));
@@ -302,12 +374,15 @@ std::shared_ptr<Document> HTMLParser::parse_fragment_owned(
         }
         return result_document;
     } catch (const HPSException& e) {
-        m_errors.push_back(e.error());
+        // 预算检查停止解析时已经记录过错误
+        if (m_status == ParseStatus::Complete) {
+            add_error(e.error());
+        }
         if (error_handling == ErrorHandlingMode::Strict) {
             throw;
         }
     } catch (const std::exception& e) {
-        m_errors.emplace_back(ErrorCode::UnknownError, e.what(), Location{});
+        add_error(HPSError(ErrorCode::UnknownError, e.what(), Location{}));
         if (error_handling == ErrorHandlingMode::Strict) {
             throw HPSException(ErrorCode::UnknownError, e.what());
         }
@@ -318,7 +393,7 @@ std::shared_ptr<Document> HTMLParser::parse_fragment_owned(
 std::shared_ptr<Document> HTMLParser::parse_file(
     const std::string_view filePath,
     const Options& options) {
-    m_errors.clear();
+    reset_errors(options);
     const auto mode = options.error_handling;
     try {
         const std::filesystem::path path(filePath);
@@ -330,39 +405,32 @@ std::shared_ptr<Document> HTMLParser::parse_file(
             throw std::runtime_error("Path is not a regular file: " + path.string());
         }
 
-        std::ifstream file{path, std::ios::in | std::ios::binary};
-        if (!file.is_open()) {
-            throw std::runtime_error("Cannot open file: " + path.string());
-        }
-
-        std::string html_content;
-        {
-            std::error_code ec;
-            const auto      file_size = std::filesystem::file_size(path, ec);
-            if (!ec && file_size > 0) {
-                html_content.reserve(static_cast<size_t>(file_size));
-            }
+        // 文件以只读方式映射；已是 UTF-8 时文档直接引用映射内容并持有映射，源码不做任何复制
+        auto mapping = MappedFile::open_shared(path);
+        // 超出预算的文件在校验或转码之前就拒绝
+        if (mapping->size() > options.max_input_bytes) {
+            return reject_input(options);
         }
-        html_content.assign(
-            std::istreambuf_iterator<char>(file),
-            std::istreambuf_iterator<char>());
-        if (!file.eof() && file.fail()) {
-            throw std::runtime_error("Cannot read file: " + path.string());
+        if (auto decoded = normalize_file_input(mapping->data(), options.transcode_file_input)) {
+            return parse_owned(std::move(*decoded), options);
         }
-        html_content = normalize_utf8_file_input(html_content);
-        return parse_owned(std::move(html_content), options);
+        const std::string_view source = strip_utf8_bom(mapping->data());
+        return parse_document(std::make_shared<Document>(source, std::move(mapping)), options);
 
     } catch (const HPSException& e) {
-        m_errors.push_back(e.error());
+        // 预算检查停止解析时已经记录过错误
+        if (m_status == ParseStatus::Complete) {
+            add_error(e.error());
+        }
         if (mode == ErrorHandlingMode::Strict) {
             throw;
         }
         return std::make_shared<Document>("");
     } catch (const std::exception& e) {
-        m_errors.emplace_back(
+        add_error(HPSError(
             ErrorCode::FileReadError,
             "File read error: " + std::string(e.what()),
-            0);
+            0));
         if (mode == ErrorHandlingMode::Strict) {
             throw HPSException(
                 ErrorCode::FileReadError,
@@ -372,8 +440,159 @@ std::shared_ptr<Document> HTMLParser::parse_file(
     }
 }
 
-const std::vector<HPSError>& HTMLParser::get_errors() const noexcept {
+std::shared_ptr<Document> HTMLParser::parse_bytes(
+    const std::string_view raw_bytes,
+    const Options& options,
+    const std::string_view transport_charset) {
+    reset_errors(options);
+
+    // 只对有界前缀做嗅探，随后一次性解码为文档源码；UTF-8 按块校验并复制，非法序列替换为 U+FFFD
+    const auto             hint  = sniff_html_encoding(raw_bytes, transport_charset);
+    const std::string_view label = hint.has_encoding() ? std::string_view(hint.canonical_label) : "windows-1252";
+
+    // 解码前先按原始字节数拒绝超大输入，避免无谓的解码与复制
+    if (raw_bytes.size() > options.max_input_bytes) {
+        return reject_input(options);
+    }
+
+    std::string html;
+    if (label == "utf-8") {
+        decode_utf8_with_replacement(strip_utf8_bom(raw_bytes), html);
+    } else if (auto decoded = decode_html_bytes_to_utf8(raw_bytes, label)) {
+        html = std::move(*decoded);
+    } else {
+        const std::string detected = hint.detected_label.empty() ? hint.canonical_label : hint.detected_label;
+        const HPSError    error(ErrorCode::UnsupportedEncoding, "Unsupported HTML input encoding: " + detected, 0);
+        add_error(error);
+        if (options.error_handling == ErrorHandlingMode::Strict) {
+            throw HPSException(error);
+        }
+        return std::make_shared<Document>("");
+    }
+    return parse_owned(std::move(html), options);
+}
+
+const std::vector<HPSError>& HTMLParser::get_errors() const {
+    // Compact 模式下只保留了 (错误码, 偏移)，首次读取时才格式化为完整错误
+    if (m_pending_compact_errors) {
+        const auto recent = m_error_summary.recent();
+        m_errors.reserve(m_errors.size() + recent.size());
+        for (const auto& [code, position] : recent) {
+            m_errors.emplace_back(code, std::string(error_code_description(code)), Location::unresolved(position));
+        }
+        m_pending_compact_errors = false;
+    }
+
+    // 延迟定位模式下错误只记录了字节偏移，首次读取时统一补全行列号
+    if (m_pending_locations) {
+        for (auto& error : m_errors) {
+            m_pending_locations->resolve(error.location);
+        }
+        m_pending_locations.reset();
+    }
     return m_errors;
 }
 
+const ErrorSummary& HTMLParser::error_summary() const noexcept {
+    return m_error_summary;
+}
+
+ParseStatus HTMLParser::status() const noexcept {
+    return m_status;
+}
+
+void HTMLParser::reset_errors(const Options& options) {
+    m_status = ParseStatus::Complete;
+    m_errors.clear();
+    m_pending_locations.reset();
+    m_pending_compact_errors = false;
+
+    const size_t ring_capacity =
+        options.error_collection == ErrorCollectionMode::Compact ? options.error_ring_capacity : 0;
+    if (m_error_summary.ring_capacity() == ring_capacity) {
+        m_error_summary.clear();
+    } else {
+        m_error_summary = ErrorSummary(ring_capacity);
+    }
+}
+
+void HTMLParser::stop_parsing(const ParseStatus status, const size_t position, const Options& options) {
+    ErrorCode        code    = ErrorCode::TooManyElements;
+    std::string_view message = "Token limit exceeded";
+    switch (status) {
+        case ParseStatus::Complete:
+            return;
+        case ParseStatus::TokenLimit:
+            break;
+        case ParseStatus::InputTooLarge:
+            code    = ErrorCode::OutOfMemory;
+            message = "Input size limit exceeded";
+            break;
+        case ParseStatus::MemoryLimit:
+            code    = ErrorCode::OutOfMemory;
+            message = "DOM memory limit exceeded";
+            break;
+        case ParseStatus::Timeout:
+            code    = ErrorCode::ParseTimeout;
+            message = "Parse deadline exceeded";
+            break;
+        case ParseStatus::Cancelled:
+            code    = ErrorCode::ParseCancelled;
+            message = "Parse cancelled";
+            break;
+    }
+
+    m_status = status;
+    add_error(HPSError(code, std::string(message), position));
+    if (options.error_handling == ErrorHandlingMode::Strict) {
+        throw HPSException(code, std::string(message), position);
+    }
+}
+
+std::shared_ptr<Document> HTMLParser::reject_input(const Options& options) {
+    reset_errors(options);
+    stop_parsing(ParseStatus::InputTooLarge, 0, options);
+    return std::make_shared<Document>("");
+}
+
+void HTMLParser::add_error(HPSError error) {
+    m_error_summary.count(error.code);
+    m_errors.push_back(std::move(error));
+}
+
+void HTMLParser::defer_locations(const std::shared_ptr<LineIndex>& line_index) {
+    // 只保留行首表，不让解析器在调用方释放文档后继续持有源码
+    line_index->release_source();
+    m_pending_locations = line_index;
+}
+
+void HTMLParser::collect_errors(
+    Tokenizer&                        tokenizer,
+    TreeBuilder&                      builder,
+    const Options&                    options,
+    const std::shared_ptr<LineIndex>& line_index) {
+    if (options.error_collection != ErrorCollectionMode::Full) {
+        m_error_summary.merge(tokenizer.error_summary());
+        m_error_summary.merge(builder.error_summary());
+        if (m_error_summary.ring_capacity() > 0 && m_error_summary.total() > m_errors.size()) {
+            m_pending_compact_errors = true;
+            defer_locations(line_index);
+        }
+        return;
+    }
+
+    auto tokenizer_errors = tokenizer.consume_errors();
+    auto builder_errors   = builder.consume_errors();
+    m_errors.reserve(
+        m_errors.size() + tokenizer_errors.size() + builder_errors.size());
+    for (auto* errors : {&tokenizer_errors, &builder_errors}) {
+        for (auto& error : *errors) {
+            add_error(std::move(error));
+        }
+    }
+    if (options.defer_error_locations && !m_errors.empty()) {
+        defer_locations(line_index);
+    }
+}
+
 }  // namespace hps
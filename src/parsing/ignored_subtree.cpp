@@ -0,0 +1,59 @@
+#include "hps/parsing/ignored_subtree.hpp"
+
+namespace hps {
+
+namespace {
+
+[[nodiscard]] TagId slot_tag_id(const std::uint16_t slot) noexcept {
+    return slot < kTagIdCount ? static_cast<TagId>(slot) : TagId::Unknown;
+}
+
+}  // namespace
+
+void IgnoredSubtree::begin(const std::string_view name, const TagInfo tag) {
+    clear();
+    const size_t slot = open_tag_slot(name, tag);
+    m_open_slots.push_back(static_cast<std::uint16_t>(slot));
+    ++m_open_counts[slot];
+}
+
+IgnoredSubtree::Step IgnoredSubtree::start_tag(const std::string_view name, const TagInfo tag, const bool opens_element) {
+    while (!m_open_slots.empty() && implicitly_closed_by(slot_tag_id(m_open_slots.back()), tag)) {
+        pop();
+    }
+    if (m_open_slots.empty()) {
+        return Step::Finished;
+    }
+    if (opens_element) {
+        const size_t slot = open_tag_slot(name, tag);
+        m_open_slots.push_back(static_cast<std::uint16_t>(slot));
+        ++m_open_counts[slot];
+    }
+    return Step::Continue;
+}
+
+IgnoredSubtree::Step IgnoredSubtree::end_tag(const std::string_view name, const TagInfo tag) noexcept {
+    const size_t slot = open_tag_slot(name, tag);
+    if (m_open_counts[slot] == 0) {
+        return Step::Unmatched;
+    }
+    // 与 TreeBuilder 一致，结束标签关闭匹配元素之上所有未闭合的元素
+    while (m_open_slots.back() != slot) {
+        pop();
+    }
+    pop();
+    return m_open_slots.empty() ? Step::Finished : Step::Continue;
+}
+
+void IgnoredSubtree::clear() noexcept {
+    while (!m_open_slots.empty()) {
+        pop();
+    }
+}
+
+void IgnoredSubtree::pop() noexcept {
+    --m_open_counts[m_open_slots.back()];
+    m_open_slots.pop_back();
+}
+
+}  // namespace hps
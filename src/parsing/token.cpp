@@ -15,9 +15,11 @@ Token::Token(Token&& other) noexcept
       m_doctype_public_id(std::move(other.m_doctype_public_id)),
       m_doctype_system_id(std::move(other.m_doctype_system_id)),
       m_doctype_force_quirks(other.m_doctype_force_quirks),
+      m_has_char_ref(other.m_has_char_ref),
       m_attrs(std::move(other.m_attrs)) {
     other.m_value = {};
     other.m_doctype_force_quirks = false;
+    other.m_has_char_ref         = false;
 }
 
 Token& Token::operator=(Token&& other) noexcept {
@@ -29,9 +31,11 @@ Token& Token::operator=(Token&& other) noexcept {
         m_doctype_public_id    = std::move(other.m_doctype_public_id);
         m_doctype_system_id    = std::move(other.m_doctype_system_id);
         m_doctype_force_quirks = other.m_doctype_force_quirks;
+        m_has_char_ref         = other.m_has_char_ref;
         m_attrs                = std::move(other.m_attrs);
         other.m_value          = {};
         other.m_doctype_force_quirks = false;
+        other.m_has_char_ref         = false;
     }
     return *this;
 }
@@ -63,6 +67,14 @@ bool Token::doctype_force_quirks() const noexcept {
     return m_doctype_force_quirks;
 }
 
+bool Token::has_char_ref() const noexcept {
+    return m_has_char_ref;
+}
+
+void Token::set_has_char_ref(const bool has_char_ref) noexcept {
+    m_has_char_ref = has_char_ref;
+}
+
 void Token::set_owned_value(std::string value) {
     m_value_owned = std::move(value);
 }
@@ -1,27 +1,28 @@
 #include "hps/parsing/tokenizer.hpp"
 
+#include "hps/parsing/ignored_subtree.hpp"
+#include "hps/parsing/tag_table.hpp"
 #include "hps/utils/exception.hpp"
 #include "hps/utils/string_utils.hpp"
 
 namespace {
 
-[[nodiscard]] auto text_parsing_state_for_tag(const std::string_view tag_name) noexcept -> hps::TokenizerState {
-    if (hps::equals_ignore_case(tag_name, "script")) {
-        return hps::TokenizerState::ScriptData;
+[[nodiscard]] auto text_parsing_state_for_tag(const hps::TagId tag) noexcept -> hps::TokenizerState {
+    switch (tag) {
+        case hps::TagId::Script:
+            return hps::TokenizerState::ScriptData;
+        case hps::TagId::Svg:
+        case hps::TagId::Style:
+        case hps::TagId::NoScript:
+            return hps::TokenizerState::RAWTEXT;
+        case hps::TagId::TextArea:
+        case hps::TagId::Title:
+            return hps::TokenizerState::RCDATA;
+        case hps::TagId::PlainText:
+            return hps::TokenizerState::Plaintext;
+        default:
+            return hps::TokenizerState::Data;
     }
-    if (hps::equals_ignore_case(tag_name, "svg")) {
-        return hps::TokenizerState::RAWTEXT;
-    }
-    if (hps::equals_ignore_case(tag_name, "style") || hps::equals_ignore_case(tag_name, "noscript")) {
-        return hps::TokenizerState::RAWTEXT;
-    }
-    if (hps::equals_ignore_case(tag_name, "textarea") || hps::equals_ignore_case(tag_name, "title")) {
-        return hps::TokenizerState::RCDATA;
-    }
-    if (hps::equals_ignore_case(tag_name, "plaintext")) {
-        return hps::TokenizerState::Plaintext;
-    }
-    return hps::TokenizerState::Data;
 }
 
 }  // namespace
@@ -41,6 +42,7 @@ Tokenizer::Tokenizer(
       m_state(initial_state),
       m_options(options),
       m_last_start_tag(last_start_tag),
+      m_error_summary(options.error_collection == ErrorCollectionMode::Compact ? options.error_ring_capacity : 0),
       m_attr_value_start(0) {}
 
 std::optional<Token> Tokenizer::next_token() {
@@ -142,6 +144,139 @@ std::vector<Token> Tokenizer::tokenize_all() {
     return tokens;
 }
 
+bool Tokenizer::skip_ignored_subtree(IgnoredSubtree& subtree) {
+    if (m_state != TokenizerState::Data || subtree.depth() == 0) {
+        return false;
+    }
+
+    const std::string_view source = m_source;
+    const size_t           end    = source.size();
+
+    // 从 from 开始找到标签结束的 '>'，跳过属性值中的引号内容
+    const auto find_tag_end = [&](size_t from) -> size_t {
+        while (from < end) {
+            const char c = source[from];
+            if (c == '>') {
+                return from;
+            }
+            ++from;
+            if (c == '=') {
+                while (from < end && is_whitespace(source[from])) {
+                    ++from;
+                }
+                if (from < end && (source[from] == '"' || source[from] == '\'')) {
+                    const size_t close = source.find(source[from], from + 1);
+                    from               = close == std::string_view::npos ? end : close + 1;
+                }
+            }
+        }
+        return end;
+    };
+    const auto name_end = [&](size_t from) -> size_t {
+        while (from < end && !is_whitespace(source[from]) && source[from] != '/' && source[from] != '>') {
+            ++from;
+        }
+        return from;
+    };
+
+    size_t pos = m_pos;
+    while (subtree.depth() > 0) {
+        const size_t open = source.find('<', pos);
+        if (open == std::string_view::npos || open + 1 >= end) {
+            pos = end;
+            break;
+        }
+        const char next = source[open + 1];
+
+        if (next == '!') {
+            if (source.compare(open + 2, 2, "--") == 0) {
+                const size_t close = source.find("-->", open + 4);
+                pos                = close == std::string_view::npos ? end : close + 3;
+            } else {
+                const size_t close = source.find('>', open + 2);
+                pos                = close == std::string_view::npos ? end : close + 1;
+            }
+            continue;
+        }
+        if (next == '?') {
+            const size_t close = source.find('>', open + 2);
+            pos                = close == std::string_view::npos ? end : close + 1;
+            continue;
+        }
+        if (next == '/' && open + 2 < end && is_alpha(source[open + 2])) {
+            const size_t           close_name_end = name_end(open + 2);
+            const std::string_view close_name     = source.substr(open + 2, close_name_end - open - 2);
+            // 不匹配子树内元素的结束标签交给树构建器判断，词法分析器停在它之前
+            if (subtree.end_tag(close_name, lookup_tag(close_name)) == IgnoredSubtree::Step::Unmatched) {
+                pos = open;
+                break;
+            }
+            pos = find_tag_end(close_name_end);
+            pos = pos < end ? pos + 1 : end;
+            continue;
+        }
+        if (!is_alpha(next)) {
+            pos = open + 1;
+            continue;
+        }
+
+        const size_t           name_stop = name_end(open + 1);
+        const std::string_view name      = source.substr(open + 1, name_stop - open - 1);
+        const size_t           tag_end   = find_tag_end(name_stop);
+        if (tag_end >= end) {
+            pos = end;
+            break;
+        }
+
+        const TagInfo        tag = lookup_tag(name);
+        const bool           is_void =
+            m_options.void_elements.empty() ? tag.is(TagCategory::Void) : m_options.is_void_element(name);
+        const TokenizerState text_state = text_parsing_state_for_tag(tag.id);
+        // 原始文本元素的内容在下面直接跳过，不进入子树的元素栈
+        const bool opens_element = !is_void && source[tag_end - 1] != '/' && text_state == TokenizerState::Data;
+        if (subtree.start_tag(name, tag, opens_element) == IgnoredSubtree::Step::Finished) {
+            // 隐式关闭了子树根元素的开始标签属于子树之外
+            pos = open;
+            break;
+        }
+        pos = tag_end + 1;
+        if (is_void || source[tag_end - 1] == '/') {
+            continue;
+        }
+
+        // 原始文本元素的内容不含标签，直接跳到对应的结束标签
+        switch (text_state) {
+            case TokenizerState::Data:
+                break;
+            case TokenizerState::Plaintext:
+                pos = end;
+                break;
+            default: {
+                size_t search = pos;
+                while (true) {
+                    const size_t close = source.find("</", search);
+                    if (close == std::string_view::npos) {
+                        pos = end;
+                        break;
+                    }
+                    const size_t close_name_end = name_end(close + 2);
+                    if (equals_ignore_case(source.substr(close + 2, close_name_end - close - 2), name)) {
+                        const size_t close_end = find_tag_end(close_name_end);
+                        pos                    = close_end < end ? close_end + 1 : end;
+                        break;
+                    }
+                    search = close + 2;
+                }
+                break;
+            }
+        }
+    }
+
+    m_pos = pos;
+    m_token_builder.reset();
+    return true;
+}
+
 bool Tokenizer::has_more() const noexcept {
     return m_pos < m_source.length();
 }
@@ -162,6 +297,10 @@ std::vector<HPSError> Tokenizer::consume_errors() {
     return std::move(m_errors);
 }
 
+const ErrorSummary& Tokenizer::error_summary() const noexcept {
+    return m_error_summary;
+}
+
 std::optional<Token> Tokenizer::consume_data_state() {
     if (current_char() == '<') {
         advance();
@@ -169,12 +308,18 @@ std::optional<Token> Tokenizer::consume_data_state() {
         return {};
     }
 
-    const size_t start = m_pos;
+    const size_t start        = m_pos;
+    bool         has_char_ref = false;
     while (has_more() && current_char() != '<') {
+        has_char_ref |= current_char() == '&';
         advance();
     }
     if (start < m_pos) {
-        return emit_text_token(m_source.substr(start, m_pos - start));
+        auto token = emit_text_token(m_source.substr(start, m_pos - start));
+        if (token) {
+            token->set_has_char_ref(has_char_ref);
+        }
+        return token;
     }
     return {};
 }
@@ -188,6 +333,19 @@ std::optional<Token> Tokenizer::consume_tag_open_state() {
             for (int i = 0; i < 7 && has_more(); i++) {
                 advance();
             }
+            if (m_options.skip_markup_declarations) {
+                const size_t end = m_source.find("]]", m_pos);
+                if (end == std::string_view::npos) {
+                    m_pos = m_source.size();
+                } else {
+                    m_pos = end + 2;
+                    if (has_more() && current_char() == '>') {
+                        advance();
+                    }
+                }
+                m_state = TokenizerState::Data;
+                return {};
+            }
             std::string cdata_content;
             while (has_more()) {
                 if (starts_with("]]")) {
@@ -246,6 +404,12 @@ std::optional<Token> Tokenizer::consume_tag_name_state() {
         }
     }
 
+    // 树构建器会丢弃的标签不再收集属性
+    if (m_options.has_tag_filters()) {
+        m_token_builder.discard_attrs =
+            m_options.is_pruned_tag(m_token_builder.tag_name) || !m_options.keeps_tag(m_token_builder.tag_name);
+    }
+
     if (is_whitespace(current_char())) {
         skip_whitespace();
         m_state = TokenizerState::BeforeAttributeName;
@@ -356,7 +520,7 @@ std::optional<Token> Tokenizer::consume_attribute_name_state() {
         }
     }
 
-    if (m_pos > start) {
+    if (m_pos > start && !m_token_builder.discard_attrs) {
         const std::string_view raw_name = m_source.substr(start, m_pos - start);
         if (m_options.preserve_case) {
             m_token_builder.attr_name += raw_name;
@@ -432,7 +596,7 @@ std::optional<Token> Tokenizer::consume_before_attribute_value_state() {
     } else if (current_char() == '>') {
         record_error(ErrorCode::InvalidToken, "Missing attribute value");
         if (m_options.error_handling == ErrorHandlingMode::Strict) {
-            throw HPSException(ErrorCode::InvalidToken, "Missing attribute value", Location::from_position(m_source, m_pos));
+            throw HPSException(ErrorCode::InvalidToken, "Missing attribute value", current_location());
         }
         finish_boolean_attribute();
         advance();
@@ -523,7 +687,7 @@ std::optional<Token> Tokenizer::consume_self_closing_start_tag_state() {
         throw HPSException(
             ErrorCode::InvalidToken,
             "Unexpected character after '/' in self-closing start tag",
-            Location::from_position(m_source, m_pos));
+            current_location());
     }
     m_state = TokenizerState::BeforeAttributeName;
     return {};
@@ -534,31 +698,32 @@ std::optional<Token> Tokenizer::consume_comment_state() {
         advance();
         advance();
     }
-    m_char_ref_buffer.clear();
-    while (has_more()) {
-        if (current_char() == '-' && peek_char() == '-') {
-            if (peek_char(2) == '>') {
-                m_pos += 3;
-                m_state              = TokenizerState::Data;
-                auto comment_content = std::move(m_char_ref_buffer);
-                m_char_ref_buffer.clear();
-                return create_owned_comment_token(std::move(comment_content));
-            }
-            m_char_ref_buffer += current_char();
-            advance();
-        } else {
-            m_char_ref_buffer += current_char();
-            advance();
-        }
+    const size_t start = m_pos;
+    const size_t end   = m_source.find("-->", m_pos);
+    m_state            = TokenizerState::Data;
+    if (end == std::string_view::npos) {
+        m_pos = m_source.size();
+        handle_parse_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in comment");
+    } else {
+        m_pos = end + 3;
+    }
+
+    // 注释会被树构建器丢弃时不再复制内容
+    if (m_options.comment_mode == CommentMode::Remove) {
+        return {};
     }
-    handle_parse_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in comment");
-    m_state              = TokenizerState::Data;
-    auto comment_content = std::move(m_char_ref_buffer);
-    m_char_ref_buffer.clear();
-    return create_owned_comment_token(std::move(comment_content));
+    const size_t content_end = end == std::string_view::npos ? m_source.size() : end;
+    return create_owned_comment_token(std::string(m_source.substr(start, content_end - start)));
 }
 
 std::optional<Token> Tokenizer::consume_doctype_state() {
+    if (m_options.skip_markup_declarations) {
+        const size_t end = m_source.find('>', m_pos);
+        m_pos            = end == std::string_view::npos ? m_source.size() : end + 1;
+        m_state          = TokenizerState::Data;
+        return {};
+    }
+
     if (starts_with("DOCTYPE") || starts_with("doctype")) {
         m_pos += 7;
     } else {
@@ -630,7 +795,7 @@ std::optional<Token> Tokenizer::consume_script_data_state() {
                         const std::string_view content = m_source.substr(start, saved_pos - start);
                         record_recoverable_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in script end tag");
                         m_state = TokenizerState::Data;
-                        return emit_text_token(content);
+                        return emit_raw_text_token(content);
                     }
                     record_recoverable_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in script end tag");
                     m_state = TokenizerState::Data;
@@ -642,7 +807,7 @@ std::optional<Token> Tokenizer::consume_script_data_state() {
                 if (start < saved_pos) {
                     m_pos                          = saved_pos;
                     const std::string_view content = m_source.substr(start, saved_pos - start);
-                    return emit_text_token(content);
+                    return emit_raw_text_token(content);
                 }
                 advance();
                 m_state   = TokenizerState::Data;
@@ -659,7 +824,7 @@ std::optional<Token> Tokenizer::consume_script_data_state() {
                         const std::string_view content = m_source.substr(start, saved_pos - start);
                         record_recoverable_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in script end tag");
                         m_state = TokenizerState::Data;
-                        return emit_text_token(content);
+                        return emit_raw_text_token(content);
                     }
                     record_recoverable_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in script end tag");
                     m_state = TokenizerState::Data;
@@ -669,7 +834,7 @@ std::optional<Token> Tokenizer::consume_script_data_state() {
                     if (start < saved_pos) {
                         m_pos                          = saved_pos;
                         const std::string_view content = m_source.substr(start, saved_pos - start);
-                        return emit_text_token(content);
+                        return emit_raw_text_token(content);
                     }
                     advance();
                     m_state   = TokenizerState::Data;
@@ -686,7 +851,7 @@ std::optional<Token> Tokenizer::consume_script_data_state() {
     if (start < m_pos) {
         const std::string_view content = m_source.substr(start, m_pos - start);
         m_state                        = TokenizerState::Data;
-        return emit_text_token(content);
+        return emit_raw_text_token(content);
     }
     handle_parse_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in script data");
     m_state = TokenizerState::Data;
@@ -722,7 +887,7 @@ std::optional<Token> Tokenizer::consume_rawtext_state() {
                         const std::string_view content = m_source.substr(start, saved_pos - start);
                         record_recoverable_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in RAWTEXT end tag");
                         m_state = TokenizerState::Data;
-                        return emit_text_token(content);
+                        return emit_raw_text_token(content);
                     }
                     record_recoverable_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in RAWTEXT end tag");
                     m_state = TokenizerState::Data;
@@ -733,7 +898,7 @@ std::optional<Token> Tokenizer::consume_rawtext_state() {
                 if (start < saved_pos) {
                     m_pos                          = saved_pos;
                     const std::string_view content = m_source.substr(start, saved_pos - start);
-                    return emit_text_token(content);
+                    return emit_raw_text_token(content);
                 }
                 advance();
                 m_state   = TokenizerState::Data;
@@ -750,7 +915,7 @@ std::optional<Token> Tokenizer::consume_rawtext_state() {
                         const std::string_view content = m_source.substr(start, saved_pos - start);
                         record_recoverable_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in RAWTEXT end tag");
                         m_state = TokenizerState::Data;
-                        return emit_text_token(content);
+                        return emit_raw_text_token(content);
                     }
                     record_recoverable_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in RAWTEXT end tag");
                     m_state = TokenizerState::Data;
@@ -760,7 +925,7 @@ std::optional<Token> Tokenizer::consume_rawtext_state() {
                     if (start < saved_pos) {
                         m_pos                          = saved_pos;
                         const std::string_view content = m_source.substr(start, saved_pos - start);
-                        return emit_text_token(content);
+                        return emit_raw_text_token(content);
                     }
                     advance();
                     m_state   = TokenizerState::Data;
@@ -778,7 +943,7 @@ std::optional<Token> Tokenizer::consume_rawtext_state() {
     if (start < m_pos) {
         const std::string_view content = m_source.substr(start, m_pos - start);
         m_state                        = TokenizerState::Data;
-        return emit_text_token(content);
+        return emit_raw_text_token(content);
     }
 
     handle_parse_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in RAWTEXT");
@@ -815,7 +980,7 @@ std::optional<Token> Tokenizer::consume_rcdata_state() {
                         const std::string_view content = m_source.substr(start, saved_pos - start);
                         record_recoverable_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in RCDATA end tag");
                         m_state = TokenizerState::Data;
-                        return emit_owned_text_token(decode_html_entities(std::string(content)));
+                        return emit_owned_text_token(decode_html_entities(content));
                     }
                     record_recoverable_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in RCDATA end tag");
                     m_state = TokenizerState::Data;
@@ -826,7 +991,7 @@ std::optional<Token> Tokenizer::consume_rcdata_state() {
                 if (start < saved_pos) {
                     m_pos                          = saved_pos;
                     const std::string_view content = m_source.substr(start, saved_pos - start);
-                    return emit_owned_text_token(decode_html_entities(std::string(content)));
+                    return emit_owned_text_token(decode_html_entities(content));
                 }
                 advance();
                 m_state   = TokenizerState::Data;
@@ -843,7 +1008,7 @@ std::optional<Token> Tokenizer::consume_rcdata_state() {
                         const std::string_view content = m_source.substr(start, saved_pos - start);
                         record_recoverable_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in RCDATA end tag");
                         m_state = TokenizerState::Data;
-                        return emit_owned_text_token(decode_html_entities(std::string(content)));
+                        return emit_owned_text_token(decode_html_entities(content));
                     }
                     record_recoverable_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in RCDATA end tag");
                     m_state = TokenizerState::Data;
@@ -853,7 +1018,7 @@ std::optional<Token> Tokenizer::consume_rcdata_state() {
                     if (start < saved_pos) {
                         m_pos                          = saved_pos;
                         const std::string_view content = m_source.substr(start, saved_pos - start);
-                        return emit_owned_text_token(decode_html_entities(std::string(content)));
+                        return emit_owned_text_token(decode_html_entities(content));
                     }
                     advance();
                     m_state   = TokenizerState::Data;
@@ -871,7 +1036,7 @@ std::optional<Token> Tokenizer::consume_rcdata_state() {
     if (start < m_pos) {
         const std::string_view content = m_source.substr(start, m_pos - start);
         m_state                        = TokenizerState::Data;
-        return emit_owned_text_token(decode_html_entities(std::string(content)));
+        return emit_owned_text_token(decode_html_entities(content));
     }
 
     handle_parse_error(ErrorCode::UnexpectedEOF, "Unexpected EOF in RCDATA");
@@ -944,11 +1109,14 @@ Token Tokenizer::create_start_tag_token() {
         token.add_attr(std::move(attr));
     }
 
-    if (m_options.is_void_element(m_token_builder.tag_name)) {
+    const TagInfo tag = lookup_tag(m_token_builder.tag_name);
+    const bool    is_void =
+        m_options.void_elements.empty() ? tag.is(TagCategory::Void) : m_options.is_void_element(m_token_builder.tag_name);
+    if (is_void) {
         token.set_type(TokenType::CLOSE_SELF);
     }
 
-    const auto next_state = text_parsing_state_for_tag(m_token_builder.tag_name);
+    const auto next_state = text_parsing_state_for_tag(tag.id);
     m_last_start_tag      = m_token_builder.tag_name;
     if (token.type() == TokenType::OPEN && next_state != TokenizerState::Data) {
         m_state = next_state;
@@ -985,7 +1153,7 @@ std::optional<Token> Tokenizer::emit_text_token(std::string_view data) {
             throw HPSException(
                 ErrorCode::TextTooLong,
                 "Text node length limit exceeded",
-                Location::from_position(m_source, m_pos));
+                current_location());
         }
         data = data.substr(0, m_options.max_text_length);
     }
@@ -993,6 +1161,16 @@ std::optional<Token> Tokenizer::emit_text_token(std::string_view data) {
     return create_text_token(data);
 }
 
+std::optional<Token> Tokenizer::emit_raw_text_token(const std::string_view data) {
+    if (m_options.skip_script_style_content) {
+        const TagId tag = lookup_tag(m_last_start_tag).id;
+        if (tag == TagId::Script || tag == TagId::Style) {
+            return {};
+        }
+    }
+    return emit_text_token(data);
+}
+
 std::optional<Token> Tokenizer::emit_owned_text_token(std::string data) {
     if (data.empty()) {
         return {};
@@ -1004,7 +1182,7 @@ std::optional<Token> Tokenizer::emit_owned_text_token(std::string data) {
             throw HPSException(
                 ErrorCode::TextTooLong,
                 "Text node length limit exceeded",
-                Location::from_position(m_source, m_pos));
+                current_location());
         }
         data.resize(m_options.max_text_length);
     }
@@ -1043,12 +1221,12 @@ Token Tokenizer::create_done_token() {
     return {TokenType::DONE, "", ""};
 }
 
-void Tokenizer::handle_parse_error(const ErrorCode code, const std::string& message) {
+void Tokenizer::handle_parse_error(const ErrorCode code, const std::string_view message) {
     record_error(code, message);
 
     switch (m_options.error_handling) {
         case ErrorHandlingMode::Strict:
-            throw HPSException(code, message, Location::from_position(m_source, m_pos));
+            throw HPSException(code, std::string(message), current_location());
         case ErrorHandlingMode::Lenient:
             transition_to_data_state();
             break;
@@ -1057,15 +1235,33 @@ void Tokenizer::handle_parse_error(const ErrorCode code, const std::string& mess
     }
 }
 
-void Tokenizer::record_recoverable_error(const ErrorCode code, const std::string& message) {
+void Tokenizer::record_recoverable_error(const ErrorCode code, const std::string_view message) {
     record_error(code, message);
     if (m_options.error_handling == ErrorHandlingMode::Strict) {
-        throw HPSException(code, message, Location::from_position(m_source, m_pos));
+        throw HPSException(code, std::string(message), current_location());
     }
 }
 
-void Tokenizer::record_error(ErrorCode code, const std::string& message) {
-    m_errors.emplace_back(code, message, Location::from_position(m_source, m_pos));
+void Tokenizer::record_error(const ErrorCode code, const std::string_view message) {
+    if (m_options.error_collection != ErrorCollectionMode::Full) {
+        m_error_summary.record(code, m_pos);
+        return;
+    }
+    m_errors.emplace_back(
+        code,
+        std::string(message),
+        m_options.defer_error_locations ? Location::unresolved(m_pos) : current_location());
+}
+
+Location Tokenizer::current_location() {
+    if (!m_line_index) {
+        m_line_index = std::make_shared<LineIndex>(m_source);
+    }
+    return m_line_index->locate(m_pos);
+}
+
+void Tokenizer::set_line_index(std::shared_ptr<const LineIndex> line_index) {
+    m_line_index = std::move(line_index);
 }
 
 void Tokenizer::transition_to_data_state() {
@@ -1078,13 +1274,18 @@ void Tokenizer::finish_boolean_attribute() {
         return;
     }
 
+    if (!m_options.attribute_allow_list.empty() && !m_options.attribute_allow_list.contains(m_token_builder.attr_name)) {
+        m_token_builder.attr_name.clear();
+        return;
+    }
+
     if (m_token_builder.attrs.size() >= m_options.max_attributes) {
         record_error(ErrorCode::TooManyAttributes, "Attribute count limit exceeded");
         if (m_options.error_handling == ErrorHandlingMode::Strict) {
             throw HPSException(
                 ErrorCode::TooManyAttributes,
                 "Attribute count limit exceeded",
-                Location::from_position(m_source, m_pos));
+                current_location());
         }
         m_token_builder.attr_name.clear();
         return;
@@ -1096,7 +1297,7 @@ void Tokenizer::finish_boolean_attribute() {
             throw HPSException(
                 ErrorCode::AttributeTooLong,
                 "Attribute name length limit exceeded",
-                Location::from_position(m_source, m_pos));
+                current_location());
         }
         m_token_builder.attr_name.clear();
         return;
@@ -1111,13 +1312,18 @@ void Tokenizer::finish_attribute(const std::string_view value) {
         return;
     }
 
+    if (!m_options.attribute_allow_list.empty() && !m_options.attribute_allow_list.contains(m_token_builder.attr_name)) {
+        m_token_builder.attr_name.clear();
+        return;
+    }
+
     if (m_token_builder.attrs.size() >= m_options.max_attributes) {
         record_error(ErrorCode::TooManyAttributes, "Attribute count limit exceeded");
         if (m_options.error_handling == ErrorHandlingMode::Strict) {
             throw HPSException(
                 ErrorCode::TooManyAttributes,
                 "Attribute count limit exceeded",
-                Location::from_position(m_source, m_pos));
+                current_location());
         }
         m_token_builder.attr_name.clear();
         return;
@@ -1129,7 +1335,7 @@ void Tokenizer::finish_attribute(const std::string_view value) {
             throw HPSException(
                 ErrorCode::AttributeTooLong,
                 "Attribute name length limit exceeded",
-                Location::from_position(m_source, m_pos));
+                current_location());
         }
         m_token_builder.attr_name.clear();
         return;
@@ -1142,12 +1348,13 @@ void Tokenizer::finish_attribute(const std::string_view value) {
             throw HPSException(
                 ErrorCode::AttributeTooLong,
                 "Attribute value length limit exceeded",
-                Location::from_position(m_source, m_pos));
+                current_location());
         }
         stored_value = stored_value.substr(0, m_options.max_attribute_value_length);
     }
 
-    m_token_builder.add_attr(std::move(m_token_builder.attr_name), stored_value, true);
+    const bool has_char_ref = stored_value.find('&') != std::string_view::npos;
+    m_token_builder.add_attr(std::move(m_token_builder.attr_name), stored_value, true, has_char_ref);
     m_token_builder.attr_name.clear();
 }
 
@@ -9,16 +9,11 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
-#include <ranges>
 
 namespace hps {
 
 namespace {
 
-[[nodiscard]] constexpr auto sorted_string_view_array(auto array) {
-    return array;
-}
-
 [[nodiscard]] auto clone_element_shallow(const Element& source) -> std::unique_ptr<Element> {
     auto clone = std::make_unique<Element>(source.tag_name(), source.namespace_kind());
     for (const auto& attribute : source.attributes()) {
@@ -31,10 +26,14 @@ namespace {
 
 TreeBuilder::TreeBuilder(const std::shared_ptr<Document>& document, const Options& options)
     : m_document(document),
-      m_options(options) {
+      m_options(options),
+      m_error_summary(options.error_collection == ErrorCollectionMode::Compact ? options.error_ring_capacity : 0) {
     assert(m_document != nullptr);
+    if (m_options.build_query_indexes) {
+        m_document->enable_incremental_query_indexes();
+    }
     m_element_stack.reserve(32);
-    m_ignored_element_stack.reserve(8);
+    m_element_links.reserve(32);
 }
 
 TreeBuilder::TreeBuilder(
@@ -53,26 +52,14 @@ bool TreeBuilder::process_token(const Token& token, const size_t position) {
     m_last_position = position;
 
     try {
-        if (!m_ignored_element_stack.empty()) {
-            switch (token.type()) {
-                case TokenType::OPEN:
-                case TokenType::CLOSE_SELF:
-                    if (!m_options.is_void_element(token.name()) && token.type() != TokenType::CLOSE_SELF) {
-                        m_ignored_element_stack.emplace_back(token.name());
-                    }
-                    return true;
-                case TokenType::CLOSE:
-                    if (token.name() == m_ignored_element_stack.back()) {
-                        m_ignored_element_stack.pop_back();
-                    }
-                    return true;
-                case TokenType::TEXT:
-                case TokenType::COMMENT:
-                case TokenType::DONE:
-                case TokenType::FORCE_QUIRKS:
-                case TokenType::DOCTYPE:
-                    return true;
-            }
+        // 超过深度限制或被剪除的子树整体丢弃；通过 HTMLParser 解析时词法分析器会直接跳过这段输入
+        if (m_ignored_subtree.depth() > 0 && process_ignored_token(token)) {
+            return true;
+        }
+
+        if (m_options.has_tag_filters() && (token.is_open() || token.is_close_self() || token.is_close()) &&
+            filter_tag_token(token)) {
+            return true;
         }
 
         switch (token.type()) {
@@ -109,15 +96,62 @@ bool TreeBuilder::process_token(const Token& token, const size_t position) {
 bool TreeBuilder::finish() {
     while (m_element_stack.size() > m_stack_floor) {
         const auto element = m_element_stack.back();
-        m_element_stack.pop_back();
+        pop_element();
         if (!can_omit_end_tag_at_eof(element->tag_name())) {
-            parse_error(ErrorCode::UnclosedTag, "Unclosed tag: " + std::string(element->tag_name()), m_last_position);
+            parse_error(ErrorCode::UnclosedTag, "Unclosed tag: ", element->tag_name(), m_last_position);
         }
     }
 
     return true;
 }
 
+size_t TreeBuilder::ignored_depth() const noexcept {
+    return m_ignored_subtree.depth();
+}
+
+IgnoredSubtree& TreeBuilder::ignored_subtree() noexcept {
+    return m_ignored_subtree;
+}
+
+void TreeBuilder::begin_ignored_subtree(const std::string_view tag_name, const TagInfo tag) {
+    m_ignored_subtree.begin(tag_name, tag);
+}
+
+bool TreeBuilder::process_ignored_token(const Token& token) {
+    if (!token.is_open() && !token.is_close_self() && !token.is_close()) {
+        return true;
+    }
+    const std::string_view name = token.name();
+    const TagInfo          tag  = lookup_tag(name);
+    if (token.is_close()) {
+        const auto step = m_ignored_subtree.end_tag(name, tag);
+        // 子树外已打开元素的结束标签（如被剪除的 <li> 遇到 </ul>）结束子树并按正常流程关闭该元素，
+        // 其余不匹配的结束标签是错位标签，直接丢弃
+        if (step != IgnoredSubtree::Step::Unmatched || find_open_position(name, false) == 0) {
+            return true;
+        }
+        m_ignored_subtree.clear();
+        return false;
+    }
+    const bool opens_element = token.type() == TokenType::OPEN && !is_void_element(name, tag);
+    return m_ignored_subtree.start_tag(name, tag, opens_element) != IgnoredSubtree::Step::Finished;
+}
+
+bool TreeBuilder::filter_tag_token(const Token& token) {
+    const std::string_view name = token.name();
+    if (m_options.is_pruned_tag(name)) {
+        if (const TagInfo tag = lookup_tag(name); token.type() == TokenType::OPEN && !is_void_element(name, tag)) {
+            begin_ignored_subtree(name, tag);
+        }
+        return true;
+    }
+    return !m_options.keeps_tag(name);
+}
+
+size_t TreeBuilder::dom_bytes() const noexcept {
+    return m_dom_bytes;
+}
+
 const std::vector<HPSError>& TreeBuilder::errors() const noexcept {
     return m_errors;
 }
@@ -126,22 +160,29 @@ std::vector<HPSError> TreeBuilder::consume_errors() {
     return std::move(m_errors);
 }
 
+const ErrorSummary& TreeBuilder::error_summary() const noexcept {
+    return m_error_summary;
+}
+
 void TreeBuilder::process_start_tag(const Token& token) {
+    // 每个开始标签只查一次标签表，之后的分派都基于编号与类别位
+    const TagInfo tag = lookup_tag(token.name());
     if (m_fragment_context == nullptr) {
-        if (equals_ignore_case(token.name(), "html")) {
-            process_html_start_tag(token);
-            return;
-        }
-        if (equals_ignore_case(token.name(), "head")) {
-            process_head_start_tag(token);
-            return;
-        }
-        if (equals_ignore_case(token.name(), "body")) {
-            process_body_start_tag(token);
-            return;
+        switch (tag.id) {
+            case TagId::Html:
+                process_html_start_tag(token);
+                return;
+            case TagId::Head:
+                process_head_start_tag(token);
+                return;
+            case TagId::Body:
+                process_body_start_tag(token);
+                return;
+            default:
+                break;
         }
 
-        if (is_head_content_tag(token.name()) && m_body_element == nullptr) {
+        if (tag.is(TagCategory::HeadContent) && m_body_element == nullptr) {
             ensure_head_element();
         } else {
             if (current_element() == m_head_element && !m_head_closed) {
@@ -152,12 +193,12 @@ void TreeBuilder::process_start_tag(const Token& token) {
     } else {
     }
 
-    if (equals_ignore_case(token.name(), "form") &&
+    if (tag.id == TagId::Form &&
         find_open_element("form", false) != nullptr) {
         parse_error(ErrorCode::InvalidNesting, "Unexpected nested <form>", m_last_position);
         return;
     }
-    if (equals_ignore_case(token.name(), "a") &&
+    if (tag.id == TagId::A &&
         find_open_element("a", false) != nullptr) {
         parse_error(ErrorCode::InvalidNesting, "Unexpected nested <a>", m_last_position);
         if (!try_recover_formatting_end_tag("a")) {
@@ -165,31 +206,31 @@ void TreeBuilder::process_start_tag(const Token& token) {
         }
     }
 
-    if (!equals_ignore_case(token.name(), "col")) {
+    if (tag.id != TagId::Col) {
         close_colgroup_for_non_col_token();
     }
 
-    const bool foster_parent_element = should_foster_parent_element(token.name());
-    check_implicit_close(token.name());
+    const bool foster_parent_element = should_foster_parent_element(tag);
+    check_implicit_close(tag);
     if (!foster_parent_element) {
-        prepare_table_context_for_start_tag(token.name());
+        prepare_table_context_for_start_tag(tag);
     }
-    prepare_select_context_for_start_tag(token.name());
+    prepare_select_context_for_start_tag(tag);
 
-    const size_t content_depth =
-        static_cast<size_t>(std::ranges::count_if(m_element_stack, [this](const Element* element) {
-            return element != m_html_element && element != m_head_element && element != m_body_element;
-        }));
+    // html/head/body 各自至多入栈一次，不计入嵌套深度
+    const size_t content_depth = m_element_stack.size() - static_cast<size_t>(is_on_stack(m_html_element)) -
+                                 static_cast<size_t>(is_on_stack(m_head_element)) -
+                                 static_cast<size_t>(is_on_stack(m_body_element));
     const size_t next_depth = content_depth + 1;
     if (next_depth > m_options.max_depth) {
-        parse_error(ErrorCode::TooDeep, "Nesting depth limit exceeded at <" + std::string(token.name()) + ">", m_last_position);
-        if (!m_options.is_void_element(token.name()) && token.type() != TokenType::CLOSE_SELF) {
-            m_ignored_element_stack.emplace_back(token.name());
+        parse_error(ErrorCode::TooDeep, "Nesting depth limit exceeded at: ", token.name(), m_last_position);
+        if (token.type() != TokenType::CLOSE_SELF && !is_void_element(token.name(), tag)) {
+            begin_ignored_subtree(token.name(), tag);
         }
         return;
     }
 
-    if (token.name() == "br") {
+    if (tag.id == TagId::Br) {
         if (m_options.br_handling == BRHandling::InsertNewline) {
             if (foster_parent_element) {
                 const auto [parent, before] = foster_parent_insertion_point();
@@ -207,7 +248,7 @@ void TreeBuilder::process_start_tag(const Token& token) {
         }
     }
 
-    auto element = create_element(token, namespace_for_start_tag(token.name()));
+    auto element = create_element(token, namespace_for_start_tag(tag));
     Element* element_ptr = element.get();
     if (foster_parent_element) {
         const auto [parent, before] = foster_parent_insertion_point();
@@ -216,8 +257,8 @@ void TreeBuilder::process_start_tag(const Token& token) {
         insert_element(std::move(element));
     }
 
-    if (!m_options.is_void_element(std::string(token.name())) && token.type() != TokenType::CLOSE_SELF) {
-        push_element(element_ptr);
+    if (token.type() != TokenType::CLOSE_SELF && !is_void_element(token.name(), tag)) {
+        push_element(element_ptr, tag);
     }
 }
 
@@ -276,13 +317,14 @@ void TreeBuilder::process_body_start_tag(const Token& token) {
 }
 
 void TreeBuilder::process_end_tag(const Token& token) {
-    std::string_view tag_name = token.name();
+    const std::string_view tag_name = token.name();
+    const TagInfo          tag      = lookup_tag(tag_name);
 
-    if (m_fragment_context == nullptr && equals_ignore_case(tag_name, "head")) {
+    if (m_fragment_context == nullptr && tag.id == TagId::Head) {
         close_head_element_if_open();
         return;
     }
-    if (m_fragment_context == nullptr && equals_ignore_case(tag_name, "body")) {
+    if (m_fragment_context == nullptr && tag.id == TagId::Body) {
         close_head_element_if_open();
         if (!m_body_element) {
             return;
@@ -292,7 +334,7 @@ void TreeBuilder::process_end_tag(const Token& token) {
         }
         return;
     }
-    if (m_fragment_context == nullptr && equals_ignore_case(tag_name, "html")) {
+    if (m_fragment_context == nullptr && tag.id == TagId::Html) {
         close_head_element_if_open();
         if (m_body_element && is_on_stack(m_body_element)) {
             close_elements_until("body", false);
@@ -303,28 +345,28 @@ void TreeBuilder::process_end_tag(const Token& token) {
         return;
     }
 
-    if (handle_table_end_tag(tag_name)) {
+    if (tag.is(TagCategory::TableStructure) && handle_table_end_tag(tag_name, tag)) {
         return;
     }
-    if (handle_select_end_tag(tag_name)) {
+    if (handle_select_end_tag(tag)) {
         return;
     }
 
-    if (m_options.is_void_element(std::string(token.name()))) {
+    if (is_void_element(tag_name, tag)) {
         return;
     }
 
     if (m_element_stack.empty()) {
-        parse_error(ErrorCode::MismatchedTag, "No matching opening tag for: " + std::string(tag_name));
+        parse_error(ErrorCode::MismatchedTag, "No matching opening tag for: ", tag_name);
         return;
     }
-    if (try_recover_formatting_end_tag(tag_name)) {
+    if (tag.is(TagCategory::Formatting) && try_recover_formatting_end_tag(tag_name)) {
         return;
     }
     if (find_open_element(tag_name, false) != nullptr) {
         close_elements_until(tag_name);
     } else {
-        parse_error(ErrorCode::MismatchedTag, "No matching opening tag for: " + std::string(tag_name));
+        parse_error(ErrorCode::MismatchedTag, "No matching opening tag for: ", tag_name);
     }
 }
 
@@ -346,33 +388,51 @@ void TreeBuilder::process_text(const Token& token) {
         ensure_body_element();
     }
 
-    std::string processed_text(text);
-
-    switch (m_options.text_processing_mode) {
-        case TextProcessingMode::Raw:
-            break;
-        case TextProcessingMode::Decode:
-            processed_text = decode_html_entities(processed_text);
-            break;
-    }
-
-    if (m_options.decode_entities && m_options.text_processing_mode == TextProcessingMode::Raw) {
-        processed_text = decode_html_entities(processed_text);
-    }
+    // 只有词法分析器见到 '&' 的文本才需要解码；惰性解码只在保留空白时生效，
+    // 因为标准化或裁剪空白必须作用于解码后的文本
+    const bool decode = token.has_char_ref() && decodes_entities();
+    const bool lazy   = decode && m_options.text_processing_mode == TextProcessingMode::LazyDecode &&
+                      m_options.whitespace_mode == WhitespaceMode::Preserve;
 
-    std::string final_text;
+    // 解码与空白处理写入复用的 m_text_buffer；无需改写的文本直接引用词法单元，不产生分配
+    std::string_view final_text = text;
     switch (m_options.whitespace_mode) {
         case WhitespaceMode::Preserve:
-            final_text = processed_text;
+            if (decode && !lazy) {
+                m_text_buffer.clear();
+                decode_html_entities(text, m_text_buffer);
+                final_text = m_text_buffer;
+            }
             break;
         case WhitespaceMode::Normalize:
-            final_text = normalize_whitespace(processed_text);
+            if (decode) {
+                m_text_buffer.clear();
+                decode_html_entities_normalized(text, m_text_buffer);
+                final_text = m_text_buffer;
+            } else if (!is_normalized_whitespace(text)) {
+                m_text_buffer.clear();
+                append_normalized_whitespace(text, m_text_buffer);
+                final_text = m_text_buffer;
+            }
             break;
         case WhitespaceMode::Trim:
-            final_text = std::string(trim_whitespace(processed_text));
+            if (decode) {
+                m_text_buffer.clear();
+                decode_html_entities(text, m_text_buffer);
+                final_text = m_text_buffer;
+            }
+            final_text = trim_whitespace(final_text);
             break;
         case WhitespaceMode::Remove:
-            return;
+            if (is_all_whitespace(text)) {
+                return;
+            }
+            if (decode) {
+                m_text_buffer.clear();
+                decode_html_entities(text, m_text_buffer);
+                final_text = m_text_buffer;
+            }
+            break;
     }
 
     if (final_text.empty()) {
@@ -381,11 +441,15 @@ void TreeBuilder::process_text(const Token& token) {
 
     if (should_foster_parent_text() && !is_all_whitespace(final_text)) {
         const auto [parent, before] = foster_parent_insertion_point();
-        insert_text_before(final_text, parent, before);
+        insert_text_before(final_text, parent, before, lazy);
         return;
     }
 
-    insert_text(final_text);
+    insert_text(final_text, lazy);
+}
+
+bool TreeBuilder::decodes_entities() const noexcept {
+    return m_options.decode_entities || m_options.text_processing_mode != TextProcessingMode::Raw;
 }
 
 void TreeBuilder::process_comment(const Token& token) const {
@@ -404,21 +468,35 @@ void TreeBuilder::process_comment(const Token& token) const {
     }
 }
 
-std::unique_ptr<Element> TreeBuilder::create_element(const Token& token) {
+std::unique_ptr<Element> TreeBuilder::create_element(const Token& token) const {
     return create_element(token, NamespaceKind::Html);
 }
 
 std::unique_ptr<Element> TreeBuilder::create_element(
     const Token& token,
-    const NamespaceKind namespace_kind) {
+    const NamespaceKind namespace_kind) const {
     auto element = std::make_unique<Element>(token.name(), namespace_kind);
     merge_token_attributes(*element, token);
+    m_dom_bytes += sizeof(Element) + token.name().size();
+    for (const auto& attr : token.attrs()) {
+        m_dom_bytes += sizeof(Attribute) + attr.name.size() + attr.value.size();
+    }
     return element;
 }
 
-void TreeBuilder::merge_token_attributes(Element& element, const Token& token) {
+void TreeBuilder::merge_token_attributes(Element& element, const Token& token) const {
+    const bool lazy = m_options.text_processing_mode == TextProcessingMode::LazyDecode;
     for (const auto& attr : token.attrs()) {
-        element.add_attribute(attr.name, attr.value, attr.has_value);
+        if (!attr.has_char_ref || !decodes_entities()) {
+            element.add_attribute(attr.name, attr.value, attr.has_value);
+        } else if (lazy) {
+            element.add_attribute(attr.name, attr.value, attr.has_value, true);
+        } else {
+            std::string decoded;
+            decoded.reserve(attr.value.size());
+            decode_html_entities(attr.value, decoded, true);
+            element.add_attribute(attr.name, decoded, attr.has_value);
+        }
     }
 }
 
@@ -464,7 +542,7 @@ Node* TreeBuilder::insert_node_before(
     return nullptr;
 }
 
-void TreeBuilder::insert_text(std::string_view text) const {
+void TreeBuilder::insert_text(std::string_view text, const bool needs_decode) const {
     if (text.empty()) {
         return;
     }
@@ -479,13 +557,15 @@ void TreeBuilder::insert_text(std::string_view text) const {
     if (parent) {
         if (Node* last = parent->last_child_mut()) {
             if (last->type() == NodeType::Text) {
-                dynamic_cast<TextNode*>(last)->append_text(text);
+                dynamic_cast<TextNode*>(last)->append_text(text, needs_decode);
+                m_dom_bytes += text.size();
                 return;
             }
         }
     }
 
-    auto text_node = std::make_unique<TextNode>(text);
+    auto text_node = std::make_unique<TextNode>(text, needs_decode);
+    m_dom_bytes += sizeof(TextNode) + text.size();
     if (m_element_stack.empty()) {
         m_document->add_child(std::move(text_node));
     } else {
@@ -497,7 +577,8 @@ void TreeBuilder::insert_text(std::string_view text) const {
 void TreeBuilder::insert_text_before(
     std::string_view text,
     Node* parent,
-    const Node* before) const {
+    const Node* before,
+    const bool needs_decode) const {
     if (text.empty() || parent == nullptr) {
         return;
     }
@@ -510,16 +591,19 @@ void TreeBuilder::insert_text_before(
     }
 
     if (previous != nullptr && previous->type() == NodeType::Text) {
-        dynamic_cast<TextNode*>(previous)->append_text(text);
+        dynamic_cast<TextNode*>(previous)->append_text(text, needs_decode);
+        m_dom_bytes += text.size();
         return;
     }
 
-    auto text_node = std::make_unique<TextNode>(text);
+    auto text_node = std::make_unique<TextNode>(text, needs_decode);
+    m_dom_bytes += sizeof(TextNode) + text.size();
     insert_node_before(std::move(text_node), parent, before);
 }
 
 void TreeBuilder::insert_comment(std::string_view comment) const {
     auto comment_node = std::make_unique<CommentNode>(comment);
+    m_dom_bytes += sizeof(CommentNode) + comment.size();
     if (m_element_stack.empty()) {
         m_document->add_child(std::move(comment_node));
     } else {
@@ -529,7 +613,21 @@ void TreeBuilder::insert_comment(std::string_view comment) const {
 }
 
 void TreeBuilder::push_element(Element* element) {
+    push_element(element, lookup_tag(element->tag_name()));
+}
+
+void TreeBuilder::push_element(Element* element, const TagInfo tag) {
+    const size_t slot = open_tag_slot(element->tag_name(), tag);
+    m_element_links.push_back(OpenElementLink{tag, static_cast<std::uint16_t>(slot), m_topmost_open[slot]});
     m_element_stack.push_back(element);
+    m_topmost_open[slot] = static_cast<std::uint32_t>(m_element_stack.size());
+}
+
+void TreeBuilder::pop_element() noexcept {
+    const OpenElementLink& link = m_element_links.back();
+    m_topmost_open[link.slot]   = link.previous;
+    m_element_links.pop_back();
+    m_element_stack.pop_back();
 }
 
 void TreeBuilder::push_if_absent(Element* element) {
@@ -546,68 +644,78 @@ Element* TreeBuilder::current_element() const {
     return m_element_stack.back();
 }
 
+TagInfo TreeBuilder::current_tag() const noexcept {
+    return m_element_links.empty() ? TagInfo{} : m_element_links.back().tag;
+}
+
 bool TreeBuilder::is_on_stack(const Element* element) const noexcept {
-    return element != nullptr &&
-           std::ranges::find(m_element_stack, element) != m_element_stack.end();
+    if (element == nullptr) {
+        return false;
+    }
+    const std::string_view tag_name = element->tag_name();
+    for (std::uint32_t position = m_topmost_open[open_tag_slot(tag_name, lookup_tag(tag_name))]; position != 0;
+         position               = m_element_links[position - 1].previous) {
+        if (m_element_stack[position - 1] == element) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void TreeBuilder::close_elements_until(const std::string_view tag_name, const bool report_auto_close_errors) {
     while (m_element_stack.size() > m_stack_floor) {
         const auto element = m_element_stack.back();
-        m_element_stack.pop_back();
+        pop_element();
         if (equals_ignore_case(element->tag_name(), tag_name)) {
             break;
         }
         if (report_auto_close_errors && !can_omit_end_tag_at_eof(element->tag_name())) {
-            parse_error(ErrorCode::MismatchedTag, "Auto-closing unclosed tag: " + std::string(element->tag_name()));
+            parse_error(ErrorCode::MismatchedTag, "Auto-closing unclosed tag: ", element->tag_name());
         }
     }
 }
 
-void TreeBuilder::parse_error(const ErrorCode code, const std::string& message, const size_t position) {
-    const auto location = Location::from_position(m_document->source_html(), position);
-    m_errors.emplace_back(code, message, location);
-    if (m_options.error_handling == ErrorHandlingMode::Strict) {
-        throw HPSException(code, message, location);
+void TreeBuilder::parse_error(const ErrorCode code, const std::string_view message, const size_t position) {
+    parse_error(code, message, {}, position);
+}
+
+void TreeBuilder::parse_error(
+    const ErrorCode        code,
+    const std::string_view prefix,
+    const std::string_view detail,
+    const size_t           position) {
+    const bool strict = m_options.error_handling == ErrorHandlingMode::Strict;
+    if (m_options.error_collection != ErrorCollectionMode::Full && !strict) {
+        m_error_summary.record(code, position);
+        return;
+    }
+
+    std::string message;
+    message.reserve(prefix.size() + detail.size());
+    message.append(prefix).append(detail);
+    if (m_options.defer_error_locations && !strict) {
+        m_errors.emplace_back(code, std::move(message), Location::unresolved(position));
+        return;
+    }
+
+    if (!m_line_index) {
+        m_line_index = std::make_shared<LineIndex>(m_document->source_html());
+    }
+    const auto location = m_line_index->locate(position);
+    if (strict) {
+        m_errors.emplace_back(code, message, location);
+        throw HPSException(code, std::move(message), location);
     }
+    m_errors.emplace_back(code, std::move(message), location);
 }
 
-void TreeBuilder::check_implicit_close(const std::string_view tag_name) {
-    while (m_element_stack.size() > m_stack_floor) {
-        const auto             current     = current_element();
-        const std::string_view current_tag = current->tag_name();
-
-        // <p> implies closing by block elements
-        static constexpr std::array<std::string_view, 26> p_closers = {"address", "article", "aside", "blockquote", "div", "dl", "fieldset", "footer", "form", "h1", "h2", "h3", "h4", "h5", "h6", "header", "hgroup", "hr", "main", "nav", "ol", "p", "pre", "section", "table", "ul"};
-        const bool closes_paragraph =
-            current_tag == "p" && std::ranges::binary_search(p_closers, tag_name);
-        const bool closes_list_item =
-            (current_tag == "li" && tag_name == "li") ||
-            ((current_tag == "dd" || current_tag == "dt") &&
-             (tag_name == "dd" || tag_name == "dt"));
-        const bool closes_button =
-            equals_ignore_case(current_tag, "button") &&
-            equals_ignore_case(tag_name, "button");
-        const bool closes_table_cell =
-            is_table_cell_tag(current_tag) &&
-            (is_table_cell_tag(tag_name) || equals_ignore_case(tag_name, "tr") ||
-             is_table_section_tag(tag_name));
-        const bool closes_table_row =
-            equals_ignore_case(current_tag, "tr") &&
-            (equals_ignore_case(tag_name, "tr") || is_table_section_tag(tag_name) ||
-             equals_ignore_case(tag_name, "table"));
-        const bool closes_table_section =
-            is_table_section_tag(current_tag) &&
-            (is_table_section_tag(tag_name) || equals_ignore_case(tag_name, "table"));
-        const bool should_pop_current =
-            closes_paragraph || closes_list_item || closes_button || closes_table_cell ||
-            closes_table_row || closes_table_section;
-
-        if (should_pop_current) {
-            m_element_stack.pop_back();
-            continue;
-        }
-        break;
+void TreeBuilder::set_line_index(std::shared_ptr<const LineIndex> line_index) {
+    m_line_index = std::move(line_index);
+}
+
+void TreeBuilder::check_implicit_close(const TagInfo tag) {
+    while (m_element_stack.size() > m_stack_floor && implicitly_closed_by(current_tag().id, tag)) {
+        pop_element();
     }
 }
 
@@ -667,29 +775,28 @@ void TreeBuilder::close_head_element_if_open() {
     m_head_closed = true;
 }
 
-void TreeBuilder::prepare_table_context_for_start_tag(const std::string_view tag_name) {
-    if (is_table_structure_tag(tag_name)) {
-        close_foster_parented_elements_before_table_token();
-    }
-
-    if (equals_ignore_case(tag_name, "caption")) {
-        close_open_table_content_before_container("caption");
-        return;
-    }
-
-    if (equals_ignore_case(tag_name, "colgroup")) {
-        close_open_table_content_before_container("colgroup");
+void TreeBuilder::prepare_table_context_for_start_tag(const TagInfo tag) {
+    if (!tag.is(TagCategory::TableStructure)) {
         return;
     }
+    close_foster_parented_elements_before_table_token();
 
-    if (equals_ignore_case(tag_name, "col")) {
-        close_open_table_content_before_container("colgroup", false);
-        ensure_colgroup();
-        return;
+    switch (tag.id) {
+        case TagId::Caption:
+            close_open_table_content_before_container("caption");
+            return;
+        case TagId::ColGroup:
+            close_open_table_content_before_container("colgroup");
+            return;
+        case TagId::Col:
+            close_open_table_content_before_container("colgroup", false);
+            ensure_colgroup();
+            return;
+        default:
+            break;
     }
 
-    if (is_table_section_tag(tag_name) || equals_ignore_case(tag_name, "tr") ||
-        is_table_cell_tag(tag_name)) {
+    if (tag.is(TagCategory::TableSection | TagCategory::TableRow | TagCategory::TableCell)) {
         if (find_open_element("caption", false) != nullptr) {
             close_elements_until("caption", false);
         }
@@ -698,25 +805,25 @@ void TreeBuilder::prepare_table_context_for_start_tag(const std::string_view tag
         }
     }
 
-    if (equals_ignore_case(tag_name, "tr")) {
+    if (tag.id == TagId::Tr) {
         ensure_table_section();
         return;
     }
 
-    if (is_table_cell_tag(tag_name)) {
+    if (tag.is(TagCategory::TableCell)) {
         ensure_table_row();
     }
 }
 
-void TreeBuilder::prepare_select_context_for_start_tag(const std::string_view tag_name) {
-    if (equals_ignore_case(tag_name, "option")) {
+void TreeBuilder::prepare_select_context_for_start_tag(const TagInfo tag) {
+    if (tag.id == TagId::Option) {
         if (find_open_in_select_scope("option") != nullptr) {
             close_elements_until("option", false);
         }
         return;
     }
 
-    if (equals_ignore_case(tag_name, "optgroup")) {
+    if (tag.id == TagId::OptGroup) {
         if (find_open_in_select_scope("option") != nullptr) {
             close_elements_until("option", false);
         }
@@ -726,7 +833,7 @@ void TreeBuilder::prepare_select_context_for_start_tag(const std::string_view ta
         return;
     }
 
-    if (equals_ignore_case(tag_name, "select")) {
+    if (tag.id == TagId::Select) {
         if (find_open_in_select_scope("option") != nullptr) {
             close_elements_until("option", false);
         }
@@ -739,26 +846,22 @@ void TreeBuilder::prepare_select_context_for_start_tag(const std::string_view ta
     }
 }
 
-bool TreeBuilder::handle_table_end_tag(const std::string_view tag_name) {
-    if (equals_ignore_case(tag_name, "table") ||
-        equals_ignore_case(tag_name, "tr") ||
-        is_table_section_tag(tag_name) ||
-        is_table_cell_tag(tag_name) ||
-        equals_ignore_case(tag_name, "caption") ||
-        equals_ignore_case(tag_name, "colgroup")) {
-        close_foster_parented_elements_before_table_token();
+bool TreeBuilder::handle_table_end_tag(const std::string_view tag_name, const TagInfo tag) {
+    if (tag.id == TagId::Col) {
+        return false;
     }
+    close_foster_parented_elements_before_table_token();
 
-    if (equals_ignore_case(tag_name, "caption") || equals_ignore_case(tag_name, "colgroup")) {
+    if (tag.id == TagId::Caption || tag.id == TagId::ColGroup) {
         if (find_open_element(tag_name, false) == nullptr) {
-            parse_error(ErrorCode::MismatchedTag, "No matching opening tag for: " + std::string(tag_name));
+            parse_error(ErrorCode::MismatchedTag, "No matching opening tag for: ", tag_name);
             return true;
         }
         close_elements_until(tag_name, false);
         return true;
     }
 
-    if (is_table_cell_tag(tag_name)) {
+    if (tag.is(TagCategory::TableCell)) {
         if (find_open_element(tag_name, false) == nullptr) {
             return false;
         }
@@ -766,7 +869,7 @@ bool TreeBuilder::handle_table_end_tag(const std::string_view tag_name) {
         return true;
     }
 
-    if (equals_ignore_case(tag_name, "tr")) {
+    if (tag.id == TagId::Tr) {
         if (find_open_table_cell() != nullptr) {
             close_elements_until(find_open_table_cell()->tag_name(), false);
         }
@@ -778,7 +881,7 @@ bool TreeBuilder::handle_table_end_tag(const std::string_view tag_name) {
         return true;
     }
 
-    if (is_table_section_tag(tag_name)) {
+    if (tag.is(TagCategory::TableSection)) {
         if (find_open_table_cell() != nullptr) {
             close_elements_until(find_open_table_cell()->tag_name(), false);
         }
@@ -786,14 +889,14 @@ bool TreeBuilder::handle_table_end_tag(const std::string_view tag_name) {
             close_elements_until("tr", false);
         }
         if (find_open_element(tag_name, false) == nullptr) {
-            parse_error(ErrorCode::MismatchedTag, "No matching opening tag for: " + std::string(tag_name));
+            parse_error(ErrorCode::MismatchedTag, "No matching opening tag for: ", tag_name);
             return true;
         }
         close_elements_until(tag_name, false);
         return true;
     }
 
-    if (equals_ignore_case(tag_name, "table")) {
+    if (tag.id == TagId::Table) {
         if (find_open_element("caption", false) != nullptr) {
             close_elements_until("caption", false);
         }
@@ -820,8 +923,8 @@ bool TreeBuilder::handle_table_end_tag(const std::string_view tag_name) {
     return false;
 }
 
-bool TreeBuilder::handle_select_end_tag(const std::string_view tag_name) {
-    if (equals_ignore_case(tag_name, "option")) {
+bool TreeBuilder::handle_select_end_tag(const TagInfo tag) {
+    if (tag.id == TagId::Option) {
         if (find_open_in_select_scope("option") == nullptr) {
             parse_error(ErrorCode::MismatchedTag, "No matching opening tag for: option");
             return true;
@@ -830,7 +933,7 @@ bool TreeBuilder::handle_select_end_tag(const std::string_view tag_name) {
         return true;
     }
 
-    if (equals_ignore_case(tag_name, "optgroup")) {
+    if (tag.id == TagId::OptGroup) {
         if (find_open_in_select_scope("option") != nullptr) {
             close_elements_until("option", false);
         }
@@ -842,7 +945,7 @@ bool TreeBuilder::handle_select_end_tag(const std::string_view tag_name) {
         return true;
     }
 
-    if (equals_ignore_case(tag_name, "select")) {
+    if (tag.id == TagId::Select) {
         if (find_open_in_select_scope("option") != nullptr) {
             close_elements_until("option", false);
         }
@@ -927,73 +1030,35 @@ void TreeBuilder::close_colgroup_for_non_col_token() {
     if (current_element() == nullptr) {
         return;
     }
-    if (!equals_ignore_case(current_element()->tag_name(), "colgroup")) {
+    if (current_tag().id != TagId::ColGroup) {
         return;
     }
     close_elements_until("colgroup", false);
 }
 
-bool TreeBuilder::is_head_content_tag(const std::string_view tag_name) noexcept {
-    static constexpr auto head_content_tags = sorted_string_view_array(std::array<std::string_view, 11>{
-        "base",
-        "basefont",
-        "bgsound",
-        "link",
-        "meta",
-        "noframes",
-        "noscript",
-        "script",
-        "style",
-        "template",
-        "title",
-    });
-    return std::ranges::binary_search(head_content_tags, tag_name);
-}
-
-bool TreeBuilder::is_table_section_tag(const std::string_view tag_name) noexcept {
-    static constexpr auto table_section_tags = sorted_string_view_array(
-        std::array<std::string_view, 3>{"tbody", "tfoot", "thead"});
-    return std::ranges::binary_search(table_section_tags, tag_name);
-}
-
-bool TreeBuilder::is_table_cell_tag(const std::string_view tag_name) noexcept {
-    static constexpr auto table_cell_tags =
-        sorted_string_view_array(std::array<std::string_view, 2>{"td", "th"});
-    return std::ranges::binary_search(table_cell_tags, tag_name);
-}
-
-bool TreeBuilder::is_table_structure_tag(const std::string_view tag_name) noexcept {
-    static constexpr auto table_structure_tags = sorted_string_view_array(
-        std::array<std::string_view, 9>{"caption", "col", "colgroup", "table", "tbody", "td", "tfoot", "th", "thead"});
-    return std::ranges::binary_search(table_structure_tags, tag_name) ||
-           equals_ignore_case(tag_name, "tr");
-}
-
-bool TreeBuilder::is_table_container_tag(const std::string_view tag_name) noexcept {
-    static constexpr auto table_container_tags = sorted_string_view_array(
-        std::array<std::string_view, 2>{"caption", "colgroup"});
-    return std::ranges::binary_search(table_container_tags, tag_name);
-}
-
-bool TreeBuilder::is_adoption_formatting_tag(const std::string_view tag_name) noexcept {
-    static constexpr auto formatting_tags = sorted_string_view_array(std::array<std::string_view, 15>{
-        "a",
-        "b",
-        "big",
-        "code",
-        "em",
-        "font",
-        "i",
-        "nobr",
-        "s",
-        "small",
-        "strike",
-        "strong",
-        "tt",
-        "u",
-        "span",
-    });
-    return std::ranges::binary_search(formatting_tags, tag_name);
+size_t TreeBuilder::topmost_open(const std::initializer_list<TagId> tags) const noexcept {
+    size_t position = 0;
+    for (const TagId tag : tags) {
+        position = std::max<size_t>(position, m_topmost_open[static_cast<size_t>(tag)]);
+    }
+    return position;
+}
+
+Element* TreeBuilder::open_element_above_table(const std::initializer_list<TagId> tags) const noexcept {
+    // 表格作用域：只认最近一个打开的 <table> 之上的元素
+    const size_t position = topmost_open(tags);
+    if (position <= m_topmost_open[static_cast<size_t>(TagId::Table)]) {
+        return nullptr;
+    }
+    return m_element_stack[position - 1];
+}
+
+bool TreeBuilder::is_void_element(const std::string_view tag_name, const TagInfo tag) const {
+    // 自定义空元素集合优先，默认集合直接读类别位
+    if (!m_options.void_elements.empty()) {
+        return m_options.is_void_element(tag_name);
+    }
+    return tag.is(TagCategory::Void);
 }
 
 NamespaceKind TreeBuilder::current_insertion_namespace() const noexcept {
@@ -1001,19 +1066,18 @@ NamespaceKind TreeBuilder::current_insertion_namespace() const noexcept {
     if (current == nullptr) {
         return NamespaceKind::Html;
     }
-    if (current->namespace_kind() == NamespaceKind::Svg &&
-        equals_ignore_case(current->tag_name(), "foreignobject")) {
+    if (current->namespace_kind() == NamespaceKind::Svg && current_tag().id == TagId::ForeignObject) {
         return NamespaceKind::Html;
     }
     return current->namespace_kind();
 }
 
-NamespaceKind TreeBuilder::namespace_for_start_tag(const std::string_view tag_name) const noexcept {
+NamespaceKind TreeBuilder::namespace_for_start_tag(const TagInfo tag) const noexcept {
     const auto inherited_namespace = current_insertion_namespace();
-    if (equals_ignore_case(tag_name, "svg")) {
+    if (tag.id == TagId::Svg) {
         return NamespaceKind::Svg;
     }
-    if (equals_ignore_case(tag_name, "math")) {
+    if (tag.id == TagId::Math) {
         return NamespaceKind::MathML;
     }
     if (inherited_namespace != NamespaceKind::Html) {
@@ -1023,37 +1087,11 @@ NamespaceKind TreeBuilder::namespace_for_start_tag(const std::string_view tag_na
 }
 
 bool TreeBuilder::can_omit_end_tag_at_eof(const std::string_view tag_name) noexcept {
-    static constexpr auto optional_end_tags = sorted_string_view_array(std::array<std::string_view, 18>{
-        "body",
-        "caption",
-        "colgroup",
-        "dd",
-        "dt",
-        "head",
-        "html",
-        "li",
-        "optgroup",
-        "option",
-        "p",
-        "rb",
-        "rp",
-        "rt",
-        "rtc",
-        "tbody",
-        "td",
-        "tfoot",
-    });
-    static constexpr auto optional_end_tags_tail = sorted_string_view_array(std::array<std::string_view, 3>{
-        "th",
-        "thead",
-        "tr",
-    });
-    return std::ranges::binary_search(optional_end_tags, tag_name) ||
-           std::ranges::binary_search(optional_end_tags_tail, tag_name);
+    return lookup_tag(tag_name).is(TagCategory::OptionalEndTag);
 }
 
 bool TreeBuilder::is_all_whitespace(const std::string_view text) noexcept {
-    return std::ranges::all_of(text, is_whitespace);
+    return find_non_whitespace(text) == text.size();
 }
 
 bool TreeBuilder::should_foster_parent_text() const noexcept {
@@ -1062,14 +1100,11 @@ bool TreeBuilder::should_foster_parent_text() const noexcept {
         return false;
     }
 
-    const std::string_view current_tag = current->tag_name();
-    return equals_ignore_case(current_tag, "table") ||
-           is_table_section_tag(current_tag) ||
-           equals_ignore_case(current_tag, "tr");
+    return current_tag().is(TagCategory::FosterParent);
 }
 
-bool TreeBuilder::should_foster_parent_element(const std::string_view tag_name) const noexcept {
-    if (is_table_structure_tag(tag_name)) {
+bool TreeBuilder::should_foster_parent_element(const TagInfo tag) const noexcept {
+    if (tag.is(TagCategory::TableStructure)) {
         return false;
     }
 
@@ -1077,11 +1112,7 @@ bool TreeBuilder::should_foster_parent_element(const std::string_view tag_name)
     if (current == nullptr) {
         return false;
     }
-
-    const std::string_view current_tag = current->tag_name();
-    return equals_ignore_case(current_tag, "table") ||
-           is_table_section_tag(current_tag) ||
-           equals_ignore_case(current_tag, "tr");
+    return current_tag().is(TagCategory::FosterParent);
 }
 
 std::pair<Node*, const Node*> TreeBuilder::foster_parent_insertion_point() const noexcept {
@@ -1114,35 +1145,29 @@ void TreeBuilder::close_foster_parented_elements_before_table_token() noexcept {
         if (current == nullptr || current == table) {
             return;
         }
-        if (is_table_structure_tag(current->tag_name())) {
+        if (current_tag().is(TagCategory::TableStructure)) {
             return;
         }
-        m_element_stack.pop_back();
+        pop_element();
     }
 }
 
 bool TreeBuilder::try_recover_formatting_end_tag(const std::string_view tag_name) {
-    if (!is_adoption_formatting_tag(tag_name)) {
+    if (!lookup_tag(tag_name).is(TagCategory::Formatting)) {
         return false;
     }
 
-    size_t matching_index = m_element_stack.size();
-    for (size_t index = m_element_stack.size(); index > m_stack_floor; --index) {
-        if (equals_ignore_case(m_element_stack[index - 1]->tag_name(), tag_name)) {
-            matching_index = index - 1;
-            break;
-        }
-    }
-
-    if (matching_index == m_element_stack.size()) {
+    const size_t position = find_open_position(tag_name, false);
+    if (position == 0) {
         return false;
     }
+    const size_t matching_index = position - 1;
     if (matching_index + 1 == m_element_stack.size()) {
         return false;
     }
 
     for (size_t index = matching_index + 1; index < m_element_stack.size(); ++index) {
-        if (!is_adoption_formatting_tag(m_element_stack[index]->tag_name())) {
+        if (!m_element_links[index].tag.is(TagCategory::Formatting)) {
             return false;
         }
     }
@@ -1153,7 +1178,9 @@ bool TreeBuilder::try_recover_formatting_end_tag(const std::string_view tag_name
         reopen_chain.push_back(m_element_stack[index]);
     }
 
-    m_element_stack.resize(matching_index);
+    while (m_element_stack.size() > matching_index) {
+        pop_element();
+    }
 
     Node* parent = current_element() != nullptr
                        ? static_cast<Node*>(current_element())
@@ -1169,74 +1196,53 @@ bool TreeBuilder::try_recover_formatting_end_tag(const std::string_view tag_name
     return true;
 }
 
-Element* TreeBuilder::find_open_element(
+size_t TreeBuilder::find_open_position(
     const std::string_view tag_name,
     const bool include_fragment_base) const noexcept {
-    for (size_t index = m_element_stack.size(); index > 0; --index) {
-        if (!include_fragment_base && index <= m_stack_floor) {
+    // 已知标签独占一个槽，链首即为结果；未知标签共享哈希槽，需要沿链比较名称
+    const TagInfo tag = lookup_tag(tag_name);
+    for (std::uint32_t position = m_topmost_open[open_tag_slot(tag_name, tag)]; position != 0;
+         position               = m_element_links[position - 1].previous) {
+        if (!include_fragment_base && position <= m_stack_floor) {
             break;
         }
-        Element* element = m_element_stack[index - 1];
-        if (equals_ignore_case(element->tag_name(), tag_name)) {
-            return element;
+        if (tag.id != TagId::Unknown || equals_ignore_case(m_element_stack[position - 1]->tag_name(), tag_name)) {
+            return position;
         }
     }
-    return nullptr;
+    return 0;
+}
+
+Element* TreeBuilder::find_open_element(
+    const std::string_view tag_name,
+    const bool include_fragment_base) const noexcept {
+    const size_t position = find_open_position(tag_name, include_fragment_base);
+    return position != 0 ? m_element_stack[position - 1] : nullptr;
 }
 
 Element* TreeBuilder::find_open_in_select_scope(const std::string_view tag_name) const noexcept {
-    for (size_t index = m_element_stack.size(); index > 0; --index) {
-        if (index <= m_stack_floor) {
-            break;
-        }
-        Element* element = m_element_stack[index - 1];
-        if (equals_ignore_case(element->tag_name(), tag_name)) {
-            return element;
-        }
-        if (equals_ignore_case(element->tag_name(), "select")) {
-            return equals_ignore_case(tag_name, "select") ? element : nullptr;
-        }
+    // select 作用域：目标元素必须位于最近一个打开的 <select> 之上（或就是它）
+    size_t select = m_topmost_open[static_cast<size_t>(TagId::Select)];
+    if (select <= m_stack_floor) {
+        select = 0;
     }
-    return nullptr;
+    const size_t position = find_open_position(tag_name, false);
+    if (position == 0 || position < select) {
+        return nullptr;
+    }
+    return m_element_stack[position - 1];
 }
 
 Element* TreeBuilder::find_open_table_section() const noexcept {
-    for (size_t index = m_element_stack.size(); index > 0; --index) {
-        Element* element = m_element_stack[index - 1];
-        if (is_table_section_tag(element->tag_name())) {
-            return element;
-        }
-        if (equals_ignore_case(element->tag_name(), "table")) {
-            break;
-        }
-    }
-    return nullptr;
+    return open_element_above_table({TagId::Tbody, TagId::Thead, TagId::Tfoot});
 }
 
 Element* TreeBuilder::find_open_table_row() const noexcept {
-    for (size_t index = m_element_stack.size(); index > 0; --index) {
-        Element* element = m_element_stack[index - 1];
-        if (equals_ignore_case(element->tag_name(), "tr")) {
-            return element;
-        }
-        if (equals_ignore_case(element->tag_name(), "table")) {
-            break;
-        }
-    }
-    return nullptr;
+    return open_element_above_table({TagId::Tr});
 }
 
 Element* TreeBuilder::find_open_table_cell() const noexcept {
-    for (size_t index = m_element_stack.size(); index > 0; --index) {
-        Element* element = m_element_stack[index - 1];
-        if (is_table_cell_tag(element->tag_name())) {
-            return element;
-        }
-        if (equals_ignore_case(element->tag_name(), "table")) {
-            break;
-        }
-    }
-    return nullptr;
+    return open_element_above_table({TagId::Td, TagId::Th});
 }
 
 }  // namespace hps
@@ -5,7 +5,6 @@
 
 #include <algorithm>
 #include <regex>
-#include <unordered_set>
 
 namespace hps {
 
@@ -26,10 +25,6 @@ std::vector<const Element*> CSSMatcher::find_all(const Element& element, const S
             traverse_and_match(*child->as_element(), selector_list, results);
         }
     }
-    std::unordered_set<const Element*> seen;
-    const auto                         it = std::ranges::remove_if(results, [&seen](const Element* elem) { return !seen.insert(elem).second; }).begin();
-    results.erase(it, results.end());
-
     return results;
 }
 
@@ -50,10 +45,6 @@ std::vector<const Element*> CSSMatcher::find_all(const Document& document, const
             traverse_and_match(*child->as_element(), selector_list, results);
         }
     }
-
-    std::unordered_set<const Element*> seen;
-    const auto                         it = std::ranges::remove_if(results, [&seen](const Element* elem) { return !seen.insert(elem).second; }).begin();
-    results.erase(it, results.end());
     return results;
 }
 
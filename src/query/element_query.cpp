@@ -492,6 +492,26 @@ ElementQuery ElementQuery::filter(const std::function<bool(const Element&)>& pre
     return ElementQuery(std::move(filtered));
 }
 
+ElementQuery ElementQuery::sort_by_document_order() const {
+    std::vector<std::pair<size_t, const Element*>> keyed;
+    keyed.reserve(m_elements.size());
+    for (const auto* element : m_elements) {
+        if (element) {
+            keyed.emplace_back(element->document_order(), element);
+        }
+    }
+    std::ranges::sort(keyed);
+    const auto duplicates = std::ranges::unique(keyed);
+    keyed.erase(duplicates.begin(), duplicates.end());
+
+    std::vector<const Element*> sorted;
+    sorted.reserve(keyed.size());
+    for (const auto& [order, element] : keyed) {
+        sorted.push_back(element);
+    }
+    return ElementQuery(std::move(sorted));
+}
+
 ElementQuery ElementQuery::not_(const std::string_view selector) const {
     if (selector.empty()) {
         return *this;
@@ -1,35 +1,46 @@
 #include "hps/utils/encoding.hpp"
 
+#include "hps/utils/legacy_encodings.hpp"
 #include "hps/utils/string_utils.hpp"
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cstdint>
+#include <cstring>
 #include <optional>
-#include <stdexcept>
 #include <string_view>
-#include <vector>
 
-#ifdef _WIN32
-#define NOMINMAX
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
+// x86-64 上 SSE2 是基线指令集；SSSE3 校验路径在运行时检测 CPU 后启用，无需额外编译选项
+#if defined(__x86_64__) || defined(_M_X64)
+#define HPS_ENCODING_X86_64 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define HPS_TARGET_SSSE3
 #else
-#include <iconv.h>
+#define HPS_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#else
+#define HPS_ENCODING_X86_64 0
 #endif
 
 namespace hps {
 namespace {
 
+// WHATWG 编码嗅探只检查输入开头的 1024 字节
+constexpr size_t kPrescanLength = 1024;
+
 struct CharsetAliasMapping {
     std::string_view alias;
     std::string_view canonical;
 };
 
+using DecodeFunction = std::string (*)(std::string_view bytes);
+
 struct CharsetBackendMapping {
     std::string_view canonical;
-    unsigned int     windows_code_page;
-    std::string_view iconv_name;
+    DecodeFunction   decode;
 };
 
 constexpr std::array<CharsetAliasMapping, 28> kSupportedCharsetAliases = {{
@@ -70,14 +81,6 @@ constexpr std::array<CharsetAliasMapping, 4> kSupportedCharsetAliasesTail = {{
     {"csshiftjis", "shift_jis"},
 }};
 
-constexpr std::array<CharsetBackendMapping, 5> kSupportedCharsetBackends = {{
-    {"gbk", 936U, "GBK"},
-    {"windows-1252", 1252U, "WINDOWS-1252"},
-    {"shift_jis", 932U, "SHIFT_JIS"},
-    {"utf-16le", 1200U, "UTF-16LE"},
-    {"utf-16be", 1201U, "UTF-16BE"},
-}};
-
 [[nodiscard]] auto has_utf8_bom(const std::string_view input) noexcept -> bool {
     return input.size() >= 3 &&
            static_cast<unsigned char>(input[0]) == 0xEF &&
@@ -173,12 +176,14 @@ void append_utf8(std::string& output, const char32_t code_point) {
     return utf8;
 }
 
-[[nodiscard]] auto is_valid_utf8(const std::string_view input) noexcept -> bool {
+// ==================== UTF-8 校验 ====================
+
+[[nodiscard]] auto is_valid_utf8_scalar(const std::string_view input) noexcept -> bool {
     size_t index = 0;
     while (index < input.size()) {
         const auto byte = static_cast<unsigned char>(input[index]);
         if (byte <= 0x7F) {
-            ++index;
+            index += ascii_prefix_length(input.substr(index));
             continue;
         }
 
@@ -249,6 +254,139 @@ void append_utf8(std::string& output, const char32_t code_point) {
     return true;
 }
 
+#if HPS_ENCODING_X86_64
+
+[[nodiscard]] auto cpu_supports_ssse3() noexcept -> bool {
+#ifdef _MSC_VER
+    int info[4] = {};
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    return __builtin_cpu_supports("ssse3") != 0;
+#endif
+}
+
+/**
+ * @brief 基于查表的 UTF-8 校验（Keiser–Lemire 算法，每次处理 16 字节）
+ *
+ * 对每个字节，用前一字节的高/低半字节和当前字节的高半字节各查一张 16 项表，
+ * 三者按位与得到该字节对上的错误类别；再用前 2、3 个字节判断哪些位置必须是多字节序列的后续字节。
+ * 纯 ASCII 块只需确认上一块没有未完成的序列。
+ */
+HPS_TARGET_SSSE3 [[nodiscard]] auto is_valid_utf8_ssse3(const std::string_view input) noexcept -> bool {
+    constexpr std::uint8_t kTooShort    = 1 << 0;  // 11______ 0_______ / 11______ 11______
+    constexpr std::uint8_t kTooLong     = 1 << 1;  // 0_______ 10______
+    constexpr std::uint8_t kOverlong3   = 1 << 2;  // 11100000 100_____
+    constexpr std::uint8_t kTooLarge    = 1 << 3;  // 11110100 1001____ 及更大
+    constexpr std::uint8_t kSurrogate   = 1 << 4;  // 11101101 101_____
+    constexpr std::uint8_t kOverlong2   = 1 << 5;  // 1100000_ 10______
+    constexpr std::uint8_t kTooLarge1000 = 1 << 6; // 11110101 1000____ 及更大
+    constexpr std::uint8_t kOverlong4   = 1 << 6;  // 11110000 1000____
+    constexpr std::uint8_t kTwoConts    = 1 << 7;  // 10______ 10______
+    constexpr std::uint8_t kCarry       = kTooShort | kTooLong | kTwoConts;
+
+    alignas(16) static constexpr std::array<std::uint8_t, 16> kByte1High = {
+        kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+        kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+        kTooShort | kOverlong2,
+        kTooShort,
+        kTooShort | kOverlong3 | kSurrogate,
+        kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+    };
+    alignas(16) static constexpr std::array<std::uint8_t, 16> kByte1Low = {
+        kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+        kCarry | kOverlong2,
+        kCarry,
+        kCarry,
+        kCarry | kTooLarge,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+    };
+    alignas(16) static constexpr std::array<std::uint8_t, 16> kByte2High = {
+        kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+        kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+        kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+        kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+        kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+        kTooShort, kTooShort, kTooShort, kTooShort,
+    };
+    // 块末尾若出现尚未结束的多字节序列首字节，减法结果非零
+    alignas(16) static constexpr std::array<std::uint8_t, 16> kIncompleteMax = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1,
+    };
+
+    const auto load = [](const std::array<std::uint8_t, 16>& table) {
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(table.data()));
+    };
+    const __m128i byte_1_high_table = load(kByte1High);
+    const __m128i byte_1_low_table  = load(kByte1Low);
+    const __m128i byte_2_high_table = load(kByte2High);
+    const __m128i incomplete_max    = load(kIncompleteMax);
+    const __m128i nibble_mask       = _mm_set1_epi8(0x0F);
+    const __m128i third_byte_min    = _mm_set1_epi8(static_cast<char>(0xE0 - 0x80));
+    const __m128i fourth_byte_min   = _mm_set1_epi8(static_cast<char>(0xF0 - 0x80));
+    const __m128i high_bit          = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i zero              = _mm_setzero_si128();
+
+    const auto* data            = reinterpret_cast<const unsigned char*>(input.data());
+    const size_t size           = input.size();
+    __m128i      error          = zero;
+    __m128i      prev_input     = zero;
+    __m128i      prev_incomplete = zero;
+
+    for (size_t index = 0; index < size; index += 16) {
+        __m128i block;
+        if (index + 16 <= size) {
+            block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+        } else {
+            // 尾块以 0 填充；若输入在序列中途结束，填充的 ASCII 字节会触发 kTooShort
+            alignas(16) std::array<unsigned char, 16> tail{};
+            std::memcpy(tail.data(), data + index, size - index);
+            block = _mm_load_si128(reinterpret_cast<const __m128i*>(tail.data()));
+        }
+
+        if (_mm_movemask_epi8(block) == 0) {
+            error           = _mm_or_si128(error, prev_incomplete);
+            prev_incomplete = zero;
+        } else {
+            const __m128i prev1       = _mm_alignr_epi8(block, prev_input, 15);
+            const __m128i byte_1_high = _mm_shuffle_epi8(byte_1_high_table, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble_mask));
+            const __m128i byte_1_low  = _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, nibble_mask));
+            const __m128i byte_2_high = _mm_shuffle_epi8(byte_2_high_table, _mm_and_si128(_mm_srli_epi16(block, 4), nibble_mask));
+            const __m128i special     = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+            const __m128i prev2        = _mm_alignr_epi8(block, prev_input, 14);
+            const __m128i prev3        = _mm_alignr_epi8(block, prev_input, 13);
+            const __m128i is_third     = _mm_subs_epu8(prev2, third_byte_min);
+            const __m128i is_fourth    = _mm_subs_epu8(prev3, fourth_byte_min);
+            const __m128i must_be_cont = _mm_and_si128(_mm_or_si128(is_third, is_fourth), high_bit);
+
+            error           = _mm_or_si128(error, _mm_xor_si128(must_be_cont, special));
+            prev_incomplete = _mm_subs_epu8(block, incomplete_max);
+        }
+        prev_input = block;
+
+        // 定期检查以便尽早拒绝非 UTF-8 输入
+        if ((index & 0x3FF) == 0x3F0 && _mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) != 0xFFFF) {
+            return false;
+        }
+    }
+
+    error = _mm_or_si128(error, prev_incomplete);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) == 0xFFFF;
+}
+
+#endif
+
 template <typename Range>
 [[nodiscard]] auto lookup_alias(
     const Range& aliases,
@@ -282,6 +420,29 @@ template <typename Range>
     return normalized;
 }
 
+template <void (*Decoder)(std::string_view, std::string&)>
+[[nodiscard]] auto decode_with(const std::string_view bytes) -> std::string {
+    std::string out;
+    Decoder(bytes, out);
+    return out;
+}
+
+[[nodiscard]] auto decode_utf16le(const std::string_view bytes) -> std::string {
+    return decode_utf16_to_utf8(bytes, false);
+}
+
+[[nodiscard]] auto decode_utf16be(const std::string_view bytes) -> std::string {
+    return decode_utf16_to_utf8(bytes, true);
+}
+
+constexpr std::array<CharsetBackendMapping, 5> kSupportedCharsetBackends = {{
+    {"gbk", &decode_with<decode_gb18030_to_utf8>},
+    {"windows-1252", &decode_with<decode_windows_1252_to_utf8>},
+    {"shift_jis", &decode_with<decode_shift_jis_to_utf8>},
+    {"utf-16le", &decode_utf16le},
+    {"utf-16be", &decode_utf16be},
+}};
+
 template <typename Range>
 [[nodiscard]] auto lookup_backend(
     const Range& backends,
@@ -357,19 +518,35 @@ template <typename Range>
 }
 
 [[nodiscard]] auto sniff_meta_charset(const std::string_view raw_html) -> EncodingHint {
-    const auto prefix = raw_html.substr(0, std::min<size_t>(raw_html.size(), 4096));
+    const auto prefix = raw_html.substr(0, std::min<size_t>(raw_html.size(), kPrescanLength));
 
     std::string lowered(prefix);
     std::ranges::transform(lowered, lowered.begin(), [](const unsigned char ch) {
         return static_cast<char>(ch < 0x80 ? to_lower(static_cast<char>(ch)) : ch);
     });
 
-    size_t cursor = 0;
-    while (cursor < lowered.size()) {
-        const size_t meta_pos = lowered.find("<meta", cursor);
+    const std::string_view view(lowered);
+    size_t                 cursor = 0;
+    while (cursor < view.size()) {
+        const size_t meta_pos = view.find('<', cursor);
         if (meta_pos == std::string_view::npos) {
             break;
         }
+        // 与 WHATWG 预扫描一致：跳过注释，只识别后接空白或 '/' 的 <meta
+        if (view.substr(meta_pos).starts_with("<!--")) {
+            const size_t comment_end = view.find("-->", meta_pos + 4);
+            if (comment_end == std::string_view::npos) {
+                break;
+            }
+            cursor = comment_end + 3;
+            continue;
+        }
+        const bool is_meta = view.substr(meta_pos).starts_with("<meta") && meta_pos + 5 < view.size() &&
+                             (is_whitespace(view[meta_pos + 5]) || view[meta_pos + 5] == '/');
+        if (!is_meta) {
+            cursor = meta_pos + 1;
+            continue;
+        }
 
         size_t end_pos = lowered.find('>', meta_pos);
         if (end_pos == std::string_view::npos) {
@@ -379,7 +556,11 @@ template <typename Range>
         const std::string detected_label = extract_charset_from_meta_tag(
             std::string_view(lowered).substr(meta_pos, end_pos - meta_pos));
         if (!detected_label.empty()) {
-            const std::string canonical = normalize_encoding_label(detected_label);
+            std::string canonical = normalize_encoding_label(detected_label);
+            // 能被 ASCII 预扫描读到的声明不可能真是 UTF-16，规范要求此时改用 UTF-8
+            if (canonical == "utf-16le" || canonical == "utf-16be") {
+                canonical = "utf-8";
+            }
             return EncodingHint{
                 .detected_label   = detected_label,
                 .canonical_label  = canonical,
@@ -394,90 +575,140 @@ template <typename Range>
     return {};
 }
 
-[[nodiscard]] auto decode_code_page_to_utf8(
-    const std::string_view bytes,
-    const CharsetBackendMapping& mapping) -> std::string {
-    if (mapping.canonical == "utf-16le") {
-        return decode_utf16_to_utf8(bytes, false);
-    }
-    if (mapping.canonical == "utf-16be") {
-        return decode_utf16_to_utf8(bytes, true);
-    }
-
-#ifdef _WIN32
-    const int wide_size = MultiByteToWideChar(
-        mapping.windows_code_page,
-        0,
-        bytes.data(),
-        static_cast<int>(bytes.size()),
-        nullptr,
-        0);
-    if (wide_size <= 0) {
-        throw std::runtime_error("Failed to calculate UTF-16 size for charset " + std::string(mapping.canonical));
-    }
-
-    std::vector<wchar_t> wide(wide_size);
-    if (MultiByteToWideChar(
-            mapping.windows_code_page,
-            0,
-            bytes.data(),
-            static_cast<int>(bytes.size()),
-            wide.data(),
-            wide_size) != wide_size) {
-        throw std::runtime_error("Failed to convert bytes from charset " + std::string(mapping.canonical));
-    }
-
-    const int utf8_size = WideCharToMultiByte(
-        CP_UTF8,
-        0,
-        wide.data(),
-        wide_size,
-        nullptr,
-        0,
-        nullptr,
-        nullptr);
-    if (utf8_size <= 0) {
-        throw std::runtime_error("Failed to calculate UTF-8 size for charset " + std::string(mapping.canonical));
-    }
-
-    std::string utf8(utf8_size, '\0');
-    if (WideCharToMultiByte(
-            CP_UTF8,
-            0,
-            wide.data(),
-            wide_size,
-            utf8.data(),
-            utf8_size,
-            nullptr,
-            nullptr) != utf8_size) {
-        throw std::runtime_error("Failed to convert UTF-16 to UTF-8 for charset " + std::string(mapping.canonical));
-    }
-    return utf8;
-#else
-    std::string iconv_name(mapping.iconv_name);
-    iconv_t     cd = iconv_open("UTF-8", iconv_name.c_str());
-    if (cd == reinterpret_cast<iconv_t>(-1)) {
-        throw std::runtime_error("Failed to open iconv for charset " + std::string(mapping.canonical));
+/**
+ * @brief 取预扫描范围内的前缀，截断时去掉被切开的末尾多字节序列
+ */
+[[nodiscard]] auto utf8_prescan_prefix(const std::string_view input) noexcept -> std::string_view {
+    if (input.size() <= kPrescanLength) {
+        return input;
+    }
+    std::string_view prefix = input.substr(0, kPrescanLength);
+    // 从末尾向前最多回看 3 字节，找到最后一个序列首字节并判断其是否完整
+    for (size_t back = 1; back <= 3; ++back) {
+        const auto byte = static_cast<unsigned char>(prefix[prefix.size() - back]);
+        if ((byte & 0xC0) == 0x80) {
+            continue;
+        }
+        const size_t length = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+        if (length > back) {
+            prefix.remove_suffix(back);
+        }
+        break;
     }
+    return prefix;
+}
+
+}  // namespace
 
-    size_t            in_bytes_left  = bytes.size();
-    size_t            out_bytes_left = std::max<size_t>(bytes.size() * 4, 32);
-    std::vector<char> out_buffer(out_bytes_left);
-    char*             in_ptr  = const_cast<char*>(bytes.data());
-    char*             out_ptr = out_buffer.data();
-    const size_t      result  = iconv(cd, &in_ptr, &in_bytes_left, &out_ptr, &out_bytes_left);
-    iconv_close(cd);
-    if (result == static_cast<size_t>(-1)) {
-        throw std::runtime_error("Failed to convert bytes from charset " + std::string(mapping.canonical));
+size_t ascii_prefix_length(const std::string_view input) noexcept {
+    const auto*  data  = reinterpret_cast<const unsigned char*>(input.data());
+    const size_t size  = input.size();
+    size_t       index = 0;
+#if HPS_ENCODING_X86_64
+    for (; index + 16 <= size; index += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+        if (const int mask = _mm_movemask_epi8(block); mask != 0) {
+            return index + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+        }
+    }
+#endif
+    for (; index + 8 <= size; index += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + index, sizeof(word));
+        if (const std::uint64_t high = word & 0x8080808080808080ULL; high != 0) {
+            if constexpr (std::endian::native == std::endian::little) {
+                return index + static_cast<size_t>(std::countr_zero(high)) / 8;
+            } else {
+                return index + static_cast<size_t>(std::countl_zero(high)) / 8;
+            }
+        }
     }
+    while (index < size && data[index] < 0x80) {
+        ++index;
+    }
+    return index;
+}
 
-    return std::string(out_buffer.data(), out_buffer.size() - out_bytes_left);
+bool is_valid_utf8(const std::string_view input) noexcept {
+#if HPS_ENCODING_X86_64
+    static const bool use_ssse3 = cpu_supports_ssse3();
+    if (use_ssse3) {
+        return is_valid_utf8_ssse3(input);
+    }
 #endif
+    return is_valid_utf8_scalar(input);
 }
 
-}  // namespace
+void decode_utf8_with_replacement(std::string_view bytes, std::string& out) {
+    // 分块校验：合法块整块追加（校验与复制在缓存中完成），含非法序列的块逐字节解码
+    constexpr size_t kChunkSize = 64 * 1024;
+
+    out.reserve(out.size() + bytes.size());
+    while (!bytes.empty()) {
+        std::string_view chunk = bytes.substr(0, kChunkSize);
+        if (chunk.size() < bytes.size()) {
+            // 块边界回退到序列首字节，避免切开多字节序列
+            size_t end = chunk.size();
+            for (size_t back = 0; back < 3 && (static_cast<unsigned char>(bytes[end]) & 0xC0) == 0x80; ++back) {
+                --end;
+            }
+            chunk = chunk.substr(0, end);
+        }
+        bytes.remove_prefix(chunk.size());
+        if (is_valid_utf8(chunk)) {
+            out.append(chunk);
+            continue;
+        }
 
-EncodingHint sniff_html_encoding(const std::string_view raw_bytes) {
+        // WHATWG UTF-8 解码：每个最长非法子序列替换为一个 U+FFFD
+        size_t index = 0;
+        while (index < chunk.size()) {
+            const auto   lead   = static_cast<unsigned char>(chunk[index]);
+            size_t       needed = 0;
+            unsigned int lower  = 0x80;
+            unsigned int upper  = 0xBF;
+            if (lead < 0x80) {
+                out.push_back(static_cast<char>(lead));
+                ++index;
+                continue;
+            }
+            if (lead >= 0xC2 && lead <= 0xDF) {
+                needed = 1;
+            } else if (lead >= 0xE0 && lead <= 0xEF) {
+                needed = 2;
+                lower  = lead == 0xE0 ? 0xA0 : 0x80;
+                upper  = lead == 0xED ? 0x9F : 0xBF;
+            } else if (lead >= 0xF0 && lead <= 0xF4) {
+                needed = 3;
+                lower  = lead == 0xF0 ? 0x90 : 0x80;
+                upper  = lead == 0xF4 ? 0x8F : 0xBF;
+            } else {
+                append_utf8(out, 0xFFFD);
+                ++index;
+                continue;
+            }
+
+            size_t seen = 1;
+            while (seen <= needed && index + seen < chunk.size()) {
+                const auto byte = static_cast<unsigned char>(chunk[index + seen]);
+                if (byte < lower || byte > upper) {
+                    break;
+                }
+                lower = 0x80;
+                upper = 0xBF;
+                ++seen;
+            }
+            if (seen == needed + 1) {
+                out.append(chunk.substr(index, seen));
+            } else {
+                append_utf8(out, 0xFFFD);
+            }
+            index += seen;
+        }
+    }
+}
+
+EncodingHint sniff_html_encoding(const std::string_view raw_bytes, const std::string_view transport_charset) {
     if (raw_bytes.empty()) {
         return {};
     }
@@ -507,11 +738,20 @@ EncodingHint sniff_html_encoding(const std::string_view raw_bytes) {
         };
     }
 
+    if (const std::string transport = normalize_encoding_label(transport_charset); !transport.empty()) {
+        return EncodingHint{
+            .detected_label   = std::string(trim_whitespace(transport_charset)),
+            .canonical_label  = transport,
+            .source           = EncodingHintSource::TransportCharset,
+            .helper_supported = is_helper_supported_encoding(transport),
+        };
+    }
+
     if (auto meta_hint = sniff_meta_charset(raw_bytes); meta_hint.has_encoding()) {
         return meta_hint;
     }
 
-    if (is_valid_utf8(raw_bytes)) {
+    if (is_valid_utf8(utf8_prescan_prefix(raw_bytes))) {
         return EncodingHint{
             .detected_label   = "utf-8",
             .canonical_label  = "utf-8",
@@ -555,11 +795,7 @@ std::optional<std::string> decode_html_bytes_to_utf8(
         bytes.remove_prefix(2);
     }
 
-    try {
-        return decode_code_page_to_utf8(bytes, *mapping);
-    } catch (const std::exception&) {
-        return std::nullopt;
-    }
+    return mapping->decode(bytes);
 }
 
 }  // namespace hps
@@ -0,0 +1,118 @@
+#include "hps/utils/error_summary.hpp"
+
+#include <algorithm>
+
+namespace hps {
+
+ErrorSummary::ErrorSummary(const size_t ring_capacity)
+    : m_ring(ring_capacity) {}
+
+void ErrorSummary::merge(const ErrorSummary& other) {
+    for (size_t i = 0; i < kErrorCodeCount; ++i) {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_total += other.m_total;
+    if (m_ring.empty()) {
+        return;
+    }
+
+    auto combined = recent();
+    auto incoming = other.recent();
+    combined.insert(combined.end(), incoming.begin(), incoming.end());
+    std::ranges::stable_sort(combined, {}, &CompactError::position);
+
+    const size_t keep = std::min(combined.size(), m_ring.size());
+    std::copy(combined.end() - static_cast<std::ptrdiff_t>(keep), combined.end(), m_ring.begin());
+    // 合并后缓冲区从头按偏移排列，写入计数只用于推算保留条数
+    m_next     = keep == m_ring.size() ? 0 : keep;
+    m_recorded = keep;
+}
+
+void ErrorSummary::clear() noexcept {
+    m_counts.fill(0);
+    m_next     = 0;
+    m_total    = 0;
+    m_recorded = 0;
+}
+
+std::vector<CompactError> ErrorSummary::recent() const {
+    std::vector<CompactError> result;
+    if (m_recorded <= m_ring.size()) {
+        result.assign(m_ring.begin(), m_ring.begin() + static_cast<std::ptrdiff_t>(m_recorded));
+        return result;
+    }
+    result.reserve(m_ring.size());
+    result.insert(result.end(), m_ring.begin() + static_cast<std::ptrdiff_t>(m_next), m_ring.end());
+    result.insert(result.end(), m_ring.begin(), m_ring.begin() + static_cast<std::ptrdiff_t>(m_next));
+    return result;
+}
+
+size_t ErrorSummary::dropped() const noexcept {
+    return m_total - std::min(m_recorded, m_ring.size());
+}
+
+std::string_view error_code_description(const ErrorCode code) noexcept {
+    switch (code) {
+        case ErrorCode::Success:
+            return "Success";
+        case ErrorCode::UnknownError:
+            return "Unknown error";
+        case ErrorCode::OutOfMemory:
+            return "Out of memory";
+        case ErrorCode::UnexpectedEOF:
+            return "Unexpected EOF";
+        case ErrorCode::InvalidCharacter:
+            return "Invalid character";
+        case ErrorCode::InvalidToken:
+            return "Invalid token";
+        case ErrorCode::InvalidEntity:
+            return "Invalid entity";
+        case ErrorCode::InvalidNesting:
+            return "Invalid nesting";
+        case ErrorCode::UnclosedTag:
+            return "Unclosed tag";
+        case ErrorCode::VoidElementClose:
+            return "Void element closed";
+        case ErrorCode::MismatchedTag:
+            return "Mismatched tag";
+        case ErrorCode::TooManyElements:
+            return "Too many elements";
+        case ErrorCode::TooManyAttributes:
+            return "Too many attributes";
+        case ErrorCode::TooDeep:
+            return "Nesting depth limit exceeded";
+        case ErrorCode::AttributeTooLong:
+            return "Attribute too long";
+        case ErrorCode::TextTooLong:
+            return "Text too long";
+        case ErrorCode::InvalidHTML:
+            return "Invalid HTML";
+        case ErrorCode::ParseTimeout:
+            return "Parse timeout";
+        case ErrorCode::ParseCancelled:
+            return "Parse cancelled";
+        case ErrorCode::QuirksMode:
+            return "Quirks mode";
+        case ErrorCode::FileReadError:
+            return "File read error";
+        case ErrorCode::FileWriteError:
+            return "File write error";
+        case ErrorCode::UnsupportedEncoding:
+            return "Unsupported encoding";
+        case ErrorCode::InvalidSelector:
+            return "Invalid selector";
+        case ErrorCode::InvalidXPath:
+            return "Invalid XPath";
+        case ErrorCode::XPathParseError:
+            return "XPath parse error";
+        case ErrorCode::XPathEvaluationError:
+            return "XPath evaluation error";
+        case ErrorCode::InvalidSnapshot:
+            return "Invalid snapshot";
+        case ErrorCode::InvalidArchive:
+            return "Invalid archive";
+    }
+    return "Unknown error";
+}
+
+}  // namespace hps
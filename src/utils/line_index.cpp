@@ -0,0 +1,50 @@
+#include "hps/utils/line_index.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace hps {
+
+LineIndex::LineIndex(const std::string_view source) noexcept
+    : m_source(source),
+      m_size(source.size()) {}
+
+Location LineIndex::locate(const size_t position) const {
+    if (m_line_starts.empty()) {
+        build();
+    }
+
+    const size_t clamped_position = std::min(position, m_size);
+    const auto   line_start       = std::prev(std::upper_bound(m_line_starts.begin(), m_line_starts.end(), clamped_position));
+    const auto   line             = static_cast<size_t>(line_start - m_line_starts.begin()) + 1;
+    return Location(clamped_position, line, clamped_position - *line_start + 1);
+}
+
+void LineIndex::resolve(Location& location) const {
+    if (!location.resolved()) {
+        location = locate(location.position);
+    }
+}
+
+void LineIndex::release_source() {
+    if (m_line_starts.empty()) {
+        build();
+    }
+    m_source = {};
+}
+
+void LineIndex::build() const {
+    m_line_starts.push_back(0);
+    const char* data = m_source.data();
+    size_t      pos  = 0;
+    while (pos < m_source.size()) {
+        const void* found = std::memchr(data + pos, '\n', m_source.size() - pos);
+        if (found == nullptr) {
+            break;
+        }
+        pos = static_cast<size_t>(static_cast<const char*>(found) - data) + 1;
+        m_line_starts.push_back(pos);
+    }
+}
+
+}  // namespace hps
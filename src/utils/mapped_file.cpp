@@ -0,0 +1,141 @@
+#include "hps/utils/mapped_file.hpp"
+
+#include "hps/utils/exception.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hps {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    m_file_handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file_handle == INVALID_HANDLE_VALUE) {
+        m_file_handle = nullptr;
+        throw HPSException(ErrorCode::FileReadError, "Cannot open file: " + path.string());
+    }
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(m_file_handle, &file_size)) {
+        release();
+        throw HPSException(ErrorCode::FileReadError, "Cannot stat file: " + path.string());
+    }
+    m_size = static_cast<size_t>(file_size.QuadPart);
+    if (m_size == 0) {
+        return;
+    }
+    m_mapping_handle = CreateFileMappingW(m_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping_handle == nullptr) {
+        release();
+        throw HPSException(ErrorCode::FileReadError, "Cannot map file: " + path.string());
+    }
+    m_data = MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (m_data == nullptr) {
+        release();
+        throw HPSException(ErrorCode::FileReadError, "Cannot map file: " + path.string());
+    }
+}
+
+void MappedFile::release() noexcept {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping_handle != nullptr) {
+        CloseHandle(m_mapping_handle);
+    }
+    if (m_file_handle != nullptr) {
+        CloseHandle(m_file_handle);
+    }
+    m_data           = nullptr;
+    m_size           = 0;
+    m_mapping_handle = nullptr;
+    m_file_handle    = nullptr;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)),
+      m_size(std::exchange(other.m_size, 0)),
+      m_file_handle(std::exchange(other.m_file_handle, nullptr)),
+      m_mapping_handle(std::exchange(other.m_mapping_handle, nullptr)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_data           = std::exchange(other.m_data, nullptr);
+        m_size           = std::exchange(other.m_size, 0);
+        m_file_handle    = std::exchange(other.m_file_handle, nullptr);
+        m_mapping_handle = std::exchange(other.m_mapping_handle, nullptr);
+    }
+    return *this;
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw HPSException(ErrorCode::FileReadError, "Cannot open file: " + path.string());
+    }
+    struct stat file_stat{};
+    if (::fstat(fd, &file_stat) != 0) {
+        ::close(fd);
+        throw HPSException(ErrorCode::FileReadError, "Cannot stat file: " + path.string());
+    }
+    m_size = static_cast<size_t>(file_stat.st_size);
+    if (m_size == 0) {
+        ::close(fd);
+        return;
+    }
+    void* mapped = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // 映射建立后即可关闭描述符，映射本身保持有效
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        m_size = 0;
+        throw HPSException(ErrorCode::FileReadError, "Cannot map file: " + path.string());
+    }
+    m_data = mapped;
+}
+
+void MappedFile::release() noexcept {
+    if (m_data != nullptr) {
+        ::munmap(const_cast<void*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)),
+      m_size(std::exchange(other.m_size, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+std::shared_ptr<const MappedFile> MappedFile::open_shared(const std::filesystem::path& path) {
+    return std::make_shared<const MappedFile>(path);
+}
+
+}  // namespace hps
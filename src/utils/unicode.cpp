@@ -0,0 +1,5951 @@
+#include "hps/utils/unicode.hpp"
+
+#include "hps/utils/encoding.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace hps {
+
+namespace {
+
+struct CodePointRange {
+    char32_t first;
+    char32_t last;
+};
+
+struct CombiningClassRange {
+    char32_t     first;
+    char32_t     last;
+    std::uint8_t combining_class;
+};
+
+struct MappingEntry {
+    char32_t      code_point;
+    std::uint16_t offset;
+    std::uint8_t  length;
+};
+
+struct CompositionPair {
+    char32_t first;
+    char32_t second;
+    char32_t composite;
+};
+
+// 以下数据表由 Unicode 14.0 字符数据库（UnicodeData.txt、CompositionExclusions.txt、CaseFolding.txt）生成，请勿手工修改。
+
+// ==================== 生成的数据表（Unicode 14.0） ====================
+
+// 组合类别（Canonical_Combining_Class 非 0 的区间）
+constexpr std::array<CombiningClassRange, 382> kCombiningClassRanges = {{
+    {0x0300, 0x0314, 230},
+    {0x0315, 0x0315, 232},
+    {0x0316, 0x0319, 220},
+    {0x031A, 0x031A, 232},
+    {0x031B, 0x031B, 216},
+    {0x031C, 0x0320, 220},
+    {0x0321, 0x0322, 202},
+    {0x0323, 0x0326, 220},
+    {0x0327, 0x0328, 202},
+    {0x0329, 0x0333, 220},
+    {0x0334, 0x0338, 1},
+    {0x0339, 0x033C, 220},
+    {0x033D, 0x0344, 230},
+    {0x0345, 0x0345, 240},
+    {0x0346, 0x0346, 230},
+    {0x0347, 0x0349, 220},
+    {0x034A, 0x034C, 230},
+    {0x034D, 0x034E, 220},
+    {0x0350, 0x0352, 230},
+    {0x0353, 0x0356, 220},
+    {0x0357, 0x0357, 230},
+    {0x0358, 0x0358, 232},
+    {0x0359, 0x035A, 220},
+    {0x035B, 0x035B, 230},
+    {0x035C, 0x035C, 233},
+    {0x035D, 0x035E, 234},
+    {0x035F, 0x035F, 233},
+    {0x0360, 0x0361, 234},
+    {0x0362, 0x0362, 233},
+    {0x0363, 0x036F, 230},
+    {0x0483, 0x0487, 230},
+    {0x0591, 0x0591, 220},
+    {0x0592, 0x0595, 230},
+    {0x0596, 0x0596, 220},
+    {0x0597, 0x0599, 230},
+    {0x059A, 0x059A, 222},
+    {0x059B, 0x059B, 220},
+    {0x059C, 0x05A1, 230},
+    {0x05A2, 0x05A7, 220},
+    {0x05A8, 0x05A9, 230},
+    {0x05AA, 0x05AA, 220},
+    {0x05AB, 0x05AC, 230},
+    {0x05AD, 0x05AD, 222},
+    {0x05AE, 0x05AE, 228},
+    {0x05AF, 0x05AF, 230},
+    {0x05B0, 0x05B0, 10},
+    {0x05B1, 0x05B1, 11},
+    {0x05B2, 0x05B2, 12},
+    {0x05B3, 0x05B3, 13},
+    {0x05B4, 0x05B4, 14},
+    {0x05B5, 0x05B5, 15},
+    {0x05B6, 0x05B6, 16},
+    {0x05B7, 0x05B7, 17},
+    {0x05B8, 0x05B8, 18},
+    {0x05B9, 0x05BA, 19},
+    {0x05BB, 0x05BB, 20},
+    {0x05BC, 0x05BC, 21},
+    {0x05BD, 0x05BD, 22},
+    {0x05BF, 0x05BF, 23},
+    {0x05C1, 0x05C1, 24},
+    {0x05C2, 0x05C2, 25},
+    {0x05C4, 0x05C4, 230},
+    {0x05C5, 0x05C5, 220},
+    {0x05C7, 0x05C7, 18},
+    {0x0610, 0x0617, 230},
+    {0x0618, 0x0618, 30},
+    {0x0619, 0x0619, 31},
+    {0x061A, 0x061A, 32},
+    {0x064B, 0x064B, 27},
+    {0x064C, 0x064C, 28},
+    {0x064D, 0x064D, 29},
+    {0x064E, 0x064E, 30},
+    {0x064F, 0x064F, 31},
+    {0x0650, 0x0650, 32},
+    {0x0651, 0x0651, 33},
+    {0x0652, 0x0652, 34},
+    {0x0653, 0x0654, 230},
+    {0x0655, 0x0656, 220},
+    {0x0657, 0x065B, 230},
+    {0x065C, 0x065C, 220},
+    {0x065D, 0x065E, 230},
+    {0x065F, 0x065F, 220},
+    {0x0670, 0x0670, 35},
+    {0x06D6, 0x06DC, 230},
+    {0x06DF, 0x06E2, 230},
+    {0x06E3, 0x06E3, 220},
+    {0x06E4, 0x06E4, 230},
+    {0x06E7, 0x06E8, 230},
+    {0x06EA, 0x06EA, 220},
+    {0x06EB, 0x06EC, 230},
+    {0x06ED, 0x06ED, 220},
+    {0x0711, 0x0711, 36},
+    {0x0730, 0x0730, 230},
+    {0x0731, 0x0731, 220},
+    {0x0732, 0x0733, 230},
+    {0x0734, 0x0734, 220},
+    {0x0735, 0x0736, 230},
+    {0x0737, 0x0739, 220},
+    {0x073A, 0x073A, 230},
+    {0x073B, 0x073C, 220},
+    {0x073D, 0x073D, 230},
+    {0x073E, 0x073E, 220},
+    {0x073F, 0x0741, 230},
+    {0x0742, 0x0742, 220},
+    {0x0743, 0x0743, 230},
+    {0x0744, 0x0744, 220},
+    {0x0745, 0x0745, 230},
+    {0x0746, 0x0746, 220},
+    {0x0747, 0x0747, 230},
+    {0x0748, 0x0748, 220},
+    {0x0749, 0x074A, 230},
+    {0x07EB, 0x07F1, 230},
+    {0x07F2, 0x07F2, 220},
+    {0x07F3, 0x07F3, 230},
+    {0x07FD, 0x07FD, 220},
+    {0x0816, 0x0819, 230},
+    {0x081B, 0x0823, 230},
+    {0x0825, 0x0827, 230},
+    {0x0829, 0x082D, 230},
+    {0x0859, 0x085B, 220},
+    {0x0898, 0x0898, 230},
+    {0x0899, 0x089B, 220},
+    {0x089C, 0x089F, 230},
+    {0x08CA, 0x08CE, 230},
+    {0x08CF, 0x08D3, 220},
+    {0x08D4, 0x08E1, 230},
+    {0x08E3, 0x08E3, 220},
+    {0x08E4, 0x08E5, 230},
+    {0x08E6, 0x08E6, 220},
+    {0x08E7, 0x08E8, 230},
+    {0x08E9, 0x08E9, 220},
+    {0x08EA, 0x08EC, 230},
+    {0x08ED, 0x08EF, 220},
+    {0x08F0, 0x08F0, 27},
+    {0x08F1, 0x08F1, 28},
+    {0x08F2, 0x08F2, 29},
+    {0x08F3, 0x08F5, 230},
+    {0x08F6, 0x08F6, 220},
+    {0x08F7, 0x08F8, 230},
+    {0x08F9, 0x08FA, 220},
+    {0x08FB, 0x08FF, 230},
+    {0x093C, 0x093C, 7},
+    {0x094D, 0x094D, 9},
+    {0x0951, 0x0951, 230},
+    {0x0952, 0x0952, 220},
+    {0x0953, 0x0954, 230},
+    {0x09BC, 0x09BC, 7},
+    {0x09CD, 0x09CD, 9},
+    {0x09FE, 0x09FE, 230},
+    {0x0A3C, 0x0A3C, 7},
+    {0x0A4D, 0x0A4D, 9},
+    {0x0ABC, 0x0ABC, 7},
+    {0x0ACD, 0x0ACD, 9},
+    {0x0B3C, 0x0B3C, 7},
+    {0x0B4D, 0x0B4D, 9},
+    {0x0BCD, 0x0BCD, 9},
+    {0x0C3C, 0x0C3C, 7},
+    {0x0C4D, 0x0C4D, 9},
+    {0x0C55, 0x0C55, 84},
+    {0x0C56, 0x0C56, 91},
+    {0x0CBC, 0x0CBC, 7},
+    {0x0CCD, 0x0CCD, 9},
+    {0x0D3B, 0x0D3C, 9},
+    {0x0D4D, 0x0D4D, 9},
+    {0x0DCA, 0x0DCA, 9},
+    {0x0E38, 0x0E39, 103},
+    {0x0E3A, 0x0E3A, 9},
+    {0x0E48, 0x0E4B, 107},
+    {0x0EB8, 0x0EB9, 118},
+    {0x0EBA, 0x0EBA, 9},
+    {0x0EC8, 0x0ECB, 122},
+    {0x0F18, 0x0F19, 220},
+    {0x0F35, 0x0F35, 220},
+    {0x0F37, 0x0F37, 220},
+    {0x0F39, 0x0F39, 216},
+    {0x0F71, 0x0F71, 129},
+    {0x0F72, 0x0F72, 130},
+    {0x0F74, 0x0F74, 132},
+    {0x0F7A, 0x0F7D, 130},
+    {0x0F80, 0x0F80, 130},
+    {0x0F82, 0x0F83, 230},
+    {0x0F84, 0x0F84, 9},
+    {0x0F86, 0x0F87, 230},
+    {0x0FC6, 0x0FC6, 220},
+    {0x1037, 0x1037, 7},
+    {0x1039, 0x103A, 9},
+    {0x108D, 0x108D, 220},
+    {0x135D, 0x135F, 230},
+    {0x1714, 0x1715, 9},
+    {0x1734, 0x1734, 9},
+    {0x17D2, 0x17D2, 9},
+    {0x17DD, 0x17DD, 230},
+    {0x18A9, 0x18A9, 228},
+    {0x1939, 0x1939, 222},
+    {0x193A, 0x193A, 230},
+    {0x193B, 0x193B, 220},
+    {0x1A17, 0x1A17, 230},
+    {0x1A18, 0x1A18, 220},
+    {0x1A60, 0x1A60, 9},
+    {0x1A75, 0x1A7C, 230},
+    {0x1A7F, 0x1A7F, 220},
+    {0x1AB0, 0x1AB4, 230},
+    {0x1AB5, 0x1ABA, 220},
+    {0x1ABB, 0x1ABC, 230},
+    {0x1ABD, 0x1ABD, 220},
+    {0x1ABF, 0x1AC0, 220},
+    {0x1AC1, 0x1AC2, 230},
+    {0x1AC3, 0x1AC4, 220},
+    {0x1AC5, 0x1AC9, 230},
+    {0x1ACA, 0x1ACA, 220},
+    {0x1ACB, 0x1ACE, 230},
+    {0x1B34, 0x1B34, 7},
+    {0x1B44, 0x1B44, 9},
+    {0x1B6B, 0x1B6B, 230},
+    {0x1B6C, 0x1B6C, 220},
+    {0x1B6D, 0x1B73, 230},
+    {0x1BAA, 0x1BAB, 9},
+    {0x1BE6, 0x1BE6, 7},
+    {0x1BF2, 0x1BF3, 9},
+    {0x1C37, 0x1C37, 7},
+    {0x1CD0, 0x1CD2, 230},
+    {0x1CD4, 0x1CD4, 1},
+    {0x1CD5, 0x1CD9, 220},
+    {0x1CDA, 0x1CDB, 230},
+    {0x1CDC, 0x1CDF, 220},
+    {0x1CE0, 0x1CE0, 230},
+    {0x1CE2, 0x1CE8, 1},
+    {0x1CED, 0x1CED, 220},
+    {0x1CF4, 0x1CF4, 230},
+    {0x1CF8, 0x1CF9, 230},
+    {0x1DC0, 0x1DC1, 230},
+    {0x1DC2, 0x1DC2, 220},
+    {0x1DC3, 0x1DC9, 230},
+    {0x1DCA, 0x1DCA, 220},
+    {0x1DCB, 0x1DCC, 230},
+    {0x1DCD, 0x1DCD, 234},
+    {0x1DCE, 0x1DCE, 214},
+    {0x1DCF, 0x1DCF, 220},
+    {0x1DD0, 0x1DD0, 202},
+    {0x1DD1, 0x1DF5, 230},
+    {0x1DF6, 0x1DF6, 232},
+    {0x1DF7, 0x1DF8, 228},
+    {0x1DF9, 0x1DF9, 220},
+    {0x1DFA, 0x1DFA, 218},
+    {0x1DFB, 0x1DFB, 230},
+    {0x1DFC, 0x1DFC, 233},
+    {0x1DFD, 0x1DFD, 220},
+    {0x1DFE, 0x1DFE, 230},
+    {0x1DFF, 0x1DFF, 220},
+    {0x20D0, 0x20D1, 230},
+    {0x20D2, 0x20D3, 1},
+    {0x20D4, 0x20D7, 230},
+    {0x20D8, 0x20DA, 1},
+    {0x20DB, 0x20DC, 230},
+    {0x20E1, 0x20E1, 230},
+    {0x20E5, 0x20E6, 1},
+    {0x20E7, 0x20E7, 230},
+    {0x20E8, 0x20E8, 220},
+    {0x20E9, 0x20E9, 230},
+    {0x20EA, 0x20EB, 1},
+    {0x20EC, 0x20EF, 220},
+    {0x20F0, 0x20F0, 230},
+    {0x2CEF, 0x2CF1, 230},
+    {0x2D7F, 0x2D7F, 9},
+    {0x2DE0, 0x2DFF, 230},
+    {0x302A, 0x302A, 218},
+    {0x302B, 0x302B, 228},
+    {0x302C, 0x302C, 232},
+    {0x302D, 0x302D, 222},
+    {0x302E, 0x302F, 224},
+    {0x3099, 0x309A, 8},
+    {0xA66F, 0xA66F, 230},
+    {0xA674, 0xA67D, 230},
+    {0xA69E, 0xA69F, 230},
+    {0xA6F0, 0xA6F1, 230},
+    {0xA806, 0xA806, 9},
+    {0xA82C, 0xA82C, 9},
+    {0xA8C4, 0xA8C4, 9},
+    {0xA8E0, 0xA8F1, 230},
+    {0xA92B, 0xA92D, 220},
+    {0xA953, 0xA953, 9},
+    {0xA9B3, 0xA9B3, 7},
+    {0xA9C0, 0xA9C0, 9},
+    {0xAAB0, 0xAAB0, 230},
+    {0xAAB2, 0xAAB3, 230},
+    {0xAAB4, 0xAAB4, 220},
+    {0xAAB7, 0xAAB8, 230},
+    {0xAABE, 0xAABF, 230},
+    {0xAAC1, 0xAAC1, 230},
+    {0xAAF6, 0xAAF6, 9},
+    {0xABED, 0xABED, 9},
+    {0xFB1E, 0xFB1E, 26},
+    {0xFE20, 0xFE26, 230},
+    {0xFE27, 0xFE2D, 220},
+    {0xFE2E, 0xFE2F, 230},
+    {0x101FD, 0x101FD, 220},
+    {0x102E0, 0x102E0, 220},
+    {0x10376, 0x1037A, 230},
+    {0x10A0D, 0x10A0D, 220},
+    {0x10A0F, 0x10A0F, 230},
+    {0x10A38, 0x10A38, 230},
+    {0x10A39, 0x10A39, 1},
+    {0x10A3A, 0x10A3A, 220},
+    {0x10A3F, 0x10A3F, 9},
+    {0x10AE5, 0x10AE5, 230},
+    {0x10AE6, 0x10AE6, 220},
+    {0x10D24, 0x10D27, 230},
+    {0x10EAB, 0x10EAC, 230},
+    {0x10F46, 0x10F47, 220},
+    {0x10F48, 0x10F4A, 230},
+    {0x10F4B, 0x10F4B, 220},
+    {0x10F4C, 0x10F4C, 230},
+    {0x10F4D, 0x10F50, 220},
+    {0x10F82, 0x10F82, 230},
+    {0x10F83, 0x10F83, 220},
+    {0x10F84, 0x10F84, 230},
+    {0x10F85, 0x10F85, 220},
+    {0x11046, 0x11046, 9},
+    {0x11070, 0x11070, 9},
+    {0x1107F, 0x1107F, 9},
+    {0x110B9, 0x110B9, 9},
+    {0x110BA, 0x110BA, 7},
+    {0x11100, 0x11102, 230},
+    {0x11133, 0x11134, 9},
+    {0x11173, 0x11173, 7},
+    {0x111C0, 0x111C0, 9},
+    {0x111CA, 0x111CA, 7},
+    {0x11235, 0x11235, 9},
+    {0x11236, 0x11236, 7},
+    {0x112E9, 0x112E9, 7},
+    {0x112EA, 0x112EA, 9},
+    {0x1133B, 0x1133C, 7},
+    {0x1134D, 0x1134D, 9},
+    {0x11366, 0x1136C, 230},
+    {0x11370, 0x11374, 230},
+    {0x11442, 0x11442, 9},
+    {0x11446, 0x11446, 7},
+    {0x1145E, 0x1145E, 230},
+    {0x114C2, 0x114C2, 9},
+    {0x114C3, 0x114C3, 7},
+    {0x115BF, 0x115BF, 9},
+    {0x115C0, 0x115C0, 7},
+    {0x1163F, 0x1163F, 9},
+    {0x116B6, 0x116B6, 9},
+    {0x116B7, 0x116B7, 7},
+    {0x1172B, 0x1172B, 9},
+    {0x11839, 0x11839, 9},
+    {0x1183A, 0x1183A, 7},
+    {0x1193D, 0x1193E, 9},
+    {0x11943, 0x11943, 7},
+    {0x119E0, 0x119E0, 9},
+    {0x11A34, 0x11A34, 9},
+    {0x11A47, 0x11A47, 9},
+    {0x11A99, 0x11A99, 9},
+    {0x11C3F, 0x11C3F, 9},
+    {0x11D42, 0x11D42, 7},
+    {0x11D44, 0x11D45, 9},
+    {0x11D97, 0x11D97, 9},
+    {0x16AF0, 0x16AF4, 1},
+    {0x16B30, 0x16B36, 230},
+    {0x16FF0, 0x16FF1, 6},
+    {0x1BC9E, 0x1BC9E, 1},
+    {0x1D165, 0x1D166, 216},
+    {0x1D167, 0x1D169, 1},
+    {0x1D16D, 0x1D16D, 226},
+    {0x1D16E, 0x1D172, 216},
+    {0x1D17B, 0x1D182, 220},
+    {0x1D185, 0x1D189, 230},
+    {0x1D18A, 0x1D18B, 220},
+    {0x1D1AA, 0x1D1AD, 230},
+    {0x1D242, 0x1D244, 230},
+    {0x1E000, 0x1E006, 230},
+    {0x1E008, 0x1E018, 230},
+    {0x1E01B, 0x1E021, 230},
+    {0x1E023, 0x1E024, 230},
+    {0x1E026, 0x1E02A, 230},
+    {0x1E130, 0x1E136, 230},
+    {0x1E2AE, 0x1E2AE, 230},
+    {0x1E2EC, 0x1E2EF, 230},
+    {0x1E8D0, 0x1E8D6, 220},
+    {0x1E944, 0x1E949, 230},
+    {0x1E94A, 0x1E94A, 7},
+}};
+
+// NFC 快速检查不通过的码位区间：组合字符、可能与前一字符组合的字符以及 NFC 下会被替换的字符
+constexpr std::array<CodePointRange, 274> kNfcUnsafeRanges = {{
+    {0x0300, 0x034E},
+    {0x0350, 0x036F},
+    {0x0374, 0x0374},
+    {0x037E, 0x037E},
+    {0x0387, 0x0387},
+    {0x0483, 0x0487},
+    {0x0591, 0x05BD},
+    {0x05BF, 0x05BF},
+    {0x05C1, 0x05C2},
+    {0x05C4, 0x05C5},
+    {0x05C7, 0x05C7},
+    {0x0610, 0x061A},
+    {0x064B, 0x065F},
+    {0x0670, 0x0670},
+    {0x06D6, 0x06DC},
+    {0x06DF, 0x06E4},
+    {0x06E7, 0x06E8},
+    {0x06EA, 0x06ED},
+    {0x0711, 0x0711},
+    {0x0730, 0x074A},
+    {0x07EB, 0x07F3},
+    {0x07FD, 0x07FD},
+    {0x0816, 0x0819},
+    {0x081B, 0x0823},
+    {0x0825, 0x0827},
+    {0x0829, 0x082D},
+    {0x0859, 0x085B},
+    {0x0898, 0x089F},
+    {0x08CA, 0x08E1},
+    {0x08E3, 0x08FF},
+    {0x093C, 0x093C},
+    {0x094D, 0x094D},
+    {0x0951, 0x0954},
+    {0x0958, 0x095F},
+    {0x09BC, 0x09BC},
+    {0x09BE, 0x09BE},
+    {0x09CD, 0x09CD},
+    {0x09D7, 0x09D7},
+    {0x09DC, 0x09DD},
+    {0x09DF, 0x09DF},
+    {0x09FE, 0x09FE},
+    {0x0A33, 0x0A33},
+    {0x0A36, 0x0A36},
+    {0x0A3C, 0x0A3C},
+    {0x0A4D, 0x0A4D},
+    {0x0A59, 0x0A5B},
+    {0x0A5E, 0x0A5E},
+    {0x0ABC, 0x0ABC},
+    {0x0ACD, 0x0ACD},
+    {0x0B3C, 0x0B3C},
+    {0x0B3E, 0x0B3E},
+    {0x0B4D, 0x0B4D},
+    {0x0B56, 0x0B57},
+    {0x0B5C, 0x0B5D},
+    {0x0BBE, 0x0BBE},
+    {0x0BCD, 0x0BCD},
+    {0x0BD7, 0x0BD7},
+    {0x0C3C, 0x0C3C},
+    {0x0C4D, 0x0C4D},
+    {0x0C55, 0x0C56},
+    {0x0CBC, 0x0CBC},
+    {0x0CC2, 0x0CC2},
+    {0x0CCD, 0x0CCD},
+    {0x0CD5, 0x0CD6},
+    {0x0D3B, 0x0D3C},
+    {0x0D3E, 0x0D3E},
+    {0x0D4D, 0x0D4D},
+    {0x0D57, 0x0D57},
+    {0x0DCA, 0x0DCA},
+    {0x0DCF, 0x0DCF},
+    {0x0DDF, 0x0DDF},
+    {0x0E38, 0x0E3A},
+    {0x0E48, 0x0E4B},
+    {0x0EB8, 0x0EBA},
+    {0x0EC8, 0x0ECB},
+    {0x0F18, 0x0F19},
+    {0x0F35, 0x0F35},
+    {0x0F37, 0x0F37},
+    {0x0F39, 0x0F39},
+    {0x0F43, 0x0F43},
+    {0x0F4D, 0x0F4D},
+    {0x0F52, 0x0F52},
+    {0x0F57, 0x0F57},
+    {0x0F5C, 0x0F5C},
+    {0x0F69, 0x0F69},
+    {0x0F71, 0x0F76},
+    {0x0F78, 0x0F78},
+    {0x0F7A, 0x0F7D},
+    {0x0F80, 0x0F84},
+    {0x0F86, 0x0F87},
+    {0x0F93, 0x0F93},
+    {0x0F9D, 0x0F9D},
+    {0x0FA2, 0x0FA2},
+    {0x0FA7, 0x0FA7},
+    {0x0FAC, 0x0FAC},
+    {0x0FB9, 0x0FB9},
+    {0x0FC6, 0x0FC6},
+    {0x102E, 0x102E},
+    {0x1037, 0x1037},
+    {0x1039, 0x103A},
+    {0x108D, 0x108D},
+    {0x1161, 0x1175},
+    {0x11A8, 0x11C2},
+    {0x135D, 0x135F},
+    {0x1714, 0x1715},
+    {0x1734, 0x1734},
+    {0x17D2, 0x17D2},
+    {0x17DD, 0x17DD},
+    {0x18A9, 0x18A9},
+    {0x1939, 0x193B},
+    {0x1A17, 0x1A18},
+    {0x1A60, 0x1A60},
+    {0x1A75, 0x1A7C},
+    {0x1A7F, 0x1A7F},
+    {0x1AB0, 0x1ABD},
+    {0x1ABF, 0x1ACE},
+    {0x1B34, 0x1B35},
+    {0x1B44, 0x1B44},
+    {0x1B6B, 0x1B73},
+    {0x1BAA, 0x1BAB},
+    {0x1BE6, 0x1BE6},
+    {0x1BF2, 0x1BF3},
+    {0x1C37, 0x1C37},
+    {0x1CD0, 0x1CD2},
+    {0x1CD4, 0x1CE0},
+    {0x1CE2, 0x1CE8},
+    {0x1CED, 0x1CED},
+    {0x1CF4, 0x1CF4},
+    {0x1CF8, 0x1CF9},
+    {0x1DC0, 0x1DFF},
+    {0x1F71, 0x1F71},
+    {0x1F73, 0x1F73},
+    {0x1F75, 0x1F75},
+    {0x1F77, 0x1F77},
+    {0x1F79, 0x1F79},
+    {0x1F7B, 0x1F7B},
+    {0x1F7D, 0x1F7D},
+    {0x1FBB, 0x1FBB},
+    {0x1FBE, 0x1FBE},
+    {0x1FC9, 0x1FC9},
+    {0x1FCB, 0x1FCB},
+    {0x1FD3, 0x1FD3},
+    {0x1FDB, 0x1FDB},
+    {0x1FE3, 0x1FE3},
+    {0x1FEB, 0x1FEB},
+    {0x1FEE, 0x1FEF},
+    {0x1FF9, 0x1FF9},
+    {0x1FFB, 0x1FFB},
+    {0x1FFD, 0x1FFD},
+    {0x2000, 0x2001},
+    {0x20D0, 0x20DC},
+    {0x20E1, 0x20E1},
+    {0x20E5, 0x20F0},
+    {0x2126, 0x2126},
+    {0x212A, 0x212B},
+    {0x2329, 0x232A},
+    {0x2ADC, 0x2ADC},
+    {0x2CEF, 0x2CF1},
+    {0x2D7F, 0x2D7F},
+    {0x2DE0, 0x2DFF},
+    {0x302A, 0x302F},
+    {0x3099, 0x309A},
+    {0xA66F, 0xA66F},
+    {0xA674, 0xA67D},
+    {0xA69E, 0xA69F},
+    {0xA6F0, 0xA6F1},
+    {0xA806, 0xA806},
+    {0xA82C, 0xA82C},
+    {0xA8C4, 0xA8C4},
+    {0xA8E0, 0xA8F1},
+    {0xA92B, 0xA92D},
+    {0xA953, 0xA953},
+    {0xA9B3, 0xA9B3},
+    {0xA9C0, 0xA9C0},
+    {0xAAB0, 0xAAB0},
+    {0xAAB2, 0xAAB4},
+    {0xAAB7, 0xAAB8},
+    {0xAABE, 0xAABF},
+    {0xAAC1, 0xAAC1},
+    {0xAAF6, 0xAAF6},
+    {0xABED, 0xABED},
+    {0xF900, 0xFA0D},
+    {0xFA10, 0xFA10},
+    {0xFA12, 0xFA12},
+    {0xFA15, 0xFA1E},
+    {0xFA20, 0xFA20},
+    {0xFA22, 0xFA22},
+    {0xFA25, 0xFA26},
+    {0xFA2A, 0xFA6D},
+    {0xFA70, 0xFAD9},
+    {0xFB1D, 0xFB1F},
+    {0xFB2A, 0xFB36},
+    {0xFB38, 0xFB3C},
+    {0xFB3E, 0xFB3E},
+    {0xFB40, 0xFB41},
+    {0xFB43, 0xFB44},
+    {0xFB46, 0xFB4E},
+    {0xFE20, 0xFE2F},
+    {0x101FD, 0x101FD},
+    {0x102E0, 0x102E0},
+    {0x10376, 0x1037A},
+    {0x10A0D, 0x10A0D},
+    {0x10A0F, 0x10A0F},
+    {0x10A38, 0x10A3A},
+    {0x10A3F, 0x10A3F},
+    {0x10AE5, 0x10AE6},
+    {0x10D24, 0x10D27},
+    {0x10EAB, 0x10EAC},
+    {0x10F46, 0x10F50},
+    {0x10F82, 0x10F85},
+    {0x11046, 0x11046},
+    {0x11070, 0x11070},
+    {0x1107F, 0x1107F},
+    {0x110B9, 0x110BA},
+    {0x11100, 0x11102},
+    {0x11127, 0x11127},
+    {0x11133, 0x11134},
+    {0x11173, 0x11173},
+    {0x111C0, 0x111C0},
+    {0x111CA, 0x111CA},
+    {0x11235, 0x11236},
+    {0x112E9, 0x112EA},
+    {0x1133B, 0x1133C},
+    {0x1133E, 0x1133E},
+    {0x1134D, 0x1134D},
+    {0x11357, 0x11357},
+    {0x11366, 0x1136C},
+    {0x11370, 0x11374},
+    {0x11442, 0x11442},
+    {0x11446, 0x11446},
+    {0x1145E, 0x1145E},
+    {0x114B0, 0x114B0},
+    {0x114BA, 0x114BA},
+    {0x114BD, 0x114BD},
+    {0x114C2, 0x114C3},
+    {0x115AF, 0x115AF},
+    {0x115BF, 0x115C0},
+    {0x1163F, 0x1163F},
+    {0x116B6, 0x116B7},
+    {0x1172B, 0x1172B},
+    {0x11839, 0x1183A},
+    {0x11930, 0x11930},
+    {0x1193D, 0x1193E},
+    {0x11943, 0x11943},
+    {0x119E0, 0x119E0},
+    {0x11A34, 0x11A34},
+    {0x11A47, 0x11A47},
+    {0x11A99, 0x11A99},
+    {0x11C3F, 0x11C3F},
+    {0x11D42, 0x11D42},
+    {0x11D44, 0x11D45},
+    {0x11D97, 0x11D97},
+    {0x16AF0, 0x16AF4},
+    {0x16B30, 0x16B36},
+    {0x16FF0, 0x16FF1},
+    {0x1BC9E, 0x1BC9E},
+    {0x1D15E, 0x1D169},
+    {0x1D16D, 0x1D172},
+    {0x1D17B, 0x1D182},
+    {0x1D185, 0x1D18B},
+    {0x1D1AA, 0x1D1AD},
+    {0x1D1BB, 0x1D1C0},
+    {0x1D242, 0x1D244},
+    {0x1E000, 0x1E006},
+    {0x1E008, 0x1E018},
+    {0x1E01B, 0x1E021},
+    {0x1E023, 0x1E024},
+    {0x1E026, 0x1E02A},
+    {0x1E130, 0x1E136},
+    {0x1E2AE, 0x1E2AE},
+    {0x1E2EC, 0x1E2EF},
+    {0x1E8D0, 0x1E8D6},
+    {0x1E944, 0x1E94A},
+    {0x2F800, 0x2FA1D},
+}};
+
+// 完全展开的规范分解（不含算法处理的谚文音节），按码位排序
+constexpr std::array<MappingEntry, 2061> kDecompositionIndex = {{
+    {0x00C0, 0, 2},
+    {0x00C1, 2, 2},
+    {0x00C2, 4, 2},
+    {0x00C3, 6, 2},
+    {0x00C4, 8, 2},
+    {0x00C5, 10, 2},
+    {0x00C7, 12, 2},
+    {0x00C8, 14, 2},
+    {0x00C9, 16, 2},
+    {0x00CA, 18, 2},
+    {0x00CB, 20, 2},
+    {0x00CC, 22, 2},
+    {0x00CD, 24, 2},
+    {0x00CE, 26, 2},
+    {0x00CF, 28, 2},
+    {0x00D1, 30, 2},
+    {0x00D2, 32, 2},
+    {0x00D3, 34, 2},
+    {0x00D4, 36, 2},
+    {0x00D5, 38, 2},
+    {0x00D6, 40, 2},
+    {0x00D9, 42, 2},
+    {0x00DA, 44, 2},
+    {0x00DB, 46, 2},
+    {0x00DC, 48, 2},
+    {0x00DD, 50, 2},
+    {0x00E0, 52, 2},
+    {0x00E1, 54, 2},
+    {0x00E2, 56, 2},
+    {0x00E3, 58, 2},
+    {0x00E4, 60, 2},
+    {0x00E5, 62, 2},
+    {0x00E7, 64, 2},
+    {0x00E8, 66, 2},
+    {0x00E9, 68, 2},
+    {0x00EA, 70, 2},
+    {0x00EB, 72, 2},
+    {0x00EC, 74, 2},
+    {0x00ED, 76, 2},
+    {0x00EE, 78, 2},
+    {0x00EF, 80, 2},
+    {0x00F1, 82, 2},
+    {0x00F2, 84, 2},
+    {0x00F3, 86, 2},
+    {0x00F4, 88, 2},
+    {0x00F5, 90, 2},
+    {0x00F6, 92, 2},
+    {0x00F9, 94, 2},
+    {0x00FA, 96, 2},
+    {0x00FB, 98, 2},
+    {0x00FC, 100, 2},
+    {0x00FD, 102, 2},
+    {0x00FF, 104, 2},
+    {0x0100, 106, 2},
+    {0x0101, 108, 2},
+    {0x0102, 110, 2},
+    {0x0103, 112, 2},
+    {0x0104, 114, 2},
+    {0x0105, 116, 2},
+    {0x0106, 118, 2},
+    {0x0107, 120, 2},
+    {0x0108, 122, 2},
+    {0x0109, 124, 2},
+    {0x010A, 126, 2},
+    {0x010B, 128, 2},
+    {0x010C, 130, 2},
+    {0x010D, 132, 2},
+    {0x010E, 134, 2},
+    {0x010F, 136, 2},
+    {0x0112, 138, 2},
+    {0x0113, 140, 2},
+    {0x0114, 142, 2},
+    {0x0115, 144, 2},
+    {0x0116, 146, 2},
+    {0x0117, 148, 2},
+    {0x0118, 150, 2},
+    {0x0119, 152, 2},
+    {0x011A, 154, 2},
+    {0x011B, 156, 2},
+    {0x011C, 158, 2},
+    {0x011D, 160, 2},
+    {0x011E, 162, 2},
+    {0x011F, 164, 2},
+    {0x0120, 166, 2},
+    {0x0121, 168, 2},
+    {0x0122, 170, 2},
+    {0x0123, 172, 2},
+    {0x0124, 174, 2},
+    {0x0125, 176, 2},
+    {0x0128, 178, 2},
+    {0x0129, 180, 2},
+    {0x012A, 182, 2},
+    {0x012B, 184, 2},
+    {0x012C, 186, 2},
+    {0x012D, 188, 2},
+    {0x012E, 190, 2},
+    {0x012F, 192, 2},
+    {0x0130, 194, 2},
+    {0x0134, 196, 2},
+    {0x0135, 198, 2},
+    {0x0136, 200, 2},
+    {0x0137, 202, 2},
+    {0x0139, 204, 2},
+    {0x013A, 206, 2},
+    {0x013B, 208, 2},
+    {0x013C, 210, 2},
+    {0x013D, 212, 2},
+    {0x013E, 214, 2},
+    {0x0143, 216, 2},
+    {0x0144, 218, 2},
+    {0x0145, 220, 2},
+    {0x0146, 222, 2},
+    {0x0147, 224, 2},
+    {0x0148, 226, 2},
+    {0x014C, 228, 2},
+    {0x014D, 230, 2},
+    {0x014E, 232, 2},
+    {0x014F, 234, 2},
+    {0x0150, 236, 2},
+    {0x0151, 238, 2},
+    {0x0154, 240, 2},
+    {0x0155, 242, 2},
+    {0x0156, 244, 2},
+    {0x0157, 246, 2},
+    {0x0158, 248, 2},
+    {0x0159, 250, 2},
+    {0x015A, 252, 2},
+    {0x015B, 254, 2},
+    {0x015C, 256, 2},
+    {0x015D, 258, 2},
+    {0x015E, 260, 2},
+    {0x015F, 262, 2},
+    {0x0160, 264, 2},
+    {0x0161, 266, 2},
+    {0x0162, 268, 2},
+    {0x0163, 270, 2},
+    {0x0164, 272, 2},
+    {0x0165, 274, 2},
+    {0x0168, 276, 2},
+    {0x0169, 278, 2},
+    {0x016A, 280, 2},
+    {0x016B, 282, 2},
+    {0x016C, 284, 2},
+    {0x016D, 286, 2},
+    {0x016E, 288, 2},
+    {0x016F, 290, 2},
+    {0x0170, 292, 2},
+    {0x0171, 294, 2},
+    {0x0172, 296, 2},
+    {0x0173, 298, 2},
+    {0x0174, 300, 2},
+    {0x0175, 302, 2},
+    {0x0176, 304, 2},
+    {0x0177, 306, 2},
+    {0x0178, 308, 2},
+    {0x0179, 310, 2},
+    {0x017A, 312, 2},
+    {0x017B, 314, 2},
+    {0x017C, 316, 2},
+    {0x017D, 318, 2},
+    {0x017E, 320, 2},
+    {0x01A0, 322, 2},
+    {0x01A1, 324, 2},
+    {0x01AF, 326, 2},
+    {0x01B0, 328, 2},
+    {0x01CD, 330, 2},
+    {0x01CE, 332, 2},
+    {0x01CF, 334, 2},
+    {0x01D0, 336, 2},
+    {0x01D1, 338, 2},
+    {0x01D2, 340, 2},
+    {0x01D3, 342, 2},
+    {0x01D4, 344, 2},
+    {0x01D5, 346, 3},
+    {0x01D6, 349, 3},
+    {0x01D7, 352, 3},
+    {0x01D8, 355, 3},
+    {0x01D9, 358, 3},
+    {0x01DA, 361, 3},
+    {0x01DB, 364, 3},
+    {0x01DC, 367, 3},
+    {0x01DE, 370, 3},
+    {0x01DF, 373, 3},
+    {0x01E0, 376, 3},
+    {0x01E1, 379, 3},
+    {0x01E2, 382, 2},
+    {0x01E3, 384, 2},
+    {0x01E6, 386, 2},
+    {0x01E7, 388, 2},
+    {0x01E8, 390, 2},
+    {0x01E9, 392, 2},
+    {0x01EA, 394, 2},
+    {0x01EB, 396, 2},
+    {0x01EC, 398, 3},
+    {0x01ED, 401, 3},
+    {0x01EE, 404, 2},
+    {0x01EF, 406, 2},
+    {0x01F0, 408, 2},
+    {0x01F4, 410, 2},
+    {0x01F5, 412, 2},
+    {0x01F8, 414, 2},
+    {0x01F9, 416, 2},
+    {0x01FA, 418, 3},
+    {0x01FB, 421, 3},
+    {0x01FC, 424, 2},
+    {0x01FD, 426, 2},
+    {0x01FE, 428, 2},
+    {0x01FF, 430, 2},
+    {0x0200, 432, 2},
+    {0x0201, 434, 2},
+    {0x0202, 436, 2},
+    {0x0203, 438, 2},
+    {0x0204, 440, 2},
+    {0x0205, 442, 2},
+    {0x0206, 444, 2},
+    {0x0207, 446, 2},
+    {0x0208, 448, 2},
+    {0x0209, 450, 2},
+    {0x020A, 452, 2},
+    {0x020B, 454, 2},
+    {0x020C, 456, 2},
+    {0x020D, 458, 2},
+    {0x020E, 460, 2},
+    {0x020F, 462, 2},
+    {0x0210, 464, 2},
+    {0x0211, 466, 2},
+    {0x0212, 468, 2},
+    {0x0213, 470, 2},
+    {0x0214, 472, 2},
+    {0x0215, 474, 2},
+    {0x0216, 476, 2},
+    {0x0217, 478, 2},
+    {0x0218, 480, 2},
+    {0x0219, 482, 2},
+    {0x021A, 484, 2},
+    {0x021B, 486, 2},
+    {0x021E, 488, 2},
+    {0x021F, 490, 2},
+    {0x0226, 492, 2},
+    {0x0227, 494, 2},
+    {0x0228, 496, 2},
+    {0x0229, 498, 2},
+    {0x022A, 500, 3},
+    {0x022B, 503, 3},
+    {0x022C, 506, 3},
+    {0x022D, 509, 3},
+    {0x022E, 512, 2},
+    {0x022F, 514, 2},
+    {0x0230, 516, 3},
+    {0x0231, 519, 3},
+    {0x0232, 522, 2},
+    {0x0233, 524, 2},
+    {0x0340, 526, 1},
+    {0x0341, 527, 1},
+    {0x0343, 528, 1},
+    {0x0344, 529, 2},
+    {0x0374, 531, 1},
+    {0x037E, 532, 1},
+    {0x0385, 533, 2},
+    {0x0386, 535, 2},
+    {0x0387, 537, 1},
+    {0x0388, 538, 2},
+    {0x0389, 540, 2},
+    {0x038A, 542, 2},
+    {0x038C, 544, 2},
+    {0x038E, 546, 2},
+    {0x038F, 548, 2},
+    {0x0390, 550, 3},
+    {0x03AA, 553, 2},
+    {0x03AB, 555, 2},
+    {0x03AC, 557, 2},
+    {0x03AD, 559, 2},
+    {0x03AE, 561, 2},
+    {0x03AF, 563, 2},
+    {0x03B0, 565, 3},
+    {0x03CA, 568, 2},
+    {0x03CB, 570, 2},
+    {0x03CC, 572, 2},
+    {0x03CD, 574, 2},
+    {0x03CE, 576, 2},
+    {0x03D3, 578, 2},
+    {0x03D4, 580, 2},
+    {0x0400, 582, 2},
+    {0x0401, 584, 2},
+    {0x0403, 586, 2},
+    {0x0407, 588, 2},
+    {0x040C, 590, 2},
+    {0x040D, 592, 2},
+    {0x040E, 594, 2},
+    {0x0419, 596, 2},
+    {0x0439, 598, 2},
+    {0x0450, 600, 2},
+    {0x0451, 602, 2},
+    {0x0453, 604, 2},
+    {0x0457, 606, 2},
+    {0x045C, 608, 2},
+    {0x045D, 610, 2},
+    {0x045E, 612, 2},
+    {0x0476, 614, 2},
+    {0x0477, 616, 2},
+    {0x04C1, 618, 2},
+    {0x04C2, 620, 2},
+    {0x04D0, 622, 2},
+    {0x04D1, 624, 2},
+    {0x04D2, 626, 2},
+    {0x04D3, 628, 2},
+    {0x04D6, 630, 2},
+    {0x04D7, 632, 2},
+    {0x04DA, 634, 2},
+    {0x04DB, 636, 2},
+    {0x04DC, 638, 2},
+    {0x04DD, 640, 2},
+    {0x04DE, 642, 2},
+    {0x04DF, 644, 2},
+    {0x04E2, 646, 2},
+    {0x04E3, 648, 2},
+    {0x04E4, 650, 2},
+    {0x04E5, 652, 2},
+    {0x04E6, 654, 2},
+    {0x04E7, 656, 2},
+    {0x04EA, 658, 2},
+    {0x04EB, 660, 2},
+    {0x04EC, 662, 2},
+    {0x04ED, 664, 2},
+    {0x04EE, 666, 2},
+    {0x04EF, 668, 2},
+    {0x04F0, 670, 2},
+    {0x04F1, 672, 2},
+    {0x04F2, 674, 2},
+    {0x04F3, 676, 2},
+    {0x04F4, 678, 2},
+    {0x04F5, 680, 2},
+    {0x04F8, 682, 2},
+    {0x04F9, 684, 2},
+    {0x0622, 686, 2},
+    {0x0623, 688, 2},
+    {0x0624, 690, 2},
+    {0x0625, 692, 2},
+    {0x0626, 694, 2},
+    {0x06C0, 696, 2},
+    {0x06C2, 698, 2},
+    {0x06D3, 700, 2},
+    {0x0929, 702, 2},
+    {0x0931, 704, 2},
+    {0x0934, 706, 2},
+    {0x0958, 708, 2},
+    {0x0959, 710, 2},
+    {0x095A, 712, 2},
+    {0x095B, 714, 2},
+    {0x095C, 716, 2},
+    {0x095D, 718, 2},
+    {0x095E, 720, 2},
+    {0x095F, 722, 2},
+    {0x09CB, 724, 2},
+    {0x09CC, 726, 2},
+    {0x09DC, 728, 2},
+    {0x09DD, 730, 2},
+    {0x09DF, 732, 2},
+    {0x0A33, 734, 2},
+    {0x0A36, 736, 2},
+    {0x0A59, 738, 2},
+    {0x0A5A, 740, 2},
+    {0x0A5B, 742, 2},
+    {0x0A5E, 744, 2},
+    {0x0B48, 746, 2},
+    {0x0B4B, 748, 2},
+    {0x0B4C, 750, 2},
+    {0x0B5C, 752, 2},
+    {0x0B5D, 754, 2},
+    {0x0B94, 756, 2},
+    {0x0BCA, 758, 2},
+    {0x0BCB, 760, 2},
+    {0x0BCC, 762, 2},
+    {0x0C48, 764, 2},
+    {0x0CC0, 766, 2},
+    {0x0CC7, 768, 2},
+    {0x0CC8, 770, 2},
+    {0x0CCA, 772, 2},
+    {0x0CCB, 774, 3},
+    {0x0D4A, 777, 2},
+    {0x0D4B, 779, 2},
+    {0x0D4C, 781, 2},
+    {0x0DDA, 783, 2},
+    {0x0DDC, 785, 2},
+    {0x0DDD, 787, 3},
+    {0x0DDE, 790, 2},
+    {0x0F43, 792, 2},
+    {0x0F4D, 794, 2},
+    {0x0F52, 796, 2},
+    {0x0F57, 798, 2},
+    {0x0F5C, 800, 2},
+    {0x0F69, 802, 2},
+    {0x0F73, 804, 2},
+    {0x0F75, 806, 2},
+    {0x0F76, 808, 2},
+    {0x0F78, 810, 2},
+    {0x0F81, 812, 2},
+    {0x0F93, 814, 2},
+    {0x0F9D, 816, 2},
+    {0x0FA2, 818, 2},
+    {0x0FA7, 820, 2},
+    {0x0FAC, 822, 2},
+    {0x0FB9, 824, 2},
+    {0x1026, 826, 2},
+    {0x1B06, 828, 2},
+    {0x1B08, 830, 2},
+    {0x1B0A, 832, 2},
+    {0x1B0C, 834, 2},
+    {0x1B0E, 836, 2},
+    {0x1B12, 838, 2},
+    {0x1B3B, 840, 2},
+    {0x1B3D, 842, 2},
+    {0x1B40, 844, 2},
+    {0x1B41, 846, 2},
+    {0x1B43, 848, 2},
+    {0x1E00, 850, 2},
+    {0x1E01, 852, 2},
+    {0x1E02, 854, 2},
+    {0x1E03, 856, 2},
+    {0x1E04, 858, 2},
+    {0x1E05, 860, 2},
+    {0x1E06, 862, 2},
+    {0x1E07, 864, 2},
+    {0x1E08, 866, 3},
+    {0x1E09, 869, 3},
+    {0x1E0A, 872, 2},
+    {0x1E0B, 874, 2},
+    {0x1E0C, 876, 2},
+    {0x1E0D, 878, 2},
+    {0x1E0E, 880, 2},
+    {0x1E0F, 882, 2},
+    {0x1E10, 884, 2},
+    {0x1E11, 886, 2},
+    {0x1E12, 888, 2},
+    {0x1E13, 890, 2},
+    {0x1E14, 892, 3},
+    {0x1E15, 895, 3},
+    {0x1E16, 898, 3},
+    {0x1E17, 901, 3},
+    {0x1E18, 904, 2},
+    {0x1E19, 906, 2},
+    {0x1E1A, 908, 2},
+    {0x1E1B, 910, 2},
+    {0x1E1C, 912, 3},
+    {0x1E1D, 915, 3},
+    {0x1E1E, 918, 2},
+    {0x1E1F, 920, 2},
+    {0x1E20, 922, 2},
+    {0x1E21, 924, 2},
+    {0x1E22, 926, 2},
+    {0x1E23, 928, 2},
+    {0x1E24, 930, 2},
+    {0x1E25, 932, 2},
+    {0x1E26, 934, 2},
+    {0x1E27, 936, 2},
+    {0x1E28, 938, 2},
+    {0x1E29, 940, 2},
+    {0x1E2A, 942, 2},
+    {0x1E2B, 944, 2},
+    {0x1E2C, 946, 2},
+    {0x1E2D, 948, 2},
+    {0x1E2E, 950, 3},
+    {0x1E2F, 953, 3},
+    {0x1E30, 956, 2},
+    {0x1E31, 958, 2},
+    {0x1E32, 960, 2},
+    {0x1E33, 962, 2},
+    {0x1E34, 964, 2},
+    {0x1E35, 966, 2},
+    {0x1E36, 968, 2},
+    {0x1E37, 970, 2},
+    {0x1E38, 972, 3},
+    {0x1E39, 975, 3},
+    {0x1E3A, 978, 2},
+    {0x1E3B, 980, 2},
+    {0x1E3C, 982, 2},
+    {0x1E3D, 984, 2},
+    {0x1E3E, 986, 2},
+    {0x1E3F, 988, 2},
+    {0x1E40, 990, 2},
+    {0x1E41, 992, 2},
+    {0x1E42, 994, 2},
+    {0x1E43, 996, 2},
+    {0x1E44, 998, 2},
+    {0x1E45, 1000, 2},
+    {0x1E46, 1002, 2},
+    {0x1E47, 1004, 2},
+    {0x1E48, 1006, 2},
+    {0x1E49, 1008, 2},
+    {0x1E4A, 1010, 2},
+    {0x1E4B, 1012, 2},
+    {0x1E4C, 1014, 3},
+    {0x1E4D, 1017, 3},
+    {0x1E4E, 1020, 3},
+    {0x1E4F, 1023, 3},
+    {0x1E50, 1026, 3},
+    {0x1E51, 1029, 3},
+    {0x1E52, 1032, 3},
+    {0x1E53, 1035, 3},
+    {0x1E54, 1038, 2},
+    {0x1E55, 1040, 2},
+    {0x1E56, 1042, 2},
+    {0x1E57, 1044, 2},
+    {0x1E58, 1046, 2},
+    {0x1E59, 1048, 2},
+    {0x1E5A, 1050, 2},
+    {0x1E5B, 1052, 2},
+    {0x1E5C, 1054, 3},
+    {0x1E5D, 1057, 3},
+    {0x1E5E, 1060, 2},
+    {0x1E5F, 1062, 2},
+    {0x1E60, 1064, 2},
+    {0x1E61, 1066, 2},
+    {0x1E62, 1068, 2},
+    {0x1E63, 1070, 2},
+    {0x1E64, 1072, 3},
+    {0x1E65, 1075, 3},
+    {0x1E66, 1078, 3},
+    {0x1E67, 1081, 3},
+    {0x1E68, 1084, 3},
+    {0x1E69, 1087, 3},
+    {0x1E6A, 1090, 2},
+    {0x1E6B, 1092, 2},
+    {0x1E6C, 1094, 2},
+    {0x1E6D, 1096, 2},
+    {0x1E6E, 1098, 2},
+    {0x1E6F, 1100, 2},
+    {0x1E70, 1102, 2},
+    {0x1E71, 1104, 2},
+    {0x1E72, 1106, 2},
+    {0x1E73, 1108, 2},
+    {0x1E74, 1110, 2},
+    {0x1E75, 1112, 2},
+    {0x1E76, 1114, 2},
+    {0x1E77, 1116, 2},
+    {0x1E78, 1118, 3},
+    {0x1E79, 1121, 3},
+    {0x1E7A, 1124, 3},
+    {0x1E7B, 1127, 3},
+    {0x1E7C, 1130, 2},
+    {0x1E7D, 1132, 2},
+    {0x1E7E, 1134, 2},
+    {0x1E7F, 1136, 2},
+    {0x1E80, 1138, 2},
+    {0x1E81, 1140, 2},
+    {0x1E82, 1142, 2},
+    {0x1E83, 1144, 2},
+    {0x1E84, 1146, 2},
+    {0x1E85, 1148, 2},
+    {0x1E86, 1150, 2},
+    {0x1E87, 1152, 2},
+    {0x1E88, 1154, 2},
+    {0x1E89, 1156, 2},
+    {0x1E8A, 1158, 2},
+    {0x1E8B, 1160, 2},
+    {0x1E8C, 1162, 2},
+    {0x1E8D, 1164, 2},
+    {0x1E8E, 1166, 2},
+    {0x1E8F, 1168, 2},
+    {0x1E90, 1170, 2},
+    {0x1E91, 1172, 2},
+    {0x1E92, 1174, 2},
+    {0x1E93, 1176, 2},
+    {0x1E94, 1178, 2},
+    {0x1E95, 1180, 2},
+    {0x1E96, 1182, 2},
+    {0x1E97, 1184, 2},
+    {0x1E98, 1186, 2},
+    {0x1E99, 1188, 2},
+    {0x1E9B, 1190, 2},
+    {0x1EA0, 1192, 2},
+    {0x1EA1, 1194, 2},
+    {0x1EA2, 1196, 2},
+    {0x1EA3, 1198, 2},
+    {0x1EA4, 1200, 3},
+    {0x1EA5, 1203, 3},
+    {0x1EA6, 1206, 3},
+    {0x1EA7, 1209, 3},
+    {0x1EA8, 1212, 3},
+    {0x1EA9, 1215, 3},
+    {0x1EAA, 1218, 3},
+    {0x1EAB, 1221, 3},
+    {0x1EAC, 1224, 3},
+    {0x1EAD, 1227, 3},
+    {0x1EAE, 1230, 3},
+    {0x1EAF, 1233, 3},
+    {0x1EB0, 1236, 3},
+    {0x1EB1, 1239, 3},
+    {0x1EB2, 1242, 3},
+    {0x1EB3, 1245, 3},
+    {0x1EB4, 1248, 3},
+    {0x1EB5, 1251, 3},
+    {0x1EB6, 1254, 3},
+    {0x1EB7, 1257, 3},
+    {0x1EB8, 1260, 2},
+    {0x1EB9, 1262, 2},
+    {0x1EBA, 1264, 2},
+    {0x1EBB, 1266, 2},
+    {0x1EBC, 1268, 2},
+    {0x1EBD, 1270, 2},
+    {0x1EBE, 1272, 3},
+    {0x1EBF, 1275, 3},
+    {0x1EC0, 1278, 3},
+    {0x1EC1, 1281, 3},
+    {0x1EC2, 1284, 3},
+    {0x1EC3, 1287, 3},
+    {0x1EC4, 1290, 3},
+    {0x1EC5, 1293, 3},
+    {0x1EC6, 1296, 3},
+    {0x1EC7, 1299, 3},
+    {0x1EC8, 1302, 2},
+    {0x1EC9, 1304, 2},
+    {0x1ECA, 1306, 2},
+    {0x1ECB, 1308, 2},
+    {0x1ECC, 1310, 2},
+    {0x1ECD, 1312, 2},
+    {0x1ECE, 1314, 2},
+    {0x1ECF, 1316, 2},
+    {0x1ED0, 1318, 3},
+    {0x1ED1, 1321, 3},
+    {0x1ED2, 1324, 3},
+    {0x1ED3, 1327, 3},
+    {0x1ED4, 1330, 3},
+    {0x1ED5, 1333, 3},
+    {0x1ED6, 1336, 3},
+    {0x1ED7, 1339, 3},
+    {0x1ED8, 1342, 3},
+    {0x1ED9, 1345, 3},
+    {0x1EDA, 1348, 3},
+    {0x1EDB, 1351, 3},
+    {0x1EDC, 1354, 3},
+    {0x1EDD, 1357, 3},
+    {0x1EDE, 1360, 3},
+    {0x1EDF, 1363, 3},
+    {0x1EE0, 1366, 3},
+    {0x1EE1, 1369, 3},
+    {0x1EE2, 1372, 3},
+    {0x1EE3, 1375, 3},
+    {0x1EE4, 1378, 2},
+    {0x1EE5, 1380, 2},
+    {0x1EE6, 1382, 2},
+    {0x1EE7, 1384, 2},
+    {0x1EE8, 1386, 3},
+    {0x1EE9, 1389, 3},
+    {0x1EEA, 1392, 3},
+    {0x1EEB, 1395, 3},
+    {0x1EEC, 1398, 3},
+    {0x1EED, 1401, 3},
+    {0x1EEE, 1404, 3},
+    {0x1EEF, 1407, 3},
+    {0x1EF0, 1410, 3},
+    {0x1EF1, 1413, 3},
+    {0x1EF2, 1416, 2},
+    {0x1EF3, 1418, 2},
+    {0x1EF4, 1420, 2},
+    {0x1EF5, 1422, 2},
+    {0x1EF6, 1424, 2},
+    {0x1EF7, 1426, 2},
+    {0x1EF8, 1428, 2},
+    {0x1EF9, 1430, 2},
+    {0x1F00, 1432, 2},
+    {0x1F01, 1434, 2},
+    {0x1F02, 1436, 3},
+    {0x1F03, 1439, 3},
+    {0x1F04, 1442, 3},
+    {0x1F05, 1445, 3},
+    {0x1F06, 1448, 3},
+    {0x1F07, 1451, 3},
+    {0x1F08, 1454, 2},
+    {0x1F09, 1456, 2},
+    {0x1F0A, 1458, 3},
+    {0x1F0B, 1461, 3},
+    {0x1F0C, 1464, 3},
+    {0x1F0D, 1467, 3},
+    {0x1F0E, 1470, 3},
+    {0x1F0F, 1473, 3},
+    {0x1F10, 1476, 2},
+    {0x1F11, 1478, 2},
+    {0x1F12, 1480, 3},
+    {0x1F13, 1483, 3},
+    {0x1F14, 1486, 3},
+    {0x1F15, 1489, 3},
+    {0x1F18, 1492, 2},
+    {0x1F19, 1494, 2},
+    {0x1F1A, 1496, 3},
+    {0x1F1B, 1499, 3},
+    {0x1F1C, 1502, 3},
+    {0x1F1D, 1505, 3},
+    {0x1F20, 1508, 2},
+    {0x1F21, 1510, 2},
+    {0x1F22, 1512, 3},
+    {0x1F23, 1515, 3},
+    {0x1F24, 1518, 3},
+    {0x1F25, 1521, 3},
+    {0x1F26, 1524, 3},
+    {0x1F27, 1527, 3},
+    {0x1F28, 1530, 2},
+    {0x1F29, 1532, 2},
+    {0x1F2A, 1534, 3},
+    {0x1F2B, 1537, 3},
+    {0x1F2C, 1540, 3},
+    {0x1F2D, 1543, 3},
+    {0x1F2E, 1546, 3},
+    {0x1F2F, 1549, 3},
+    {0x1F30, 1552, 2},
+    {0x1F31, 1554, 2},
+    {0x1F32, 1556, 3},
+    {0x1F33, 1559, 3},
+    {0x1F34, 1562, 3},
+    {0x1F35, 1565, 3},
+    {0x1F36, 1568, 3},
+    {0x1F37, 1571, 3},
+    {0x1F38, 1574, 2},
+    {0x1F39, 1576, 2},
+    {0x1F3A, 1578, 3},
+    {0x1F3B, 1581, 3},
+    {0x1F3C, 1584, 3},
+    {0x1F3D, 1587, 3},
+    {0x1F3E, 1590, 3},
+    {0x1F3F, 1593, 3},
+    {0x1F40, 1596, 2},
+    {0x1F41, 1598, 2},
+    {0x1F42, 1600, 3},
+    {0x1F43, 1603, 3},
+    {0x1F44, 1606, 3},
+    {0x1F45, 1609, 3},
+    {0x1F48, 1612, 2},
+    {0x1F49, 1614, 2},
+    {0x1F4A, 1616, 3},
+    {0x1F4B, 1619, 3},
+    {0x1F4C, 1622, 3},
+    {0x1F4D, 1625, 3},
+    {0x1F50, 1628, 2},
+    {0x1F51, 1630, 2},
+    {0x1F52, 1632, 3},
+    {0x1F53, 1635, 3},
+    {0x1F54, 1638, 3},
+    {0x1F55, 1641, 3},
+    {0x1F56, 1644, 3},
+    {0x1F57, 1647, 3},
+    {0x1F59, 1650, 2},
+    {0x1F5B, 1652, 3},
+    {0x1F5D, 1655, 3},
+    {0x1F5F, 1658, 3},
+    {0x1F60, 1661, 2},
+    {0x1F61, 1663, 2},
+    {0x1F62, 1665, 3},
+    {0x1F63, 1668, 3},
+    {0x1F64, 1671, 3},
+    {0x1F65, 1674, 3},
+    {0x1F66, 1677, 3},
+    {0x1F67, 1680, 3},
+    {0x1F68, 1683, 2},
+    {0x1F69, 1685, 2},
+    {0x1F6A, 1687, 3},
+    {0x1F6B, 1690, 3},
+    {0x1F6C, 1693, 3},
+    {0x1F6D, 1696, 3},
+    {0x1F6E, 1699, 3},
+    {0x1F6F, 1702, 3},
+    {0x1F70, 1705, 2},
+    {0x1F71, 1707, 2},
+    {0x1F72, 1709, 2},
+    {0x1F73, 1711, 2},
+    {0x1F74, 1713, 2},
+    {0x1F75, 1715, 2},
+    {0x1F76, 1717, 2},
+    {0x1F77, 1719, 2},
+    {0x1F78, 1721, 2},
+    {0x1F79, 1723, 2},
+    {0x1F7A, 1725, 2},
+    {0x1F7B, 1727, 2},
+    {0x1F7C, 1729, 2},
+    {0x1F7D, 1731, 2},
+    {0x1F80, 1733, 3},
+    {0x1F81, 1736, 3},
+    {0x1F82, 1739, 4},
+    {0x1F83, 1743, 4},
+    {0x1F84, 1747, 4},
+    {0x1F85, 1751, 4},
+    {0x1F86, 1755, 4},
+    {0x1F87, 1759, 4},
+    {0x1F88, 1763, 3},
+    {0x1F89, 1766, 3},
+    {0x1F8A, 1769, 4},
+    {0x1F8B, 1773, 4},
+    {0x1F8C, 1777, 4},
+    {0x1F8D, 1781, 4},
+    {0x1F8E, 1785, 4},
+    {0x1F8F, 1789, 4},
+    {0x1F90, 1793, 3},
+    {0x1F91, 1796, 3},
+    {0x1F92, 1799, 4},
+    {0x1F93, 1803, 4},
+    {0x1F94, 1807, 4},
+    {0x1F95, 1811, 4},
+    {0x1F96, 1815, 4},
+    {0x1F97, 1819, 4},
+    {0x1F98, 1823, 3},
+    {0x1F99, 1826, 3},
+    {0x1F9A, 1829, 4},
+    {0x1F9B, 1833, 4},
+    {0x1F9C, 1837, 4},
+    {0x1F9D, 1841, 4},
+    {0x1F9E, 1845, 4},
+    {0x1F9F, 1849, 4},
+    {0x1FA0, 1853, 3},
+    {0x1FA1, 1856, 3},
+    {0x1FA2, 1859, 4},
+    {0x1FA3, 1863, 4},
+    {0x1FA4, 1867, 4},
+    {0x1FA5, 1871, 4},
+    {0x1FA6, 1875, 4},
+    {0x1FA7, 1879, 4},
+    {0x1FA8, 1883, 3},
+    {0x1FA9, 1886, 3},
+    {0x1FAA, 1889, 4},
+    {0x1FAB, 1893, 4},
+    {0x1FAC, 1897, 4},
+    {0x1FAD, 1901, 4},
+    {0x1FAE, 1905, 4},
+    {0x1FAF, 1909, 4},
+    {0x1FB0, 1913, 2},
+    {0x1FB1, 1915, 2},
+    {0x1FB2, 1917, 3},
+    {0x1FB3, 1920, 2},
+    {0x1FB4, 1922, 3},
+    {0x1FB6, 1925, 2},
+    {0x1FB7, 1927, 3},
+    {0x1FB8, 1930, 2},
+    {0x1FB9, 1932, 2},
+    {0x1FBA, 1934, 2},
+    {0x1FBB, 1936, 2},
+    {0x1FBC, 1938, 2},
+    {0x1FBE, 1940, 1},
+    {0x1FC1, 1941, 2},
+    {0x1FC2, 1943, 3},
+    {0x1FC3, 1946, 2},
+    {0x1FC4, 1948, 3},
+    {0x1FC6, 1951, 2},
+    {0x1FC7, 1953, 3},
+    {0x1FC8, 1956, 2},
+    {0x1FC9, 1958, 2},
+    {0x1FCA, 1960, 2},
+    {0x1FCB, 1962, 2},
+    {0x1FCC, 1964, 2},
+    {0x1FCD, 1966, 2},
+    {0x1FCE, 1968, 2},
+    {0x1FCF, 1970, 2},
+    {0x1FD0, 1972, 2},
+    {0x1FD1, 1974, 2},
+    {0x1FD2, 1976, 3},
+    {0x1FD3, 1979, 3},
+    {0x1FD6, 1982, 2},
+    {0x1FD7, 1984, 3},
+    {0x1FD8, 1987, 2},
+    {0x1FD9, 1989, 2},
+    {0x1FDA, 1991, 2},
+    {0x1FDB, 1993, 2},
+    {0x1FDD, 1995, 2},
+    {0x1FDE, 1997, 2},
+    {0x1FDF, 1999, 2},
+    {0x1FE0, 2001, 2},
+    {0x1FE1, 2003, 2},
+    {0x1FE2, 2005, 3},
+    {0x1FE3, 2008, 3},
+    {0x1FE4, 2011, 2},
+    {0x1FE5, 2013, 2},
+    {0x1FE6, 2015, 2},
+    {0x1FE7, 2017, 3},
+    {0x1FE8, 2020, 2},
+    {0x1FE9, 2022, 2},
+    {0x1FEA, 2024, 2},
+    {0x1FEB, 2026, 2},
+    {0x1FEC, 2028, 2},
+    {0x1FED, 2030, 2},
+    {0x1FEE, 2032, 2},
+    {0x1FEF, 2034, 1},
+    {0x1FF2, 2035, 3},
+    {0x1FF3, 2038, 2},
+    {0x1FF4, 2040, 3},
+    {0x1FF6, 2043, 2},
+    {0x1FF7, 2045, 3},
+    {0x1FF8, 2048, 2},
+    {0x1FF9, 2050, 2},
+    {0x1FFA, 2052, 2},
+    {0x1FFB, 2054, 2},
+    {0x1FFC, 2056, 2},
+    {0x1FFD, 2058, 1},
+    {0x2000, 2059, 1},
+    {0x2001, 2060, 1},
+    {0x2126, 2061, 1},
+    {0x212A, 2062, 1},
+    {0x212B, 2063, 2},
+    {0x219A, 2065, 2},
+    {0x219B, 2067, 2},
+    {0x21AE, 2069, 2},
+    {0x21CD, 2071, 2},
+    {0x21CE, 2073, 2},
+    {0x21CF, 2075, 2},
+    {0x2204, 2077, 2},
+    {0x2209, 2079, 2},
+    {0x220C, 2081, 2},
+    {0x2224, 2083, 2},
+    {0x2226, 2085, 2},
+    {0x2241, 2087, 2},
+    {0x2244, 2089, 2},
+    {0x2247, 2091, 2},
+    {0x2249, 2093, 2},
+    {0x2260, 2095, 2},
+    {0x2262, 2097, 2},
+    {0x226D, 2099, 2},
+    {0x226E, 2101, 2},
+    {0x226F, 2103, 2},
+    {0x2270, 2105, 2},
+    {0x2271, 2107, 2},
+    {0x2274, 2109, 2},
+    {0x2275, 2111, 2},
+    {0x2278, 2113, 2},
+    {0x2279, 2115, 2},
+    {0x2280, 2117, 2},
+    {0x2281, 2119, 2},
+    {0x2284, 2121, 2},
+    {0x2285, 2123, 2},
+    {0x2288, 2125, 2},
+    {0x2289, 2127, 2},
+    {0x22AC, 2129, 2},
+    {0x22AD, 2131, 2},
+    {0x22AE, 2133, 2},
+    {0x22AF, 2135, 2},
+    {0x22E0, 2137, 2},
+    {0x22E1, 2139, 2},
+    {0x22E2, 2141, 2},
+    {0x22E3, 2143, 2},
+    {0x22EA, 2145, 2},
+    {0x22EB, 2147, 2},
+    {0x22EC, 2149, 2},
+    {0x22ED, 2151, 2},
+    {0x2329, 2153, 1},
+    {0x232A, 2154, 1},
+    {0x2ADC, 2155, 2},
+    {0x304C, 2157, 2},
+    {0x304E, 2159, 2},
+    {0x3050, 2161, 2},
+    {0x3052, 2163, 2},
+    {0x3054, 2165, 2},
+    {0x3056, 2167, 2},
+    {0x3058, 2169, 2},
+    {0x305A, 2171, 2},
+    {0x305C, 2173, 2},
+    {0x305E, 2175, 2},
+    {0x3060, 2177, 2},
+    {0x3062, 2179, 2},
+    {0x3065, 2181, 2},
+    {0x3067, 2183, 2},
+    {0x3069, 2185, 2},
+    {0x3070, 2187, 2},
+    {0x3071, 2189, 2},
+    {0x3073, 2191, 2},
+    {0x3074, 2193, 2},
+    {0x3076, 2195, 2},
+    {0x3077, 2197, 2},
+    {0x3079, 2199, 2},
+    {0x307A, 2201, 2},
+    {0x307C, 2203, 2},
+    {0x307D, 2205, 2},
+    {0x3094, 2207, 2},
+    {0x309E, 2209, 2},
+    {0x30AC, 2211, 2},
+    {0x30AE, 2213, 2},
+    {0x30B0, 2215, 2},
+    {0x30B2, 2217, 2},
+    {0x30B4, 2219, 2},
+    {0x30B6, 2221, 2},
+    {0x30B8, 2223, 2},
+    {0x30BA, 2225, 2},
+    {0x30BC, 2227, 2},
+    {0x30BE, 2229, 2},
+    {0x30C0, 2231, 2},
+    {0x30C2, 2233, 2},
+    {0x30C5, 2235, 2},
+    {0x30C7, 2237, 2},
+    {0x30C9, 2239, 2},
+    {0x30D0, 2241, 2},
+    {0x30D1, 2243, 2},
+    {0x30D3, 2245, 2},
+    {0x30D4, 2247, 2},
+    {0x30D6, 2249, 2},
+    {0x30D7, 2251, 2},
+    {0x30D9, 2253, 2},
+    {0x30DA, 2255, 2},
+    {0x30DC, 2257, 2},
+    {0x30DD, 2259, 2},
+    {0x30F4, 2261, 2},
+    {0x30F7, 2263, 2},
+    {0x30F8, 2265, 2},
+    {0x30F9, 2267, 2},
+    {0x30FA, 2269, 2},
+    {0x30FE, 2271, 2},
+    {0xF900, 2273, 1},
+    {0xF901, 2274, 1},
+    {0xF902, 2275, 1},
+    {0xF903, 2276, 1},
+    {0xF904, 2277, 1},
+    {0xF905, 2278, 1},
+    {0xF906, 2279, 1},
+    {0xF907, 2280, 1},
+    {0xF908, 2281, 1},
+    {0xF909, 2282, 1},
+    {0xF90A, 2283, 1},
+    {0xF90B, 2284, 1},
+    {0xF90C, 2285, 1},
+    {0xF90D, 2286, 1},
+    {0xF90E, 2287, 1},
+    {0xF90F, 2288, 1},
+    {0xF910, 2289, 1},
+    {0xF911, 2290, 1},
+    {0xF912, 2291, 1},
+    {0xF913, 2292, 1},
+    {0xF914, 2293, 1},
+    {0xF915, 2294, 1},
+    {0xF916, 2295, 1},
+    {0xF917, 2296, 1},
+    {0xF918, 2297, 1},
+    {0xF919, 2298, 1},
+    {0xF91A, 2299, 1},
+    {0xF91B, 2300, 1},
+    {0xF91C, 2301, 1},
+    {0xF91D, 2302, 1},
+    {0xF91E, 2303, 1},
+    {0xF91F, 2304, 1},
+    {0xF920, 2305, 1},
+    {0xF921, 2306, 1},
+    {0xF922, 2307, 1},
+    {0xF923, 2308, 1},
+    {0xF924, 2309, 1},
+    {0xF925, 2310, 1},
+    {0xF926, 2311, 1},
+    {0xF927, 2312, 1},
+    {0xF928, 2313, 1},
+    {0xF929, 2314, 1},
+    {0xF92A, 2315, 1},
+    {0xF92B, 2316, 1},
+    {0xF92C, 2317, 1},
+    {0xF92D, 2318, 1},
+    {0xF92E, 2319, 1},
+    {0xF92F, 2320, 1},
+    {0xF930, 2321, 1},
+    {0xF931, 2322, 1},
+    {0xF932, 2323, 1},
+    {0xF933, 2324, 1},
+    {0xF934, 2325, 1},
+    {0xF935, 2326, 1},
+    {0xF936, 2327, 1},
+    {0xF937, 2328, 1},
+    {0xF938, 2329, 1},
+    {0xF939, 2330, 1},
+    {0xF93A, 2331, 1},
+    {0xF93B, 2332, 1},
+    {0xF93C, 2333, 1},
+    {0xF93D, 2334, 1},
+    {0xF93E, 2335, 1},
+    {0xF93F, 2336, 1},
+    {0xF940, 2337, 1},
+    {0xF941, 2338, 1},
+    {0xF942, 2339, 1},
+    {0xF943, 2340, 1},
+    {0xF944, 2341, 1},
+    {0xF945, 2342, 1},
+    {0xF946, 2343, 1},
+    {0xF947, 2344, 1},
+    {0xF948, 2345, 1},
+    {0xF949, 2346, 1},
+    {0xF94A, 2347, 1},
+    {0xF94B, 2348, 1},
+    {0xF94C, 2349, 1},
+    {0xF94D, 2350, 1},
+    {0xF94E, 2351, 1},
+    {0xF94F, 2352, 1},
+    {0xF950, 2353, 1},
+    {0xF951, 2354, 1},
+    {0xF952, 2355, 1},
+    {0xF953, 2356, 1},
+    {0xF954, 2357, 1},
+    {0xF955, 2358, 1},
+    {0xF956, 2359, 1},
+    {0xF957, 2360, 1},
+    {0xF958, 2361, 1},
+    {0xF959, 2362, 1},
+    {0xF95A, 2363, 1},
+    {0xF95B, 2364, 1},
+    {0xF95C, 2365, 1},
+    {0xF95D, 2366, 1},
+    {0xF95E, 2367, 1},
+    {0xF95F, 2368, 1},
+    {0xF960, 2369, 1},
+    {0xF961, 2370, 1},
+    {0xF962, 2371, 1},
+    {0xF963, 2372, 1},
+    {0xF964, 2373, 1},
+    {0xF965, 2374, 1},
+    {0xF966, 2375, 1},
+    {0xF967, 2376, 1},
+    {0xF968, 2377, 1},
+    {0xF969, 2378, 1},
+    {0xF96A, 2379, 1},
+    {0xF96B, 2380, 1},
+    {0xF96C, 2381, 1},
+    {0xF96D, 2382, 1},
+    {0xF96E, 2383, 1},
+    {0xF96F, 2384, 1},
+    {0xF970, 2385, 1},
+    {0xF971, 2386, 1},
+    {0xF972, 2387, 1},
+    {0xF973, 2388, 1},
+    {0xF974, 2389, 1},
+    {0xF975, 2390, 1},
+    {0xF976, 2391, 1},
+    {0xF977, 2392, 1},
+    {0xF978, 2393, 1},
+    {0xF979, 2394, 1},
+    {0xF97A, 2395, 1},
+    {0xF97B, 2396, 1},
+    {0xF97C, 2397, 1},
+    {0xF97D, 2398, 1},
+    {0xF97E, 2399, 1},
+    {0xF97F, 2400, 1},
+    {0xF980, 2401, 1},
+    {0xF981, 2402, 1},
+    {0xF982, 2403, 1},
+    {0xF983, 2404, 1},
+    {0xF984, 2405, 1},
+    {0xF985, 2406, 1},
+    {0xF986, 2407, 1},
+    {0xF987, 2408, 1},
+    {0xF988, 2409, 1},
+    {0xF989, 2410, 1},
+    {0xF98A, 2411, 1},
+    {0xF98B, 2412, 1},
+    {0xF98C, 2413, 1},
+    {0xF98D, 2414, 1},
+    {0xF98E, 2415, 1},
+    {0xF98F, 2416, 1},
+    {0xF990, 2417, 1},
+    {0xF991, 2418, 1},
+    {0xF992, 2419, 1},
+    {0xF993, 2420, 1},
+    {0xF994, 2421, 1},
+    {0xF995, 2422, 1},
+    {0xF996, 2423, 1},
+    {0xF997, 2424, 1},
+    {0xF998, 2425, 1},
+    {0xF999, 2426, 1},
+    {0xF99A, 2427, 1},
+    {0xF99B, 2428, 1},
+    {0xF99C, 2429, 1},
+    {0xF99D, 2430, 1},
+    {0xF99E, 2431, 1},
+    {0xF99F, 2432, 1},
+    {0xF9A0, 2433, 1},
+    {0xF9A1, 2434, 1},
+    {0xF9A2, 2435, 1},
+    {0xF9A3, 2436, 1},
+    {0xF9A4, 2437, 1},
+    {0xF9A5, 2438, 1},
+    {0xF9A6, 2439, 1},
+    {0xF9A7, 2440, 1},
+    {0xF9A8, 2441, 1},
+    {0xF9A9, 2442, 1},
+    {0xF9AA, 2443, 1},
+    {0xF9AB, 2444, 1},
+    {0xF9AC, 2445, 1},
+    {0xF9AD, 2446, 1},
+    {0xF9AE, 2447, 1},
+    {0xF9AF, 2448, 1},
+    {0xF9B0, 2449, 1},
+    {0xF9B1, 2450, 1},
+    {0xF9B2, 2451, 1},
+    {0xF9B3, 2452, 1},
+    {0xF9B4, 2453, 1},
+    {0xF9B5, 2454, 1},
+    {0xF9B6, 2455, 1},
+    {0xF9B7, 2456, 1},
+    {0xF9B8, 2457, 1},
+    {0xF9B9, 2458, 1},
+    {0xF9BA, 2459, 1},
+    {0xF9BB, 2460, 1},
+    {0xF9BC, 2461, 1},
+    {0xF9BD, 2462, 1},
+    {0xF9BE, 2463, 1},
+    {0xF9BF, 2464, 1},
+    {0xF9C0, 2465, 1},
+    {0xF9C1, 2466, 1},
+    {0xF9C2, 2467, 1},
+    {0xF9C3, 2468, 1},
+    {0xF9C4, 2469, 1},
+    {0xF9C5, 2470, 1},
+    {0xF9C6, 2471, 1},
+    {0xF9C7, 2472, 1},
+    {0xF9C8, 2473, 1},
+    {0xF9C9, 2474, 1},
+    {0xF9CA, 2475, 1},
+    {0xF9CB, 2476, 1},
+    {0xF9CC, 2477, 1},
+    {0xF9CD, 2478, 1},
+    {0xF9CE, 2479, 1},
+    {0xF9CF, 2480, 1},
+    {0xF9D0, 2481, 1},
+    {0xF9D1, 2482, 1},
+    {0xF9D2, 2483, 1},
+    {0xF9D3, 2484, 1},
+    {0xF9D4, 2485, 1},
+    {0xF9D5, 2486, 1},
+    {0xF9D6, 2487, 1},
+    {0xF9D7, 2488, 1},
+    {0xF9D8, 2489, 1},
+    {0xF9D9, 2490, 1},
+    {0xF9DA, 2491, 1},
+    {0xF9DB, 2492, 1},
+    {0xF9DC, 2493, 1},
+    {0xF9DD, 2494, 1},
+    {0xF9DE, 2495, 1},
+    {0xF9DF, 2496, 1},
+    {0xF9E0, 2497, 1},
+    {0xF9E1, 2498, 1},
+    {0xF9E2, 2499, 1},
+    {0xF9E3, 2500, 1},
+    {0xF9E4, 2501, 1},
+    {0xF9E5, 2502, 1},
+    {0xF9E6, 2503, 1},
+    {0xF9E7, 2504, 1},
+    {0xF9E8, 2505, 1},
+    {0xF9E9, 2506, 1},
+    {0xF9EA, 2507, 1},
+    {0xF9EB, 2508, 1},
+    {0xF9EC, 2509, 1},
+    {0xF9ED, 2510, 1},
+    {0xF9EE, 2511, 1},
+    {0xF9EF, 2512, 1},
+    {0xF9F0, 2513, 1},
+    {0xF9F1, 2514, 1},
+    {0xF9F2, 2515, 1},
+    {0xF9F3, 2516, 1},
+    {0xF9F4, 2517, 1},
+    {0xF9F5, 2518, 1},
+    {0xF9F6, 2519, 1},
+    {0xF9F7, 2520, 1},
+    {0xF9F8, 2521, 1},
+    {0xF9F9, 2522, 1},
+    {0xF9FA, 2523, 1},
+    {0xF9FB, 2524, 1},
+    {0xF9FC, 2525, 1},
+    {0xF9FD, 2526, 1},
+    {0xF9FE, 2527, 1},
+    {0xF9FF, 2528, 1},
+    {0xFA00, 2529, 1},
+    {0xFA01, 2530, 1},
+    {0xFA02, 2531, 1},
+    {0xFA03, 2532, 1},
+    {0xFA04, 2533, 1},
+    {0xFA05, 2534, 1},
+    {0xFA06, 2535, 1},
+    {0xFA07, 2536, 1},
+    {0xFA08, 2537, 1},
+    {0xFA09, 2538, 1},
+    {0xFA0A, 2539, 1},
+    {0xFA0B, 2540, 1},
+    {0xFA0C, 2541, 1},
+    {0xFA0D, 2542, 1},
+    {0xFA10, 2543, 1},
+    {0xFA12, 2544, 1},
+    {0xFA15, 2545, 1},
+    {0xFA16, 2546, 1},
+    {0xFA17, 2547, 1},
+    {0xFA18, 2548, 1},
+    {0xFA19, 2549, 1},
+    {0xFA1A, 2550, 1},
+    {0xFA1B, 2551, 1},
+    {0xFA1C, 2552, 1},
+    {0xFA1D, 2553, 1},
+    {0xFA1E, 2554, 1},
+    {0xFA20, 2555, 1},
+    {0xFA22, 2556, 1},
+    {0xFA25, 2557, 1},
+    {0xFA26, 2558, 1},
+    {0xFA2A, 2559, 1},
+    {0xFA2B, 2560, 1},
+    {0xFA2C, 2561, 1},
+    {0xFA2D, 2562, 1},
+    {0xFA2E, 2563, 1},
+    {0xFA2F, 2564, 1},
+    {0xFA30, 2565, 1},
+    {0xFA31, 2566, 1},
+    {0xFA32, 2567, 1},
+    {0xFA33, 2568, 1},
+    {0xFA34, 2569, 1},
+    {0xFA35, 2570, 1},
+    {0xFA36, 2571, 1},
+    {0xFA37, 2572, 1},
+    {0xFA38, 2573, 1},
+    {0xFA39, 2574, 1},
+    {0xFA3A, 2575, 1},
+    {0xFA3B, 2576, 1},
+    {0xFA3C, 2577, 1},
+    {0xFA3D, 2578, 1},
+    {0xFA3E, 2579, 1},
+    {0xFA3F, 2580, 1},
+    {0xFA40, 2581, 1},
+    {0xFA41, 2582, 1},
+    {0xFA42, 2583, 1},
+    {0xFA43, 2584, 1},
+    {0xFA44, 2585, 1},
+    {0xFA45, 2586, 1},
+    {0xFA46, 2587, 1},
+    {0xFA47, 2588, 1},
+    {0xFA48, 2589, 1},
+    {0xFA49, 2590, 1},
+    {0xFA4A, 2591, 1},
+    {0xFA4B, 2592, 1},
+    {0xFA4C, 2593, 1},
+    {0xFA4D, 2594, 1},
+    {0xFA4E, 2595, 1},
+    {0xFA4F, 2596, 1},
+    {0xFA50, 2597, 1},
+    {0xFA51, 2598, 1},
+    {0xFA52, 2599, 1},
+    {0xFA53, 2600, 1},
+    {0xFA54, 2601, 1},
+    {0xFA55, 2602, 1},
+    {0xFA56, 2603, 1},
+    {0xFA57, 2604, 1},
+    {0xFA58, 2605, 1},
+    {0xFA59, 2606, 1},
+    {0xFA5A, 2607, 1},
+    {0xFA5B, 2608, 1},
+    {0xFA5C, 2609, 1},
+    {0xFA5D, 2610, 1},
+    {0xFA5E, 2611, 1},
+    {0xFA5F, 2612, 1},
+    {0xFA60, 2613, 1},
+    {0xFA61, 2614, 1},
+    {0xFA62, 2615, 1},
+    {0xFA63, 2616, 1},
+    {0xFA64, 2617, 1},
+    {0xFA65, 2618, 1},
+    {0xFA66, 2619, 1},
+    {0xFA67, 2620, 1},
+    {0xFA68, 2621, 1},
+    {0xFA69, 2622, 1},
+    {0xFA6A, 2623, 1},
+    {0xFA6B, 2624, 1},
+    {0xFA6C, 2625, 1},
+    {0xFA6D, 2626, 1},
+    {0xFA70, 2627, 1},
+    {0xFA71, 2628, 1},
+    {0xFA72, 2629, 1},
+    {0xFA73, 2630, 1},
+    {0xFA74, 2631, 1},
+    {0xFA75, 2632, 1},
+    {0xFA76, 2633, 1},
+    {0xFA77, 2634, 1},
+    {0xFA78, 2635, 1},
+    {0xFA79, 2636, 1},
+    {0xFA7A, 2637, 1},
+    {0xFA7B, 2638, 1},
+    {0xFA7C, 2639, 1},
+    {0xFA7D, 2640, 1},
+    {0xFA7E, 2641, 1},
+    {0xFA7F, 2642, 1},
+    {0xFA80, 2643, 1},
+    {0xFA81, 2644, 1},
+    {0xFA82, 2645, 1},
+    {0xFA83, 2646, 1},
+    {0xFA84, 2647, 1},
+    {0xFA85, 2648, 1},
+    {0xFA86, 2649, 1},
+    {0xFA87, 2650, 1},
+    {0xFA88, 2651, 1},
+    {0xFA89, 2652, 1},
+    {0xFA8A, 2653, 1},
+    {0xFA8B, 2654, 1},
+    {0xFA8C, 2655, 1},
+    {0xFA8D, 2656, 1},
+    {0xFA8E, 2657, 1},
+    {0xFA8F, 2658, 1},
+    {0xFA90, 2659, 1},
+    {0xFA91, 2660, 1},
+    {0xFA92, 2661, 1},
+    {0xFA93, 2662, 1},
+    {0xFA94, 2663, 1},
+    {0xFA95, 2664, 1},
+    {0xFA96, 2665, 1},
+    {0xFA97, 2666, 1},
+    {0xFA98, 2667, 1},
+    {0xFA99, 2668, 1},
+    {0xFA9A, 2669, 1},
+    {0xFA9B, 2670, 1},
+    {0xFA9C, 2671, 1},
+    {0xFA9D, 2672, 1},
+    {0xFA9E, 2673, 1},
+    {0xFA9F, 2674, 1},
+    {0xFAA0, 2675, 1},
+    {0xFAA1, 2676, 1},
+    {0xFAA2, 2677, 1},
+    {0xFAA3, 2678, 1},
+    {0xFAA4, 2679, 1},
+    {0xFAA5, 2680, 1},
+    {0xFAA6, 2681, 1},
+    {0xFAA7, 2682, 1},
+    {0xFAA8, 2683, 1},
+    {0xFAA9, 2684, 1},
+    {0xFAAA, 2685, 1},
+    {0xFAAB, 2686, 1},
+    {0xFAAC, 2687, 1},
+    {0xFAAD, 2688, 1},
+    {0xFAAE, 2689, 1},
+    {0xFAAF, 2690, 1},
+    {0xFAB0, 2691, 1},
+    {0xFAB1, 2692, 1},
+    {0xFAB2, 2693, 1},
+    {0xFAB3, 2694, 1},
+    {0xFAB4, 2695, 1},
+    {0xFAB5, 2696, 1},
+    {0xFAB6, 2697, 1},
+    {0xFAB7, 2698, 1},
+    {0xFAB8, 2699, 1},
+    {0xFAB9, 2700, 1},
+    {0xFABA, 2701, 1},
+    {0xFABB, 2702, 1},
+    {0xFABC, 2703, 1},
+    {0xFABD, 2704, 1},
+    {0xFABE, 2705, 1},
+    {0xFABF, 2706, 1},
+    {0xFAC0, 2707, 1},
+    {0xFAC1, 2708, 1},
+    {0xFAC2, 2709, 1},
+    {0xFAC3, 2710, 1},
+    {0xFAC4, 2711, 1},
+    {0xFAC5, 2712, 1},
+    {0xFAC6, 2713, 1},
+    {0xFAC7, 2714, 1},
+    {0xFAC8, 2715, 1},
+    {0xFAC9, 2716, 1},
+    {0xFACA, 2717, 1},
+    {0xFACB, 2718, 1},
+    {0xFACC, 2719, 1},
+    {0xFACD, 2720, 1},
+    {0xFACE, 2721, 1},
+    {0xFACF, 2722, 1},
+    {0xFAD0, 2723, 1},
+    {0xFAD1, 2724, 1},
+    {0xFAD2, 2725, 1},
+    {0xFAD3, 2726, 1},
+    {0xFAD4, 2727, 1},
+    {0xFAD5, 2728, 1},
+    {0xFAD6, 2729, 1},
+    {0xFAD7, 2730, 1},
+    {0xFAD8, 2731, 1},
+    {0xFAD9, 2732, 1},
+    {0xFB1D, 2733, 2},
+    {0xFB1F, 2735, 2},
+    {0xFB2A, 2737, 2},
+    {0xFB2B, 2739, 2},
+    {0xFB2C, 2741, 3},
+    {0xFB2D, 2744, 3},
+    {0xFB2E, 2747, 2},
+    {0xFB2F, 2749, 2},
+    {0xFB30, 2751, 2},
+    {0xFB31, 2753, 2},
+    {0xFB32, 2755, 2},
+    {0xFB33, 2757, 2},
+    {0xFB34, 2759, 2},
+    {0xFB35, 2761, 2},
+    {0xFB36, 2763, 2},
+    {0xFB38, 2765, 2},
+    {0xFB39, 2767, 2},
+    {0xFB3A, 2769, 2},
+    {0xFB3B, 2771, 2},
+    {0xFB3C, 2773, 2},
+    {0xFB3E, 2775, 2},
+    {0xFB40, 2777, 2},
+    {0xFB41, 2779, 2},
+    {0xFB43, 2781, 2},
+    {0xFB44, 2783, 2},
+    {0xFB46, 2785, 2},
+    {0xFB47, 2787, 2},
+    {0xFB48, 2789, 2},
+    {0xFB49, 2791, 2},
+    {0xFB4A, 2793, 2},
+    {0xFB4B, 2795, 2},
+    {0xFB4C, 2797, 2},
+    {0xFB4D, 2799, 2},
+    {0xFB4E, 2801, 2},
+    {0x1109A, 2803, 2},
+    {0x1109C, 2805, 2},
+    {0x110AB, 2807, 2},
+    {0x1112E, 2809, 2},
+    {0x1112F, 2811, 2},
+    {0x1134B, 2813, 2},
+    {0x1134C, 2815, 2},
+    {0x114BB, 2817, 2},
+    {0x114BC, 2819, 2},
+    {0x114BE, 2821, 2},
+    {0x115BA, 2823, 2},
+    {0x115BB, 2825, 2},
+    {0x11938, 2827, 2},
+    {0x1D15E, 2829, 2},
+    {0x1D15F, 2831, 2},
+    {0x1D160, 2833, 3},
+    {0x1D161, 2836, 3},
+    {0x1D162, 2839, 3},
+    {0x1D163, 2842, 3},
+    {0x1D164, 2845, 3},
+    {0x1D1BB, 2848, 2},
+    {0x1D1BC, 2850, 2},
+    {0x1D1BD, 2852, 3},
+    {0x1D1BE, 2855, 3},
+    {0x1D1BF, 2858, 3},
+    {0x1D1C0, 2861, 3},
+    {0x2F800, 2864, 1},
+    {0x2F801, 2865, 1},
+    {0x2F802, 2866, 1},
+    {0x2F803, 2867, 1},
+    {0x2F804, 2868, 1},
+    {0x2F805, 2869, 1},
+    {0x2F806, 2870, 1},
+    {0x2F807, 2871, 1},
+    {0x2F808, 2872, 1},
+    {0x2F809, 2873, 1},
+    {0x2F80A, 2874, 1},
+    {0x2F80B, 2875, 1},
+    {0x2F80C, 2876, 1},
+    {0x2F80D, 2877, 1},
+    {0x2F80E, 2878, 1},
+    {0x2F80F, 2879, 1},
+    {0x2F810, 2880, 1},
+    {0x2F811, 2881, 1},
+    {0x2F812, 2882, 1},
+    {0x2F813, 2883, 1},
+    {0x2F814, 2884, 1},
+    {0x2F815, 2885, 1},
+    {0x2F816, 2886, 1},
+    {0x2F817, 2887, 1},
+    {0x2F818, 2888, 1},
+    {0x2F819, 2889, 1},
+    {0x2F81A, 2890, 1},
+    {0x2F81B, 2891, 1},
+    {0x2F81C, 2892, 1},
+    {0x2F81D, 2893, 1},
+    {0x2F81E, 2894, 1},
+    {0x2F81F, 2895, 1},
+    {0x2F820, 2896, 1},
+    {0x2F821, 2897, 1},
+    {0x2F822, 2898, 1},
+    {0x2F823, 2899, 1},
+    {0x2F824, 2900, 1},
+    {0x2F825, 2901, 1},
+    {0x2F826, 2902, 1},
+    {0x2F827, 2903, 1},
+    {0x2F828, 2904, 1},
+    {0x2F829, 2905, 1},
+    {0x2F82A, 2906, 1},
+    {0x2F82B, 2907, 1},
+    {0x2F82C, 2908, 1},
+    {0x2F82D, 2909, 1},
+    {0x2F82E, 2910, 1},
+    {0x2F82F, 2911, 1},
+    {0x2F830, 2912, 1},
+    {0x2F831, 2913, 1},
+    {0x2F832, 2914, 1},
+    {0x2F833, 2915, 1},
+    {0x2F834, 2916, 1},
+    {0x2F835, 2917, 1},
+    {0x2F836, 2918, 1},
+    {0x2F837, 2919, 1},
+    {0x2F838, 2920, 1},
+    {0x2F839, 2921, 1},
+    {0x2F83A, 2922, 1},
+    {0x2F83B, 2923, 1},
+    {0x2F83C, 2924, 1},
+    {0x2F83D, 2925, 1},
+    {0x2F83E, 2926, 1},
+    {0x2F83F, 2927, 1},
+    {0x2F840, 2928, 1},
+    {0x2F841, 2929, 1},
+    {0x2F842, 2930, 1},
+    {0x2F843, 2931, 1},
+    {0x2F844, 2932, 1},
+    {0x2F845, 2933, 1},
+    {0x2F846, 2934, 1},
+    {0x2F847, 2935, 1},
+    {0x2F848, 2936, 1},
+    {0x2F849, 2937, 1},
+    {0x2F84A, 2938, 1},
+    {0x2F84B, 2939, 1},
+    {0x2F84C, 2940, 1},
+    {0x2F84D, 2941, 1},
+    {0x2F84E, 2942, 1},
+    {0x2F84F, 2943, 1},
+    {0x2F850, 2944, 1},
+    {0x2F851, 2945, 1},
+    {0x2F852, 2946, 1},
+    {0x2F853, 2947, 1},
+    {0x2F854, 2948, 1},
+    {0x2F855, 2949, 1},
+    {0x2F856, 2950, 1},
+    {0x2F857, 2951, 1},
+    {0x2F858, 2952, 1},
+    {0x2F859, 2953, 1},
+    {0x2F85A, 2954, 1},
+    {0x2F85B, 2955, 1},
+    {0x2F85C, 2956, 1},
+    {0x2F85D, 2957, 1},
+    {0x2F85E, 2958, 1},
+    {0x2F85F, 2959, 1},
+    {0x2F860, 2960, 1},
+    {0x2F861, 2961, 1},
+    {0x2F862, 2962, 1},
+    {0x2F863, 2963, 1},
+    {0x2F864, 2964, 1},
+    {0x2F865, 2965, 1},
+    {0x2F866, 2966, 1},
+    {0x2F867, 2967, 1},
+    {0x2F868, 2968, 1},
+    {0x2F869, 2969, 1},
+    {0x2F86A, 2970, 1},
+    {0x2F86B, 2971, 1},
+    {0x2F86C, 2972, 1},
+    {0x2F86D, 2973, 1},
+    {0x2F86E, 2974, 1},
+    {0x2F86F, 2975, 1},
+    {0x2F870, 2976, 1},
+    {0x2F871, 2977, 1},
+    {0x2F872, 2978, 1},
+    {0x2F873, 2979, 1},
+    {0x2F874, 2980, 1},
+    {0x2F875, 2981, 1},
+    {0x2F876, 2982, 1},
+    {0x2F877, 2983, 1},
+    {0x2F878, 2984, 1},
+    {0x2F879, 2985, 1},
+    {0x2F87A, 2986, 1},
+    {0x2F87B, 2987, 1},
+    {0x2F87C, 2988, 1},
+    {0x2F87D, 2989, 1},
+    {0x2F87E, 2990, 1},
+    {0x2F87F, 2991, 1},
+    {0x2F880, 2992, 1},
+    {0x2F881, 2993, 1},
+    {0x2F882, 2994, 1},
+    {0x2F883, 2995, 1},
+    {0x2F884, 2996, 1},
+    {0x2F885, 2997, 1},
+    {0x2F886, 2998, 1},
+    {0x2F887, 2999, 1},
+    {0x2F888, 3000, 1},
+    {0x2F889, 3001, 1},
+    {0x2F88A, 3002, 1},
+    {0x2F88B, 3003, 1},
+    {0x2F88C, 3004, 1},
+    {0x2F88D, 3005, 1},
+    {0x2F88E, 3006, 1},
+    {0x2F88F, 3007, 1},
+    {0x2F890, 3008, 1},
+    {0x2F891, 3009, 1},
+    {0x2F892, 3010, 1},
+    {0x2F893, 3011, 1},
+    {0x2F894, 3012, 1},
+    {0x2F895, 3013, 1},
+    {0x2F896, 3014, 1},
+    {0x2F897, 3015, 1},
+    {0x2F898, 3016, 1},
+    {0x2F899, 3017, 1},
+    {0x2F89A, 3018, 1},
+    {0x2F89B, 3019, 1},
+    {0x2F89C, 3020, 1},
+    {0x2F89D, 3021, 1},
+    {0x2F89E, 3022, 1},
+    {0x2F89F, 3023, 1},
+    {0x2F8A0, 3024, 1},
+    {0x2F8A1, 3025, 1},
+    {0x2F8A2, 3026, 1},
+    {0x2F8A3, 3027, 1},
+    {0x2F8A4, 3028, 1},
+    {0x2F8A5, 3029, 1},
+    {0x2F8A6, 3030, 1},
+    {0x2F8A7, 3031, 1},
+    {0x2F8A8, 3032, 1},
+    {0x2F8A9, 3033, 1},
+    {0x2F8AA, 3034, 1},
+    {0x2F8AB, 3035, 1},
+    {0x2F8AC, 3036, 1},
+    {0x2F8AD, 3037, 1},
+    {0x2F8AE, 3038, 1},
+    {0x2F8AF, 3039, 1},
+    {0x2F8B0, 3040, 1},
+    {0x2F8B1, 3041, 1},
+    {0x2F8B2, 3042, 1},
+    {0x2F8B3, 3043, 1},
+    {0x2F8B4, 3044, 1},
+    {0x2F8B5, 3045, 1},
+    {0x2F8B6, 3046, 1},
+    {0x2F8B7, 3047, 1},
+    {0x2F8B8, 3048, 1},
+    {0x2F8B9, 3049, 1},
+    {0x2F8BA, 3050, 1},
+    {0x2F8BB, 3051, 1},
+    {0x2F8BC, 3052, 1},
+    {0x2F8BD, 3053, 1},
+    {0x2F8BE, 3054, 1},
+    {0x2F8BF, 3055, 1},
+    {0x2F8C0, 3056, 1},
+    {0x2F8C1, 3057, 1},
+    {0x2F8C2, 3058, 1},
+    {0x2F8C3, 3059, 1},
+    {0x2F8C4, 3060, 1},
+    {0x2F8C5, 3061, 1},
+    {0x2F8C6, 3062, 1},
+    {0x2F8C7, 3063, 1},
+    {0x2F8C8, 3064, 1},
+    {0x2F8C9, 3065, 1},
+    {0x2F8CA, 3066, 1},
+    {0x2F8CB, 3067, 1},
+    {0x2F8CC, 3068, 1},
+    {0x2F8CD, 3069, 1},
+    {0x2F8CE, 3070, 1},
+    {0x2F8CF, 3071, 1},
+    {0x2F8D0, 3072, 1},
+    {0x2F8D1, 3073, 1},
+    {0x2F8D2, 3074, 1},
+    {0x2F8D3, 3075, 1},
+    {0x2F8D4, 3076, 1},
+    {0x2F8D5, 3077, 1},
+    {0x2F8D6, 3078, 1},
+    {0x2F8D7, 3079, 1},
+    {0x2F8D8, 3080, 1},
+    {0x2F8D9, 3081, 1},
+    {0x2F8DA, 3082, 1},
+    {0x2F8DB, 3083, 1},
+    {0x2F8DC, 3084, 1},
+    {0x2F8DD, 3085, 1},
+    {0x2F8DE, 3086, 1},
+    {0x2F8DF, 3087, 1},
+    {0x2F8E0, 3088, 1},
+    {0x2F8E1, 3089, 1},
+    {0x2F8E2, 3090, 1},
+    {0x2F8E3, 3091, 1},
+    {0x2F8E4, 3092, 1},
+    {0x2F8E5, 3093, 1},
+    {0x2F8E6, 3094, 1},
+    {0x2F8E7, 3095, 1},
+    {0x2F8E8, 3096, 1},
+    {0x2F8E9, 3097, 1},
+    {0x2F8EA, 3098, 1},
+    {0x2F8EB, 3099, 1},
+    {0x2F8EC, 3100, 1},
+    {0x2F8ED, 3101, 1},
+    {0x2F8EE, 3102, 1},
+    {0x2F8EF, 3103, 1},
+    {0x2F8F0, 3104, 1},
+    {0x2F8F1, 3105, 1},
+    {0x2F8F2, 3106, 1},
+    {0x2F8F3, 3107, 1},
+    {0x2F8F4, 3108, 1},
+    {0x2F8F5, 3109, 1},
+    {0x2F8F6, 3110, 1},
+    {0x2F8F7, 3111, 1},
+    {0x2F8F8, 3112, 1},
+    {0x2F8F9, 3113, 1},
+    {0x2F8FA, 3114, 1},
+    {0x2F8FB, 3115, 1},
+    {0x2F8FC, 3116, 1},
+    {0x2F8FD, 3117, 1},
+    {0x2F8FE, 3118, 1},
+    {0x2F8FF, 3119, 1},
+    {0x2F900, 3120, 1},
+    {0x2F901, 3121, 1},
+    {0x2F902, 3122, 1},
+    {0x2F903, 3123, 1},
+    {0x2F904, 3124, 1},
+    {0x2F905, 3125, 1},
+    {0x2F906, 3126, 1},
+    {0x2F907, 3127, 1},
+    {0x2F908, 3128, 1},
+    {0x2F909, 3129, 1},
+    {0x2F90A, 3130, 1},
+    {0x2F90B, 3131, 1},
+    {0x2F90C, 3132, 1},
+    {0x2F90D, 3133, 1},
+    {0x2F90E, 3134, 1},
+    {0x2F90F, 3135, 1},
+    {0x2F910, 3136, 1},
+    {0x2F911, 3137, 1},
+    {0x2F912, 3138, 1},
+    {0x2F913, 3139, 1},
+    {0x2F914, 3140, 1},
+    {0x2F915, 3141, 1},
+    {0x2F916, 3142, 1},
+    {0x2F917, 3143, 1},
+    {0x2F918, 3144, 1},
+    {0x2F919, 3145, 1},
+    {0x2F91A, 3146, 1},
+    {0x2F91B, 3147, 1},
+    {0x2F91C, 3148, 1},
+    {0x2F91D, 3149, 1},
+    {0x2F91E, 3150, 1},
+    {0x2F91F, 3151, 1},
+    {0x2F920, 3152, 1},
+    {0x2F921, 3153, 1},
+    {0x2F922, 3154, 1},
+    {0x2F923, 3155, 1},
+    {0x2F924, 3156, 1},
+    {0x2F925, 3157, 1},
+    {0x2F926, 3158, 1},
+    {0x2F927, 3159, 1},
+    {0x2F928, 3160, 1},
+    {0x2F929, 3161, 1},
+    {0x2F92A, 3162, 1},
+    {0x2F92B, 3163, 1},
+    {0x2F92C, 3164, 1},
+    {0x2F92D, 3165, 1},
+    {0x2F92E, 3166, 1},
+    {0x2F92F, 3167, 1},
+    {0x2F930, 3168, 1},
+    {0x2F931, 3169, 1},
+    {0x2F932, 3170, 1},
+    {0x2F933, 3171, 1},
+    {0x2F934, 3172, 1},
+    {0x2F935, 3173, 1},
+    {0x2F936, 3174, 1},
+    {0x2F937, 3175, 1},
+    {0x2F938, 3176, 1},
+    {0x2F939, 3177, 1},
+    {0x2F93A, 3178, 1},
+    {0x2F93B, 3179, 1},
+    {0x2F93C, 3180, 1},
+    {0x2F93D, 3181, 1},
+    {0x2F93E, 3182, 1},
+    {0x2F93F, 3183, 1},
+    {0x2F940, 3184, 1},
+    {0x2F941, 3185, 1},
+    {0x2F942, 3186, 1},
+    {0x2F943, 3187, 1},
+    {0x2F944, 3188, 1},
+    {0x2F945, 3189, 1},
+    {0x2F946, 3190, 1},
+    {0x2F947, 3191, 1},
+    {0x2F948, 3192, 1},
+    {0x2F949, 3193, 1},
+    {0x2F94A, 3194, 1},
+    {0x2F94B, 3195, 1},
+    {0x2F94C, 3196, 1},
+    {0x2F94D, 3197, 1},
+    {0x2F94E, 3198, 1},
+    {0x2F94F, 3199, 1},
+    {0x2F950, 3200, 1},
+    {0x2F951, 3201, 1},
+    {0x2F952, 3202, 1},
+    {0x2F953, 3203, 1},
+    {0x2F954, 3204, 1},
+    {0x2F955, 3205, 1},
+    {0x2F956, 3206, 1},
+    {0x2F957, 3207, 1},
+    {0x2F958, 3208, 1},
+    {0x2F959, 3209, 1},
+    {0x2F95A, 3210, 1},
+    {0x2F95B, 3211, 1},
+    {0x2F95C, 3212, 1},
+    {0x2F95D, 3213, 1},
+    {0x2F95E, 3214, 1},
+    {0x2F95F, 3215, 1},
+    {0x2F960, 3216, 1},
+    {0x2F961, 3217, 1},
+    {0x2F962, 3218, 1},
+    {0x2F963, 3219, 1},
+    {0x2F964, 3220, 1},
+    {0x2F965, 3221, 1},
+    {0x2F966, 3222, 1},
+    {0x2F967, 3223, 1},
+    {0x2F968, 3224, 1},
+    {0x2F969, 3225, 1},
+    {0x2F96A, 3226, 1},
+    {0x2F96B, 3227, 1},
+    {0x2F96C, 3228, 1},
+    {0x2F96D, 3229, 1},
+    {0x2F96E, 3230, 1},
+    {0x2F96F, 3231, 1},
+    {0x2F970, 3232, 1},
+    {0x2F971, 3233, 1},
+    {0x2F972, 3234, 1},
+    {0x2F973, 3235, 1},
+    {0x2F974, 3236, 1},
+    {0x2F975, 3237, 1},
+    {0x2F976, 3238, 1},
+    {0x2F977, 3239, 1},
+    {0x2F978, 3240, 1},
+    {0x2F979, 3241, 1},
+    {0x2F97A, 3242, 1},
+    {0x2F97B, 3243, 1},
+    {0x2F97C, 3244, 1},
+    {0x2F97D, 3245, 1},
+    {0x2F97E, 3246, 1},
+    {0x2F97F, 3247, 1},
+    {0x2F980, 3248, 1},
+    {0x2F981, 3249, 1},
+    {0x2F982, 3250, 1},
+    {0x2F983, 3251, 1},
+    {0x2F984, 3252, 1},
+    {0x2F985, 3253, 1},
+    {0x2F986, 3254, 1},
+    {0x2F987, 3255, 1},
+    {0x2F988, 3256, 1},
+    {0x2F989, 3257, 1},
+    {0x2F98A, 3258, 1},
+    {0x2F98B, 3259, 1},
+    {0x2F98C, 3260, 1},
+    {0x2F98D, 3261, 1},
+    {0x2F98E, 3262, 1},
+    {0x2F98F, 3263, 1},
+    {0x2F990, 3264, 1},
+    {0x2F991, 3265, 1},
+    {0x2F992, 3266, 1},
+    {0x2F993, 3267, 1},
+    {0x2F994, 3268, 1},
+    {0x2F995, 3269, 1},
+    {0x2F996, 3270, 1},
+    {0x2F997, 3271, 1},
+    {0x2F998, 3272, 1},
+    {0x2F999, 3273, 1},
+    {0x2F99A, 3274, 1},
+    {0x2F99B, 3275, 1},
+    {0x2F99C, 3276, 1},
+    {0x2F99D, 3277, 1},
+    {0x2F99E, 3278, 1},
+    {0x2F99F, 3279, 1},
+    {0x2F9A0, 3280, 1},
+    {0x2F9A1, 3281, 1},
+    {0x2F9A2, 3282, 1},
+    {0x2F9A3, 3283, 1},
+    {0x2F9A4, 3284, 1},
+    {0x2F9A5, 3285, 1},
+    {0x2F9A6, 3286, 1},
+    {0x2F9A7, 3287, 1},
+    {0x2F9A8, 3288, 1},
+    {0x2F9A9, 3289, 1},
+    {0x2F9AA, 3290, 1},
+    {0x2F9AB, 3291, 1},
+    {0x2F9AC, 3292, 1},
+    {0x2F9AD, 3293, 1},
+    {0x2F9AE, 3294, 1},
+    {0x2F9AF, 3295, 1},
+    {0x2F9B0, 3296, 1},
+    {0x2F9B1, 3297, 1},
+    {0x2F9B2, 3298, 1},
+    {0x2F9B3, 3299, 1},
+    {0x2F9B4, 3300, 1},
+    {0x2F9B5, 3301, 1},
+    {0x2F9B6, 3302, 1},
+    {0x2F9B7, 3303, 1},
+    {0x2F9B8, 3304, 1},
+    {0x2F9B9, 3305, 1},
+    {0x2F9BA, 3306, 1},
+    {0x2F9BB, 3307, 1},
+    {0x2F9BC, 3308, 1},
+    {0x2F9BD, 3309, 1},
+    {0x2F9BE, 3310, 1},
+    {0x2F9BF, 3311, 1},
+    {0x2F9C0, 3312, 1},
+    {0x2F9C1, 3313, 1},
+    {0x2F9C2, 3314, 1},
+    {0x2F9C3, 3315, 1},
+    {0x2F9C4, 3316, 1},
+    {0x2F9C5, 3317, 1},
+    {0x2F9C6, 3318, 1},
+    {0x2F9C7, 3319, 1},
+    {0x2F9C8, 3320, 1},
+    {0x2F9C9, 3321, 1},
+    {0x2F9CA, 3322, 1},
+    {0x2F9CB, 3323, 1},
+    {0x2F9CC, 3324, 1},
+    {0x2F9CD, 3325, 1},
+    {0x2F9CE, 3326, 1},
+    {0x2F9CF, 3327, 1},
+    {0x2F9D0, 3328, 1},
+    {0x2F9D1, 3329, 1},
+    {0x2F9D2, 3330, 1},
+    {0x2F9D3, 3331, 1},
+    {0x2F9D4, 3332, 1},
+    {0x2F9D5, 3333, 1},
+    {0x2F9D6, 3334, 1},
+    {0x2F9D7, 3335, 1},
+    {0x2F9D8, 3336, 1},
+    {0x2F9D9, 3337, 1},
+    {0x2F9DA, 3338, 1},
+    {0x2F9DB, 3339, 1},
+    {0x2F9DC, 3340, 1},
+    {0x2F9DD, 3341, 1},
+    {0x2F9DE, 3342, 1},
+    {0x2F9DF, 3343, 1},
+    {0x2F9E0, 3344, 1},
+    {0x2F9E1, 3345, 1},
+    {0x2F9E2, 3346, 1},
+    {0x2F9E3, 3347, 1},
+    {0x2F9E4, 3348, 1},
+    {0x2F9E5, 3349, 1},
+    {0x2F9E6, 3350, 1},
+    {0x2F9E7, 3351, 1},
+    {0x2F9E8, 3352, 1},
+    {0x2F9E9, 3353, 1},
+    {0x2F9EA, 3354, 1},
+    {0x2F9EB, 3355, 1},
+    {0x2F9EC, 3356, 1},
+    {0x2F9ED, 3357, 1},
+    {0x2F9EE, 3358, 1},
+    {0x2F9EF, 3359, 1},
+    {0x2F9F0, 3360, 1},
+    {0x2F9F1, 3361, 1},
+    {0x2F9F2, 3362, 1},
+    {0x2F9F3, 3363, 1},
+    {0x2F9F4, 3364, 1},
+    {0x2F9F5, 3365, 1},
+    {0x2F9F6, 3366, 1},
+    {0x2F9F7, 3367, 1},
+    {0x2F9F8, 3368, 1},
+    {0x2F9F9, 3369, 1},
+    {0x2F9FA, 3370, 1},
+    {0x2F9FB, 3371, 1},
+    {0x2F9FC, 3372, 1},
+    {0x2F9FD, 3373, 1},
+    {0x2F9FE, 3374, 1},
+    {0x2F9FF, 3375, 1},
+    {0x2FA00, 3376, 1},
+    {0x2FA01, 3377, 1},
+    {0x2FA02, 3378, 1},
+    {0x2FA03, 3379, 1},
+    {0x2FA04, 3380, 1},
+    {0x2FA05, 3381, 1},
+    {0x2FA06, 3382, 1},
+    {0x2FA07, 3383, 1},
+    {0x2FA08, 3384, 1},
+    {0x2FA09, 3385, 1},
+    {0x2FA0A, 3386, 1},
+    {0x2FA0B, 3387, 1},
+    {0x2FA0C, 3388, 1},
+    {0x2FA0D, 3389, 1},
+    {0x2FA0E, 3390, 1},
+    {0x2FA0F, 3391, 1},
+    {0x2FA10, 3392, 1},
+    {0x2FA11, 3393, 1},
+    {0x2FA12, 3394, 1},
+    {0x2FA13, 3395, 1},
+    {0x2FA14, 3396, 1},
+    {0x2FA15, 3397, 1},
+    {0x2FA16, 3398, 1},
+    {0x2FA17, 3399, 1},
+    {0x2FA18, 3400, 1},
+    {0x2FA19, 3401, 1},
+    {0x2FA1A, 3402, 1},
+    {0x2FA1B, 3403, 1},
+    {0x2FA1C, 3404, 1},
+    {0x2FA1D, 3405, 1},
+}};
+
+constexpr std::array<char32_t, 3406> kDecompositionData = {{
+    0x0041, 0x0300, 0x0041, 0x0301, 0x0041, 0x0302, 0x0041, 0x0303, 0x0041, 0x0308, 0x0041, 0x030A,
+    0x0043, 0x0327, 0x0045, 0x0300, 0x0045, 0x0301, 0x0045, 0x0302, 0x0045, 0x0308, 0x0049, 0x0300,
+    0x0049, 0x0301, 0x0049, 0x0302, 0x0049, 0x0308, 0x004E, 0x0303, 0x004F, 0x0300, 0x004F, 0x0301,
+    0x004F, 0x0302, 0x004F, 0x0303, 0x004F, 0x0308, 0x0055, 0x0300, 0x0055, 0x0301, 0x0055, 0x0302,
+    0x0055, 0x0308, 0x0059, 0x0301, 0x0061, 0x0300, 0x0061, 0x0301, 0x0061, 0x0302, 0x0061, 0x0303,
+    0x0061, 0x0308, 0x0061, 0x030A, 0x0063, 0x0327, 0x0065, 0x0300, 0x0065, 0x0301, 0x0065, 0x0302,
+    0x0065, 0x0308, 0x0069, 0x0300, 0x0069, 0x0301, 0x0069, 0x0302, 0x0069, 0x0308, 0x006E, 0x0303,
+    0x006F, 0x0300, 0x006F, 0x0301, 0x006F, 0x0302, 0x006F, 0x0303, 0x006F, 0x0308, 0x0075, 0x0300,
+    0x0075, 0x0301, 0x0075, 0x0302, 0x0075, 0x0308, 0x0079, 0x0301, 0x0079, 0x0308, 0x0041, 0x0304,
+    0x0061, 0x0304, 0x0041, 0x0306, 0x0061, 0x0306, 0x0041, 0x0328, 0x0061, 0x0328, 0x0043, 0x0301,
+    0x0063, 0x0301, 0x0043, 0x0302, 0x0063, 0x0302, 0x0043, 0x0307, 0x0063, 0x0307, 0x0043, 0x030C,
+    0x0063, 0x030C, 0x0044, 0x030C, 0x0064, 0x030C, 0x0045, 0x0304, 0x0065, 0x0304, 0x0045, 0x0306,
+    0x0065, 0x0306, 0x0045, 0x0307, 0x0065, 0x0307, 0x0045, 0x0328, 0x0065, 0x0328, 0x0045, 0x030C,
+    0x0065, 0x030C, 0x0047, 0x0302, 0x0067, 0x0302, 0x0047, 0x0306, 0x0067, 0x0306, 0x0047, 0x0307,
+    0x0067, 0x0307, 0x0047, 0x0327, 0x0067, 0x0327, 0x0048, 0x0302, 0x0068, 0x0302, 0x0049, 0x0303,
+    0x0069, 0x0303, 0x0049, 0x0304, 0x0069, 0x0304, 0x0049, 0x0306, 0x0069, 0x0306, 0x0049, 0x0328,
+    0x0069, 0x0328, 0x0049, 0x0307, 0x004A, 0x0302, 0x006A, 0x0302, 0x004B, 0x0327, 0x006B, 0x0327,
+    0x004C, 0x0301, 0x006C, 0x0301, 0x004C, 0x0327, 0x006C, 0x0327, 0x004C, 0x030C, 0x006C, 0x030C,
+    0x004E, 0x0301, 0x006E, 0x0301, 0x004E, 0x0327, 0x006E, 0x0327, 0x004E, 0x030C, 0x006E, 0x030C,
+    0x004F, 0x0304, 0x006F, 0x0304, 0x004F, 0x0306, 0x006F, 0x0306, 0x004F, 0x030B, 0x006F, 0x030B,
+    0x0052, 0x0301, 0x0072, 0x0301, 0x0052, 0x0327, 0x0072, 0x0327, 0x0052, 0x030C, 0x0072, 0x030C,
+    0x0053, 0x0301, 0x0073, 0x0301, 0x0053, 0x0302, 0x0073, 0x0302, 0x0053, 0x0327, 0x0073, 0x0327,
+    0x0053, 0x030C, 0x0073, 0x030C, 0x0054, 0x0327, 0x0074, 0x0327, 0x0054, 0x030C, 0x0074, 0x030C,
+    0x0055, 0x0303, 0x0075, 0x0303, 0x0055, 0x0304, 0x0075, 0x0304, 0x0055, 0x0306, 0x0075, 0x0306,
+    0x0055, 0x030A, 0x0075, 0x030A, 0x0055, 0x030B, 0x0075, 0x030B, 0x0055, 0x0328, 0x0075, 0x0328,
+    0x0057, 0x0302, 0x0077, 0x0302, 0x0059, 0x0302, 0x0079, 0x0302, 0x0059, 0x0308, 0x005A, 0x0301,
+    0x007A, 0x0301, 0x005A, 0x0307, 0x007A, 0x0307, 0x005A, 0x030C, 0x007A, 0x030C, 0x004F, 0x031B,
+    0x006F, 0x031B, 0x0055, 0x031B, 0x0075, 0x031B, 0x0041, 0x030C, 0x0061, 0x030C, 0x0049, 0x030C,
+    0x0069, 0x030C, 0x004F, 0x030C, 0x006F, 0x030C, 0x0055, 0x030C, 0x0075, 0x030C, 0x0055, 0x0308,
+    0x0304, 0x0075, 0x0308, 0x0304, 0x0055, 0x0308, 0x0301, 0x0075, 0x0308, 0x0301, 0x0055, 0x0308,
+    0x030C, 0x0075, 0x0308, 0x030C, 0x0055, 0x0308, 0x0300, 0x0075, 0x0308, 0x0300, 0x0041, 0x0308,
+    0x0304, 0x0061, 0x0308, 0x0304, 0x0041, 0x0307, 0x0304, 0x0061, 0x0307, 0x0304, 0x00C6, 0x0304,
+    0x00E6, 0x0304, 0x0047, 0x030C, 0x0067, 0x030C, 0x004B, 0x030C, 0x006B, 0x030C, 0x004F, 0x0328,
+    0x006F, 0x0328, 0x004F, 0x0328, 0x0304, 0x006F, 0x0328, 0x0304, 0x01B7, 0x030C, 0x0292, 0x030C,
+    0x006A, 0x030C, 0x0047, 0x0301, 0x0067, 0x0301, 0x004E, 0x0300, 0x006E, 0x0300, 0x0041, 0x030A,
+    0x0301, 0x0061, 0x030A, 0x0301, 0x00C6, 0x0301, 0x00E6, 0x0301, 0x00D8, 0x0301, 0x00F8, 0x0301,
+    0x0041, 0x030F, 0x0061, 0x030F, 0x0041, 0x0311, 0x0061, 0x0311, 0x0045, 0x030F, 0x0065, 0x030F,
+    0x0045, 0x0311, 0x0065, 0x0311, 0x0049, 0x030F, 0x0069, 0x030F, 0x0049, 0x0311, 0x0069, 0x0311,
+    0x004F, 0x030F, 0x006F, 0x030F, 0x004F, 0x0311, 0x006F, 0x0311, 0x0052, 0x030F, 0x0072, 0x030F,
+    0x0052, 0x0311, 0x0072, 0x0311, 0x0055, 0x030F, 0x0075, 0x030F, 0x0055, 0x0311, 0x0075, 0x0311,
+    0x0053, 0x0326, 0x0073, 0x0326, 0x0054, 0x0326, 0x0074, 0x0326, 0x0048, 0x030C, 0x0068, 0x030C,
+    0x0041, 0x0307, 0x0061, 0x0307, 0x0045, 0x0327, 0x0065, 0x0327, 0x004F, 0x0308, 0x0304, 0x006F,
+    0x0308, 0x0304, 0x004F, 0x0303, 0x0304, 0x006F, 0x0303, 0x0304, 0x004F, 0x0307, 0x006F, 0x0307,
+    0x004F, 0x0307, 0x0304, 0x006F, 0x0307, 0x0304, 0x0059, 0x0304, 0x0079, 0x0304, 0x0300, 0x0301,
+    0x0313, 0x0308, 0x0301, 0x02B9, 0x003B, 0x00A8, 0x0301, 0x0391, 0x0301, 0x00B7, 0x0395, 0x0301,
+    0x0397, 0x0301, 0x0399, 0x0301, 0x039F, 0x0301, 0x03A5, 0x0301, 0x03A9, 0x0301, 0x03B9, 0x0308,
+    0x0301, 0x0399, 0x0308, 0x03A5, 0x0308, 0x03B1, 0x0301, 0x03B5, 0x0301, 0x03B7, 0x0301, 0x03B9,
+    0x0301, 0x03C5, 0x0308, 0x0301, 0x03B9, 0x0308, 0x03C5, 0x0308, 0x03BF, 0x0301, 0x03C5, 0x0301,
+    0x03C9, 0x0301, 0x03D2, 0x0301, 0x03D2, 0x0308, 0x0415, 0x0300, 0x0415, 0x0308, 0x0413, 0x0301,
+    0x0406, 0x0308, 0x041A, 0x0301, 0x0418, 0x0300, 0x0423, 0x0306, 0x0418, 0x0306, 0x0438, 0x0306,
+    0x0435, 0x0300, 0x0435, 0x0308, 0x0433, 0x0301, 0x0456, 0x0308, 0x043A, 0x0301, 0x0438, 0x0300,
+    0x0443, 0x0306, 0x0474, 0x030F, 0x0475, 0x030F, 0x0416, 0x0306, 0x0436, 0x0306, 0x0410, 0x0306,
+    0x0430, 0x0306, 0x0410, 0x0308, 0x0430, 0x0308, 0x0415, 0x0306, 0x0435, 0x0306, 0x04D8, 0x0308,
+    0x04D9, 0x0308, 0x0416, 0x0308, 0x0436, 0x0308, 0x0417, 0x0308, 0x0437, 0x0308, 0x0418, 0x0304,
+    0x0438, 0x0304, 0x0418, 0x0308, 0x0438, 0x0308, 0x041E, 0x0308, 0x043E, 0x0308, 0x04E8, 0x0308,
+    0x04E9, 0x0308, 0x042D, 0x0308, 0x044D, 0x0308, 0x0423, 0x0304, 0x0443, 0x0304, 0x0423, 0x0308,
+    0x0443, 0x0308, 0x0423, 0x030B, 0x0443, 0x030B, 0x0427, 0x0308, 0x0447, 0x0308, 0x042B, 0x0308,
+    0x044B, 0x0308, 0x0627, 0x0653, 0x0627, 0x0654, 0x0648, 0x0654, 0x0627, 0x0655, 0x064A, 0x0654,
+    0x06D5, 0x0654, 0x06C1, 0x0654, 0x06D2, 0x0654, 0x0928, 0x093C, 0x0930, 0x093C, 0x0933, 0x093C,
+    0x0915, 0x093C, 0x0916, 0x093C, 0x0917, 0x093C, 0x091C, 0x093C, 0x0921, 0x093C, 0x0922, 0x093C,
+    0x092B, 0x093C, 0x092F, 0x093C, 0x09C7, 0x09BE, 0x09C7, 0x09D7, 0x09A1, 0x09BC, 0x09A2, 0x09BC,
+    0x09AF, 0x09BC, 0x0A32, 0x0A3C, 0x0A38, 0x0A3C, 0x0A16, 0x0A3C, 0x0A17, 0x0A3C, 0x0A1C, 0x0A3C,
+    0x0A2B, 0x0A3C, 0x0B47, 0x0B56, 0x0B47, 0x0B3E, 0x0B47, 0x0B57, 0x0B21, 0x0B3C, 0x0B22, 0x0B3C,
+    0x0B92, 0x0BD7, 0x0BC6, 0x0BBE, 0x0BC7, 0x0BBE, 0x0BC6, 0x0BD7, 0x0C46, 0x0C56, 0x0CBF, 0x0CD5,
+    0x0CC6, 0x0CD5, 0x0CC6, 0x0CD6, 0x0CC6, 0x0CC2, 0x0CC6, 0x0CC2, 0x0CD5, 0x0D46, 0x0D3E, 0x0D47,
+    0x0D3E, 0x0D46, 0x0D57, 0x0DD9, 0x0DCA, 0x0DD9, 0x0DCF, 0x0DD9, 0x0DCF, 0x0DCA, 0x0DD9, 0x0DDF,
+    0x0F42, 0x0FB7, 0x0F4C, 0x0FB7, 0x0F51, 0x0FB7, 0x0F56, 0x0FB7, 0x0F5B, 0x0FB7, 0x0F40, 0x0FB5,
+    0x0F71, 0x0F72, 0x0F71, 0x0F74, 0x0FB2, 0x0F80, 0x0FB3, 0x0F80, 0x0F71, 0x0F80, 0x0F92, 0x0FB7,
+    0x0F9C, 0x0FB7, 0x0FA1, 0x0FB7, 0x0FA6, 0x0FB7, 0x0FAB, 0x0FB7, 0x0F90, 0x0FB5, 0x1025, 0x102E,
+    0x1B05, 0x1B35, 0x1B07, 0x1B35, 0x1B09, 0x1B35, 0x1B0B, 0x1B35, 0x1B0D, 0x1B35, 0x1B11, 0x1B35,
+    0x1B3A, 0x1B35, 0x1B3C, 0x1B35, 0x1B3E, 0x1B35, 0x1B3F, 0x1B35, 0x1B42, 0x1B35, 0x0041, 0x0325,
+    0x0061, 0x0325, 0x0042, 0x0307, 0x0062, 0x0307, 0x0042, 0x0323, 0x0062, 0x0323, 0x0042, 0x0331,
+    0x0062, 0x0331, 0x0043, 0x0327, 0x0301, 0x0063, 0x0327, 0x0301, 0x0044, 0x0307, 0x0064, 0x0307,
+    0x0044, 0x0323, 0x0064, 0x0323, 0x0044, 0x0331, 0x0064, 0x0331, 0x0044, 0x0327, 0x0064, 0x0327,
+    0x0044, 0x032D, 0x0064, 0x032D, 0x0045, 0x0304, 0x0300, 0x0065, 0x0304, 0x0300, 0x0045, 0x0304,
+    0x0301, 0x0065, 0x0304, 0x0301, 0x0045, 0x032D, 0x0065, 0x032D, 0x0045, 0x0330, 0x0065, 0x0330,
+    0x0045, 0x0327, 0x0306, 0x0065, 0x0327, 0x0306, 0x0046, 0x0307, 0x0066, 0x0307, 0x0047, 0x0304,
+    0x0067, 0x0304, 0x0048, 0x0307, 0x0068, 0x0307, 0x0048, 0x0323, 0x0068, 0x0323, 0x0048, 0x0308,
+    0x0068, 0x0308, 0x0048, 0x0327, 0x0068, 0x0327, 0x0048, 0x032E, 0x0068, 0x032E, 0x0049, 0x0330,
+    0x0069, 0x0330, 0x0049, 0x0308, 0x0301, 0x0069, 0x0308, 0x0301, 0x004B, 0x0301, 0x006B, 0x0301,
+    0x004B, 0x0323, 0x006B, 0x0323, 0x004B, 0x0331, 0x006B, 0x0331, 0x004C, 0x0323, 0x006C, 0x0323,
+    0x004C, 0x0323, 0x0304, 0x006C, 0x0323, 0x0304, 0x004C, 0x0331, 0x006C, 0x0331, 0x004C, 0x032D,
+    0x006C, 0x032D, 0x004D, 0x0301, 0x006D, 0x0301, 0x004D, 0x0307, 0x006D, 0x0307, 0x004D, 0x0323,
+    0x006D, 0x0323, 0x004E, 0x0307, 0x006E, 0x0307, 0x004E, 0x0323, 0x006E, 0x0323, 0x004E, 0x0331,
+    0x006E, 0x0331, 0x004E, 0x032D, 0x006E, 0x032D, 0x004F, 0x0303, 0x0301, 0x006F, 0x0303, 0x0301,
+    0x004F, 0x0303, 0x0308, 0x006F, 0x0303, 0x0308, 0x004F, 0x0304, 0x0300, 0x006F, 0x0304, 0x0300,
+    0x004F, 0x0304, 0x0301, 0x006F, 0x0304, 0x0301, 0x0050, 0x0301, 0x0070, 0x0301, 0x0050, 0x0307,
+    0x0070, 0x0307, 0x0052, 0x0307, 0x0072, 0x0307, 0x0052, 0x0323, 0x0072, 0x0323, 0x0052, 0x0323,
+    0x0304, 0x0072, 0x0323, 0x0304, 0x0052, 0x0331, 0x0072, 0x0331, 0x0053, 0x0307, 0x0073, 0x0307,
+    0x0053, 0x0323, 0x0073, 0x0323, 0x0053, 0x0301, 0x0307, 0x0073, 0x0301, 0x0307, 0x0053, 0x030C,
+    0x0307, 0x0073, 0x030C, 0x0307, 0x0053, 0x0323, 0x0307, 0x0073, 0x0323, 0x0307, 0x0054, 0x0307,
+    0x0074, 0x0307, 0x0054, 0x0323, 0x0074, 0x0323, 0x0054, 0x0331, 0x0074, 0x0331, 0x0054, 0x032D,
+    0x0074, 0x032D, 0x0055, 0x0324, 0x0075, 0x0324, 0x0055, 0x0330, 0x0075, 0x0330, 0x0055, 0x032D,
+    0x0075, 0x032D, 0x0055, 0x0303, 0x0301, 0x0075, 0x0303, 0x0301, 0x0055, 0x0304, 0x0308, 0x0075,
+    0x0304, 0x0308, 0x0056, 0x0303, 0x0076, 0x0303, 0x0056, 0x0323, 0x0076, 0x0323, 0x0057, 0x0300,
+    0x0077, 0x0300, 0x0057, 0x0301, 0x0077, 0x0301, 0x0057, 0x0308, 0x0077, 0x0308, 0x0057, 0x0307,
+    0x0077, 0x0307, 0x0057, 0x0323, 0x0077, 0x0323, 0x0058, 0x0307, 0x0078, 0x0307, 0x0058, 0x0308,
+    0x0078, 0x0308, 0x0059, 0x0307, 0x0079, 0x0307, 0x005A, 0x0302, 0x007A, 0x0302, 0x005A, 0x0323,
+    0x007A, 0x0323, 0x005A, 0x0331, 0x007A, 0x0331, 0x0068, 0x0331, 0x0074, 0x0308, 0x0077, 0x030A,
+    0x0079, 0x030A, 0x017F, 0x0307, 0x0041, 0x0323, 0x0061, 0x0323, 0x0041, 0x0309, 0x0061, 0x0309,
+    0x0041, 0x0302, 0x0301, 0x0061, 0x0302, 0x0301, 0x0041, 0x0302, 0x0300, 0x0061, 0x0302, 0x0300,
+    0x0041, 0x0302, 0x0309, 0x0061, 0x0302, 0x0309, 0x0041, 0x0302, 0x0303, 0x0061, 0x0302, 0x0303,
+    0x0041, 0x0323, 0x0302, 0x0061, 0x0323, 0x0302, 0x0041, 0x0306, 0x0301, 0x0061, 0x0306, 0x0301,
+    0x0041, 0x0306, 0x0300, 0x0061, 0x0306, 0x0300, 0x0041, 0x0306, 0x0309, 0x0061, 0x0306, 0x0309,
+    0x0041, 0x0306, 0x0303, 0x0061, 0x0306, 0x0303, 0x0041, 0x0323, 0x0306, 0x0061, 0x0323, 0x0306,
+    0x0045, 0x0323, 0x0065, 0x0323, 0x0045, 0x0309, 0x0065, 0x0309, 0x0045, 0x0303, 0x0065, 0x0303,
+    0x0045, 0x0302, 0x0301, 0x0065, 0x0302, 0x0301, 0x0045, 0x0302, 0x0300, 0x0065, 0x0302, 0x0300,
+    0x0045, 0x0302, 0x0309, 0x0065, 0x0302, 0x0309, 0x0045, 0x0302, 0x0303, 0x0065, 0x0302, 0x0303,
+    0x0045, 0x0323, 0x0302, 0x0065, 0x0323, 0x0302, 0x0049, 0x0309, 0x0069, 0x0309, 0x0049, 0x0323,
+    0x0069, 0x0323, 0x004F, 0x0323, 0x006F, 0x0323, 0x004F, 0x0309, 0x006F, 0x0309, 0x004F, 0x0302,
+    0x0301, 0x006F, 0x0302, 0x0301, 0x004F, 0x0302, 0x0300, 0x006F, 0x0302, 0x0300, 0x004F, 0x0302,
+    0x0309, 0x006F, 0x0302, 0x0309, 0x004F, 0x0302, 0x0303, 0x006F, 0x0302, 0x0303, 0x004F, 0x0323,
+    0x0302, 0x006F, 0x0323, 0x0302, 0x004F, 0x031B, 0x0301, 0x006F, 0x031B, 0x0301, 0x004F, 0x031B,
+    0x0300, 0x006F, 0x031B, 0x0300, 0x004F, 0x031B, 0x0309, 0x006F, 0x031B, 0x0309, 0x004F, 0x031B,
+    0x0303, 0x006F, 0x031B, 0x0303, 0x004F, 0x031B, 0x0323, 0x006F, 0x031B, 0x0323, 0x0055, 0x0323,
+    0x0075, 0x0323, 0x0055, 0x0309, 0x0075, 0x0309, 0x0055, 0x031B, 0x0301, 0x0075, 0x031B, 0x0301,
+    0x0055, 0x031B, 0x0300, 0x0075, 0x031B, 0x0300, 0x0055, 0x031B, 0x0309, 0x0075, 0x031B, 0x0309,
+    0x0055, 0x031B, 0x0303, 0x0075, 0x031B, 0x0303, 0x0055, 0x031B, 0x0323, 0x0075, 0x031B, 0x0323,
+    0x0059, 0x0300, 0x0079, 0x0300, 0x0059, 0x0323, 0x0079, 0x0323, 0x0059, 0x0309, 0x0079, 0x0309,
+    0x0059, 0x0303, 0x0079, 0x0303, 0x03B1, 0x0313, 0x03B1, 0x0314, 0x03B1, 0x0313, 0x0300, 0x03B1,
+    0x0314, 0x0300, 0x03B1, 0x0313, 0x0301, 0x03B1, 0x0314, 0x0301, 0x03B1, 0x0313, 0x0342, 0x03B1,
+    0x0314, 0x0342, 0x0391, 0x0313, 0x0391, 0x0314, 0x0391, 0x0313, 0x0300, 0x0391, 0x0314, 0x0300,
+    0x0391, 0x0313, 0x0301, 0x0391, 0x0314, 0x0301, 0x0391, 0x0313, 0x0342, 0x0391, 0x0314, 0x0342,
+    0x03B5, 0x0313, 0x03B5, 0x0314, 0x03B5, 0x0313, 0x0300, 0x03B5, 0x0314, 0x0300, 0x03B5, 0x0313,
+    0x0301, 0x03B5, 0x0314, 0x0301, 0x0395, 0x0313, 0x0395, 0x0314, 0x0395, 0x0313, 0x0300, 0x0395,
+    0x0314, 0x0300, 0x0395, 0x0313, 0x0301, 0x0395, 0x0314, 0x0301, 0x03B7, 0x0313, 0x03B7, 0x0314,
+    0x03B7, 0x0313, 0x0300, 0x03B7, 0x0314, 0x0300, 0x03B7, 0x0313, 0x0301, 0x03B7, 0x0314, 0x0301,
+    0x03B7, 0x0313, 0x0342, 0x03B7, 0x0314, 0x0342, 0x0397, 0x0313, 0x0397, 0x0314, 0x0397, 0x0313,
+    0x0300, 0x0397, 0x0314, 0x0300, 0x0397, 0x0313, 0x0301, 0x0397, 0x0314, 0x0301, 0x0397, 0x0313,
+    0x0342, 0x0397, 0x0314, 0x0342, 0x03B9, 0x0313, 0x03B9, 0x0314, 0x03B9, 0x0313, 0x0300, 0x03B9,
+    0x0314, 0x0300, 0x03B9, 0x0313, 0x0301, 0x03B9, 0x0314, 0x0301, 0x03B9, 0x0313, 0x0342, 0x03B9,
+    0x0314, 0x0342, 0x0399, 0x0313, 0x0399, 0x0314, 0x0399, 0x0313, 0x0300, 0x0399, 0x0314, 0x0300,
+    0x0399, 0x0313, 0x0301, 0x0399, 0x0314, 0x0301, 0x0399, 0x0313, 0x0342, 0x0399, 0x0314, 0x0342,
+    0x03BF, 0x0313, 0x03BF, 0x0314, 0x03BF, 0x0313, 0x0300, 0x03BF, 0x0314, 0x0300, 0x03BF, 0x0313,
+    0x0301, 0x03BF, 0x0314, 0x0301, 0x039F, 0x0313, 0x039F, 0x0314, 0x039F, 0x0313, 0x0300, 0x039F,
+    0x0314, 0x0300, 0x039F, 0x0313, 0x0301, 0x039F, 0x0314, 0x0301, 0x03C5, 0x0313, 0x03C5, 0x0314,
+    0x03C5, 0x0313, 0x0300, 0x03C5, 0x0314, 0x0300, 0x03C5, 0x0313, 0x0301, 0x03C5, 0x0314, 0x0301,
+    0x03C5, 0x0313, 0x0342, 0x03C5, 0x0314, 0x0342, 0x03A5, 0x0314, 0x03A5, 0x0314, 0x0300, 0x03A5,
+    0x0314, 0x0301, 0x03A5, 0x0314, 0x0342, 0x03C9, 0x0313, 0x03C9, 0x0314, 0x03C9, 0x0313, 0x0300,
+    0x03C9, 0x0314, 0x0300, 0x03C9, 0x0313, 0x0301, 0x03C9, 0x0314, 0x0301, 0x03C9, 0x0313, 0x0342,
+    0x03C9, 0x0314, 0x0342, 0x03A9, 0x0313, 0x03A9, 0x0314, 0x03A9, 0x0313, 0x0300, 0x03A9, 0x0314,
+    0x0300, 0x03A9, 0x0313, 0x0301, 0x03A9, 0x0314, 0x0301, 0x03A9, 0x0313, 0x0342, 0x03A9, 0x0314,
+    0x0342, 0x03B1, 0x0300, 0x03B1, 0x0301, 0x03B5, 0x0300, 0x03B5, 0x0301, 0x03B7, 0x0300, 0x03B7,
+    0x0301, 0x03B9, 0x0300, 0x03B9, 0x0301, 0x03BF, 0x0300, 0x03BF, 0x0301, 0x03C5, 0x0300, 0x03C5,
+    0x0301, 0x03C9, 0x0300, 0x03C9, 0x0301, 0x03B1, 0x0313, 0x0345, 0x03B1, 0x0314, 0x0345, 0x03B1,
+    0x0313, 0x0300, 0x0345, 0x03B1, 0x0314, 0x0300, 0x0345, 0x03B1, 0x0313, 0x0301, 0x0345, 0x03B1,
+    0x0314, 0x0301, 0x0345, 0x03B1, 0x0313, 0x0342, 0x0345, 0x03B1, 0x0314, 0x0342, 0x0345, 0x0391,
+    0x0313, 0x0345, 0x0391, 0x0314, 0x0345, 0x0391, 0x0313, 0x0300, 0x0345, 0x0391, 0x0314, 0x0300,
+    0x0345, 0x0391, 0x0313, 0x0301, 0x0345, 0x0391, 0x0314, 0x0301, 0x0345, 0x0391, 0x0313, 0x0342,
+    0x0345, 0x0391, 0x0314, 0x0342, 0x0345, 0x03B7, 0x0313, 0x0345, 0x03B7, 0x0314, 0x0345, 0x03B7,
+    0x0313, 0x0300, 0x0345, 0x03B7, 0x0314, 0x0300, 0x0345, 0x03B7, 0x0313, 0x0301, 0x0345, 0x03B7,
+    0x0314, 0x0301, 0x0345, 0x03B7, 0x0313, 0x0342, 0x0345, 0x03B7, 0x0314, 0x0342, 0x0345, 0x0397,
+    0x0313, 0x0345, 0x0397, 0x0314, 0x0345, 0x0397, 0x0313, 0x0300, 0x0345, 0x0397, 0x0314, 0x0300,
+    0x0345, 0x0397, 0x0313, 0x0301, 0x0345, 0x0397, 0x0314, 0x0301, 0x0345, 0x0397, 0x0313, 0x0342,
+    0x0345, 0x0397, 0x0314, 0x0342, 0x0345, 0x03C9, 0x0313, 0x0345, 0x03C9, 0x0314, 0x0345, 0x03C9,
+    0x0313, 0x0300, 0x0345, 0x03C9, 0x0314, 0x0300, 0x0345, 0x03C9, 0x0313, 0x0301, 0x0345, 0x03C9,
+    0x0314, 0x0301, 0x0345, 0x03C9, 0x0313, 0x0342, 0x0345, 0x03C9, 0x0314, 0x0342, 0x0345, 0x03A9,
+    0x0313, 0x0345, 0x03A9, 0x0314, 0x0345, 0x03A9, 0x0313, 0x0300, 0x0345, 0x03A9, 0x0314, 0x0300,
+    0x0345, 0x03A9, 0x0313, 0x0301, 0x0345, 0x03A9, 0x0314, 0x0301, 0x0345, 0x03A9, 0x0313, 0x0342,
+    0x0345, 0x03A9, 0x0314, 0x0342, 0x0345, 0x03B1, 0x0306, 0x03B1, 0x0304, 0x03B1, 0x0300, 0x0345,
+    0x03B1, 0x0345, 0x03B1, 0x0301, 0x0345, 0x03B1, 0x0342, 0x03B1, 0x0342, 0x0345, 0x0391, 0x0306,
+    0x0391, 0x0304, 0x0391, 0x0300, 0x0391, 0x0301, 0x0391, 0x0345, 0x03B9, 0x00A8, 0x0342, 0x03B7,
+    0x0300, 0x0345, 0x03B7, 0x0345, 0x03B7, 0x0301, 0x0345, 0x03B7, 0x0342, 0x03B7, 0x0342, 0x0345,
+    0x0395, 0x0300, 0x0395, 0x0301, 0x0397, 0x0300, 0x0397, 0x0301, 0x0397, 0x0345, 0x1FBF, 0x0300,
+    0x1FBF, 0x0301, 0x1FBF, 0x0342, 0x03B9, 0x0306, 0x03B9, 0x0304, 0x03B9, 0x0308, 0x0300, 0x03B9,
+    0x0308, 0x0301, 0x03B9, 0x0342, 0x03B9, 0x0308, 0x0342, 0x0399, 0x0306, 0x0399, 0x0304, 0x0399,
+    0x0300, 0x0399, 0x0301, 0x1FFE, 0x0300, 0x1FFE, 0x0301, 0x1FFE, 0x0342, 0x03C5, 0x0306, 0x03C5,
+    0x0304, 0x03C5, 0x0308, 0x0300, 0x03C5, 0x0308, 0x0301, 0x03C1, 0x0313, 0x03C1, 0x0314, 0x03C5,
+    0x0342, 0x03C5, 0x0308, 0x0342, 0x03A5, 0x0306, 0x03A5, 0x0304, 0x03A5, 0x0300, 0x03A5, 0x0301,
+    0x03A1, 0x0314, 0x00A8, 0x0300, 0x00A8, 0x0301, 0x0060, 0x03C9, 0x0300, 0x0345, 0x03C9, 0x0345,
+    0x03C9, 0x0301, 0x0345, 0x03C9, 0x0342, 0x03C9, 0x0342, 0x0345, 0x039F, 0x0300, 0x039F, 0x0301,
+    0x03A9, 0x0300, 0x03A9, 0x0301, 0x03A9, 0x0345, 0x00B4, 0x2002, 0x2003, 0x03A9, 0x004B, 0x0041,
+    0x030A, 0x2190, 0x0338, 0x2192, 0x0338, 0x2194, 0x0338, 0x21D0, 0x0338, 0x21D4, 0x0338, 0x21D2,
+    0x0338, 0x2203, 0x0338, 0x2208, 0x0338, 0x220B, 0x0338, 0x2223, 0x0338, 0x2225, 0x0338, 0x223C,
+    0x0338, 0x2243, 0x0338, 0x2245, 0x0338, 0x2248, 0x0338, 0x003D, 0x0338, 0x2261, 0x0338, 0x224D,
+    0x0338, 0x003C, 0x0338, 0x003E, 0x0338, 0x2264, 0x0338, 0x2265, 0x0338, 0x2272, 0x0338, 0x2273,
+    0x0338, 0x2276, 0x0338, 0x2277, 0x0338, 0x227A, 0x0338, 0x227B, 0x0338, 0x2282, 0x0338, 0x2283,
+    0x0338, 0x2286, 0x0338, 0x2287, 0x0338, 0x22A2, 0x0338, 0x22A8, 0x0338, 0x22A9, 0x0338, 0x22AB,
+    0x0338, 0x227C, 0x0338, 0x227D, 0x0338, 0x2291, 0x0338, 0x2292, 0x0338, 0x22B2, 0x0338, 0x22B3,
+    0x0338, 0x22B4, 0x0338, 0x22B5, 0x0338, 0x3008, 0x3009, 0x2ADD, 0x0338, 0x304B, 0x3099, 0x304D,
+    0x3099, 0x304F, 0x3099, 0x3051, 0x3099, 0x3053, 0x3099, 0x3055, 0x3099, 0x3057, 0x3099, 0x3059,
+    0x3099, 0x305B, 0x3099, 0x305D, 0x3099, 0x305F, 0x3099, 0x3061, 0x3099, 0x3064, 0x3099, 0x3066,
+    0x3099, 0x3068, 0x3099, 0x306F, 0x3099, 0x306F, 0x309A, 0x3072, 0x3099, 0x3072, 0x309A, 0x3075,
+    0x3099, 0x3075, 0x309A, 0x3078, 0x3099, 0x3078, 0x309A, 0x307B, 0x3099, 0x307B, 0x309A, 0x3046,
+    0x3099, 0x309D, 0x3099, 0x30AB, 0x3099, 0x30AD, 0x3099, 0x30AF, 0x3099, 0x30B1, 0x3099, 0x30B3,
+    0x3099, 0x30B5, 0x3099, 0x30B7, 0x3099, 0x30B9, 0x3099, 0x30BB, 0x3099, 0x30BD, 0x3099, 0x30BF,
+    0x3099, 0x30C1, 0x3099, 0x30C4, 0x3099, 0x30C6, 0x3099, 0x30C8, 0x3099, 0x30CF, 0x3099, 0x30CF,
+    0x309A, 0x30D2, 0x3099, 0x30D2, 0x309A, 0x30D5, 0x3099, 0x30D5, 0x309A, 0x30D8, 0x3099, 0x30D8,
+    0x309A, 0x30DB, 0x3099, 0x30DB, 0x309A, 0x30A6, 0x3099, 0x30EF, 0x3099, 0x30F0, 0x3099, 0x30F1,
+    0x3099, 0x30F2, 0x3099, 0x30FD, 0x3099, 0x8C48, 0x66F4, 0x8ECA, 0x8CC8, 0x6ED1, 0x4E32, 0x53E5,
+    0x9F9C, 0x9F9C, 0x5951, 0x91D1, 0x5587, 0x5948, 0x61F6, 0x7669, 0x7F85, 0x863F, 0x87BA, 0x88F8,
+    0x908F, 0x6A02, 0x6D1B, 0x70D9, 0x73DE, 0x843D, 0x916A, 0x99F1, 0x4E82, 0x5375, 0x6B04, 0x721B,
+    0x862D, 0x9E1E, 0x5D50, 0x6FEB, 0x85CD, 0x8964, 0x62C9, 0x81D8, 0x881F, 0x5ECA, 0x6717, 0x6D6A,
+    0x72FC, 0x90CE, 0x4F86, 0x51B7, 0x52DE, 0x64C4, 0x6AD3, 0x7210, 0x76E7, 0x8001, 0x8606, 0x865C,
+    0x8DEF, 0x9732, 0x9B6F, 0x9DFA, 0x788C, 0x797F, 0x7DA0, 0x83C9, 0x9304, 0x9E7F, 0x8AD6, 0x58DF,
+    0x5F04, 0x7C60, 0x807E, 0x7262, 0x78CA, 0x8CC2, 0x96F7, 0x58D8, 0x5C62, 0x6A13, 0x6DDA, 0x6F0F,
+    0x7D2F, 0x7E37, 0x964B, 0x52D2, 0x808B, 0x51DC, 0x51CC, 0x7A1C, 0x7DBE, 0x83F1, 0x9675, 0x8B80,
+    0x62CF, 0x6A02, 0x8AFE, 0x4E39, 0x5BE7, 0x6012, 0x7387, 0x7570, 0x5317, 0x78FB, 0x4FBF, 0x5FA9,
+    0x4E0D, 0x6CCC, 0x6578, 0x7D22, 0x53C3, 0x585E, 0x7701, 0x8449, 0x8AAA, 0x6BBA, 0x8FB0, 0x6C88,
+    0x62FE, 0x82E5, 0x63A0, 0x7565, 0x4EAE, 0x5169, 0x51C9, 0x6881, 0x7CE7, 0x826F, 0x8AD2, 0x91CF,
+    0x52F5, 0x5442, 0x5973, 0x5EEC, 0x65C5, 0x6FFE, 0x792A, 0x95AD, 0x9A6A, 0x9E97, 0x9ECE, 0x529B,
+    0x66C6, 0x6B77, 0x8F62, 0x5E74, 0x6190, 0x6200, 0x649A, 0x6F23, 0x7149, 0x7489, 0x79CA, 0x7DF4,
+    0x806F, 0x8F26, 0x84EE, 0x9023, 0x934A, 0x5217, 0x52A3, 0x54BD, 0x70C8, 0x88C2, 0x8AAA, 0x5EC9,
+    0x5FF5, 0x637B, 0x6BAE, 0x7C3E, 0x7375, 0x4EE4, 0x56F9, 0x5BE7, 0x5DBA, 0x601C, 0x73B2, 0x7469,
+    0x7F9A, 0x8046, 0x9234, 0x96F6, 0x9748, 0x9818, 0x4F8B, 0x79AE, 0x91B4, 0x96B8, 0x60E1, 0x4E86,
+    0x50DA, 0x5BEE, 0x5C3F, 0x6599, 0x6A02, 0x71CE, 0x7642, 0x84FC, 0x907C, 0x9F8D, 0x6688, 0x962E,
+    0x5289, 0x677B, 0x67F3, 0x6D41, 0x6E9C, 0x7409, 0x7559, 0x786B, 0x7D10, 0x985E, 0x516D, 0x622E,
+    0x9678, 0x502B, 0x5D19, 0x6DEA, 0x8F2A, 0x5F8B, 0x6144, 0x6817, 0x7387, 0x9686, 0x5229, 0x540F,
+    0x5C65, 0x6613, 0x674E, 0x68A8, 0x6CE5, 0x7406, 0x75E2, 0x7F79, 0x88CF, 0x88E1, 0x91CC, 0x96E2,
+    0x533F, 0x6EBA, 0x541D, 0x71D0, 0x7498, 0x85FA, 0x96A3, 0x9C57, 0x9E9F, 0x6797, 0x6DCB, 0x81E8,
+    0x7ACB, 0x7B20, 0x7C92, 0x72C0, 0x7099, 0x8B58, 0x4EC0, 0x8336, 0x523A, 0x5207, 0x5EA6, 0x62D3,
+    0x7CD6, 0x5B85, 0x6D1E, 0x66B4, 0x8F3B, 0x884C, 0x964D, 0x898B, 0x5ED3, 0x5140, 0x55C0, 0x585A,
+    0x6674, 0x51DE, 0x732A, 0x76CA, 0x793C, 0x795E, 0x7965, 0x798F, 0x9756, 0x7CBE, 0x7FBD, 0x8612,
+    0x8AF8, 0x9038, 0x90FD, 0x98EF, 0x98FC, 0x9928, 0x9DB4, 0x90DE, 0x96B7, 0x4FAE, 0x50E7, 0x514D,
+    0x52C9, 0x52E4, 0x5351, 0x559D, 0x5606, 0x5668, 0x5840, 0x58A8, 0x5C64, 0x5C6E, 0x6094, 0x6168,
+    0x618E, 0x61F2, 0x654F, 0x65E2, 0x6691, 0x6885, 0x6D77, 0x6E1A, 0x6F22, 0x716E, 0x722B, 0x7422,
+    0x7891, 0x793E, 0x7949, 0x7948, 0x7950, 0x7956, 0x795D, 0x798D, 0x798E, 0x7A40, 0x7A81, 0x7BC0,
+    0x7DF4, 0x7E09, 0x7E41, 0x7F72, 0x8005, 0x81ED, 0x8279, 0x8279, 0x8457, 0x8910, 0x8996, 0x8B01,
+    0x8B39, 0x8CD3, 0x8D08, 0x8FB6, 0x9038, 0x96E3, 0x97FF, 0x983B, 0x6075, 0x242EE, 0x8218, 0x4E26,
+    0x51B5, 0x5168, 0x4F80, 0x5145, 0x5180, 0x52C7, 0x52FA, 0x559D, 0x5555, 0x5599, 0x55E2, 0x585A,
+    0x58B3, 0x5944, 0x5954, 0x5A62, 0x5B28, 0x5ED2, 0x5ED9, 0x5F69, 0x5FAD, 0x60D8, 0x614E, 0x6108,
+    0x618E, 0x6160, 0x61F2, 0x6234, 0x63C4, 0x641C, 0x6452, 0x6556, 0x6674, 0x6717, 0x671B, 0x6756,
+    0x6B79, 0x6BBA, 0x6D41, 0x6EDB, 0x6ECB, 0x6F22, 0x701E, 0x716E, 0x77A7, 0x7235, 0x72AF, 0x732A,
+    0x7471, 0x7506, 0x753B, 0x761D, 0x761F, 0x76CA, 0x76DB, 0x76F4, 0x774A, 0x7740, 0x78CC, 0x7AB1,
+    0x7BC0, 0x7C7B, 0x7D5B, 0x7DF4, 0x7F3E, 0x8005, 0x8352, 0x83EF, 0x8779, 0x8941, 0x8986, 0x8996,
+    0x8ABF, 0x8AF8, 0x8ACB, 0x8B01, 0x8AFE, 0x8AED, 0x8B39, 0x8B8A, 0x8D08, 0x8F38, 0x9072, 0x9199,
+    0x9276, 0x967C, 0x96E3, 0x9756, 0x97DB, 0x97FF, 0x980B, 0x983B, 0x9B12, 0x9F9C, 0x2284A, 0x22844,
+    0x233D5, 0x3B9D, 0x4018, 0x4039, 0x25249, 0x25CD0, 0x27ED3, 0x9F43, 0x9F8E, 0x05D9, 0x05B4, 0x05F2,
+    0x05B7, 0x05E9, 0x05C1, 0x05E9, 0x05C2, 0x05E9, 0x05BC, 0x05C1, 0x05E9, 0x05BC, 0x05C2, 0x05D0,
+    0x05B7, 0x05D0, 0x05B8, 0x05D0, 0x05BC, 0x05D1, 0x05BC, 0x05D2, 0x05BC, 0x05D3, 0x05BC, 0x05D4,
+    0x05BC, 0x05D5, 0x05BC, 0x05D6, 0x05BC, 0x05D8, 0x05BC, 0x05D9, 0x05BC, 0x05DA, 0x05BC, 0x05DB,
+    0x05BC, 0x05DC, 0x05BC, 0x05DE, 0x05BC, 0x05E0, 0x05BC, 0x05E1, 0x05BC, 0x05E3, 0x05BC, 0x05E4,
+    0x05BC, 0x05E6, 0x05BC, 0x05E7, 0x05BC, 0x05E8, 0x05BC, 0x05E9, 0x05BC, 0x05EA, 0x05BC, 0x05D5,
+    0x05B9, 0x05D1, 0x05BF, 0x05DB, 0x05BF, 0x05E4, 0x05BF, 0x11099, 0x110BA, 0x1109B, 0x110BA, 0x110A5,
+    0x110BA, 0x11131, 0x11127, 0x11132, 0x11127, 0x11347, 0x1133E, 0x11347, 0x11357, 0x114B9, 0x114BA, 0x114B9,
+    0x114B0, 0x114B9, 0x114BD, 0x115B8, 0x115AF, 0x115B9, 0x115AF, 0x11935, 0x11930, 0x1D157, 0x1D165, 0x1D158,
+    0x1D165, 0x1D158, 0x1D165, 0x1D16E, 0x1D158, 0x1D165, 0x1D16F, 0x1D158, 0x1D165, 0x1D170, 0x1D158, 0x1D165,
+    0x1D171, 0x1D158, 0x1D165, 0x1D172, 0x1D1B9, 0x1D165, 0x1D1BA, 0x1D165, 0x1D1B9, 0x1D165, 0x1D16E, 0x1D1BA,
+    0x1D165, 0x1D16E, 0x1D1B9, 0x1D165, 0x1D16F, 0x1D1BA, 0x1D165, 0x1D16F, 0x4E3D, 0x4E38, 0x4E41, 0x20122,
+    0x4F60, 0x4FAE, 0x4FBB, 0x5002, 0x507A, 0x5099, 0x50E7, 0x50CF, 0x349E, 0x2063A, 0x514D, 0x5154,
+    0x5164, 0x5177, 0x2051C, 0x34B9, 0x5167, 0x518D, 0x2054B, 0x5197, 0x51A4, 0x4ECC, 0x51AC, 0x51B5,
+    0x291DF, 0x51F5, 0x5203, 0x34DF, 0x523B, 0x5246, 0x5272, 0x5277, 0x3515, 0x52C7, 0x52C9, 0x52E4,
+    0x52FA, 0x5305, 0x5306, 0x5317, 0x5349, 0x5351, 0x535A, 0x5373, 0x537D, 0x537F, 0x537F, 0x537F,
+    0x20A2C, 0x7070, 0x53CA, 0x53DF, 0x20B63, 0x53EB, 0x53F1, 0x5406, 0x549E, 0x5438, 0x5448, 0x5468,
+    0x54A2, 0x54F6, 0x5510, 0x5553, 0x5563, 0x5584, 0x5584, 0x5599, 0x55AB, 0x55B3, 0x55C2, 0x5716,
+    0x5606, 0x5717, 0x5651, 0x5674, 0x5207, 0x58EE, 0x57CE, 0x57F4, 0x580D, 0x578B, 0x5832, 0x5831,
+    0x58AC, 0x214E4, 0x58F2, 0x58F7, 0x5906, 0x591A, 0x5922, 0x5962, 0x216A8, 0x216EA, 0x59EC, 0x5A1B,
+    0x5A27, 0x59D8, 0x5A66, 0x36EE, 0x36FC, 0x5B08, 0x5B3E, 0x5B3E, 0x219C8, 0x5BC3, 0x5BD8, 0x5BE7,
+    0x5BF3, 0x21B18, 0x5BFF, 0x5C06, 0x5F53, 0x5C22, 0x3781, 0x5C60, 0x5C6E, 0x5CC0, 0x5C8D, 0x21DE4,
+    0x5D43, 0x21DE6, 0x5D6E, 0x5D6B, 0x5D7C, 0x5DE1, 0x5DE2, 0x382F, 0x5DFD, 0x5E28, 0x5E3D, 0x5E69,
+    0x3862, 0x22183, 0x387C, 0x5EB0, 0x5EB3, 0x5EB6, 0x5ECA, 0x2A392, 0x5EFE, 0x22331, 0x22331, 0x8201,
+    0x5F22, 0x5F22, 0x38C7, 0x232B8, 0x261DA, 0x5F62, 0x5F6B, 0x38E3, 0x5F9A, 0x5FCD, 0x5FD7, 0x5FF9,
+    0x6081, 0x393A, 0x391C, 0x6094, 0x226D4, 0x60C7, 0x6148, 0x614C, 0x614E, 0x614C, 0x617A, 0x618E,
+    0x61B2, 0x61A4, 0x61AF, 0x61DE, 0x61F2, 0x61F6, 0x6210, 0x621B, 0x625D, 0x62B1, 0x62D4, 0x6350,
+    0x22B0C, 0x633D, 0x62FC, 0x6368, 0x6383, 0x63E4, 0x22BF1, 0x6422, 0x63C5, 0x63A9, 0x3A2E, 0x6469,
+    0x647E, 0x649D, 0x6477, 0x3A6C, 0x654F, 0x656C, 0x2300A, 0x65E3, 0x66F8, 0x6649, 0x3B19, 0x6691,
+    0x3B08, 0x3AE4, 0x5192, 0x5195, 0x6700, 0x669C, 0x80AD, 0x43D9, 0x6717, 0x671B, 0x6721, 0x675E,
+    0x6753, 0x233C3, 0x3B49, 0x67FA, 0x6785, 0x6852, 0x6885, 0x2346D, 0x688E, 0x681F, 0x6914, 0x3B9D,
+    0x6942, 0x69A3, 0x69EA, 0x6AA8, 0x236A3, 0x6ADB, 0x3C18, 0x6B21, 0x238A7, 0x6B54, 0x3C4E, 0x6B72,
+    0x6B9F, 0x6BBA, 0x6BBB, 0x23A8D, 0x21D0B, 0x23AFA, 0x6C4E, 0x23CBC, 0x6CBF, 0x6CCD, 0x6C67, 0x6D16,
+    0x6D3E, 0x6D77, 0x6D41, 0x6D69, 0x6D78, 0x6D85, 0x23D1E, 0x6D34, 0x6E2F, 0x6E6E, 0x3D33, 0x6ECB,
+    0x6EC7, 0x23ED1, 0x6DF9, 0x6F6E, 0x23F5E, 0x23F8E, 0x6FC6, 0x7039, 0x701E, 0x701B, 0x3D96, 0x704A,
+    0x707D, 0x7077, 0x70AD, 0x20525, 0x7145, 0x24263, 0x719C, 0x243AB, 0x7228, 0x7235, 0x7250, 0x24608,
+    0x7280, 0x7295, 0x24735, 0x24814, 0x737A, 0x738B, 0x3EAC, 0x73A5, 0x3EB8, 0x3EB8, 0x7447, 0x745C,
+    0x7471, 0x7485, 0x74CA, 0x3F1B, 0x7524, 0x24C36, 0x753E, 0x24C92, 0x7570, 0x2219F, 0x7610, 0x24FA1,
+    0x24FB8, 0x25044, 0x3FFC, 0x4008, 0x76F4, 0x250F3, 0x250F2, 0x25119, 0x25133, 0x771E, 0x771F, 0x771F,
+    0x774A, 0x4039, 0x778B, 0x4046, 0x4096, 0x2541D, 0x784E, 0x788C, 0x78CC, 0x40E3, 0x25626, 0x7956,
+    0x2569A, 0x256C5, 0x798F, 0x79EB, 0x412F, 0x7A40, 0x7A4A, 0x7A4F, 0x2597C, 0x25AA7, 0x25AA7, 0x7AEE,
+    0x4202, 0x25BAB, 0x7BC6, 0x7BC9, 0x4227, 0x25C80, 0x7CD2, 0x42A0, 0x7CE8, 0x7CE3, 0x7D00, 0x25F86,
+    0x7D63, 0x4301, 0x7DC7, 0x7E02, 0x7E45, 0x4334, 0x26228, 0x26247, 0x4359, 0x262D9, 0x7F7A, 0x2633E,
+    0x7F95, 0x7FFA, 0x8005, 0x264DA, 0x26523, 0x8060, 0x265A8, 0x8070, 0x2335F, 0x43D5, 0x80B2, 0x8103,
+    0x440B, 0x813E, 0x5AB5, 0x267A7, 0x267B5, 0x23393, 0x2339C, 0x8201, 0x8204, 0x8F9E, 0x446B, 0x8291,
+    0x828B, 0x829D, 0x52B3, 0x82B1, 0x82B3, 0x82BD, 0x82E6, 0x26B3C, 0x82E5, 0x831D, 0x8363, 0x83AD,
+    0x8323, 0x83BD, 0x83E7, 0x8457, 0x8353, 0x83CA, 0x83CC, 0x83DC, 0x26C36, 0x26D6B, 0x26CD5, 0x452B,
+    0x84F1, 0x84F3, 0x8516, 0x273CA, 0x8564, 0x26F2C, 0x455D, 0x4561, 0x26FB1, 0x270D2, 0x456B, 0x8650,
+    0x865C, 0x8667, 0x8669, 0x86A9, 0x8688, 0x870E, 0x86E2, 0x8779, 0x8728, 0x876B, 0x8786, 0x45D7,
+    0x87E1, 0x8801, 0x45F9, 0x8860, 0x8863, 0x27667, 0x88D7, 0x88DE, 0x4635, 0x88FA, 0x34BB, 0x278AE,
+    0x27966, 0x46BE, 0x46C7, 0x8AA0, 0x8AED, 0x8B8A, 0x8C55, 0x27CA8, 0x8CAB, 0x8CC1, 0x8D1B, 0x8D77,
+    0x27F2F, 0x20804, 0x8DCB, 0x8DBC, 0x8DF0, 0x208DE, 0x8ED4, 0x8F38, 0x285D2, 0x285ED, 0x9094, 0x90F1,
+    0x9111, 0x2872E, 0x911B, 0x9238, 0x92D7, 0x92D8, 0x927C, 0x93F9, 0x9415, 0x28BFA, 0x958B, 0x4995,
+    0x95B7, 0x28D77, 0x49E6, 0x96C3, 0x5DB2, 0x9723, 0x29145, 0x2921A, 0x4A6E, 0x4A76, 0x97E0, 0x2940A,
+    0x4AB2, 0x29496, 0x980B, 0x980B, 0x9829, 0x295B6, 0x98E2, 0x4B33, 0x9929, 0x99A7, 0x99C2, 0x99FE,
+    0x4BCE, 0x29B30, 0x9B12, 0x9C40, 0x9CFD, 0x4CCE, 0x4CED, 0x9D67, 0x2A0CE, 0x4CF8, 0x2A105, 0x2A20E,
+    0x2A291, 0x9EBB, 0x4D56, 0x9EF9, 0x9EFE, 0x9F05, 0x9F0F, 0x9F16, 0x9F3B, 0x2A600,
+}};
+
+// 规范组合对（已排除组合排除项与单字符分解），按 (first, second) 排序
+constexpr std::array<CompositionPair, 941> kCompositionPairs = {{
+    {0x003C, 0x0338, 0x226E},
+    {0x003D, 0x0338, 0x2260},
+    {0x003E, 0x0338, 0x226F},
+    {0x0041, 0x0300, 0x00C0},
+    {0x0041, 0x0301, 0x00C1},
+    {0x0041, 0x0302, 0x00C2},
+    {0x0041, 0x0303, 0x00C3},
+    {0x0041, 0x0304, 0x0100},
+    {0x0041, 0x0306, 0x0102},
+    {0x0041, 0x0307, 0x0226},
+    {0x0041, 0x0308, 0x00C4},
+    {0x0041, 0x0309, 0x1EA2},
+    {0x0041, 0x030A, 0x00C5},
+    {0x0041, 0x030C, 0x01CD},
+    {0x0041, 0x030F, 0x0200},
+    {0x0041, 0x0311, 0x0202},
+    {0x0041, 0x0323, 0x1EA0},
+    {0x0041, 0x0325, 0x1E00},
+    {0x0041, 0x0328, 0x0104},
+    {0x0042, 0x0307, 0x1E02},
+    {0x0042, 0x0323, 0x1E04},
+    {0x0042, 0x0331, 0x1E06},
+    {0x0043, 0x0301, 0x0106},
+    {0x0043, 0x0302, 0x0108},
+    {0x0043, 0x0307, 0x010A},
+    {0x0043, 0x030C, 0x010C},
+    {0x0043, 0x0327, 0x00C7},
+    {0x0044, 0x0307, 0x1E0A},
+    {0x0044, 0x030C, 0x010E},
+    {0x0044, 0x0323, 0x1E0C},
+    {0x0044, 0x0327, 0x1E10},
+    {0x0044, 0x032D, 0x1E12},
+    {0x0044, 0x0331, 0x1E0E},
+    {0x0045, 0x0300, 0x00C8},
+    {0x0045, 0x0301, 0x00C9},
+    {0x0045, 0x0302, 0x00CA},
+    {0x0045, 0x0303, 0x1EBC},
+    {0x0045, 0x0304, 0x0112},
+    {0x0045, 0x0306, 0x0114},
+    {0x0045, 0x0307, 0x0116},
+    {0x0045, 0x0308, 0x00CB},
+    {0x0045, 0x0309, 0x1EBA},
+    {0x0045, 0x030C, 0x011A},
+    {0x0045, 0x030F, 0x0204},
+    {0x0045, 0x0311, 0x0206},
+    {0x0045, 0x0323, 0x1EB8},
+    {0x0045, 0x0327, 0x0228},
+    {0x0045, 0x0328, 0x0118},
+    {0x0045, 0x032D, 0x1E18},
+    {0x0045, 0x0330, 0x1E1A},
+    {0x0046, 0x0307, 0x1E1E},
+    {0x0047, 0x0301, 0x01F4},
+    {0x0047, 0x0302, 0x011C},
+    {0x0047, 0x0304, 0x1E20},
+    {0x0047, 0x0306, 0x011E},
+    {0x0047, 0x0307, 0x0120},
+    {0x0047, 0x030C, 0x01E6},
+    {0x0047, 0x0327, 0x0122},
+    {0x0048, 0x0302, 0x0124},
+    {0x0048, 0x0307, 0x1E22},
+    {0x0048, 0x0308, 0x1E26},
+    {0x0048, 0x030C, 0x021E},
+    {0x0048, 0x0323, 0x1E24},
+    {0x0048, 0x0327, 0x1E28},
+    {0x0048, 0x032E, 0x1E2A},
+    {0x0049, 0x0300, 0x00CC},
+    {0x0049, 0x0301, 0x00CD},
+    {0x0049, 0x0302, 0x00CE},
+    {0x0049, 0x0303, 0x0128},
+    {0x0049, 0x0304, 0x012A},
+    {0x0049, 0x0306, 0x012C},
+    {0x0049, 0x0307, 0x0130},
+    {0x0049, 0x0308, 0x00CF},
+    {0x0049, 0x0309, 0x1EC8},
+    {0x0049, 0x030C, 0x01CF},
+    {0x0049, 0x030F, 0x0208},
+    {0x0049, 0x0311, 0x020A},
+    {0x0049, 0x0323, 0x1ECA},
+    {0x0049, 0x0328, 0x012E},
+    {0x0049, 0x0330, 0x1E2C},
+    {0x004A, 0x0302, 0x0134},
+    {0x004B, 0x0301, 0x1E30},
+    {0x004B, 0x030C, 0x01E8},
+    {0x004B, 0x0323, 0x1E32},
+    {0x004B, 0x0327, 0x0136},
+    {0x004B, 0x0331, 0x1E34},
+    {0x004C, 0x0301, 0x0139},
+    {0x004C, 0x030C, 0x013D},
+    {0x004C, 0x0323, 0x1E36},
+    {0x004C, 0x0327, 0x013B},
+    {0x004C, 0x032D, 0x1E3C},
+    {0x004C, 0x0331, 0x1E3A},
+    {0x004D, 0x0301, 0x1E3E},
+    {0x004D, 0x0307, 0x1E40},
+    {0x004D, 0x0323, 0x1E42},
+    {0x004E, 0x0300, 0x01F8},
+    {0x004E, 0x0301, 0x0143},
+    {0x004E, 0x0303, 0x00D1},
+    {0x004E, 0x0307, 0x1E44},
+    {0x004E, 0x030C, 0x0147},
+    {0x004E, 0x0323, 0x1E46},
+    {0x004E, 0x0327, 0x0145},
+    {0x004E, 0x032D, 0x1E4A},
+    {0x004E, 0x0331, 0x1E48},
+    {0x004F, 0x0300, 0x00D2},
+    {0x004F, 0x0301, 0x00D3},
+    {0x004F, 0x0302, 0x00D4},
+    {0x004F, 0x0303, 0x00D5},
+    {0x004F, 0x0304, 0x014C},
+    {0x004F, 0x0306, 0x014E},
+    {0x004F, 0x0307, 0x022E},
+    {0x004F, 0x0308, 0x00D6},
+    {0x004F, 0x0309, 0x1ECE},
+    {0x004F, 0x030B, 0x0150},
+    {0x004F, 0x030C, 0x01D1},
+    {0x004F, 0x030F, 0x020C},
+    {0x004F, 0x0311, 0x020E},
+    {0x004F, 0x031B, 0x01A0},
+    {0x004F, 0x0323, 0x1ECC},
+    {0x004F, 0x0328, 0x01EA},
+    {0x0050, 0x0301, 0x1E54},
+    {0x0050, 0x0307, 0x1E56},
+    {0x0052, 0x0301, 0x0154},
+    {0x0052, 0x0307, 0x1E58},
+    {0x0052, 0x030C, 0x0158},
+    {0x0052, 0x030F, 0x0210},
+    {0x0052, 0x0311, 0x0212},
+    {0x0052, 0x0323, 0x1E5A},
+    {0x0052, 0x0327, 0x0156},
+    {0x0052, 0x0331, 0x1E5E},
+    {0x0053, 0x0301, 0x015A},
+    {0x0053, 0x0302, 0x015C},
+    {0x0053, 0x0307, 0x1E60},
+    {0x0053, 0x030C, 0x0160},
+    {0x0053, 0x0323, 0x1E62},
+    {0x0053, 0x0326, 0x0218},
+    {0x0053, 0x0327, 0x015E},
+    {0x0054, 0x0307, 0x1E6A},
+    {0x0054, 0x030C, 0x0164},
+    {0x0054, 0x0323, 0x1E6C},
+    {0x0054, 0x0326, 0x021A},
+    {0x0054, 0x0327, 0x0162},
+    {0x0054, 0x032D, 0x1E70},
+    {0x0054, 0x0331, 0x1E6E},
+    {0x0055, 0x0300, 0x00D9},
+    {0x0055, 0x0301, 0x00DA},
+    {0x0055, 0x0302, 0x00DB},
+    {0x0055, 0x0303, 0x0168},
+    {0x0055, 0x0304, 0x016A},
+    {0x0055, 0x0306, 0x016C},
+    {0x0055, 0x0308, 0x00DC},
+    {0x0055, 0x0309, 0x1EE6},
+    {0x0055, 0x030A, 0x016E},
+    {0x0055, 0x030B, 0x0170},
+    {0x0055, 0x030C, 0x01D3},
+    {0x0055, 0x030F, 0x0214},
+    {0x0055, 0x0311, 0x0216},
+    {0x0055, 0x031B, 0x01AF},
+    {0x0055, 0x0323, 0x1EE4},
+    {0x0055, 0x0324, 0x1E72},
+    {0x0055, 0x0328, 0x0172},
+    {0x0055, 0x032D, 0x1E76},
+    {0x0055, 0x0330, 0x1E74},
+    {0x0056, 0x0303, 0x1E7C},
+    {0x0056, 0x0323, 0x1E7E},
+    {0x0057, 0x0300, 0x1E80},
+    {0x0057, 0x0301, 0x1E82},
+    {0x0057, 0x0302, 0x0174},
+    {0x0057, 0x0307, 0x1E86},
+    {0x0057, 0x0308, 0x1E84},
+    {0x0057, 0x0323, 0x1E88},
+    {0x0058, 0x0307, 0x1E8A},
+    {0x0058, 0x0308, 0x1E8C},
+    {0x0059, 0x0300, 0x1EF2},
+    {0x0059, 0x0301, 0x00DD},
+    {0x0059, 0x0302, 0x0176},
+    {0x0059, 0x0303, 0x1EF8},
+    {0x0059, 0x0304, 0x0232},
+    {0x0059, 0x0307, 0x1E8E},
+    {0x0059, 0x0308, 0x0178},
+    {0x0059, 0x0309, 0x1EF6},
+    {0x0059, 0x0323, 0x1EF4},
+    {0x005A, 0x0301, 0x0179},
+    {0x005A, 0x0302, 0x1E90},
+    {0x005A, 0x0307, 0x017B},
+    {0x005A, 0x030C, 0x017D},
+    {0x005A, 0x0323, 0x1E92},
+    {0x005A, 0x0331, 0x1E94},
+    {0x0061, 0x0300, 0x00E0},
+    {0x0061, 0x0301, 0x00E1},
+    {0x0061, 0x0302, 0x00E2},
+    {0x0061, 0x0303, 0x00E3},
+    {0x0061, 0x0304, 0x0101},
+    {0x0061, 0x0306, 0x0103},
+    {0x0061, 0x0307, 0x0227},
+    {0x0061, 0x0308, 0x00E4},
+    {0x0061, 0x0309, 0x1EA3},
+    {0x0061, 0x030A, 0x00E5},
+    {0x0061, 0x030C, 0x01CE},
+    {0x0061, 0x030F, 0x0201},
+    {0x0061, 0x0311, 0x0203},
+    {0x0061, 0x0323, 0x1EA1},
+    {0x0061, 0x0325, 0x1E01},
+    {0x0061, 0x0328, 0x0105},
+    {0x0062, 0x0307, 0x1E03},
+    {0x0062, 0x0323, 0x1E05},
+    {0x0062, 0x0331, 0x1E07},
+    {0x0063, 0x0301, 0x0107},
+    {0x0063, 0x0302, 0x0109},
+    {0x0063, 0x0307, 0x010B},
+    {0x0063, 0x030C, 0x010D},
+    {0x0063, 0x0327, 0x00E7},
+    {0x0064, 0x0307, 0x1E0B},
+    {0x0064, 0x030C, 0x010F},
+    {0x0064, 0x0323, 0x1E0D},
+    {0x0064, 0x0327, 0x1E11},
+    {0x0064, 0x032D, 0x1E13},
+    {0x0064, 0x0331, 0x1E0F},
+    {0x0065, 0x0300, 0x00E8},
+    {0x0065, 0x0301, 0x00E9},
+    {0x0065, 0x0302, 0x00EA},
+    {0x0065, 0x0303, 0x1EBD},
+    {0x0065, 0x0304, 0x0113},
+    {0x0065, 0x0306, 0x0115},
+    {0x0065, 0x0307, 0x0117},
+    {0x0065, 0x0308, 0x00EB},
+    {0x0065, 0x0309, 0x1EBB},
+    {0x0065, 0x030C, 0x011B},
+    {0x0065, 0x030F, 0x0205},
+    {0x0065, 0x0311, 0x0207},
+    {0x0065, 0x0323, 0x1EB9},
+    {0x0065, 0x0327, 0x0229},
+    {0x0065, 0x0328, 0x0119},
+    {0x0065, 0x032D, 0x1E19},
+    {0x0065, 0x0330, 0x1E1B},
+    {0x0066, 0x0307, 0x1E1F},
+    {0x0067, 0x0301, 0x01F5},
+    {0x0067, 0x0302, 0x011D},
+    {0x0067, 0x0304, 0x1E21},
+    {0x0067, 0x0306, 0x011F},
+    {0x0067, 0x0307, 0x0121},
+    {0x0067, 0x030C, 0x01E7},
+    {0x0067, 0x0327, 0x0123},
+    {0x0068, 0x0302, 0x0125},
+    {0x0068, 0x0307, 0x1E23},
+    {0x0068, 0x0308, 0x1E27},
+    {0x0068, 0x030C, 0x021F},
+    {0x0068, 0x0323, 0x1E25},
+    {0x0068, 0x0327, 0x1E29},
+    {0x0068, 0x032E, 0x1E2B},
+    {0x0068, 0x0331, 0x1E96},
+    {0x0069, 0x0300, 0x00EC},
+    {0x0069, 0x0301, 0x00ED},
+    {0x0069, 0x0302, 0x00EE},
+    {0x0069, 0x0303, 0x0129},
+    {0x0069, 0x0304, 0x012B},
+    {0x0069, 0x0306, 0x012D},
+    {0x0069, 0x0308, 0x00EF},
+    {0x0069, 0x0309, 0x1EC9},
+    {0x0069, 0x030C, 0x01D0},
+    {0x0069, 0x030F, 0x0209},
+    {0x0069, 0x0311, 0x020B},
+    {0x0069, 0x0323, 0x1ECB},
+    {0x0069, 0x0328, 0x012F},
+    {0x0069, 0x0330, 0x1E2D},
+    {0x006A, 0x0302, 0x0135},
+    {0x006A, 0x030C, 0x01F0},
+    {0x006B, 0x0301, 0x1E31},
+    {0x006B, 0x030C, 0x01E9},
+    {0x006B, 0x0323, 0x1E33},
+    {0x006B, 0x0327, 0x0137},
+    {0x006B, 0x0331, 0x1E35},
+    {0x006C, 0x0301, 0x013A},
+    {0x006C, 0x030C, 0x013E},
+    {0x006C, 0x0323, 0x1E37},
+    {0x006C, 0x0327, 0x013C},
+    {0x006C, 0x032D, 0x1E3D},
+    {0x006C, 0x0331, 0x1E3B},
+    {0x006D, 0x0301, 0x1E3F},
+    {0x006D, 0x0307, 0x1E41},
+    {0x006D, 0x0323, 0x1E43},
+    {0x006E, 0x0300, 0x01F9},
+    {0x006E, 0x0301, 0x0144},
+    {0x006E, 0x0303, 0x00F1},
+    {0x006E, 0x0307, 0x1E45},
+    {0x006E, 0x030C, 0x0148},
+    {0x006E, 0x0323, 0x1E47},
+    {0x006E, 0x0327, 0x0146},
+    {0x006E, 0x032D, 0x1E4B},
+    {0x006E, 0x0331, 0x1E49},
+    {0x006F, 0x0300, 0x00F2},
+    {0x006F, 0x0301, 0x00F3},
+    {0x006F, 0x0302, 0x00F4},
+    {0x006F, 0x0303, 0x00F5},
+    {0x006F, 0x0304, 0x014D},
+    {0x006F, 0x0306, 0x014F},
+    {0x006F, 0x0307, 0x022F},
+    {0x006F, 0x0308, 0x00F6},
+    {0x006F, 0x0309, 0x1ECF},
+    {0x006F, 0x030B, 0x0151},
+    {0x006F, 0x030C, 0x01D2},
+    {0x006F, 0x030F, 0x020D},
+    {0x006F, 0x0311, 0x020F},
+    {0x006F, 0x031B, 0x01A1},
+    {0x006F, 0x0323, 0x1ECD},
+    {0x006F, 0x0328, 0x01EB},
+    {0x0070, 0x0301, 0x1E55},
+    {0x0070, 0x0307, 0x1E57},
+    {0x0072, 0x0301, 0x0155},
+    {0x0072, 0x0307, 0x1E59},
+    {0x0072, 0x030C, 0x0159},
+    {0x0072, 0x030F, 0x0211},
+    {0x0072, 0x0311, 0x0213},
+    {0x0072, 0x0323, 0x1E5B},
+    {0x0072, 0x0327, 0x0157},
+    {0x0072, 0x0331, 0x1E5F},
+    {0x0073, 0x0301, 0x015B},
+    {0x0073, 0x0302, 0x015D},
+    {0x0073, 0x0307, 0x1E61},
+    {0x0073, 0x030C, 0x0161},
+    {0x0073, 0x0323, 0x1E63},
+    {0x0073, 0x0326, 0x0219},
+    {0x0073, 0x0327, 0x015F},
+    {0x0074, 0x0307, 0x1E6B},
+    {0x0074, 0x0308, 0x1E97},
+    {0x0074, 0x030C, 0x0165},
+    {0x0074, 0x0323, 0x1E6D},
+    {0x0074, 0x0326, 0x021B},
+    {0x0074, 0x0327, 0x0163},
+    {0x0074, 0x032D, 0x1E71},
+    {0x0074, 0x0331, 0x1E6F},
+    {0x0075, 0x0300, 0x00F9},
+    {0x0075, 0x0301, 0x00FA},
+    {0x0075, 0x0302, 0x00FB},
+    {0x0075, 0x0303, 0x0169},
+    {0x0075, 0x0304, 0x016B},
+    {0x0075, 0x0306, 0x016D},
+    {0x0075, 0x0308, 0x00FC},
+    {0x0075, 0x0309, 0x1EE7},
+    {0x0075, 0x030A, 0x016F},
+    {0x0075, 0x030B, 0x0171},
+    {0x0075, 0x030C, 0x01D4},
+    {0x0075, 0x030F, 0x0215},
+    {0x0075, 0x0311, 0x0217},
+    {0x0075, 0x031B, 0x01B0},
+    {0x0075, 0x0323, 0x1EE5},
+    {0x0075, 0x0324, 0x1E73},
+    {0x0075, 0x0328, 0x0173},
+    {0x0075, 0x032D, 0x1E77},
+    {0x0075, 0x0330, 0x1E75},
+    {0x0076, 0x0303, 0x1E7D},
+    {0x0076, 0x0323, 0x1E7F},
+    {0x0077, 0x0300, 0x1E81},
+    {0x0077, 0x0301, 0x1E83},
+    {0x0077, 0x0302, 0x0175},
+    {0x0077, 0x0307, 0x1E87},
+    {0x0077, 0x0308, 0x1E85},
+    {0x0077, 0x030A, 0x1E98},
+    {0x0077, 0x0323, 0x1E89},
+    {0x0078, 0x0307, 0x1E8B},
+    {0x0078, 0x0308, 0x1E8D},
+    {0x0079, 0x0300, 0x1EF3},
+    {0x0079, 0x0301, 0x00FD},
+    {0x0079, 0x0302, 0x0177},
+    {0x0079, 0x0303, 0x1EF9},
+    {0x0079, 0x0304, 0x0233},
+    {0x0079, 0x0307, 0x1E8F},
+    {0x0079, 0x0308, 0x00FF},
+    {0x0079, 0x0309, 0x1EF7},
+    {0x0079, 0x030A, 0x1E99},
+    {0x0079, 0x0323, 0x1EF5},
+    {0x007A, 0x0301, 0x017A},
+    {0x007A, 0x0302, 0x1E91},
+    {0x007A, 0x0307, 0x017C},
+    {0x007A, 0x030C, 0x017E},
+    {0x007A, 0x0323, 0x1E93},
+    {0x007A, 0x0331, 0x1E95},
+    {0x00A8, 0x0300, 0x1FED},
+    {0x00A8, 0x0301, 0x0385},
+    {0x00A8, 0x0342, 0x1FC1},
+    {0x00C2, 0x0300, 0x1EA6},
+    {0x00C2, 0x0301, 0x1EA4},
+    {0x00C2, 0x0303, 0x1EAA},
+    {0x00C2, 0x0309, 0x1EA8},
+    {0x00C4, 0x0304, 0x01DE},
+    {0x00C5, 0x0301, 0x01FA},
+    {0x00C6, 0x0301, 0x01FC},
+    {0x00C6, 0x0304, 0x01E2},
+    {0x00C7, 0x0301, 0x1E08},
+    {0x00CA, 0x0300, 0x1EC0},
+    {0x00CA, 0x0301, 0x1EBE},
+    {0x00CA, 0x0303, 0x1EC4},
+    {0x00CA, 0x0309, 0x1EC2},
+    {0x00CF, 0x0301, 0x1E2E},
+    {0x00D4, 0x0300, 0x1ED2},
+    {0x00D4, 0x0301, 0x1ED0},
+    {0x00D4, 0x0303, 0x1ED6},
+    {0x00D4, 0x0309, 0x1ED4},
+    {0x00D5, 0x0301, 0x1E4C},
+    {0x00D5, 0x0304, 0x022C},
+    {0x00D5, 0x0308, 0x1E4E},
+    {0x00D6, 0x0304, 0x022A},
+    {0x00D8, 0x0301, 0x01FE},
+    {0x00DC, 0x0300, 0x01DB},
+    {0x00DC, 0x0301, 0x01D7},
+    {0x00DC, 0x0304, 0x01D5},
+    {0x00DC, 0x030C, 0x01D9},
+    {0x00E2, 0x0300, 0x1EA7},
+    {0x00E2, 0x0301, 0x1EA5},
+    {0x00E2, 0x0303, 0x1EAB},
+    {0x00E2, 0x0309, 0x1EA9},
+    {0x00E4, 0x0304, 0x01DF},
+    {0x00E5, 0x0301, 0x01FB},
+    {0x00E6, 0x0301, 0x01FD},
+    {0x00E6, 0x0304, 0x01E3},
+    {0x00E7, 0x0301, 0x1E09},
+    {0x00EA, 0x0300, 0x1EC1},
+    {0x00EA, 0x0301, 0x1EBF},
+    {0x00EA, 0x0303, 0x1EC5},
+    {0x00EA, 0x0309, 0x1EC3},
+    {0x00EF, 0x0301, 0x1E2F},
+    {0x00F4, 0x0300, 0x1ED3},
+    {0x00F4, 0x0301, 0x1ED1},
+    {0x00F4, 0x0303, 0x1ED7},
+    {0x00F4, 0x0309, 0x1ED5},
+    {0x00F5, 0x0301, 0x1E4D},
+    {0x00F5, 0x0304, 0x022D},
+    {0x00F5, 0x0308, 0x1E4F},
+    {0x00F6, 0x0304, 0x022B},
+    {0x00F8, 0x0301, 0x01FF},
+    {0x00FC, 0x0300, 0x01DC},
+    {0x00FC, 0x0301, 0x01D8},
+    {0x00FC, 0x0304, 0x01D6},
+    {0x00FC, 0x030C, 0x01DA},
+    {0x0102, 0x0300, 0x1EB0},
+    {0x0102, 0x0301, 0x1EAE},
+    {0x0102, 0x0303, 0x1EB4},
+    {0x0102, 0x0309, 0x1EB2},
+    {0x0103, 0x0300, 0x1EB1},
+    {0x0103, 0x0301, 0x1EAF},
+    {0x0103, 0x0303, 0x1EB5},
+    {0x0103, 0x0309, 0x1EB3},
+    {0x0112, 0x0300, 0x1E14},
+    {0x0112, 0x0301, 0x1E16},
+    {0x0113, 0x0300, 0x1E15},
+    {0x0113, 0x0301, 0x1E17},
+    {0x014C, 0x0300, 0x1E50},
+    {0x014C, 0x0301, 0x1E52},
+    {0x014D, 0x0300, 0x1E51},
+    {0x014D, 0x0301, 0x1E53},
+    {0x015A, 0x0307, 0x1E64},
+    {0x015B, 0x0307, 0x1E65},
+    {0x0160, 0x0307, 0x1E66},
+    {0x0161, 0x0307, 0x1E67},
+    {0x0168, 0x0301, 0x1E78},
+    {0x0169, 0x0301, 0x1E79},
+    {0x016A, 0x0308, 0x1E7A},
+    {0x016B, 0x0308, 0x1E7B},
+    {0x017F, 0x0307, 0x1E9B},
+    {0x01A0, 0x0300, 0x1EDC},
+    {0x01A0, 0x0301, 0x1EDA},
+    {0x01A0, 0x0303, 0x1EE0},
+    {0x01A0, 0x0309, 0x1EDE},
+    {0x01A0, 0x0323, 0x1EE2},
+    {0x01A1, 0x0300, 0x1EDD},
+    {0x01A1, 0x0301, 0x1EDB},
+    {0x01A1, 0x0303, 0x1EE1},
+    {0x01A1, 0x0309, 0x1EDF},
+    {0x01A1, 0x0323, 0x1EE3},
+    {0x01AF, 0x0300, 0x1EEA},
+    {0x01AF, 0x0301, 0x1EE8},
+    {0x01AF, 0x0303, 0x1EEE},
+    {0x01AF, 0x0309, 0x1EEC},
+    {0x01AF, 0x0323, 0x1EF0},
+    {0x01B0, 0x0300, 0x1EEB},
+    {0x01B0, 0x0301, 0x1EE9},
+    {0x01B0, 0x0303, 0x1EEF},
+    {0x01B0, 0x0309, 0x1EED},
+    {0x01B0, 0x0323, 0x1EF1},
+    {0x01B7, 0x030C, 0x01EE},
+    {0x01EA, 0x0304, 0x01EC},
+    {0x01EB, 0x0304, 0x01ED},
+    {0x0226, 0x0304, 0x01E0},
+    {0x0227, 0x0304, 0x01E1},
+    {0x0228, 0x0306, 0x1E1C},
+    {0x0229, 0x0306, 0x1E1D},
+    {0x022E, 0x0304, 0x0230},
+    {0x022F, 0x0304, 0x0231},
+    {0x0292, 0x030C, 0x01EF},
+    {0x0391, 0x0300, 0x1FBA},
+    {0x0391, 0x0301, 0x0386},
+    {0x0391, 0x0304, 0x1FB9},
+    {0x0391, 0x0306, 0x1FB8},
+    {0x0391, 0x0313, 0x1F08},
+    {0x0391, 0x0314, 0x1F09},
+    {0x0391, 0x0345, 0x1FBC},
+    {0x0395, 0x0300, 0x1FC8},
+    {0x0395, 0x0301, 0x0388},
+    {0x0395, 0x0313, 0x1F18},
+    {0x0395, 0x0314, 0x1F19},
+    {0x0397, 0x0300, 0x1FCA},
+    {0x0397, 0x0301, 0x0389},
+    {0x0397, 0x0313, 0x1F28},
+    {0x0397, 0x0314, 0x1F29},
+    {0x0397, 0x0345, 0x1FCC},
+    {0x0399, 0x0300, 0x1FDA},
+    {0x0399, 0x0301, 0x038A},
+    {0x0399, 0x0304, 0x1FD9},
+    {0x0399, 0x0306, 0x1FD8},
+    {0x0399, 0x0308, 0x03AA},
+    {0x0399, 0x0313, 0x1F38},
+    {0x0399, 0x0314, 0x1F39},
+    {0x039F, 0x0300, 0x1FF8},
+    {0x039F, 0x0301, 0x038C},
+    {0x039F, 0x0313, 0x1F48},
+    {0x039F, 0x0314, 0x1F49},
+    {0x03A1, 0x0314, 0x1FEC},
+    {0x03A5, 0x0300, 0x1FEA},
+    {0x03A5, 0x0301, 0x038E},
+    {0x03A5, 0x0304, 0x1FE9},
+    {0x03A5, 0x0306, 0x1FE8},
+    {0x03A5, 0x0308, 0x03AB},
+    {0x03A5, 0x0314, 0x1F59},
+    {0x03A9, 0x0300, 0x1FFA},
+    {0x03A9, 0x0301, 0x038F},
+    {0x03A9, 0x0313, 0x1F68},
+    {0x03A9, 0x0314, 0x1F69},
+    {0x03A9, 0x0345, 0x1FFC},
+    {0x03AC, 0x0345, 0x1FB4},
+    {0x03AE, 0x0345, 0x1FC4},
+    {0x03B1, 0x0300, 0x1F70},
+    {0x03B1, 0x0301, 0x03AC},
+    {0x03B1, 0x0304, 0x1FB1},
+    {0x03B1, 0x0306, 0x1FB0},
+    {0x03B1, 0x0313, 0x1F00},
+    {0x03B1, 0x0314, 0x1F01},
+    {0x03B1, 0x0342, 0x1FB6},
+    {0x03B1, 0x0345, 0x1FB3},
+    {0x03B5, 0x0300, 0x1F72},
+    {0x03B5, 0x0301, 0x03AD},
+    {0x03B5, 0x0313, 0x1F10},
+    {0x03B5, 0x0314, 0x1F11},
+    {0x03B7, 0x0300, 0x1F74},
+    {0x03B7, 0x0301, 0x03AE},
+    {0x03B7, 0x0313, 0x1F20},
+    {0x03B7, 0x0314, 0x1F21},
+    {0x03B7, 0x0342, 0x1FC6},
+    {0x03B7, 0x0345, 0x1FC3},
+    {0x03B9, 0x0300, 0x1F76},
+    {0x03B9, 0x0301, 0x03AF},
+    {0x03B9, 0x0304, 0x1FD1},
+    {0x03B9, 0x0306, 0x1FD0},
+    {0x03B9, 0x0308, 0x03CA},
+    {0x03B9, 0x0313, 0x1F30},
+    {0x03B9, 0x0314, 0x1F31},
+    {0x03B9, 0x0342, 0x1FD6},
+    {0x03BF, 0x0300, 0x1F78},
+    {0x03BF, 0x0301, 0x03CC},
+    {0x03BF, 0x0313, 0x1F40},
+    {0x03BF, 0x0314, 0x1F41},
+    {0x03C1, 0x0313, 0x1FE4},
+    {0x03C1, 0x0314, 0x1FE5},
+    {0x03C5, 0x0300, 0x1F7A},
+    {0x03C5, 0x0301, 0x03CD},
+    {0x03C5, 0x0304, 0x1FE1},
+    {0x03C5, 0x0306, 0x1FE0},
+    {0x03C5, 0x0308, 0x03CB},
+    {0x03C5, 0x0313, 0x1F50},
+    {0x03C5, 0x0314, 0x1F51},
+    {0x03C5, 0x0342, 0x1FE6},
+    {0x03C9, 0x0300, 0x1F7C},
+    {0x03C9, 0x0301, 0x03CE},
+    {0x03C9, 0x0313, 0x1F60},
+    {0x03C9, 0x0314, 0x1F61},
+    {0x03C9, 0x0342, 0x1FF6},
+    {0x03C9, 0x0345, 0x1FF3},
+    {0x03CA, 0x0300, 0x1FD2},
+    {0x03CA, 0x0301, 0x0390},
+    {0x03CA, 0x0342, 0x1FD7},
+    {0x03CB, 0x0300, 0x1FE2},
+    {0x03CB, 0x0301, 0x03B0},
+    {0x03CB, 0x0342, 0x1FE7},
+    {0x03CE, 0x0345, 0x1FF4},
+    {0x03D2, 0x0301, 0x03D3},
+    {0x03D2, 0x0308, 0x03D4},
+    {0x0406, 0x0308, 0x0407},
+    {0x0410, 0x0306, 0x04D0},
+    {0x0410, 0x0308, 0x04D2},
+    {0x0413, 0x0301, 0x0403},
+    {0x0415, 0x0300, 0x0400},
+    {0x0415, 0x0306, 0x04D6},
+    {0x0415, 0x0308, 0x0401},
+    {0x0416, 0x0306, 0x04C1},
+    {0x0416, 0x0308, 0x04DC},
+    {0x0417, 0x0308, 0x04DE},
+    {0x0418, 0x0300, 0x040D},
+    {0x0418, 0x0304, 0x04E2},
+    {0x0418, 0x0306, 0x0419},
+    {0x0418, 0x0308, 0x04E4},
+    {0x041A, 0x0301, 0x040C},
+    {0x041E, 0x0308, 0x04E6},
+    {0x0423, 0x0304, 0x04EE},
+    {0x0423, 0x0306, 0x040E},
+    {0x0423, 0x0308, 0x04F0},
+    {0x0423, 0x030B, 0x04F2},
+    {0x0427, 0x0308, 0x04F4},
+    {0x042B, 0x0308, 0x04F8},
+    {0x042D, 0x0308, 0x04EC},
+    {0x0430, 0x0306, 0x04D1},
+    {0x0430, 0x0308, 0x04D3},
+    {0x0433, 0x0301, 0x0453},
+    {0x0435, 0x0300, 0x0450},
+    {0x0435, 0x0306, 0x04D7},
+    {0x0435, 0x0308, 0x0451},
+    {0x0436, 0x0306, 0x04C2},
+    {0x0436, 0x0308, 0x04DD},
+    {0x0437, 0x0308, 0x04DF},
+    {0x0438, 0x0300, 0x045D},
+    {0x0438, 0x0304, 0x04E3},
+    {0x0438, 0x0306, 0x0439},
+    {0x0438, 0x0308, 0x04E5},
+    {0x043A, 0x0301, 0x045C},
+    {0x043E, 0x0308, 0x04E7},
+    {0x0443, 0x0304, 0x04EF},
+    {0x0443, 0x0306, 0x045E},
+    {0x0443, 0x0308, 0x04F1},
+    {0x0443, 0x030B, 0x04F3},
+    {0x0447, 0x0308, 0x04F5},
+    {0x044B, 0x0308, 0x04F9},
+    {0x044D, 0x0308, 0x04ED},
+    {0x0456, 0x0308, 0x0457},
+    {0x0474, 0x030F, 0x0476},
+    {0x0475, 0x030F, 0x0477},
+    {0x04D8, 0x0308, 0x04DA},
+    {0x04D9, 0x0308, 0x04DB},
+    {0x04E8, 0x0308, 0x04EA},
+    {0x04E9, 0x0308, 0x04EB},
+    {0x0627, 0x0653, 0x0622},
+    {0x0627, 0x0654, 0x0623},
+    {0x0627, 0x0655, 0x0625},
+    {0x0648, 0x0654, 0x0624},
+    {0x064A, 0x0654, 0x0626},
+    {0x06C1, 0x0654, 0x06C2},
+    {0x06D2, 0x0654, 0x06D3},
+    {0x06D5, 0x0654, 0x06C0},
+    {0x0928, 0x093C, 0x0929},
+    {0x0930, 0x093C, 0x0931},
+    {0x0933, 0x093C, 0x0934},
+    {0x09C7, 0x09BE, 0x09CB},
+    {0x09C7, 0x09D7, 0x09CC},
+    {0x0B47, 0x0B3E, 0x0B4B},
+    {0x0B47, 0x0B56, 0x0B48},
+    {0x0B47, 0x0B57, 0x0B4C},
+    {0x0B92, 0x0BD7, 0x0B94},
+    {0x0BC6, 0x0BBE, 0x0BCA},
+    {0x0BC6, 0x0BD7, 0x0BCC},
+    {0x0BC7, 0x0BBE, 0x0BCB},
+    {0x0C46, 0x0C56, 0x0C48},
+    {0x0CBF, 0x0CD5, 0x0CC0},
+    {0x0CC6, 0x0CC2, 0x0CCA},
+    {0x0CC6, 0x0CD5, 0x0CC7},
+    {0x0CC6, 0x0CD6, 0x0CC8},
+    {0x0CCA, 0x0CD5, 0x0CCB},
+    {0x0D46, 0x0D3E, 0x0D4A},
+    {0x0D46, 0x0D57, 0x0D4C},
+    {0x0D47, 0x0D3E, 0x0D4B},
+    {0x0DD9, 0x0DCA, 0x0DDA},
+    {0x0DD9, 0x0DCF, 0x0DDC},
+    {0x0DD9, 0x0DDF, 0x0DDE},
+    {0x0DDC, 0x0DCA, 0x0DDD},
+    {0x1025, 0x102E, 0x1026},
+    {0x1B05, 0x1B35, 0x1B06},
+    {0x1B07, 0x1B35, 0x1B08},
+    {0x1B09, 0x1B35, 0x1B0A},
+    {0x1B0B, 0x1B35, 0x1B0C},
+    {0x1B0D, 0x1B35, 0x1B0E},
+    {0x1B11, 0x1B35, 0x1B12},
+    {0x1B3A, 0x1B35, 0x1B3B},
+    {0x1B3C, 0x1B35, 0x1B3D},
+    {0x1B3E, 0x1B35, 0x1B40},
+    {0x1B3F, 0x1B35, 0x1B41},
+    {0x1B42, 0x1B35, 0x1B43},
+    {0x1E36, 0x0304, 0x1E38},
+    {0x1E37, 0x0304, 0x1E39},
+    {0x1E5A, 0x0304, 0x1E5C},
+    {0x1E5B, 0x0304, 0x1E5D},
+    {0x1E62, 0x0307, 0x1E68},
+    {0x1E63, 0x0307, 0x1E69},
+    {0x1EA0, 0x0302, 0x1EAC},
+    {0x1EA0, 0x0306, 0x1EB6},
+    {0x1EA1, 0x0302, 0x1EAD},
+    {0x1EA1, 0x0306, 0x1EB7},
+    {0x1EB8, 0x0302, 0x1EC6},
+    {0x1EB9, 0x0302, 0x1EC7},
+    {0x1ECC, 0x0302, 0x1ED8},
+    {0x1ECD, 0x0302, 0x1ED9},
+    {0x1F00, 0x0300, 0x1F02},
+    {0x1F00, 0x0301, 0x1F04},
+    {0x1F00, 0x0342, 0x1F06},
+    {0x1F00, 0x0345, 0x1F80},
+    {0x1F01, 0x0300, 0x1F03},
+    {0x1F01, 0x0301, 0x1F05},
+    {0x1F01, 0x0342, 0x1F07},
+    {0x1F01, 0x0345, 0x1F81},
+    {0x1F02, 0x0345, 0x1F82},
+    {0x1F03, 0x0345, 0x1F83},
+    {0x1F04, 0x0345, 0x1F84},
+    {0x1F05, 0x0345, 0x1F85},
+    {0x1F06, 0x0345, 0x1F86},
+    {0x1F07, 0x0345, 0x1F87},
+    {0x1F08, 0x0300, 0x1F0A},
+    {0x1F08, 0x0301, 0x1F0C},
+    {0x1F08, 0x0342, 0x1F0E},
+    {0x1F08, 0x0345, 0x1F88},
+    {0x1F09, 0x0300, 0x1F0B},
+    {0x1F09, 0x0301, 0x1F0D},
+    {0x1F09, 0x0342, 0x1F0F},
+    {0x1F09, 0x0345, 0x1F89},
+    {0x1F0A, 0x0345, 0x1F8A},
+    {0x1F0B, 0x0345, 0x1F8B},
+    {0x1F0C, 0x0345, 0x1F8C},
+    {0x1F0D, 0x0345, 0x1F8D},
+    {0x1F0E, 0x0345, 0x1F8E},
+    {0x1F0F, 0x0345, 0x1F8F},
+    {0x1F10, 0x0300, 0x1F12},
+    {0x1F10, 0x0301, 0x1F14},
+    {0x1F11, 0x0300, 0x1F13},
+    {0x1F11, 0x0301, 0x1F15},
+    {0x1F18, 0x0300, 0x1F1A},
+    {0x1F18, 0x0301, 0x1F1C},
+    {0x1F19, 0x0300, 0x1F1B},
+    {0x1F19, 0x0301, 0x1F1D},
+    {0x1F20, 0x0300, 0x1F22},
+    {0x1F20, 0x0301, 0x1F24},
+    {0x1F20, 0x0342, 0x1F26},
+    {0x1F20, 0x0345, 0x1F90},
+    {0x1F21, 0x0300, 0x1F23},
+    {0x1F21, 0x0301, 0x1F25},
+    {0x1F21, 0x0342, 0x1F27},
+    {0x1F21, 0x0345, 0x1F91},
+    {0x1F22, 0x0345, 0x1F92},
+    {0x1F23, 0x0345, 0x1F93},
+    {0x1F24, 0x0345, 0x1F94},
+    {0x1F25, 0x0345, 0x1F95},
+    {0x1F26, 0x0345, 0x1F96},
+    {0x1F27, 0x0345, 0x1F97},
+    {0x1F28, 0x0300, 0x1F2A},
+    {0x1F28, 0x0301, 0x1F2C},
+    {0x1F28, 0x0342, 0x1F2E},
+    {0x1F28, 0x0345, 0x1F98},
+    {0x1F29, 0x0300, 0x1F2B},
+    {0x1F29, 0x0301, 0x1F2D},
+    {0x1F29, 0x0342, 0x1F2F},
+    {0x1F29, 0x0345, 0x1F99},
+    {0x1F2A, 0x0345, 0x1F9A},
+    {0x1F2B, 0x0345, 0x1F9B},
+    {0x1F2C, 0x0345, 0x1F9C},
+    {0x1F2D, 0x0345, 0x1F9D},
+    {0x1F2E, 0x0345, 0x1F9E},
+    {0x1F2F, 0x0345, 0x1F9F},
+    {0x1F30, 0x0300, 0x1F32},
+    {0x1F30, 0x0301, 0x1F34},
+    {0x1F30, 0x0342, 0x1F36},
+    {0x1F31, 0x0300, 0x1F33},
+    {0x1F31, 0x0301, 0x1F35},
+    {0x1F31, 0x0342, 0x1F37},
+    {0x1F38, 0x0300, 0x1F3A},
+    {0x1F38, 0x0301, 0x1F3C},
+    {0x1F38, 0x0342, 0x1F3E},
+    {0x1F39, 0x0300, 0x1F3B},
+    {0x1F39, 0x0301, 0x1F3D},
+    {0x1F39, 0x0342, 0x1F3F},
+    {0x1F40, 0x0300, 0x1F42},
+    {0x1F40, 0x0301, 0x1F44},
+    {0x1F41, 0x0300, 0x1F43},
+    {0x1F41, 0x0301, 0x1F45},
+    {0x1F48, 0x0300, 0x1F4A},
+    {0x1F48, 0x0301, 0x1F4C},
+    {0x1F49, 0x0300, 0x1F4B},
+    {0x1F49, 0x0301, 0x1F4D},
+    {0x1F50, 0x0300, 0x1F52},
+    {0x1F50, 0x0301, 0x1F54},
+    {0x1F50, 0x0342, 0x1F56},
+    {0x1F51, 0x0300, 0x1F53},
+    {0x1F51, 0x0301, 0x1F55},
+    {0x1F51, 0x0342, 0x1F57},
+    {0x1F59, 0x0300, 0x1F5B},
+    {0x1F59, 0x0301, 0x1F5D},
+    {0x1F59, 0x0342, 0x1F5F},
+    {0x1F60, 0x0300, 0x1F62},
+    {0x1F60, 0x0301, 0x1F64},
+    {0x1F60, 0x0342, 0x1F66},
+    {0x1F60, 0x0345, 0x1FA0},
+    {0x1F61, 0x0300, 0x1F63},
+    {0x1F61, 0x0301, 0x1F65},
+    {0x1F61, 0x0342, 0x1F67},
+    {0x1F61, 0x0345, 0x1FA1},
+    {0x1F62, 0x0345, 0x1FA2},
+    {0x1F63, 0x0345, 0x1FA3},
+    {0x1F64, 0x0345, 0x1FA4},
+    {0x1F65, 0x0345, 0x1FA5},
+    {0x1F66, 0x0345, 0x1FA6},
+    {0x1F67, 0x0345, 0x1FA7},
+    {0x1F68, 0x0300, 0x1F6A},
+    {0x1F68, 0x0301, 0x1F6C},
+    {0x1F68, 0x0342, 0x1F6E},
+    {0x1F68, 0x0345, 0x1FA8},
+    {0x1F69, 0x0300, 0x1F6B},
+    {0x1F69, 0x0301, 0x1F6D},
+    {0x1F69, 0x0342, 0x1F6F},
+    {0x1F69, 0x0345, 0x1FA9},
+    {0x1F6A, 0x0345, 0x1FAA},
+    {0x1F6B, 0x0345, 0x1FAB},
+    {0x1F6C, 0x0345, 0x1FAC},
+    {0x1F6D, 0x0345, 0x1FAD},
+    {0x1F6E, 0x0345, 0x1FAE},
+    {0x1F6F, 0x0345, 0x1FAF},
+    {0x1F70, 0x0345, 0x1FB2},
+    {0x1F74, 0x0345, 0x1FC2},
+    {0x1F7C, 0x0345, 0x1FF2},
+    {0x1FB6, 0x0345, 0x1FB7},
+    {0x1FBF, 0x0300, 0x1FCD},
+    {0x1FBF, 0x0301, 0x1FCE},
+    {0x1FBF, 0x0342, 0x1FCF},
+    {0x1FC6, 0x0345, 0x1FC7},
+    {0x1FF6, 0x0345, 0x1FF7},
+    {0x1FFE, 0x0300, 0x1FDD},
+    {0x1FFE, 0x0301, 0x1FDE},
+    {0x1FFE, 0x0342, 0x1FDF},
+    {0x2190, 0x0338, 0x219A},
+    {0x2192, 0x0338, 0x219B},
+    {0x2194, 0x0338, 0x21AE},
+    {0x21D0, 0x0338, 0x21CD},
+    {0x21D2, 0x0338, 0x21CF},
+    {0x21D4, 0x0338, 0x21CE},
+    {0x2203, 0x0338, 0x2204},
+    {0x2208, 0x0338, 0x2209},
+    {0x220B, 0x0338, 0x220C},
+    {0x2223, 0x0338, 0x2224},
+    {0x2225, 0x0338, 0x2226},
+    {0x223C, 0x0338, 0x2241},
+    {0x2243, 0x0338, 0x2244},
+    {0x2245, 0x0338, 0x2247},
+    {0x2248, 0x0338, 0x2249},
+    {0x224D, 0x0338, 0x226D},
+    {0x2261, 0x0338, 0x2262},
+    {0x2264, 0x0338, 0x2270},
+    {0x2265, 0x0338, 0x2271},
+    {0x2272, 0x0338, 0x2274},
+    {0x2273, 0x0338, 0x2275},
+    {0x2276, 0x0338, 0x2278},
+    {0x2277, 0x0338, 0x2279},
+    {0x227A, 0x0338, 0x2280},
+    {0x227B, 0x0338, 0x2281},
+    {0x227C, 0x0338, 0x22E0},
+    {0x227D, 0x0338, 0x22E1},
+    {0x2282, 0x0338, 0x2284},
+    {0x2283, 0x0338, 0x2285},
+    {0x2286, 0x0338, 0x2288},
+    {0x2287, 0x0338, 0x2289},
+    {0x2291, 0x0338, 0x22E2},
+    {0x2292, 0x0338, 0x22E3},
+    {0x22A2, 0x0338, 0x22AC},
+    {0x22A8, 0x0338, 0x22AD},
+    {0x22A9, 0x0338, 0x22AE},
+    {0x22AB, 0x0338, 0x22AF},
+    {0x22B2, 0x0338, 0x22EA},
+    {0x22B3, 0x0338, 0x22EB},
+    {0x22B4, 0x0338, 0x22EC},
+    {0x22B5, 0x0338, 0x22ED},
+    {0x3046, 0x3099, 0x3094},
+    {0x304B, 0x3099, 0x304C},
+    {0x304D, 0x3099, 0x304E},
+    {0x304F, 0x3099, 0x3050},
+    {0x3051, 0x3099, 0x3052},
+    {0x3053, 0x3099, 0x3054},
+    {0x3055, 0x3099, 0x3056},
+    {0x3057, 0x3099, 0x3058},
+    {0x3059, 0x3099, 0x305A},
+    {0x305B, 0x3099, 0x305C},
+    {0x305D, 0x3099, 0x305E},
+    {0x305F, 0x3099, 0x3060},
+    {0x3061, 0x3099, 0x3062},
+    {0x3064, 0x3099, 0x3065},
+    {0x3066, 0x3099, 0x3067},
+    {0x3068, 0x3099, 0x3069},
+    {0x306F, 0x3099, 0x3070},
+    {0x306F, 0x309A, 0x3071},
+    {0x3072, 0x3099, 0x3073},
+    {0x3072, 0x309A, 0x3074},
+    {0x3075, 0x3099, 0x3076},
+    {0x3075, 0x309A, 0x3077},
+    {0x3078, 0x3099, 0x3079},
+    {0x3078, 0x309A, 0x307A},
+    {0x307B, 0x3099, 0x307C},
+    {0x307B, 0x309A, 0x307D},
+    {0x309D, 0x3099, 0x309E},
+    {0x30A6, 0x3099, 0x30F4},
+    {0x30AB, 0x3099, 0x30AC},
+    {0x30AD, 0x3099, 0x30AE},
+    {0x30AF, 0x3099, 0x30B0},
+    {0x30B1, 0x3099, 0x30B2},
+    {0x30B3, 0x3099, 0x30B4},
+    {0x30B5, 0x3099, 0x30B6},
+    {0x30B7, 0x3099, 0x30B8},
+    {0x30B9, 0x3099, 0x30BA},
+    {0x30BB, 0x3099, 0x30BC},
+    {0x30BD, 0x3099, 0x30BE},
+    {0x30BF, 0x3099, 0x30C0},
+    {0x30C1, 0x3099, 0x30C2},
+    {0x30C4, 0x3099, 0x30C5},
+    {0x30C6, 0x3099, 0x30C7},
+    {0x30C8, 0x3099, 0x30C9},
+    {0x30CF, 0x3099, 0x30D0},
+    {0x30CF, 0x309A, 0x30D1},
+    {0x30D2, 0x3099, 0x30D3},
+    {0x30D2, 0x309A, 0x30D4},
+    {0x30D5, 0x3099, 0x30D6},
+    {0x30D5, 0x309A, 0x30D7},
+    {0x30D8, 0x3099, 0x30D9},
+    {0x30D8, 0x309A, 0x30DA},
+    {0x30DB, 0x3099, 0x30DC},
+    {0x30DB, 0x309A, 0x30DD},
+    {0x30EF, 0x3099, 0x30F7},
+    {0x30F0, 0x3099, 0x30F8},
+    {0x30F1, 0x3099, 0x30F9},
+    {0x30F2, 0x3099, 0x30FA},
+    {0x30FD, 0x3099, 0x30FE},
+    {0x11099, 0x110BA, 0x1109A},
+    {0x1109B, 0x110BA, 0x1109C},
+    {0x110A5, 0x110BA, 0x110AB},
+    {0x11131, 0x11127, 0x1112E},
+    {0x11132, 0x11127, 0x1112F},
+    {0x11347, 0x1133E, 0x1134B},
+    {0x11347, 0x11357, 0x1134C},
+    {0x114B9, 0x114B0, 0x114BC},
+    {0x114B9, 0x114BA, 0x114BB},
+    {0x114B9, 0x114BD, 0x114BE},
+    {0x115B8, 0x115AF, 0x115BA},
+    {0x115B9, 0x115AF, 0x115BB},
+    {0x11935, 0x11930, 0x11938},
+}};
+
+// 完全大小写折叠（CaseFolding.txt 的 C 与 F 项），按码位排序
+constexpr std::array<MappingEntry, 1530> kCaseFoldIndex = {{
+    {0x0041, 0, 1},
+    {0x0042, 1, 1},
+    {0x0043, 2, 1},
+    {0x0044, 3, 1},
+    {0x0045, 4, 1},
+    {0x0046, 5, 1},
+    {0x0047, 6, 1},
+    {0x0048, 7, 1},
+    {0x0049, 8, 1},
+    {0x004A, 9, 1},
+    {0x004B, 10, 1},
+    {0x004C, 11, 1},
+    {0x004D, 12, 1},
+    {0x004E, 13, 1},
+    {0x004F, 14, 1},
+    {0x0050, 15, 1},
+    {0x0051, 16, 1},
+    {0x0052, 17, 1},
+    {0x0053, 18, 1},
+    {0x0054, 19, 1},
+    {0x0055, 20, 1},
+    {0x0056, 21, 1},
+    {0x0057, 22, 1},
+    {0x0058, 23, 1},
+    {0x0059, 24, 1},
+    {0x005A, 25, 1},
+    {0x00B5, 26, 1},
+    {0x00C0, 27, 1},
+    {0x00C1, 28, 1},
+    {0x00C2, 29, 1},
+    {0x00C3, 30, 1},
+    {0x00C4, 31, 1},
+    {0x00C5, 32, 1},
+    {0x00C6, 33, 1},
+    {0x00C7, 34, 1},
+    {0x00C8, 35, 1},
+    {0x00C9, 36, 1},
+    {0x00CA, 37, 1},
+    {0x00CB, 38, 1},
+    {0x00CC, 39, 1},
+    {0x00CD, 40, 1},
+    {0x00CE, 41, 1},
+    {0x00CF, 42, 1},
+    {0x00D0, 43, 1},
+    {0x00D1, 44, 1},
+    {0x00D2, 45, 1},
+    {0x00D3, 46, 1},
+    {0x00D4, 47, 1},
+    {0x00D5, 48, 1},
+    {0x00D6, 49, 1},
+    {0x00D8, 50, 1},
+    {0x00D9, 51, 1},
+    {0x00DA, 52, 1},
+    {0x00DB, 53, 1},
+    {0x00DC, 54, 1},
+    {0x00DD, 55, 1},
+    {0x00DE, 56, 1},
+    {0x00DF, 57, 2},
+    {0x0100, 59, 1},
+    {0x0102, 60, 1},
+    {0x0104, 61, 1},
+    {0x0106, 62, 1},
+    {0x0108, 63, 1},
+    {0x010A, 64, 1},
+    {0x010C, 65, 1},
+    {0x010E, 66, 1},
+    {0x0110, 67, 1},
+    {0x0112, 68, 1},
+    {0x0114, 69, 1},
+    {0x0116, 70, 1},
+    {0x0118, 71, 1},
+    {0x011A, 72, 1},
+    {0x011C, 73, 1},
+    {0x011E, 74, 1},
+    {0x0120, 75, 1},
+    {0x0122, 76, 1},
+    {0x0124, 77, 1},
+    {0x0126, 78, 1},
+    {0x0128, 79, 1},
+    {0x012A, 80, 1},
+    {0x012C, 81, 1},
+    {0x012E, 82, 1},
+    {0x0130, 83, 2},
+    {0x0132, 85, 1},
+    {0x0134, 86, 1},
+    {0x0136, 87, 1},
+    {0x0139, 88, 1},
+    {0x013B, 89, 1},
+    {0x013D, 90, 1},
+    {0x013F, 91, 1},
+    {0x0141, 92, 1},
+    {0x0143, 93, 1},
+    {0x0145, 94, 1},
+    {0x0147, 95, 1},
+    {0x0149, 96, 2},
+    {0x014A, 98, 1},
+    {0x014C, 99, 1},
+    {0x014E, 100, 1},
+    {0x0150, 101, 1},
+    {0x0152, 102, 1},
+    {0x0154, 103, 1},
+    {0x0156, 104, 1},
+    {0x0158, 105, 1},
+    {0x015A, 106, 1},
+    {0x015C, 107, 1},
+    {0x015E, 108, 1},
+    {0x0160, 109, 1},
+    {0x0162, 110, 1},
+    {0x0164, 111, 1},
+    {0x0166, 112, 1},
+    {0x0168, 113, 1},
+    {0x016A, 114, 1},
+    {0x016C, 115, 1},
+    {0x016E, 116, 1},
+    {0x0170, 117, 1},
+    {0x0172, 118, 1},
+    {0x0174, 119, 1},
+    {0x0176, 120, 1},
+    {0x0178, 121, 1},
+    {0x0179, 122, 1},
+    {0x017B, 123, 1},
+    {0x017D, 124, 1},
+    {0x017F, 125, 1},
+    {0x0181, 126, 1},
+    {0x0182, 127, 1},
+    {0x0184, 128, 1},
+    {0x0186, 129, 1},
+    {0x0187, 130, 1},
+    {0x0189, 131, 1},
+    {0x018A, 132, 1},
+    {0x018B, 133, 1},
+    {0x018E, 134, 1},
+    {0x018F, 135, 1},
+    {0x0190, 136, 1},
+    {0x0191, 137, 1},
+    {0x0193, 138, 1},
+    {0x0194, 139, 1},
+    {0x0196, 140, 1},
+    {0x0197, 141, 1},
+    {0x0198, 142, 1},
+    {0x019C, 143, 1},
+    {0x019D, 144, 1},
+    {0x019F, 145, 1},
+    {0x01A0, 146, 1},
+    {0x01A2, 147, 1},
+    {0x01A4, 148, 1},
+    {0x01A6, 149, 1},
+    {0x01A7, 150, 1},
+    {0x01A9, 151, 1},
+    {0x01AC, 152, 1},
+    {0x01AE, 153, 1},
+    {0x01AF, 154, 1},
+    {0x01B1, 155, 1},
+    {0x01B2, 156, 1},
+    {0x01B3, 157, 1},
+    {0x01B5, 158, 1},
+    {0x01B7, 159, 1},
+    {0x01B8, 160, 1},
+    {0x01BC, 161, 1},
+    {0x01C4, 162, 1},
+    {0x01C5, 163, 1},
+    {0x01C7, 164, 1},
+    {0x01C8, 165, 1},
+    {0x01CA, 166, 1},
+    {0x01CB, 167, 1},
+    {0x01CD, 168, 1},
+    {0x01CF, 169, 1},
+    {0x01D1, 170, 1},
+    {0x01D3, 171, 1},
+    {0x01D5, 172, 1},
+    {0x01D7, 173, 1},
+    {0x01D9, 174, 1},
+    {0x01DB, 175, 1},
+    {0x01DE, 176, 1},
+    {0x01E0, 177, 1},
+    {0x01E2, 178, 1},
+    {0x01E4, 179, 1},
+    {0x01E6, 180, 1},
+    {0x01E8, 181, 1},
+    {0x01EA, 182, 1},
+    {0x01EC, 183, 1},
+    {0x01EE, 184, 1},
+    {0x01F0, 185, 2},
+    {0x01F1, 187, 1},
+    {0x01F2, 188, 1},
+    {0x01F4, 189, 1},
+    {0x01F6, 190, 1},
+    {0x01F7, 191, 1},
+    {0x01F8, 192, 1},
+    {0x01FA, 193, 1},
+    {0x01FC, 194, 1},
+    {0x01FE, 195, 1},
+    {0x0200, 196, 1},
+    {0x0202, 197, 1},
+    {0x0204, 198, 1},
+    {0x0206, 199, 1},
+    {0x0208, 200, 1},
+    {0x020A, 201, 1},
+    {0x020C, 202, 1},
+    {0x020E, 203, 1},
+    {0x0210, 204, 1},
+    {0x0212, 205, 1},
+    {0x0214, 206, 1},
+    {0x0216, 207, 1},
+    {0x0218, 208, 1},
+    {0x021A, 209, 1},
+    {0x021C, 210, 1},
+    {0x021E, 211, 1},
+    {0x0220, 212, 1},
+    {0x0222, 213, 1},
+    {0x0224, 214, 1},
+    {0x0226, 215, 1},
+    {0x0228, 216, 1},
+    {0x022A, 217, 1},
+    {0x022C, 218, 1},
+    {0x022E, 219, 1},
+    {0x0230, 220, 1},
+    {0x0232, 221, 1},
+    {0x023A, 222, 1},
+    {0x023B, 223, 1},
+    {0x023D, 224, 1},
+    {0x023E, 225, 1},
+    {0x0241, 226, 1},
+    {0x0243, 227, 1},
+    {0x0244, 228, 1},
+    {0x0245, 229, 1},
+    {0x0246, 230, 1},
+    {0x0248, 231, 1},
+    {0x024A, 232, 1},
+    {0x024C, 233, 1},
+    {0x024E, 234, 1},
+    {0x0345, 235, 1},
+    {0x0370, 236, 1},
+    {0x0372, 237, 1},
+    {0x0376, 238, 1},
+    {0x037F, 239, 1},
+    {0x0386, 240, 1},
+    {0x0388, 241, 1},
+    {0x0389, 242, 1},
+    {0x038A, 243, 1},
+    {0x038C, 244, 1},
+    {0x038E, 245, 1},
+    {0x038F, 246, 1},
+    {0x0390, 247, 3},
+    {0x0391, 250, 1},
+    {0x0392, 251, 1},
+    {0x0393, 252, 1},
+    {0x0394, 253, 1},
+    {0x0395, 254, 1},
+    {0x0396, 255, 1},
+    {0x0397, 256, 1},
+    {0x0398, 257, 1},
+    {0x0399, 258, 1},
+    {0x039A, 259, 1},
+    {0x039B, 260, 1},
+    {0x039C, 261, 1},
+    {0x039D, 262, 1},
+    {0x039E, 263, 1},
+    {0x039F, 264, 1},
+    {0x03A0, 265, 1},
+    {0x03A1, 266, 1},
+    {0x03A3, 267, 1},
+    {0x03A4, 268, 1},
+    {0x03A5, 269, 1},
+    {0x03A6, 270, 1},
+    {0x03A7, 271, 1},
+    {0x03A8, 272, 1},
+    {0x03A9, 273, 1},
+    {0x03AA, 274, 1},
+    {0x03AB, 275, 1},
+    {0x03B0, 276, 3},
+    {0x03C2, 279, 1},
+    {0x03CF, 280, 1},
+    {0x03D0, 281, 1},
+    {0x03D1, 282, 1},
+    {0x03D5, 283, 1},
+    {0x03D6, 284, 1},
+    {0x03D8, 285, 1},
+    {0x03DA, 286, 1},
+    {0x03DC, 287, 1},
+    {0x03DE, 288, 1},
+    {0x03E0, 289, 1},
+    {0x03E2, 290, 1},
+    {0x03E4, 291, 1},
+    {0x03E6, 292, 1},
+    {0x03E8, 293, 1},
+    {0x03EA, 294, 1},
+    {0x03EC, 295, 1},
+    {0x03EE, 296, 1},
+    {0x03F0, 297, 1},
+    {0x03F1, 298, 1},
+    {0x03F4, 299, 1},
+    {0x03F5, 300, 1},
+    {0x03F7, 301, 1},
+    {0x03F9, 302, 1},
+    {0x03FA, 303, 1},
+    {0x03FD, 304, 1},
+    {0x03FE, 305, 1},
+    {0x03FF, 306, 1},
+    {0x0400, 307, 1},
+    {0x0401, 308, 1},
+    {0x0402, 309, 1},
+    {0x0403, 310, 1},
+    {0x0404, 311, 1},
+    {0x0405, 312, 1},
+    {0x0406, 313, 1},
+    {0x0407, 314, 1},
+    {0x0408, 315, 1},
+    {0x0409, 316, 1},
+    {0x040A, 317, 1},
+    {0x040B, 318, 1},
+    {0x040C, 319, 1},
+    {0x040D, 320, 1},
+    {0x040E, 321, 1},
+    {0x040F, 322, 1},
+    {0x0410, 323, 1},
+    {0x0411, 324, 1},
+    {0x0412, 325, 1},
+    {0x0413, 326, 1},
+    {0x0414, 327, 1},
+    {0x0415, 328, 1},
+    {0x0416, 329, 1},
+    {0x0417, 330, 1},
+    {0x0418, 331, 1},
+    {0x0419, 332, 1},
+    {0x041A, 333, 1},
+    {0x041B, 334, 1},
+    {0x041C, 335, 1},
+    {0x041D, 336, 1},
+    {0x041E, 337, 1},
+    {0x041F, 338, 1},
+    {0x0420, 339, 1},
+    {0x0421, 340, 1},
+    {0x0422, 341, 1},
+    {0x0423, 342, 1},
+    {0x0424, 343, 1},
+    {0x0425, 344, 1},
+    {0x0426, 345, 1},
+    {0x0427, 346, 1},
+    {0x0428, 347, 1},
+    {0x0429, 348, 1},
+    {0x042A, 349, 1},
+    {0x042B, 350, 1},
+    {0x042C, 351, 1},
+    {0x042D, 352, 1},
+    {0x042E, 353, 1},
+    {0x042F, 354, 1},
+    {0x0460, 355, 1},
+    {0x0462, 356, 1},
+    {0x0464, 357, 1},
+    {0x0466, 358, 1},
+    {0x0468, 359, 1},
+    {0x046A, 360, 1},
+    {0x046C, 361, 1},
+    {0x046E, 362, 1},
+    {0x0470, 363, 1},
+    {0x0472, 364, 1},
+    {0x0474, 365, 1},
+    {0x0476, 366, 1},
+    {0x0478, 367, 1},
+    {0x047A, 368, 1},
+    {0x047C, 369, 1},
+    {0x047E, 370, 1},
+    {0x0480, 371, 1},
+    {0x048A, 372, 1},
+    {0x048C, 373, 1},
+    {0x048E, 374, 1},
+    {0x0490, 375, 1},
+    {0x0492, 376, 1},
+    {0x0494, 377, 1},
+    {0x0496, 378, 1},
+    {0x0498, 379, 1},
+    {0x049A, 380, 1},
+    {0x049C, 381, 1},
+    {0x049E, 382, 1},
+    {0x04A0, 383, 1},
+    {0x04A2, 384, 1},
+    {0x04A4, 385, 1},
+    {0x04A6, 386, 1},
+    {0x04A8, 387, 1},
+    {0x04AA, 388, 1},
+    {0x04AC, 389, 1},
+    {0x04AE, 390, 1},
+    {0x04B0, 391, 1},
+    {0x04B2, 392, 1},
+    {0x04B4, 393, 1},
+    {0x04B6, 394, 1},
+    {0x04B8, 395, 1},
+    {0x04BA, 396, 1},
+    {0x04BC, 397, 1},
+    {0x04BE, 398, 1},
+    {0x04C0, 399, 1},
+    {0x04C1, 400, 1},
+    {0x04C3, 401, 1},
+    {0x04C5, 402, 1},
+    {0x04C7, 403, 1},
+    {0x04C9, 404, 1},
+    {0x04CB, 405, 1},
+    {0x04CD, 406, 1},
+    {0x04D0, 407, 1},
+    {0x04D2, 408, 1},
+    {0x04D4, 409, 1},
+    {0x04D6, 410, 1},
+    {0x04D8, 411, 1},
+    {0x04DA, 412, 1},
+    {0x04DC, 413, 1},
+    {0x04DE, 414, 1},
+    {0x04E0, 415, 1},
+    {0x04E2, 416, 1},
+    {0x04E4, 417, 1},
+    {0x04E6, 418, 1},
+    {0x04E8, 419, 1},
+    {0x04EA, 420, 1},
+    {0x04EC, 421, 1},
+    {0x04EE, 422, 1},
+    {0x04F0, 423, 1},
+    {0x04F2, 424, 1},
+    {0x04F4, 425, 1},
+    {0x04F6, 426, 1},
+    {0x04F8, 427, 1},
+    {0x04FA, 428, 1},
+    {0x04FC, 429, 1},
+    {0x04FE, 430, 1},
+    {0x0500, 431, 1},
+    {0x0502, 432, 1},
+    {0x0504, 433, 1},
+    {0x0506, 434, 1},
+    {0x0508, 435, 1},
+    {0x050A, 436, 1},
+    {0x050C, 437, 1},
+    {0x050E, 438, 1},
+    {0x0510, 439, 1},
+    {0x0512, 440, 1},
+    {0x0514, 441, 1},
+    {0x0516, 442, 1},
+    {0x0518, 443, 1},
+    {0x051A, 444, 1},
+    {0x051C, 445, 1},
+    {0x051E, 446, 1},
+    {0x0520, 447, 1},
+    {0x0522, 448, 1},
+    {0x0524, 449, 1},
+    {0x0526, 450, 1},
+    {0x0528, 451, 1},
+    {0x052A, 452, 1},
+    {0x052C, 453, 1},
+    {0x052E, 454, 1},
+    {0x0531, 455, 1},
+    {0x0532, 456, 1},
+    {0x0533, 457, 1},
+    {0x0534, 458, 1},
+    {0x0535, 459, 1},
+    {0x0536, 460, 1},
+    {0x0537, 461, 1},
+    {0x0538, 462, 1},
+    {0x0539, 463, 1},
+    {0x053A, 464, 1},
+    {0x053B, 465, 1},
+    {0x053C, 466, 1},
+    {0x053D, 467, 1},
+    {0x053E, 468, 1},
+    {0x053F, 469, 1},
+    {0x0540, 470, 1},
+    {0x0541, 471, 1},
+    {0x0542, 472, 1},
+    {0x0543, 473, 1},
+    {0x0544, 474, 1},
+    {0x0545, 475, 1},
+    {0x0546, 476, 1},
+    {0x0547, 477, 1},
+    {0x0548, 478, 1},
+    {0x0549, 479, 1},
+    {0x054A, 480, 1},
+    {0x054B, 481, 1},
+    {0x054C, 482, 1},
+    {0x054D, 483, 1},
+    {0x054E, 484, 1},
+    {0x054F, 485, 1},
+    {0x0550, 486, 1},
+    {0x0551, 487, 1},
+    {0x0552, 488, 1},
+    {0x0553, 489, 1},
+    {0x0554, 490, 1},
+    {0x0555, 491, 1},
+    {0x0556, 492, 1},
+    {0x0587, 493, 2},
+    {0x10A0, 495, 1},
+    {0x10A1, 496, 1},
+    {0x10A2, 497, 1},
+    {0x10A3, 498, 1},
+    {0x10A4, 499, 1},
+    {0x10A5, 500, 1},
+    {0x10A6, 501, 1},
+    {0x10A7, 502, 1},
+    {0x10A8, 503, 1},
+    {0x10A9, 504, 1},
+    {0x10AA, 505, 1},
+    {0x10AB, 506, 1},
+    {0x10AC, 507, 1},
+    {0x10AD, 508, 1},
+    {0x10AE, 509, 1},
+    {0x10AF, 510, 1},
+    {0x10B0, 511, 1},
+    {0x10B1, 512, 1},
+    {0x10B2, 513, 1},
+    {0x10B3, 514, 1},
+    {0x10B4, 515, 1},
+    {0x10B5, 516, 1},
+    {0x10B6, 517, 1},
+    {0x10B7, 518, 1},
+    {0x10B8, 519, 1},
+    {0x10B9, 520, 1},
+    {0x10BA, 521, 1},
+    {0x10BB, 522, 1},
+    {0x10BC, 523, 1},
+    {0x10BD, 524, 1},
+    {0x10BE, 525, 1},
+    {0x10BF, 526, 1},
+    {0x10C0, 527, 1},
+    {0x10C1, 528, 1},
+    {0x10C2, 529, 1},
+    {0x10C3, 530, 1},
+    {0x10C4, 531, 1},
+    {0x10C5, 532, 1},
+    {0x10C7, 533, 1},
+    {0x10CD, 534, 1},
+    {0x13F8, 535, 1},
+    {0x13F9, 536, 1},
+    {0x13FA, 537, 1},
+    {0x13FB, 538, 1},
+    {0x13FC, 539, 1},
+    {0x13FD, 540, 1},
+    {0x1C80, 541, 1},
+    {0x1C81, 542, 1},
+    {0x1C82, 543, 1},
+    {0x1C83, 544, 1},
+    {0x1C84, 545, 1},
+    {0x1C85, 546, 1},
+    {0x1C86, 547, 1},
+    {0x1C87, 548, 1},
+    {0x1C88, 549, 1},
+    {0x1C90, 550, 1},
+    {0x1C91, 551, 1},
+    {0x1C92, 552, 1},
+    {0x1C93, 553, 1},
+    {0x1C94, 554, 1},
+    {0x1C95, 555, 1},
+    {0x1C96, 556, 1},
+    {0x1C97, 557, 1},
+    {0x1C98, 558, 1},
+    {0x1C99, 559, 1},
+    {0x1C9A, 560, 1},
+    {0x1C9B, 561, 1},
+    {0x1C9C, 562, 1},
+    {0x1C9D, 563, 1},
+    {0x1C9E, 564, 1},
+    {0x1C9F, 565, 1},
+    {0x1CA0, 566, 1},
+    {0x1CA1, 567, 1},
+    {0x1CA2, 568, 1},
+    {0x1CA3, 569, 1},
+    {0x1CA4, 570, 1},
+    {0x1CA5, 571, 1},
+    {0x1CA6, 572, 1},
+    {0x1CA7, 573, 1},
+    {0x1CA8, 574, 1},
+    {0x1CA9, 575, 1},
+    {0x1CAA, 576, 1},
+    {0x1CAB, 577, 1},
+    {0x1CAC, 578, 1},
+    {0x1CAD, 579, 1},
+    {0x1CAE, 580, 1},
+    {0x1CAF, 581, 1},
+    {0x1CB0, 582, 1},
+    {0x1CB1, 583, 1},
+    {0x1CB2, 584, 1},
+    {0x1CB3, 585, 1},
+    {0x1CB4, 586, 1},
+    {0x1CB5, 587, 1},
+    {0x1CB6, 588, 1},
+    {0x1CB7, 589, 1},
+    {0x1CB8, 590, 1},
+    {0x1CB9, 591, 1},
+    {0x1CBA, 592, 1},
+    {0x1CBD, 593, 1},
+    {0x1CBE, 594, 1},
+    {0x1CBF, 595, 1},
+    {0x1E00, 596, 1},
+    {0x1E02, 597, 1},
+    {0x1E04, 598, 1},
+    {0x1E06, 599, 1},
+    {0x1E08, 600, 1},
+    {0x1E0A, 601, 1},
+    {0x1E0C, 602, 1},
+    {0x1E0E, 603, 1},
+    {0x1E10, 604, 1},
+    {0x1E12, 605, 1},
+    {0x1E14, 606, 1},
+    {0x1E16, 607, 1},
+    {0x1E18, 608, 1},
+    {0x1E1A, 609, 1},
+    {0x1E1C, 610, 1},
+    {0x1E1E, 611, 1},
+    {0x1E20, 612, 1},
+    {0x1E22, 613, 1},
+    {0x1E24, 614, 1},
+    {0x1E26, 615, 1},
+    {0x1E28, 616, 1},
+    {0x1E2A, 617, 1},
+    {0x1E2C, 618, 1},
+    {0x1E2E, 619, 1},
+    {0x1E30, 620, 1},
+    {0x1E32, 621, 1},
+    {0x1E34, 622, 1},
+    {0x1E36, 623, 1},
+    {0x1E38, 624, 1},
+    {0x1E3A, 625, 1},
+    {0x1E3C, 626, 1},
+    {0x1E3E, 627, 1},
+    {0x1E40, 628, 1},
+    {0x1E42, 629, 1},
+    {0x1E44, 630, 1},
+    {0x1E46, 631, 1},
+    {0x1E48, 632, 1},
+    {0x1E4A, 633, 1},
+    {0x1E4C, 634, 1},
+    {0x1E4E, 635, 1},
+    {0x1E50, 636, 1},
+    {0x1E52, 637, 1},
+    {0x1E54, 638, 1},
+    {0x1E56, 639, 1},
+    {0x1E58, 640, 1},
+    {0x1E5A, 641, 1},
+    {0x1E5C, 642, 1},
+    {0x1E5E, 643, 1},
+    {0x1E60, 644, 1},
+    {0x1E62, 645, 1},
+    {0x1E64, 646, 1},
+    {0x1E66, 647, 1},
+    {0x1E68, 648, 1},
+    {0x1E6A, 649, 1},
+    {0x1E6C, 650, 1},
+    {0x1E6E, 651, 1},
+    {0x1E70, 652, 1},
+    {0x1E72, 653, 1},
+    {0x1E74, 654, 1},
+    {0x1E76, 655, 1},
+    {0x1E78, 656, 1},
+    {0x1E7A, 657, 1},
+    {0x1E7C, 658, 1},
+    {0x1E7E, 659, 1},
+    {0x1E80, 660, 1},
+    {0x1E82, 661, 1},
+    {0x1E84, 662, 1},
+    {0x1E86, 663, 1},
+    {0x1E88, 664, 1},
+    {0x1E8A, 665, 1},
+    {0x1E8C, 666, 1},
+    {0x1E8E, 667, 1},
+    {0x1E90, 668, 1},
+    {0x1E92, 669, 1},
+    {0x1E94, 670, 1},
+    {0x1E96, 671, 2},
+    {0x1E97, 673, 2},
+    {0x1E98, 675, 2},
+    {0x1E99, 677, 2},
+    {0x1E9A, 679, 2},
+    {0x1E9B, 681, 1},
+    {0x1E9E, 682, 2},
+    {0x1EA0, 684, 1},
+    {0x1EA2, 685, 1},
+    {0x1EA4, 686, 1},
+    {0x1EA6, 687, 1},
+    {0x1EA8, 688, 1},
+    {0x1EAA, 689, 1},
+    {0x1EAC, 690, 1},
+    {0x1EAE, 691, 1},
+    {0x1EB0, 692, 1},
+    {0x1EB2, 693, 1},
+    {0x1EB4, 694, 1},
+    {0x1EB6, 695, 1},
+    {0x1EB8, 696, 1},
+    {0x1EBA, 697, 1},
+    {0x1EBC, 698, 1},
+    {0x1EBE, 699, 1},
+    {0x1EC0, 700, 1},
+    {0x1EC2, 701, 1},
+    {0x1EC4, 702, 1},
+    {0x1EC6, 703, 1},
+    {0x1EC8, 704, 1},
+    {0x1ECA, 705, 1},
+    {0x1ECC, 706, 1},
+    {0x1ECE, 707, 1},
+    {0x1ED0, 708, 1},
+    {0x1ED2, 709, 1},
+    {0x1ED4, 710, 1},
+    {0x1ED6, 711, 1},
+    {0x1ED8, 712, 1},
+    {0x1EDA, 713, 1},
+    {0x1EDC, 714, 1},
+    {0x1EDE, 715, 1},
+    {0x1EE0, 716, 1},
+    {0x1EE2, 717, 1},
+    {0x1EE4, 718, 1},
+    {0x1EE6, 719, 1},
+    {0x1EE8, 720, 1},
+    {0x1EEA, 721, 1},
+    {0x1EEC, 722, 1},
+    {0x1EEE, 723, 1},
+    {0x1EF0, 724, 1},
+    {0x1EF2, 725, 1},
+    {0x1EF4, 726, 1},
+    {0x1EF6, 727, 1},
+    {0x1EF8, 728, 1},
+    {0x1EFA, 729, 1},
+    {0x1EFC, 730, 1},
+    {0x1EFE, 731, 1},
+    {0x1F08, 732, 1},
+    {0x1F09, 733, 1},
+    {0x1F0A, 734, 1},
+    {0x1F0B, 735, 1},
+    {0x1F0C, 736, 1},
+    {0x1F0D, 737, 1},
+    {0x1F0E, 738, 1},
+    {0x1F0F, 739, 1},
+    {0x1F18, 740, 1},
+    {0x1F19, 741, 1},
+    {0x1F1A, 742, 1},
+    {0x1F1B, 743, 1},
+    {0x1F1C, 744, 1},
+    {0x1F1D, 745, 1},
+    {0x1F28, 746, 1},
+    {0x1F29, 747, 1},
+    {0x1F2A, 748, 1},
+    {0x1F2B, 749, 1},
+    {0x1F2C, 750, 1},
+    {0x1F2D, 751, 1},
+    {0x1F2E, 752, 1},
+    {0x1F2F, 753, 1},
+    {0x1F38, 754, 1},
+    {0x1F39, 755, 1},
+    {0x1F3A, 756, 1},
+    {0x1F3B, 757, 1},
+    {0x1F3C, 758, 1},
+    {0x1F3D, 759, 1},
+    {0x1F3E, 760, 1},
+    {0x1F3F, 761, 1},
+    {0x1F48, 762, 1},
+    {0x1F49, 763, 1},
+    {0x1F4A, 764, 1},
+    {0x1F4B, 765, 1},
+    {0x1F4C, 766, 1},
+    {0x1F4D, 767, 1},
+    {0x1F50, 768, 2},
+    {0x1F52, 770, 3},
+    {0x1F54, 773, 3},
+    {0x1F56, 776, 3},
+    {0x1F59, 779, 1},
+    {0x1F5B, 780, 1},
+    {0x1F5D, 781, 1},
+    {0x1F5F, 782, 1},
+    {0x1F68, 783, 1},
+    {0x1F69, 784, 1},
+    {0x1F6A, 785, 1},
+    {0x1F6B, 786, 1},
+    {0x1F6C, 787, 1},
+    {0x1F6D, 788, 1},
+    {0x1F6E, 789, 1},
+    {0x1F6F, 790, 1},
+    {0x1F80, 791, 2},
+    {0x1F81, 793, 2},
+    {0x1F82, 795, 2},
+    {0x1F83, 797, 2},
+    {0x1F84, 799, 2},
+    {0x1F85, 801, 2},
+    {0x1F86, 803, 2},
+    {0x1F87, 805, 2},
+    {0x1F88, 807, 2},
+    {0x1F89, 809, 2},
+    {0x1F8A, 811, 2},
+    {0x1F8B, 813, 2},
+    {0x1F8C, 815, 2},
+    {0x1F8D, 817, 2},
+    {0x1F8E, 819, 2},
+    {0x1F8F, 821, 2},
+    {0x1F90, 823, 2},
+    {0x1F91, 825, 2},
+    {0x1F92, 827, 2},
+    {0x1F93, 829, 2},
+    {0x1F94, 831, 2},
+    {0x1F95, 833, 2},
+    {0x1F96, 835, 2},
+    {0x1F97, 837, 2},
+    {0x1F98, 839, 2},
+    {0x1F99, 841, 2},
+    {0x1F9A, 843, 2},
+    {0x1F9B, 845, 2},
+    {0x1F9C, 847, 2},
+    {0x1F9D, 849, 2},
+    {0x1F9E, 851, 2},
+    {0x1F9F, 853, 2},
+    {0x1FA0, 855, 2},
+    {0x1FA1, 857, 2},
+    {0x1FA2, 859, 2},
+    {0x1FA3, 861, 2},
+    {0x1FA4, 863, 2},
+    {0x1FA5, 865, 2},
+    {0x1FA6, 867, 2},
+    {0x1FA7, 869, 2},
+    {0x1FA8, 871, 2},
+    {0x1FA9, 873, 2},
+    {0x1FAA, 875, 2},
+    {0x1FAB, 877, 2},
+    {0x1FAC, 879, 2},
+    {0x1FAD, 881, 2},
+    {0x1FAE, 883, 2},
+    {0x1FAF, 885, 2},
+    {0x1FB2, 887, 2},
+    {0x1FB3, 889, 2},
+    {0x1FB4, 891, 2},
+    {0x1FB6, 893, 2},
+    {0x1FB7, 895, 3},
+    {0x1FB8, 898, 1},
+    {0x1FB9, 899, 1},
+    {0x1FBA, 900, 1},
+    {0x1FBB, 901, 1},
+    {0x1FBC, 902, 2},
+    {0x1FBE, 904, 1},
+    {0x1FC2, 905, 2},
+    {0x1FC3, 907, 2},
+    {0x1FC4, 909, 2},
+    {0x1FC6, 911, 2},
+    {0x1FC7, 913, 3},
+    {0x1FC8, 916, 1},
+    {0x1FC9, 917, 1},
+    {0x1FCA, 918, 1},
+    {0x1FCB, 919, 1},
+    {0x1FCC, 920, 2},
+    {0x1FD2, 922, 3},
+    {0x1FD3, 925, 3},
+    {0x1FD6, 928, 2},
+    {0x1FD7, 930, 3},
+    {0x1FD8, 933, 1},
+    {0x1FD9, 934, 1},
+    {0x1FDA, 935, 1},
+    {0x1FDB, 936, 1},
+    {0x1FE2, 937, 3},
+    {0x1FE3, 940, 3},
+    {0x1FE4, 943, 2},
+    {0x1FE6, 945, 2},
+    {0x1FE7, 947, 3},
+    {0x1FE8, 950, 1},
+    {0x1FE9, 951, 1},
+    {0x1FEA, 952, 1},
+    {0x1FEB, 953, 1},
+    {0x1FEC, 954, 1},
+    {0x1FF2, 955, 2},
+    {0x1FF3, 957, 2},
+    {0x1FF4, 959, 2},
+    {0x1FF6, 961, 2},
+    {0x1FF7, 963, 3},
+    {0x1FF8, 966, 1},
+    {0x1FF9, 967, 1},
+    {0x1FFA, 968, 1},
+    {0x1FFB, 969, 1},
+    {0x1FFC, 970, 2},
+    {0x2126, 972, 1},
+    {0x212A, 973, 1},
+    {0x212B, 974, 1},
+    {0x2132, 975, 1},
+    {0x2160, 976, 1},
+    {0x2161, 977, 1},
+    {0x2162, 978, 1},
+    {0x2163, 979, 1},
+    {0x2164, 980, 1},
+    {0x2165, 981, 1},
+    {0x2166, 982, 1},
+    {0x2167, 983, 1},
+    {0x2168, 984, 1},
+    {0x2169, 985, 1},
+    {0x216A, 986, 1},
+    {0x216B, 987, 1},
+    {0x216C, 988, 1},
+    {0x216D, 989, 1},
+    {0x216E, 990, 1},
+    {0x216F, 991, 1},
+    {0x2183, 992, 1},
+    {0x24B6, 993, 1},
+    {0x24B7, 994, 1},
+    {0x24B8, 995, 1},
+    {0x24B9, 996, 1},
+    {0x24BA, 997, 1},
+    {0x24BB, 998, 1},
+    {0x24BC, 999, 1},
+    {0x24BD, 1000, 1},
+    {0x24BE, 1001, 1},
+    {0x24BF, 1002, 1},
+    {0x24C0, 1003, 1},
+    {0x24C1, 1004, 1},
+    {0x24C2, 1005, 1},
+    {0x24C3, 1006, 1},
+    {0x24C4, 1007, 1},
+    {0x24C5, 1008, 1},
+    {0x24C6, 1009, 1},
+    {0x24C7, 1010, 1},
+    {0x24C8, 1011, 1},
+    {0x24C9, 1012, 1},
+    {0x24CA, 1013, 1},
+    {0x24CB, 1014, 1},
+    {0x24CC, 1015, 1},
+    {0x24CD, 1016, 1},
+    {0x24CE, 1017, 1},
+    {0x24CF, 1018, 1},
+    {0x2C00, 1019, 1},
+    {0x2C01, 1020, 1},
+    {0x2C02, 1021, 1},
+    {0x2C03, 1022, 1},
+    {0x2C04, 1023, 1},
+    {0x2C05, 1024, 1},
+    {0x2C06, 1025, 1},
+    {0x2C07, 1026, 1},
+    {0x2C08, 1027, 1},
+    {0x2C09, 1028, 1},
+    {0x2C0A, 1029, 1},
+    {0x2C0B, 1030, 1},
+    {0x2C0C, 1031, 1},
+    {0x2C0D, 1032, 1},
+    {0x2C0E, 1033, 1},
+    {0x2C0F, 1034, 1},
+    {0x2C10, 1035, 1},
+    {0x2C11, 1036, 1},
+    {0x2C12, 1037, 1},
+    {0x2C13, 1038, 1},
+    {0x2C14, 1039, 1},
+    {0x2C15, 1040, 1},
+    {0x2C16, 1041, 1},
+    {0x2C17, 1042, 1},
+    {0x2C18, 1043, 1},
+    {0x2C19, 1044, 1},
+    {0x2C1A, 1045, 1},
+    {0x2C1B, 1046, 1},
+    {0x2C1C, 1047, 1},
+    {0x2C1D, 1048, 1},
+    {0x2C1E, 1049, 1},
+    {0x2C1F, 1050, 1},
+    {0x2C20, 1051, 1},
+    {0x2C21, 1052, 1},
+    {0x2C22, 1053, 1},
+    {0x2C23, 1054, 1},
+    {0x2C24, 1055, 1},
+    {0x2C25, 1056, 1},
+    {0x2C26, 1057, 1},
+    {0x2C27, 1058, 1},
+    {0x2C28, 1059, 1},
+    {0x2C29, 1060, 1},
+    {0x2C2A, 1061, 1},
+    {0x2C2B, 1062, 1},
+    {0x2C2C, 1063, 1},
+    {0x2C2D, 1064, 1},
+    {0x2C2E, 1065, 1},
+    {0x2C2F, 1066, 1},
+    {0x2C60, 1067, 1},
+    {0x2C62, 1068, 1},
+    {0x2C63, 1069, 1},
+    {0x2C64, 1070, 1},
+    {0x2C67, 1071, 1},
+    {0x2C69, 1072, 1},
+    {0x2C6B, 1073, 1},
+    {0x2C6D, 1074, 1},
+    {0x2C6E, 1075, 1},
+    {0x2C6F, 1076, 1},
+    {0x2C70, 1077, 1},
+    {0x2C72, 1078, 1},
+    {0x2C75, 1079, 1},
+    {0x2C7E, 1080, 1},
+    {0x2C7F, 1081, 1},
+    {0x2C80, 1082, 1},
+    {0x2C82, 1083, 1},
+    {0x2C84, 1084, 1},
+    {0x2C86, 1085, 1},
+    {0x2C88, 1086, 1},
+    {0x2C8A, 1087, 1},
+    {0x2C8C, 1088, 1},
+    {0x2C8E, 1089, 1},
+    {0x2C90, 1090, 1},
+    {0x2C92, 1091, 1},
+    {0x2C94, 1092, 1},
+    {0x2C96, 1093, 1},
+    {0x2C98, 1094, 1},
+    {0x2C9A, 1095, 1},
+    {0x2C9C, 1096, 1},
+    {0x2C9E, 1097, 1},
+    {0x2CA0, 1098, 1},
+    {0x2CA2, 1099, 1},
+    {0x2CA4, 1100, 1},
+    {0x2CA6, 1101, 1},
+    {0x2CA8, 1102, 1},
+    {0x2CAA, 1103, 1},
+    {0x2CAC, 1104, 1},
+    {0x2CAE, 1105, 1},
+    {0x2CB0, 1106, 1},
+    {0x2CB2, 1107, 1},
+    {0x2CB4, 1108, 1},
+    {0x2CB6, 1109, 1},
+    {0x2CB8, 1110, 1},
+    {0x2CBA, 1111, 1},
+    {0x2CBC, 1112, 1},
+    {0x2CBE, 1113, 1},
+    {0x2CC0, 1114, 1},
+    {0x2CC2, 1115, 1},
+    {0x2CC4, 1116, 1},
+    {0x2CC6, 1117, 1},
+    {0x2CC8, 1118, 1},
+    {0x2CCA, 1119, 1},
+    {0x2CCC, 1120, 1},
+    {0x2CCE, 1121, 1},
+    {0x2CD0, 1122, 1},
+    {0x2CD2, 1123, 1},
+    {0x2CD4, 1124, 1},
+    {0x2CD6, 1125, 1},
+    {0x2CD8, 1126, 1},
+    {0x2CDA, 1127, 1},
+    {0x2CDC, 1128, 1},
+    {0x2CDE, 1129, 1},
+    {0x2CE0, 1130, 1},
+    {0x2CE2, 1131, 1},
+    {0x2CEB, 1132, 1},
+    {0x2CED, 1133, 1},
+    {0x2CF2, 1134, 1},
+    {0xA640, 1135, 1},
+    {0xA642, 1136, 1},
+    {0xA644, 1137, 1},
+    {0xA646, 1138, 1},
+    {0xA648, 1139, 1},
+    {0xA64A, 1140, 1},
+    {0xA64C, 1141, 1},
+    {0xA64E, 1142, 1},
+    {0xA650, 1143, 1},
+    {0xA652, 1144, 1},
+    {0xA654, 1145, 1},
+    {0xA656, 1146, 1},
+    {0xA658, 1147, 1},
+    {0xA65A, 1148, 1},
+    {0xA65C, 1149, 1},
+    {0xA65E, 1150, 1},
+    {0xA660, 1151, 1},
+    {0xA662, 1152, 1},
+    {0xA664, 1153, 1},
+    {0xA666, 1154, 1},
+    {0xA668, 1155, 1},
+    {0xA66A, 1156, 1},
+    {0xA66C, 1157, 1},
+    {0xA680, 1158, 1},
+    {0xA682, 1159, 1},
+    {0xA684, 1160, 1},
+    {0xA686, 1161, 1},
+    {0xA688, 1162, 1},
+    {0xA68A, 1163, 1},
+    {0xA68C, 1164, 1},
+    {0xA68E, 1165, 1},
+    {0xA690, 1166, 1},
+    {0xA692, 1167, 1},
+    {0xA694, 1168, 1},
+    {0xA696, 1169, 1},
+    {0xA698, 1170, 1},
+    {0xA69A, 1171, 1},
+    {0xA722, 1172, 1},
+    {0xA724, 1173, 1},
+    {0xA726, 1174, 1},
+    {0xA728, 1175, 1},
+    {0xA72A, 1176, 1},
+    {0xA72C, 1177, 1},
+    {0xA72E, 1178, 1},
+    {0xA732, 1179, 1},
+    {0xA734, 1180, 1},
+    {0xA736, 1181, 1},
+    {0xA738, 1182, 1},
+    {0xA73A, 1183, 1},
+    {0xA73C, 1184, 1},
+    {0xA73E, 1185, 1},
+    {0xA740, 1186, 1},
+    {0xA742, 1187, 1},
+    {0xA744, 1188, 1},
+    {0xA746, 1189, 1},
+    {0xA748, 1190, 1},
+    {0xA74A, 1191, 1},
+    {0xA74C, 1192, 1},
+    {0xA74E, 1193, 1},
+    {0xA750, 1194, 1},
+    {0xA752, 1195, 1},
+    {0xA754, 1196, 1},
+    {0xA756, 1197, 1},
+    {0xA758, 1198, 1},
+    {0xA75A, 1199, 1},
+    {0xA75C, 1200, 1},
+    {0xA75E, 1201, 1},
+    {0xA760, 1202, 1},
+    {0xA762, 1203, 1},
+    {0xA764, 1204, 1},
+    {0xA766, 1205, 1},
+    {0xA768, 1206, 1},
+    {0xA76A, 1207, 1},
+    {0xA76C, 1208, 1},
+    {0xA76E, 1209, 1},
+    {0xA779, 1210, 1},
+    {0xA77B, 1211, 1},
+    {0xA77D, 1212, 1},
+    {0xA77E, 1213, 1},
+    {0xA780, 1214, 1},
+    {0xA782, 1215, 1},
+    {0xA784, 1216, 1},
+    {0xA786, 1217, 1},
+    {0xA78B, 1218, 1},
+    {0xA78D, 1219, 1},
+    {0xA790, 1220, 1},
+    {0xA792, 1221, 1},
+    {0xA796, 1222, 1},
+    {0xA798, 1223, 1},
+    {0xA79A, 1224, 1},
+    {0xA79C, 1225, 1},
+    {0xA79E, 1226, 1},
+    {0xA7A0, 1227, 1},
+    {0xA7A2, 1228, 1},
+    {0xA7A4, 1229, 1},
+    {0xA7A6, 1230, 1},
+    {0xA7A8, 1231, 1},
+    {0xA7AA, 1232, 1},
+    {0xA7AB, 1233, 1},
+    {0xA7AC, 1234, 1},
+    {0xA7AD, 1235, 1},
+    {0xA7AE, 1236, 1},
+    {0xA7B0, 1237, 1},
+    {0xA7B1, 1238, 1},
+    {0xA7B2, 1239, 1},
+    {0xA7B3, 1240, 1},
+    {0xA7B4, 1241, 1},
+    {0xA7B6, 1242, 1},
+    {0xA7B8, 1243, 1},
+    {0xA7BA, 1244, 1},
+    {0xA7BC, 1245, 1},
+    {0xA7BE, 1246, 1},
+    {0xA7C0, 1247, 1},
+    {0xA7C2, 1248, 1},
+    {0xA7C4, 1249, 1},
+    {0xA7C5, 1250, 1},
+    {0xA7C6, 1251, 1},
+    {0xA7C7, 1252, 1},
+    {0xA7C9, 1253, 1},
+    {0xA7D0, 1254, 1},
+    {0xA7D6, 1255, 1},
+    {0xA7D8, 1256, 1},
+    {0xA7F5, 1257, 1},
+    {0xAB70, 1258, 1},
+    {0xAB71, 1259, 1},
+    {0xAB72, 1260, 1},
+    {0xAB73, 1261, 1},
+    {0xAB74, 1262, 1},
+    {0xAB75, 1263, 1},
+    {0xAB76, 1264, 1},
+    {0xAB77, 1265, 1},
+    {0xAB78, 1266, 1},
+    {0xAB79, 1267, 1},
+    {0xAB7A, 1268, 1},
+    {0xAB7B, 1269, 1},
+    {0xAB7C, 1270, 1},
+    {0xAB7D, 1271, 1},
+    {0xAB7E, 1272, 1},
+    {0xAB7F, 1273, 1},
+    {0xAB80, 1274, 1},
+    {0xAB81, 1275, 1},
+    {0xAB82, 1276, 1},
+    {0xAB83, 1277, 1},
+    {0xAB84, 1278, 1},
+    {0xAB85, 1279, 1},
+    {0xAB86, 1280, 1},
+    {0xAB87, 1281, 1},
+    {0xAB88, 1282, 1},
+    {0xAB89, 1283, 1},
+    {0xAB8A, 1284, 1},
+    {0xAB8B, 1285, 1},
+    {0xAB8C, 1286, 1},
+    {0xAB8D, 1287, 1},
+    {0xAB8E, 1288, 1},
+    {0xAB8F, 1289, 1},
+    {0xAB90, 1290, 1},
+    {0xAB91, 1291, 1},
+    {0xAB92, 1292, 1},
+    {0xAB93, 1293, 1},
+    {0xAB94, 1294, 1},
+    {0xAB95, 1295, 1},
+    {0xAB96, 1296, 1},
+    {0xAB97, 1297, 1},
+    {0xAB98, 1298, 1},
+    {0xAB99, 1299, 1},
+    {0xAB9A, 1300, 1},
+    {0xAB9B, 1301, 1},
+    {0xAB9C, 1302, 1},
+    {0xAB9D, 1303, 1},
+    {0xAB9E, 1304, 1},
+    {0xAB9F, 1305, 1},
+    {0xABA0, 1306, 1},
+    {0xABA1, 1307, 1},
+    {0xABA2, 1308, 1},
+    {0xABA3, 1309, 1},
+    {0xABA4, 1310, 1},
+    {0xABA5, 1311, 1},
+    {0xABA6, 1312, 1},
+    {0xABA7, 1313, 1},
+    {0xABA8, 1314, 1},
+    {0xABA9, 1315, 1},
+    {0xABAA, 1316, 1},
+    {0xABAB, 1317, 1},
+    {0xABAC, 1318, 1},
+    {0xABAD, 1319, 1},
+    {0xABAE, 1320, 1},
+    {0xABAF, 1321, 1},
+    {0xABB0, 1322, 1},
+    {0xABB1, 1323, 1},
+    {0xABB2, 1324, 1},
+    {0xABB3, 1325, 1},
+    {0xABB4, 1326, 1},
+    {0xABB5, 1327, 1},
+    {0xABB6, 1328, 1},
+    {0xABB7, 1329, 1},
+    {0xABB8, 1330, 1},
+    {0xABB9, 1331, 1},
+    {0xABBA, 1332, 1},
+    {0xABBB, 1333, 1},
+    {0xABBC, 1334, 1},
+    {0xABBD, 1335, 1},
+    {0xABBE, 1336, 1},
+    {0xABBF, 1337, 1},
+    {0xFB00, 1338, 2},
+    {0xFB01, 1340, 2},
+    {0xFB02, 1342, 2},
+    {0xFB03, 1344, 3},
+    {0xFB04, 1347, 3},
+    {0xFB05, 1350, 2},
+    {0xFB06, 1352, 2},
+    {0xFB13, 1354, 2},
+    {0xFB14, 1356, 2},
+    {0xFB15, 1358, 2},
+    {0xFB16, 1360, 2},
+    {0xFB17, 1362, 2},
+    {0xFF21, 1364, 1},
+    {0xFF22, 1365, 1},
+    {0xFF23, 1366, 1},
+    {0xFF24, 1367, 1},
+    {0xFF25, 1368, 1},
+    {0xFF26, 1369, 1},
+    {0xFF27, 1370, 1},
+    {0xFF28, 1371, 1},
+    {0xFF29, 1372, 1},
+    {0xFF2A, 1373, 1},
+    {0xFF2B, 1374, 1},
+    {0xFF2C, 1375, 1},
+    {0xFF2D, 1376, 1},
+    {0xFF2E, 1377, 1},
+    {0xFF2F, 1378, 1},
+    {0xFF30, 1379, 1},
+    {0xFF31, 1380, 1},
+    {0xFF32, 1381, 1},
+    {0xFF33, 1382, 1},
+    {0xFF34, 1383, 1},
+    {0xFF35, 1384, 1},
+    {0xFF36, 1385, 1},
+    {0xFF37, 1386, 1},
+    {0xFF38, 1387, 1},
+    {0xFF39, 1388, 1},
+    {0xFF3A, 1389, 1},
+    {0x10400, 1390, 1},
+    {0x10401, 1391, 1},
+    {0x10402, 1392, 1},
+    {0x10403, 1393, 1},
+    {0x10404, 1394, 1},
+    {0x10405, 1395, 1},
+    {0x10406, 1396, 1},
+    {0x10407, 1397, 1},
+    {0x10408, 1398, 1},
+    {0x10409, 1399, 1},
+    {0x1040A, 1400, 1},
+    {0x1040B, 1401, 1},
+    {0x1040C, 1402, 1},
+    {0x1040D, 1403, 1},
+    {0x1040E, 1404, 1},
+    {0x1040F, 1405, 1},
+    {0x10410, 1406, 1},
+    {0x10411, 1407, 1},
+    {0x10412, 1408, 1},
+    {0x10413, 1409, 1},
+    {0x10414, 1410, 1},
+    {0x10415, 1411, 1},
+    {0x10416, 1412, 1},
+    {0x10417, 1413, 1},
+    {0x10418, 1414, 1},
+    {0x10419, 1415, 1},
+    {0x1041A, 1416, 1},
+    {0x1041B, 1417, 1},
+    {0x1041C, 1418, 1},
+    {0x1041D, 1419, 1},
+    {0x1041E, 1420, 1},
+    {0x1041F, 1421, 1},
+    {0x10420, 1422, 1},
+    {0x10421, 1423, 1},
+    {0x10422, 1424, 1},
+    {0x10423, 1425, 1},
+    {0x10424, 1426, 1},
+    {0x10425, 1427, 1},
+    {0x10426, 1428, 1},
+    {0x10427, 1429, 1},
+    {0x104B0, 1430, 1},
+    {0x104B1, 1431, 1},
+    {0x104B2, 1432, 1},
+    {0x104B3, 1433, 1},
+    {0x104B4, 1434, 1},
+    {0x104B5, 1435, 1},
+    {0x104B6, 1436, 1},
+    {0x104B7, 1437, 1},
+    {0x104B8, 1438, 1},
+    {0x104B9, 1439, 1},
+    {0x104BA, 1440, 1},
+    {0x104BB, 1441, 1},
+    {0x104BC, 1442, 1},
+    {0x104BD, 1443, 1},
+    {0x104BE, 1444, 1},
+    {0x104BF, 1445, 1},
+    {0x104C0, 1446, 1},
+    {0x104C1, 1447, 1},
+    {0x104C2, 1448, 1},
+    {0x104C3, 1449, 1},
+    {0x104C4, 1450, 1},
+    {0x104C5, 1451, 1},
+    {0x104C6, 1452, 1},
+    {0x104C7, 1453, 1},
+    {0x104C8, 1454, 1},
+    {0x104C9, 1455, 1},
+    {0x104CA, 1456, 1},
+    {0x104CB, 1457, 1},
+    {0x104CC, 1458, 1},
+    {0x104CD, 1459, 1},
+    {0x104CE, 1460, 1},
+    {0x104CF, 1461, 1},
+    {0x104D0, 1462, 1},
+    {0x104D1, 1463, 1},
+    {0x104D2, 1464, 1},
+    {0x104D3, 1465, 1},
+    {0x10570, 1466, 1},
+    {0x10571, 1467, 1},
+    {0x10572, 1468, 1},
+    {0x10573, 1469, 1},
+    {0x10574, 1470, 1},
+    {0x10575, 1471, 1},
+    {0x10576, 1472, 1},
+    {0x10577, 1473, 1},
+    {0x10578, 1474, 1},
+    {0x10579, 1475, 1},
+    {0x1057A, 1476, 1},
+    {0x1057C, 1477, 1},
+    {0x1057D, 1478, 1},
+    {0x1057E, 1479, 1},
+    {0x1057F, 1480, 1},
+    {0x10580, 1481, 1},
+    {0x10581, 1482, 1},
+    {0x10582, 1483, 1},
+    {0x10583, 1484, 1},
+    {0x10584, 1485, 1},
+    {0x10585, 1486, 1},
+    {0x10586, 1487, 1},
+    {0x10587, 1488, 1},
+    {0x10588, 1489, 1},
+    {0x10589, 1490, 1},
+    {0x1058A, 1491, 1},
+    {0x1058C, 1492, 1},
+    {0x1058D, 1493, 1},
+    {0x1058E, 1494, 1},
+    {0x1058F, 1495, 1},
+    {0x10590, 1496, 1},
+    {0x10591, 1497, 1},
+    {0x10592, 1498, 1},
+    {0x10594, 1499, 1},
+    {0x10595, 1500, 1},
+    {0x10C80, 1501, 1},
+    {0x10C81, 1502, 1},
+    {0x10C82, 1503, 1},
+    {0x10C83, 1504, 1},
+    {0x10C84, 1505, 1},
+    {0x10C85, 1506, 1},
+    {0x10C86, 1507, 1},
+    {0x10C87, 1508, 1},
+    {0x10C88, 1509, 1},
+    {0x10C89, 1510, 1},
+    {0x10C8A, 1511, 1},
+    {0x10C8B, 1512, 1},
+    {0x10C8C, 1513, 1},
+    {0x10C8D, 1514, 1},
+    {0x10C8E, 1515, 1},
+    {0x10C8F, 1516, 1},
+    {0x10C90, 1517, 1},
+    {0x10C91, 1518, 1},
+    {0x10C92, 1519, 1},
+    {0x10C93, 1520, 1},
+    {0x10C94, 1521, 1},
+    {0x10C95, 1522, 1},
+    {0x10C96, 1523, 1},
+    {0x10C97, 1524, 1},
+    {0x10C98, 1525, 1},
+    {0x10C99, 1526, 1},
+    {0x10C9A, 1527, 1},
+    {0x10C9B, 1528, 1},
+    {0x10C9C, 1529, 1},
+    {0x10C9D, 1530, 1},
+    {0x10C9E, 1531, 1},
+    {0x10C9F, 1532, 1},
+    {0x10CA0, 1533, 1},
+    {0x10CA1, 1534, 1},
+    {0x10CA2, 1535, 1},
+    {0x10CA3, 1536, 1},
+    {0x10CA4, 1537, 1},
+    {0x10CA5, 1538, 1},
+    {0x10CA6, 1539, 1},
+    {0x10CA7, 1540, 1},
+    {0x10CA8, 1541, 1},
+    {0x10CA9, 1542, 1},
+    {0x10CAA, 1543, 1},
+    {0x10CAB, 1544, 1},
+    {0x10CAC, 1545, 1},
+    {0x10CAD, 1546, 1},
+    {0x10CAE, 1547, 1},
+    {0x10CAF, 1548, 1},
+    {0x10CB0, 1549, 1},
+    {0x10CB1, 1550, 1},
+    {0x10CB2, 1551, 1},
+    {0x118A0, 1552, 1},
+    {0x118A1, 1553, 1},
+    {0x118A2, 1554, 1},
+    {0x118A3, 1555, 1},
+    {0x118A4, 1556, 1},
+    {0x118A5, 1557, 1},
+    {0x118A6, 1558, 1},
+    {0x118A7, 1559, 1},
+    {0x118A8, 1560, 1},
+    {0x118A9, 1561, 1},
+    {0x118AA, 1562, 1},
+    {0x118AB, 1563, 1},
+    {0x118AC, 1564, 1},
+    {0x118AD, 1565, 1},
+    {0x118AE, 1566, 1},
+    {0x118AF, 1567, 1},
+    {0x118B0, 1568, 1},
+    {0x118B1, 1569, 1},
+    {0x118B2, 1570, 1},
+    {0x118B3, 1571, 1},
+    {0x118B4, 1572, 1},
+    {0x118B5, 1573, 1},
+    {0x118B6, 1574, 1},
+    {0x118B7, 1575, 1},
+    {0x118B8, 1576, 1},
+    {0x118B9, 1577, 1},
+    {0x118BA, 1578, 1},
+    {0x118BB, 1579, 1},
+    {0x118BC, 1580, 1},
+    {0x118BD, 1581, 1},
+    {0x118BE, 1582, 1},
+    {0x118BF, 1583, 1},
+    {0x16E40, 1584, 1},
+    {0x16E41, 1585, 1},
+    {0x16E42, 1586, 1},
+    {0x16E43, 1587, 1},
+    {0x16E44, 1588, 1},
+    {0x16E45, 1589, 1},
+    {0x16E46, 1590, 1},
+    {0x16E47, 1591, 1},
+    {0x16E48, 1592, 1},
+    {0x16E49, 1593, 1},
+    {0x16E4A, 1594, 1},
+    {0x16E4B, 1595, 1},
+    {0x16E4C, 1596, 1},
+    {0x16E4D, 1597, 1},
+    {0x16E4E, 1598, 1},
+    {0x16E4F, 1599, 1},
+    {0x16E50, 1600, 1},
+    {0x16E51, 1601, 1},
+    {0x16E52, 1602, 1},
+    {0x16E53, 1603, 1},
+    {0x16E54, 1604, 1},
+    {0x16E55, 1605, 1},
+    {0x16E56, 1606, 1},
+    {0x16E57, 1607, 1},
+    {0x16E58, 1608, 1},
+    {0x16E59, 1609, 1},
+    {0x16E5A, 1610, 1},
+    {0x16E5B, 1611, 1},
+    {0x16E5C, 1612, 1},
+    {0x16E5D, 1613, 1},
+    {0x16E5E, 1614, 1},
+    {0x16E5F, 1615, 1},
+    {0x1E900, 1616, 1},
+    {0x1E901, 1617, 1},
+    {0x1E902, 1618, 1},
+    {0x1E903, 1619, 1},
+    {0x1E904, 1620, 1},
+    {0x1E905, 1621, 1},
+    {0x1E906, 1622, 1},
+    {0x1E907, 1623, 1},
+    {0x1E908, 1624, 1},
+    {0x1E909, 1625, 1},
+    {0x1E90A, 1626, 1},
+    {0x1E90B, 1627, 1},
+    {0x1E90C, 1628, 1},
+    {0x1E90D, 1629, 1},
+    {0x1E90E, 1630, 1},
+    {0x1E90F, 1631, 1},
+    {0x1E910, 1632, 1},
+    {0x1E911, 1633, 1},
+    {0x1E912, 1634, 1},
+    {0x1E913, 1635, 1},
+    {0x1E914, 1636, 1},
+    {0x1E915, 1637, 1},
+    {0x1E916, 1638, 1},
+    {0x1E917, 1639, 1},
+    {0x1E918, 1640, 1},
+    {0x1E919, 1641, 1},
+    {0x1E91A, 1642, 1},
+    {0x1E91B, 1643, 1},
+    {0x1E91C, 1644, 1},
+    {0x1E91D, 1645, 1},
+    {0x1E91E, 1646, 1},
+    {0x1E91F, 1647, 1},
+    {0x1E920, 1648, 1},
+    {0x1E921, 1649, 1},
+}};
+
+constexpr std::array<char32_t, 1650> kCaseFoldData = {{
+    0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067, 0x0068, 0x0069, 0x006A, 0x006B, 0x006C,
+    0x006D, 0x006E, 0x006F, 0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077, 0x0078,
+    0x0079, 0x007A, 0x03BC, 0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7, 0x00E8,
+    0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF, 0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4,
+    0x00F5, 0x00F6, 0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x0073, 0x0073, 0x0101,
+    0x0103, 0x0105, 0x0107, 0x0109, 0x010B, 0x010D, 0x010F, 0x0111, 0x0113, 0x0115, 0x0117, 0x0119,
+    0x011B, 0x011D, 0x011F, 0x0121, 0x0123, 0x0125, 0x0127, 0x0129, 0x012B, 0x012D, 0x012F, 0x0069,
+    0x0307, 0x0133, 0x0135, 0x0137, 0x013A, 0x013C, 0x013E, 0x0140, 0x0142, 0x0144, 0x0146, 0x0148,
+    0x02BC, 0x006E, 0x014B, 0x014D, 0x014F, 0x0151, 0x0153, 0x0155, 0x0157, 0x0159, 0x015B, 0x015D,
+    0x015F, 0x0161, 0x0163, 0x0165, 0x0167, 0x0169, 0x016B, 0x016D, 0x016F, 0x0171, 0x0173, 0x0175,
+    0x0177, 0x00FF, 0x017A, 0x017C, 0x017E, 0x0073, 0x0253, 0x0183, 0x0185, 0x0254, 0x0188, 0x0256,
+    0x0257, 0x018C, 0x01DD, 0x0259, 0x025B, 0x0192, 0x0260, 0x0263, 0x0269, 0x0268, 0x0199, 0x026F,
+    0x0272, 0x0275, 0x01A1, 0x01A3, 0x01A5, 0x0280, 0x01A8, 0x0283, 0x01AD, 0x0288, 0x01B0, 0x028A,
+    0x028B, 0x01B4, 0x01B6, 0x0292, 0x01B9, 0x01BD, 0x01C6, 0x01C6, 0x01C9, 0x01C9, 0x01CC, 0x01CC,
+    0x01CE, 0x01D0, 0x01D2, 0x01D4, 0x01D6, 0x01D8, 0x01DA, 0x01DC, 0x01DF, 0x01E1, 0x01E3, 0x01E5,
+    0x01E7, 0x01E9, 0x01EB, 0x01ED, 0x01EF, 0x006A, 0x030C, 0x01F3, 0x01F3, 0x01F5, 0x0195, 0x01BF,
+    0x01F9, 0x01FB, 0x01FD, 0x01FF, 0x0201, 0x0203, 0x0205, 0x0207, 0x0209, 0x020B, 0x020D, 0x020F,
+    0x0211, 0x0213, 0x0215, 0x0217, 0x0219, 0x021B, 0x021D, 0x021F, 0x019E, 0x0223, 0x0225, 0x0227,
+    0x0229, 0x022B, 0x022D, 0x022F, 0x0231, 0x0233, 0x2C65, 0x023C, 0x019A, 0x2C66, 0x0242, 0x0180,
+    0x0289, 0x028C, 0x0247, 0x0249, 0x024B, 0x024D, 0x024F, 0x03B9, 0x0371, 0x0373, 0x0377, 0x03F3,
+    0x03AC, 0x03AD, 0x03AE, 0x03AF, 0x03CC, 0x03CD, 0x03CE, 0x03B9, 0x0308, 0x0301, 0x03B1, 0x03B2,
+    0x03B3, 0x03B4, 0x03B5, 0x03B6, 0x03B7, 0x03B8, 0x03B9, 0x03BA, 0x03BB, 0x03BC, 0x03BD, 0x03BE,
+    0x03BF, 0x03C0, 0x03C1, 0x03C3, 0x03C4, 0x03C5, 0x03C6, 0x03C7, 0x03C8, 0x03C9, 0x03CA, 0x03CB,
+    0x03C5, 0x0308, 0x0301, 0x03C3, 0x03D7, 0x03B2, 0x03B8, 0x03C6, 0x03C0, 0x03D9, 0x03DB, 0x03DD,
+    0x03DF, 0x03E1, 0x03E3, 0x03E5, 0x03E7, 0x03E9, 0x03EB, 0x03ED, 0x03EF, 0x03BA, 0x03C1, 0x03B8,
+    0x03B5, 0x03F8, 0x03F2, 0x03FB, 0x037B, 0x037C, 0x037D, 0x0450, 0x0451, 0x0452, 0x0453, 0x0454,
+    0x0455, 0x0456, 0x0457, 0x0458, 0x0459, 0x045A, 0x045B, 0x045C, 0x045D, 0x045E, 0x045F, 0x0430,
+    0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437, 0x0438, 0x0439, 0x043A, 0x043B, 0x043C,
+    0x043D, 0x043E, 0x043F, 0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447, 0x0448,
+    0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F, 0x0461, 0x0463, 0x0465, 0x0467, 0x0469,
+    0x046B, 0x046D, 0x046F, 0x0471, 0x0473, 0x0475, 0x0477, 0x0479, 0x047B, 0x047D, 0x047F, 0x0481,
+    0x048B, 0x048D, 0x048F, 0x0491, 0x0493, 0x0495, 0x0497, 0x0499, 0x049B, 0x049D, 0x049F, 0x04A1,
+    0x04A3, 0x04A5, 0x04A7, 0x04A9, 0x04AB, 0x04AD, 0x04AF, 0x04B1, 0x04B3, 0x04B5, 0x04B7, 0x04B9,
+    0x04BB, 0x04BD, 0x04BF, 0x04CF, 0x04C2, 0x04C4, 0x04C6, 0x04C8, 0x04CA, 0x04CC, 0x04CE, 0x04D1,
+    0x04D3, 0x04D5, 0x04D7, 0x04D9, 0x04DB, 0x04DD, 0x04DF, 0x04E1, 0x04E3, 0x04E5, 0x04E7, 0x04E9,
+    0x04EB, 0x04ED, 0x04EF, 0x04F1, 0x04F3, 0x04F5, 0x04F7, 0x04F9, 0x04FB, 0x04FD, 0x04FF, 0x0501,
+    0x0503, 0x0505, 0x0507, 0x0509, 0x050B, 0x050D, 0x050F, 0x0511, 0x0513, 0x0515, 0x0517, 0x0519,
+    0x051B, 0x051D, 0x051F, 0x0521, 0x0523, 0x0525, 0x0527, 0x0529, 0x052B, 0x052D, 0x052F, 0x0561,
+    0x0562, 0x0563, 0x0564, 0x0565, 0x0566, 0x0567, 0x0568, 0x0569, 0x056A, 0x056B, 0x056C, 0x056D,
+    0x056E, 0x056F, 0x0570, 0x0571, 0x0572, 0x0573, 0x0574, 0x0575, 0x0576, 0x0577, 0x0578, 0x0579,
+    0x057A, 0x057B, 0x057C, 0x057D, 0x057E, 0x057F, 0x0580, 0x0581, 0x0582, 0x0583, 0x0584, 0x0585,
+    0x0586, 0x0565, 0x0582, 0x2D00, 0x2D01, 0x2D02, 0x2D03, 0x2D04, 0x2D05, 0x2D06, 0x2D07, 0x2D08,
+    0x2D09, 0x2D0A, 0x2D0B, 0x2D0C, 0x2D0D, 0x2D0E, 0x2D0F, 0x2D10, 0x2D11, 0x2D12, 0x2D13, 0x2D14,
+    0x2D15, 0x2D16, 0x2D17, 0x2D18, 0x2D19, 0x2D1A, 0x2D1B, 0x2D1C, 0x2D1D, 0x2D1E, 0x2D1F, 0x2D20,
+    0x2D21, 0x2D22, 0x2D23, 0x2D24, 0x2D25, 0x2D27, 0x2D2D, 0x13F0, 0x13F1, 0x13F2, 0x13F3, 0x13F4,
+    0x13F5, 0x0432, 0x0434, 0x043E, 0x0441, 0x0442, 0x0442, 0x044A, 0x0463, 0xA64B, 0x10D0, 0x10D1,
+    0x10D2, 0x10D3, 0x10D4, 0x10D5, 0x10D6, 0x10D7, 0x10D8, 0x10D9, 0x10DA, 0x10DB, 0x10DC, 0x10DD,
+    0x10DE, 0x10DF, 0x10E0, 0x10E1, 0x10E2, 0x10E3, 0x10E4, 0x10E5, 0x10E6, 0x10E7, 0x10E8, 0x10E9,
+    0x10EA, 0x10EB, 0x10EC, 0x10ED, 0x10EE, 0x10EF, 0x10F0, 0x10F1, 0x10F2, 0x10F3, 0x10F4, 0x10F5,
+    0x10F6, 0x10F7, 0x10F8, 0x10F9, 0x10FA, 0x10FD, 0x10FE, 0x10FF, 0x1E01, 0x1E03, 0x1E05, 0x1E07,
+    0x1E09, 0x1E0B, 0x1E0D, 0x1E0F, 0x1E11, 0x1E13, 0x1E15, 0x1E17, 0x1E19, 0x1E1B, 0x1E1D, 0x1E1F,
+    0x1E21, 0x1E23, 0x1E25, 0x1E27, 0x1E29, 0x1E2B, 0x1E2D, 0x1E2F, 0x1E31, 0x1E33, 0x1E35, 0x1E37,
+    0x1E39, 0x1E3B, 0x1E3D, 0x1E3F, 0x1E41, 0x1E43, 0x1E45, 0x1E47, 0x1E49, 0x1E4B, 0x1E4D, 0x1E4F,
+    0x1E51, 0x1E53, 0x1E55, 0x1E57, 0x1E59, 0x1E5B, 0x1E5D, 0x1E5F, 0x1E61, 0x1E63, 0x1E65, 0x1E67,
+    0x1E69, 0x1E6B, 0x1E6D, 0x1E6F, 0x1E71, 0x1E73, 0x1E75, 0x1E77, 0x1E79, 0x1E7B, 0x1E7D, 0x1E7F,
+    0x1E81, 0x1E83, 0x1E85, 0x1E87, 0x1E89, 0x1E8B, 0x1E8D, 0x1E8F, 0x1E91, 0x1E93, 0x1E95, 0x0068,
+    0x0331, 0x0074, 0x0308, 0x0077, 0x030A, 0x0079, 0x030A, 0x0061, 0x02BE, 0x1E61, 0x0073, 0x0073,
+    0x1EA1, 0x1EA3, 0x1EA5, 0x1EA7, 0x1EA9, 0x1EAB, 0x1EAD, 0x1EAF, 0x1EB1, 0x1EB3, 0x1EB5, 0x1EB7,
+    0x1EB9, 0x1EBB, 0x1EBD, 0x1EBF, 0x1EC1, 0x1EC3, 0x1EC5, 0x1EC7, 0x1EC9, 0x1ECB, 0x1ECD, 0x1ECF,
+    0x1ED1, 0x1ED3, 0x1ED5, 0x1ED7, 0x1ED9, 0x1EDB, 0x1EDD, 0x1EDF, 0x1EE1, 0x1EE3, 0x1EE5, 0x1EE7,
+    0x1EE9, 0x1EEB, 0x1EED, 0x1EEF, 0x1EF1, 0x1EF3, 0x1EF5, 0x1EF7, 0x1EF9, 0x1EFB, 0x1EFD, 0x1EFF,
+    0x1F00, 0x1F01, 0x1F02, 0x1F03, 0x1F04, 0x1F05, 0x1F06, 0x1F07, 0x1F10, 0x1F11, 0x1F12, 0x1F13,
+    0x1F14, 0x1F15, 0x1F20, 0x1F21, 0x1F22, 0x1F23, 0x1F24, 0x1F25, 0x1F26, 0x1F27, 0x1F30, 0x1F31,
+    0x1F32, 0x1F33, 0x1F34, 0x1F35, 0x1F36, 0x1F37, 0x1F40, 0x1F41, 0x1F42, 0x1F43, 0x1F44, 0x1F45,
+    0x03C5, 0x0313, 0x03C5, 0x0313, 0x0300, 0x03C5, 0x0313, 0x0301, 0x03C5, 0x0313, 0x0342, 0x1F51,
+    0x1F53, 0x1F55, 0x1F57, 0x1F60, 0x1F61, 0x1F62, 0x1F63, 0x1F64, 0x1F65, 0x1F66, 0x1F67, 0x1F00,
+    0x03B9, 0x1F01, 0x03B9, 0x1F02, 0x03B9, 0x1F03, 0x03B9, 0x1F04, 0x03B9, 0x1F05, 0x03B9, 0x1F06,
+    0x03B9, 0x1F07, 0x03B9, 0x1F00, 0x03B9, 0x1F01, 0x03B9, 0x1F02, 0x03B9, 0x1F03, 0x03B9, 0x1F04,
+    0x03B9, 0x1F05, 0x03B9, 0x1F06, 0x03B9, 0x1F07, 0x03B9, 0x1F20, 0x03B9, 0x1F21, 0x03B9, 0x1F22,
+    0x03B9, 0x1F23, 0x03B9, 0x1F24, 0x03B9, 0x1F25, 0x03B9, 0x1F26, 0x03B9, 0x1F27, 0x03B9, 0x1F20,
+    0x03B9, 0x1F21, 0x03B9, 0x1F22, 0x03B9, 0x1F23, 0x03B9, 0x1F24, 0x03B9, 0x1F25, 0x03B9, 0x1F26,
+    0x03B9, 0x1F27, 0x03B9, 0x1F60, 0x03B9, 0x1F61, 0x03B9, 0x1F62, 0x03B9, 0x1F63, 0x03B9, 0x1F64,
+    0x03B9, 0x1F65, 0x03B9, 0x1F66, 0x03B9, 0x1F67, 0x03B9, 0x1F60, 0x03B9, 0x1F61, 0x03B9, 0x1F62,
+    0x03B9, 0x1F63, 0x03B9, 0x1F64, 0x03B9, 0x1F65, 0x03B9, 0x1F66, 0x03B9, 0x1F67, 0x03B9, 0x1F70,
+    0x03B9, 0x03B1, 0x03B9, 0x03AC, 0x03B9, 0x03B1, 0x0342, 0x03B1, 0x0342, 0x03B9, 0x1FB0, 0x1FB1,
+    0x1F70, 0x1F71, 0x03B1, 0x03B9, 0x03B9, 0x1F74, 0x03B9, 0x03B7, 0x03B9, 0x03AE, 0x03B9, 0x03B7,
+    0x0342, 0x03B7, 0x0342, 0x03B9, 0x1F72, 0x1F73, 0x1F74, 0x1F75, 0x03B7, 0x03B9, 0x03B9, 0x0308,
+    0x0300, 0x03B9, 0x0308, 0x0301, 0x03B9, 0x0342, 0x03B9, 0x0308, 0x0342, 0x1FD0, 0x1FD1, 0x1F76,
+    0x1F77, 0x03C5, 0x0308, 0x0300, 0x03C5, 0x0308, 0x0301, 0x03C1, 0x0313, 0x03C5, 0x0342, 0x03C5,
+    0x0308, 0x0342, 0x1FE0, 0x1FE1, 0x1F7A, 0x1F7B, 0x1FE5, 0x1F7C, 0x03B9, 0x03C9, 0x03B9, 0x03CE,
+    0x03B9, 0x03C9, 0x0342, 0x03C9, 0x0342, 0x03B9, 0x1F78, 0x1F79, 0x1F7C, 0x1F7D, 0x03C9, 0x03B9,
+    0x03C9, 0x006B, 0x00E5, 0x214E, 0x2170, 0x2171, 0x2172, 0x2173, 0x2174, 0x2175, 0x2176, 0x2177,
+    0x2178, 0x2179, 0x217A, 0x217B, 0x217C, 0x217D, 0x217E, 0x217F, 0x2184, 0x24D0, 0x24D1, 0x24D2,
+    0x24D3, 0x24D4, 0x24D5, 0x24D6, 0x24D7, 0x24D8, 0x24D9, 0x24DA, 0x24DB, 0x24DC, 0x24DD, 0x24DE,
+    0x24DF, 0x24E0, 0x24E1, 0x24E2, 0x24E3, 0x24E4, 0x24E5, 0x24E6, 0x24E7, 0x24E8, 0x24E9, 0x2C30,
+    0x2C31, 0x2C32, 0x2C33, 0x2C34, 0x2C35, 0x2C36, 0x2C37, 0x2C38, 0x2C39, 0x2C3A, 0x2C3B, 0x2C3C,
+    0x2C3D, 0x2C3E, 0x2C3F, 0x2C40, 0x2C41, 0x2C42, 0x2C43, 0x2C44, 0x2C45, 0x2C46, 0x2C47, 0x2C48,
+    0x2C49, 0x2C4A, 0x2C4B, 0x2C4C, 0x2C4D, 0x2C4E, 0x2C4F, 0x2C50, 0x2C51, 0x2C52, 0x2C53, 0x2C54,
+    0x2C55, 0x2C56, 0x2C57, 0x2C58, 0x2C59, 0x2C5A, 0x2C5B, 0x2C5C, 0x2C5D, 0x2C5E, 0x2C5F, 0x2C61,
+    0x026B, 0x1D7D, 0x027D, 0x2C68, 0x2C6A, 0x2C6C, 0x0251, 0x0271, 0x0250, 0x0252, 0x2C73, 0x2C76,
+    0x023F, 0x0240, 0x2C81, 0x2C83, 0x2C85, 0x2C87, 0x2C89, 0x2C8B, 0x2C8D, 0x2C8F, 0x2C91, 0x2C93,
+    0x2C95, 0x2C97, 0x2C99, 0x2C9B, 0x2C9D, 0x2C9F, 0x2CA1, 0x2CA3, 0x2CA5, 0x2CA7, 0x2CA9, 0x2CAB,
+    0x2CAD, 0x2CAF, 0x2CB1, 0x2CB3, 0x2CB5, 0x2CB7, 0x2CB9, 0x2CBB, 0x2CBD, 0x2CBF, 0x2CC1, 0x2CC3,
+    0x2CC5, 0x2CC7, 0x2CC9, 0x2CCB, 0x2CCD, 0x2CCF, 0x2CD1, 0x2CD3, 0x2CD5, 0x2CD7, 0x2CD9, 0x2CDB,
+    0x2CDD, 0x2CDF, 0x2CE1, 0x2CE3, 0x2CEC, 0x2CEE, 0x2CF3, 0xA641, 0xA643, 0xA645, 0xA647, 0xA649,
+    0xA64B, 0xA64D, 0xA64F, 0xA651, 0xA653, 0xA655, 0xA657, 0xA659, 0xA65B, 0xA65D, 0xA65F, 0xA661,
+    0xA663, 0xA665, 0xA667, 0xA669, 0xA66B, 0xA66D, 0xA681, 0xA683, 0xA685, 0xA687, 0xA689, 0xA68B,
+    0xA68D, 0xA68F, 0xA691, 0xA693, 0xA695, 0xA697, 0xA699, 0xA69B, 0xA723, 0xA725, 0xA727, 0xA729,
+    0xA72B, 0xA72D, 0xA72F, 0xA733, 0xA735, 0xA737, 0xA739, 0xA73B, 0xA73D, 0xA73F, 0xA741, 0xA743,
+    0xA745, 0xA747, 0xA749, 0xA74B, 0xA74D, 0xA74F, 0xA751, 0xA753, 0xA755, 0xA757, 0xA759, 0xA75B,
+    0xA75D, 0xA75F, 0xA761, 0xA763, 0xA765, 0xA767, 0xA769, 0xA76B, 0xA76D, 0xA76F, 0xA77A, 0xA77C,
+    0x1D79, 0xA77F, 0xA781, 0xA783, 0xA785, 0xA787, 0xA78C, 0x0265, 0xA791, 0xA793, 0xA797, 0xA799,
+    0xA79B, 0xA79D, 0xA79F, 0xA7A1, 0xA7A3, 0xA7A5, 0xA7A7, 0xA7A9, 0x0266, 0x025C, 0x0261, 0x026C,
+    0x026A, 0x029E, 0x0287, 0x029D, 0xAB53, 0xA7B5, 0xA7B7, 0xA7B9, 0xA7BB, 0xA7BD, 0xA7BF, 0xA7C1,
+    0xA7C3, 0xA794, 0x0282, 0x1D8E, 0xA7C8, 0xA7CA, 0xA7D1, 0xA7D7, 0xA7D9, 0xA7F6, 0x13A0, 0x13A1,
+    0x13A2, 0x13A3, 0x13A4, 0x13A5, 0x13A6, 0x13A7, 0x13A8, 0x13A9, 0x13AA, 0x13AB, 0x13AC, 0x13AD,
+    0x13AE, 0x13AF, 0x13B0, 0x13B1, 0x13B2, 0x13B3, 0x13B4, 0x13B5, 0x13B6, 0x13B7, 0x13B8, 0x13B9,
+    0x13BA, 0x13BB, 0x13BC, 0x13BD, 0x13BE, 0x13BF, 0x13C0, 0x13C1, 0x13C2, 0x13C3, 0x13C4, 0x13C5,
+    0x13C6, 0x13C7, 0x13C8, 0x13C9, 0x13CA, 0x13CB, 0x13CC, 0x13CD, 0x13CE, 0x13CF, 0x13D0, 0x13D1,
+    0x13D2, 0x13D3, 0x13D4, 0x13D5, 0x13D6, 0x13D7, 0x13D8, 0x13D9, 0x13DA, 0x13DB, 0x13DC, 0x13DD,
+    0x13DE, 0x13DF, 0x13E0, 0x13E1, 0x13E2, 0x13E3, 0x13E4, 0x13E5, 0x13E6, 0x13E7, 0x13E8, 0x13E9,
+    0x13EA, 0x13EB, 0x13EC, 0x13ED, 0x13EE, 0x13EF, 0x0066, 0x0066, 0x0066, 0x0069, 0x0066, 0x006C,
+    0x0066, 0x0066, 0x0069, 0x0066, 0x0066, 0x006C, 0x0073, 0x0074, 0x0073, 0x0074, 0x0574, 0x0576,
+    0x0574, 0x0565, 0x0574, 0x056B, 0x057E, 0x0576, 0x0574, 0x056D, 0xFF41, 0xFF42, 0xFF43, 0xFF44,
+    0xFF45, 0xFF46, 0xFF47, 0xFF48, 0xFF49, 0xFF4A, 0xFF4B, 0xFF4C, 0xFF4D, 0xFF4E, 0xFF4F, 0xFF50,
+    0xFF51, 0xFF52, 0xFF53, 0xFF54, 0xFF55, 0xFF56, 0xFF57, 0xFF58, 0xFF59, 0xFF5A, 0x10428, 0x10429,
+    0x1042A, 0x1042B, 0x1042C, 0x1042D, 0x1042E, 0x1042F, 0x10430, 0x10431, 0x10432, 0x10433, 0x10434, 0x10435,
+    0x10436, 0x10437, 0x10438, 0x10439, 0x1043A, 0x1043B, 0x1043C, 0x1043D, 0x1043E, 0x1043F, 0x10440, 0x10441,
+    0x10442, 0x10443, 0x10444, 0x10445, 0x10446, 0x10447, 0x10448, 0x10449, 0x1044A, 0x1044B, 0x1044C, 0x1044D,
+    0x1044E, 0x1044F, 0x104D8, 0x104D9, 0x104DA, 0x104DB, 0x104DC, 0x104DD, 0x104DE, 0x104DF, 0x104E0, 0x104E1,
+    0x104E2, 0x104E3, 0x104E4, 0x104E5, 0x104E6, 0x104E7, 0x104E8, 0x104E9, 0x104EA, 0x104EB, 0x104EC, 0x104ED,
+    0x104EE, 0x104EF, 0x104F0, 0x104F1, 0x104F2, 0x104F3, 0x104F4, 0x104F5, 0x104F6, 0x104F7, 0x104F8, 0x104F9,
+    0x104FA, 0x104FB, 0x10597, 0x10598, 0x10599, 0x1059A, 0x1059B, 0x1059C, 0x1059D, 0x1059E, 0x1059F, 0x105A0,
+    0x105A1, 0x105A3, 0x105A4, 0x105A5, 0x105A6, 0x105A7, 0x105A8, 0x105A9, 0x105AA, 0x105AB, 0x105AC, 0x105AD,
+    0x105AE, 0x105AF, 0x105B0, 0x105B1, 0x105B3, 0x105B4, 0x105B5, 0x105B6, 0x105B7, 0x105B8, 0x105B9, 0x105BB,
+    0x105BC, 0x10CC0, 0x10CC1, 0x10CC2, 0x10CC3, 0x10CC4, 0x10CC5, 0x10CC6, 0x10CC7, 0x10CC8, 0x10CC9, 0x10CCA,
+    0x10CCB, 0x10CCC, 0x10CCD, 0x10CCE, 0x10CCF, 0x10CD0, 0x10CD1, 0x10CD2, 0x10CD3, 0x10CD4, 0x10CD5, 0x10CD6,
+    0x10CD7, 0x10CD8, 0x10CD9, 0x10CDA, 0x10CDB, 0x10CDC, 0x10CDD, 0x10CDE, 0x10CDF, 0x10CE0, 0x10CE1, 0x10CE2,
+    0x10CE3, 0x10CE4, 0x10CE5, 0x10CE6, 0x10CE7, 0x10CE8, 0x10CE9, 0x10CEA, 0x10CEB, 0x10CEC, 0x10CED, 0x10CEE,
+    0x10CEF, 0x10CF0, 0x10CF1, 0x10CF2, 0x118C0, 0x118C1, 0x118C2, 0x118C3, 0x118C4, 0x118C5, 0x118C6, 0x118C7,
+    0x118C8, 0x118C9, 0x118CA, 0x118CB, 0x118CC, 0x118CD, 0x118CE, 0x118CF, 0x118D0, 0x118D1, 0x118D2, 0x118D3,
+    0x118D4, 0x118D5, 0x118D6, 0x118D7, 0x118D8, 0x118D9, 0x118DA, 0x118DB, 0x118DC, 0x118DD, 0x118DE, 0x118DF,
+    0x16E60, 0x16E61, 0x16E62, 0x16E63, 0x16E64, 0x16E65, 0x16E66, 0x16E67, 0x16E68, 0x16E69, 0x16E6A, 0x16E6B,
+    0x16E6C, 0x16E6D, 0x16E6E, 0x16E6F, 0x16E70, 0x16E71, 0x16E72, 0x16E73, 0x16E74, 0x16E75, 0x16E76, 0x16E77,
+    0x16E78, 0x16E79, 0x16E7A, 0x16E7B, 0x16E7C, 0x16E7D, 0x16E7E, 0x16E7F, 0x1E922, 0x1E923, 0x1E924, 0x1E925,
+    0x1E926, 0x1E927, 0x1E928, 0x1E929, 0x1E92A, 0x1E92B, 0x1E92C, 0x1E92D, 0x1E92E, 0x1E92F, 0x1E930, 0x1E931,
+    0x1E932, 0x1E933, 0x1E934, 0x1E935, 0x1E936, 0x1E937, 0x1E938, 0x1E939, 0x1E93A, 0x1E93B, 0x1E93C, 0x1E93D,
+    0x1E93E, 0x1E93F, 0x1E940, 0x1E941, 0x1E942, 0x1E943,
+}};
+
+// ==================== 数据表结束 ====================
+
+constexpr char32_t kReplacementCharacter = 0xFFFD;
+
+// 谚文音节的算法分解与组合（Unicode 标准 3.12 节）
+constexpr char32_t kHangulSBase  = 0xAC00;
+constexpr char32_t kHangulLBase  = 0x1100;
+constexpr char32_t kHangulVBase  = 0x1161;
+constexpr char32_t kHangulTBase  = 0x11A7;
+constexpr char32_t kHangulLCount = 19;
+constexpr char32_t kHangulVCount = 21;
+constexpr char32_t kHangulTCount = 28;
+constexpr char32_t kHangulNCount = kHangulVCount * kHangulTCount;
+constexpr char32_t kHangulSCount = kHangulLCount * kHangulNCount;
+
+/**
+ * @brief 组合字符起始码位：更小的码位都是组合类别为 0、NFC 下保持不变的字符
+ */
+constexpr char32_t kFirstNfcUnsafe = 0x0300;
+
+[[nodiscard]] auto find_mapping(const auto& index, const char32_t code_point) noexcept -> const MappingEntry* {
+    const auto it = std::lower_bound(index.begin(), index.end(), code_point, [](const MappingEntry& entry, const char32_t cp) {
+        return entry.code_point < cp;
+    });
+    return it != index.end() && it->code_point == code_point ? &*it : nullptr;
+}
+
+[[nodiscard]] auto is_nfc_safe(const char32_t code_point) noexcept -> bool {
+    if (code_point < kFirstNfcUnsafe) {
+        return true;
+    }
+    const auto it = std::upper_bound(kNfcUnsafeRanges.begin(), kNfcUnsafeRanges.end(), code_point, [](const char32_t cp, const CodePointRange& range) {
+        return cp < range.first;
+    });
+    return it == kNfcUnsafeRanges.begin() || std::prev(it)->last < code_point;
+}
+
+void decompose(const char32_t code_point, std::vector<char32_t>& out) {
+    if (code_point >= kHangulSBase && code_point < kHangulSBase + kHangulSCount) {
+        const char32_t index = code_point - kHangulSBase;
+        out.push_back(kHangulLBase + index / kHangulNCount);
+        out.push_back(kHangulVBase + (index % kHangulNCount) / kHangulTCount);
+        if (index % kHangulTCount != 0) {
+            out.push_back(kHangulTBase + index % kHangulTCount);
+        }
+        return;
+    }
+    if (const auto* entry = find_mapping(kDecompositionIndex, code_point)) {
+        const auto* data = kDecompositionData.data() + entry->offset;
+        out.insert(out.end(), data, data + entry->length);
+        return;
+    }
+    out.push_back(code_point);
+}
+
+[[nodiscard]] auto compose(const char32_t first, const char32_t second) noexcept -> char32_t {
+    if (first >= kHangulLBase && first < kHangulLBase + kHangulLCount &&
+        second >= kHangulVBase && second < kHangulVBase + kHangulVCount) {
+        return kHangulSBase + ((first - kHangulLBase) * kHangulVCount + (second - kHangulVBase)) * kHangulTCount;
+    }
+    if (first >= kHangulSBase && first < kHangulSBase + kHangulSCount && (first - kHangulSBase) % kHangulTCount == 0 &&
+        second > kHangulTBase && second < kHangulTBase + kHangulTCount) {
+        return first + (second - kHangulTBase);
+    }
+    const auto it = std::lower_bound(kCompositionPairs.begin(), kCompositionPairs.end(), std::pair{first, second}, [](const CompositionPair& pair, const std::pair<char32_t, char32_t>& key) {
+        return pair.first != key.first ? pair.first < key.first : pair.second < key.second;
+    });
+    return it != kCompositionPairs.end() && it->first == first && it->second == second ? it->composite : 0;
+}
+
+/**
+ * @brief 对一个以安全字符为边界的片段做完整的 NFC：分解、按组合类别稳定重排、再组合
+ */
+void normalize_segment(const std::string_view segment, std::string& out) {
+    std::vector<char32_t> buffer;
+    buffer.reserve(segment.size() * 2);
+    for (size_t pos = 0; pos < segment.size();) {
+        decompose(next_code_point(segment, pos), buffer);
+    }
+
+    // 规范重排：连续的非起始字符按组合类别稳定排序（插入排序，这样的序列通常只有一两个字符）
+    for (size_t i = 1; i < buffer.size(); ++i) {
+        const char32_t current       = buffer[i];
+        const unsigned current_class = combining_class(current);
+        if (current_class == 0) {
+            continue;
+        }
+        size_t j = i;
+        while (j > 0 && combining_class(buffer[j - 1]) > current_class) {
+            buffer[j] = buffer[j - 1];
+            --j;
+        }
+        buffer[j] = current;
+    }
+
+    if (!buffer.empty()) {
+        size_t   starter_pos = 0;
+        char32_t starter     = buffer[0];
+        unsigned last_class  = combining_class(starter) == 0 ? 0 : 256;
+        size_t   write       = 1;
+        for (size_t i = 1; i < buffer.size(); ++i) {
+            const char32_t current       = buffer[i];
+            const unsigned current_class = combining_class(current);
+            // 起始字符与当前字符之间没有组合类别相同或更高的字符时才能组合
+            if (last_class != 256 && (last_class < current_class || last_class == 0)) {
+                if (const char32_t composite = compose(starter, current); composite != 0) {
+                    buffer[starter_pos] = composite;
+                    starter             = composite;
+                    continue;
+                }
+            }
+            if (current_class == 0) {
+                starter_pos = write;
+                starter     = current;
+            }
+            last_class      = current_class;
+            buffer[write++] = current;
+        }
+        buffer.resize(write);
+    }
+
+    for (const char32_t code_point : buffer) {
+        append_code_point(code_point, out);
+    }
+}
+
+}  // namespace
+
+char32_t next_code_point(const std::string_view text, size_t& pos) noexcept {
+    const auto lead = static_cast<unsigned char>(text[pos]);
+    if (lead < 0x80) {
+        ++pos;
+        return lead;
+    }
+
+    size_t   length = 0;
+    char32_t value  = 0;
+    char32_t min    = 0;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+        value  = lead & 0x1F;
+        min    = 0x80;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        value  = lead & 0x0F;
+        min    = 0x800;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        value  = lead & 0x07;
+        min    = 0x10000;
+    }
+    if (length == 0 || pos + length > text.size()) {
+        ++pos;
+        return kReplacementCharacter;
+    }
+    for (size_t i = 1; i < length; ++i) {
+        const auto trail = static_cast<unsigned char>(text[pos + i]);
+        if ((trail & 0xC0) != 0x80) {
+            ++pos;
+            return kReplacementCharacter;
+        }
+        value = (value << 6) | (trail & 0x3F);
+    }
+    if (value < min || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) {
+        ++pos;
+        return kReplacementCharacter;
+    }
+    pos += length;
+    return value;
+}
+
+void append_code_point(const char32_t code_point, std::string& out) {
+    if (code_point < 0x80) {
+        out.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+unsigned combining_class(const char32_t code_point) noexcept {
+    if (code_point < kFirstNfcUnsafe) {
+        return 0;
+    }
+    const auto it = std::upper_bound(kCombiningClassRanges.begin(), kCombiningClassRanges.end(), code_point, [](const char32_t cp, const CombiningClassRange& range) {
+        return cp < range.first;
+    });
+    if (it == kCombiningClassRanges.begin() || std::prev(it)->last < code_point) {
+        return 0;
+    }
+    return std::prev(it)->combining_class;
+}
+
+void append_nfc(const std::string_view text, std::string& out) {
+    out.reserve(out.size() + text.size());
+
+    // 安全字符（组合类别为 0、不会与前一字符组合且 NFC 下不变）是规范化边界：
+    // 从最后一个安全字符到下一个安全字符之前的片段需要完整处理，其余原样复制
+    size_t copied        = 0;
+    size_t last_boundary = 0;
+    size_t pos           = 0;
+    while (pos < text.size()) {
+        const size_t ascii = ascii_prefix_length(text.substr(pos));
+        if (ascii != 0) {
+            pos += ascii;
+            last_boundary = pos - 1;
+            continue;
+        }
+
+        const size_t   start      = pos;
+        const char32_t code_point = next_code_point(text, pos);
+        if (is_nfc_safe(code_point)) {
+            last_boundary = start;
+            continue;
+        }
+
+        size_t end = pos;
+        while (end < text.size()) {
+            size_t         next      = end;
+            const char32_t following = next_code_point(text, next);
+            if (is_nfc_safe(following)) {
+                break;
+            }
+            end = next;
+        }
+
+        const size_t segment_begin = std::max(copied, last_boundary);
+        out.append(text.data() + copied, segment_begin - copied);
+        normalize_segment(text.substr(segment_begin, end - segment_begin), out);
+        copied        = end;
+        last_boundary = end;
+        pos           = end;
+    }
+    out.append(text.data() + copied, text.size() - copied);
+}
+
+void append_case_folded(const std::string_view text, std::string& out) {
+    out.reserve(out.size() + text.size());
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const size_t ascii = ascii_prefix_length(text.substr(pos));
+        for (size_t i = pos; i < pos + ascii; ++i) {
+            const char c = text[i];
+            out.push_back(c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c);
+        }
+        pos += ascii;
+        if (pos == text.size()) {
+            break;
+        }
+
+        const size_t   start      = pos;
+        const char32_t code_point = next_code_point(text, pos);
+        if (const auto* entry = find_mapping(kCaseFoldIndex, code_point)) {
+            for (size_t i = 0; i < entry->length; ++i) {
+                append_code_point(kCaseFoldData[entry->offset + i], out);
+            }
+        } else if (code_point == kReplacementCharacter) {
+            append_code_point(code_point, out);
+        } else {
+            out.append(text.data() + start, pos - start);
+        }
+    }
+}
+
+}  // namespace hps
@@ -0,0 +1,134 @@
+#include "hps/utils/whitespace.hpp"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define HPS_WHITESPACE_SSE2 1
+#include <emmintrin.h>
+#else
+#define HPS_WHITESPACE_SSE2 0
+#endif
+
+namespace hps {
+namespace {
+
+[[nodiscard]] constexpr auto is_space_byte(const char c) noexcept -> bool {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+#if HPS_WHITESPACE_SSE2
+
+constexpr size_t kBlockSize = 16;
+
+/**
+ * @brief 16 字节块中空格以外的空白字符掩码
+ */
+[[nodiscard]] inline auto control_whitespace_mask(const __m128i block) noexcept -> unsigned {
+    const __m128i tab_to_cr = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\t')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))),
+        _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\f')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\r'))));
+    return static_cast<unsigned>(_mm_movemask_epi8(tab_to_cr));
+}
+
+[[nodiscard]] inline auto space_mask(const __m128i block) noexcept -> unsigned {
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(' '))));
+}
+
+[[nodiscard]] inline auto load_block(const char* data) noexcept -> __m128i {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+#endif
+
+}  // namespace
+
+size_t find_whitespace_or(const std::string_view text, size_t pos, const char stop) noexcept {
+    const char* data = text.data();
+#if HPS_WHITESPACE_SSE2
+    const __m128i stop_byte = _mm_set1_epi8(stop);
+    for (; pos + kBlockSize <= text.size(); pos += kBlockSize) {
+        const __m128i  block = load_block(data + pos);
+        const unsigned mask  = control_whitespace_mask(block) | space_mask(block) |
+                              static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, stop_byte)));
+        if (mask != 0) {
+            return pos + static_cast<size_t>(std::countr_zero(mask));
+        }
+    }
+#endif
+    for (; pos < text.size(); ++pos) {
+        if (is_space_byte(data[pos]) || data[pos] == stop) {
+            return pos;
+        }
+    }
+    return text.size();
+}
+
+size_t find_non_whitespace(const std::string_view text, size_t pos) noexcept {
+    const char* data = text.data();
+#if HPS_WHITESPACE_SSE2
+    for (; pos + kBlockSize <= text.size(); pos += kBlockSize) {
+        const __m128i  block = load_block(data + pos);
+        const unsigned mask  = ~(control_whitespace_mask(block) | space_mask(block)) & 0xFFFFU;
+        if (mask != 0) {
+            return pos + static_cast<size_t>(std::countr_zero(mask));
+        }
+    }
+#endif
+    for (; pos < text.size(); ++pos) {
+        if (!is_space_byte(data[pos])) {
+            return pos;
+        }
+    }
+    return text.size();
+}
+
+bool is_normalized_whitespace(const std::string_view text) noexcept {
+    const char* data           = text.data();
+    size_t      pos            = 0;
+    bool        previous_space = false;
+#if HPS_WHITESPACE_SSE2
+    for (; pos + kBlockSize <= text.size(); pos += kBlockSize) {
+        const __m128i block = load_block(data + pos);
+        if (control_whitespace_mask(block) != 0) {
+            return false;
+        }
+        // 把上一块末尾的空格移入第 0 位，同时检查块内与跨块的相邻空格
+        const unsigned spaces = space_mask(block);
+        if ((spaces & ((spaces << 1) | (previous_space ? 1U : 0U))) != 0) {
+            return false;
+        }
+        previous_space = (spaces & 0x8000U) != 0;
+    }
+#endif
+    for (; pos < text.size(); ++pos) {
+        const char c = data[pos];
+        if (c == ' ') {
+            if (previous_space) {
+                return false;
+            }
+            previous_space = true;
+        } else if (is_space_byte(c)) {
+            return false;
+        } else {
+            previous_space = false;
+        }
+    }
+    return true;
+}
+
+void append_normalized_whitespace(const std::string_view text, std::string& out) {
+    out.reserve(out.size() + text.size());
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const size_t whitespace = find_whitespace(text, pos);
+        out.append(text.data() + pos, whitespace - pos);
+        if (whitespace == text.size()) {
+            break;
+        }
+        out.push_back(' ');
+        pos = find_non_whitespace(text, whitespace + 1);
+    }
+}
+
+}  // namespace hps
@@ -135,4 +135,125 @@ TEST(DocumentTest, QueryIndexesInvalidateAfterAttachedDomMutations) {
     ASSERT_EQ(doc.get_elements_by_class_name("gamma").size(), 1u);
 }
 
+TEST(DocumentTest, IncrementalQueryIndexesKeepDocumentOrder) {
+    Document doc("");
+
+    auto root      = std::make_unique<Element>("div");
+    auto* root_ptr = root.get();
+    doc.add_child(std::move(root));
+
+    auto last = std::make_unique<Element>("p");
+    last->add_attribute("id", "dup");
+    auto* last_ptr = last.get();
+    root_ptr->add_child(std::move(last));
+
+    ASSERT_EQ(doc.get_element_by_id("dup"), last_ptr);
+
+    auto first = std::make_unique<Element>("p");
+    first->add_attribute("id", "dup");
+    first->add_attribute("class", "x");
+    auto nested = std::make_unique<Element>("span");
+    nested->add_attribute("class", "x");
+    auto* nested_ptr = nested.get();
+    first->add_child(std::move(nested));
+    auto* first_ptr = first.get();
+    root_ptr->insert_child_before(std::move(first), last_ptr);
+
+    EXPECT_EQ(doc.get_element_by_id("dup"), first_ptr);
+    const auto paragraphs = doc.get_elements_by_tag_name("p");
+    ASSERT_EQ(paragraphs.size(), 2u);
+    EXPECT_EQ(paragraphs[0], first_ptr);
+    EXPECT_EQ(paragraphs[1], last_ptr);
+
+    last_ptr->add_attribute("class", "x");
+    const auto with_class = doc.get_elements_by_class_name("x");
+    ASSERT_EQ(with_class.size(), 3u);
+    EXPECT_EQ(with_class[0], first_ptr);
+    EXPECT_EQ(with_class[1], nested_ptr);
+    EXPECT_EQ(with_class[2], last_ptr);
+
+    EXPECT_LT(first_ptr->document_order(), nested_ptr->document_order());
+    EXPECT_LT(nested_ptr->document_order(), last_ptr->document_order());
+
+    auto detached = root_ptr->take_children();
+    EXPECT_EQ(nested_ptr->document_order(), 0u);
+    EXPECT_EQ(doc.get_element_by_id("dup"), nullptr);
+    EXPECT_TRUE(doc.get_elements_by_tag_name("p").empty());
+    EXPECT_TRUE(doc.get_elements_by_class_name("x").empty());
+    ASSERT_EQ(doc.get_elements_by_tag_name("div").size(), 1u);
+}
+
+TEST(DocumentTest, AppendingIntoEarlierElementKeepsDocumentOrder) {
+    Document doc("");
+
+    auto first      = std::make_unique<Element>("section");
+    auto* first_ptr = first.get();
+    doc.add_child(std::move(first));
+    first_ptr->add_child(std::make_unique<TextNode>("text"));
+
+    auto second      = std::make_unique<Element>("section");
+    auto* second_ptr = second.get();
+    doc.add_child(std::move(second));
+    ASSERT_EQ(doc.get_elements_by_tag_name("section").size(), 2u);
+
+    // first 之后已有 second，向 first 追加的元素不在文档末尾
+    auto inner      = std::make_unique<Element>("span");
+    auto* inner_ptr = inner.get();
+    first_ptr->add_child(std::move(inner));
+    auto tail      = std::make_unique<Element>("span");
+    auto* tail_ptr = tail.get();
+    second_ptr->add_child(std::move(tail));
+
+    EXPECT_LT(first_ptr->document_order(), inner_ptr->document_order());
+    EXPECT_LT(inner_ptr->document_order(), second_ptr->document_order());
+    EXPECT_LT(second_ptr->document_order(), tail_ptr->document_order());
+    const auto spans = doc.get_elements_by_tag_name("span");
+    ASSERT_EQ(spans.size(), 2u);
+    EXPECT_EQ(spans[0], inner_ptr);
+    EXPECT_EQ(spans[1], tail_ptr);
+
+    auto detached = second_ptr->take_children();
+    auto again      = std::make_unique<Element>("span");
+    auto* again_ptr = again.get();
+    first_ptr->add_child(std::move(again));
+    const auto remaining = doc.get_elements_by_tag_name("span");
+    ASSERT_EQ(remaining.size(), 2u);
+    EXPECT_EQ(remaining[0], inner_ptr);
+    EXPECT_EQ(remaining[1], again_ptr);
+    EXPECT_LT(again_ptr->document_order(), second_ptr->document_order());
+}
+
+TEST(DocumentTest, AttachingSubtreeUpdatesOwnerOfEveryNode) {
+    Document doc("");
+
+    auto  root     = std::make_unique<Element>("div");
+    auto* root_ptr = root.get();
+    auto  list     = std::make_unique<Element>("ul");
+    auto* list_ptr = list.get();
+    auto  item     = std::make_unique<Element>("li");
+    auto* item_ptr = item.get();
+    item_ptr->add_child(std::make_unique<TextNode>("a"));
+    list_ptr->add_child(std::move(item));
+    auto  tail     = std::make_unique<Element>("li");
+    auto* tail_ptr = tail.get();
+    list_ptr->add_child(std::move(tail));
+    root_ptr->add_child(std::move(list));
+    root_ptr->add_child(std::make_unique<TextNode>("b"));
+    doc.add_child(std::move(root));
+    ASSERT_TRUE(doc.get_elements_by_class_name("x").empty());
+
+    // 子树内每个节点都归属文档，属性变化会更新文档索引
+    item_ptr->add_attribute("class", "x");
+    tail_ptr->add_attribute("class", "x");
+    const auto with_class = doc.get_elements_by_class_name("x");
+    ASSERT_EQ(with_class.size(), 2u);
+    EXPECT_EQ(with_class[0], item_ptr);
+    EXPECT_EQ(with_class[1], tail_ptr);
+
+    auto detached = root_ptr->take_children();
+    tail_ptr->add_attribute("id", "gone");
+    EXPECT_EQ(doc.get_element_by_id("gone"), nullptr);
+    EXPECT_TRUE(doc.get_elements_by_class_name("x").empty());
+}
+
 }  // namespace hps::tests
@@ -0,0 +1,190 @@
+#include "hps/core/frozen_document.hpp"
+#include "hps/core/element.hpp"
+#include "hps/hps.hpp"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace hps::tests {
+
+namespace {
+constexpr std::string_view kSampleHtml = R"(<!DOCTYPE html>
+<html><head><title>Frozen</title></head>
+<body>
+  <div id="main" class="container wrapper">
+    <h1 id="logo">Logo</h1>
+    <nav><ul>
+      <li><a href="#" class="nav-link active">Home</a></li>
+      <li><a href="/about" class="nav-link">About</a></li>
+      <li><a class="nav-link">Contact</a></li>
+    </ul></nav>
+    <section class="feature"><h2>Feature</h2><p class="description">Text <b>bold</b></p></section>
+    <p></p>
+    <input type="checkbox" checked><input type="text" name="user" disabled>
+    <!-- note -->
+  </div>
+</body></html>)";
+}  // namespace
+
+TEST(FrozenDocumentTest, MirrorsTreeStructure) {
+    const auto document = parse(kSampleHtml);
+    ASSERT_NE(document, nullptr);
+    const auto frozen = document->freeze();
+
+    ASSERT_GT(frozen.size(), 1u);
+    EXPECT_EQ(frozen.type(FrozenDocument::root()), NodeType::Document);
+
+    const auto main = frozen.css_first("#main");
+    ASSERT_NE(main, FrozenDocument::kInvalidNode);
+    EXPECT_EQ(frozen.tag_name(main), "div");
+    EXPECT_EQ(frozen.get_attribute(main, "CLASS"), "container wrapper");
+    EXPECT_TRUE(frozen.has_class(main, "wrapper"));
+    EXPECT_FALSE(frozen.has_class(main, "wrap"));
+    EXPECT_EQ(frozen.tag_name(frozen.parent(main)), "body");
+
+    const auto description = frozen.css_first("p.description");
+    ASSERT_NE(description, FrozenDocument::kInvalidNode);
+    EXPECT_EQ(frozen.text_content(description), "Text bold");
+    EXPECT_EQ(frozen.text_content(main), document->get_element_by_id("main")->text_content());
+}
+
+TEST(FrozenDocumentTest, SelectorResultsMatchPointerTree) {
+    const auto document = parse(kSampleHtml);
+    ASSERT_NE(document, nullptr);
+    const auto frozen = document->freeze();
+
+    const std::array<std::string_view, 16> selectors = {
+        "div", ".nav-link", "#logo", "a[href]", "a[href='#']", "div > h1", "ul li a", "h1 + nav",
+        "li:first-child a", "li:nth-child(2)", "input:checked", "input:disabled", "p:empty",
+        "section h2 + p.description", "li:not(:first-child)", "h1, h2, p",
+    };
+    for (const auto selector : selectors) {
+        std::vector<std::string> expected;
+        for (const auto* element : document->querySelectorAll(selector)) {
+            expected.push_back(element->tag_name() + "|" + element->text_content());
+        }
+        std::vector<std::string> actual;
+        for (const auto node : frozen.css(selector)) {
+            actual.push_back(std::string(frozen.tag_name(node)) + "|" + frozen.text_content(node));
+        }
+        EXPECT_EQ(actual, expected) << selector;
+    }
+}
+
+TEST(FrozenDocumentTest, SnapshotIsIndependentOfLaterMutations) {
+    const auto document = parse("<div id='a'></div>");
+    ASSERT_NE(document, nullptr);
+    const auto frozen = document->freeze();
+
+    const_cast<Element*>(document->get_element_by_id("a"))->add_attribute("id", "b");
+    EXPECT_NE(frozen.css_first("#a"), FrozenDocument::kInvalidNode);
+    EXPECT_EQ(frozen.css_first("#b"), FrozenDocument::kInvalidNode);
+}
+
+TEST(FrozenDocumentTest, RejectsUnsupportedSelectors) {
+    const auto document = parse("<div><p>x</p></div>");
+    ASSERT_NE(document, nullptr);
+    const auto frozen = document->freeze();
+    EXPECT_THROW((void)frozen.css("div:has(p)"), HPSException);
+}
+
+TEST(FrozenDocumentTest, SerializeRoundTripPreservesQueries) {
+    const auto document = parse(kSampleHtml);
+    ASSERT_NE(document, nullptr);
+    const auto frozen   = document->freeze();
+    const auto restored = FrozenDocument::deserialize(frozen.serialize());
+
+    ASSERT_EQ(restored.size(), frozen.size());
+    for (const auto selector : {"a.nav-link", "#logo", "input:disabled", "li:nth-child(2) a"}) {
+        EXPECT_EQ(restored.css(selector), frozen.css(selector)) << selector;
+    }
+    const auto link = restored.css_first("a[href='/about']");
+    ASSERT_NE(link, FrozenDocument::kInvalidNode);
+    EXPECT_EQ(restored.text_content(link), "About");
+}
+
+TEST(FrozenDocumentTest, SaveAndLoadThroughMappedFile) {
+    const auto document = parse(kSampleHtml);
+    ASSERT_NE(document, nullptr);
+    const auto path = std::filesystem::temp_directory_path() / "hps_frozen_document_test.hpssnap";
+    document->freeze().save(path);
+
+    {
+        const auto loaded = FrozenDocument::load(path);
+        const auto main   = loaded.css_first("div#main.wrapper");
+        ASSERT_NE(main, FrozenDocument::kInvalidNode);
+        EXPECT_EQ(loaded.text_content(main), document->get_element_by_id("main")->text_content());
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(FrozenDocumentTest, RejectsCorruptedSnapshots) {
+    const auto        document = parse(kSampleHtml);
+    const std::string bytes    = document->freeze().serialize();
+
+    EXPECT_THROW((void)FrozenDocument::deserialize(bytes.substr(0, bytes.size() / 2)), HPSException);
+    EXPECT_THROW((void)FrozenDocument::deserialize(""), HPSException);
+
+    std::string bad_magic = bytes;
+    bad_magic[0]          = 'X';
+    EXPECT_THROW((void)FrozenDocument::deserialize(bad_magic), HPSException);
+
+    std::string bad_version = bytes;
+    bad_version[8]          = static_cast<char>(FrozenDocument::kFormatVersion + 1);
+    try {
+        (void)FrozenDocument::deserialize(bad_version);
+        FAIL() << "expected InvalidSnapshot";
+    } catch (const HPSException& e) {
+        EXPECT_EQ(e.code(), ErrorCode::InvalidSnapshot);
+    }
+}
+
+TEST(FrozenDocumentTest, RejectsNonContainerParentsAndUnknownNamespaces) {
+    const auto        document = parse(kSampleHtml);
+    const auto        frozen   = document->freeze();
+    const std::string bytes    = frozen.serialize();
+    // SnapshotHeader::section_offsets 的起始位置；列顺序为 types、namespaces、tags、parents……
+    constexpr size_t kSectionOffsetsAt = 40;
+    const auto section_offset = [&](const size_t section) {
+        std::uint64_t offset = 0;
+        std::memcpy(&offset, bytes.data() + kSectionOffsetsAt + section * sizeof(offset), sizeof(offset));
+        return static_cast<size_t>(offset);
+    };
+
+    FrozenDocument::NodeId text = FrozenDocument::kInvalidNode;
+    for (FrozenDocument::NodeId id = 1; id + 1 < frozen.size(); ++id) {
+        if (frozen.type(id) == NodeType::Text) {
+            text = id;
+            break;
+        }
+    }
+    ASSERT_NE(text, FrozenDocument::kInvalidNode);
+
+    std::string text_parent = bytes;
+    const FrozenDocument::NodeId parent = text;
+    std::memcpy(text_parent.data() + section_offset(3) + (text + 1) * sizeof(parent), &parent, sizeof(parent));
+    EXPECT_THROW((void)FrozenDocument::deserialize(text_parent), HPSException);
+
+    std::string bad_namespace            = bytes;
+    bad_namespace[section_offset(1) + 1] = 7;
+    EXPECT_THROW((void)FrozenDocument::deserialize(bad_namespace), HPSException);
+}
+
+TEST(FrozenDocumentTest, ToDocumentRebuildsPointerTree) {
+    const auto document = parse(kSampleHtml);
+    ASSERT_NE(document, nullptr);
+    const auto rebuilt = FrozenDocument::deserialize(document->freeze().serialize()).to_document();
+    ASSERT_NE(rebuilt, nullptr);
+
+    EXPECT_EQ(rebuilt->text_content(), document->text_content());
+    EXPECT_EQ(rebuilt->querySelectorAll(".nav-link").size(), 3u);
+    const auto* checkbox = rebuilt->querySelector("input[checked]");
+    ASSERT_NE(checkbox, nullptr);
+    EXPECT_EQ(checkbox->get_attribute("type"), "checkbox");
+}
+
+}  // namespace hps::tests
@@ -0,0 +1,121 @@
+#include "hps/core/text_extractor.hpp"
+#include "hps/core/document.hpp"
+#include "hps/core/element.hpp"
+#include "hps/parsing/html_parser.hpp"
+#include "hps/utils/unicode.hpp"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace hps::tests {
+
+namespace {
+
+auto parse(const std::string_view html) -> std::shared_ptr<Document> {
+    HTMLParser parser;
+    return parser.parse(html);
+}
+
+}  // namespace
+
+TEST(TextExtractorTest, InsertsNewlinesAtBlockBoundariesAndCollapsesWhitespace) {
+    const auto document = parse(
+        "<html><head><title>Title</title><style>p{}</style></head>"
+        "<body>\n  <h1> Heading </h1>\n<p>First   <b>bold</b>\n text</p><div><p>Nested</p></div>"
+        "<script>var x = 1;</script><ul><li>one</li><li>two</li></ul>tail</body></html>");
+
+    const TextExtractor extractor;
+    EXPECT_EQ(extractor.extract(*document), "Title\nHeading\nFirst bold text\nNested\none\ntwo\ntail");
+
+    TextExtractionOptions inline_options;
+    inline_options.block_newlines = false;
+    EXPECT_EQ(TextExtractor(inline_options).extract(*document), "Title Heading First bold text Nested one two tail");
+}
+
+TEST(TextExtractorTest, HonorsBrHandlingAndPreformattedText) {
+    const auto document = parse("<body><p>a<br>b<br><br>c</p><pre>  keep\n   spaces </pre>end</body>");
+
+    EXPECT_EQ(TextExtractor().extract(*document), "a\nb\n\nc\n  keep\n   spaces \nend");
+
+    TextExtractionOptions keep;
+    keep.br_handling = BRHandling::Keep;
+    EXPECT_EQ(TextExtractor(keep).extract(*document), "a b c\n  keep\n   spaces \nend");
+
+    TextExtractionOptions custom;
+    custom.br_handling = BRHandling::InsertCustom;
+    custom.br_text     = " | ";
+    EXPECT_EQ(TextExtractor(custom).extract(*document->querySelector("p")), "a | b |  | c");
+}
+
+TEST(TextExtractorTest, AppendsToCallerBuffer) {
+    const auto  document = parse("<p>x</p>");
+    std::string buffer   = "prefix:";
+    TextExtractor().extract(*document, buffer);
+    EXPECT_EQ(buffer, "prefix:x");
+}
+
+TEST(TextExtractorTest, AppliesNfcAndCaseFolding) {
+    // "Cafe" + U+0301 组合重音，"STRASSE" 中的 ß 与大写字母
+    const auto document = parse("<p>Cafe\xCC\x81 Stra\xC3\x9F" "e \xC3\x85NGSTR\xC3\x96M</p>");
+
+    TextExtractionOptions nfc;
+    nfc.nfc = true;
+    EXPECT_EQ(TextExtractor(nfc).extract(*document), "Caf\xC3\xA9 Stra\xC3\x9F" "e \xC3\x85NGSTR\xC3\x96M");
+
+    TextExtractionOptions folded;
+    folded.nfc       = true;
+    folded.case_fold = true;
+    EXPECT_EQ(TextExtractor(folded).extract(*document), "caf\xC3\xA9 strasse \xC3\xA5ngstr\xC3\xB6m");
+}
+
+TEST(TextExtractorTest, SegmentsWords) {
+    std::vector<std::string_view> words;
+    TextExtractor::segment_words("Don't panic: pi is 3.14, e\xCC\x81t\xC3\xA9! \xE4\xB8\xAD\xE6\x96\x87" "abc", words);
+    const std::vector<std::string_view> expected = {
+        "Don't", "panic", "pi", "is", "3.14", "e\xCC\x81t\xC3\xA9", "\xE4\xB8\xAD", "\xE6\x96\x87", "abc",
+    };
+    EXPECT_EQ(words, expected);
+
+    const auto  document = parse("<h1>Hello</h1><p>big world</p>");
+    std::string buffer;
+    words.clear();
+    TextExtractor().extract_words(*document, buffer, words);
+    EXPECT_EQ(words, (std::vector<std::string_view>{"Hello", "big", "world"}));
+}
+
+TEST(TextExtractorTest, HandlesDeepNestingWithoutRecursion) {
+    std::string html;
+    for (int i = 0; i < 800; ++i) {
+        html += "<span>";
+    }
+    html += "deep";
+    const auto document = parse(html);
+    EXPECT_EQ(TextExtractor().extract(*document), "deep");
+    EXPECT_EQ(document->text_content(), "deep");
+}
+
+TEST(UnicodeTest, NormalizesToNfc) {
+    std::string out;
+    // 重排后组合：a + U+0323 + U+0302 与 a + U+0302 + U+0323 都得到 U+1EAD
+    append_nfc("a\xCC\x82\xCC\xA3|a\xCC\xA3\xCC\x82", out);
+    EXPECT_EQ(out, "\xE1\xBA\xAD|\xE1\xBA\xAD");
+
+    out.clear();
+    // 谚文字母组合为音节，单字符分解 U+212B（埃）映射为 U+00C5
+    append_nfc("\xE1\x84\x80\xE1\x85\xA1\xE1\x86\xA8 \xE2\x84\xAB", out);
+    EXPECT_EQ(out, "\xEA\xB0\x81 \xC3\x85");
+
+    out.clear();
+    append_nfc("plain ascii", out);
+    EXPECT_EQ(out, "plain ascii");
+}
+
+TEST(UnicodeTest, FoldsCase) {
+    std::string out;
+    append_case_folded("ABC \xC3\x9F \xCE\xA3 \xEF\xAC\x81", out);
+    EXPECT_EQ(out, "abc ss \xCF\x83 fi");
+}
+
+}  // namespace hps::tests
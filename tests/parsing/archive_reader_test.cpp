@@ -0,0 +1,241 @@
+#include "hps/parsing/archive_reader.hpp"
+#include "hps/core/document.hpp"
+#include "hps/core/element.hpp"
+#include "hps/parsing/html_parser.hpp"
+#include "hps/utils/exception.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace hps::tests {
+
+namespace {
+
+auto warc_record(const std::string& type, const std::string& uri, const std::string& content_type, const std::string& block)
+    -> std::string {
+    std::string record = "WARC/1.1\r\nWARC-Type: " + type + "\r\n";
+    if (!uri.empty()) {
+        record += "WARC-Target-URI: " + uri + "\r\n";
+    }
+    record += "Content-Type: " + content_type + "\r\n";
+    record += "Content-Length: " + std::to_string(block.size()) + "\r\n\r\n";
+    record += block;
+    record += "\r\n\r\n";
+    return record;
+}
+
+auto http_response(const std::string& content_type, const std::string& body, const std::string& extra_headers = {})
+    -> std::string {
+    return "HTTP/1.1 200 OK\r\nContent-Type: " + content_type + "\r\n" + extra_headers + "\r\n" + body;
+}
+
+auto sample_warc() -> std::string {
+    std::string warc;
+    warc += warc_record("warcinfo", "", "application/warc-fields", "software: test\r\n");
+    warc += warc_record("request", "http://example.com/", "application/http; msgtype=request", "GET / HTTP/1.1\r\n\r\n");
+    warc += warc_record("response", "http://example.com/", "application/http; msgtype=response",
+                        http_response("text/html; charset=utf-8", "<html><body><p id=\"a\">first</p></body></html>"));
+    warc += warc_record("response", "http://example.com/logo.png", "application/http; msgtype=response",
+                        http_response("image/png", "\x89PNG"));
+    warc += warc_record("response", "http://example.cn/", "application/http; msgtype=response",
+                        http_response("text/html; charset=\"GBK\"", "<p id=\"b\">\xD6\xD0\xCE\xC4</p>"));
+    warc += warc_record("response", "http://example.com/chunked", "application/http; msgtype=response",
+                        http_response("text/html", "5\r\n<p>ch\r\n9\r\nunked</p>\r\n0\r\n\r\n", "Transfer-Encoding: chunked\r\n"));
+    warc += warc_record("resource", "file:///local.html", "text/html", "<p id=\"c\">resource</p>");
+    return warc;
+}
+
+void write_binary_file(const std::filesystem::path& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    ASSERT_TRUE(out.is_open());
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    ASSERT_TRUE(out.good());
+}
+
+}  // namespace
+
+TEST(ArchiveReaderTest, ReadsHtmlRecordsFromWarc) {
+    const std::string warc = sample_warc();
+    ArchiveReader     reader(warc);
+
+    std::vector<ArchiveRecord> records;
+    while (auto record = reader.next()) {
+        records.push_back(*record);
+    }
+
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(records[0].target_uri, "http://example.com/");
+    EXPECT_EQ(records[0].charset, "utf-8");
+    EXPECT_EQ(records[0].body, "<html><body><p id=\"a\">first</p></body></html>");
+    EXPECT_GE(records[0].body.data(), warc.data());
+    EXPECT_LE(records[0].body.data() + records[0].body.size(), warc.data() + warc.size());
+    EXPECT_EQ(warc.compare(records[0].offset, 5, "WARC/"), 0);
+
+    EXPECT_EQ(records[1].target_uri, "http://example.cn/");
+    EXPECT_EQ(records[1].charset, "GBK");
+
+    EXPECT_EQ(records[2].body, "<p>chunked</p>");
+    EXPECT_NE(records[2].keep_alive, nullptr);
+
+    EXPECT_EQ(records[3].target_uri, "file:///local.html");
+    EXPECT_EQ(records[3].body, "<p id=\"c\">resource</p>");
+    EXPECT_FALSE(reader.next().has_value());
+}
+
+TEST(ArchiveReaderTest, SplitsConcatenatedHtmlDocuments) {
+    const std::string data =
+        "<!DOCTYPE html><html><body>one</body></html>\n"
+        "<HTML><body>two</body></HTML >\n\n"
+        "<p>three without closing html";
+    ArchiveReader reader(data);
+
+    std::vector<std::string> bodies;
+    while (auto record = reader.next()) {
+        bodies.emplace_back(record->body);
+    }
+
+    ASSERT_EQ(bodies.size(), 3u);
+    EXPECT_EQ(bodies[0], "<!DOCTYPE html><html><body>one</body></html>");
+    EXPECT_EQ(bodies[1], "<HTML><body>two</body></HTML >");
+    EXPECT_EQ(bodies[2], "<p>three without closing html");
+}
+
+TEST(ArchiveReaderTest, ParseArchiveRecordBorrowsUtf8AndDecodesDeclaredCharset) {
+    const std::string warc = sample_warc();
+    ArchiveReader     reader(warc);
+    HTMLParser        parser;
+
+    const auto utf8_record = reader.next();
+    ASSERT_TRUE(utf8_record.has_value());
+    const auto utf8_document = parse_archive_record(parser, *utf8_record);
+    ASSERT_NE(utf8_document, nullptr);
+    EXPECT_FALSE(utf8_document->owns_source());
+    ASSERT_NE(utf8_document->get_element_by_id("a"), nullptr);
+    EXPECT_EQ(utf8_document->get_element_by_id("a")->text_content(), "first");
+
+    const auto gbk_record = reader.next();
+    ASSERT_TRUE(gbk_record.has_value());
+    const auto gbk_document = parse_archive_record(parser, *gbk_record);
+    ASSERT_NE(gbk_document, nullptr);
+    ASSERT_NE(gbk_document->get_element_by_id("b"), nullptr);
+    EXPECT_EQ(gbk_document->get_element_by_id("b")->text_content(), "\xE4\xB8\xAD\xE6\x96\x87");
+}
+
+TEST(ArchiveReaderTest, OpenedArchiveRecordsOutliveReader) {
+    const auto path = std::filesystem::temp_directory_path() / "hps_archive_reader_test.warc";
+    write_binary_file(path, sample_warc());
+
+    std::shared_ptr<Document> document;
+    {
+        auto       reader = ArchiveReader::open(path);
+        const auto record = reader.next();
+        ASSERT_TRUE(record.has_value());
+        EXPECT_NE(record->keep_alive, nullptr);
+        HTMLParser parser;
+        document = parse_archive_record(parser, *record);
+    }
+    std::filesystem::remove(path);
+
+    ASSERT_NE(document, nullptr);
+    ASSERT_NE(document->get_element_by_id("a"), nullptr);
+    EXPECT_EQ(document->get_element_by_id("a")->text_content(), "first");
+}
+
+TEST(ArchiveReaderTest, ChunkedRecordHeadersOutliveReader) {
+    const auto path = std::filesystem::temp_directory_path() / "hps_archive_reader_chunked_test.warc";
+    write_binary_file(path, warc_record("response", "http://example.com/chunked", "application/http; msgtype=response",
+                                        http_response("text/html; charset=utf-8", "5\r\n<p>ch\r\n9\r\nunked</p>\r\n0\r\n\r\n",
+                                                      "Transfer-Encoding: chunked\r\n")));
+
+    std::optional<ArchiveRecord> record;
+    {
+        auto reader = ArchiveReader::open(path);
+        record      = reader.next();
+    }
+    std::filesystem::remove(path);
+
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ(record->body, "<p>chunked</p>");
+    EXPECT_EQ(record->target_uri, "http://example.com/chunked");
+    EXPECT_EQ(record->charset, "utf-8");
+}
+
+TEST(ArchiveReaderTest, TruncatedWarcRecordThrows) {
+    std::string warc = sample_warc();
+    warc.resize(warc.size() - 20);
+    ArchiveReader reader(warc);
+
+    try {
+        while (reader.next()) {
+        }
+        FAIL() << "Expected InvalidArchive";
+    } catch (const HPSException& e) {
+        EXPECT_EQ(e.code(), ErrorCode::InvalidArchive);
+    }
+}
+
+TEST(ArchiveReaderTest, ReadsPerRecordGzipMembers) {
+    // 两条分别压缩的 WARC 响应记录（.warc.gz 的常见形式）
+    const std::string gzip_warc(
+        "\x1F\x8B\x08\x00\x00\x00\x00\x00\x02\x03\x0B\x77\x0C\x72\xD6\x37\xD4\x33\xE0\xE5\x0A\x07\xB2\x74"
+        "\x43\x2A\x0B\x52\xAD\x14\x8A\x52\x8B\x0B\xF2\xF3\x8A\x53\x61\x82\x89\x45\xE9\xA9\x25\xBA\xA1\x41"
+        "\x9E\x56\x0A\x19\x25\x25\x05\x56\xFA\xFA\x89\xFA\xBC\x5C\xCE\xF9\x79\x25\xA9\x79\x25\xBA\x3E\xA9"
+        "\x79\xE9\x25\x19\x56\x0A\xA6\x26\xBC\x5C\xBC\x5C\x1E\x21\x21\x01\x40\x03\x0D\x15\x8C\x0C\x0C\x14"
+        "\xFC\xBD\x11\xCA\x20\x46\x97\xA4\x56\x94\xE8\x67\x94\xE4\xE6\x80\xD4\xDA\x14\xD8\xE5\xE7\xA5\xDA"
+        "\xE8\x17\xD8\x81\x78\x00\x2E\x9C\x17\x7D\x8B\x00\x00\x00\x1F\x8B\x08\x00\x00\x00\x00\x00\x02\x03"
+        "\x0B\x77\x0C\x72\xD6\x37\xD4\x33\xE0\xE5\x0A\x07\xB2\x74\x43\x2A\x0B\x52\xAD\x14\x8A\x52\x8B\x0B"
+        "\xF2\xF3\x8A\x53\x61\x82\x89\x45\xE9\xA9\x25\xBA\xA1\x41\x9E\x56\x0A\x19\x25\x25\x05\x56\xFA\xFA"
+        "\x49\xFA\xBC\x5C\xCE\xF9\x79\x25\xA9\x79\x25\xBA\x3E\xA9\x79\xE9\x25\x19\x56\x0A\xA6\x26\xBC\x5C"
+        "\xBC\x5C\x1E\x21\x21\x01\x40\x03\x0D\x15\x8C\x0C\x0C\x14\xFC\xBD\x11\xCA\x20\x46\x97\xA4\x56\x94"
+        "\xE8\x67\x94\xE4\xE6\x80\xD4\xDA\x14\xD8\x95\x94\xE7\xDB\xE8\x17\xD8\x81\x78\x00\x4C\x1E\x51\x50"
+        "\x8B\x00\x00\x00",
+        268);
+    ArchiveReader reader(gzip_warc);
+
+    if (!ArchiveReader::gzip_supported()) {
+        EXPECT_THROW((void)reader.next(), HPSException);
+        return;
+    }
+
+    const auto first = reader.next();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->target_uri, "http://a/");
+    EXPECT_EQ(first->body, "<p>one</p>");
+    EXPECT_EQ(first->offset, 0u);
+
+    const auto second = reader.next();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->target_uri, "http://b/");
+    EXPECT_EQ(second->body, "<p>two</p>");
+    EXPECT_EQ(second->offset, 139u);
+    EXPECT_FALSE(reader.next().has_value());
+}
+
+TEST(ArchiveReaderTest, InflatesMembersLargerThanInitialBuffer) {
+    // 约 100 字节压缩为 40 KB 的拼接 HTML，解压缓冲区需要多次扩容
+    const std::string gzip_html(
+        "\x1F\x8B\x08\x00\x00\x00\x00\x00\x02\x03\xED\xC5\xA1\x11\xC0\x20\x10\x00\xB0\x91\x58\xE0\xEF\x77"
+        "\x29\x87\x40\xC0\x81\xC0\xB0\x7D\xAB\x3A\x45\x62\x12\xFD\xCC\x91\x51\x57\xBB\x19\x3B\x1F\x00\x00"
+        "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\xE0\x17\x65\x67\x94\xBA\xDA\xFD\xEA\x67\x8E\x7C"
+        "\x01\xA3\x77\x4B\x1C\x61\x9C\x00\x00",
+        105);
+    ArchiveReader reader(gzip_html, {}, ArchiveFormat::ConcatenatedHtml);
+
+    if (!ArchiveReader::gzip_supported()) {
+        EXPECT_THROW((void)reader.next(), HPSException);
+        return;
+    }
+
+    const auto record = reader.next();
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ(record->body, "<html><body><p>" + std::string(40000, 'a') + "</p></body></html>");
+    EXPECT_FALSE(reader.next().has_value());
+}
+
+}  // namespace hps::tests
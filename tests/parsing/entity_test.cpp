@@ -2,8 +2,12 @@
 #include "hps/parsing/options.hpp"
 #include "hps/core/document.hpp"
 #include "hps/core/element.hpp"
+#include "hps/core/text_node.hpp"
 
 #include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace hps::tests {
 
@@ -53,4 +57,89 @@ TEST(HTMLEntityDecodingTest, DecodingDoesNotAffectDomStructure) {
     EXPECT_EQ(div->querySelector("span"), nullptr);
 }
 
+TEST(HTMLEntityDecodingTest, DecodeModeDecodesAttributeValues) {
+    Options options;
+    options.text_processing_mode = TextProcessingMode::Decode;
+
+    HTMLParser parser;
+    const auto doc = parser.parse(std::string_view(R"(<a title="a&amp;b" href="?x=1&copy=2">x</a>)"), options);
+
+    const auto* link = doc->querySelector("a");
+    ASSERT_NE(link, nullptr);
+    EXPECT_EQ(link->get_attribute("title"), "a&b");
+    // 属性值中无分号的历史写法后接 '=' 时不解码
+    EXPECT_EQ(link->get_attribute("href"), "?x=1&copy=2");
+}
+
+TEST(HTMLEntityDecodingTest, LazyDecodeDefersUntilFirstRead) {
+    Options options;
+    options.text_processing_mode = TextProcessingMode::LazyDecode;
+
+    HTMLParser parser;
+    const auto doc = parser.parse(std::string_view(R"(<p id="a">Tom &amp; Jerry</p><p id="b" title="&lt;x&gt;">plain</p>)"), options);
+
+    const auto* first = doc->get_element_by_id("a");
+    const auto* second = doc->get_element_by_id("b");
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+
+    const auto* entity_text = first->first_child()->as_text();
+    const auto* plain_text  = second->first_child()->as_text();
+    ASSERT_NE(entity_text, nullptr);
+    ASSERT_NE(plain_text, nullptr);
+    EXPECT_TRUE(entity_text->needs_decode());
+    EXPECT_FALSE(plain_text->needs_decode());
+
+    EXPECT_EQ(entity_text->text(), "Tom & Jerry");
+    EXPECT_FALSE(entity_text->needs_decode());
+    EXPECT_EQ(first->text_content(), "Tom & Jerry");
+    EXPECT_EQ(second->get_attribute("title"), "<x>");
+    EXPECT_NE(doc->querySelector("p[title='<x>']"), nullptr);
+}
+
+TEST(HTMLEntityDecodingTest, LazyDecodeAllowsConcurrentReadsOfConstDocument) {
+    Options options;
+    options.text_processing_mode = TextProcessingMode::LazyDecode;
+
+    std::string html;
+    for (int i = 0; i < 200; ++i) {
+        html += R"(<p title="a&amp;b">x &lt; y</p>)";
+    }
+    HTMLParser parser;
+    const auto doc = parser.parse(std::string_view(html), options);
+    const auto paragraphs = doc->get_elements_by_tag_name("p");
+    ASSERT_EQ(paragraphs.size(), 200u);
+
+    // 多个线程同时首次读取同一批节点，每个节点只解码一次且结果一致
+    std::vector<int>         mismatches(4, 0);
+    std::vector<std::thread> readers;
+    for (size_t reader = 0; reader < mismatches.size(); ++reader) {
+        readers.emplace_back([&, reader] {
+            for (const auto* paragraph : paragraphs) {
+                mismatches[reader] += paragraph->get_attribute("title") != "a&b";
+                mismatches[reader] += paragraph->first_child()->as_text()->text() != "x < y";
+            }
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    for (const int count : mismatches) {
+        EXPECT_EQ(count, 0);
+    }
+}
+
+TEST(HTMLEntityDecodingTest, LazyDecodeWithWhitespaceNormalizationDecodesFirst) {
+    Options options;
+    options.text_processing_mode = TextProcessingMode::LazyDecode;
+    options.whitespace_mode      = WhitespaceMode::Normalize;
+
+    HTMLParser parser;
+    const auto doc = parser.parse(std::string_view("<div>a &#10;&#10; b</div>"), options);
+
+    const auto* div = doc->querySelector("div");
+    ASSERT_NE(div, nullptr);
+    EXPECT_EQ(div->text_content(), "a b");
+}
+
 }  // namespace hps::tests
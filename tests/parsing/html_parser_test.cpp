@@ -1,11 +1,15 @@
 #include "hps/hps.hpp"
 #include "hps/core/element.hpp"
 #include "hps/core/text_node.hpp"
+#include "hps/parsing/html_parser.hpp"
 
 #include <filesystem>
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <ranges>
 #include <string>
+#include <utility>
 
 #include <gtest/gtest.h>
 
@@ -43,6 +47,208 @@ TEST(HTMLParser, EnforcesMaxTokens) {
     EXPECT_TRUE(has_error_code(res.errors, hps::ErrorCode::TooManyElements));
 }
 
+TEST(HTMLParser, TokenLimitReportsPartialStatus) {
+    hps::Options opts;
+    opts.max_tokens = 3;
+
+    const auto res = hps::parse_with_error("<a></a><b></b><c></c><d></d>", opts);
+    EXPECT_EQ(res.status, hps::ParseStatus::TokenLimit);
+    EXPECT_TRUE(res.is_partial());
+
+    const auto complete = hps::parse_with_error("<a></a>");
+    EXPECT_EQ(complete.status, hps::ParseStatus::Complete);
+    EXPECT_FALSE(complete.is_partial());
+}
+
+TEST(HTMLParser, StrictBudgetStopRecordsErrorOnce) {
+    hps::Options opts;
+    opts.max_tokens     = 3;
+    opts.error_handling = hps::ErrorHandlingMode::Strict;
+
+    const std::string_view html = "<a></a><b></b><c></c><d></d>";
+    hps::HTMLParser        parser;
+    EXPECT_THROW((void)parser.parse(html, opts), hps::HPSException);
+    ASSERT_EQ(parser.get_errors().size(), 1u);
+    EXPECT_EQ(parser.get_errors()[0].code, hps::ErrorCode::TooManyElements);
+
+    EXPECT_THROW((void)parser.parse_fragment(html, "div", opts), hps::HPSException);
+    ASSERT_EQ(parser.get_errors().size(), 1u);
+    EXPECT_EQ(parser.get_errors()[0].code, hps::ErrorCode::TooManyElements);
+}
+
+TEST(HTMLParser, RejectsInputLargerThanBudget) {
+    hps::Options opts;
+    opts.max_input_bytes = 16;
+
+    const std::string_view too_long = "<p>this input is too long</p>";
+    hps::HTMLParser        parser;
+    const auto             document = parser.parse(too_long, opts);
+    ASSERT_NE(document, nullptr);
+    EXPECT_EQ(parser.status(), hps::ParseStatus::InputTooLarge);
+    EXPECT_TRUE(document->source_html().empty());
+    EXPECT_EQ(document->querySelector("p"), nullptr);
+    EXPECT_TRUE(has_error_code(parser.get_errors(), hps::ErrorCode::OutOfMemory));
+
+    EXPECT_EQ(parser.parse_bytes(too_long, opts)->querySelector("p"), nullptr);
+    EXPECT_EQ(parser.status(), hps::ParseStatus::InputTooLarge);
+
+    const auto small = parser.parse(std::string_view("<p>ok</p>"), opts);
+    EXPECT_EQ(parser.status(), hps::ParseStatus::Complete);
+    EXPECT_NE(small->querySelector("p"), nullptr);
+
+    opts.error_handling = hps::ErrorHandlingMode::Strict;
+    EXPECT_THROW((void)parser.parse_fragment(too_long, "div", opts), hps::HPSException);
+}
+
+TEST(HTMLParser, StopsBuildingWhenDomBudgetIsExceeded) {
+    std::string html;
+    for (int i = 0; i < 1000; ++i) {
+        html += "<p class=\"item\">paragraph text</p>";
+    }
+
+    hps::Options opts;
+    opts.max_dom_bytes = 16 * 1024;
+
+    const auto res = hps::parse_with_error(html, opts);
+    ASSERT_NE(res.document, nullptr);
+    EXPECT_EQ(res.status, hps::ParseStatus::MemoryLimit);
+    EXPECT_TRUE(has_error_code(res.errors, hps::ErrorCode::OutOfMemory));
+
+    const auto paragraphs = res.document->querySelectorAll("p").size();
+    EXPECT_GT(paragraphs, 0u);
+    EXPECT_LT(paragraphs, 1000u);
+}
+
+TEST(HTMLParser, HonorsDeadlineAndCancellation) {
+    std::string html;
+    for (int i = 0; i < 1000; ++i) {
+        html += "<li>item</li>";
+    }
+
+    hps::Options timed;
+    timed.parse_timeout = std::chrono::nanoseconds(1);
+    const auto timed_out = hps::parse_with_error(html, timed);
+    EXPECT_EQ(timed_out.status, hps::ParseStatus::Timeout);
+    EXPECT_TRUE(has_error_code(timed_out.errors, hps::ErrorCode::ParseTimeout));
+
+    hps::Options cancelled;
+    cancelled.cancellation = hps::CancellationToken::create();
+    const hps::CancellationToken copy = cancelled.cancellation;
+    EXPECT_FALSE(cancelled.cancellation.is_cancelled());
+    copy.cancel();
+    EXPECT_TRUE(cancelled.cancellation.is_cancelled());
+
+    const auto aborted = hps::parse_with_error(html, cancelled);
+    EXPECT_EQ(aborted.status, hps::ParseStatus::Cancelled);
+    EXPECT_TRUE(has_error_code(aborted.errors, hps::ErrorCode::ParseCancelled));
+    EXPECT_EQ(aborted.document->querySelector("li"), nullptr);
+
+    hps::Options untouched;
+    untouched.cancellation = hps::CancellationToken::create();
+    EXPECT_EQ(hps::parse_with_error(html, untouched).status, hps::ParseStatus::Complete);
+}
+
+TEST(HTMLParser, PerformanceProfileSkipsScriptStyleAndDeclarations) {
+    const auto res = hps::parse_with_error(
+        "<!DOCTYPE html><html><head><style>p{}</style><script>x()</script></head>"
+        "<body><!-- c --><p id=\"a\">text</p><![CDATA[data]]></body></html>",
+        hps::Options::performance());
+    ASSERT_NE(res.document, nullptr);
+
+    const auto* script = res.document->querySelector("script");
+    ASSERT_NE(script, nullptr);
+    EXPECT_FALSE(script->has_children());
+    EXPECT_EQ(res.document->querySelector("body")->text_content(), "text");
+    EXPECT_NE(res.document->querySelector("#a"), nullptr);
+}
+
+TEST(HTMLParser, TagAllowListKeepsContentOfDroppedElements) {
+    hps::Options opts;
+    opts.tag_allow_list = {"a", "title"};
+
+    const auto res = hps::parse_with_error(
+        "<html><head><title>T</title><meta charset=utf-8></head>"
+        "<body><div class=\"nav\"><ul><li><a href=\"/x\">X</a></li></ul></div><p>tail</p></body></html>",
+        opts);
+    ASSERT_NE(res.document, nullptr);
+
+    EXPECT_EQ(res.document->querySelector("div"), nullptr);
+    EXPECT_EQ(res.document->querySelector("meta"), nullptr);
+    EXPECT_EQ(res.document->querySelector("title")->text_content(), "T");
+    const auto* link = res.document->querySelector("body > a");
+    ASSERT_NE(link, nullptr);
+    EXPECT_EQ(link->get_attribute("href"), "/x");
+    EXPECT_EQ(res.document->querySelector("body")->text_content(), "Xtail");
+}
+
+TEST(HTMLParser, PrunedTagsSkipWholeSubtrees) {
+    hps::Options opts;
+    opts.pruned_tags = {"svg", "script", "nav"};
+
+    const auto res = hps::parse_with_error(
+        "<body><nav><div><a href=\"/n\">n</a></div><br></nav>"
+        "<script>document.write('<p>x</p>')</script><svg><g/></svg>"
+        "<p id=\"kept\">body</p></body>",
+        opts);
+    ASSERT_NE(res.document, nullptr);
+
+    EXPECT_EQ(res.document->querySelector("nav"), nullptr);
+    EXPECT_EQ(res.document->querySelector("a"), nullptr);
+    EXPECT_EQ(res.document->querySelector("script"), nullptr);
+    EXPECT_EQ(res.document->querySelector("svg"), nullptr);
+    EXPECT_EQ(res.document->querySelectorAll("p").size(), 1u);
+    EXPECT_EQ(res.document->querySelector("body")->text_content(), "body");
+    EXPECT_FALSE(res.has_errors());
+}
+
+TEST(HTMLParser, PrunedSubtreeEndsOnlyAtItsOwnEndTag) {
+    hps::Options opts;
+    opts.pruned_tags = {"nav"};
+
+    // 子树内未闭合的 <li>/<p> 与错位的结束标签都不影响剪除范围
+    for (const std::string_view html : {
+             "<body><nav><ul><li>a<li>b</ul></nav><p id=kept>body</p>",
+             "<body><nav><p>a<p>b</nav><p id=kept>body</p>",
+             "<body><nav></div>x</nav><p id=kept>body</p>",
+             "<body><nav><nav>x</nav></span>y</nav><p id=kept>body</p>",
+         }) {
+        const auto res = hps::parse_with_error(html, opts);
+        ASSERT_NE(res.document, nullptr) << html;
+        EXPECT_EQ(res.document->querySelector("nav"), nullptr) << html;
+        const auto* kept = res.document->querySelector("body > #kept");
+        ASSERT_NE(kept, nullptr) << html;
+        EXPECT_EQ(res.document->querySelector("body")->text_content(), "body") << html;
+    }
+
+    // 被剪除的元素自身会被同名开始标签隐式关闭时，不按嵌套计数
+    opts.pruned_tags = {"p"};
+    const auto res = hps::parse_with_error("<body><p>a<p>b</p><div id=kept>body</div>", opts);
+    ASSERT_NE(res.document, nullptr);
+    EXPECT_EQ(res.document->querySelector("p"), nullptr);
+    ASSERT_NE(res.document->querySelector("body > #kept"), nullptr);
+    EXPECT_EQ(res.document->querySelector("body")->text_content(), "body");
+}
+
+TEST(HTMLParser, PrunedOptionalEndTagElementEndsWithItsParent) {
+    // 可省略结束标签的元素被父元素的结束标签或隐式关闭它的开始标签结束，剪除范围随之结束
+    for (const auto& [pruned, html] : {
+             std::pair<std::string, std::string_view>{"p", "<div><p>x</div><span>after</span>"},
+             std::pair<std::string, std::string_view>{"p", "<p>x<div><span>after</span></div>"},
+             std::pair<std::string, std::string_view>{"li", "<ul><li>a<li>b</ul><span>after</span>"},
+         }) {
+        hps::Options opts;
+        opts.pruned_tags = {pruned};
+
+        const auto res = hps::parse_with_error(html, opts);
+        ASSERT_NE(res.document, nullptr) << html;
+        EXPECT_EQ(res.document->querySelector(pruned), nullptr) << html;
+        const auto* after = res.document->querySelector("span");
+        ASSERT_NE(after, nullptr) << html;
+        EXPECT_EQ(after->text_content(), "after") << html;
+        EXPECT_EQ(res.document->querySelector("body")->text_content(), "after") << html;
+    }
+}
+
 TEST(HTMLParser, ParseFileUsesFileContent) {
     const auto temp_path = std::filesystem::temp_directory_path() / "hps_html_parser_test.html";
     const std::string html = "<div>Hello</div>";
@@ -57,6 +263,99 @@ TEST(HTMLParser, ParseFileUsesFileContent) {
     std::filesystem::remove(temp_path, ec);
 }
 
+TEST(HTMLParser, ParseFileRejectsOversizedFileBeforeDecoding) {
+    const auto temp_path = std::filesystem::temp_directory_path() / "hps_html_parser_test_oversized.html";
+    // 非法 UTF-8 需要整体转码，超出预算时应在转码前就被拒绝
+    write_binary_file(temp_path, "<p>caf\xE9 au lait, a long enough paragraph</p>");
+
+    hps::Options opts;
+    opts.max_input_bytes = 16;
+    hps::HTMLParser parser;
+    const auto      document = parser.parse_file(temp_path.string(), opts);
+    ASSERT_NE(document, nullptr);
+    EXPECT_EQ(parser.status(), hps::ParseStatus::InputTooLarge);
+    EXPECT_TRUE(document->source_html().empty());
+    ASSERT_EQ(parser.get_errors().size(), 1u);
+    EXPECT_EQ(parser.get_errors()[0].code, hps::ErrorCode::OutOfMemory);
+
+    opts.error_handling = hps::ErrorHandlingMode::Strict;
+    EXPECT_THROW((void)parser.parse_file(temp_path.string(), opts), hps::HPSException);
+    EXPECT_EQ(parser.get_errors().size(), 1u);
+
+    std::error_code ec;
+    std::filesystem::remove(temp_path, ec);
+}
+
+TEST(HTMLParser, ParseFileDocumentOwnsMappedSource) {
+    const auto temp_path = std::filesystem::temp_directory_path() / "hps_html_parser_test_mapped.html";
+    std::string html = "<ul>";
+    for (int i = 0; i < 1000; ++i) {
+        html += "<li class=\"item\">entry " + std::to_string(i) + "</li>";
+    }
+    html += "</ul>";
+    write_binary_file(temp_path, html);
+
+    std::shared_ptr<hps::Document> document;
+    {
+        hps::HTMLParser parser;
+        document = parser.parse_file(temp_path.string());
+    }
+    std::error_code ec;
+    std::filesystem::remove(temp_path, ec);
+
+    ASSERT_NE(document, nullptr);
+    EXPECT_FALSE(document->owns_source());
+    EXPECT_EQ(document->source_html(), html);
+    EXPECT_EQ(document->querySelectorAll("li.item").size(), 1000U);
+    ASSERT_NE(document->querySelector("li:last-child"), nullptr);
+    EXPECT_EQ(document->querySelector("li:last-child")->text_content(), "entry 999");
+}
+
+TEST(HTMLParser, ParseBorrowedReferencesCallerBuffer) {
+    auto buffer = std::make_shared<const std::string>("<div id=\"main\"><p>Hello</p></div>");
+    const std::weak_ptr<const std::string> observer = buffer;
+
+    auto document = hps::parse_borrowed(*buffer, buffer);
+    const char* source_data = buffer->data();
+    buffer.reset();
+
+    ASSERT_NE(document, nullptr);
+    EXPECT_FALSE(document->owns_source());
+    EXPECT_EQ(document->source_html().data(), source_data);
+    EXPECT_FALSE(observer.expired());
+    ASSERT_NE(document->querySelector("#main p"), nullptr);
+    EXPECT_EQ(document->querySelector("#main p")->text_content(), "Hello");
+
+    document.reset();
+    EXPECT_TRUE(observer.expired());
+
+    // 不传所有者时由调用方保证缓冲区有效
+    const std::string local = "<span>x</span>";
+    const auto        unowned = hps::parse_borrowed(local, nullptr);
+    EXPECT_EQ(unowned->source_html().data(), local.data());
+    EXPECT_TRUE(hps::parse("<span>x</span>")->owns_source());
+
+    // HTMLParser 成员与自由函数的参数顺序一致：源码、所有者、选项
+    hps::Options strict;
+    strict.error_handling = hps::ErrorHandlingMode::Strict;
+    hps::HTMLParser parser;
+    const auto      parsed = parser.parse_borrowed(local, nullptr, strict);
+    EXPECT_EQ(parsed->source_html().data(), local.data());
+}
+
+TEST(HTMLParser, ParseFileHandlesEmptyFile) {
+    const auto temp_path = std::filesystem::temp_directory_path() / "hps_html_parser_test_empty.html";
+    write_binary_file(temp_path, "");
+
+    const auto res = hps::parse_file_with_error(temp_path.string(), hps::Options{});
+    ASSERT_NE(res.document, nullptr);
+    EXPECT_FALSE(res.has_errors());
+    EXPECT_TRUE(res.document->source_html().empty());
+
+    std::error_code ec;
+    std::filesystem::remove(temp_path, ec);
+}
+
 TEST(HTMLParser, ParseFileStripsUtf8Bom) {
     const auto temp_path = std::filesystem::temp_directory_path() / "hps_html_parser_test_utf8_bom.html";
     const std::string html = "<div>Hello</div>";
@@ -104,6 +403,77 @@ TEST(HTMLParser, ParseFileRejectsDeclaredGbkCharsetByDefault) {
     std::filesystem::remove(temp_path, ec);
 }
 
+TEST(HTMLParser, ParseFileTranscodesDeclaredGbkCharsetWhenEnabled) {
+    const auto temp_path = std::filesystem::temp_directory_path() / "hps_html_parser_test_gbk_transcode.html";
+
+    std::string bytes = "<html><head><meta charset='gbk'></head><body><p>";
+    bytes.append("\xD6\xD0\xCE\xC4", 4);
+    bytes += "</p></body></html>";
+    write_binary_file(temp_path, bytes);
+
+    hps::Options options;
+    options.transcode_file_input = true;
+    const auto res = hps::parse_file_with_error(temp_path.string(), options);
+    ASSERT_NE(res.document, nullptr);
+    EXPECT_FALSE(has_error_code(res.errors, hps::ErrorCode::UnsupportedEncoding));
+
+    const auto* paragraph = res.document->querySelector("p");
+    ASSERT_NE(paragraph, nullptr);
+    EXPECT_EQ(paragraph->text_content(), "中文");
+
+    std::error_code ec;
+    std::filesystem::remove(temp_path, ec);
+}
+
+TEST(HTMLParser, ParseBytesDecodesSniffedEncodings) {
+    std::string shift_jis = "<meta charset=\"shift_jis\"><p>";
+    shift_jis.append("\x93\xFA\x96\x7B", 4);
+    shift_jis += "</p>";
+    const auto sjis_doc = hps::parse_bytes(shift_jis);
+    ASSERT_NE(sjis_doc, nullptr);
+    ASSERT_NE(sjis_doc->querySelector("p"), nullptr);
+    EXPECT_EQ(sjis_doc->querySelector("p")->text_content(), "日本");
+
+    const auto utf16_doc = hps::parse_bytes(utf16le_with_bom(u"<p>Hello</p>"));
+    ASSERT_NE(utf16_doc->querySelector("p"), nullptr);
+    EXPECT_EQ(utf16_doc->querySelector("p")->text_content(), "Hello");
+
+    // 无 BOM、无 meta 且不是合法 UTF-8 时按 windows-1252 解码
+    const auto fallback_doc = hps::parse_bytes(std::string("<p>caf\xE9</p>"));
+    ASSERT_NE(fallback_doc->querySelector("p"), nullptr);
+    EXPECT_EQ(fallback_doc->querySelector("p")->text_content(), "café");
+
+    const auto res = hps::parse_bytes_with_error("<meta charset='euc-jp'><p>x</p>");
+    EXPECT_TRUE(has_error_code(res.errors, hps::ErrorCode::UnsupportedEncoding));
+    EXPECT_TRUE(res.document->source_html().empty());
+}
+
+TEST(HTMLParser, ParseBytesHonorsTransportCharsetAndReplacesInvalidUtf8) {
+    std::string gbk = "<meta charset=\"shift_jis\"><p>";
+    gbk.append("\xD6\xD0\xCE\xC4", 4);
+    gbk += "</p>";
+    const auto transport_doc = hps::parse_bytes(gbk, hps::Options{}, "gb2312");
+    ASSERT_NE(transport_doc->querySelector("p"), nullptr);
+    EXPECT_EQ(transport_doc->querySelector("p")->text_content(), "中文");
+
+    // 前 1024 字节是合法 UTF-8，之后的非法字节替换为 U+FFFD 而不是整体回退到 windows-1252
+    std::string mixed = std::string(2000, ' ') + "<p>caf\xC3\xA9 \xFF</p>";
+    const auto mixed_doc = hps::parse_bytes(mixed);
+    ASSERT_NE(mixed_doc->querySelector("p"), nullptr);
+    EXPECT_EQ(mixed_doc->querySelector("p")->text_content(), "café \xEF\xBF\xBD");
+}
+
+TEST(HTMLParser, ParseFileValidatesUtf8BeyondPrescanPrefix) {
+    const auto temp_path = std::filesystem::temp_directory_path() / "hps_html_parser_test_late_invalid.html";
+    write_binary_file(temp_path, std::string(2000, ' ') + "<p>\xFF</p>");
+
+    const auto res = hps::parse_file_with_error(temp_path.string(), hps::Options{});
+    EXPECT_TRUE(has_error_code(res.errors, hps::ErrorCode::UnsupportedEncoding));
+
+    std::error_code ec;
+    std::filesystem::remove(temp_path, ec);
+}
+
 TEST(HTMLParser, PreserveWhitespaceOnlyTextNodesByDefault) {
     const auto document = hps::parse("<div>   </div>");
     ASSERT_NE(document, nullptr);
@@ -733,6 +1103,85 @@ TEST(HTMLParser, EnforcesMaxDepthBySkippingTooDeepSubtrees) {
     EXPECT_EQ(res.document->querySelector("c"), nullptr);
 }
 
+TEST(HTMLParser, SkipsTooDeepSubtreeAndResumesAfterIt) {
+    hps::Options opts;
+    opts.max_depth = 2;
+
+    // 被跳过的子树里含有注释、原始文本、空元素、自闭合标签以及引号内的 '>'，都不应影响层数统计
+    const auto res = hps::parse_with_error(
+        "<div id=outer><section>"
+        "<p title='a > b'><!-- <div> --><script>if (a</b) {}</div></script>"
+        "<br><img src=x /><span/><em>x</em></p>"
+        "</section><i>after</i></div><footer>tail</footer>",
+        opts);
+    ASSERT_NE(res.document, nullptr);
+
+    EXPECT_TRUE(has_error_code(res.errors, hps::ErrorCode::TooDeep));
+    EXPECT_EQ(res.document->querySelector("p"), nullptr);
+    EXPECT_EQ(res.document->querySelector("script"), nullptr);
+    const auto* after = res.document->querySelector("#outer > i");
+    ASSERT_NE(after, nullptr);
+    EXPECT_EQ(after->text_content(), "after");
+    const auto* footer = res.document->querySelector("body > footer");
+    ASSERT_NE(footer, nullptr);
+    EXPECT_EQ(footer->text_content(), "tail");
+}
+
+TEST(HTMLParser, StrayEndTagDoesNotEndTooDeepSubtree) {
+    hps::Options opts;
+    opts.max_depth = 2;
+
+    const auto res = hps::parse_with_error(
+        "<div id=outer><section><article></b>deep<span>deeper</span></article>"
+        "</section><i>after</i></div>",
+        opts);
+    ASSERT_NE(res.document, nullptr);
+
+    EXPECT_TRUE(has_error_code(res.errors, hps::ErrorCode::TooDeep));
+    EXPECT_EQ(res.document->querySelector("span"), nullptr);
+    EXPECT_EQ(res.document->text_content().find("deep"), std::string::npos);
+    const auto* after = res.document->querySelector("#outer > i");
+    ASSERT_NE(after, nullptr);
+    EXPECT_EQ(after->text_content(), "after");
+}
+
+TEST(HTMLParser, TooDeepSubtreeEndsWithItsParent) {
+    hps::Options opts;
+    opts.max_depth = 4;
+
+    // 超过深度的 <li> 没有结束标签，由 </ul> 结束
+    auto res = hps::parse_with_error(
+        "<div><div><div><ul><li>a<li>b</ul></div></div></div><span>after</span>", opts);
+    ASSERT_NE(res.document, nullptr);
+    EXPECT_TRUE(has_error_code(res.errors, hps::ErrorCode::TooDeep));
+    EXPECT_TRUE(res.document->querySelectorAll("li").empty());
+    ASSERT_NE(res.document->querySelector("body > span"), nullptr);
+    EXPECT_EQ(res.document->querySelector("body")->text_content(), "after");
+
+    // 子树内与外层元素同名的元素由自己的结束标签关闭，不提前结束子树
+    res = hps::parse_with_error(
+        "<div><div><div><div id=last><section><div>x</div>y</section></div></div></div></div><i>kept</i>", opts);
+    ASSERT_NE(res.document, nullptr);
+    EXPECT_EQ(res.document->querySelector("section"), nullptr);
+    EXPECT_FALSE(res.document->querySelector("#last")->has_children());
+    ASSERT_NE(res.document->querySelector("body > i"), nullptr);
+    EXPECT_EQ(res.document->querySelector("body")->text_content(), "kept");
+}
+
+TEST(HTMLParser, SkipsUnclosedNestingBombToEndOfInput) {
+    hps::Options opts;
+    opts.max_depth = 50;
+
+    std::string html;
+    for (int i = 0; i < 100000; ++i) {
+        html += "<div>";
+    }
+    const auto res = hps::parse_with_error(html, opts);
+    ASSERT_NE(res.document, nullptr);
+    EXPECT_TRUE(has_error_code(res.errors, hps::ErrorCode::TooDeep));
+    EXPECT_EQ(res.document->querySelectorAll("div").size(), 50u);
+}
+
 TEST(HTMLParser, EnforcesMaxAttributesPerElement) {
     hps::Options opts;
     opts.max_attributes = 1;
@@ -776,3 +1225,117 @@ TEST(HTMLParser, EnforcesMaxTextLength) {
     ASSERT_NE(div, nullptr);
     EXPECT_EQ(div->text_content(), "abc");
 }
+
+TEST(HTMLParser, BuildQueryIndexesDuringParseMatchesLazyIndexes) {
+    const std::string html =
+        "<div id='top' class='a b'><span class='a'>1</span></div>"
+        "<table><tr><td class='a'>x</td></tr><p class='a' id='foster'>f</p></table>"
+        "<b><i class='a'>y</b>z</i><P ID='last' class='A a'>end</P>";
+
+    hps::Options eager;
+    eager.build_query_indexes = true;
+    const auto indexed = hps::parse(html, eager);
+    const auto lazy    = hps::parse(html);
+    ASSERT_NE(indexed, nullptr);
+    ASSERT_NE(lazy, nullptr);
+
+    const auto describe = [](const std::vector<const hps::Element*>& elements) {
+        std::vector<std::string> described;
+        for (const auto* element : elements) {
+            described.push_back(element->tag_name() + "#" + element->id() + "." + element->text_content());
+        }
+        return described;
+    };
+
+    EXPECT_EQ(describe(indexed->get_elements_by_class_name("a")), describe(lazy->get_elements_by_class_name("a")));
+    EXPECT_EQ(describe(indexed->get_elements_by_tag_name("p")), describe(lazy->get_elements_by_tag_name("p")));
+    EXPECT_EQ(describe(indexed->get_elements_by_tag_name("i")), describe(lazy->get_elements_by_tag_name("i")));
+    ASSERT_NE(indexed->get_element_by_id("foster"), nullptr);
+    EXPECT_EQ(indexed->get_element_by_id("foster")->text_content(), "f");
+    EXPECT_NE(indexed->get_element_by_id("last"), nullptr);
+    EXPECT_EQ(describe(indexed->querySelectorAll(".a")), describe(lazy->querySelectorAll(".a")));
+}
+
+TEST(HTMLParser, DeferredErrorLocationsMatchEagerLocations) {
+    std::string html = "<html><body>\n";
+    for (int i = 0; i < 2000; ++i) {
+        html += "<div><span>unclosed\n</p>\n";
+    }
+
+    hps::Options eager_options;
+    hps::Options deferred_options;
+    deferred_options.defer_error_locations = true;
+
+    hps::HTMLParser eager_parser;
+    hps::HTMLParser deferred_parser;
+    (void)eager_parser.parse(html, eager_options);
+    {
+        // 文档释放后仍能补全行列号：解析器只保留行首表，不持有文档
+        const std::weak_ptr<hps::Document> document = deferred_parser.parse(html, deferred_options);
+        EXPECT_TRUE(document.expired());
+    }
+
+    const auto& eager    = eager_parser.get_errors();
+    const auto& deferred = deferred_parser.get_errors();
+    ASSERT_GT(eager.size(), 1000u);
+    ASSERT_EQ(eager.size(), deferred.size());
+    for (size_t i = 0; i < eager.size(); ++i) {
+        EXPECT_EQ(deferred[i].code, eager[i].code);
+        EXPECT_EQ(deferred[i].location.position, eager[i].location.position);
+        EXPECT_EQ(deferred[i].location.line, eager[i].location.line);
+        EXPECT_EQ(deferred[i].location.column, eager[i].location.column);
+    }
+    EXPECT_GT(eager.back().location.line, 500u);
+}
+
+TEST(HTMLParser, CompactErrorCollectionMatchesFullCounts) {
+    std::string html = "<html><body>\n";
+    for (int i = 0; i < 300; ++i) {
+        html += "<div><span>unclosed\n</p><a href=\"x\"title=y>\n";
+    }
+
+    hps::Options full_options;
+    hps::Options compact_options;
+    compact_options.error_collection    = hps::ErrorCollectionMode::Compact;
+    compact_options.error_ring_capacity = 16;
+    hps::Options count_options;
+    count_options.error_collection = hps::ErrorCollectionMode::CountOnly;
+
+    hps::HTMLParser full_parser;
+    hps::HTMLParser compact_parser;
+    hps::HTMLParser count_parser;
+    (void)full_parser.parse(html, full_options);
+    const std::weak_ptr<hps::Document> compact_document = compact_parser.parse(html, compact_options);
+    EXPECT_TRUE(compact_document.expired());
+    (void)count_parser.parse(html, count_options);
+
+    const auto& full = full_parser.get_errors();
+    ASSERT_GT(full.size(), 100u);
+    for (const auto* summary : {&full_parser.error_summary(), &compact_parser.error_summary(), &count_parser.error_summary()}) {
+        EXPECT_EQ(summary->total(), full.size());
+        for (size_t code = 0; code < hps::kErrorCodeCount; ++code) {
+            const auto error_code = static_cast<hps::ErrorCode>(code);
+            const auto expected   = static_cast<size_t>(std::ranges::count(full, error_code, &hps::HPSError::code));
+            EXPECT_EQ(summary->count_of(error_code), expected) << code;
+        }
+    }
+
+    // Compact 模式只保留最近的错误，读取时按错误码格式化并补全行列号
+    const auto& compact = compact_parser.get_errors();
+    ASSERT_EQ(compact.size(), 16u);
+    EXPECT_EQ(compact_parser.error_summary().dropped(), full.size() - 16u);
+    std::vector<size_t> full_positions;
+    for (const auto& error : full) {
+        full_positions.push_back(error.location.position);
+    }
+    std::ranges::stable_sort(full_positions);
+    for (size_t i = 0; i < compact.size(); ++i) {
+        EXPECT_EQ(compact[i].location.position, full_positions[full_positions.size() - compact.size() + i]);
+        const auto expected = hps::Location::from_position(html, compact[i].location.position);
+        EXPECT_EQ(compact[i].location.line, expected.line);
+        EXPECT_EQ(compact[i].location.column, expected.column);
+        EXPECT_EQ(compact[i].message, hps::error_code_description(compact[i].code));
+    }
+
+    EXPECT_TRUE(count_parser.get_errors().empty());
+}
@@ -27,6 +27,10 @@ TEST(OptionsTest, FactoryMethods) {
     auto perf = Options::performance();
     EXPECT_EQ(perf.comment_mode, CommentMode::Remove);
     EXPECT_EQ(perf.whitespace_mode, WhitespaceMode::Remove);
+    EXPECT_EQ(perf.error_collection, ErrorCollectionMode::CountOnly);
+    EXPECT_TRUE(perf.skip_script_style_content);
+    EXPECT_TRUE(perf.skip_markup_declarations);
+    EXPECT_TRUE(perf.attribute_allow_list.empty());
     EXPECT_TRUE(perf.is_valid());
 
     auto sanitized = Options::sanitized();
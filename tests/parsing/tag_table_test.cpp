@@ -0,0 +1,42 @@
+#include "hps/parsing/tag_table.hpp"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace hps::tests {
+
+TEST(TagTableTest, FindsEveryEntryIgnoringCase) {
+    for (const auto& entry : detail::kTagEntries) {
+        EXPECT_EQ(lookup_tag(entry.name).id, entry.id) << entry.name;
+
+        std::string upper(entry.name);
+        for (char& c : upper) {
+            c = static_cast<char>(c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c);
+        }
+        const TagInfo info = lookup_tag(upper);
+        EXPECT_EQ(info.id, entry.id) << upper;
+        EXPECT_EQ(info.categories, entry.categories) << upper;
+    }
+}
+
+TEST(TagTableTest, UnknownTagsHaveNoCategories) {
+    for (const std::string_view name : {"", "x", "custom-element", "tablex", "tabl", "foreignobjects", "h7"}) {
+        const TagInfo info = lookup_tag(name);
+        EXPECT_EQ(info.id, TagId::Unknown) << name;
+        EXPECT_EQ(info.categories, 0) << name;
+    }
+}
+
+TEST(TagTableTest, CategoriesMatchInsertionRules) {
+    EXPECT_TRUE(lookup_tag("div").is(TagCategory::ParagraphCloser));
+    EXPECT_FALSE(lookup_tag("span").is(TagCategory::ParagraphCloser));
+    EXPECT_TRUE(lookup_tag("span").is(TagCategory::Formatting));
+    EXPECT_TRUE(lookup_tag("tr").is(TagCategory::TableRow | TagCategory::TableStructure | TagCategory::FosterParent));
+    EXPECT_FALSE(lookup_tag("td").is(TagCategory::FosterParent));
+    EXPECT_TRUE(lookup_tag("meta").is(TagCategory::HeadContent | TagCategory::Void));
+    EXPECT_TRUE(lookup_tag("li").is(TagCategory::OptionalEndTag));
+    EXPECT_FALSE(lookup_tag("div").is(TagCategory::OptionalEndTag));
+}
+
+}  // namespace hps::tests
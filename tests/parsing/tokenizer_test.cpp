@@ -1,5 +1,7 @@
 #include "hps/parsing/tokenizer.hpp"
+#include "hps/parsing/ignored_subtree.hpp"
 #include <gtest/gtest.h>
+#include <tuple>
 #include <vector>
 
 using namespace hps;
@@ -407,3 +409,153 @@ TEST_F(TokenizerTest, RcdataWithoutEndTagReturnsTextAtEOF) {
     ExpectToken(tokens[0], TokenType::OPEN, "textarea");
     ExpectToken(tokens[1], TokenType::TEXT, "", "abc");
 }
+
+TEST_F(TokenizerTest, SkipIgnoredSubtreeStopsAfterMatchingEndTag) {
+    const std::string_view source = "<a><b x=\"</a>\"><c/><br><style></a></style></b></a><i>";
+    Options                options;
+    Tokenizer              tokenizer(source, options);
+    IgnoredSubtree         subtree;
+
+    auto first = tokenizer.next_token();
+    ASSERT_TRUE(first.has_value());
+    ExpectToken(*first, TokenType::OPEN, "a");
+    subtree.begin("a", lookup_tag("a"));
+    ASSERT_TRUE(tokenizer.skip_ignored_subtree(subtree));
+    EXPECT_EQ(subtree.depth(), 0u);
+
+    auto next = tokenizer.next_token();
+    ASSERT_TRUE(next.has_value());
+    ExpectToken(*next, TokenType::OPEN, "i");
+}
+
+TEST_F(TokenizerTest, SkipIgnoredSubtreeMatchesNestedElements) {
+    // 子树内的同名元素与未闭合的子元素由对应的结束标签关闭
+    const std::string_view source = "<nav><div><NAV>y</nav><p>z</div></Nav><i>";
+    Options                options;
+    Tokenizer              tokenizer(source, options);
+    IgnoredSubtree         subtree;
+
+    auto first = tokenizer.next_token();
+    ASSERT_TRUE(first.has_value());
+    ExpectToken(*first, TokenType::OPEN, "nav");
+    subtree.begin("nav", lookup_tag("nav"));
+    ASSERT_TRUE(tokenizer.skip_ignored_subtree(subtree));
+    EXPECT_EQ(subtree.depth(), 0u);
+
+    auto next = tokenizer.next_token();
+    ASSERT_TRUE(next.has_value());
+    ExpectToken(*next, TokenType::OPEN, "i");
+}
+
+TEST_F(TokenizerTest, SkipIgnoredSubtreeStopsBeforeUnmatchedEndTag) {
+    // 不匹配子树内元素的结束标签留给树构建器判断
+    Options        options;
+    Tokenizer      tokenizer("<li>a<b>x</b></ul><i>", options);
+    IgnoredSubtree subtree;
+
+    auto first = tokenizer.next_token();
+    ASSERT_TRUE(first.has_value());
+    ExpectToken(*first, TokenType::OPEN, "li");
+    subtree.begin("li", lookup_tag("li"));
+    ASSERT_TRUE(tokenizer.skip_ignored_subtree(subtree));
+    EXPECT_EQ(subtree.depth(), 1u);
+
+    auto next = tokenizer.next_token();
+    ASSERT_TRUE(next.has_value());
+    ExpectToken(*next, TokenType::CLOSE, "ul");
+}
+
+TEST_F(TokenizerTest, SkipIgnoredSubtreeStopsBeforeImplicitlyClosingStartTag) {
+    // <li> 与 <div> 分别隐式关闭被丢弃的 <li> 与 <p>，这些开始标签属于子树之外
+    for (const auto& [source, root, expected] : {
+             std::tuple{"<li>a<li>b", "li", "li"},
+             std::tuple{"<p>a<span>b</span><div>c", "p", "div"},
+         }) {
+        Options        options;
+        Tokenizer      tokenizer(source, options);
+        IgnoredSubtree subtree;
+
+        auto first = tokenizer.next_token();
+        ASSERT_TRUE(first.has_value());
+        ExpectToken(*first, TokenType::OPEN, root);
+        subtree.begin(root, lookup_tag(root));
+        ASSERT_TRUE(tokenizer.skip_ignored_subtree(subtree));
+        EXPECT_EQ(subtree.depth(), 0u) << source;
+
+        auto next = tokenizer.next_token();
+        ASSERT_TRUE(next.has_value());
+        ExpectToken(*next, TokenType::OPEN, expected);
+    }
+}
+
+TEST_F(TokenizerTest, SkipIgnoredSubtreeDoesNothingInsideRawText) {
+    Options        options;
+    Tokenizer      tokenizer("<script></div></script>", options);
+    IgnoredSubtree subtree;
+
+    auto first = tokenizer.next_token();
+    ASSERT_TRUE(first.has_value());
+    ExpectToken(*first, TokenType::OPEN, "script");
+    subtree.begin("script", lookup_tag("script"));
+    EXPECT_FALSE(tokenizer.skip_ignored_subtree(subtree));
+
+    auto text = tokenizer.next_token();
+    ASSERT_TRUE(text.has_value());
+    ExpectToken(*text, TokenType::TEXT, "", "</div>");
+}
+
+TEST_F(TokenizerTest, SkipScriptStyleContentKeepsElementsButDropsText) {
+    Options options;
+    options.skip_script_style_content = true;
+
+    auto tokens = tokenize("<script>var a = '<p>';</script><style>p{}</style><textarea>t</textarea>", options);
+    ASSERT_EQ(tokens.size(), 7);
+    ExpectToken(tokens[0], TokenType::OPEN, "script");
+    ExpectToken(tokens[1], TokenType::CLOSE, "script");
+    ExpectToken(tokens[2], TokenType::OPEN, "style");
+    ExpectToken(tokens[3], TokenType::CLOSE, "style");
+    ExpectToken(tokens[4], TokenType::OPEN, "textarea");
+    ExpectToken(tokens[5], TokenType::TEXT, "", "t");
+    ExpectToken(tokens[6], TokenType::CLOSE, "textarea");
+}
+
+TEST_F(TokenizerTest, SkipMarkupDeclarationsAndRemovedComments) {
+    Options options;
+    options.skip_markup_declarations = true;
+    options.comment_mode             = CommentMode::Remove;
+
+    auto tokens = tokenize("<!DOCTYPE html><!-- c --><![CDATA[x]]><p>a</p><!-- unclosed", options);
+    ASSERT_EQ(tokens.size(), 3);
+    ExpectToken(tokens[0], TokenType::OPEN, "p");
+    ExpectToken(tokens[1], TokenType::TEXT, "", "a");
+    ExpectToken(tokens[2], TokenType::CLOSE, "p");
+}
+
+TEST_F(TokenizerTest, AttributeAllowListDropsOtherAttributes) {
+    Options options;
+    options.attribute_allow_list = {"href", "hidden"};
+
+    auto tokens = tokenize("<a class=\"x\" href=\"/a\" data-id=1 hidden>", options);
+    ASSERT_EQ(tokens.size(), 1);
+    const auto& attrs = tokens[0].attrs();
+    ASSERT_EQ(attrs.size(), 2);
+    EXPECT_EQ(attrs[0].name, "href");
+    EXPECT_EQ(attrs[0].value, "/a");
+    EXPECT_EQ(attrs[1].name, "hidden");
+}
+
+TEST_F(TokenizerTest, FilteredTagsDoNotCollectAttributes) {
+    Options options;
+    options.tag_allow_list = {"a"};
+    options.pruned_tags    = {"svg"};
+
+    auto tokens = tokenize("<div id=\"d\" class=x><a href=\"/a\"><svg width=1>", options);
+    ASSERT_EQ(tokens.size(), 3);
+    ExpectToken(tokens[0], TokenType::OPEN, "div");
+    EXPECT_TRUE(tokens[0].attrs().empty());
+    ExpectToken(tokens[1], TokenType::OPEN, "a");
+    ASSERT_EQ(tokens[1].attrs().size(), 1);
+    EXPECT_EQ(tokens[1].attrs()[0].name, "href");
+    ExpectToken(tokens[2], TokenType::OPEN, "svg");
+    EXPECT_TRUE(tokens[2].attrs().empty());
+}
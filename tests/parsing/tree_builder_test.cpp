@@ -500,6 +500,52 @@ TEST_F(TreeBuilderTest, RecoversMisnestedFormattingElements) {
     EXPECT_EQ(children[2]->as_text()->value(), "z");
 }
 
+TEST_F(TreeBuilderTest, EndTagsMatchOpenCustomElementsIgnoringCase) {
+    // 未知标签共享哈希槽，结束标签需按名称匹配到正确的祖先
+    options.error_handling = ErrorHandlingMode::Lenient;
+    builder = std::make_unique<TreeBuilder>(doc, options);
+
+    EXPECT_TRUE(builder->process_token(Token(TokenType::OPEN, "x-outer", "")));
+    EXPECT_TRUE(builder->process_token(Token(TokenType::OPEN, "x-inner", "")));
+    EXPECT_TRUE(builder->process_token(Token(TokenType::OPEN, "x-outer", "")));
+    EXPECT_TRUE(builder->process_token(Token(TokenType::CLOSE, "x-missing", "")));
+    EXPECT_TRUE(builder->process_token(Token(TokenType::CLOSE, "X-INNER", "")));
+    EXPECT_TRUE(builder->process_token(Token(TokenType::TEXT, "", "after")));
+    EXPECT_TRUE(builder->finish());
+
+    const auto* outer = doc->querySelector("x-outer");
+    ASSERT_NE(outer, nullptr);
+    const auto children = outer->children();
+    ASSERT_EQ(children.size(), 2u);
+    ASSERT_TRUE(children[0]->is_element());
+    EXPECT_EQ(children[0]->as_element()->tag_name(), "x-inner");
+    ASSERT_TRUE(children[1]->is_text());
+    EXPECT_EQ(children[1]->as_text()->value(), "after");
+    EXPECT_EQ(builder->errors().size(), 3u);  // x-missing、自动关闭的内层 x-outer、文件结束时未闭合的外层 x-outer
+}
+
+TEST_F(TreeBuilderTest, TableScopeStopsAtNestedTable) {
+    options.error_handling = ErrorHandlingMode::Lenient;
+    builder = std::make_unique<TreeBuilder>(doc, options);
+
+    for (const char* tag : {"table", "tbody", "tr", "td", "table", "tbody", "tr", "td"}) {
+        EXPECT_TRUE(builder->process_token(Token(TokenType::OPEN, tag, "")));
+    }
+    EXPECT_TRUE(builder->process_token(Token(TokenType::TEXT, "", "inner")));
+    EXPECT_TRUE(builder->process_token(Token(TokenType::CLOSE, "table", "")));
+    // 内层表格关闭后，外层单元格重新成为当前作用域，新的 <td> 应成为外层行的子元素
+    EXPECT_TRUE(builder->process_token(Token(TokenType::OPEN, "td", "")));
+    EXPECT_TRUE(builder->process_token(Token(TokenType::TEXT, "", "outer")));
+    EXPECT_TRUE(builder->finish());
+
+    const auto rows = doc->querySelectorAll("tr");
+    ASSERT_EQ(rows.size(), 2u);
+    const auto outer_cells = rows[0]->children();
+    ASSERT_EQ(outer_cells.size(), 2u);
+    EXPECT_EQ(outer_cells[1]->as_element()->text_content(), "outer");
+    EXPECT_EQ(rows[1]->as_element()->text_content(), "inner");
+}
+
 TEST_F(TreeBuilderTest, Errors) {
     // </div> mismatch
     // Changing to Lenient for error collection test
@@ -514,4 +560,91 @@ TEST_F(TreeBuilderTest, Errors) {
     EXPECT_FALSE(errors.empty());
 }
 
+TEST_F(TreeBuilderTest, IgnoredSubtreeEndsOnlyAtMatchingEndTag) {
+    options.error_handling = ErrorHandlingMode::Lenient;
+    options.max_depth      = 2;
+
+    for (const auto& token : {
+             Token(TokenType::OPEN, "body", ""),
+             Token(TokenType::OPEN, "div", ""),
+             Token(TokenType::OPEN, "section", ""),
+             Token(TokenType::OPEN, "article", ""),  // 超过深度限制，整棵子树被忽略
+             Token(TokenType::CLOSE, "b", ""),
+             Token(TokenType::TEXT, "", "deep"),
+             Token(TokenType::OPEN, "article", ""),
+             Token(TokenType::CLOSE, "article", ""),
+             Token(TokenType::TEXT, "", "deeper"),
+             Token(TokenType::CLOSE, "article", ""),
+             Token(TokenType::CLOSE, "section", ""),
+             Token(TokenType::OPEN, "i", ""),
+             Token(TokenType::TEXT, "", "after"),
+             Token(TokenType::CLOSE, "i", ""),
+         }) {
+        EXPECT_TRUE(builder->process_token(token));
+    }
+    EXPECT_EQ(builder->ignored_depth(), 0u);
+    EXPECT_TRUE(builder->finish());
+
+    EXPECT_EQ(doc->text_content(), "after");
+    EXPECT_TRUE(doc->get_elements_by_tag_name("article").empty());
+}
+
+TEST_F(TreeBuilderTest, PrunedSubtreeIgnoresUnclosedChildrenAndStrayEndTags) {
+    options.error_handling = ErrorHandlingMode::Lenient;
+    options.pruned_tags    = {"nav"};
+
+    for (const auto& token : {
+             Token(TokenType::OPEN, "body", ""),
+             Token(TokenType::OPEN, "nav", ""),
+             Token(TokenType::OPEN, "ul", ""),
+             Token(TokenType::OPEN, "li", ""),
+             Token(TokenType::TEXT, "", "a"),
+             Token(TokenType::OPEN, "li", ""),
+             Token(TokenType::TEXT, "", "b"),
+             Token(TokenType::CLOSE, "ul", ""),
+             Token(TokenType::CLOSE, "div", ""),
+             Token(TokenType::TEXT, "", "x"),
+             Token(TokenType::CLOSE, "nav", ""),
+             Token(TokenType::OPEN, "p", ""),
+             Token(TokenType::TEXT, "", "kept"),
+             Token(TokenType::CLOSE, "p", ""),
+         }) {
+        EXPECT_TRUE(builder->process_token(token));
+    }
+    EXPECT_EQ(builder->ignored_depth(), 0u);
+    EXPECT_TRUE(builder->finish());
+
+    EXPECT_EQ(doc->text_content(), "kept");
+    EXPECT_TRUE(doc->get_elements_by_tag_name("li").empty());
+}
+
+TEST_F(TreeBuilderTest, PrunedListItemEndsAtParentEndTag) {
+    options.error_handling = ErrorHandlingMode::Lenient;
+    options.pruned_tags    = {"li"};
+
+    for (const auto& token : {
+             Token(TokenType::OPEN, "body", ""),
+             Token(TokenType::OPEN, "ul", ""),
+             Token(TokenType::OPEN, "li", ""),
+             Token(TokenType::TEXT, "", "a"),
+             Token(TokenType::CLOSE, "span", ""),  // 错位标签，丢弃
+             Token(TokenType::OPEN, "li", ""),      // 隐式关闭前一个 <li>，再次被剪除
+             Token(TokenType::TEXT, "", "b"),
+             Token(TokenType::CLOSE, "ul", ""),     // 结束剪除并关闭 <ul>
+             Token(TokenType::OPEN, "span", ""),
+             Token(TokenType::TEXT, "", "after"),
+             Token(TokenType::CLOSE, "span", ""),
+         }) {
+        EXPECT_TRUE(builder->process_token(token));
+    }
+    EXPECT_EQ(builder->ignored_depth(), 0u);
+    EXPECT_TRUE(builder->finish());
+
+    EXPECT_EQ(doc->text_content(), "after");
+    EXPECT_TRUE(doc->get_elements_by_tag_name("li").empty());
+    const auto spans = doc->get_elements_by_tag_name("span");
+    ASSERT_EQ(spans.size(), 1u);
+    EXPECT_EQ(spans[0]->parent()->as_element()->tag_name(), "body");
+}
+
 } // namespace hps::tests
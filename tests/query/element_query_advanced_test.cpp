@@ -1,5 +1,6 @@
 #include "hps/hps.hpp"
 
+#include "hps/core/element.hpp"
 #include "hps/query/element_query.hpp"
 
 #include <gtest/gtest.h>
@@ -116,4 +117,26 @@ TEST(ElementQueryAdvancedTest, FindAliasAndHasTagStayHtmlCaseInsensitive) {
     EXPECT_EQ(spans.has_tag("SPAN").size(), 2u);
 }
 
+TEST(ElementQueryAdvancedTest, SortByDocumentOrderMergesAndDedupes) {
+    const auto doc = hps::parse(R"(<h2 id="a">A</h2><h1 id="b">B</h1><div><h3 id="c">C</h3><h1 id="d">D</h1></div>)");
+    ASSERT_NE(doc, nullptr);
+
+    const auto* b = doc->get_element_by_id("b");
+    const auto* c = doc->get_element_by_id("c");
+    ASSERT_NE(b, nullptr);
+    ASSERT_NE(c, nullptr);
+    EXPECT_LT(b->document_order(), c->document_order());
+
+    std::vector<const Element*> mixed = doc->get_elements_by_tag_name("h3");
+    for (const auto* element : doc->get_elements_by_tag_name("h1")) {
+        mixed.push_back(element);
+    }
+    mixed.push_back(doc->get_element_by_id("a"));
+    mixed.push_back(c);
+
+    const auto sorted = ElementQuery(std::move(mixed)).sort_by_document_order().extract_attributes("id");
+    EXPECT_EQ(sorted, (std::vector<std::string>{"a", "b", "c", "d"}));
+    EXPECT_EQ(doc->css("h1, h2, h3").extract_attributes("id"), sorted);
+}
+
 }  // namespace hps::tests
@@ -1,6 +1,9 @@
 #include "hps/hps.hpp"
+#include "hps/utils/legacy_encodings.hpp"
+#include "hps/utils/string_utils.hpp"
 
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -84,6 +87,157 @@ TEST(EncodingTest, DecodeShiftJisHelperConvertsToUtf8) {
     EXPECT_EQ(*decoded, "日本");
 }
 
+TEST(EncodingTest, Utf8ValidationAtEveryBlockOffset) {
+    const std::vector<std::string> valid_samples = {
+        "\xC3\xA9",
+        "\xE4\xB8\xAD",
+        "\xF0\x9F\x98\x80",
+        "\xEF\xBF\xBD",
+        "\xF4\x8F\xBF\xBF",
+        "\xED\x9F\xBF",
+    };
+    const std::vector<std::string> invalid_samples = {
+        std::string("\xC0\x80", 2),
+        "\xE0\x80\x80",
+        "\xED\xA0\x80",
+        "\xF4\x90\x80\x80",
+        "\xF5\x80\x80\x80",
+        "\x80",
+        "\xC3",
+        "\xE4\xB8",
+        "\xF0\x9F\x98",
+        "\xC3\xA9\xA9",
+    };
+
+    // 样本放在 ASCII 填充中的每个偏移处，覆盖跨 16 字节块边界和尾块的情况
+    for (size_t offset = 0; offset <= 40; ++offset) {
+        for (const auto& sample : valid_samples) {
+            const std::string input = std::string(offset, 'a') + sample + std::string(40 - offset, 'b');
+            EXPECT_TRUE(decode_html_bytes_to_utf8(input, "utf-8").has_value()) << "offset " << offset;
+            EXPECT_TRUE(decode_html_bytes_to_utf8(std::string(offset, 'a') + sample, "utf-8").has_value())
+                << "offset " << offset;
+        }
+        for (const auto& sample : invalid_samples) {
+            const std::string input = std::string(offset, 'a') + sample + std::string(40 - offset, 'b');
+            EXPECT_FALSE(decode_html_bytes_to_utf8(input, "utf-8").has_value()) << "offset " << offset;
+            EXPECT_FALSE(decode_html_bytes_to_utf8(std::string(offset, 'a') + sample, "utf-8").has_value())
+                << "offset " << offset;
+        }
+    }
+}
+
+TEST(EncodingTest, SniffUtf8HeuristicOnlyInspectsPrescanPrefix) {
+    std::string html = "<html><body>";
+    for (int i = 0; i < 500; ++i) {
+        html += "<p>中文 text \xF0\x9F\x98\x80 caf\xC3\xA9</p>";
+    }
+    html += "</body></html>";
+    EXPECT_EQ(sniff_html_encoding(html).source, EncodingHintSource::Utf8Heuristic);
+
+    // 1024 字节之后的非法字节不参与探测；被前缀截断的多字节序列不算错误
+    std::string late_invalid = html;
+    late_invalid[late_invalid.size() / 2] = static_cast<char>(0xFF);
+    EXPECT_EQ(sniff_html_encoding(late_invalid).source, EncodingHintSource::Utf8Heuristic);
+
+    std::string split = std::string(1022, 'a') + "\xE4\xB8\xAD" + "tail";
+    EXPECT_EQ(sniff_html_encoding(split).source, EncodingHintSource::Utf8Heuristic);
+
+    std::string early_invalid = html;
+    early_invalid[100] = static_cast<char>(0xFF);
+    EXPECT_FALSE(sniff_html_encoding(early_invalid).has_encoding());
+}
+
+TEST(EncodingTest, SniffMetaPrescanFollowsWhatwgRules) {
+    const auto commented = sniff_html_encoding("<!-- <meta charset=gbk> --><meta charset=\"shift_jis\">");
+    EXPECT_EQ(commented.canonical_label, "shift_jis");
+
+    EXPECT_EQ(sniff_html_encoding("<metadata charset=gbk>").source, EncodingHintSource::Utf8Heuristic);
+    EXPECT_EQ(sniff_html_encoding("<meta charset=utf-16le>").canonical_label, "utf-8");
+
+    const std::string late_meta = std::string(1100, ' ') + "<meta charset=gbk>";
+    EXPECT_EQ(sniff_html_encoding(late_meta).source, EncodingHintSource::Utf8Heuristic);
+}
+
+TEST(EncodingTest, TransportCharsetOverridesMetaButNotBom) {
+    const auto transport = sniff_html_encoding("<meta charset=gbk><p>x</p>", " Shift-JIS ");
+    EXPECT_EQ(transport.source, EncodingHintSource::TransportCharset);
+    EXPECT_EQ(transport.canonical_label, "shift_jis");
+    EXPECT_TRUE(transport.helper_supported);
+
+    const auto bom = sniff_html_encoding(std::string("\xEF\xBB\xBF<p>x</p>"), "gbk");
+    EXPECT_EQ(bom.source, EncodingHintSource::Utf8Bom);
+
+    EXPECT_EQ(sniff_html_encoding("<meta charset=gbk>", "").source, EncodingHintSource::MetaCharset);
+}
+
+TEST(EncodingTest, DecodeUtf8WithReplacementUsesMaximalSubparts) {
+    std::string decoded;
+    decode_utf8_with_replacement(std::string("a\xC3\xA9" "b\xE4\xB8" "c\xF0\x9F\x98\x80\xED\xA0\x80\xFF", 15), decoded);
+    EXPECT_EQ(decoded, "aéb\xEF\xBF\xBD" "c\xF0\x9F\x98\x80\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD");
+
+    // 跨越 64 KiB 块边界的合法序列保持完整
+    std::string large(64 * 1024 - 1, 'x');
+    large += "中";
+    large += std::string(10, 'y');
+    std::string large_decoded;
+    decode_utf8_with_replacement(large, large_decoded);
+    EXPECT_EQ(large_decoded, large);
+}
+
+TEST(EncodingTest, DecodeLegacyEncodingsWithAsciiMarkup) {
+    const std::string padding(40, ' ');
+
+    std::string gbk = "<p class=\"a\\b~\">" + padding;
+    gbk.append("\xD6\xD0\xCE\xC4", 4);
+    gbk += "x</p>";
+    const auto gbk_decoded = decode_html_bytes_to_utf8(gbk, "gb18030");
+    ASSERT_TRUE(gbk_decoded.has_value());
+    EXPECT_EQ(*gbk_decoded, "<p class=\"a\\b~\">" + padding + "中文x</p>");
+
+    std::string sjis = "<p>a\\b~";
+    sjis.append("\x93\xFA", 2);
+    sjis += "\\";
+    sjis.append("\x96\x7B", 2);
+    sjis += padding + "</p>";
+    const auto sjis_decoded = decode_html_bytes_to_utf8(sjis, "shift_jis");
+    ASSERT_TRUE(sjis_decoded.has_value());
+    EXPECT_EQ(*sjis_decoded, "<p>a\\b~日\\本" + padding + "</p>");
+
+    // 重复调用复用同一转换句柄，不能残留上一次的转换状态
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(decode_html_bytes_to_utf8(sjis, "shift_jis"), sjis_decoded);
+    }
+}
+
+TEST(EncodingTest, BuiltinGb18030DecoderHandlesFourByteAndInvalidSequences) {
+    std::string decoded;
+    decode_gb18030_to_utf8(std::string("\x81\x30\x81\x30\x94\x39\xFC\x36\x80\xA2\xE3", 11), decoded);
+    EXPECT_EQ(decoded, "\xC2\x80\xF0\x9F\x98\x80€€");
+
+    // 非法尾字节为 ASCII 时保留该字符，残缺的结尾序列只产生一个替换字符
+    decoded.clear();
+    decode_gb18030_to_utf8(std::string("\xD6<p>\xFF\xD6\xD0\xCE", 8), decoded);
+    EXPECT_EQ(decoded, "\xEF\xBF\xBD<p>\xEF\xBF\xBD中\xEF\xBF\xBD");
+
+    EXPECT_EQ(gbk_to_utf8("\xD6\xD0\xCE\xC4"), "中文");
+}
+
+TEST(EncodingTest, BuiltinShiftJisDecoderHandlesKanaExtensionsAndPrivateUse) {
+    std::string decoded;
+    decode_shift_jis_to_utf8(std::string("\xB1\x81\x60\xED\x40\xF0\x40\x80", 8), decoded);
+    EXPECT_EQ(decoded, "ｱ～纊\xEE\x80\x80\xC2\x80");
+
+    decoded.clear();
+    decode_shift_jis_to_utf8(std::string("\x93\x3C\xA0\x93", 4), decoded);
+    EXPECT_EQ(decoded, "\xEF\xBF\xBD<\xEF\xBF\xBD\xEF\xBF\xBD");
+}
+
+TEST(EncodingTest, BuiltinWindows1252DecoderMapsC1Range) {
+    std::string decoded = "prefix:";
+    decode_windows_1252_to_utf8(std::string("\x80\x81\x9F\xA0\xE9", 5), decoded);
+    EXPECT_EQ(decoded, "prefix:€\xC2\x81Ÿ\xC2\xA0é");
+}
+
 TEST(EncodingTest, DecodeUnsupportedEncodingReturnsNullopt) {
     EXPECT_FALSE(decode_html_bytes_to_utf8("abc", "euc-jp").has_value());
 }
@@ -0,0 +1,71 @@
+#include "hps/utils/error_summary.hpp"
+
+#include <gtest/gtest.h>
+
+namespace hps::tests {
+
+TEST(ErrorSummaryTest, CountsEveryCode) {
+    ErrorSummary summary;
+    summary.record(ErrorCode::UnclosedTag, 1);
+    summary.record(ErrorCode::UnclosedTag, 2);
+    summary.count(ErrorCode::TooDeep);
+
+    EXPECT_EQ(summary.total(), 3u);
+    EXPECT_EQ(summary.count_of(ErrorCode::UnclosedTag), 2u);
+    EXPECT_EQ(summary.count_of(ErrorCode::TooDeep), 1u);
+    EXPECT_EQ(summary.count_of(ErrorCode::InvalidArchive), 0u);
+    EXPECT_TRUE(summary.recent().empty());
+    EXPECT_EQ(summary.dropped(), 3u);
+}
+
+TEST(ErrorSummaryTest, RingKeepsMostRecentInOrder) {
+    ErrorSummary summary(3);
+    for (size_t position = 0; position < 5; ++position) {
+        summary.record(ErrorCode::InvalidToken, position);
+    }
+
+    const auto recent = summary.recent();
+    ASSERT_EQ(recent.size(), 3u);
+    EXPECT_EQ(recent[0].position, 2u);
+    EXPECT_EQ(recent[1].position, 3u);
+    EXPECT_EQ(recent[2].position, 4u);
+    EXPECT_EQ(summary.dropped(), 2u);
+
+    summary.clear();
+    EXPECT_EQ(summary.total(), 0u);
+    EXPECT_TRUE(summary.recent().empty());
+}
+
+TEST(ErrorSummaryTest, MergeInterleavesByPosition) {
+    ErrorSummary tokenizer(4);
+    ErrorSummary builder(4);
+    tokenizer.record(ErrorCode::InvalidToken, 10);
+    tokenizer.record(ErrorCode::InvalidToken, 30);
+    builder.record(ErrorCode::MismatchedTag, 20);
+    builder.record(ErrorCode::UnclosedTag, 40);
+    builder.record(ErrorCode::UnclosedTag, 50);
+
+    ErrorSummary merged(4);
+    merged.count(ErrorCode::TooManyElements);
+    merged.merge(tokenizer);
+    merged.merge(builder);
+
+    EXPECT_EQ(merged.total(), 6u);
+    EXPECT_EQ(merged.count_of(ErrorCode::UnclosedTag), 2u);
+    const auto recent = merged.recent();
+    ASSERT_EQ(recent.size(), 4u);
+    EXPECT_EQ(recent[0].position, 20u);
+    EXPECT_EQ(recent[1].position, 30u);
+    EXPECT_EQ(recent[2].position, 40u);
+    EXPECT_EQ(recent[3].position, 50u);
+    EXPECT_EQ(merged.dropped(), 2u);
+}
+
+TEST(ErrorSummaryTest, DescribesEveryCode) {
+    for (size_t code = 0; code < kErrorCodeCount; ++code) {
+        EXPECT_FALSE(error_code_description(static_cast<ErrorCode>(code)).empty()) << code;
+    }
+    EXPECT_EQ(error_code_description(ErrorCode::UnclosedTag), "Unclosed tag");
+}
+
+}  // namespace hps::tests
@@ -0,0 +1,57 @@
+#include "hps/utils/line_index.hpp"
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace hps::tests {
+
+TEST(LineIndexTest, MatchesLinearScanAtEveryPosition) {
+    const std::string source = "first\nsecond line\n\n\nlast\r\nend";
+    const LineIndex   index(source);
+    for (size_t position = 0; position <= source.size() + 2; ++position) {
+        const Location expected = Location::from_position(source, position);
+        const Location actual   = index.locate(position);
+        EXPECT_EQ(actual.position, expected.position) << position;
+        EXPECT_EQ(actual.line, expected.line) << position;
+        EXPECT_EQ(actual.column, expected.column) << position;
+    }
+}
+
+TEST(LineIndexTest, HandlesEmptySource) {
+    const LineIndex index("");
+    const Location  location = index.locate(10);
+    EXPECT_EQ(location.position, 0u);
+    EXPECT_EQ(location.line, 1u);
+    EXPECT_EQ(location.column, 1u);
+}
+
+TEST(LineIndexTest, ResolvesDeferredLocations) {
+    const LineIndex index("ab\ncd");
+    Location        location = Location::unresolved(4);
+    EXPECT_FALSE(location.resolved());
+    index.resolve(location);
+    EXPECT_TRUE(location.resolved());
+    EXPECT_EQ(location.line, 2u);
+    EXPECT_EQ(location.column, 2u);
+
+    Location explicit_location(1, 7, 9);
+    index.resolve(explicit_location);
+    EXPECT_EQ(explicit_location.line, 7u);
+}
+
+TEST(LineIndexTest, LocatesAfterReleasingSource) {
+    auto      source = std::make_unique<std::string>("ab\ncd\nef");
+    LineIndex index(*source);
+    index.release_source();
+    source.reset();
+
+    EXPECT_TRUE(index.source().empty());
+    const Location location = index.locate(7);
+    EXPECT_EQ(location.line, 3u);
+    EXPECT_EQ(location.column, 2u);
+    EXPECT_EQ(index.locate(100).position, 8u);
+}
+
+}  // namespace hps::tests
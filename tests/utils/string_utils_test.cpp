@@ -1,4 +1,7 @@
 #include "hps/utils/string_utils.hpp"
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 namespace hps::tests {
@@ -53,6 +56,65 @@ TEST(StringUtilsTest, NormalizeWhitespace) {
     EXPECT_EQ(normalize_whitespace("  a   b  c  "), " a b c ");
 }
 
+TEST(StringUtilsTest, WhitespaceScanningAtEveryBlockOffset) {
+    // 逐字节参考实现，覆盖 16 字节块内外的每个位置
+    const auto reference_normalize = [](const std::string_view text) {
+        std::string out;
+        for (const char c : text) {
+            if (!is_whitespace(c)) {
+                out.push_back(c);
+            } else if (out.empty() || out.back() != ' ') {
+                out.push_back(' ');
+            }
+        }
+        return out;
+    };
+
+    for (size_t length = 0; length <= 40; ++length) {
+        for (size_t pos = 0; pos < length; ++pos) {
+            for (const char ws : {' ', '\t', '\n', '\r', '\f'}) {
+                std::string text(length, 'x');
+                text[pos] = ws;
+                EXPECT_EQ(find_whitespace(text), pos);
+                EXPECT_EQ(is_normalized_whitespace(text), ws == ' ');
+                EXPECT_EQ(normalize_whitespace(text), reference_normalize(text));
+
+                std::string blank(length, ws);
+                blank[pos] = 'y';
+                EXPECT_EQ(find_non_whitespace(blank), pos);
+                EXPECT_EQ(trim_whitespace(blank), "y");
+                EXPECT_EQ(normalize_whitespace(blank), reference_normalize(blank));
+            }
+            if (pos + 1 < length) {
+                std::string doubled(length, 'x');
+                doubled[pos]     = ' ';
+                doubled[pos + 1] = ' ';
+                EXPECT_FALSE(is_normalized_whitespace(doubled));
+            }
+        }
+        EXPECT_EQ(find_whitespace(std::string(length, 'x')), length);
+        EXPECT_EQ(find_non_whitespace(std::string(length, ' ')), length);
+        EXPECT_TRUE(is_normalized_whitespace(std::string(length, 'x')));
+    }
+    EXPECT_EQ(find_whitespace_or("abc&def ghi", 0, '&'), 3u);
+}
+
+TEST(StringUtilsTest, DecodeEntitiesNormalizedMatchesTwoPass) {
+    const std::vector<std::string_view> inputs = {
+        "",
+        "  plain   text\n\twith  runs  ",
+        "a &#10;&#10; b",
+        "&nbsp;&nbsp;x&Tab;&NewLine;y",
+        "  &amp;  &lt;tag&gt;\r\n  &unknown;  ",
+        "Tom &amp; Jerry &copy 2024&#32;",
+    };
+    for (const auto input : inputs) {
+        std::string fused = "prefix ";
+        decode_html_entities_normalized(input, fused);
+        EXPECT_EQ(fused, "prefix " + normalize_whitespace(decode_html_entities(input))) << input;
+    }
+}
+
 TEST(StringUtilsTest, DecodeEntities) {
     EXPECT_EQ(decode_html_entities("a&nbsp;b"), "a b");
     EXPECT_EQ(decode_html_entities("a&amp;b&lt;c&gt;"), "a&b<c>");
@@ -62,4 +124,33 @@ TEST(StringUtilsTest, DecodeEntities) {
     EXPECT_EQ(decode_html_entities("&unknown;"), "&unknown;");
 }
 
+TEST(StringUtilsTest, DecodeEntitiesFullNamedTable) {
+    EXPECT_EQ(decode_html_entities("&hearts;&rarr;&alpha;"), "\xE2\x99\xA5\xE2\x86\x92\xCE\xB1");
+    EXPECT_EQ(decode_html_entities("&CounterClockwiseContourIntegral;"), "\xE2\x88\xB3");
+    EXPECT_EQ(decode_html_entities("&NotEqualTilde;"), "\xE2\x89\x82\xCC\xB8");
+    // 历史无分号写法按最长匹配解码
+    EXPECT_EQ(decode_html_entities("&copy 2024 &notit;"), "\xC2\xA9 2024 \xC2\xACit;");
+    EXPECT_EQ(decode_html_entities("&ampx &"), "&x &");
+    EXPECT_EQ(decode_html_entities("&hearts"), "&hearts");
+}
+
+TEST(StringUtilsTest, DecodeEntitiesNumericEdgeCases) {
+    EXPECT_EQ(decode_html_entities("&#65 &#x42"), "A B");
+    EXPECT_EQ(decode_html_entities("&#0;&#xD800;&#x110000;"), "\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD");
+    EXPECT_EQ(decode_html_entities("&#x80;&#150;"), "\xE2\x82\xAC\xE2\x80\x93");
+    EXPECT_EQ(decode_html_entities("&#;&#x;"), "&#;&#x;");
+}
+
+TEST(StringUtilsTest, DecodeEntitiesAppendsToBuffer) {
+    std::string out = "prefix:";
+    decode_html_entities(std::string_view("a&lt;b"), out);
+    EXPECT_EQ(out, "prefix:a<b");
+
+    const auto match = match_named_entity("lt;rest");
+    ASSERT_TRUE(match.has_value());
+    EXPECT_EQ(match->length, 3u);
+    EXPECT_EQ(match->replacement, "<");
+    EXPECT_FALSE(match_named_entity("zzz").has_value());
+}
+
 } // namespace hps::tests